@@ -2,6 +2,8 @@
 
 #include "../resource.h"
 #include <Foundation/Filesystem.hpp>
+#include <Foundation/CPUProfiler.hpp>
+#include <RenderPipeline/RenderPassGraphAnalyzer.hpp>
 #include <choreograph/Choreograph.h>
 #include <windows.h>
 #include <tchar.h>
@@ -14,9 +16,19 @@ namespace PathFinder
         CreateEngineWindow();
 
         mCmdLineParser = std::make_unique<CommandLineParser>(argc, argv);
+
+        Foundation::CPUProfiler::SharedInstance().SetThreadName("Main Thread");
+        Foundation::CPUProfiler::SharedInstance().SetCaptureEnabled(mCmdLineParser->ShouldCaptureCPUTrace());
+
         mSettingsController = std::make_unique<RenderSettingsController>();
         mRenderEngine = std::make_unique<RenderEngine<RenderPassContentMediator>>(mWindowHandle, *mCmdLineParser);
 
+        // Benchmarks that get this far only need a device and a resource producer
+        if (mCmdLineParser->BenchmarkToRun())
+        {
+            return;
+        }
+
         mScene = std::make_unique<Scene>(
             mCmdLineParser->ExecutableFolderPath(),
             mRenderEngine->Device(), 
@@ -25,6 +37,8 @@ namespace PathFinder
             &mRenderEngine->RenderSurface(),
             mSettingsController->GetAppliedSettings());
 
+        mScene->GetMaterialLoader().SetTextureCompressionQuality(mCmdLineParser->TextureCompressionQuality());
+
         mInput = std::make_unique<Input>();
         mWindowsInputHandler = std::make_unique<InputHandlerWindows>(mInput.get(), mWindowHandle);
         mCameraInteractor = std::make_unique<CameraInteractor>(&mScene->GetMainCamera(), mInput.get());
@@ -49,12 +63,14 @@ namespace PathFinder
         mInput->SetInvertVerticalDelta(true);
 
         InjectRenderPasses();
+        BuildSceneUpdateTaskGraph();
 
         mUIEntryPoint->CreateMandatoryViewControllers();
 
         // Temporary to load demo Scene until proper UI is implemented
         //mThirdPartySceneLoader = std::make_unique<ThirdPartySceneLoader>(mCmdLineParser->ExecutableFolderPath() / "MediaResources/Models/");
         mMaterialLoader = std::make_unique<MaterialLoader>(mCmdLineParser->ExecutableFolderPath(), mRenderEngine->ResourceProducer());
+        mMaterialLoader->SetTextureCompressionQuality(mCmdLineParser->TextureCompressionQuality());
        
         LoadSpheres();
         //mScene->LoadThirdPartyScene(mCmdLineParser->ExecutableFolderPath() / "SanMiguel" / "san-miguel-low-poly.obj");
@@ -149,6 +165,51 @@ namespace PathFinder
         }
 
         mRenderEngine->FlushAllQueuedFrames();
+
+        if (mCmdLineParser->ShouldCaptureCPUTrace())
+        {
+            Foundation::CPUProfiler::SharedInstance().ExportChromeTrace(mCmdLineParser->ExecutableFolderPath() / "CPUTrace.json");
+            Foundation::CPUProfiler::SharedInstance().ExportBinary(mCmdLineParser->ExecutableFolderPath() / "CPUTrace.pfprof");
+        }
+
+        if (mCmdLineParser->ShouldExportGPUStatistics())
+        {
+            mRenderEngine->RendererDevice()->MeasurementStorage().ExportCSV(mCmdLineParser->ExecutableFolderPath() / "GPUStatistics.csv");
+            mRenderEngine->RendererDevice()->MeasurementStorage().ExportJSON(mCmdLineParser->ExecutableFolderPath() / "GPUStatistics.json");
+        }
+
+        if (mCmdLineParser->ShouldExportPipelineStateStatistics())
+        {
+            mRenderEngine->PipelineStates()->ExportStatistics(mCmdLineParser->ExecutableFolderPath() / "PipelineStateStatistics.json");
+        }
+
+        mRenderEngine->PipelineStates()->SaveCache();
+
+        if (mCmdLineParser->ShouldRecordRenderGraph())
+        {
+            RenderPassGraphAnalyzer::GraphRecord record = RenderPassGraphAnalyzer::Record(*mRenderEngine->RenderGraph(), mRenderEngine->RendererDevice()->MeasurementStorage());
+            RenderPassGraphAnalyzer::Report report = RenderPassGraphAnalyzer::Analyze(record);
+
+            RenderPassGraphAnalyzer::SaveRecord(record, mCmdLineParser->ExecutableFolderPath() / "RenderGraph.pfgraph");
+            RenderPassGraphAnalyzer::ExportDOT(record, report, mCmdLineParser->ExecutableFolderPath() / "RenderGraph.dot");
+            RenderPassGraphAnalyzer::ExportJSON(record, report, mCmdLineParser->ExecutableFolderPath() / "RenderGraph.json");
+        }
+
+        if (mCmdLineParser->ShouldRecordBarriers())
+        {
+            BarrierPlanner::SaveFrame(mRenderEngine->RendererDevice()->FrameTransitions(), mCmdLineParser->ExecutableFolderPath() / "FrameBarriers.pfbarriers");
+        }
+    }
+
+    bool Application::RunBenchmark(const BenchmarkRegistry::Entry& benchmark)
+    {
+        BenchmarkRegistry::Context context{};
+        context.ReportPath = mCmdLineParser->ExecutableFolderPath() / benchmark.ReportFileName;
+        context.Input = mCmdLineParser->BenchmarkInput();
+        context.Device = mRenderEngine->Device();
+        context.ResourceProducer = mRenderEngine->ResourceProducer();
+
+        return benchmark.Run(context);
     }
 
     LRESULT WINAPI WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
@@ -216,16 +277,32 @@ namespace PathFinder
         mRenderEngine->AddRenderPass(&mToneMappingPass);
         mRenderEngine->AddRenderPass(&mBackBufferOutputPass);
         mRenderEngine->AddRenderPass(&mUIPass);
-        mRenderEngine->AddRenderPass(&mGeometryPickingPass);
         mRenderEngine->AddRenderPass(&mGIRayTracingPass);
         mRenderEngine->AddRenderPass(&mGIProbeUpdatePass);
         mRenderEngine->AddRenderPass(&mGIDebugPass);
         mRenderEngine->AddRenderPass(&mSkyGenerationPass);
     }
 
+    void Application::BuildSceneUpdateTaskGraph()
+    {
+        auto transformUpdate = mSceneUpdateTaskGraph.AddTask("MeshInstanceStorage::UpdateTransforms", [this] { mScene->GetMeshInstances().UpdateTransforms(); });
+        auto giUpdate = mSceneUpdateTaskGraph.AddTask("GIManager::Update", [this] { mScene->GetGIManager().Update(); });
+        auto skyUpdate = mSceneUpdateTaskGraph.AddTask("Sky::UpdateSkyState", [this] { mScene->GetSky().UpdateSkyState(); });
+        auto instanceUpload = mSceneUpdateTaskGraph.AddTask("SceneGPUStorage::UploadInstances", [this] { mScene->GetGPUStorage().UploadInstances(); });
+        auto bvhUpdate = mSceneUpdateTaskGraph.AddTask("SceneBVH::Update", [this] { mScene->GetBVH().Update(); });
+
+        // Probe invalidation, instance upload and CPU hierarchy read world matrices and bounds of the updated transform hierarchy.
+        // Probe states and debug probe instances are taken from the updated probe grid.
+        // CPU hierarchy reuses light model matrices constructed during instance upload.
+        // Sky state is only consumed by render passes, so sky update runs alongside all of them.
+        mSceneUpdateTaskGraph.AddDependency(transformUpdate, giUpdate);
+        mSceneUpdateTaskGraph.AddDependency(giUpdate, instanceUpload);
+        mSceneUpdateTaskGraph.AddDependency(instanceUpload, bvhUpdate);
+    }
+
     void Application::PerformPreRenderActions()
     {
-        static bool IsInitialSceneUploaded = false; // Dirty hack until dynamic mesh and material buffers are implemented
+        PF_CPU_ZONE("Application::PerformPreRenderActions");
 
         const Geometry::Dimensions& viewportSize = mRenderEngine->RenderSurface().Dimensions();
 
@@ -244,20 +321,15 @@ namespace PathFinder
 
         mSettingsController->SetEnabled(!interactingWithUI);
 
-        if (!IsInitialSceneUploaded)
-        {
-            mScene->GetGPUStorage().UploadMeshes();
-            mScene->GetGPUStorage().UploadMaterials();
-
-            for (const PathFinder::BottomRTAS& bottomRTAS : mScene->GetGPUStorage().BottomAccelerationStructures())
-                mRenderEngine->AddBottomRayTracingAccelerationStructure(&bottomRTAS);
+        // Instance upload reads vertex locations and material indices assigned here
+        mScene->GetGPUStorage().UploadMeshes();
+        mScene->GetGPUStorage().UploadMaterials();
 
-            IsInitialSceneUploaded = true;
-        }
+        // Only new, moved or rebuilt meshes need their bottom structures built
+        for (PathFinder::BottomRTAS* bottomRTAS : mScene->GetGPUStorage().BottomAccelerationStructuresToBuild())
+            mRenderEngine->AddBottomRayTracingAccelerationStructure(bottomRTAS);
 
-        mScene->GetGIManager().Update();
-        mScene->GetSky().UpdateSkyState();
-        mScene->GetGPUStorage().UploadInstances();
+        mSceneUpdateTaskGraph.Execute(Foundation::TaskScheduler::SharedInstance());
 
         mRenderEngine->AddTopRayTracingAccelerationStructure(&mScene->GetGPUStorage().TopAccelerationStructure());
 
@@ -317,10 +389,11 @@ namespace PathFinder
 
         Material* redSphereMaterial = &mScene->AddMaterial(std::move(noTextureRedMaterial));
         Material* blueSphereMaterial = &mScene->AddMaterial(std::move(noTextureBlueMaterial));
-        MeshInstance& sphere1Instance = mScene->GetMeshInstances().back();
-        MeshInstance& sphere2Instance = mScene->AddMeshInstance(MeshInstance{sphere1Instance.GetAssociatedMesh(), blueSphereMaterial});
+        MeshInstanceStorage& instances = mScene->GetMeshInstances();
+        MeshInstanceHandle sphere1Instance = instances.HandleAt(instances.Size() - 1);
 
-        sphere1Instance.SetMaterial(redSphereMaterial);
+        mScene->AddMeshInstance(instances.GetMesh(sphere1Instance), blueSphereMaterial);
+        instances.SetMaterial(sphere1Instance, redSphereMaterial);
 
         redSphereMaterial->DiffuseAlbedoOverride = { 1.0f, 0.0f, 0.0f };
         blueSphereMaterial->DiffuseAlbedoOverride = { 0.0f, 0.0f, 1.0f };
@@ -335,14 +408,18 @@ namespace PathFinder
         mScene->LoadThirdPartyScene(mCmdLineParser->ExecutableFolderPath() / "MediaResources" / "sponza" / "sponza.obj", loadSettings);
 
         // For GI to work correctly we need to set double-sided flags for curtains and such
-        for (MeshInstance& instance : mScene->GetMeshInstances())
+        MeshInstanceStorage& instances = mScene->GetMeshInstances();
+
+        for (uint32_t index = 0; index < instances.Size(); ++index)
         {
-            if (instance.GetAssociatedMaterial()->Name.find("leaf") != std::string::npos ||
-                instance.GetAssociatedMaterial()->Name.find("fabric") != std::string::npos ||
-                instance.GetAssociatedMaterial()->Name.find("chain") != std::string::npos ||
-                instance.GetAssociatedMaterial()->Name.find("vase") != std::string::npos)
+            const std::string& materialName = instances.Materials()[index]->Name;
+
+            if (materialName.find("leaf") != std::string::npos ||
+                materialName.find("fabric") != std::string::npos ||
+                materialName.find("chain") != std::string::npos ||
+                materialName.find("vase") != std::string::npos)
             {
-                instance.SetIsDoubleSided(true);
+                instances.SetFlag(instances.HandleAt(index), MeshInstanceFlags::DoubleSided, true);
             }
         }
     }
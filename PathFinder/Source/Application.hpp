@@ -11,6 +11,8 @@
 #include <IO/CommandLineParser.hpp>
 #include <IO/InputHandlerWindows.hpp>
 #include <Utility/DisplaySettingsController.hpp>
+#include <Utility/BenchmarkRegistry.hpp>
+#include <Foundation/TaskGraph.hpp>
 
 #include "RenderPipeline/RenderPasses/GBufferRenderPass.hpp"
 #include "RenderPipeline/RenderPasses/BackBufferOutputPass.hpp"
@@ -36,7 +38,6 @@
 #include "RenderPipeline/RenderPasses/CommonSetupRenderPass.hpp"
 #include "RenderPipeline/RenderPasses/BloomBlurRenderPass.hpp"
 #include "RenderPipeline/RenderPasses/BloomCompositionRenderPass.hpp"
-#include "RenderPipeline/RenderPasses/GeometryPickingRenderPass.hpp"
 #include "RenderPipeline/RenderPasses/GIRayTracingRenderPass.hpp"
 #include "RenderPipeline/RenderPasses/GIProbeUpdateRenderPass.hpp"
 #include "RenderPipeline/RenderPasses/GIDebugRenderPass.hpp"
@@ -58,11 +59,13 @@ namespace PathFinder
         Application(int argc, char** argv);
 
         void RunMessageLoop();
+        bool RunBenchmark(const BenchmarkRegistry::Entry& benchmark);
 
     private:
         void CreateEngineWindow();
         void DestroyEngineWindow();
         void InjectRenderPasses();
+        void BuildSceneUpdateTaskGraph();
         void PerformPreRenderActions();
         void PerformPostRenderActions();
         void LoadSpheres();
@@ -84,6 +87,9 @@ namespace PathFinder
         std::unique_ptr<DisplaySettingsController> mDisplaySettingsController;
         std::unique_ptr<RenderPassContentMediator> mContentMediator;
 
+        // Per-frame scene updates that are independent of each other overlap on the shared task scheduler
+        Foundation::TaskGraph mSceneUpdateTaskGraph;
+
         CommonSetupRenderPass mCommonSetupPass;
         GBufferRenderPass mGBufferPass;
         RngSeedGenerationRenderPass mRgnSeedGenerationPass;
@@ -107,7 +113,6 @@ namespace PathFinder
         SMAANeighborhoodBlendingRenderPass mSMAANeighborhoodBlendingPass;
         BackBufferOutputPass mBackBufferOutputPass;
         UIRenderPass mUIPass;
-        GeometryPickingRenderPass mGeometryPickingPass;
         GIRayTracingRenderPass mGIRayTracingPass;
         GIProbeUpdateRenderPass mGIProbeUpdatePass;
         GIDebugRenderPass mGIDebugPass;
@@ -0,0 +1,472 @@
+#include "CPUProfiler.hpp"
+
+#include <fstream>
+#include <algorithm>
+#include <unordered_map>
+#include <thread>
+#include <limits>
+
+namespace Foundation
+{
+
+    namespace
+    {
+        std::string EscapeJSONString(const std::string& string)
+        {
+            std::string escaped;
+            escaped.reserve(string.size());
+
+            for (char c : string)
+            {
+                switch (c)
+                {
+                case '"': escaped += "\\\""; break;
+                case '\\': escaped += "\\\\"; break;
+                case '\n': escaped += "\\n"; break;
+                case '\t': escaped += "\\t"; break;
+                default: escaped += c; break;
+                }
+            }
+
+            return escaped;
+        }
+
+        template <class T>
+        void WriteBinary(std::ofstream& stream, const T& value)
+        {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        void WriteBinaryString(std::ofstream& stream, const std::string& string)
+        {
+            WriteBinary(stream, uint32_t(string.size()));
+            stream.write(string.data(), string.size());
+        }
+    }
+
+    CPUProfiler& CPUProfiler::SharedInstance()
+    {
+        static CPUProfiler profiler;
+        return profiler;
+    }
+
+    void CPUProfiler::SetCaptureEnabled(bool enabled)
+    {
+        mIsCaptureEnabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    void CPUProfiler::SetThreadName(const std::string& name)
+    {
+        ThreadEventBuffer& buffer = LocalBuffer();
+        std::lock_guard lock{ mRegistrationMutex };
+        buffer.ThreadName = name;
+    }
+
+    void CPUProfiler::BeginFrame(uint64_t frameNumber)
+    {
+        mFrameNumber.store(frameNumber, std::memory_order_relaxed);
+
+        if (!IsCaptureEnabled())
+            return;
+
+        Event event;
+        event.Name = "Frame";
+        event.StartNS = TimestampNS();
+        event.EndNS = event.StartNS;
+        event.Value = double(frameNumber);
+        event.Type = EventType::FrameMarker;
+
+        LocalBuffer().Push(event);
+    }
+
+    void CPUProfiler::RecordExternalEvents(const std::string& trackName, const std::vector<ExternalEvent>& events)
+    {
+        if (!IsCaptureEnabled())
+            return;
+
+        std::lock_guard lock{ mExternalEventsMutex };
+
+        auto trackIt = std::find_if(mExternalTracks.begin(), mExternalTracks.end(), [&](const ExternalTrack& track) { return track.Name == trackName; });
+
+        if (trackIt == mExternalTracks.end())
+        {
+            mExternalTracks.emplace_back(ExternalTrack{ trackName });
+            trackIt = std::prev(mExternalTracks.end());
+        }
+
+        // Keep external tracks bounded the same way thread rings are
+        std::vector<ExternalEvent>& trackEvents = trackIt->Events;
+        trackEvents.insert(trackEvents.end(), events.begin(), events.end());
+
+        if (trackEvents.size() > ExternalTrackCapacity)
+        {
+            trackEvents.erase(trackEvents.begin(), trackEvents.begin() + (trackEvents.size() - ExternalTrackCapacity));
+        }
+    }
+
+    bool CPUProfiler::ExportChromeTrace(const std::filesystem::path& path) const
+    {
+        // https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+        std::ofstream stream{ path, std::ios::out | std::ios::trunc };
+
+        if (!stream.is_open())
+            return false;
+
+        stream.precision(3);
+        stream << std::fixed;
+        stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+
+        bool isFirstEvent = true;
+
+        auto separator = [&]() -> std::ofstream&
+        {
+            if (!isFirstEvent) stream << ",\n";
+            isFirstEvent = false;
+            return stream;
+        };
+
+        // Chrome trace timestamps are in microseconds
+        auto toUS = [](uint64_t ns) { return double(ns) / 1000.0; };
+
+        std::lock_guard registrationLock{ mRegistrationMutex };
+        std::vector<Event> events;
+
+        for (const std::unique_ptr<ThreadEventBuffer>& buffer : mThreadBuffers)
+        {
+            std::string threadName = buffer->ThreadName.empty() ? "Thread " + std::to_string(buffer->ThreadIndex) : buffer->ThreadName;
+
+            separator() << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":0,\"tid\":" << buffer->ThreadIndex
+                << ",\"args\":{\"name\":\"" << EscapeJSONString(threadName) << "\"}}";
+
+            buffer->CopyPublishedEvents(events);
+
+            for (const Event& event : events)
+            {
+                std::string name = EscapeJSONString(event.Name);
+
+                switch (event.Type)
+                {
+                case EventType::Zone:
+                    separator() << "{\"ph\":\"X\",\"name\":\"" << name << "\",\"pid\":0,\"tid\":" << buffer->ThreadIndex
+                        << ",\"ts\":" << toUS(event.StartNS) << ",\"dur\":" << toUS(event.EndNS - event.StartNS) << "}";
+                    break;
+
+                case EventType::Counter:
+                    separator() << "{\"ph\":\"C\",\"name\":\"" << name << "\",\"pid\":0,\"tid\":" << buffer->ThreadIndex
+                        << ",\"ts\":" << toUS(event.StartNS) << ",\"args\":{\"value\":" << event.Value << "}}";
+                    break;
+
+                case EventType::FrameMarker:
+                    separator() << "{\"ph\":\"i\",\"s\":\"g\",\"name\":\"Frame " << uint64_t(event.Value) << "\",\"pid\":0,\"tid\":" << buffer->ThreadIndex
+                        << ",\"ts\":" << toUS(event.StartNS) << "}";
+                    break;
+                }
+            }
+        }
+
+        std::lock_guard externalLock{ mExternalEventsMutex };
+
+        // External tracks are placed into a separate process lane so they're grouped together in the viewer
+        for (auto trackIdx = 0u; trackIdx < mExternalTracks.size(); ++trackIdx)
+        {
+            const ExternalTrack& track = mExternalTracks[trackIdx];
+
+            separator() << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << trackIdx
+                << ",\"args\":{\"name\":\"" << EscapeJSONString(track.Name) << "\"}}";
+
+            for (const ExternalEvent& event : track.Events)
+            {
+                separator() << "{\"ph\":\"X\",\"name\":\"" << EscapeJSONString(event.Name.ToString()) << "\",\"pid\":1,\"tid\":" << trackIdx
+                    << ",\"ts\":" << toUS(event.StartNS) << ",\"dur\":" << toUS(event.EndNS - event.StartNS)
+                    << ",\"args\":{\"frame\":" << event.FrameNumber << "}}";
+            }
+        }
+
+        stream << "\n]}\n";
+
+        return stream.good();
+    }
+
+    bool CPUProfiler::ExportBinary(const std::filesystem::path& path) const
+    {
+        // Layout:
+        // Header     | 'PFCP' | version u32 |
+        // Strings    | count u32 | (length u32, chars)... |
+        // Tracks     | count u32 | (kind u8, name u32, event count u32, events...)... |
+        // Event      | name u32 | type u8 | depth u16 | start ns u64 | end ns u64 | value f64 |
+        //
+        std::ofstream stream{ path, std::ios::out | std::ios::binary | std::ios::trunc };
+
+        if (!stream.is_open())
+            return false;
+
+        std::lock_guard registrationLock{ mRegistrationMutex };
+        std::lock_guard externalLock{ mExternalEventsMutex };
+
+        std::vector<std::string> strings;
+        std::unordered_map<std::string, uint32_t> stringIndices;
+
+        auto internString = [&](const std::string& string) -> uint32_t
+        {
+            auto [it, inserted] = stringIndices.emplace(string, uint32_t(strings.size()));
+            if (inserted) strings.push_back(string);
+            return it->second;
+        };
+
+        struct Track
+        {
+            uint8_t Kind;
+            uint32_t NameIndex;
+            std::vector<Event> Events;
+            std::vector<uint32_t> EventNameIndices;
+        };
+
+        std::vector<Track> tracks;
+
+        for (const std::unique_ptr<ThreadEventBuffer>& buffer : mThreadBuffers)
+        {
+            Track& track = tracks.emplace_back();
+            track.Kind = 0;
+            track.NameIndex = internString(buffer->ThreadName.empty() ? "Thread " + std::to_string(buffer->ThreadIndex) : buffer->ThreadName);
+            buffer->CopyPublishedEvents(track.Events);
+
+            for (const Event& event : track.Events)
+                track.EventNameIndices.push_back(internString(event.Name));
+        }
+
+        for (const ExternalTrack& externalTrack : mExternalTracks)
+        {
+            Track& track = tracks.emplace_back();
+            track.Kind = 1;
+            track.NameIndex = internString(externalTrack.Name);
+
+            for (const ExternalEvent& externalEvent : externalTrack.Events)
+            {
+                Event& event = track.Events.emplace_back();
+                event.StartNS = externalEvent.StartNS;
+                event.EndNS = externalEvent.EndNS;
+                event.Value = double(externalEvent.FrameNumber);
+                track.EventNameIndices.push_back(internString(externalEvent.Name.ToString()));
+            }
+        }
+
+        stream.write("PFCP", 4);
+        WriteBinary(stream, uint32_t(1));
+
+        WriteBinary(stream, uint32_t(strings.size()));
+        for (const std::string& string : strings)
+            WriteBinaryString(stream, string);
+
+        WriteBinary(stream, uint32_t(tracks.size()));
+
+        for (const Track& track : tracks)
+        {
+            WriteBinary(stream, track.Kind);
+            WriteBinary(stream, track.NameIndex);
+            WriteBinary(stream, uint32_t(track.Events.size()));
+
+            for (auto eventIdx = 0u; eventIdx < track.Events.size(); ++eventIdx)
+            {
+                const Event& event = track.Events[eventIdx];
+                WriteBinary(stream, track.EventNameIndices[eventIdx]);
+                WriteBinary(stream, uint8_t(event.Type));
+                WriteBinary(stream, event.Depth);
+                WriteBinary(stream, event.StartNS);
+                WriteBinary(stream, event.EndNS);
+                WriteBinary(stream, event.Value);
+            }
+        }
+
+        return stream.good();
+    }
+
+    bool CPUProfiler::RunBenchmark(const std::filesystem::path& reportPath)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        struct Phase
+        {
+            uint64_t ThreadCount = 0;
+            bool IsCaptureEnabled = false;
+            std::vector<double> ZoneNS;
+        };
+
+        const uint64_t ZoneCount = 1 << 20;
+        const uint64_t RepetitionCount = 5;
+        const double TargetZoneNS = 50.0;
+        const char* ZoneName = "Benchmark Zone";
+
+        std::vector<uint64_t> threadCounts = { 1, 2, 4, 8 };
+        uint64_t maxThreadCount = *std::max_element(threadCounts.begin(), threadCounts.end());
+
+        std::vector<Phase> phases;
+
+        for (uint64_t threadCount : threadCounts)
+        {
+            for (bool isCaptureEnabled : { false, true })
+            {
+                for (uint64_t repetition = 0; repetition < RepetitionCount; ++repetition)
+                {
+                    phases.push_back({ threadCount, isCaptureEnabled, std::vector<double>(threadCount) });
+                }
+            }
+        }
+
+        // Loop cost without zones is taken out of measurements
+        auto loopStart = Clock::now();
+
+        for (uint64_t zoneIdx = 0; zoneIdx < ZoneCount; ++zoneIdx)
+        {
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+        }
+
+        double loopOverheadNS = std::chrono::duration<double, std::nano>(Clock::now() - loopStart).count() / ZoneCount;
+
+        // Zone takes two timestamps, so clock cost of the platform bounds what zones can reach
+        uint64_t timestampSum = 0;
+        auto timestampStart = Clock::now();
+
+        for (uint64_t zoneIdx = 0; zoneIdx < ZoneCount; ++zoneIdx)
+        {
+            timestampSum += TimestampNS();
+        }
+
+        double timestampNS = std::chrono::duration<double, std::nano>(Clock::now() - timestampStart).count() / ZoneCount - loopOverheadNS;
+
+        CPUProfiler& profiler = SharedInstance();
+        bool wasCaptureEnabled = profiler.IsCaptureEnabled();
+
+        // Threads are created once and step through phases, since every recording thread keeps its event ring for good
+        std::atomic<uint64_t> startedPhaseCount = 0;
+        std::atomic<uint64_t> finishedThreadCount = 0;
+        std::vector<ThreadEventBuffer*> threadBuffers(maxThreadCount, nullptr);
+        std::vector<std::thread> threads;
+
+        for (uint64_t threadIdx = 0; threadIdx < maxThreadCount; ++threadIdx)
+        {
+            threads.emplace_back([&, threadIdx]
+            {
+                threadBuffers[threadIdx] = &profiler.LocalBuffer();
+
+                for (uint64_t phaseIdx = 0; phaseIdx < phases.size(); ++phaseIdx)
+                {
+                    while (startedPhaseCount.load(std::memory_order_acquire) <= phaseIdx)
+                        std::this_thread::yield();
+
+                    Phase& phase = phases[phaseIdx];
+
+                    if (threadIdx >= phase.ThreadCount)
+                        continue;
+
+                    auto start = Clock::now();
+
+                    for (uint64_t zoneIdx = 0; zoneIdx < ZoneCount; ++zoneIdx)
+                    {
+                        PF_CPU_ZONE(ZoneName);
+                        std::atomic_signal_fence(std::memory_order_seq_cst);
+                    }
+
+                    phase.ZoneNS[threadIdx] = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / ZoneCount - loopOverheadNS;
+                    finishedThreadCount.fetch_add(1, std::memory_order_acq_rel);
+                }
+            });
+        }
+
+        uint64_t expectedFinishedThreadCount = 0;
+
+        for (uint64_t phaseIdx = 0; phaseIdx < phases.size(); ++phaseIdx)
+        {
+            profiler.SetCaptureEnabled(phases[phaseIdx].IsCaptureEnabled);
+            expectedFinishedThreadCount += phases[phaseIdx].ThreadCount;
+            startedPhaseCount.store(phaseIdx + 1, std::memory_order_release);
+
+            while (finishedThreadCount.load(std::memory_order_acquire) < expectedFinishedThreadCount)
+                std::this_thread::yield();
+        }
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        profiler.SetCaptureEnabled(wasCaptureEnabled);
+
+        // Every ring has to end with well formed benchmark zones
+        bool areEventsValid = true;
+        std::vector<Event> events;
+
+        for (ThreadEventBuffer* buffer : threadBuffers)
+        {
+            buffer->CopyPublishedEvents(events);
+
+            areEventsValid &= events.size() == std::min(ThreadBufferCapacity, ZoneCount * RepetitionCount) && 
+                std::all_of(events.begin(), events.end(), [&](const Event& event)
+                {
+                    return event.Name == ZoneName && event.Type == EventType::Zone && event.Depth == 0 && event.EndNS >= event.StartNS;
+                });
+
+            areEventsValid &= buffer->CurrentDepth == 0;
+        }
+
+        std::ofstream stream{ reportPath, std::ios::out | std::ios::trunc };
+
+        if (!stream.is_open())
+            return false;
+
+        bool isWithinTarget = true;
+
+        stream.precision(4);
+        stream << "{\"units\":\"nanoseconds\",\"zonesPerThread\":" << ZoneCount << ",\"targetZoneNS\":" << TargetZoneNS
+            << ",\"loopOverheadNS\":" << loopOverheadNS << ",\"timestampNS\":" << timestampNS << ",\"hardwareThreads\":" << std::thread::hardware_concurrency()
+            << ",\"measurements\":[\n";
+
+        for (auto countIdx = 0u; countIdx < threadCounts.size(); ++countIdx)
+        {
+            // Best of repetitions filters out OS scheduling noise, slowest thread of a repetition counts
+            double zoneNS[2] = { std::numeric_limits<double>::max(), std::numeric_limits<double>::max() };
+
+            for (const Phase& phase : phases)
+            {
+                if (phase.ThreadCount == threadCounts[countIdx])
+                {
+                    double& best = zoneNS[phase.IsCaptureEnabled];
+                    best = std::min(best, *std::max_element(phase.ZoneNS.begin(), phase.ZoneNS.end()));
+                }
+            }
+
+            isWithinTarget &= zoneNS[1] < TargetZoneNS;
+
+            stream << "{\"threads\":" << threadCounts[countIdx] << ",\"zoneNSCaptureDisabled\":" << zoneNS[0]
+                << ",\"zoneNSCaptureEnabled\":" << zoneNS[1] << "}" << (countIdx + 1 < threadCounts.size() ? ",\n" : "\n");
+        }
+
+        stream << "],\"eventsValid\":" << (areEventsValid ? "true" : "false") << ",\"withinTarget\":" << (isWithinTarget ? "true" : "false") << "}\n";
+
+        return areEventsValid && timestampSum > 0 && stream.good();
+    }
+
+    CPUProfiler::ThreadEventBuffer& CPUProfiler::RegisterCurrentThread()
+    {
+        std::lock_guard lock{ mRegistrationMutex };
+        uint32_t threadIndex = uint32_t(mThreadBuffers.size());
+        return *mThreadBuffers.emplace_back(std::make_unique<ThreadEventBuffer>(ThreadBufferCapacity, threadIndex));
+    }
+
+    CPUProfiler::ThreadEventBuffer::ThreadEventBuffer(uint64_t capacity, uint32_t threadIndex)
+        : ThreadIndex{ threadIndex }, mEvents{ std::make_unique<Event[]>(capacity) }, mCapacity{ capacity } {}
+
+    void CPUProfiler::ThreadEventBuffer::CopyPublishedEvents(std::vector<Event>& events) const
+    {
+        events.clear();
+
+        uint64_t writeIndex = mWriteIndex.load(std::memory_order_acquire);
+        uint64_t count = std::min(writeIndex, mCapacity);
+        uint64_t firstIndex = writeIndex - count;
+
+        events.reserve(count);
+
+        for (uint64_t i = firstIndex; i < writeIndex; ++i)
+        {
+            events.push_back(mEvents[i % mCapacity]);
+        }
+    }
+
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "Name.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Foundation
+{
+
+    class CPUProfiler
+    {
+    public:
+        enum class EventType : uint8_t
+        {
+            Zone, Counter, FrameMarker
+        };
+
+        struct Event
+        {
+            // Zone names are expected to be string literals or otherwise outlive the profiler
+            const char* Name = nullptr;
+            uint64_t StartNS = 0;
+            uint64_t EndNS = 0;
+            double Value = 0.0;
+            EventType Type = EventType::Zone;
+            uint16_t Depth = 0;
+        };
+
+        // Events produced outside of CPU threads (GPU queues) and submitted in bulk
+        // once their timestamps are resolved and converted into profiler time domain
+        struct ExternalEvent
+        {
+            Foundation::Name Name;
+            uint64_t StartNS = 0;
+            uint64_t EndNS = 0;
+            uint64_t FrameNumber = 0;
+        };
+
+        static CPUProfiler& SharedInstance();
+
+        static inline uint64_t TimestampNS();
+
+        void SetCaptureEnabled(bool enabled);
+        void SetThreadName(const std::string& name);
+
+        void BeginFrame(uint64_t frameNumber);
+
+        // Zone name is recorded when the zone ends, together with its duration
+        inline void BeginZone(uint64_t& startNS);
+        inline void EndZone(const char* name, uint64_t startNS);
+        inline void RecordCounter(const char* name, double value);
+
+        void RecordExternalEvents(const std::string& trackName, const std::vector<ExternalEvent>& events);
+
+        bool ExportChromeTrace(const std::filesystem::path& path) const;
+        bool ExportBinary(const std::filesystem::path& path) const;
+
+        // Measures per zone overhead with capture disabled and enabled on one and several recording threads.
+        // Zones are expected to stay under 50 ns with capture enabled.
+        static bool RunBenchmark(const std::filesystem::path& reportPath);
+
+    private:
+        // Single producer ring of events. Only the owning thread writes into it,
+        // readers (exporters) observe events up to the published write index.
+        class ThreadEventBuffer
+        {
+        public:
+            ThreadEventBuffer(uint64_t capacity, uint32_t threadIndex);
+
+            inline void Push(const Event& event);
+            void CopyPublishedEvents(std::vector<Event>& events) const;
+
+            std::string ThreadName;
+            uint32_t ThreadIndex = 0;
+            uint16_t CurrentDepth = 0;
+
+        private:
+            std::unique_ptr<Event[]> mEvents;
+            uint64_t mCapacity = 0;
+            std::atomic<uint64_t> mWriteIndex = 0;
+        };
+
+        struct ExternalTrack
+        {
+            std::string Name;
+            std::vector<ExternalEvent> Events;
+        };
+
+        inline ThreadEventBuffer& LocalBuffer();
+        ThreadEventBuffer& RegisterCurrentThread();
+
+        static constexpr uint64_t ThreadBufferCapacity = 1 << 16;
+        static constexpr uint64_t ExternalTrackCapacity = 1 << 16;
+
+        std::atomic<bool> mIsCaptureEnabled = false;
+        std::atomic<uint64_t> mFrameNumber = 0;
+
+        mutable std::mutex mRegistrationMutex;
+        std::vector<std::unique_ptr<ThreadEventBuffer>> mThreadBuffers;
+
+        mutable std::mutex mExternalEventsMutex;
+        std::vector<ExternalTrack> mExternalTracks;
+
+    public:
+        inline bool IsCaptureEnabled() const { return mIsCaptureEnabled.load(std::memory_order_relaxed); }
+        inline uint64_t FrameNumber() const { return mFrameNumber.load(std::memory_order_relaxed); }
+    };
+
+    class ScopedCPUZone
+    {
+    public:
+        inline ScopedCPUZone(const char* name);
+        inline ~ScopedCPUZone();
+
+    private:
+        const char* mName;
+        uint64_t mStartNS = 0;
+    };
+
+}
+
+#define PF_CPU_PROFILER_CONCAT_IMPL(a, b) a##b
+#define PF_CPU_PROFILER_CONCAT(a, b) PF_CPU_PROFILER_CONCAT_IMPL(a, b)
+
+// Profiles enclosing scope. Name must be a string literal.
+#define PF_CPU_ZONE(name) Foundation::ScopedCPUZone PF_CPU_PROFILER_CONCAT(_cpuZone, __LINE__){ name }
+#define PF_CPU_COUNTER(name, value) Foundation::CPUProfiler::SharedInstance().RecordCounter(name, value)
+
+#include "CPUProfiler.inl"
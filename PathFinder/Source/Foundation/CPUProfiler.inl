@@ -0,0 +1,82 @@
+namespace Foundation
+{
+
+    uint64_t CPUProfiler::TimestampNS()
+    {
+        using namespace std::chrono;
+        return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    void CPUProfiler::BeginZone(uint64_t& startNS)
+    {
+        if (!IsCaptureEnabled())
+            return;
+
+        LocalBuffer().CurrentDepth++;
+        startNS = TimestampNS();
+    }
+
+    void CPUProfiler::EndZone(const char* name, uint64_t startNS)
+    {
+        // Zone was started while capture was disabled
+        if (startNS == 0)
+            return;
+
+        uint64_t endNS = TimestampNS();
+        ThreadEventBuffer& buffer = LocalBuffer();
+        buffer.CurrentDepth--;
+
+        Event event;
+        event.Name = name;
+        event.StartNS = startNS;
+        event.EndNS = endNS;
+        event.Type = EventType::Zone;
+        event.Depth = buffer.CurrentDepth;
+
+        buffer.Push(event);
+    }
+
+    void CPUProfiler::RecordCounter(const char* name, double value)
+    {
+        if (!IsCaptureEnabled())
+            return;
+
+        Event event;
+        event.Name = name;
+        event.StartNS = TimestampNS();
+        event.EndNS = event.StartNS;
+        event.Value = value;
+        event.Type = EventType::Counter;
+
+        LocalBuffer().Push(event);
+    }
+
+    CPUProfiler::ThreadEventBuffer& CPUProfiler::LocalBuffer()
+    {
+        thread_local ThreadEventBuffer* buffer = nullptr;
+
+        if (!buffer)
+            buffer = &RegisterCurrentThread();
+
+        return *buffer;
+    }
+
+    void CPUProfiler::ThreadEventBuffer::Push(const Event& event)
+    {
+        uint64_t index = mWriteIndex.load(std::memory_order_relaxed);
+        mEvents[index % mCapacity] = event;
+        mWriteIndex.store(index + 1, std::memory_order_release);
+    }
+
+    ScopedCPUZone::ScopedCPUZone(const char* name)
+        : mName{ name }
+    {
+        CPUProfiler::SharedInstance().BeginZone(mStartNS);
+    }
+
+    ScopedCPUZone::~ScopedCPUZone()
+    {
+        CPUProfiler::SharedInstance().EndZone(mName, mStartNS);
+    }
+
+}
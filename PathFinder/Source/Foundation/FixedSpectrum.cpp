@@ -0,0 +1,490 @@
+#include "FixedSpectrum.hpp"
+
+#include <emmintrin.h>
+
+#include <vector>
+#include <random>
+#include <fstream>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+namespace Foundation
+{
+
+    namespace
+    {
+        float HorizontalSum(__m128 value)
+        {
+            __m128 shuffled = _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1));
+            __m128 sums = _mm_add_ps(value, shuffled);
+            shuffled = _mm_movehl_ps(shuffled, sums);
+            return _mm_cvtss_f32(_mm_add_ss(sums, shuffled));
+        }
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::FixedSpectrum(float value)
+    {
+        std::fill(mSamples.begin(), mSamples.begin() + SampleCount, value);
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>
+        FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::FromRGB(const glm::vec3& rgb, SpectrumType type)
+    {
+        const Basis& basis = GetBasis();
+        bool isReflectance = type == SpectrumType::Reflectance;
+        const auto& colors = isReflectance ? basis.Reflectance : basis.Illuminant;
+
+        // PBRT decomposition: white up to the smallest component,
+        // then the secondary color up to the middle one and the primary color for the rest
+        BasisColor secondary = BasisColor::White;
+        BasisColor primary = BasisColor::White;
+        float white = 0.0f;
+        float secondaryWeight = 0.0f;
+        float primaryWeight = 0.0f;
+
+        if (rgb[0] <= rgb[1] && rgb[0] <= rgb[2])
+        {
+            white = rgb[0];
+            secondary = BasisColor::Cyan;
+
+            if (rgb[1] <= rgb[2]) { secondaryWeight = rgb[1] - rgb[0]; primaryWeight = rgb[2] - rgb[1]; primary = BasisColor::Blue; }
+            else { secondaryWeight = rgb[2] - rgb[0]; primaryWeight = rgb[1] - rgb[2]; primary = BasisColor::Green; }
+        }
+        else if (rgb[1] <= rgb[0] && rgb[1] <= rgb[2])
+        {
+            white = rgb[1];
+            secondary = BasisColor::Magenta;
+
+            if (rgb[0] <= rgb[2]) { secondaryWeight = rgb[0] - rgb[1]; primaryWeight = rgb[2] - rgb[0]; primary = BasisColor::Blue; }
+            else { secondaryWeight = rgb[2] - rgb[1]; primaryWeight = rgb[0] - rgb[2]; primary = BasisColor::Red; }
+        }
+        else
+        {
+            white = rgb[2];
+            secondary = BasisColor::Yellow;
+
+            if (rgb[0] <= rgb[1]) { secondaryWeight = rgb[0] - rgb[2]; primaryWeight = rgb[1] - rgb[0]; primary = BasisColor::Green; }
+            else { secondaryWeight = rgb[1] - rgb[2]; primaryWeight = rgb[0] - rgb[1]; primary = BasisColor::Red; }
+        }
+
+        const Samples& whiteSamples = colors[uint32_t(BasisColor::White)];
+        const Samples& secondarySamples = colors[uint32_t(secondary)];
+        const Samples& primarySamples = colors[uint32_t(primary)];
+        float scale = isReflectance ? 0.94f : 0.86445f;
+
+        FixedSpectrum spectrum;
+
+        for (uint32_t i = 0; i < PaddedSampleCount; ++i)
+        {
+            float sample = 0.0f;
+            sample += white * whiteSamples[i];
+            sample += secondaryWeight * secondarySamples[i];
+            sample += primaryWeight * primarySamples[i];
+            spectrum.mSamples[i] = std::max(sample * scale, 0.0f);
+        }
+
+        return spectrum;
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>
+        FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::FromXYZ(const glm::vec3& xyz, SpectrumType type)
+    {
+        glm::vec3 rgb;
+        XYZToRGB(xyz, rgb);
+        return FromRGB(rgb, type);
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    glm::vec3 FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::ToXYZ() const
+    {
+        const Basis& basis = GetBasis();
+
+        __m128 x = _mm_setzero_ps();
+        __m128 y = _mm_setzero_ps();
+        __m128 z = _mm_setzero_ps();
+
+        for (uint32_t i = 0; i < PaddedSampleCount; i += 4)
+        {
+            __m128 samples = _mm_load_ps(mSamples.data() + i);
+            x = _mm_add_ps(x, _mm_mul_ps(samples, _mm_load_ps(basis.X.data() + i)));
+            y = _mm_add_ps(y, _mm_mul_ps(samples, _mm_load_ps(basis.Y.data() + i)));
+            z = _mm_add_ps(z, _mm_mul_ps(samples, _mm_load_ps(basis.Z.data() + i)));
+        }
+
+        return glm::vec3{ HorizontalSum(x), HorizontalSum(y), HorizontalSum(z) } * basis.XYZScale;
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    glm::vec3 FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::ToRGB() const
+    {
+        glm::vec3 rgb;
+        XYZToRGB(ToXYZ(), rgb);
+        return rgb;
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    float FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::Y() const
+    {
+        const Basis& basis = GetBasis();
+        __m128 y = _mm_setzero_ps();
+
+        for (uint32_t i = 0; i < PaddedSampleCount; i += 4)
+        {
+            y = _mm_add_ps(y, _mm_mul_ps(_mm_load_ps(mSamples.data() + i), _mm_load_ps(basis.Y.data() + i)));
+        }
+
+        return HorizontalSum(y) * basis.XYZScale;
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    void FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::ToXYZ(const FixedSpectrum* spectra, uint64_t count, glm::vec3* xyz)
+    {
+        const Basis& basis = GetBasis();
+        const __m128 scale = _mm_set1_ps(basis.XYZScale);
+
+        uint64_t spectrumIndex = 0;
+
+        for (; spectrumIndex + 4 <= count; spectrumIndex += 4)
+        {
+            const FixedSpectrum* batch = spectra + spectrumIndex;
+
+            __m128 x0 = _mm_setzero_ps(), x1 = x0, x2 = x0, x3 = x0;
+            __m128 y0 = x0, y1 = x0, y2 = x0, y3 = x0;
+            __m128 z0 = x0, z1 = x0, z2 = x0, z3 = x0;
+
+            for (uint32_t i = 0; i < PaddedSampleCount; i += 4)
+            {
+                __m128 basisX = _mm_load_ps(basis.X.data() + i);
+                __m128 basisY = _mm_load_ps(basis.Y.data() + i);
+                __m128 basisZ = _mm_load_ps(basis.Z.data() + i);
+
+                __m128 samples0 = _mm_load_ps(batch[0].mSamples.data() + i);
+                __m128 samples1 = _mm_load_ps(batch[1].mSamples.data() + i);
+                __m128 samples2 = _mm_load_ps(batch[2].mSamples.data() + i);
+                __m128 samples3 = _mm_load_ps(batch[3].mSamples.data() + i);
+
+                x0 = _mm_add_ps(x0, _mm_mul_ps(samples0, basisX));
+                x1 = _mm_add_ps(x1, _mm_mul_ps(samples1, basisX));
+                x2 = _mm_add_ps(x2, _mm_mul_ps(samples2, basisX));
+                x3 = _mm_add_ps(x3, _mm_mul_ps(samples3, basisX));
+
+                y0 = _mm_add_ps(y0, _mm_mul_ps(samples0, basisY));
+                y1 = _mm_add_ps(y1, _mm_mul_ps(samples1, basisY));
+                y2 = _mm_add_ps(y2, _mm_mul_ps(samples2, basisY));
+                y3 = _mm_add_ps(y3, _mm_mul_ps(samples3, basisY));
+
+                z0 = _mm_add_ps(z0, _mm_mul_ps(samples0, basisZ));
+                z1 = _mm_add_ps(z1, _mm_mul_ps(samples1, basisZ));
+                z2 = _mm_add_ps(z2, _mm_mul_ps(samples2, basisZ));
+                z3 = _mm_add_ps(z3, _mm_mul_ps(samples3, basisZ));
+            }
+
+            // After transposition each register holds partial sums of all 4 spectra, one spectrum per lane
+            _MM_TRANSPOSE4_PS(x0, x1, x2, x3);
+            _MM_TRANSPOSE4_PS(y0, y1, y2, y3);
+            _MM_TRANSPOSE4_PS(z0, z1, z2, z3);
+
+            alignas(16) std::array<float, 4> sumX;
+            alignas(16) std::array<float, 4> sumY;
+            alignas(16) std::array<float, 4> sumZ;
+
+            _mm_store_ps(sumX.data(), _mm_mul_ps(_mm_add_ps(_mm_add_ps(x0, x1), _mm_add_ps(x2, x3)), scale));
+            _mm_store_ps(sumY.data(), _mm_mul_ps(_mm_add_ps(_mm_add_ps(y0, y1), _mm_add_ps(y2, y3)), scale));
+            _mm_store_ps(sumZ.data(), _mm_mul_ps(_mm_add_ps(_mm_add_ps(z0, z1), _mm_add_ps(z2, z3)), scale));
+
+            for (uint32_t lane = 0; lane < 4; ++lane)
+            {
+                xyz[spectrumIndex + lane] = { sumX[lane], sumY[lane], sumZ[lane] };
+            }
+        }
+
+        for (; spectrumIndex < count; ++spectrumIndex)
+        {
+            xyz[spectrumIndex] = spectra[spectrumIndex].ToXYZ();
+        }
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    void FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::ToRGB(const FixedSpectrum* spectra, uint64_t count, glm::vec3* rgb)
+    {
+        ToXYZ(spectra, count, rgb);
+
+        for (uint64_t spectrumIndex = 0; spectrumIndex < count; ++spectrumIndex)
+        {
+            glm::vec3 xyz = rgb[spectrumIndex];
+            XYZToRGB(xyz, rgb[spectrumIndex]);
+        }
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>&
+        FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::operator+=(const FixedSpectrum& other)
+    {
+        for (uint32_t i = 0; i < PaddedSampleCount; ++i)
+        {
+            mSamples[i] += other.mSamples[i];
+        }
+
+        return *this;
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>&
+        FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::operator-=(const FixedSpectrum& other)
+    {
+        for (uint32_t i = 0; i < PaddedSampleCount; ++i)
+        {
+            mSamples[i] -= other.mSamples[i];
+        }
+
+        return *this;
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>&
+        FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::operator*=(const FixedSpectrum& other)
+    {
+        for (uint32_t i = 0; i < PaddedSampleCount; ++i)
+        {
+            mSamples[i] *= other.mSamples[i];
+        }
+
+        return *this;
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>&
+        FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::operator*=(float value)
+    {
+        for (uint32_t i = 0; i < PaddedSampleCount; ++i)
+        {
+            mSamples[i] *= value;
+        }
+
+        return *this;
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>&
+        FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::operator/=(float value)
+    {
+        // Padding is skipped so that division by zero doesn't leave NaNs there
+        for (uint32_t i = 0; i < SampleCount; ++i)
+        {
+            mSamples[i] /= value;
+        }
+
+        return *this;
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>
+        FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::operator+(const FixedSpectrum& other) const
+    {
+        FixedSpectrum result = *this;
+        return result += other;
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>
+        FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::operator-(const FixedSpectrum& other) const
+    {
+        FixedSpectrum result = *this;
+        return result -= other;
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>
+        FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::operator*(const FixedSpectrum& other) const
+    {
+        FixedSpectrum result = *this;
+        return result *= other;
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>
+        FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::operator*(float value) const
+    {
+        FixedSpectrum result = *this;
+        return result *= value;
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>
+        FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::operator/(float value) const
+    {
+        FixedSpectrum result = *this;
+        return result /= value;
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    bool FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::IsBlack() const
+    {
+        for (uint32_t i = 0; i < SampleCount; ++i)
+        {
+            if (mSamples[i] != 0.0f)
+                return false;
+        }
+
+        return true;
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    float FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::MaxComponentValue() const
+    {
+        return *std::max_element(mSamples.begin(), mSamples.begin() + SampleCount);
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>
+        FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::Clamp(float low, float high) const
+    {
+        FixedSpectrum result;
+
+        for (uint32_t i = 0; i < SampleCount; ++i)
+        {
+            result.mSamples[i] = glm::clamp(mSamples[i], low, high);
+        }
+
+        return result;
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    float FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::Wavelength(uint32_t sampleIndex)
+    {
+        return glm::mix(float(LowestWavelength), float(HighestWavelength), (sampleIndex + 0.5f) / float(SampleCount));
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    const typename FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::Basis&
+        FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::GetBasis()
+    {
+        static const Basis basis = ComputeBasis();
+        return basis;
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    typename FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::Basis
+        FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::ComputeBasis()
+    {
+        const std::array<const float*, uint32_t(BasisColor::Count)> reflectanceTables = {
+            RGBRefl2SpectWhite, RGBRefl2SpectCyan, RGBRefl2SpectMagenta, RGBRefl2SpectYellow, RGBRefl2SpectRed, RGBRefl2SpectGreen, RGBRefl2SpectBlue
+        };
+
+        const std::array<const float*, uint32_t(BasisColor::Count)> illuminantTables = {
+            RGBIllum2SpectWhite, RGBIllum2SpectCyan, RGBIllum2SpectMagenta, RGBIllum2SpectYellow, RGBIllum2SpectRed, RGBIllum2SpectGreen, RGBIllum2SpectBlue
+        };
+
+        Basis basis;
+
+        // Each sample averages tabulated functions over its wavelength interval
+        for (uint32_t i = 0; i < SampleCount; ++i)
+        {
+            float wl0 = glm::mix(float(LowestWavelength), float(HighestWavelength), i / float(SampleCount));
+            float wl1 = glm::mix(float(LowestWavelength), float(HighestWavelength), (i + 1) / float(SampleCount));
+
+            basis.X[i] = AverageSpectrumSamples(CIE_lambda, CIE_X, nCIESamples, wl0, wl1);
+            basis.Y[i] = AverageSpectrumSamples(CIE_lambda, CIE_Y, nCIESamples, wl0, wl1);
+            basis.Z[i] = AverageSpectrumSamples(CIE_lambda, CIE_Z, nCIESamples, wl0, wl1);
+
+            for (uint32_t color = 0; color < uint32_t(BasisColor::Count); ++color)
+            {
+                basis.Reflectance[color][i] = AverageSpectrumSamples(RGB2SpectLambda, reflectanceTables[color], nRGB2SpectSamples, wl0, wl1);
+                basis.Illuminant[color][i] = AverageSpectrumSamples(RGB2SpectLambda, illuminantTables[color], nRGB2SpectSamples, wl0, wl1);
+            }
+        }
+
+        basis.XYZScale = float(HighestWavelength - LowestWavelength) / float(CIE_Y_integral * SampleCount);
+
+        return basis;
+    }
+
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    bool FixedSpectrum<SampleCount, LowestWavelength, HighestWavelength>::RunBenchmark(const std::filesystem::path& reportPath)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        // Roughly what a sky model evaluation over a hemisphere of directions would convert
+        const uint64_t SpectrumCount = 4096;
+        const uint32_t RepeatCount = 5;
+
+        std::ofstream stream{ reportPath, std::ios::out | std::ios::trunc };
+
+        if (!stream.is_open())
+            return false;
+
+        auto measure = [&](auto&& function)
+        {
+            double bestSeconds = std::numeric_limits<double>::max();
+
+            for (uint32_t repeat = 0; repeat < RepeatCount; ++repeat)
+            {
+                auto start = Clock::now();
+                function();
+                bestSeconds = std::min(bestSeconds, std::chrono::duration<double>(Clock::now() - start).count());
+            }
+
+            // Nanoseconds per spectrum
+            return bestSeconds * 1e9 / SpectrumCount;
+        };
+
+        std::mt19937 generator{ 12345 };
+        std::uniform_real_distribution<float> distribution{ 0.0f, 4.0f };
+        std::vector<glm::vec3> colors(SpectrumCount);
+
+        for (glm::vec3& color : colors)
+        {
+            color = { distribution(generator), distribution(generator), distribution(generator) };
+        }
+
+        std::vector<FixedSpectrum> spectra(SpectrumCount);
+        std::vector<glm::vec3> xyz(SpectrumCount);
+        std::vector<glm::vec3> rgb(SpectrumCount);
+
+        double fromRGBTime = measure([&]
+        {
+            for (uint64_t i = 0; i < SpectrumCount; ++i)
+            {
+                spectra[i] = FromRGB(colors[i], i % 2 ? SpectrumType::Reflectance : SpectrumType::Illuminant);
+            }
+        });
+
+        double toXYZTime = measure([&]
+        {
+            for (uint64_t i = 0; i < SpectrumCount; ++i)
+            {
+                xyz[i] = spectra[i].ToXYZ();
+            }
+        });
+
+        double toRGBTime = measure([&]
+        {
+            for (uint64_t i = 0; i < SpectrumCount; ++i)
+            {
+                rgb[i] = spectra[i].ToRGB();
+            }
+        });
+
+        double batchToXYZTime = measure([&] { ToXYZ(spectra.data(), SpectrumCount, xyz.data()); });
+        double batchToRGBTime = measure([&] { ToRGB(spectra.data(), SpectrumCount, rgb.data()); });
+
+        stream.precision(6);
+        stream << "{\"samples\":" << SampleCount << ",\"paddedSamples\":" << PaddedSampleCount
+            << ",\"wavelengths\":[" << LowestWavelength << "," << HighestWavelength << "],\"spectra\":" << SpectrumCount
+            << ",\"nanosecondsPerSpectrum\":{"
+            << "\"fromRGB\":" << fromRGBTime
+            << ",\"toXYZ\":" << toXYZTime
+            << ",\"toRGB\":" << toRGBTime
+            << ",\"batchToXYZ\":" << batchToXYZTime
+            << ",\"batchToRGB\":" << batchToRGBTime << "}}\n";
+
+        return stream.good();
+    }
+
+    template class FixedSpectrum<25, 400, 700>;
+
+}
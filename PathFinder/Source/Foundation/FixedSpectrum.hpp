@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Spectrum.hpp"
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <filesystem>
+#include <glm/vec3.hpp>
+
+namespace Foundation
+{
+
+    /// Allocation free sampled spectrum with a sample count and wavelength range fixed at compile time.
+    /// Samples are stored in a padded, aligned array so that arithmetic and conversion loops run over
+    /// whole SIMD registers without tails; padding samples are always zero.
+    /// CIE matching functions and RGB to spectrum basis are precomputed once per instantiation and shared.
+    template <uint32_t SampleCount, uint32_t LowestWavelength, uint32_t HighestWavelength>
+    class FixedSpectrum
+    {
+    public:
+        inline static const uint32_t SpectralSampleCount = SampleCount;
+
+        // Multiple of both 4 and 8 float lanes
+        inline static const uint32_t PaddedSampleCount = (SampleCount + 7) / 8 * 8;
+
+        using Samples = std::array<float, PaddedSampleCount>;
+
+        enum class BasisColor : uint32_t
+        {
+            White, Cyan, Magenta, Yellow, Red, Green, Blue, Count
+        };
+
+        struct Basis
+        {
+            alignas(32) Samples X{};
+            Samples Y{};
+            Samples Z{};
+            std::array<Samples, uint32_t(BasisColor::Count)> Reflectance{};
+            std::array<Samples, uint32_t(BasisColor::Count)> Illuminant{};
+
+            // Converts sums of products with matching functions to XYZ
+            float XYZScale = 0.0f;
+        };
+
+        FixedSpectrum() = default;
+        explicit FixedSpectrum(float value);
+
+        static FixedSpectrum FromRGB(const glm::vec3& rgb, SpectrumType type = SpectrumType::Illuminant);
+        static FixedSpectrum FromXYZ(const glm::vec3& xyz, SpectrumType type = SpectrumType::Reflectance);
+
+        glm::vec3 ToXYZ() const;
+        glm::vec3 ToRGB() const;
+        float Y() const;
+
+        // Converts many spectra at once, 4 spectra per iteration share loads of matching functions
+        static void ToXYZ(const FixedSpectrum* spectra, uint64_t count, glm::vec3* xyz);
+        static void ToRGB(const FixedSpectrum* spectra, uint64_t count, glm::vec3* rgb);
+
+        FixedSpectrum& operator+=(const FixedSpectrum& other);
+        FixedSpectrum& operator-=(const FixedSpectrum& other);
+        FixedSpectrum& operator*=(const FixedSpectrum& other);
+        FixedSpectrum& operator*=(float value);
+        FixedSpectrum& operator/=(float value);
+
+        FixedSpectrum operator+(const FixedSpectrum& other) const;
+        FixedSpectrum operator-(const FixedSpectrum& other) const;
+        FixedSpectrum operator*(const FixedSpectrum& other) const;
+        FixedSpectrum operator*(float value) const;
+        FixedSpectrum operator/(float value) const;
+
+        bool IsBlack() const;
+        float MaxComponentValue() const;
+        FixedSpectrum Clamp(float low = 0, float high = std::numeric_limits<float>::infinity()) const;
+
+        // Center of the wavelength interval the sample averages over, in nanometers.
+        // The range is split into SampleCount equal intervals, so the first sample isn't at LowestWavelength.
+        static float Wavelength(uint32_t sampleIndex);
+
+        static const Basis& GetBasis();
+
+        // Measures per spectrum conversions against batched ones
+        static bool RunBenchmark(const std::filesystem::path& reportPath);
+
+    private:
+        static Basis ComputeBasis();
+
+        alignas(32) Samples mSamples{};
+
+    public:
+        inline float& operator[](uint32_t sampleIndex) { return mSamples[sampleIndex]; }
+        inline float operator[](uint32_t sampleIndex) const { return mSamples[sampleIndex]; }
+        inline const Samples& GetSamples() const { return mSamples; }
+    };
+
+    // Sampling of the visible range used by the sky model
+    using VisibleSpectrum = FixedSpectrum<25, 400, 700>;
+
+}
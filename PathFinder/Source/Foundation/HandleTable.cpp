@@ -0,0 +1,79 @@
+#include "HandleTable.hpp"
+#include "Assert.hpp"
+
+namespace Foundation
+{
+
+    Handle HandleTable::Insert()
+    {
+        uint32_t slot = 0;
+
+        if (mFreeSlots.empty())
+        {
+            slot = (uint32_t)mSlots.size();
+            mSlots.push_back({ 0, 0 });
+        }
+        else
+        {
+            slot = mFreeSlots.back();
+            mFreeSlots.pop_back();
+        }
+
+        mSlots[slot].Index = Size();
+        mIndexToSlot.push_back(slot);
+
+        return { slot, mSlots[slot].Generation };
+    }
+
+    HandleTable::Erasure HandleTable::Erase(Handle handle)
+    {
+        assert_format(Contains(handle), "Erasing an element through a stale or invalid handle");
+
+        SlotRecord& erasedSlot = mSlots[handle.Slot];
+        Erasure erasure{ erasedSlot.Index, Size() - 1 };
+
+        uint32_t movedSlot = mIndexToSlot[erasure.MovedIndex];
+        mIndexToSlot[erasure.ErasedIndex] = movedSlot;
+        mSlots[movedSlot].Index = erasure.ErasedIndex;
+        mIndexToSlot.pop_back();
+
+        // Outstanding handles to the erased element no longer match the slot
+        ++erasedSlot.Generation;
+        mFreeSlots.push_back(handle.Slot);
+
+        return erasure;
+    }
+
+    void HandleTable::Clear()
+    {
+        for (uint32_t slot : mIndexToSlot)
+        {
+            ++mSlots[slot].Generation;
+            mFreeSlots.push_back(slot);
+        }
+
+        mIndexToSlot.clear();
+    }
+
+    bool HandleTable::Contains(Handle handle) const
+    {
+        if (handle.Slot >= mSlots.size())
+            return false;
+
+        const SlotRecord& slot = mSlots[handle.Slot];
+        return slot.Generation == handle.Generation && slot.Index < Size() && mIndexToSlot[slot.Index] == handle.Slot;
+    }
+
+    uint32_t HandleTable::Index(Handle handle) const
+    {
+        assert_format(Contains(handle), "Accessing an element through a stale or invalid handle");
+        return mSlots[handle.Slot].Index;
+    }
+
+    Handle HandleTable::HandleAt(uint32_t index) const
+    {
+        uint32_t slot = mIndexToSlot[index];
+        return { slot, mSlots[slot].Generation };
+    }
+
+}
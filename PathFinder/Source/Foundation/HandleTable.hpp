@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace Foundation
+{
+
+    /// Refers to an element of densely packed storage.
+    /// Stays valid while the element lives and is detected as stale once its slot is reused.
+    struct Handle
+    {
+        inline static const uint32_t InvalidSlot = std::numeric_limits<uint32_t>::max();
+
+        uint32_t Slot = InvalidSlot;
+        uint32_t Generation = 0;
+
+        inline bool IsValid() const { return Slot != InvalidSlot; }
+        inline bool operator==(const Handle& other) const { return Slot == other.Slot && Generation == other.Generation; }
+        inline bool operator!=(const Handle& other) const { return !(*this == other); }
+    };
+
+    /// Indirection between handles and indices of elements kept in dense arrays.
+    /// Owners keep one array per element component and mirror every insertion and erasure in each of them:
+    /// insertion appends, erasure moves the last element into the erased one's place and pops the back.
+    /// Both are O(1) and keep arrays free of holes, so per-frame passes iterate them linearly.
+    class HandleTable
+    {
+    public:
+        struct Erasure
+        {
+            // Element to be overwritten by the one at MovedIndex before arrays shrink by one
+            uint32_t ErasedIndex;
+            uint32_t MovedIndex;
+        };
+
+        // Registers an element appended to the back of dense arrays
+        Handle Insert();
+        Erasure Erase(Handle handle);
+        void Clear();
+
+        bool Contains(Handle handle) const;
+        uint32_t Index(Handle handle) const;
+        Handle HandleAt(uint32_t index) const;
+
+    private:
+        struct SlotRecord
+        {
+            uint32_t Index;
+            uint32_t Generation;
+        };
+
+        std::vector<SlotRecord> mSlots;
+        std::vector<uint32_t> mIndexToSlot;
+        std::vector<uint32_t> mFreeSlots;
+
+    public:
+        inline uint32_t Size() const { return (uint32_t)mIndexToSlot.size(); }
+        inline bool Empty() const { return mIndexToSlot.empty(); }
+    };
+
+    // Mirrors an erasure in dense component arrays
+    template <class... Arrays>
+    void EraseFromArrays(const HandleTable::Erasure& erasure, Arrays&... arrays)
+    {
+        ((arrays[erasure.ErasedIndex] = std::move(arrays[erasure.MovedIndex]), arrays.pop_back()), ...);
+    }
+
+}
@@ -20,6 +20,19 @@ namespace Foundation
 
     uint32_t NameRegistry::ToId(const std::string& string)
     {
+        {
+            std::shared_lock lock{ m_Mutex };
+            auto found = m_NameToId.find(string);
+
+            if (found != m_NameToId.end())
+            {
+                return found->second;
+            }
+        }
+
+        std::unique_lock lock{ m_Mutex };
+
+        // Another thread could have registered the name while the lock was released
         auto found = m_NameToId.find(string);
 
         if (found != m_NameToId.end())
@@ -35,6 +48,7 @@ namespace Foundation
 
     const std::string& NameRegistry::ToString(uint32_t id)
     {
+        std::shared_lock lock{ m_Mutex };
         return m_IdToName.at(id);
     }
 }
@@ -2,7 +2,9 @@
 
 #include <string>
 #include <unordered_map>
-#include <vector>
+#include <deque>
+#include <shared_mutex>
+#include <mutex>
 
 namespace Foundation
 {
@@ -20,7 +22,9 @@ namespace Foundation
         const std::string& ToString(uint32_t id);
 
     private:
+        // Names can be created from any thread, deque keeps returned strings in place as registry grows
         std::unordered_map<std::string, uint32_t> m_NameToId;
-        std::vector<std::string> m_IdToName;
+        std::deque<std::string> m_IdToName;
+        mutable std::shared_mutex m_Mutex;
     };
 }
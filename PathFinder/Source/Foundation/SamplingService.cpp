@@ -0,0 +1,626 @@
+#include "SamplingService.hpp"
+#include "Halton.hpp"
+#include "Assert.hpp"
+
+#include <emmintrin.h>
+
+#include <array>
+#include <random>
+#include <fstream>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <algorithm>
+#include <limits>
+
+namespace Foundation
+{
+
+    namespace
+    {
+        using SobolDirections = std::array<std::array<uint32_t, 4>, 32>;
+
+        // Direction numbers of the first 4 Sobol dimensions, primitive polynomial degree s,
+        // its coefficients a and initial numbers m from Joe and Kuo
+        SobolDirections MakeSobolDirections()
+        {
+            struct Polynomial
+            {
+                uint32_t S;
+                uint32_t A;
+                std::array<uint32_t, 3> M;
+            };
+
+            const std::array<Polynomial, 3> polynomials{ { { 1, 0, { 1 } }, { 2, 1, { 1, 3 } }, { 3, 1, { 1, 3, 1 } } } };
+
+            SobolDirections directions{};
+
+            for (uint32_t bit = 0; bit < 32; ++bit)
+            {
+                directions[bit][0] = 1u << (31 - bit);
+            }
+
+            for (uint32_t dimension = 1; dimension < 4; ++dimension)
+            {
+                const Polynomial& polynomial = polynomials[dimension - 1];
+
+                for (uint32_t bit = 0; bit < 32; ++bit)
+                {
+                    if (bit < polynomial.S)
+                    {
+                        directions[bit][dimension] = polynomial.M[bit] << (31 - bit);
+                        continue;
+                    }
+
+                    uint32_t direction = directions[bit - polynomial.S][dimension];
+                    direction ^= direction >> polynomial.S;
+
+                    for (uint32_t k = 1; k < polynomial.S; ++k)
+                    {
+                        if ((polynomial.A >> (polynomial.S - 1 - k)) & 1)
+                        {
+                            direction ^= directions[bit - k][dimension];
+                        }
+                    }
+
+                    directions[bit][dimension] = direction;
+                }
+            }
+
+            return directions;
+        }
+
+        const SobolDirections& GetSobolDirections()
+        {
+            static const SobolDirections directions = MakeSobolDirections();
+            return directions;
+        }
+
+        uint32_t Hash(uint32_t x)
+        {
+            x ^= x >> 16;
+            x *= 0x7feb352du;
+            x ^= x >> 15;
+            x *= 0x846ca68bu;
+            x ^= x >> 16;
+            return x;
+        }
+
+        uint32_t HashCombine(uint32_t seed, uint32_t value)
+        {
+            return seed ^ (Hash(value) + 0x9e3779b9u + (seed << 6) + (seed >> 2));
+        }
+
+        uint32_t ReverseBits(uint32_t x)
+        {
+            x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+            x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+            x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+            x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+            return (x >> 16) | (x << 16);
+        }
+
+        // Laine-Karras style permutation, each bit only depends on itself and less significant bits
+        uint32_t LaineKarrasPermutation(uint32_t x, uint32_t seed)
+        {
+            x ^= x * 0x3d20adeau;
+            x += seed;
+            x *= (seed >> 16) | 1;
+            x ^= x * 0x05526c56u;
+            x ^= x * 0x53a22864u;
+            return x;
+        }
+
+        // Owen scrambling of a 32 bit fixed point value
+        uint32_t NestedUniformScramble(uint32_t x, uint32_t seed)
+        {
+            return ReverseBits(LaineKarrasPermutation(ReverseBits(x), seed));
+        }
+
+        // Faure-Lemieux style linear scrambling: digit d of a base b dimension becomes d * multiplier mod b.
+        // Multipliers were picked greedily to minimize L2 star discrepancy of 2D projections onto lower dimensions at 1024 samples.
+        // Without them correlated high bases make 8 dimensional Halton points less uniform than random ones.
+        const std::array<uint32_t, 8> HaltonDigitMultipliers{ 1, 1, 4, 6, 10, 12, 14, 13 };
+
+        uint32_t HaltonDigitMultiplier(uint32_t dimension)
+        {
+            return dimension < HaltonDigitMultipliers.size() ? HaltonDigitMultipliers[dimension] : 1;
+        }
+
+        uint32_t SobolDimensionSeed(uint32_t seed, uint32_t dimension)
+        {
+            return Hash(HashCombine(seed, dimension));
+        }
+
+        // Dimensions of one padding group share an index shuffle, groups are shuffled independently
+        uint32_t SobolShuffleSeed(uint32_t seed, uint32_t group)
+        {
+            return Hash(HashCombine(~seed, group));
+        }
+
+        float UnitFloat(uint32_t x)
+        {
+            return float(x >> 8) * (1.0f / 16777216.0f);
+        }
+
+        // SSE2 has no 32 bit low multiplication, combine two 32x32->64 bit ones
+        __m128i MultiplyLow(__m128i a, __m128i b)
+        {
+            __m128i even = _mm_mul_epu32(a, b);
+            __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+            return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+        }
+
+        __m128i SwapBits(__m128i x, int shift, uint32_t mask)
+        {
+            __m128i maskVector = _mm_set1_epi32(int(mask));
+            __m128i high = _mm_and_si128(_mm_srli_epi32(x, shift), maskVector);
+            __m128i low = _mm_slli_epi32(_mm_and_si128(x, maskVector), shift);
+            return _mm_or_si128(high, low);
+        }
+
+        __m128i ReverseBits(__m128i x)
+        {
+            x = SwapBits(x, 1, 0x55555555u);
+            x = SwapBits(x, 2, 0x33333333u);
+            x = SwapBits(x, 4, 0x0F0F0F0Fu);
+            x = SwapBits(x, 8, 0x00FF00FFu);
+            return _mm_or_si128(_mm_srli_epi32(x, 16), _mm_slli_epi32(x, 16));
+        }
+
+        __m128i LaineKarrasPermutation(__m128i x, __m128i seed)
+        {
+            x = _mm_xor_si128(x, MultiplyLow(x, _mm_set1_epi32(0x3d20adea)));
+            x = _mm_add_epi32(x, seed);
+            x = MultiplyLow(x, _mm_or_si128(_mm_srli_epi32(seed, 16), _mm_set1_epi32(1)));
+            x = _mm_xor_si128(x, MultiplyLow(x, _mm_set1_epi32(0x05526c56)));
+            x = _mm_xor_si128(x, MultiplyLow(x, _mm_set1_epi32(0x53a22864)));
+            return x;
+        }
+
+        __m128i NestedUniformScramble(__m128i x, __m128i seed)
+        {
+            return ReverseBits(LaineKarrasPermutation(ReverseBits(x), seed));
+        }
+
+        // L2 star discrepancy by Warnock's formula, points are rows of a table
+        double L2StarDiscrepancy(const float* samples, uint32_t dimensionStride, uint32_t firstDimension, uint32_t dimensionCount, uint32_t sampleCount)
+        {
+            double firstTerm = std::pow(1.0 / 3.0, dimensionCount);
+            double secondTerm = 0.0;
+            double thirdTerm = 0.0;
+
+            for (uint32_t i = 0; i < sampleCount; ++i)
+            {
+                const float* a = samples + uint64_t(i) * dimensionStride + firstDimension;
+                double product = 1.0;
+
+                for (uint32_t k = 0; k < dimensionCount; ++k)
+                {
+                    product *= (1.0 - double(a[k]) * a[k]) * 0.5;
+                }
+
+                secondTerm += product;
+
+                for (uint32_t j = 0; j < sampleCount; ++j)
+                {
+                    const float* b = samples + uint64_t(j) * dimensionStride + firstDimension;
+                    double pairProduct = 1.0;
+
+                    for (uint32_t k = 0; k < dimensionCount; ++k)
+                    {
+                        pairProduct *= 1.0 - std::max(a[k], b[k]);
+                    }
+
+                    thirdTerm += pairProduct;
+                }
+            }
+
+            double n = sampleCount;
+            return std::sqrt(std::max(firstTerm - 2.0 * secondTerm / n + thirdTerm / (n * n), 0.0));
+        }
+
+        // Every elementary interval of volume 1 / sampleCount must hold exactly one point of a 2D projection
+        bool IsZeroNet(const float* samples, uint32_t dimensionStride, uint32_t firstDimension, uint32_t log2SampleCount)
+        {
+            uint32_t sampleCount = 1u << log2SampleCount;
+            std::vector<uint32_t> intervalCounts(sampleCount);
+
+            for (uint32_t xBits = 0; xBits <= log2SampleCount; ++xBits)
+            {
+                uint32_t yBits = log2SampleCount - xBits;
+                std::fill(intervalCounts.begin(), intervalCounts.end(), 0);
+
+                for (uint32_t i = 0; i < sampleCount; ++i)
+                {
+                    const float* sample = samples + uint64_t(i) * dimensionStride + firstDimension;
+                    uint32_t x = uint32_t(sample[0] * float(1u << xBits));
+                    uint32_t y = uint32_t(sample[1] * float(1u << yBits));
+                    ++intervalCounts[(y << xBits) | x];
+                }
+
+                for (uint32_t count : intervalCounts)
+                {
+                    if (count != 1)
+                        return false;
+                }
+            }
+
+            return true;
+        }
+    }
+
+    SamplingService& SamplingService::SharedInstance()
+    {
+        static SamplingService service;
+        return service;
+    }
+
+    SamplingService::SamplingService(uint32_t dimensionCount, uint32_t sampleCount, uint32_t seed)
+        : mDimensionCount{ dimensionCount },
+        mDimensionStride{ (dimensionCount + SIMDWidth - 1) / SIMDWidth * SIMDWidth },
+        mSampleCount{ sampleCount }
+    {
+        assert_format(dimensionCount > 0 && sampleCount > 0, "Sampling tables can't be empty");
+        assert_format(sampleCount <= (1u << 24), "Halton generation requires sample indices to be exactly representable as floats");
+
+        mHaltonSamples.resize(uint64_t(mDimensionStride) * mSampleCount);
+        mSobolSamples.resize(uint64_t(mDimensionStride) * mSampleCount);
+
+        GenerateHalton(mHaltonSamples.data(), mDimensionStride, mDimensionStride, mSampleCount);
+        GenerateSobol(mSobolSamples.data(), mDimensionStride, mDimensionStride, mSampleCount, seed);
+
+        // Generalized golden ratio, the positive root of x^(d + 1) = x + 1
+        double phi = 2.0;
+
+        for (auto i = 0; i < 30; ++i)
+        {
+            phi = std::pow(1.0 + phi, 1.0 / (dimensionCount + 1));
+        }
+
+        mLatticeGenerators.resize(dimensionCount);
+        mLatticeRotations.resize(dimensionCount);
+
+        for (uint32_t dimension = 0; dimension < dimensionCount; ++dimension)
+        {
+            mLatticeGenerators[dimension] = std::pow(1.0 / phi, dimension + 1);
+            mLatticeRotations[dimension] = UnitFloat(Hash(HashCombine(seed + 1, dimension)));
+        }
+    }
+
+    const float* SamplingService::HaltonSample(uint64_t sampleIndex) const
+    {
+        return mHaltonSamples.data() + (sampleIndex % mSampleCount) * mDimensionStride;
+    }
+
+    const float* SamplingService::SobolSample(uint64_t sampleIndex) const
+    {
+        return mSobolSamples.data() + (sampleIndex % mSampleCount) * mDimensionStride;
+    }
+
+    float SamplingService::Halton(uint64_t sampleIndex, uint32_t dimension) const
+    {
+        assert_format(dimension < mDimensionCount, "Dimension is out of range of precomputed samples");
+        return HaltonSample(sampleIndex)[dimension];
+    }
+
+    float SamplingService::Sobol(uint64_t sampleIndex, uint32_t dimension) const
+    {
+        assert_format(dimension < mDimensionCount, "Dimension is out of range of precomputed samples");
+        return SobolSample(sampleIndex)[dimension];
+    }
+
+    float SamplingService::Rank1Lattice(uint64_t sampleIndex, uint32_t dimension) const
+    {
+        assert_format(dimension < mDimensionCount, "Dimension is out of range of lattice generators");
+
+        double value = mLatticeRotations[dimension] + double(sampleIndex) * mLatticeGenerators[dimension];
+        return float(value - std::floor(value));
+    }
+
+    const Gaussian::Kernel& SamplingService::GaussianKernel(size_t radius, float sigma)
+    {
+        std::lock_guard lock{ mGaussianKernelMutex };
+
+        auto key = std::make_pair(radius, sigma);
+        auto it = mGaussianKernels.find(key);
+
+        if (it == mGaussianKernels.end())
+        {
+            it = mGaussianKernels.emplace(key, Gaussian::Kernel1D(radius, sigma)).first;
+        }
+
+        return it->second;
+    }
+
+    const Gaussian::Kernel& SamplingService::GaussianKernel(size_t radius)
+    {
+        return GaussianKernel(radius, radius / 2.0f);
+    }
+
+    void SamplingService::GenerateHalton(float* samples, uint32_t dimensionStride, uint32_t dimensionCount, uint32_t sampleCount)
+    {
+        const __m128 zero = _mm_setzero_ps();
+
+        // 4 consecutive samples of one dimension per iteration. Digits are extracted with a reciprocal
+        // multiplication, which can be off by one for large indices and is corrected afterwards.
+        for (uint32_t dimension = 0; dimension < dimensionCount; ++dimension)
+        {
+            float base = float(Halton::Prime(dimension + 1));
+            __m128 baseVector = _mm_set1_ps(base);
+            __m128 inverseBase = _mm_set1_ps(1.0f / base);
+            __m128 multiplier = _mm_set1_ps(float(HaltonDigitMultiplier(dimension)));
+
+            for (uint32_t sampleIndex = 0; sampleIndex < sampleCount; sampleIndex += SIMDWidth)
+            {
+                __m128 index = _mm_setr_ps(float(sampleIndex), float(sampleIndex + 1), float(sampleIndex + 2), float(sampleIndex + 3));
+                __m128 scale = inverseBase;
+                __m128 result = zero;
+
+                while (_mm_movemask_ps(_mm_cmpgt_ps(index, zero)) != 0)
+                {
+                    __m128 quotient = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(index, inverseBase)));
+                    __m128 digit = _mm_sub_ps(index, _mm_mul_ps(quotient, baseVector));
+
+                    __m128 isUnderflow = _mm_cmplt_ps(digit, zero);
+                    __m128 isOverflow = _mm_cmpge_ps(digit, baseVector);
+                    __m128 one = _mm_set1_ps(1.0f);
+
+                    quotient = _mm_sub_ps(quotient, _mm_and_ps(isUnderflow, one));
+                    quotient = _mm_add_ps(quotient, _mm_and_ps(isOverflow, one));
+                    digit = _mm_add_ps(digit, _mm_and_ps(isUnderflow, baseVector));
+                    digit = _mm_sub_ps(digit, _mm_and_ps(isOverflow, baseVector));
+
+                    // Same correction for the scrambled digit
+                    __m128 product = _mm_mul_ps(digit, multiplier);
+                    digit = _mm_sub_ps(product, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(product, inverseBase))), baseVector));
+                    digit = _mm_add_ps(digit, _mm_and_ps(_mm_cmplt_ps(digit, zero), baseVector));
+                    digit = _mm_sub_ps(digit, _mm_and_ps(_mm_cmpge_ps(digit, baseVector), baseVector));
+
+                    result = _mm_add_ps(result, _mm_mul_ps(digit, scale));
+                    scale = _mm_mul_ps(scale, inverseBase);
+                    index = quotient;
+                }
+
+                alignas(16) std::array<float, 4> values;
+                _mm_store_ps(values.data(), result);
+
+                for (uint32_t lane = 0; lane < SIMDWidth && sampleIndex + lane < sampleCount; ++lane)
+                {
+                    samples[uint64_t(sampleIndex + lane) * dimensionStride + dimension] = values[lane];
+                }
+            }
+        }
+    }
+
+    void SamplingService::GenerateSobol(float* samples, uint32_t dimensionStride, uint32_t dimensionCount, uint32_t sampleCount, uint32_t seed)
+    {
+        assert_format(dimensionCount % SIMDWidth == 0, "Sobol dimensions are generated in groups of 4");
+
+        const SobolDirections& directions = GetSobolDirections();
+        const __m128 toUnitFloat = _mm_set1_ps(1.0f / 16777216.0f);
+
+        __m128i directionVectors[32];
+
+        for (uint32_t bit = 0; bit < 32; ++bit)
+        {
+            directionVectors[bit] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(directions[bit].data()));
+        }
+
+        // One padding group of 4 Sobol dimensions per iteration, lanes are dimensions
+        for (uint32_t group = 0; group < dimensionCount / SobolDimensionCount; ++group)
+        {
+            uint32_t firstDimension = group * SobolDimensionCount;
+            uint32_t shuffleSeed = SobolShuffleSeed(seed, group);
+
+            __m128i dimensionSeeds = _mm_setr_epi32(
+                int(SobolDimensionSeed(seed, firstDimension)), int(SobolDimensionSeed(seed, firstDimension + 1)),
+                int(SobolDimensionSeed(seed, firstDimension + 2)), int(SobolDimensionSeed(seed, firstDimension + 3)));
+
+            for (uint32_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex)
+            {
+                uint32_t shuffledIndex = NestedUniformScramble(sampleIndex, shuffleSeed);
+                __m128i value = _mm_setzero_si128();
+
+                for (uint32_t bit = 0; shuffledIndex != 0; ++bit, shuffledIndex >>= 1)
+                {
+                    if (shuffledIndex & 1)
+                    {
+                        value = _mm_xor_si128(value, directionVectors[bit]);
+                    }
+                }
+
+                value = NestedUniformScramble(value, dimensionSeeds);
+
+                __m128 result = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(value, 8)), toUnitFloat);
+                _mm_storeu_ps(samples + uint64_t(sampleIndex) * dimensionStride + firstDimension, result);
+            }
+        }
+    }
+
+    void SamplingService::GenerateSobolScalar(float* samples, uint32_t dimensionStride, uint32_t dimensionCount, uint32_t sampleCount, uint32_t seed)
+    {
+        const SobolDirections& directions = GetSobolDirections();
+
+        for (uint32_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex)
+        {
+            for (uint32_t dimension = 0; dimension < dimensionCount; ++dimension)
+            {
+                uint32_t group = dimension / SobolDimensionCount;
+                uint32_t shuffledIndex = NestedUniformScramble(sampleIndex, SobolShuffleSeed(seed, group));
+                uint32_t value = 0;
+
+                for (uint32_t bit = 0; shuffledIndex != 0; ++bit, shuffledIndex >>= 1)
+                {
+                    if (shuffledIndex & 1)
+                    {
+                        value ^= directions[bit][dimension % SobolDimensionCount];
+                    }
+                }
+
+                value = NestedUniformScramble(value, SobolDimensionSeed(seed, dimension));
+                samples[uint64_t(sampleIndex) * dimensionStride + dimension] = UnitFloat(value);
+            }
+        }
+    }
+
+    bool SamplingService::RunBenchmark(const std::filesystem::path& reportPath)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        const uint32_t DimensionCount = 8;
+        const uint32_t SampleCount = 1u << 16;
+        const uint32_t RepeatCount = 5;
+
+        // Sample counts of discrepancy and net tests
+        const uint32_t Log2DiscrepancySampleCount = 10;
+        const uint32_t DiscrepancySampleCount = 1u << Log2DiscrepancySampleCount;
+
+        std::ofstream stream{ reportPath, std::ios::out | std::ios::trunc };
+
+        if (!stream.is_open())
+            return false;
+
+        auto measure = [&](auto&& function)
+        {
+            double bestSeconds = std::numeric_limits<double>::max();
+
+            for (uint32_t repeat = 0; repeat < RepeatCount; ++repeat)
+            {
+                auto start = Clock::now();
+                function();
+                bestSeconds = std::min(bestSeconds, std::chrono::duration<double>(Clock::now() - start).count());
+            }
+
+            // Millions of sample dimensions per second
+            return double(DimensionCount) * SampleCount / bestSeconds * 1e-6;
+        };
+
+        bool isValid = true;
+        std::vector<float> haltonTable(uint64_t(DimensionCount) * SampleCount);
+        std::vector<float> sobolTable(uint64_t(DimensionCount) * SampleCount);
+        std::vector<float> referenceTable(uint64_t(DimensionCount) * SampleCount);
+        std::vector<std::array<float, DimensionCount>> haltonSequence;
+
+        double haltonThroughput = measure([&] { GenerateHalton(haltonTable.data(), DimensionCount, DimensionCount, SampleCount); });
+        double haltonScalarThroughput = measure([&] { haltonSequence = Halton::Sequence<DimensionCount>(0, SampleCount - 1); });
+        double sobolThroughput = measure([&] { GenerateSobol(sobolTable.data(), DimensionCount, DimensionCount, SampleCount, 0); });
+        double sobolScalarThroughput = measure([&] { GenerateSobolScalar(referenceTable.data(), DimensionCount, DimensionCount, SampleCount, 0); });
+
+        // Vectorized generation must reproduce scalar results
+        double maxHaltonError = 0.0;
+
+        for (uint32_t sampleIndex = 0; sampleIndex < SampleCount; ++sampleIndex)
+        {
+            for (uint32_t dimension = 0; dimension < DimensionCount; ++dimension)
+            {
+                uint32_t base = Halton::Prime(dimension + 1);
+                uint32_t multiplier = HaltonDigitMultiplier(dimension);
+                double expected = 0.0;
+                double scale = 1.0 / base;
+
+                for (uint32_t index = sampleIndex; index > 0; index /= base, scale /= base)
+                {
+                    expected += (index % base * multiplier % base) * scale;
+                }
+
+                maxHaltonError = std::max(maxHaltonError, std::abs(expected - haltonTable[uint64_t(sampleIndex) * DimensionCount + dimension]));
+            }
+        }
+
+        bool isSobolExact = sobolTable == referenceTable;
+
+        isValid &= maxHaltonError < 1e-5;
+        isValid &= isSobolExact;
+
+        // Lookups of precomputed tables as consumers do them each frame
+        SamplingService service{ DimensionCount, SampleCount, 0 };
+        float lookupSum = 0.0f;
+
+        auto lookupStart = Clock::now();
+
+        for (uint64_t frame = 0; frame < uint64_t(SampleCount) * 4; ++frame)
+        {
+            lookupSum += service.HaltonSample(frame)[0] + service.SobolSample(frame)[1] + service.Rank1Lattice(frame, 2);
+        }
+
+        double lookupNanoseconds = std::chrono::duration<double, std::nano>(Clock::now() - lookupStart).count() / (uint64_t(SampleCount) * 4);
+
+        // Pseudo random points are the baseline low-discrepancy sequences must beat
+        std::vector<float> randomTable(uint64_t(DimensionCount) * DiscrepancySampleCount);
+        std::vector<float> latticeTable(uint64_t(DimensionCount) * DiscrepancySampleCount);
+        std::mt19937 generator{ 12345 };
+        std::uniform_real_distribution<float> distribution{ 0.0f, 1.0f };
+
+        for (uint32_t sampleIndex = 0; sampleIndex < DiscrepancySampleCount; ++sampleIndex)
+        {
+            for (uint32_t dimension = 0; dimension < DimensionCount; ++dimension)
+            {
+                randomTable[uint64_t(sampleIndex) * DimensionCount + dimension] = distribution(generator);
+                latticeTable[uint64_t(sampleIndex) * DimensionCount + dimension] = service.Rank1Lattice(sampleIndex, dimension);
+            }
+        }
+
+        struct Sequence
+        {
+            std::string Name;
+            const float* Samples;
+        };
+
+        std::vector<Sequence> sequences = {
+            { "random", randomTable.data() }, { "halton", haltonTable.data() }, { "sobol", sobolTable.data() }, { "rank1_lattice", latticeTable.data() }
+        };
+
+        double randomDiscrepancy2D = L2StarDiscrepancy(randomTable.data(), DimensionCount, 0, 2, DiscrepancySampleCount);
+
+        stream.precision(6);
+        stream << "{\"dimensions\":" << DimensionCount << ",\"samples\":" << SampleCount
+            << ",\"generation\":{\"haltonSIMD\":" << haltonThroughput << ",\"haltonScalar\":" << haltonScalarThroughput
+            << ",\"sobolSIMD\":" << sobolThroughput << ",\"sobolScalar\":" << sobolScalarThroughput
+            << ",\"unit\":\"Msamples/s\"},\"lookupNanoseconds\":" << lookupNanoseconds
+            << ",\"maxHaltonError\":" << maxHaltonError << ",\"sobolMatchesScalar\":" << (isSobolExact ? "true" : "false")
+            << ",\"discrepancySamples\":" << DiscrepancySampleCount << ",\"l2StarDiscrepancy\":[\n";
+
+        for (uint64_t sequenceIndex = 0; sequenceIndex < sequences.size(); ++sequenceIndex)
+        {
+            const Sequence& sequence = sequences[sequenceIndex];
+            double discrepancy2D = L2StarDiscrepancy(sequence.Samples, DimensionCount, 0, 2, DiscrepancySampleCount);
+            double discrepancy8D = L2StarDiscrepancy(sequence.Samples, DimensionCount, 0, DimensionCount, DiscrepancySampleCount);
+
+            if (sequence.Samples != randomTable.data())
+            {
+                isValid &= discrepancy2D < randomDiscrepancy2D;
+            }
+
+            stream << (sequenceIndex == 0 ? "" : ",\n") << "{\"name\":\"" << sequence.Name
+                << "\",\"dimensions2\":" << discrepancy2D << ",\"dimensions8\":" << discrepancy8D << "}";
+        }
+
+        // Owen scrambling and index shuffling must keep power of two prefixes of every padding group stratified
+        bool isSobolNet = true;
+
+        for (uint32_t group = 0; group < DimensionCount / SobolDimensionCount; ++group)
+        {
+            for (uint32_t log2Count = 1; log2Count <= Log2DiscrepancySampleCount; ++log2Count)
+            {
+                isSobolNet &= IsZeroNet(sobolTable.data(), DimensionCount, group * SobolDimensionCount, log2Count);
+            }
+        }
+
+        isValid &= isSobolNet;
+
+        // Memoized kernels must be computed once and match direct computation
+        const Gaussian::Kernel& kernel = service.GaussianKernel(8, 3.0f);
+        bool isKernelCached = &kernel == &service.GaussianKernel(8, 3.0f) && kernel == Gaussian::Kernel1D(8, 3.0f);
+
+        isValid &= isKernelCached;
+
+        stream << "],\"sobolZeroNet\":" << (isSobolNet ? "true" : "false")
+            << ",\"gaussianKernelCached\":" << (isKernelCached ? "true" : "false")
+            << ",\"lookupChecksum\":" << lookupSum
+            << ",\"valid\":" << (isValid ? "true" : "false") << "}\n";
+
+        return isValid && stream.good();
+    }
+
+}
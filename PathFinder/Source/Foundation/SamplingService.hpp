@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Gaussian.hpp"
+
+#include <vector>
+#include <map>
+#include <mutex>
+#include <cstdint>
+#include <filesystem>
+
+namespace Foundation
+{
+
+    /// Deterministic low-discrepancy samples and filter kernels shared by the engine.
+    /// Linearly scrambled Halton and Owen-scrambled Sobol sequences are generated once at construction for a fixed
+    /// number of dimensions and samples, so that per-frame consumers only index precomputed tables.
+    /// Consumers pass the frame number, or another running counter, as the sample index.
+    class SamplingService
+    {
+    public:
+        static SamplingService& SharedInstance();
+
+        SamplingService(uint32_t dimensionCount = DefaultDimensionCount, uint32_t sampleCount = DefaultSampleCount, uint32_t seed = 0);
+
+        // Sample indices wrap around the sample count. Dimensions of a sample are stored contiguously.
+        const float* HaltonSample(uint64_t sampleIndex) const;
+        const float* SobolSample(uint64_t sampleIndex) const;
+
+        // First two dimensions are the plain base 2 and 3 radical inverses, higher ones have their digits permuted.
+        // Large prime bases complete few digits, so 8 dimensional prefixes shorter than about 512 samples are no more uniform
+        // than random points, and neither are prefixes of more than 8 dimensions, which are left unscrambled.
+        float Halton(uint64_t sampleIndex, uint32_t dimension) const;
+
+        // Only the first 4 dimensions have their own direction numbers. Every next 4 repeat them with an independently
+        // shuffled sample order and scrambling: each group of 4 is stratified, dimensions of different groups are only randomly related.
+        float Sobol(uint64_t sampleIndex, uint32_t dimension) const;
+
+        // Cranley-Patterson rotated rank-1 lattice (R_d Kronecker sequence), not limited by the sample count
+        float Rank1Lattice(uint64_t sampleIndex, uint32_t dimension) const;
+
+        // Half of a normalized symmetric kernel, center weight first. Computed once per radius and sigma.
+        const Gaussian::Kernel& GaussianKernel(size_t radius, float sigma);
+        const Gaussian::Kernel& GaussianKernel(size_t radius);
+
+        // Compares table generation throughput with on-demand generation, checks generated values against
+        // scalar references and measures discrepancy of each sequence against pseudo random points
+        static bool RunBenchmark(const std::filesystem::path& reportPath);
+
+        inline static const uint32_t DefaultDimensionCount = 8;
+        inline static const uint32_t DefaultSampleCount = 4096;
+
+    private:
+        // Sobol dimensions with known direction numbers, higher dimensions are padded
+        // with independently shuffled and scrambled copies of these
+        inline static const uint32_t SobolDimensionCount = 4;
+
+        // Tables are generated 4 dimensions or 4 samples at a time
+        inline static const uint32_t SIMDWidth = 4;
+
+        static void GenerateHalton(float* samples, uint32_t dimensionStride, uint32_t dimensionCount, uint32_t sampleCount);
+        static void GenerateSobol(float* samples, uint32_t dimensionStride, uint32_t dimensionCount, uint32_t sampleCount, uint32_t seed);
+        static void GenerateSobolScalar(float* samples, uint32_t dimensionStride, uint32_t dimensionCount, uint32_t sampleCount, uint32_t seed);
+
+        uint32_t mDimensionCount = 0;
+        uint32_t mDimensionStride = 0;
+        uint32_t mSampleCount = 0;
+
+        std::vector<float> mHaltonSamples;
+        std::vector<float> mSobolSamples;
+        std::vector<double> mLatticeGenerators;
+        std::vector<double> mLatticeRotations;
+
+        std::map<std::pair<size_t, float>, Gaussian::Kernel> mGaussianKernels;
+        std::mutex mGaussianKernelMutex;
+
+    public:
+        inline uint32_t DimensionCount() const { return mDimensionCount; }
+        inline uint32_t SampleCount() const { return mSampleCount; }
+    };
+
+}
@@ -1,5 +1,7 @@
 #include "Spectrum.hpp"
 
+#include <algorithm>
+
 namespace Foundation
 {
 
@@ -46,356 +48,6 @@ namespace Foundation
         return sum / (lambdaEnd - lambdaStart);
     }
 
-    glm::vec3 SampledSpectrum::ToRGB() const
-    {
-        glm::vec3 xyz = ToXYZ();
-        glm::vec3 rgb;
-        XYZToRGB(xyz, rgb);
-        return rgb;
-    }
-
-    SampledSpectrum::SampledSpectrum(const CoefficientSpectrum& v, float lowestWavelength, float highestWavelength) 
-        : CoefficientSpectrum(v), mLowestWavelength{ lowestWavelength }, mHighestWavelength{ highestWavelength } {}
-
-    SampledSpectrum::SampledSpectrum(uint32_t sampleCount, float lowestWavelength, float highestWavelength) 
-        : CoefficientSpectrum(sampleCount), mLowestWavelength{ lowestWavelength }, mHighestWavelength{ highestWavelength } {}
-
-    void SampledSpectrum::Init()
-    {
-        mX = std::make_unique<SampledSpectrum>(mSamples.size(), mLowestWavelength, mHighestWavelength);
-        mY = std::make_unique<SampledSpectrum>(mSamples.size(), mLowestWavelength, mHighestWavelength);
-        mZ = std::make_unique<SampledSpectrum>(mSamples.size(), mLowestWavelength, mHighestWavelength);
-
-        mRGBRefl2SpectWhite = std::make_unique<SampledSpectrum>(mSamples.size(), mLowestWavelength, mHighestWavelength);
-        mRGBRefl2SpectCyan = std::make_unique<SampledSpectrum>(mSamples.size(), mLowestWavelength, mHighestWavelength);
-        mRGBRefl2SpectMagenta = std::make_unique<SampledSpectrum>(mSamples.size(), mLowestWavelength, mHighestWavelength);
-        mRGBRefl2SpectYellow = std::make_unique<SampledSpectrum>(mSamples.size(), mLowestWavelength, mHighestWavelength);
-        mRGBRefl2SpectRed = std::make_unique<SampledSpectrum>(mSamples.size(), mLowestWavelength, mHighestWavelength);
-        mRGBRefl2SpectGreen = std::make_unique<SampledSpectrum>(mSamples.size(), mLowestWavelength, mHighestWavelength);
-        mRGBRefl2SpectBlue = std::make_unique<SampledSpectrum>(mSamples.size(), mLowestWavelength, mHighestWavelength);
-
-        mRGBIllum2SpectWhite = std::make_unique<SampledSpectrum>(mSamples.size(), mLowestWavelength, mHighestWavelength);
-        mRGBIllum2SpectCyan = std::make_unique<SampledSpectrum>(mSamples.size(), mLowestWavelength, mHighestWavelength);
-        mRGBIllum2SpectMagenta = std::make_unique<SampledSpectrum>(mSamples.size(), mLowestWavelength, mHighestWavelength);
-        mRGBIllum2SpectYellow = std::make_unique<SampledSpectrum>(mSamples.size(), mLowestWavelength, mHighestWavelength);
-        mRGBIllum2SpectRed = std::make_unique<SampledSpectrum>(mSamples.size(), mLowestWavelength, mHighestWavelength);
-        mRGBIllum2SpectGreen = std::make_unique<SampledSpectrum>(mSamples.size(), mLowestWavelength, mHighestWavelength);
-        mRGBIllum2SpectBlue = std::make_unique<SampledSpectrum>(mSamples.size(), mLowestWavelength, mHighestWavelength);
-
-        // Compute XYZ matching functions
-        for (int i = 0; i < mSamples.size(); ++i)
-        {
-            float wl0 = glm::mix(mLowestWavelength, mHighestWavelength, float(i) / float(mSamples.size()));
-            float wl1 = glm::mix(mLowestWavelength, mHighestWavelength, float(i + 1) / float(mSamples.size()));
-
-            mX->mSamples[i] = AverageSpectrumSamples(CIE_lambda, CIE_X, nCIESamples, wl0, wl1);
-            mY->mSamples[i] = AverageSpectrumSamples(CIE_lambda, CIE_Y, nCIESamples, wl0, wl1);
-            mZ->mSamples[i] = AverageSpectrumSamples(CIE_lambda, CIE_Z, nCIESamples, wl0, wl1);
-        }
-
-        // Compute RGB to spectrum functions
-        for (int i = 0; i < mSamples.size(); ++i)
-        {
-            float wl0 = glm::mix(mLowestWavelength, mHighestWavelength, float(i) / float(mSamples.size()));
-            float wl1 = glm::mix(mLowestWavelength, mHighestWavelength, float(i + 1) / float(mSamples.size()));
-
-            mRGBRefl2SpectWhite->mSamples[i] = AverageSpectrumSamples(RGB2SpectLambda, RGBRefl2SpectWhite, nRGB2SpectSamples, wl0, wl1);
-            mRGBRefl2SpectCyan->mSamples[i] = AverageSpectrumSamples(RGB2SpectLambda, RGBRefl2SpectCyan, nRGB2SpectSamples, wl0, wl1);
-            mRGBRefl2SpectMagenta->mSamples[i] = AverageSpectrumSamples(RGB2SpectLambda, RGBRefl2SpectMagenta, nRGB2SpectSamples, wl0, wl1);
-            mRGBRefl2SpectYellow->mSamples[i] = AverageSpectrumSamples(RGB2SpectLambda, RGBRefl2SpectYellow, nRGB2SpectSamples, wl0, wl1);
-            mRGBRefl2SpectRed->mSamples[i] = AverageSpectrumSamples(RGB2SpectLambda, RGBRefl2SpectRed, nRGB2SpectSamples, wl0, wl1);
-            mRGBRefl2SpectGreen->mSamples[i] = AverageSpectrumSamples(RGB2SpectLambda, RGBRefl2SpectGreen, nRGB2SpectSamples, wl0, wl1);
-            mRGBRefl2SpectBlue->mSamples[i] = AverageSpectrumSamples(RGB2SpectLambda, RGBRefl2SpectBlue, nRGB2SpectSamples, wl0, wl1);
-
-            mRGBIllum2SpectWhite->mSamples[i] = AverageSpectrumSamples(RGB2SpectLambda, RGBIllum2SpectWhite, nRGB2SpectSamples, wl0, wl1);
-            mRGBIllum2SpectCyan->mSamples[i] = AverageSpectrumSamples(RGB2SpectLambda, RGBIllum2SpectCyan, nRGB2SpectSamples, wl0, wl1);
-            mRGBIllum2SpectMagenta->mSamples[i] = AverageSpectrumSamples(RGB2SpectLambda, RGBIllum2SpectMagenta, nRGB2SpectSamples, wl0, wl1);
-            mRGBIllum2SpectYellow->mSamples[i] = AverageSpectrumSamples(RGB2SpectLambda, RGBIllum2SpectYellow, nRGB2SpectSamples, wl0, wl1);
-            mRGBIllum2SpectRed->mSamples[i] = AverageSpectrumSamples(RGB2SpectLambda, RGBIllum2SpectRed, nRGB2SpectSamples, wl0, wl1);
-            mRGBIllum2SpectGreen->mSamples[i] = AverageSpectrumSamples(RGB2SpectLambda, RGBIllum2SpectGreen, nRGB2SpectSamples, wl0, wl1);
-            mRGBIllum2SpectBlue->mSamples[i] = AverageSpectrumSamples(RGB2SpectLambda, RGBIllum2SpectBlue, nRGB2SpectSamples, wl0, wl1);
-        }
-    }
-
-    glm::vec3 SampledSpectrum::ToXYZ() const
-    {
-        glm::vec3 xyz{ 0.0f };
-
-        for (int i = 0; i < mSamples.size(); ++i)
-        {
-            xyz[0] += mX->mSamples[i] * mSamples[i];
-            xyz[1] += mY->mSamples[i] * mSamples[i];
-            xyz[2] += mZ->mSamples[i] * mSamples[i];
-        }
-
-        float scale = float(mHighestWavelength - mLowestWavelength) /
-            float(CIE_Y_integral * mSamples.size());
-
-        xyz[0] *= scale;
-        xyz[1] *= scale;
-        xyz[2] *= scale;
-
-        return xyz;
-    }
-
-    float SampledSpectrum::Y() const
-    {
-        float yy = 0.f;
-
-        for (int i = 0; i < mSamples.size(); ++i)
-            yy += mY->mSamples[i] * mSamples[i];
-
-        return yy * float(mHighestWavelength - mLowestWavelength) /
-            float(CIE_Y_integral * mSamples.size());
-    }
-
-    void SampledSpectrum::FromRGB(const glm::vec3& rgb, SpectrumType type)
-    {
-        SampledSpectrum r{ uint32_t(mSamples.size()), mLowestWavelength, mHighestWavelength };
-
-        if (type == SpectrumType::Reflectance)
-        {
-            // Convert reflectance spectrum to RGB
-            if (rgb[0] <= rgb[1] && rgb[0] <= rgb[2])
-            {
-                // Compute reflectance _SampledSpectrum_ with _rgb[0]_ as minimum
-                r += rgb[0] * (*mRGBRefl2SpectWhite);
-                if (rgb[1] <= rgb[2]) {
-                    r += (rgb[1] - rgb[0]) * (*mRGBRefl2SpectCyan);
-                    r += (rgb[2] - rgb[1]) * (*mRGBRefl2SpectBlue);
-                }
-                else {
-                    r += (rgb[2] - rgb[0]) * (*mRGBRefl2SpectCyan);
-                    r += (rgb[1] - rgb[2]) * (*mRGBRefl2SpectGreen);
-                }
-            }
-            else if (rgb[1] <= rgb[0] && rgb[1] <= rgb[2])
-            {
-                // Compute reflectance _SampledSpectrum_ with _rgb[1]_ as minimum
-                r += rgb[1] * (*mRGBRefl2SpectWhite);
-                if (rgb[0] <= rgb[2]) {
-                    r += (rgb[0] - rgb[1]) * (*mRGBRefl2SpectMagenta);
-                    r += (rgb[2] - rgb[0]) * (*mRGBRefl2SpectBlue);
-                }
-                else {
-                    r += (rgb[2] - rgb[1]) * (*mRGBRefl2SpectMagenta);
-                    r += (rgb[0] - rgb[2]) * (*mRGBRefl2SpectRed);
-                }
-            }
-            else
-            {
-                // Compute reflectance _SampledSpectrum_ with _rgb[2]_ as minimum
-                r += rgb[2] * (*mRGBRefl2SpectWhite);
-                if (rgb[0] <= rgb[1]) {
-                    r += (rgb[0] - rgb[2]) * (*mRGBRefl2SpectYellow);
-                    r += (rgb[1] - rgb[0]) * (*mRGBRefl2SpectGreen);
-                }
-                else {
-                    r += (rgb[1] - rgb[2]) * (*mRGBRefl2SpectYellow);
-                    r += (rgb[0] - rgb[1]) * (*mRGBRefl2SpectRed);
-                }
-            }
-            r *= .94;
-        }
-        else
-        {
-            // Convert illuminant spectrum to RGB
-            if (rgb[0] <= rgb[1] && rgb[0] <= rgb[2])
-            {
-                // Compute illuminant _SampledSpectrum_ with _rgb[0]_ as minimum
-                r += rgb[0] * (*mRGBIllum2SpectWhite);
-                if (rgb[1] <= rgb[2]) {
-                    r += (rgb[1] - rgb[0]) * (*mRGBIllum2SpectCyan);
-                    r += (rgb[2] - rgb[1]) * (*mRGBIllum2SpectBlue);
-                }
-                else {
-                    r += (rgb[2] - rgb[0]) * (*mRGBIllum2SpectCyan);
-                    r += (rgb[1] - rgb[2]) * (*mRGBIllum2SpectGreen);
-                }
-            }
-            else if (rgb[1] <= rgb[0] && rgb[1] <= rgb[2])
-            {
-                // Compute illuminant _SampledSpectrum_ with _rgb[1]_ as minimum
-                r += rgb[1] * (*mRGBIllum2SpectWhite);
-                if (rgb[0] <= rgb[2]) {
-                    r += (rgb[0] - rgb[1]) * (*mRGBIllum2SpectMagenta);
-                    r += (rgb[2] - rgb[0]) * (*mRGBIllum2SpectBlue);
-                }
-                else {
-                    r += (rgb[2] - rgb[1]) * (*mRGBIllum2SpectMagenta);
-                    r += (rgb[0] - rgb[2]) * (*mRGBIllum2SpectRed);
-                }
-            }
-            else
-            {
-                // Compute illuminant _SampledSpectrum_ with _rgb[2]_ as minimum
-                r += rgb[2] * (*mRGBIllum2SpectWhite);
-                if (rgb[0] <= rgb[1]) {
-                    r += (rgb[0] - rgb[2]) * (*mRGBIllum2SpectYellow);
-                    r += (rgb[1] - rgb[0]) * (*mRGBIllum2SpectGreen);
-                }
-                else {
-                    r += (rgb[1] - rgb[2]) * (*mRGBIllum2SpectYellow);
-                    r += (rgb[0] - rgb[1]) * (*mRGBIllum2SpectRed);
-                }
-            }
-            r *= .86445f;
-        }
-
-        mSamples = r.Clamp().GetSamples();
-    }
-
-    void SampledSpectrum::FromXYZ(const glm::vec3& xyz, SpectrumType type)
-    {
-        glm::vec3 rgb;
-        XYZToRGB(xyz, rgb);
-        FromRGB(rgb, type);
-    }
-
-    CoefficientSpectrum::CoefficientSpectrum(uint32_t sampleCount)
-    {
-        mSamples.resize(sampleCount);
-    }
-
-    CoefficientSpectrum& CoefficientSpectrum::operator+=(const CoefficientSpectrum& s2)
-    {
-        for (int i = 0; i < mSamples.size(); ++i)
-            mSamples[i] += s2.mSamples[i];
-        return *this;
-    }
-
-    CoefficientSpectrum CoefficientSpectrum::operator+(const CoefficientSpectrum& s2) const
-    {
-        CoefficientSpectrum ret = *this;
-        for (int i = 0; i < mSamples.size(); ++i)
-            ret.mSamples[i] += s2.mSamples[i];
-        return ret;
-    }
-
-    CoefficientSpectrum CoefficientSpectrum::operator*(const CoefficientSpectrum& sp) const
-    {
-        CoefficientSpectrum ret = *this;
-        for (int i = 0; i < mSamples.size(); ++i)
-            ret.mSamples[i] *= sp.mSamples[i];
-        return ret;
-    }
-
-    CoefficientSpectrum& CoefficientSpectrum::operator*=(const CoefficientSpectrum& sp)
-    {
-        for (int i = 0; i < mSamples.size(); ++i)
-            mSamples[i] *= sp.mSamples[i];
-        return *this;
-    }
-
-    CoefficientSpectrum CoefficientSpectrum::operator*(float a) const
-    {
-        CoefficientSpectrum ret = *this;
-        for (int i = 0; i < mSamples.size(); ++i)
-            ret.mSamples[i] *= a;
-        return ret;
-    }
-
-    CoefficientSpectrum& CoefficientSpectrum::operator*=(float a)
-    {
-        for (int i = 0; i < mSamples.size(); ++i)
-            mSamples[i] *= a;
-        return *this;
-    }
-
-    CoefficientSpectrum CoefficientSpectrum::operator/(const CoefficientSpectrum& s2) const
-    {
-        CoefficientSpectrum ret = *this;
-        for (int i = 0; i < mSamples.size(); ++i)
-        {
-            ret.mSamples[i] /= s2.mSamples[i];
-        }
-        return ret;
-    }
-
-    CoefficientSpectrum CoefficientSpectrum::operator/(float a) const
-    {
-        CoefficientSpectrum ret = *this;
-        for (int i = 0; i < mSamples.size(); ++i)
-            ret.mSamples[i] /= a;
-        return ret;
-    }
-
-    CoefficientSpectrum& CoefficientSpectrum::operator/=(float a)
-    {
-        for (int i = 0; i < mSamples.size(); ++i)
-            mSamples[i] /= a;
-        return *this;
-    }
-
-    bool CoefficientSpectrum::operator!=(const CoefficientSpectrum& sp) const
-    {
-        return !(*this == sp);
-    }
-
-    bool CoefficientSpectrum::operator==(const CoefficientSpectrum& sp) const
-    {
-        for (int i = 0; i < mSamples.size(); ++i)
-            if (mSamples[i] != sp.mSamples[i])
-                return false;
-        return true;
-    }
-
-    float& CoefficientSpectrum::operator[](int i)
-    {
-        return mSamples[i];
-    }
-
-    float CoefficientSpectrum::operator[](int i) const
-    {
-        return mSamples[i];
-    }
-
-    bool CoefficientSpectrum::IsBlack() const
-    {
-        for (int i = 0; i < mSamples.size(); ++i)
-            if (mSamples[i] != 0.)
-                return false;
-
-        return true;
-    }
-
-    CoefficientSpectrum CoefficientSpectrum::operator-(const CoefficientSpectrum& s2) const
-    {
-        CoefficientSpectrum ret = *this;
-        for (int i = 0; i < mSamples.size(); ++i)
-            ret.mSamples[i] -= s2.mSamples[i];
-        return ret;
-    }
-
-    CoefficientSpectrum CoefficientSpectrum::operator-() const
-    {
-        CoefficientSpectrum ret{ (uint32_t)mSamples.size() };
-        for (int i = 0; i < mSamples.size(); ++i)
-            ret.mSamples[i] = -mSamples[i];
-        return ret;
-    }
-
-    float CoefficientSpectrum::MaxComponentValue() const
-    {
-        float m = mSamples[0];
-        for (int i = 1; i < mSamples.size(); ++i)
-            m = std::max(m, mSamples[i]);
-        return m;
-    }
-
-    CoefficientSpectrum CoefficientSpectrum::Clamp(float low, float high) const
-    {
-        CoefficientSpectrum ret{ (uint32_t)mSamples.size() };
-        for (int i = 0; i < mSamples.size(); ++i)
-            ret.mSamples[i] = glm::clamp(mSamples[i], low, high);
-        return ret;
-    }
-
-    CoefficientSpectrum operator*(float a, const CoefficientSpectrum& s)
-    {
-        return s * a;
-    }
-
     const float CIE_X[nCIESamples] = {
         // CIE X function values
         0.0001299000f,   0.0001458470f,   0.0001638021f,   0.0001840037f,
@@ -1,12 +1,10 @@
 #pragma once
 
-#include <vector>
-#include <memory>
 #include <glm/glm.hpp>
 
 namespace Foundation
 {
-    // A minimal adaptation of Spectrum code from PBRT v3
+    // Spectral data and conversion helpers adapted from PBRT v3, spectra themselves are FixedSpectrum
     extern float AverageSpectrumSamples(const float* lambda, const float* vals, int n, float lambdaStart, float lambdaEnd);
 
     inline void XYZToRGB(const glm::vec3& xyz, glm::vec3& rgb) 
@@ -52,83 +50,5 @@ namespace Foundation
     extern const float RGBIllum2SpectGreen[nRGB2SpectSamples];
     extern const float RGBIllum2SpectBlue[nRGB2SpectSamples];
 
-    class CoefficientSpectrum 
-    {
-    public:
-        CoefficientSpectrum(uint32_t sampleCount);
-
-        CoefficientSpectrum& operator+=(const CoefficientSpectrum& s2);
-        CoefficientSpectrum operator+(const CoefficientSpectrum& s2) const;
-        CoefficientSpectrum operator-(const CoefficientSpectrum& s2) const;
-        CoefficientSpectrum operator/(const CoefficientSpectrum& s2) const;
-        CoefficientSpectrum operator*(const CoefficientSpectrum& sp) const;
-        CoefficientSpectrum& operator*=(const CoefficientSpectrum& sp);
-        CoefficientSpectrum operator*(float a) const;
-        CoefficientSpectrum& operator*=(float a);
-        CoefficientSpectrum operator/(float a) const;
-        CoefficientSpectrum& operator/=(float a);
-        CoefficientSpectrum operator-() const;
-        bool operator==(const CoefficientSpectrum& sp) const;
-        bool operator!=(const CoefficientSpectrum& sp) const;
-        float& operator[](int i);
-        float operator[](int i) const;
-        bool IsBlack() const;
-        float MaxComponentValue() const;
-
-        CoefficientSpectrum Clamp(float low = 0, float high = std::numeric_limits<float>::infinity()) const;
-
-        friend inline CoefficientSpectrum operator*(float a, const CoefficientSpectrum& s);
-
-    protected:
-        std::vector<float> mSamples;
-
-    public:
-        inline const auto& GetSamples() const { return mSamples; }
-    };
-
-    class SampledSpectrum : public CoefficientSpectrum
-    {
-    public:
-        SampledSpectrum(uint32_t sampleCount, float lowestWavelength, float highestWavelength);
-        SampledSpectrum(const CoefficientSpectrum& v, float lowestWavelength, float highestWavelength);
-
-        glm::vec3 ToXYZ() const;
-        glm::vec3 ToRGB() const;
-
-        float Y() const;
-
-        void Init();
-        void FromRGB(const glm::vec3& rgb, SpectrumType type = SpectrumType::Illuminant);
-        void FromXYZ(const glm::vec3& xyz, SpectrumType type = SpectrumType::Reflectance);
-
-    private:
-        using CoefficientSpectrum::mSamples;
-
-        float mLowestWavelength;
-        float mHighestWavelength;
-
-        std::unique_ptr<SampledSpectrum> mX;
-        std::unique_ptr<SampledSpectrum> mY;
-        std::unique_ptr<SampledSpectrum> mZ;
-        std::unique_ptr<SampledSpectrum> mRGBRefl2SpectWhite;
-        std::unique_ptr<SampledSpectrum> mRGBRefl2SpectCyan;
-        std::unique_ptr<SampledSpectrum> mRGBRefl2SpectMagenta;
-        std::unique_ptr<SampledSpectrum> mRGBRefl2SpectYellow;
-        std::unique_ptr<SampledSpectrum> mRGBRefl2SpectRed;
-        std::unique_ptr<SampledSpectrum> mRGBRefl2SpectGreen;
-        std::unique_ptr<SampledSpectrum> mRGBRefl2SpectBlue;
-        std::unique_ptr<SampledSpectrum> mRGBIllum2SpectWhite;
-        std::unique_ptr<SampledSpectrum> mRGBIllum2SpectCyan;
-        std::unique_ptr<SampledSpectrum> mRGBIllum2SpectMagenta;
-        std::unique_ptr<SampledSpectrum> mRGBIllum2SpectYellow;
-        std::unique_ptr<SampledSpectrum> mRGBIllum2SpectRed;
-        std::unique_ptr<SampledSpectrum> mRGBIllum2SpectGreen;
-        std::unique_ptr<SampledSpectrum> mRGBIllum2SpectBlue;
-
-    public:
-        inline float LowestWavelength() const { return mLowestWavelength; }
-        inline float HighestWavelength() const { return mHighestWavelength; }
-    };
-
 }  // namespace pbrt
 
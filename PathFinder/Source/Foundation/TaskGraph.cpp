@@ -0,0 +1,121 @@
+#include "TaskGraph.hpp"
+#include "CPUProfiler.hpp"
+#include "Assert.hpp"
+
+#include <algorithm>
+
+namespace Foundation
+{
+
+    TaskGraph::NodeIndex TaskGraph::AddTask(const char* name, TaskScheduler::Task task)
+    {
+        mNodes.push_back(Node{ name, std::move(task) });
+        mIsValidated = false;
+        return mNodes.size() - 1;
+    }
+
+    void TaskGraph::AddDependency(NodeIndex dependency, NodeIndex dependent)
+    {
+        assert_format(dependency < mNodes.size() && dependent < mNodes.size() && dependency != dependent, "Invalid task graph dependency");
+
+        mNodes[dependency].Dependents.push_back(dependent);
+        mNodes[dependent].DependencyCount++;
+        mIsValidated = false;
+    }
+
+    void TaskGraph::Execute(TaskScheduler& scheduler)
+    {
+        if (mNodes.empty())
+            return;
+
+        if (!mIsValidated)
+        {
+            ValidateAcyclicity();
+            mPendingDependencies = std::make_unique<std::atomic<uint64_t>[]>(mNodes.size());
+            mIsValidated = true;
+        }
+
+        mTimings.resize(mNodes.size());
+
+        for (NodeIndex nodeIdx = 0; nodeIdx < mNodes.size(); ++nodeIdx)
+        {
+            mPendingDependencies[nodeIdx].store(mNodes[nodeIdx].DependencyCount, std::memory_order_relaxed);
+        }
+
+        TaskScheduler::Counter counter;
+
+        for (NodeIndex nodeIdx = 0; nodeIdx < mNodes.size(); ++nodeIdx)
+        {
+            if (mNodes[nodeIdx].DependencyCount == 0)
+            {
+                SubmitNode(scheduler, counter, nodeIdx);
+            }
+        }
+
+        // Dependents are submitted before their dependency's task completes,
+        // so the counter reaches zero only after the whole graph is executed
+        scheduler.Wait(counter);
+    }
+
+    uint64_t TaskGraph::ExecutionSpanNS() const
+    {
+        if (mTimings.empty())
+            return 0;
+
+        uint64_t start = std::min_element(mTimings.begin(), mTimings.end(), [](auto& a, auto& b) { return a.StartNS < b.StartNS; })->StartNS;
+        uint64_t end = std::max_element(mTimings.begin(), mTimings.end(), [](auto& a, auto& b) { return a.EndNS < b.EndNS; })->EndNS;
+        return end - start;
+    }
+
+    void TaskGraph::ValidateAcyclicity() const
+    {
+        std::vector<uint64_t> dependencyCounts(mNodes.size());
+        std::vector<NodeIndex> readyNodes;
+
+        for (NodeIndex nodeIdx = 0; nodeIdx < mNodes.size(); ++nodeIdx)
+        {
+            dependencyCounts[nodeIdx] = mNodes[nodeIdx].DependencyCount;
+            if (dependencyCounts[nodeIdx] == 0) readyNodes.push_back(nodeIdx);
+        }
+
+        uint64_t visitedCount = 0;
+
+        while (!readyNodes.empty())
+        {
+            NodeIndex nodeIdx = readyNodes.back();
+            readyNodes.pop_back();
+            ++visitedCount;
+
+            for (NodeIndex dependent : mNodes[nodeIdx].Dependents)
+            {
+                if (--dependencyCounts[dependent] == 0) readyNodes.push_back(dependent);
+            }
+        }
+
+        assert_format(visitedCount == mNodes.size(), "Task graph contains a cycle");
+    }
+
+    void TaskGraph::SubmitNode(TaskScheduler& scheduler, TaskScheduler::Counter& counter, NodeIndex nodeIndex)
+    {
+        scheduler.Submit([this, &scheduler, &counter, nodeIndex]
+        {
+            NodeTiming& timing = mTimings[nodeIndex];
+            timing.StartNS = CPUProfiler::TimestampNS();
+            timing.ThreadIndex = scheduler.CurrentQueueIndex();
+
+            mNodes[nodeIndex].Function();
+
+            timing.EndNS = CPUProfiler::TimestampNS();
+
+            for (NodeIndex dependent : mNodes[nodeIndex].Dependents)
+            {
+                if (mPendingDependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    SubmitNode(scheduler, counter, dependent);
+                }
+            }
+        }, 
+        &counter, mNodes[nodeIndex].Name);
+    }
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "TaskScheduler.hpp"
+
+#include <vector>
+#include <memory>
+
+namespace Foundation
+{
+
+    /// Directed acyclic graph of named tasks executed on a TaskScheduler.
+    /// A task is submitted as soon as all of its dependencies complete, so independent branches overlap.
+    /// Graph is built once and can be executed repeatedly, e.g. once per frame.
+    /// Start and end timestamps of every task from the last execution are kept for profiling.
+    class TaskGraph
+    {
+    public:
+        using NodeIndex = uint64_t;
+
+        struct NodeTiming
+        {
+            uint64_t StartNS = 0;
+            uint64_t EndNS = 0;
+            // Index of the queue the task ran from: 0 for the waiting thread, N + 1 for worker N
+            uint64_t ThreadIndex = 0;
+        };
+
+        // Name is used for profiler zones and must be a string literal
+        NodeIndex AddTask(const char* name, TaskScheduler::Task task);
+
+        // Dependent is not started until dependency completes
+        void AddDependency(NodeIndex dependency, NodeIndex dependent);
+
+        // Blocks until every task completes, calling thread executes tasks meanwhile
+        void Execute(TaskScheduler& scheduler);
+
+        // Time from the first task start to the last task end of the last execution
+        uint64_t ExecutionSpanNS() const;
+
+    private:
+        struct Node
+        {
+            const char* Name = nullptr;
+            TaskScheduler::Task Function;
+            std::vector<NodeIndex> Dependents;
+            uint64_t DependencyCount = 0;
+        };
+
+        void ValidateAcyclicity() const;
+        void SubmitNode(TaskScheduler& scheduler, TaskScheduler::Counter& counter, NodeIndex nodeIndex);
+
+        std::vector<Node> mNodes;
+        std::vector<NodeTiming> mTimings;
+        std::unique_ptr<std::atomic<uint64_t>[]> mPendingDependencies;
+        bool mIsValidated = false;
+
+    public:
+        inline const auto& Timings() const { return mTimings; }
+        inline const char* NodeName(NodeIndex index) const { return mNodes[index].Name; }
+        inline uint64_t NodeCount() const { return mNodes.size(); }
+    };
+
+}
@@ -0,0 +1,325 @@
+#include "TaskScheduler.hpp"
+#include "TaskGraph.hpp"
+#include "CPUProfiler.hpp"
+
+#include <fstream>
+#include <chrono>
+#include <cmath>
+#include <string>
+
+namespace Foundation
+{
+
+    namespace
+    {
+        struct WorkerIdentity
+        {
+            const TaskScheduler* Scheduler = nullptr;
+            uint64_t QueueIndex = 0;
+        };
+
+        thread_local WorkerIdentity CurrentWorker;
+
+        // Arithmetic busy work that the optimizer can't remove
+        float SimulateWork(uint64_t seed, uint64_t iterationCount)
+        {
+            float value = float(seed % 1024) * 0.001f;
+
+            for (uint64_t i = 0; i < iterationCount; ++i)
+            {
+                value = std::sin(value) * 0.5f + std::sqrt(value + 1.0f);
+            }
+
+            return value;
+        }
+    }
+
+    TaskScheduler::TaskScheduler(uint64_t workerCount, const char* workerThreadName)
+        : mWorkerThreadName{ workerThreadName }
+    {
+        for (uint64_t queueIdx = 0; queueIdx < workerCount + 1; ++queueIdx)
+        {
+            mQueues.push_back(std::make_unique<TaskQueue>());
+        }
+
+        mWorkers.reserve(workerCount);
+
+        for (uint64_t workerIdx = 0; workerIdx < workerCount; ++workerIdx)
+        {
+            mWorkers.emplace_back(&TaskScheduler::RunWorker, this, workerIdx + 1);
+        }
+    }
+
+    TaskScheduler::~TaskScheduler()
+    {
+        {
+            std::lock_guard lock{ mSleepMutex };
+            mIsStopping = true;
+        }
+
+        mWakeCondition.notify_all();
+
+        for (std::thread& worker : mWorkers)
+        {
+            worker.join();
+        }
+    }
+
+    TaskScheduler& TaskScheduler::SharedInstance()
+    {
+        static TaskScheduler scheduler{ DefaultWorkerCount(), "Task Worker" };
+        return scheduler;
+    }
+
+    void TaskScheduler::Submit(Task task, Counter* counter, const char* name)
+    {
+        if (counter)
+        {
+            counter->mValue.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        TaskQueue& queue = *mQueues[CurrentQueueIndex()];
+
+        {
+            std::lock_guard lock{ queue.Mutex };
+            queue.Tasks.push_back(TaskRecord{ std::move(task), counter, name });
+        }
+
+        mQueuedTaskCount.fetch_add(1, std::memory_order_release);
+
+        // Synchronize with workers checking the wake predicate so the notification is not lost
+        {
+            std::lock_guard lock{ mSleepMutex };
+        }
+
+        mWakeCondition.notify_one();
+    }
+
+    void TaskScheduler::Wait(const Counter& counter)
+    {
+        while (!counter.IsComplete())
+        {
+            if (!TryExecuteTask())
+            {
+                // Remaining tasks are being executed by other threads
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    TaskScheduler::Statistics TaskScheduler::GetStatistics() const
+    {
+        return { mExecutedTaskCount.load(std::memory_order_relaxed), mStolenTaskCount.load(std::memory_order_relaxed) };
+    }
+
+    uint64_t TaskScheduler::CurrentQueueIndex() const
+    {
+        return CurrentWorker.Scheduler == this ? CurrentWorker.QueueIndex : 0;
+    }
+
+    bool TaskScheduler::TryExecuteTask()
+    {
+        uint64_t queueIndex = CurrentQueueIndex();
+        TaskRecord task;
+
+        if (!TryPop(queueIndex, task) && !TrySteal(queueIndex, task))
+            return false;
+
+        mQueuedTaskCount.fetch_sub(1, std::memory_order_relaxed);
+        Execute(task);
+        return true;
+    }
+
+    bool TaskScheduler::TryPop(uint64_t queueIndex, TaskRecord& task)
+    {
+        TaskQueue& queue = *mQueues[queueIndex];
+        std::lock_guard lock{ queue.Mutex };
+
+        if (queue.Tasks.empty())
+            return false;
+
+        // Most recently pushed task is most likely to have its data in cache
+        task = std::move(queue.Tasks.back());
+        queue.Tasks.pop_back();
+        return true;
+    }
+
+    bool TaskScheduler::TrySteal(uint64_t thiefQueueIndex, TaskRecord& task)
+    {
+        uint64_t queueCount = mQueues.size();
+
+        for (uint64_t offset = 1; offset < queueCount; ++offset)
+        {
+            TaskQueue& queue = *mQueues[(thiefQueueIndex + offset) % queueCount];
+
+            // Don't wait for a busy queue, there are others to steal from
+            std::unique_lock lock{ queue.Mutex, std::try_to_lock };
+
+            if (!lock.owns_lock() || queue.Tasks.empty())
+                continue;
+
+            // Oldest tasks tend to be the largest pieces of work
+            task = std::move(queue.Tasks.front());
+            queue.Tasks.pop_front();
+            mStolenTaskCount.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        return false;
+    }
+
+    void TaskScheduler::Execute(TaskRecord& task)
+    {
+        {
+            ScopedCPUZone zone{ task.Name ? task.Name : "TaskScheduler::Task" };
+            task.Function();
+        }
+
+        mExecutedTaskCount.fetch_add(1, std::memory_order_relaxed);
+
+        if (task.TaskCounter)
+        {
+            task.TaskCounter->mValue.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+    void TaskScheduler::RunWorker(uint64_t queueIndex)
+    {
+        CurrentWorker = WorkerIdentity{ this, queueIndex };
+
+        // Private schedulers of benchmarks must not touch the shared one, its workers would compete with theirs
+        if (mWorkerThreadName)
+        {
+            CPUProfiler::SharedInstance().SetThreadName(mWorkerThreadName + (" " + std::to_string(queueIndex - 1)));
+        }
+
+        while (true)
+        {
+            if (TryExecuteTask())
+                continue;
+
+            std::unique_lock lock{ mSleepMutex };
+
+            mWakeCondition.wait(lock, [this] {
+                return mIsStopping || mQueuedTaskCount.load(std::memory_order_acquire) > 0;
+            });
+
+            if (mIsStopping)
+                return;
+        }
+    }
+
+    bool TaskScheduler::RunBenchmark(const std::filesystem::path& reportPath)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        struct Measurement
+        {
+            uint64_t ThreadCount = 0;
+            double ParallelForTime = 0.0;
+            double TaskGraphTime = 0.0;
+            uint64_t StolenTaskCount = 0;
+        };
+
+        const uint64_t LoopElementCount = 1 << 20;
+        const uint64_t LoopIterationsPerElement = 64;
+        const uint64_t GraphLayerCount = 32;
+        const uint64_t GraphLayerWidth = 256;
+        const uint64_t GraphIterationsPerTask = 4096;
+        const uint64_t RepetitionCount = 3;
+
+        std::vector<uint64_t> threadCounts = { 1, 4, 8, 16, 32, 64 };
+        std::vector<Measurement> measurements;
+        std::vector<float> loopOutput(LoopElementCount);
+        std::vector<float> graphOutput(GraphLayerCount * GraphLayerWidth);
+
+        for (uint64_t threadCount : threadCounts)
+        {
+            TaskScheduler scheduler{ threadCount - 1 };
+            Measurement measurement{ threadCount };
+
+            // Each task of a layer depends on two tasks of the previous one
+            TaskGraph graph;
+
+            for (uint64_t layer = 0; layer < GraphLayerCount; ++layer)
+            {
+                for (uint64_t taskIdx = 0; taskIdx < GraphLayerWidth; ++taskIdx)
+                {
+                    uint64_t nodeIdx = layer * GraphLayerWidth + taskIdx;
+
+                    graph.AddTask("Benchmark Task", [&graphOutput, nodeIdx, GraphIterationsPerTask] {
+                        graphOutput[nodeIdx] = SimulateWork(nodeIdx, GraphIterationsPerTask);
+                    });
+
+                    if (layer > 0)
+                    {
+                        uint64_t previousLayerStart = (layer - 1) * GraphLayerWidth;
+                        graph.AddDependency(previousLayerStart + taskIdx, nodeIdx);
+                        graph.AddDependency(previousLayerStart + (taskIdx + 1) % GraphLayerWidth, nodeIdx);
+                    }
+                }
+            }
+
+            for (uint64_t repetition = 0; repetition < RepetitionCount; ++repetition)
+            {
+                auto loopStart = Clock::now();
+
+                scheduler.ParallelFor(LoopElementCount, 256, [&loopOutput, LoopIterationsPerElement](uint64_t first, uint64_t last)
+                {
+                    for (uint64_t i = first; i < last; ++i)
+                    {
+                        loopOutput[i] = SimulateWork(i, LoopIterationsPerElement);
+                    }
+                });
+
+                auto graphStart = Clock::now();
+
+                graph.Execute(scheduler);
+
+                auto graphEnd = Clock::now();
+
+                double loopTime = std::chrono::duration<double>(graphStart - loopStart).count();
+                double graphTime = std::chrono::duration<double>(graphEnd - graphStart).count();
+
+                // Best of repetitions filters out OS scheduling noise
+                measurement.ParallelForTime = repetition == 0 ? loopTime : std::min(measurement.ParallelForTime, loopTime);
+                measurement.TaskGraphTime = repetition == 0 ? graphTime : std::min(measurement.TaskGraphTime, graphTime);
+            }
+
+            measurement.StolenTaskCount = scheduler.GetStatistics().StolenTaskCount;
+            measurements.push_back(measurement);
+        }
+
+        std::ofstream stream{ reportPath, std::ios::out | std::ios::trunc };
+
+        if (!stream.is_open())
+            return false;
+
+        const Measurement& baseline = measurements.front();
+
+        stream.precision(6);
+        stream << "{\"units\":\"seconds\",\"hardwareThreads\":" << std::thread::hardware_concurrency()
+            << ",\"loopElements\":" << LoopElementCount << ",\"graphTasks\":" << GraphLayerCount * GraphLayerWidth
+            << ",\"measurements\":[\n";
+
+        for (auto i = 0u; i < measurements.size(); ++i)
+        {
+            const Measurement& measurement = measurements[i];
+            double loopSpeedup = baseline.ParallelForTime / measurement.ParallelForTime;
+            double graphSpeedup = baseline.TaskGraphTime / measurement.TaskGraphTime;
+
+            stream << "{\"threads\":" << measurement.ThreadCount
+                << ",\"parallelForTime\":" << measurement.ParallelForTime << ",\"parallelForSpeedup\":" << loopSpeedup
+                << ",\"parallelForEfficiency\":" << loopSpeedup / measurement.ThreadCount
+                << ",\"taskGraphTime\":" << measurement.TaskGraphTime << ",\"taskGraphSpeedup\":" << graphSpeedup
+                << ",\"taskGraphEfficiency\":" << graphSpeedup / measurement.ThreadCount
+                << ",\"stolenTasks\":" << measurement.StolenTaskCount
+                << "}" << (i + 1 < measurements.size() ? ",\n" : "\n");
+        }
+
+        stream << "]}\n";
+
+        return stream.good();
+    }
+
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+namespace Foundation
+{
+
+    /// Work stealing scheduler of lightweight tasks.
+    /// Every worker owns a queue: it pushes and pops its own tasks from the back
+    /// and steals from the front of other queues when its own is empty.
+    /// Threads that are not workers (render thread) submit into a shared queue.
+    /// Waiting threads do not block, they execute pending tasks until the awaited counter drops to zero,
+    /// which makes nested waits and parallel loops inside tasks safe.
+    class TaskScheduler
+    {
+    public:
+        using Task = std::function<void()>;
+
+        // Dependency counter: incremented for each task submitted with it and decremented when the task completes
+        class Counter
+        {
+        public:
+            inline bool IsComplete() const { return mValue.load(std::memory_order_acquire) == 0; }
+
+        private:
+            friend TaskScheduler;
+            std::atomic<uint64_t> mValue = 0;
+        };
+
+        struct Statistics
+        {
+            uint64_t ExecutedTaskCount = 0;
+            uint64_t StolenTaskCount = 0;
+        };
+
+        // One thread is reserved for the thread that submits and waits on work.
+        // Workers show up under the provided name in CPU profiler captures, unnamed ones aren't registered with the profiler.
+        TaskScheduler(uint64_t workerCount = DefaultWorkerCount(), const char* workerThreadName = nullptr);
+        ~TaskScheduler();
+
+        TaskScheduler(const TaskScheduler&) = delete;
+        TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+        static TaskScheduler& SharedInstance();
+
+        // Name is used for profiler zones and must be a string literal
+        void Submit(Task task, Counter* counter = nullptr, const char* name = nullptr);
+        void Wait(const Counter& counter);
+
+        // Splits [0; count) into batches of at least minBatchSize elements,
+        // calls function(first, last) for each batch and waits for all of them
+        template <class Function>
+        void ParallelFor(uint64_t count, uint64_t minBatchSize, const Function& function, const char* name = nullptr);
+
+        Statistics GetStatistics() const;
+
+        // 0 for threads that are not workers of this scheduler, N + 1 for worker N
+        uint64_t CurrentQueueIndex() const;
+
+        // Measures scaling of parallel loops and task graphs from 1 to 64 worker threads
+        static bool RunBenchmark(const std::filesystem::path& reportPath);
+
+    private:
+        struct TaskRecord
+        {
+            Task Function;
+            Counter* TaskCounter = nullptr;
+            const char* Name = nullptr;
+        };
+
+        struct TaskQueue
+        {
+            std::mutex Mutex;
+            std::deque<TaskRecord> Tasks;
+        };
+
+        bool TryExecuteTask();
+        bool TryPop(uint64_t queueIndex, TaskRecord& task);
+        bool TrySteal(uint64_t thiefQueueIndex, TaskRecord& task);
+        void Execute(TaskRecord& task);
+        void RunWorker(uint64_t queueIndex);
+
+        // Queue 0 is shared by all non-worker threads, queue N + 1 belongs to worker N
+        std::vector<std::unique_ptr<TaskQueue>> mQueues;
+        std::vector<std::thread> mWorkers;
+        const char* mWorkerThreadName = nullptr;
+
+        std::mutex mSleepMutex;
+        std::condition_variable mWakeCondition;
+        std::atomic<uint64_t> mQueuedTaskCount = 0;
+        std::atomic<bool> mIsStopping = false;
+
+        std::atomic<uint64_t> mExecutedTaskCount = 0;
+        std::atomic<uint64_t> mStolenTaskCount = 0;
+
+    public:
+        inline static uint64_t DefaultWorkerCount() { return std::max(std::thread::hardware_concurrency(), 2u) - 1; }
+        inline uint64_t WorkerCount() const { return mWorkers.size(); }
+        // Including the thread that waits on work
+        inline uint64_t ThreadCount() const { return mWorkers.size() + 1; }
+    };
+
+}
+
+#include "TaskScheduler.inl"
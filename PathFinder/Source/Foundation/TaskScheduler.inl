@@ -0,0 +1,35 @@
+namespace Foundation
+{
+
+    template <class Function>
+    void TaskScheduler::ParallelFor(uint64_t count, uint64_t minBatchSize, const Function& function, const char* name)
+    {
+        if (count == 0)
+            return;
+
+        // A few batches per thread to let stealing even out uneven batches
+        uint64_t batchSize = std::max<uint64_t>(std::max<uint64_t>(minBatchSize, 1), count / (ThreadCount() * 4));
+        uint64_t batchCount = (count + batchSize - 1) / batchSize;
+
+        if (batchCount == 1)
+        {
+            function(0, count);
+            return;
+        }
+
+        Counter counter;
+
+        // Last batch is executed by the calling thread right away
+        for (uint64_t batch = 0; batch < batchCount - 1; ++batch)
+        {
+            uint64_t first = batch * batchSize;
+            uint64_t last = first + batchSize;
+            Submit([&function, first, last] { function(first, last); }, &counter, name);
+        }
+
+        function((batchCount - 1) * batchSize, count);
+
+        Wait(counter);
+    }
+
+}
@@ -0,0 +1,235 @@
+#include "BVH.hpp"
+
+#include <glm/common.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <limits>
+
+namespace Geometry
+{
+
+    void BVH::Build(const std::vector<AABB>& primitiveBoxes, uint32_t maxLeafPrimitiveCount)
+    {
+        mNodes.clear();
+        mPrimitiveIndices.resize(primitiveBoxes.size());
+        std::iota(mPrimitiveIndices.begin(), mPrimitiveIndices.end(), 0);
+
+        if (primitiveBoxes.empty())
+        {
+            mSAHCost = 0.0f;
+            mBuildSAHCost = 0.0f;
+            return;
+        }
+
+        std::vector<glm::vec3> centroids(primitiveBoxes.size());
+
+        for (uint64_t i = 0; i < primitiveBoxes.size(); ++i)
+        {
+            centroids[i] = primitiveBoxes[i].Сenter();
+        }
+
+        mNodes.reserve(primitiveBoxes.size() * 2 - 1);
+        mNodes.emplace_back();
+        mNodes[0].PrimitiveCount = primitiveBoxes.size();
+
+        SplitNode(0, primitiveBoxes, centroids, std::max(maxLeafPrimitiveCount, 1u), 0);
+
+        mSAHCost = ComputeSAHCost();
+        mBuildSAHCost = mSAHCost;
+    }
+
+    void BVH::Refit(const std::vector<AABB>& primitiveBoxes)
+    {
+        // Children follow parents, so a reverse pass visits children first
+        for (auto nodeIt = mNodes.rbegin(); nodeIt != mNodes.rend(); ++nodeIt)
+        {
+            Node& node = *nodeIt;
+
+            if (node.IsLeaf())
+            {
+                node.Min = glm::vec3{ std::numeric_limits<float>::max() };
+                node.Max = glm::vec3{ std::numeric_limits<float>::lowest() };
+
+                for (uint32_t slot = node.LeftChildOrFirstSlot; slot < node.LeftChildOrFirstSlot + node.PrimitiveCount; ++slot)
+                {
+                    const AABB& box = primitiveBoxes[mPrimitiveIndices[slot]];
+                    node.Min = glm::min(node.Min, box.GetMin());
+                    node.Max = glm::max(node.Max, box.GetMax());
+                }
+            }
+            else
+            {
+                const Node& left = mNodes[node.LeftChildOrFirstSlot];
+                const Node& right = mNodes[node.LeftChildOrFirstSlot + 1];
+                node.Min = glm::min(left.Min, right.Min);
+                node.Max = glm::max(left.Max, right.Max);
+            }
+        }
+
+        mSAHCost = ComputeSAHCost();
+    }
+
+    float BVH::HalfSurfaceArea(const glm::vec3& min, const glm::vec3& max)
+    {
+        glm::vec3 extent = glm::max(max - min, glm::vec3{ 0.0f });
+        return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+    }
+
+    bool BVH::IntersectNode(const Node& node, const glm::vec3& origin, const glm::vec3& inverseDirection, float minDistance, float maxDistance, float& entryDistance)
+    {
+        glm::vec3 t0 = (node.Min - origin) * inverseDirection;
+        glm::vec3 t1 = (node.Max - origin) * inverseDirection;
+        glm::vec3 tNear = glm::min(t0, t1);
+        glm::vec3 tFar = glm::max(t0, t1);
+
+        entryDistance = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, minDistance));
+        float exitDistance = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+
+        return entryDistance <= exitDistance;
+    }
+
+    void BVH::SplitNode(uint32_t nodeIndex, const std::vector<AABB>& primitiveBoxes, const std::vector<glm::vec3>& centroids, uint32_t maxLeafPrimitiveCount, uint32_t depth)
+    {
+        struct Bin
+        {
+            glm::vec3 Min{ std::numeric_limits<float>::max() };
+            glm::vec3 Max{ std::numeric_limits<float>::lowest() };
+            uint32_t Count = 0;
+        };
+
+        uint32_t first = mNodes[nodeIndex].LeftChildOrFirstSlot;
+        uint32_t count = mNodes[nodeIndex].PrimitiveCount;
+
+        glm::vec3 min{ std::numeric_limits<float>::max() };
+        glm::vec3 max{ std::numeric_limits<float>::lowest() };
+        glm::vec3 centroidMin{ std::numeric_limits<float>::max() };
+        glm::vec3 centroidMax{ std::numeric_limits<float>::lowest() };
+
+        for (uint32_t slot = first; slot < first + count; ++slot)
+        {
+            uint32_t primitiveIndex = mPrimitiveIndices[slot];
+            min = glm::min(min, primitiveBoxes[primitiveIndex].GetMin());
+            max = glm::max(max, primitiveBoxes[primitiveIndex].GetMax());
+            centroidMin = glm::min(centroidMin, centroids[primitiveIndex]);
+            centroidMax = glm::max(centroidMax, centroids[primitiveIndex]);
+        }
+
+        mNodes[nodeIndex].Min = min;
+        mNodes[nodeIndex].Max = max;
+
+        if (count <= maxLeafPrimitiveCount || depth + 1 >= MaxDepth)
+            return;
+
+        // Pick the bin plane with the lowest sum of child areas weighted by primitive counts
+        float bestCost = std::numeric_limits<float>::max();
+        uint32_t bestAxis = 0;
+        uint32_t bestPlane = 0;
+        glm::vec3 centroidExtent = centroidMax - centroidMin;
+
+        for (uint32_t axis = 0; axis < 3; ++axis)
+        {
+            if (centroidExtent[axis] <= 0.0f)
+                continue;
+
+            Bin bins[BinCount];
+            float binScale = BinCount / centroidExtent[axis];
+
+            for (uint32_t slot = first; slot < first + count; ++slot)
+            {
+                uint32_t primitiveIndex = mPrimitiveIndices[slot];
+                uint32_t binIndex = std::min(uint32_t((centroids[primitiveIndex][axis] - centroidMin[axis]) * binScale), BinCount - 1);
+                Bin& bin = bins[binIndex];
+                bin.Min = glm::min(bin.Min, primitiveBoxes[primitiveIndex].GetMin());
+                bin.Max = glm::max(bin.Max, primitiveBoxes[primitiveIndex].GetMax());
+                ++bin.Count;
+            }
+
+            float leftCosts[BinCount - 1];
+            Bin left;
+
+            for (uint32_t plane = 0; plane < BinCount - 1; ++plane)
+            {
+                left.Min = glm::min(left.Min, bins[plane].Min);
+                left.Max = glm::max(left.Max, bins[plane].Max);
+                left.Count += bins[plane].Count;
+                leftCosts[plane] = left.Count > 0 ? HalfSurfaceArea(left.Min, left.Max) * left.Count : 0.0f;
+            }
+
+            Bin right;
+
+            for (uint32_t plane = BinCount - 1; plane > 0; --plane)
+            {
+                right.Min = glm::min(right.Min, bins[plane].Min);
+                right.Max = glm::max(right.Max, bins[plane].Max);
+                right.Count += bins[plane].Count;
+
+                float cost = leftCosts[plane - 1] + (right.Count > 0 ? HalfSurfaceArea(right.Min, right.Max) * right.Count : 0.0f);
+
+                if (right.Count < count && cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestPlane = plane;
+                }
+            }
+        }
+
+        uint32_t middle = first;
+
+        if (bestCost < std::numeric_limits<float>::max())
+        {
+            float binScale = BinCount / centroidExtent[bestAxis];
+
+            auto middleIt = std::partition(mPrimitiveIndices.begin() + first, mPrimitiveIndices.begin() + first + count, [&](uint32_t primitiveIndex)
+            {
+                return std::min(uint32_t((centroids[primitiveIndex][bestAxis] - centroidMin[bestAxis]) * binScale), BinCount - 1) < bestPlane;
+            });
+
+            middle = uint32_t(middleIt - mPrimitiveIndices.begin());
+        }
+
+        // Coincident centroids can't be separated by planes, split them in halves
+        if (middle == first || middle == first + count)
+        {
+            middle = first + count / 2;
+        }
+
+        uint32_t leftIndex = mNodes.size();
+
+        mNodes.emplace_back();
+        mNodes.back().LeftChildOrFirstSlot = first;
+        mNodes.back().PrimitiveCount = middle - first;
+
+        mNodes.emplace_back();
+        mNodes.back().LeftChildOrFirstSlot = middle;
+        mNodes.back().PrimitiveCount = first + count - middle;
+
+        mNodes[nodeIndex].LeftChildOrFirstSlot = leftIndex;
+        mNodes[nodeIndex].PrimitiveCount = 0;
+
+        SplitNode(leftIndex, primitiveBoxes, centroids, maxLeafPrimitiveCount, depth + 1);
+        SplitNode(leftIndex + 1, primitiveBoxes, centroids, maxLeafPrimitiveCount, depth + 1);
+    }
+
+    float BVH::ComputeSAHCost() const
+    {
+        if (mNodes.empty())
+            return 0.0f;
+
+        float rootArea = HalfSurfaceArea(mNodes[0].Min, mNodes[0].Max);
+
+        if (rootArea <= 0.0f)
+            return 0.0f;
+
+        float cost = 0.0f;
+
+        for (const Node& node : mNodes)
+        {
+            cost += HalfSurfaceArea(node.Min, node.Max) * (node.IsLeaf() ? node.PrimitiveCount : 1);
+        }
+
+        return cost / rootArea;
+    }
+
+}
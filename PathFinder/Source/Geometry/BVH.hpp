@@ -0,0 +1,79 @@
+#pragma once
+
+#include "AABB.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <vector>
+#include <cstdint>
+
+namespace Geometry
+{
+
+    /// Bounding volume hierarchy over boxes of arbitrary primitives, built with a binned surface area heuristic.
+    /// Nodes are stored in one array with children always placed after their parent,
+    /// which lets refitting run as a single reverse pass over the array.
+    /// Primitives are addressed by slots: leaves cover contiguous slot ranges,
+    /// and PrimitiveIndex(slot) maps a slot back to the index of the box passed to Build.
+    class BVH
+    {
+    public:
+        struct Node
+        {
+            glm::vec3 Min;
+            uint32_t LeftChildOrFirstSlot = 0;
+            glm::vec3 Max;
+            uint32_t PrimitiveCount = 0;
+
+            inline bool IsLeaf() const { return PrimitiveCount > 0; }
+        };
+
+        // Traversal stack never overflows because deeper nodes are turned into leaves during build
+        inline static const uint32_t MaxDepth = 64;
+        inline static const uint32_t BinCount = 16;
+
+        void Build(const std::vector<AABB>& primitiveBoxes, uint32_t maxLeafPrimitiveCount = 4);
+
+        // Keeps topology and recomputes node bounds from moved primitives.
+        // Primitive count and order must match the last build.
+        void Refit(const std::vector<AABB>& primitiveBoxes);
+
+        // Visits leaf slots of nodes the ray passes through, nearest nodes first.
+        // Visitor is called as bool(uint32_t slot, float& maxDistance): it may shrink maxDistance
+        // to prune farther nodes and returns true to stop traversal.
+        // Direction does not have to be normalized, distances are measured in its lengths.
+        template <class SlotVisitor>
+        void Traverse(const glm::vec3& origin, const glm::vec3& direction, float minDistance, float maxDistance, SlotVisitor&& visitor) const;
+
+    private:
+        struct StackEntry
+        {
+            uint32_t NodeIndex;
+            float EntryDistance;
+        };
+
+        static float HalfSurfaceArea(const glm::vec3& min, const glm::vec3& max);
+        static bool IntersectNode(const Node& node, const glm::vec3& origin, const glm::vec3& inverseDirection, float minDistance, float maxDistance, float& entryDistance);
+
+        void SplitNode(uint32_t nodeIndex, const std::vector<AABB>& primitiveBoxes, const std::vector<glm::vec3>& centroids, uint32_t maxLeafPrimitiveCount, uint32_t depth);
+        float ComputeSAHCost() const;
+
+        std::vector<Node> mNodes;
+        std::vector<uint32_t> mPrimitiveIndices;
+        float mSAHCost = 0.0f;
+        float mBuildSAHCost = 0.0f;
+
+    public:
+        inline const auto& Nodes() const { return mNodes; }
+        inline uint32_t PrimitiveIndex(uint32_t slot) const { return mPrimitiveIndices[slot]; }
+        inline uint64_t PrimitiveCount() const { return mPrimitiveIndices.size(); }
+        inline bool IsEmpty() const { return mNodes.empty(); }
+
+        // Expected cost of a ray query relative to testing the root box, grows as refits loosen the tree
+        inline float SAHCost() const { return mSAHCost; }
+        inline float BuildSAHCost() const { return mBuildSAHCost; }
+    };
+
+}
+
+#include "BVH.inl"
@@ -0,0 +1,77 @@
+namespace Geometry
+{
+
+    template <class SlotVisitor>
+    void BVH::Traverse(const glm::vec3& origin, const glm::vec3& direction, float minDistance, float maxDistance, SlotVisitor&& visitor) const
+    {
+        if (mNodes.empty())
+            return;
+
+        glm::vec3 inverseDirection = 1.0f / direction;
+
+        float entryDistance = 0.0f;
+
+        if (!IntersectNode(mNodes[0], origin, inverseDirection, minDistance, maxDistance, entryDistance))
+            return;
+
+        StackEntry stack[MaxDepth];
+        uint32_t stackSize = 0;
+        uint32_t nodeIndex = 0;
+
+        while (true)
+        {
+            const Node& node = mNodes[nodeIndex];
+
+            if (node.IsLeaf())
+            {
+                for (uint32_t slot = node.LeftChildOrFirstSlot; slot < node.LeftChildOrFirstSlot + node.PrimitiveCount; ++slot)
+                {
+                    if (visitor(slot, maxDistance))
+                        return;
+                }
+            }
+            else
+            {
+                uint32_t nearIndex = node.LeftChildOrFirstSlot;
+                uint32_t farIndex = nearIndex + 1;
+                float nearDistance = 0.0f;
+                float farDistance = 0.0f;
+
+                bool isNearHit = IntersectNode(mNodes[nearIndex], origin, inverseDirection, minDistance, maxDistance, nearDistance);
+                bool isFarHit = IntersectNode(mNodes[farIndex], origin, inverseDirection, minDistance, maxDistance, farDistance);
+
+                if (isNearHit && isFarHit)
+                {
+                    if (farDistance < nearDistance)
+                    {
+                        std::swap(nearIndex, farIndex);
+                        std::swap(nearDistance, farDistance);
+                    }
+
+                    stack[stackSize++] = { farIndex, farDistance };
+                    nodeIndex = nearIndex;
+                    continue;
+                }
+
+                if (isNearHit || isFarHit)
+                {
+                    nodeIndex = isNearHit ? nearIndex : farIndex;
+                    continue;
+                }
+            }
+
+            // Skip nodes that a closer hit found since pushing has moved out of range
+            do
+            {
+                if (stackSize == 0)
+                    return;
+
+                --stackSize;
+            }
+            while (stack[stackSize].EntryDistance > maxDistance);
+
+            nodeIndex = stack[stackSize].NodeIndex;
+        }
+    }
+
+}
@@ -0,0 +1,647 @@
+#include "CollisionKernels.hpp"
+#include "Collision.hpp"
+
+#include <intrin.h>
+#include <immintrin.h>
+
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <random>
+#include <fstream>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <algorithm>
+
+namespace Geometry
+{
+
+    namespace CollisionKernels
+    {
+
+        namespace
+        {
+            // Kernels are written once against these lane types. Operations are issued in the same order
+            // for every width and without fused multiply-adds, so all instruction sets agree bit for bit.
+
+            struct ScalarLanes
+            {
+                using Float = float;
+                using Mask = bool;
+
+                inline static const uint32_t Width = 1;
+
+                static Float Load(const float* source) { return *source; }
+                static void Store(float* destination, Float value) { *destination = value; }
+                static Float Set(float value) { return value; }
+                static Float Add(Float a, Float b) { return a + b; }
+                static Float Sub(Float a, Float b) { return a - b; }
+                static Float Mul(Float a, Float b) { return a * b; }
+                static Float Div(Float a, Float b) { return a / b; }
+                static Float Min(Float a, Float b) { return a < b ? a : b; }
+                static Float Max(Float a, Float b) { return a > b ? a : b; }
+                static Mask Less(Float a, Float b) { return a < b; }
+                static Mask LessEqual(Float a, Float b) { return a <= b; }
+                static Mask GreaterEqual(Float a, Float b) { return a >= b; }
+                static Mask And(Mask a, Mask b) { return a && b; }
+                static Mask True() { return true; }
+                static Float Select(Mask mask, Float a, Float b) { return mask ? a : b; }
+                static uint32_t Bits(Mask mask) { return mask ? 1 : 0; }
+            };
+
+            struct SSELanes
+            {
+                using Float = __m128;
+                using Mask = __m128;
+
+                inline static const uint32_t Width = 4;
+
+                static Float Load(const float* source) { return _mm_loadu_ps(source); }
+                static void Store(float* destination, Float value) { _mm_storeu_ps(destination, value); }
+                static Float Set(float value) { return _mm_set1_ps(value); }
+                static Float Add(Float a, Float b) { return _mm_add_ps(a, b); }
+                static Float Sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+                static Float Mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+                static Float Div(Float a, Float b) { return _mm_div_ps(a, b); }
+                static Float Min(Float a, Float b) { return _mm_min_ps(a, b); }
+                static Float Max(Float a, Float b) { return _mm_max_ps(a, b); }
+                static Mask Less(Float a, Float b) { return _mm_cmplt_ps(a, b); }
+                static Mask LessEqual(Float a, Float b) { return _mm_cmple_ps(a, b); }
+                static Mask GreaterEqual(Float a, Float b) { return _mm_cmpge_ps(a, b); }
+                static Mask And(Mask a, Mask b) { return _mm_and_ps(a, b); }
+                static Mask True() { return _mm_castsi128_ps(_mm_set1_epi32(-1)); }
+                static Float Select(Mask mask, Float a, Float b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+                static uint32_t Bits(Mask mask) { return uint32_t(_mm_movemask_ps(mask)); }
+            };
+
+            struct AVXLanes
+            {
+                using Float = __m256;
+                using Mask = __m256;
+
+                inline static const uint32_t Width = 8;
+
+                static Float Load(const float* source) { return _mm256_loadu_ps(source); }
+                static void Store(float* destination, Float value) { _mm256_storeu_ps(destination, value); }
+                static Float Set(float value) { return _mm256_set1_ps(value); }
+                static Float Add(Float a, Float b) { return _mm256_add_ps(a, b); }
+                static Float Sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+                static Float Mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+                static Float Div(Float a, Float b) { return _mm256_div_ps(a, b); }
+                static Float Min(Float a, Float b) { return _mm256_min_ps(a, b); }
+                static Float Max(Float a, Float b) { return _mm256_max_ps(a, b); }
+                static Mask Less(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+                static Mask LessEqual(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+                static Mask GreaterEqual(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+                static Mask And(Mask a, Mask b) { return _mm256_and_ps(a, b); }
+                static Mask True() { return _mm256_castsi256_ps(_mm256_set1_epi32(-1)); }
+                static Float Select(Mask mask, Float a, Float b) { return _mm256_blendv_ps(b, a, mask); }
+                static uint32_t Bits(Mask mask) { return uint32_t(_mm256_movemask_ps(mask)); }
+            };
+
+            InstructionSet DetectInstructionSet()
+            {
+                std::array<int, 4> registers;
+
+                __cpuid(registers.data(), 0);
+                int leafCount = registers[0];
+
+                __cpuid(registers.data(), 1);
+                bool hasAVX = (registers[2] & (1 << 28)) != 0;
+                bool hasOSXSave = (registers[2] & (1 << 27)) != 0;
+
+                // OS must save YMM registers on context switches
+                bool isYMMStateEnabled = hasOSXSave && (_xgetbv(0) & 0x6) == 0x6;
+
+                if (leafCount >= 7 && hasAVX && isYMMStateEnabled)
+                {
+                    __cpuidex(registers.data(), 7, 0);
+
+                    if ((registers[1] & (1 << 5)) != 0)
+                        return InstructionSet::AVX2;
+                }
+
+                // SSE2 is part of x64
+                return InstructionSet::SSE;
+            }
+
+            InstructionSet& ActiveInstructionSetStorage()
+            {
+                static InstructionSet set = SupportedInstructionSet();
+                return set;
+            }
+
+            void StoreBits(uint32_t bits, uint32_t width, uint8_t* destination)
+            {
+                for (uint32_t lane = 0; lane < width; ++lane)
+                {
+                    destination[lane] = (bits >> lane) & 1;
+                }
+            }
+
+            // Runs the widest kernel over whole registers and the scalar one over the rest
+            template <class Function>
+            void ForEachBatch(uint64_t count, const Function& function)
+            {
+                uint64_t vectorizedCount = 0;
+
+                switch (ActiveInstructionSet())
+                {
+                case InstructionSet::AVX2:
+                    vectorizedCount = count / AVXLanes::Width * AVXLanes::Width;
+                    function(AVXLanes{}, 0, vectorizedCount);
+                    break;
+
+                case InstructionSet::SSE:
+                    vectorizedCount = count / SSELanes::Width * SSELanes::Width;
+                    function(SSELanes{}, 0, vectorizedCount);
+                    break;
+
+                default:
+                    break;
+                }
+
+                function(ScalarLanes{}, vectorizedCount, count);
+            }
+
+            template <class Lanes>
+            void RayAABBsKernel(Lanes, const Ray3D& ray, const AABBSoA& boxes, uint64_t first, uint64_t last, uint8_t* hits, float* distances)
+            {
+                using Float = typename Lanes::Float;
+                using Mask = typename Lanes::Mask;
+
+                glm::vec3 inverseDirection = glm::vec3(1.0) / ray.direction;
+
+                Float originX = Lanes::Set(ray.origin.x);
+                Float originY = Lanes::Set(ray.origin.y);
+                Float originZ = Lanes::Set(ray.origin.z);
+                Float inverseX = Lanes::Set(inverseDirection.x);
+                Float inverseY = Lanes::Set(inverseDirection.y);
+                Float inverseZ = Lanes::Set(inverseDirection.z);
+                Float zero = Lanes::Set(0.0f);
+
+                for (uint64_t i = first; i < last; i += Lanes::Width)
+                {
+                    Float t1 = Lanes::Mul(Lanes::Sub(Lanes::Load(&boxes.MinX[i]), originX), inverseX);
+                    Float t2 = Lanes::Mul(Lanes::Sub(Lanes::Load(&boxes.MaxX[i]), originX), inverseX);
+                    Float t3 = Lanes::Mul(Lanes::Sub(Lanes::Load(&boxes.MinY[i]), originY), inverseY);
+                    Float t4 = Lanes::Mul(Lanes::Sub(Lanes::Load(&boxes.MaxY[i]), originY), inverseY);
+                    Float t5 = Lanes::Mul(Lanes::Sub(Lanes::Load(&boxes.MinZ[i]), originZ), inverseZ);
+                    Float t6 = Lanes::Mul(Lanes::Sub(Lanes::Load(&boxes.MaxZ[i]), originZ), inverseZ);
+
+                    Float tMin = Lanes::Max(Lanes::Max(Lanes::Min(t1, t2), Lanes::Min(t3, t4)), Lanes::Min(t5, t6));
+                    Float tMax = Lanes::Min(Lanes::Min(Lanes::Max(t1, t2), Lanes::Max(t3, t4)), Lanes::Max(t5, t6));
+
+                    Mask isHit = Lanes::And(Lanes::GreaterEqual(tMax, zero), Lanes::LessEqual(tMin, tMax));
+
+                    Lanes::Store(distances + i, Lanes::Select(isHit, tMin, tMax));
+                    StoreBits(Lanes::Bits(isHit), Lanes::Width, hits + i);
+                }
+            }
+
+            template <class Lanes>
+            void RayTrianglesKernel(Lanes, const Ray3D& ray, const TriangleSoA& triangles, uint64_t first, uint64_t last, uint8_t* hits, float* distances)
+            {
+                using Float = typename Lanes::Float;
+                using Mask = typename Lanes::Mask;
+
+                Float originX = Lanes::Set(ray.origin.x);
+                Float originY = Lanes::Set(ray.origin.y);
+                Float originZ = Lanes::Set(ray.origin.z);
+                Float directionX = Lanes::Set(ray.direction.x);
+                Float directionY = Lanes::Set(ray.direction.y);
+                Float directionZ = Lanes::Set(ray.direction.z);
+                Float zero = Lanes::Set(0.0f);
+                Float one = Lanes::Set(1.0f);
+                Float infinity = Lanes::Set(std::numeric_limits<float>::infinity());
+
+                for (uint64_t i = first; i < last; i += Lanes::Width)
+                {
+                    Float edgeABX = Lanes::Load(&triangles.EdgeABX[i]);
+                    Float edgeABY = Lanes::Load(&triangles.EdgeABY[i]);
+                    Float edgeABZ = Lanes::Load(&triangles.EdgeABZ[i]);
+                    Float edgeACX = Lanes::Load(&triangles.EdgeACX[i]);
+                    Float edgeACY = Lanes::Load(&triangles.EdgeACY[i]);
+                    Float edgeACZ = Lanes::Load(&triangles.EdgeACZ[i]);
+
+                    // P = D x AC
+                    Float pX = Lanes::Sub(Lanes::Mul(directionY, edgeACZ), Lanes::Mul(directionZ, edgeACY));
+                    Float pY = Lanes::Sub(Lanes::Mul(directionZ, edgeACX), Lanes::Mul(directionX, edgeACZ));
+                    Float pZ = Lanes::Sub(Lanes::Mul(directionX, edgeACY), Lanes::Mul(directionY, edgeACX));
+
+                    Float determinant = Lanes::Add(Lanes::Add(Lanes::Mul(edgeABX, pX), Lanes::Mul(edgeABY, pY)), Lanes::Mul(edgeABZ, pZ));
+                    Float inverseDeterminant = Lanes::Div(one, determinant);
+
+                    // T = O - A
+                    Float tX = Lanes::Sub(originX, Lanes::Load(&triangles.AX[i]));
+                    Float tY = Lanes::Sub(originY, Lanes::Load(&triangles.AY[i]));
+                    Float tZ = Lanes::Sub(originZ, Lanes::Load(&triangles.AZ[i]));
+
+                    Float u = Lanes::Mul(Lanes::Add(Lanes::Add(Lanes::Mul(tX, pX), Lanes::Mul(tY, pY)), Lanes::Mul(tZ, pZ)), inverseDeterminant);
+
+                    // Q = T x AB
+                    Float qX = Lanes::Sub(Lanes::Mul(tY, edgeABZ), Lanes::Mul(tZ, edgeABY));
+                    Float qY = Lanes::Sub(Lanes::Mul(tZ, edgeABX), Lanes::Mul(tX, edgeABZ));
+                    Float qZ = Lanes::Sub(Lanes::Mul(tX, edgeABY), Lanes::Mul(tY, edgeABX));
+
+                    Float v = Lanes::Mul(Lanes::Add(Lanes::Add(Lanes::Mul(directionX, qX), Lanes::Mul(directionY, qY)), Lanes::Mul(directionZ, qZ)), inverseDeterminant);
+                    Float t = Lanes::Mul(Lanes::Add(Lanes::Add(Lanes::Mul(edgeACX, qX), Lanes::Mul(edgeACY, qY)), Lanes::Mul(edgeACZ, qZ)), inverseDeterminant);
+
+                    // Collision::RayTriangle only accepts rays hitting the side its plane normal, cross(AC, AB), faces
+                    Mask isHit = Lanes::Less(determinant, zero);
+                    isHit = Lanes::And(isHit, Lanes::GreaterEqual(u, zero));
+                    isHit = Lanes::And(isHit, Lanes::GreaterEqual(v, zero));
+                    isHit = Lanes::And(isHit, Lanes::LessEqual(Lanes::Add(u, v), one));
+                    isHit = Lanes::And(isHit, Lanes::GreaterEqual(t, zero));
+
+                    Lanes::Store(distances + i, Lanes::Select(isHit, t, infinity));
+                    StoreBits(Lanes::Bits(isHit), Lanes::Width, hits + i);
+                }
+            }
+
+            template <class Lanes>
+            void FrustumAABBsKernel(Lanes, const FrustumPlanes& planes, const AABBSoA& boxes, uint64_t first, uint64_t last, uint8_t* visible)
+            {
+                using Float = typename Lanes::Float;
+                using Mask = typename Lanes::Mask;
+
+                Float zero = Lanes::Set(0.0f);
+
+                for (uint64_t i = first; i < last; i += Lanes::Width)
+                {
+                    Mask isVisible = Lanes::True();
+
+                    for (const glm::vec4& plane : planes)
+                    {
+                        // Corner furthest along the plane normal is picked per axis from the normal's sign
+                        Float x = Lanes::Load(plane.x >= 0.0f ? &boxes.MaxX[i] : &boxes.MinX[i]);
+                        Float y = Lanes::Load(plane.y >= 0.0f ? &boxes.MaxY[i] : &boxes.MinY[i]);
+                        Float z = Lanes::Load(plane.z >= 0.0f ? &boxes.MaxZ[i] : &boxes.MinZ[i]);
+
+                        Float distance = Lanes::Add(Lanes::Add(Lanes::Add(
+                            Lanes::Mul(Lanes::Set(plane.x), x), Lanes::Mul(Lanes::Set(plane.y), y)), Lanes::Mul(Lanes::Set(plane.z), z)), Lanes::Set(plane.w));
+
+                        isVisible = Lanes::And(isVisible, Lanes::GreaterEqual(distance, zero));
+                    }
+
+                    StoreBits(Lanes::Bits(isVisible), Lanes::Width, visible + i);
+                }
+            }
+
+            template <class Lanes>
+            void TransformAABBsKernel(Lanes, const glm::mat4& transform, const AABBSoA& boxes, uint64_t first, uint64_t last, AABBSoA& transformedBoxes)
+            {
+                using Float = typename Lanes::Float;
+
+                Float half = Lanes::Set(0.5f);
+
+                std::array<const std::vector<float>*, 3> mins = { &boxes.MinX, &boxes.MinY, &boxes.MinZ };
+                std::array<const std::vector<float>*, 3> maxs = { &boxes.MaxX, &boxes.MaxY, &boxes.MaxZ };
+                std::array<std::vector<float>*, 3> transformedMins = { &transformedBoxes.MinX, &transformedBoxes.MinY, &transformedBoxes.MinZ };
+                std::array<std::vector<float>*, 3> transformedMaxs = { &transformedBoxes.MaxX, &transformedBoxes.MaxY, &transformedBoxes.MaxZ };
+
+                for (uint64_t i = first; i < last; i += Lanes::Width)
+                {
+                    Float centers[3];
+                    Float extents[3];
+
+                    for (uint32_t axis = 0; axis < 3; ++axis)
+                    {
+                        Float min = Lanes::Load(&(*mins[axis])[i]);
+                        Float max = Lanes::Load(&(*maxs[axis])[i]);
+                        centers[axis] = Lanes::Mul(Lanes::Add(min, max), half);
+                        extents[axis] = Lanes::Mul(Lanes::Sub(max, min), half);
+                    }
+
+                    // Each output extent sums input extents scaled by absolute matrix entries of its row
+                    for (uint32_t row = 0; row < 3; ++row)
+                    {
+                        Float center = Lanes::Set(transform[3][row]);
+                        Float extent = Lanes::Set(0.0f);
+
+                        for (uint32_t column = 0; column < 3; ++column)
+                        {
+                            center = Lanes::Add(center, Lanes::Mul(Lanes::Set(transform[column][row]), centers[column]));
+                            extent = Lanes::Add(extent, Lanes::Mul(Lanes::Set(std::abs(transform[column][row])), extents[column]));
+                        }
+
+                        Lanes::Store(&(*transformedMins[row])[i], Lanes::Sub(center, extent));
+                        Lanes::Store(&(*transformedMaxs[row])[i], Lanes::Add(center, extent));
+                    }
+                }
+            }
+        }
+
+        void AABBSoA::Resize(uint64_t count)
+        {
+            for (std::vector<float>* component : { &MinX, &MinY, &MinZ, &MaxX, &MaxY, &MaxZ })
+            {
+                component->resize(count);
+            }
+        }
+
+        void AABBSoA::Set(uint64_t index, const AABB& box)
+        {
+            MinX[index] = box.GetMin().x; MinY[index] = box.GetMin().y; MinZ[index] = box.GetMin().z;
+            MaxX[index] = box.GetMax().x; MaxY[index] = box.GetMax().y; MaxZ[index] = box.GetMax().z;
+        }
+
+        AABB AABBSoA::Get(uint64_t index) const
+        {
+            return { { MinX[index], MinY[index], MinZ[index] }, { MaxX[index], MaxY[index], MaxZ[index] } };
+        }
+
+        uint64_t AABBSoA::Size() const
+        {
+            return MinX.size();
+        }
+
+        void TriangleSoA::Resize(uint64_t count)
+        {
+            for (std::vector<float>* component : { &AX, &AY, &AZ, &EdgeABX, &EdgeABY, &EdgeABZ, &EdgeACX, &EdgeACY, &EdgeACZ })
+            {
+                component->resize(count);
+            }
+        }
+
+        void TriangleSoA::Set(uint64_t index, const Triangle3D& triangle)
+        {
+            glm::vec3 edgeAB = triangle.b - triangle.a;
+            glm::vec3 edgeAC = triangle.c - triangle.a;
+
+            AX[index] = triangle.a.x; AY[index] = triangle.a.y; AZ[index] = triangle.a.z;
+            EdgeABX[index] = edgeAB.x; EdgeABY[index] = edgeAB.y; EdgeABZ[index] = edgeAB.z;
+            EdgeACX[index] = edgeAC.x; EdgeACY[index] = edgeAC.y; EdgeACZ[index] = edgeAC.z;
+        }
+
+        uint64_t TriangleSoA::Size() const
+        {
+            return AX.size();
+        }
+
+        FrustumPlanes ExtractFrustumPlanes(const glm::mat4& viewProjection)
+        {
+            glm::mat4 m = glm::transpose(viewProjection);
+
+            // Rows of the matrix combined as in Gribb-Hartmann, near plane is z >= 0 in clip space
+            FrustumPlanes planes = { m[3] + m[0], m[3] - m[0], m[3] + m[1], m[3] - m[1], m[2], m[3] - m[2] };
+
+            for (glm::vec4& plane : planes)
+            {
+                plane /= glm::length(glm::vec3{ plane });
+            }
+
+            return planes;
+        }
+
+        InstructionSet SupportedInstructionSet()
+        {
+            static InstructionSet set = DetectInstructionSet();
+            return set;
+        }
+
+        InstructionSet ActiveInstructionSet()
+        {
+            return ActiveInstructionSetStorage();
+        }
+
+        void SetActiveInstructionSet(InstructionSet set)
+        {
+            ActiveInstructionSetStorage() = std::min(set, SupportedInstructionSet());
+        }
+
+        void RayAABBs(const Ray3D& ray, const AABBSoA& boxes, uint8_t* hits, float* distances)
+        {
+            ForEachBatch(boxes.Size(), [&](auto lanes, uint64_t first, uint64_t last)
+            {
+                RayAABBsKernel(lanes, ray, boxes, first, last, hits, distances);
+            });
+        }
+
+        void RayTriangles(const Ray3D& ray, const TriangleSoA& triangles, uint8_t* hits, float* distances)
+        {
+            ForEachBatch(triangles.Size(), [&](auto lanes, uint64_t first, uint64_t last)
+            {
+                RayTrianglesKernel(lanes, ray, triangles, first, last, hits, distances);
+            });
+        }
+
+        void FrustumAABBs(const FrustumPlanes& planes, const AABBSoA& boxes, uint8_t* visible)
+        {
+            ForEachBatch(boxes.Size(), [&](auto lanes, uint64_t first, uint64_t last)
+            {
+                FrustumAABBsKernel(lanes, planes, boxes, first, last, visible);
+            });
+        }
+
+        void TransformAABBs(const glm::mat4& transform, const AABBSoA& boxes, AABBSoA& transformedBoxes)
+        {
+            transformedBoxes.Resize(boxes.Size());
+
+            ForEachBatch(boxes.Size(), [&](auto lanes, uint64_t first, uint64_t last)
+            {
+                TransformAABBsKernel(lanes, transform, boxes, first, last, transformedBoxes);
+            });
+        }
+
+        bool RunBenchmark(const std::filesystem::path& reportPath)
+        {
+            using Clock = std::chrono::steady_clock;
+
+            // Odd count so that scalar tails of vectorized loops are exercised
+            const uint64_t PrimitiveCount = 4099;
+            const uint64_t QueryCount = 256;
+            const uint32_t RepeatCount = 3;
+
+            std::ofstream stream{ reportPath, std::ios::out | std::ios::trunc };
+
+            if (!stream.is_open())
+                return false;
+
+            std::mt19937 generator{ 12345 };
+            std::uniform_real_distribution<float> positionDistribution{ -10.0f, 10.0f };
+            std::uniform_real_distribution<float> sizeDistribution{ 0.1f, 4.0f };
+            std::uniform_real_distribution<float> unitDistribution{ -1.0f, 1.0f };
+
+            auto randomVector = [&](std::uniform_real_distribution<float>& distribution)
+            {
+                return glm::vec3{ distribution(generator), distribution(generator), distribution(generator) };
+            };
+
+            std::vector<AABB> boxList;
+            std::vector<Triangle3D> triangleList;
+            std::vector<Ray3D> rays;
+            std::vector<FrustumPlanes> frustums;
+            std::vector<glm::mat4> transforms;
+
+            AABBSoA boxes;
+            TriangleSoA triangles;
+
+            boxes.Resize(PrimitiveCount);
+            triangles.Resize(PrimitiveCount);
+
+            for (uint64_t i = 0; i < PrimitiveCount; ++i)
+            {
+                glm::vec3 min = randomVector(positionDistribution);
+                glm::vec3 a = randomVector(positionDistribution);
+
+                boxList.emplace_back(min, min + randomVector(sizeDistribution));
+                triangleList.emplace_back(a, a + randomVector(unitDistribution) * 3.0f, a + randomVector(unitDistribution) * 3.0f);
+                boxes.Set(i, boxList.back());
+                triangles.Set(i, triangleList.back());
+            }
+
+            for (uint64_t i = 0; i < QueryCount; ++i)
+            {
+                glm::vec3 origin = randomVector(positionDistribution) * 2.0f;
+                glm::vec3 target = randomVector(positionDistribution) * 0.5f;
+                glm::vec3 up = std::abs(glm::normalize(target - origin).y) > 0.99f ? glm::vec3{ 1, 0, 0 } : glm::vec3{ 0, 1, 0 };
+
+                rays.emplace_back(origin, glm::normalize(target - origin));
+                frustums.push_back(ExtractFrustumPlanes(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 30.0f) * glm::lookAt(origin, target, up)));
+
+                glm::quat rotation = glm::angleAxis(unitDistribution(generator) * 3.14159f, glm::normalize(randomVector(unitDistribution) + glm::vec3{ 0.0f, 0.0f, 1e-3f }));
+                transforms.push_back(glm::translate(glm::mat4{ 1.0f }, randomVector(positionDistribution)) * glm::mat4_cast(rotation) * glm::scale(glm::mat4{ 1.0f }, randomVector(sizeDistribution)));
+            }
+
+            std::vector<uint8_t> hits(PrimitiveCount);
+            std::vector<float> distances(PrimitiveCount);
+            std::vector<uint8_t> referenceHits(PrimitiveCount);
+            std::vector<float> referenceDistances(PrimitiveCount);
+            AABBSoA transformedBoxes;
+
+            std::vector<InstructionSet> sets = { InstructionSet::Scalar, InstructionSet::SSE };
+
+            if (SupportedInstructionSet() == InstructionSet::AVX2)
+            {
+                sets.push_back(InstructionSet::AVX2);
+            }
+
+            // Scalar reference of a frustum test: culled if all 8 corners are outside one plane
+            auto isVisibleReference = [](const FrustumPlanes& planes, const AABB& box)
+            {
+                std::array<glm::vec4, 8> corners = box.CornerPoints();
+
+                for (const glm::vec4& plane : planes)
+                {
+                    bool isOutside = true;
+
+                    for (const glm::vec4& corner : corners)
+                    {
+                        float distance = plane.x * corner.x + plane.y * corner.y + plane.z * corner.z + plane.w;
+                        isOutside &= distance < 0.0f;
+                    }
+
+                    if (isOutside)
+                        return false;
+                }
+
+                return true;
+            };
+
+            // Scalar reference of a transform: bounds of 8 transformed corners
+            auto transformReference = [](const glm::mat4& transform, const AABB& box)
+            {
+                std::array<glm::vec4, 8> corners = box.CornerPoints();
+
+                for (glm::vec4& corner : corners)
+                {
+                    corner = transform * corner;
+                }
+
+                return AABB{ corners.begin(), corners.end() };
+            };
+
+            // Millions of primitive tests per second, best of several runs over all queries
+            auto measure = [&](auto&& function)
+            {
+                double bestSeconds = std::numeric_limits<double>::max();
+
+                for (uint32_t repeat = 0; repeat < RepeatCount; ++repeat)
+                {
+                    auto start = Clock::now();
+
+                    for (uint64_t query = 0; query < QueryCount; ++query)
+                    {
+                        function(query);
+                    }
+
+                    bestSeconds = std::min(bestSeconds, std::chrono::duration<double>(Clock::now() - start).count());
+                }
+
+                return double(PrimitiveCount) * QueryCount / bestSeconds * 1e-6;
+            };
+
+            double referenceRayAABB = measure([&](uint64_t query)
+            {
+                for (uint64_t i = 0; i < PrimitiveCount; ++i)
+                {
+                    referenceHits[i] = Collision::RayAABB(rays[query], boxList[i], referenceDistances[i]);
+                }
+            });
+
+            double referenceRayTriangle = measure([&](uint64_t query)
+            {
+                for (uint64_t i = 0; i < PrimitiveCount; ++i)
+                {
+                    referenceHits[i] = Collision::RayTriangle(rays[query], triangleList[i], referenceDistances[i]);
+                }
+            });
+
+            double referenceFrustumAABB = measure([&](uint64_t query)
+            {
+                for (uint64_t i = 0; i < PrimitiveCount; ++i)
+                {
+                    referenceHits[i] = isVisibleReference(frustums[query], boxList[i]);
+                }
+            });
+
+            double referenceTransformAABB = measure([&](uint64_t query)
+            {
+                for (uint64_t i = 0; i < PrimitiveCount; ++i)
+                {
+                    transformedBoxes.Set(i, transformReference(transforms[query], boxList[i]));
+                }
+            });
+
+            const std::array<std::string, 3> setNames = { "scalar", "sse", "avx2" };
+
+            stream.precision(6);
+            stream << "{\"primitives\":" << PrimitiveCount << ",\"queries\":" << QueryCount
+                << ",\"supportedSet\":\"" << setNames[uint32_t(SupportedInstructionSet())] << "\""
+                << ",\"unit\":\"Mtests/s\",\"collisionReference\":{"
+                << "\"rayAABB\":" << referenceRayAABB
+                << ",\"rayTriangle\":" << referenceRayTriangle
+                << ",\"frustumAABB\":" << referenceFrustumAABB
+                << ",\"transformAABB\":" << referenceTransformAABB
+                << "},\"sets\":[\n";
+
+            for (uint64_t setIndex = 0; setIndex < sets.size(); ++setIndex)
+            {
+                SetActiveInstructionSet(sets[setIndex]);
+
+                double rayAABB = measure([&](uint64_t query) { RayAABBs(rays[query], boxes, hits.data(), distances.data()); });
+                double rayTriangle = measure([&](uint64_t query) { RayTriangles(rays[query], triangles, hits.data(), distances.data()); });
+                double frustumAABB = measure([&](uint64_t query) { FrustumAABBs(frustums[query], boxes, hits.data()); });
+                double transformAABB = measure([&](uint64_t query) { TransformAABBs(transforms[query], boxes, transformedBoxes); });
+
+                stream << (setIndex == 0 ? "" : ",\n") << "{\"name\":\"" << setNames[uint32_t(sets[setIndex])] << "\""
+                    << ",\"rayAABB\":" << rayAABB
+                    << ",\"rayTriangle\":" << rayTriangle
+                    << ",\"frustumAABB\":" << frustumAABB
+                    << ",\"transformAABB\":" << transformAABB << "}";
+            }
+
+            SetActiveInstructionSet(SupportedInstructionSet());
+
+            stream << "]}\n";
+
+            return stream.good();
+        }
+
+    }
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "AABB.hpp"
+#include "Ray3D.hpp"
+#include "Triangle3D.hpp"
+
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <vector>
+#include <array>
+#include <filesystem>
+
+namespace Geometry
+{
+
+    /// Batched counterparts of Collision tests that run one ray or frustum against many primitives
+    /// stored in structure of arrays layout, 4 or 8 primitives per instruction.
+    /// Instruction set is selected at runtime from what the CPU supports; every set produces
+    /// the same results as the scalar Collision functions they mirror.
+    namespace CollisionKernels
+    {
+        enum class InstructionSet
+        {
+            Scalar, SSE, AVX2
+        };
+
+        struct AABBSoA
+        {
+            std::vector<float> MinX, MinY, MinZ;
+            std::vector<float> MaxX, MaxY, MaxZ;
+
+            void Resize(uint64_t count);
+            void Set(uint64_t index, const AABB& box);
+            AABB Get(uint64_t index) const;
+            uint64_t Size() const;
+        };
+
+        // Triangles are stored as the first vertex and two edges leaving it
+        struct TriangleSoA
+        {
+            std::vector<float> AX, AY, AZ;
+            std::vector<float> EdgeABX, EdgeABY, EdgeABZ;
+            std::vector<float> EdgeACX, EdgeACY, EdgeACZ;
+
+            void Resize(uint64_t count);
+            void Set(uint64_t index, const Triangle3D& triangle);
+            uint64_t Size() const;
+        };
+
+        // Plane normals point inside the frustum, W is the distance term: dot(N, P) + W >= 0 inside
+        using FrustumPlanes = std::array<glm::vec4, 6>;
+
+        // Planes of a view projection matrix with [0, 1] depth range
+        FrustumPlanes ExtractFrustumPlanes(const glm::mat4& viewProjection);
+
+        // Widest set supported by the CPU and the OS, detected once
+        InstructionSet SupportedInstructionSet();
+        InstructionSet ActiveInstructionSet();
+
+        // Restricts kernels to a narrower set than supported. Wider than supported sets are clamped.
+        void SetActiveInstructionSet(InstructionSet set);
+
+        // Same semantics as Collision::RayAABB for every box, outputs have boxes.Size() entries
+        void RayAABBs(const Ray3D& ray, const AABBSoA& boxes, uint8_t* hits, float* distances);
+
+        // Möller-Trumbore test accepting the same triangle side as Collision::RayTriangle
+        void RayTriangles(const Ray3D& ray, const TriangleSoA& triangles, uint8_t* hits, float* distances);
+
+        // A box is culled when all its corners are outside of one plane
+        void FrustumAABBs(const FrustumPlanes& planes, const AABBSoA& boxes, uint8_t* visible);
+
+        // Exact bounds of boxes under an affine transform by Arvo's method
+        void TransformAABBs(const glm::mat4& transform, const AABBSoA& boxes, AABBSoA& transformedBoxes);
+
+        // Measures throughput of every instruction set and of the scalar Collision functions they mirror
+        bool RunBenchmark(const std::filesystem::path& reportPath);
+    }
+
+}
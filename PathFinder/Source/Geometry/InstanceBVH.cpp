@@ -0,0 +1,510 @@
+#include "InstanceBVH.hpp"
+
+#include <glm/geometric.hpp>
+#include <glm/common.hpp>
+#include <glm/gtc/matrix_inverse.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <random>
+#include <fstream>
+#include <chrono>
+#include <cmath>
+
+namespace Geometry
+{
+
+    namespace
+    {
+        // Exact bounds of a transformed box by Arvo's method
+        AABB TransformedBounds(const AABB& box, const glm::mat4& transform)
+        {
+            glm::vec3 center = (box.GetMin() + box.GetMax()) * 0.5f;
+            glm::vec3 extent = (box.GetMax() - box.GetMin()) * 0.5f;
+            glm::vec3 transformedCenter = glm::vec3{ transform * glm::vec4{ center, 1.0f } };
+            glm::vec3 transformedExtent{ 0.0f };
+
+            for (uint32_t column = 0; column < 3; ++column)
+            {
+                transformedExtent += glm::abs(glm::vec3{ transform[column] }) * extent[column];
+            }
+
+            return { transformedCenter - transformedExtent, transformedCenter + transformedExtent };
+        }
+
+        // Direction is left unnormalized so that distances along it stay in world units
+        void ToObjectSpace(const glm::mat4& worldToObject, const Ray3D& ray, glm::vec3& origin, glm::vec3& direction)
+        {
+            origin = glm::vec3{ worldToObject * glm::vec4{ ray.origin, 1.0f } };
+            direction = glm::vec3{ worldToObject * glm::vec4{ ray.direction, 0.0f } };
+        }
+    }
+
+    void InstanceBVH::Clear()
+    {
+        mInstances.clear();
+    }
+
+    void InstanceBVH::AddInstance(const TriangleBVH* hierarchy, const glm::mat4& transform)
+    {
+        mInstances.push_back({ hierarchy, glm::affineInverse(transform) });
+
+        if (mInstanceBoxes.size() < mInstances.size())
+        {
+            mInstanceBoxes.emplace_back();
+        }
+
+        // Empty hierarchies get a box no ray can reach
+        mInstanceBoxes[mInstances.size() - 1] = hierarchy->TriangleCount() > 0 ?
+            TransformedBounds(hierarchy->BoundingBox(), transform) : AABB::MaximumReversed();
+    }
+
+    void InstanceBVH::Build()
+    {
+        mInstanceBoxes.resize(mInstances.size());
+
+        if (CanRefit())
+        {
+            mBVH.Refit(mInstanceBoxes);
+            mWasRefit = mBVH.SAHCost() <= mBVH.BuildSAHCost() * RebuildCostRatio;
+
+            if (mWasRefit)
+                return;
+        }
+
+        // Instance boxes may overlap heavily, so leaves hold single instances
+        mBVH.Build(mInstanceBoxes, 1);
+        mWasRefit = false;
+
+        mBuiltHierarchies.resize(mInstances.size());
+
+        for (uint64_t i = 0; i < mInstances.size(); ++i)
+        {
+            mBuiltHierarchies[i] = mInstances[i].Hierarchy;
+        }
+    }
+
+    std::optional<InstanceBVH::Hit> InstanceBVH::ClosestHit(const Ray3D& ray, float minDistance, float maxDistance, bool cullBackFaces) const
+    {
+        std::optional<Hit> closestHit;
+
+        mBVH.Traverse(ray.origin, ray.direction, minDistance, maxDistance, [&](uint32_t slot, float& currentMaxDistance)
+        {
+            uint32_t instanceIndex = mBVH.PrimitiveIndex(slot);
+            const Instance& instance = mInstances[instanceIndex];
+
+            glm::vec3 origin;
+            glm::vec3 direction;
+            ToObjectSpace(instance.WorldToObject, ray, origin, direction);
+
+            if (std::optional<TriangleBVH::Hit> hit = instance.Hierarchy->ClosestHit(origin, direction, minDistance, currentMaxDistance, cullBackFaces))
+            {
+                currentMaxDistance = hit->Distance;
+                closestHit = Hit{ hit->Distance, instanceIndex, hit->TriangleIndex, hit->Barycentrics };
+            }
+
+            return false;
+        });
+
+        return closestHit;
+    }
+
+    bool InstanceBVH::AnyHit(const Ray3D& ray, float minDistance, float maxDistance, bool cullBackFaces) const
+    {
+        bool isHit = false;
+
+        mBVH.Traverse(ray.origin, ray.direction, minDistance, maxDistance, [&](uint32_t slot, float& currentMaxDistance)
+        {
+            const Instance& instance = mInstances[mBVH.PrimitiveIndex(slot)];
+
+            glm::vec3 origin;
+            glm::vec3 direction;
+            ToObjectSpace(instance.WorldToObject, ray, origin, direction);
+
+            isHit = instance.Hierarchy->AnyHit(origin, direction, minDistance, currentMaxDistance, cullBackFaces);
+            return isHit;
+        });
+
+        return isHit;
+    }
+
+    bool InstanceBVH::CanRefit() const
+    {
+        if (mBVH.IsEmpty() || mBuiltHierarchies.size() != mInstances.size())
+            return false;
+
+        for (uint64_t i = 0; i < mInstances.size(); ++i)
+        {
+            if (mBuiltHierarchies[i] != mInstances[i].Hierarchy)
+                return false;
+        }
+
+        return true;
+    }
+
+    bool InstanceBVH::RunBenchmark(const std::filesystem::path& reportPath)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        struct MeshData
+        {
+            std::vector<glm::vec3> Positions;
+            std::vector<uint32_t> Indices;
+        };
+
+        std::ofstream stream{ reportPath, std::ios::out | std::ios::trunc };
+
+        if (!stream.is_open())
+            return false;
+
+        std::mt19937 generator{ 777 };
+        std::uniform_real_distribution<float> unitDistribution{ 0.0f, 1.0f };
+
+        auto milliseconds = [](Clock::time_point start)
+        {
+            return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        };
+
+        auto makeSphere = [](uint32_t segmentCount, uint32_t ringCount)
+        {
+            MeshData mesh;
+
+            for (uint32_t ring = 0; ring <= ringCount; ++ring)
+            {
+                for (uint32_t segment = 0; segment <= segmentCount; ++segment)
+                {
+                    float theta = 3.14159265f * ring / ringCount;
+                    float phi = 2.0f * 3.14159265f * segment / segmentCount;
+                    mesh.Positions.emplace_back(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+                }
+            }
+
+            for (uint32_t ring = 0; ring < ringCount; ++ring)
+            {
+                for (uint32_t segment = 0; segment < segmentCount; ++segment)
+                {
+                    uint32_t a = ring * (segmentCount + 1) + segment;
+                    uint32_t b = a + segmentCount + 1;
+                    mesh.Indices.insert(mesh.Indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+                }
+            }
+
+            return mesh;
+        };
+
+        auto makeTerrain = [&](uint32_t resolution)
+        {
+            MeshData mesh;
+            float frequency = 4.0f + unitDistribution(generator) * 8.0f;
+
+            for (uint32_t z = 0; z <= resolution; ++z)
+            {
+                for (uint32_t x = 0; x <= resolution; ++x)
+                {
+                    float u = float(x) / resolution;
+                    float v = float(z) / resolution;
+                    mesh.Positions.emplace_back(u * 2.0f - 1.0f, 0.1f * std::sin(u * frequency) * std::cos(v * frequency), v * 2.0f - 1.0f);
+                }
+            }
+
+            for (uint32_t z = 0; z < resolution; ++z)
+            {
+                for (uint32_t x = 0; x < resolution; ++x)
+                {
+                    uint32_t a = z * (resolution + 1) + x;
+                    uint32_t b = a + resolution + 1;
+                    mesh.Indices.insert(mesh.Indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+                }
+            }
+
+            return mesh;
+        };
+
+        auto makeTriangleSoup = [&](uint32_t triangleCount)
+        {
+            MeshData mesh;
+
+            for (uint32_t i = 0; i < triangleCount; ++i)
+            {
+                glm::vec3 center{ unitDistribution(generator), unitDistribution(generator), unitDistribution(generator) };
+                center = center * 2.0f - 1.0f;
+
+                for (uint32_t vertex = 0; vertex < 3; ++vertex)
+                {
+                    glm::vec3 offset{ unitDistribution(generator), unitDistribution(generator), unitDistribution(generator) };
+                    mesh.Indices.push_back(mesh.Positions.size());
+                    mesh.Positions.push_back(center + (offset - 0.5f) * 0.1f);
+                }
+            }
+
+            return mesh;
+        };
+
+        auto makeMeshes = [&](uint32_t detail)
+        {
+            std::vector<MeshData> meshes;
+            meshes.push_back(makeSphere(16 * detail, 8 * detail));
+            meshes.push_back(makeSphere(6 * detail, 3 * detail));
+            meshes.push_back(makeTerrain(24 * detail));
+            meshes.push_back(makeTerrain(8 * detail));
+            meshes.push_back(makeTriangleSoup(1200 * detail * detail));
+            meshes.push_back(makeTriangleSoup(100 * detail * detail));
+            return meshes;
+        };
+
+        auto makeTransforms = [&](uint32_t count, float sceneSize)
+        {
+            std::vector<glm::mat4> transforms;
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                glm::vec3 position{ unitDistribution(generator) - 0.5f, unitDistribution(generator) * 0.1f, unitDistribution(generator) - 0.5f };
+                glm::vec3 axis = glm::normalize(glm::vec3{ unitDistribution(generator), unitDistribution(generator), unitDistribution(generator) } + 0.01f);
+                glm::quat rotation = glm::angleAxis(unitDistribution(generator) * 6.2831853f, axis);
+                float scale = 1.0f + unitDistribution(generator) * 4.0f;
+
+                transforms.push_back(glm::translate(glm::mat4{ 1.0f }, position * sceneSize) * glm::mat4_cast(rotation) * glm::scale(glm::mat4{ 1.0f }, glm::vec3{ scale }));
+            }
+
+            return transforms;
+        };
+
+        auto makeRays = [&](uint32_t count, float sceneSize)
+        {
+            std::vector<Ray3D> rays;
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                glm::vec3 origin{ unitDistribution(generator) - 0.5f, unitDistribution(generator) * 0.1f, unitDistribution(generator) - 0.5f };
+                glm::vec3 direction{ unitDistribution(generator) - 0.5f, unitDistribution(generator) - 0.5f, unitDistribution(generator) - 0.5f };
+                rays.emplace_back(origin * sceneSize, direction + glm::vec3{ 0.0f, 0.0f, 1e-4f });
+            }
+
+            return rays;
+        };
+
+        auto buildHierarchies = [](const std::vector<MeshData>& meshes)
+        {
+            std::vector<TriangleBVH> hierarchies;
+
+            for (const MeshData& mesh : meshes)
+            {
+                hierarchies.emplace_back(mesh.Positions, mesh.Indices);
+            }
+
+            return hierarchies;
+        };
+
+        auto addInstances = [](InstanceBVH& bvh, const std::vector<TriangleBVH>& hierarchies, const std::vector<glm::mat4>& transforms)
+        {
+            bvh.Clear();
+
+            for (uint64_t i = 0; i < transforms.size(); ++i)
+            {
+                bvh.AddInstance(&hierarchies[i % hierarchies.size()], transforms[i]);
+            }
+
+            bvh.Build();
+        };
+
+        // Slowly drifting and spinning instances, as if animated
+        auto animate = [](std::vector<glm::mat4>& transforms, uint32_t frame)
+        {
+            for (uint64_t i = 0; i < transforms.size(); ++i)
+            {
+                float phase = float(i % 17) + frame * 0.05f;
+                glm::vec3 velocity{ std::sin(phase), 0.0f, std::cos(phase) };
+                transforms[i] = glm::translate(glm::mat4{ 1.0f }, velocity * 0.5f) * transforms[i] * glm::rotate(glm::mat4{ 1.0f }, 0.02f, glm::vec3{ 0, 1, 0 });
+            }
+        };
+
+        // Brute force over every triangle of every instance with the same ray and triangle arithmetic
+        auto bruteForceClosestHit = [](const std::vector<MeshData>& meshes, const std::vector<glm::mat4>& transforms, const Ray3D& ray, bool cullBackFaces)
+        {
+            float closestDistance = std::numeric_limits<float>::max();
+            bool isHit = false;
+
+            for (uint64_t instanceIdx = 0; instanceIdx < transforms.size(); ++instanceIdx)
+            {
+                const MeshData& mesh = meshes[instanceIdx % meshes.size()];
+
+                glm::vec3 origin;
+                glm::vec3 direction;
+                ToObjectSpace(glm::affineInverse(transforms[instanceIdx]), ray, origin, direction);
+
+                for (uint64_t index = 0; index < mesh.Indices.size(); index += 3)
+                {
+                    glm::vec3 a = mesh.Positions[mesh.Indices[index]];
+                    glm::vec3 edgeAB = mesh.Positions[mesh.Indices[index + 1]] - a;
+                    glm::vec3 edgeAC = mesh.Positions[mesh.Indices[index + 2]] - a;
+
+                    glm::vec3 p = glm::cross(direction, edgeAC);
+                    float determinant = glm::dot(edgeAB, p);
+
+                    if (cullBackFaces ? determinant >= 0.0f : determinant == 0.0f)
+                        continue;
+
+                    float inverseDeterminant = 1.0f / determinant;
+                    glm::vec3 t = origin - a;
+                    float u = glm::dot(t, p) * inverseDeterminant;
+                    glm::vec3 q = glm::cross(t, edgeAB);
+                    float v = glm::dot(direction, q) * inverseDeterminant;
+                    float distance = glm::dot(edgeAC, q) * inverseDeterminant;
+
+                    if (u >= 0.0f && u <= 1.0f && v >= 0.0f && u + v <= 1.0f && distance >= 0.0f && distance < closestDistance)
+                    {
+                        closestDistance = distance;
+                        isHit = true;
+                    }
+                }
+            }
+
+            return isHit ? std::optional<float>{ closestDistance } : std::nullopt;
+        };
+
+        bool isValid = true;
+
+        // Correctness on a scene small enough for brute force, right after build and after refits
+        std::vector<MeshData> smallMeshes = makeMeshes(1);
+        std::vector<TriangleBVH> smallHierarchies = buildHierarchies(smallMeshes);
+        std::vector<glm::mat4> smallTransforms = makeTransforms(48, 40.0f);
+        std::vector<Ray3D> smallRays = makeRays(1024, 40.0f);
+        InstanceBVH smallBVH;
+
+        uint64_t closestHitMismatches = 0;
+        uint64_t anyHitMismatches = 0;
+        uint64_t checkedHits = 0;
+        bool wasSmallSceneRefit = false;
+
+        for (uint32_t frame = 0; frame < 3; ++frame)
+        {
+            addInstances(smallBVH, smallHierarchies, smallTransforms);
+            wasSmallSceneRefit |= smallBVH.WasRefit();
+
+            for (uint64_t rayIdx = 0; rayIdx < smallRays.size(); ++rayIdx)
+            {
+                const Ray3D& ray = smallRays[rayIdx];
+                bool cullBackFaces = rayIdx % 2 == 1;
+
+                std::optional<float> reference = bruteForceClosestHit(smallMeshes, smallTransforms, ray, cullBackFaces);
+                std::optional<Hit> hit = smallBVH.ClosestHit(ray, 0.0f, std::numeric_limits<float>::max(), cullBackFaces);
+
+                closestHitMismatches += reference.has_value() != hit.has_value() ||
+                    (hit && std::abs(hit->Distance - *reference) > 1e-5f * std::max(*reference, 1.0f));
+
+                anyHitMismatches += smallBVH.AnyHit(ray, 0.0f, std::numeric_limits<float>::max(), cullBackFaces) != reference.has_value();
+
+                // Range limited query must agree with the unlimited one
+                if (hit)
+                {
+                    anyHitMismatches += !smallBVH.AnyHit(ray, 0.0f, hit->Distance * 1.001f, cullBackFaces);
+                    anyHitMismatches += smallBVH.AnyHit(ray, 0.0f, hit->Distance * 0.999f, cullBackFaces) !=
+                        smallBVH.ClosestHit(ray, 0.0f, hit->Distance * 0.999f, cullBackFaces).has_value();
+                    ++checkedHits;
+                }
+            }
+
+            animate(smallTransforms, frame);
+        }
+
+        isValid &= closestHitMismatches == 0 && anyHitMismatches == 0 && checkedHits > 0 && wasSmallSceneRefit;
+
+        // Throughput on a large scene
+        const uint32_t LargeInstanceCount = 4096;
+        const uint32_t AnimatedFrameCount = 16;
+        const float LargeSceneSize = 600.0f;
+
+        std::vector<MeshData> largeMeshes = makeMeshes(6);
+        uint64_t meshTriangleCount = 0;
+
+        for (const MeshData& mesh : largeMeshes)
+        {
+            meshTriangleCount += mesh.Indices.size() / 3;
+        }
+
+        auto start = Clock::now();
+        std::vector<TriangleBVH> largeHierarchies = buildHierarchies(largeMeshes);
+        double meshBuildMs = milliseconds(start);
+
+        std::vector<glm::mat4> largeTransforms = makeTransforms(LargeInstanceCount, LargeSceneSize);
+        uint64_t instancedTriangleCount = 0;
+
+        for (uint64_t i = 0; i < largeTransforms.size(); ++i)
+        {
+            instancedTriangleCount += largeHierarchies[i % largeHierarchies.size()].TriangleCount();
+        }
+
+        InstanceBVH largeBVH;
+
+        start = Clock::now();
+        addInstances(largeBVH, largeHierarchies, largeTransforms);
+        double instanceBuildMs = milliseconds(start);
+
+        double refitMs = 0.0;
+        uint32_t rebuildCount = 0;
+
+        for (uint32_t frame = 0; frame < AnimatedFrameCount; ++frame)
+        {
+            animate(largeTransforms, frame);
+
+            start = Clock::now();
+            addInstances(largeBVH, largeHierarchies, largeTransforms);
+            refitMs += milliseconds(start);
+            rebuildCount += !largeBVH.WasRefit();
+        }
+
+        refitMs /= AnimatedFrameCount;
+
+        std::vector<Ray3D> largeRays = makeRays(1 << 16, LargeSceneSize);
+        uint64_t closestHitCount = 0;
+        uint64_t anyHitCount = 0;
+
+        start = Clock::now();
+
+        for (const Ray3D& ray : largeRays)
+        {
+            closestHitCount += largeBVH.ClosestHit(ray).has_value();
+        }
+
+        double closestHitMs = milliseconds(start);
+
+        // Short occlusion rays as in line of sight checks
+        start = Clock::now();
+
+        for (const Ray3D& ray : largeRays)
+        {
+            anyHitCount += largeBVH.AnyHit(ray, 0.0f, 50.0f);
+        }
+
+        double anyHitMs = milliseconds(start);
+
+        isValid &= closestHitCount > 0;
+
+        stream.precision(6);
+        stream << "{\"correctness\":{\"rays\":" << smallRays.size() * 3
+            << ",\"hits\":" << checkedHits
+            << ",\"closestHitMismatches\":" << closestHitMismatches
+            << ",\"anyHitMismatches\":" << anyHitMismatches
+            << ",\"refitChecked\":" << (wasSmallSceneRefit ? "true" : "false") << "}"
+            << ",\"meshes\":{\"count\":" << largeMeshes.size()
+            << ",\"triangles\":" << meshTriangleCount
+            << ",\"buildMs\":" << meshBuildMs
+            << ",\"mTrianglesPerSecond\":" << meshTriangleCount / meshBuildMs * 1e-3 << "}"
+            << ",\"instances\":{\"count\":" << LargeInstanceCount
+            << ",\"instancedTriangles\":" << instancedTriangleCount
+            << ",\"buildMs\":" << instanceBuildMs
+            << ",\"refitMs\":" << refitMs
+            << ",\"rebuildsDuringAnimation\":" << rebuildCount
+            << ",\"sahCostAfterAnimation\":" << largeBVH.Hierarchy().SAHCost()
+            << ",\"sahCostAtBuild\":" << largeBVH.Hierarchy().BuildSAHCost() << "}"
+            << ",\"rays\":{\"count\":" << largeRays.size()
+            << ",\"closestHits\":" << closestHitCount
+            << ",\"closestHitMRaysPerSecond\":" << largeRays.size() / closestHitMs * 1e-3
+            << ",\"anyHits\":" << anyHitCount
+            << ",\"anyHitMRaysPerSecond\":" << largeRays.size() / anyHitMs * 1e-3 << "}"
+            << ",\"valid\":" << (isValid ? "true" : "false") << "}\n";
+
+        return isValid && stream.good();
+    }
+
+}
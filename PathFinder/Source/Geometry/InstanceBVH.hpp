@@ -0,0 +1,65 @@
+#pragma once
+
+#include "TriangleBVH.hpp"
+#include "Ray3D.hpp"
+
+#include <glm/mat4x4.hpp>
+
+#include <vector>
+#include <optional>
+#include <limits>
+#include <filesystem>
+
+namespace Geometry
+{
+
+    /// Top level of a two-level hierarchy: triangle hierarchies placed into the world by affine transforms.
+    /// Instances are declared anew before every build, the same way GPU top level acceleration structures are.
+    /// As long as instances keep referencing the same triangle hierarchies in the same order,
+    /// a build only refits the existing tree to moved instances.
+    class InstanceBVH
+    {
+    public:
+        struct Hit
+        {
+            float Distance = 0.0f;
+            uint32_t InstanceIndex = 0;
+            uint32_t TriangleIndex = 0;
+            glm::vec2 Barycentrics;
+        };
+
+        // Refitted tree is rebuilt once its expected query cost exceeds the freshly built one by this factor
+        inline static const float RebuildCostRatio = 2.0f;
+
+        void Clear();
+        void AddInstance(const TriangleBVH* hierarchy, const glm::mat4& transform);
+        void Build();
+
+        std::optional<Hit> ClosestHit(const Ray3D& ray, float minDistance = 0.0f, float maxDistance = std::numeric_limits<float>::max(), bool cullBackFaces = false) const;
+        bool AnyHit(const Ray3D& ray, float minDistance = 0.0f, float maxDistance = std::numeric_limits<float>::max(), bool cullBackFaces = false) const;
+
+        // Builds, refits and traces procedurally generated scenes and checks hits against brute force
+        static bool RunBenchmark(const std::filesystem::path& reportPath);
+
+    private:
+        struct Instance
+        {
+            const TriangleBVH* Hierarchy;
+            glm::mat4 WorldToObject;
+        };
+
+        bool CanRefit() const;
+
+        std::vector<Instance> mInstances;
+        std::vector<AABB> mInstanceBoxes;
+        std::vector<const TriangleBVH*> mBuiltHierarchies;
+        BVH mBVH;
+        bool mWasRefit = false;
+
+    public:
+        inline const BVH& Hierarchy() const { return mBVH; }
+        inline uint64_t InstanceCount() const { return mInstances.size(); }
+        inline bool WasRefit() const { return mWasRefit; }
+    };
+
+}
@@ -0,0 +1,108 @@
+#include "TriangleBVH.hpp"
+
+#include <glm/geometric.hpp>
+#include <glm/common.hpp>
+
+namespace Geometry
+{
+
+    TriangleBVH::TriangleBVH(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices)
+    {
+        uint64_t triangleCount = indices.size() / 3;
+
+        std::vector<AABB> triangleBoxes;
+        triangleBoxes.reserve(triangleCount);
+
+        for (uint64_t triangleIdx = 0; triangleIdx < triangleCount; ++triangleIdx)
+        {
+            const glm::vec3& a = positions[indices[triangleIdx * 3 + 0]];
+            const glm::vec3& b = positions[indices[triangleIdx * 3 + 1]];
+            const glm::vec3& c = positions[indices[triangleIdx * 3 + 2]];
+
+            triangleBoxes.emplace_back(glm::min(a, glm::min(b, c)), glm::max(a, glm::max(b, c)));
+            mBoundingBox = mBoundingBox.Union(triangleBoxes.back());
+        }
+
+        mBVH.Build(triangleBoxes);
+        mTriangles.resize(triangleCount);
+
+        for (uint32_t slot = 0; slot < triangleCount; ++slot)
+        {
+            uint64_t triangleIdx = mBVH.PrimitiveIndex(slot);
+            const glm::vec3& a = positions[indices[triangleIdx * 3 + 0]];
+            const glm::vec3& b = positions[indices[triangleIdx * 3 + 1]];
+            const glm::vec3& c = positions[indices[triangleIdx * 3 + 2]];
+
+            mTriangles[slot] = { a, b - a, c - a };
+        }
+    }
+
+    std::optional<TriangleBVH::Hit> TriangleBVH::ClosestHit(const glm::vec3& origin, const glm::vec3& direction, float minDistance, float maxDistance, bool cullBackFaces) const
+    {
+        std::optional<Hit> closestHit;
+
+        mBVH.Traverse(origin, direction, minDistance, maxDistance, [&](uint32_t slot, float& currentMaxDistance)
+        {
+            Hit hit;
+
+            if (IntersectTriangle(mTriangles[slot], origin, direction, minDistance, currentMaxDistance, cullBackFaces, hit))
+            {
+                hit.TriangleIndex = mBVH.PrimitiveIndex(slot);
+                currentMaxDistance = hit.Distance;
+                closestHit = hit;
+            }
+
+            return false;
+        });
+
+        return closestHit;
+    }
+
+    bool TriangleBVH::AnyHit(const glm::vec3& origin, const glm::vec3& direction, float minDistance, float maxDistance, bool cullBackFaces) const
+    {
+        bool isHit = false;
+
+        mBVH.Traverse(origin, direction, minDistance, maxDistance, [&](uint32_t slot, float& currentMaxDistance)
+        {
+            Hit hit;
+            isHit = IntersectTriangle(mTriangles[slot], origin, direction, minDistance, currentMaxDistance, cullBackFaces, hit);
+            return isHit;
+        });
+
+        return isHit;
+    }
+
+    bool TriangleBVH::IntersectTriangle(const Triangle& triangle, const glm::vec3& origin, const glm::vec3& direction, float minDistance, float maxDistance, bool cullBackFaces, Hit& hit) const
+    {
+        // Möller-Trumbore
+        glm::vec3 p = glm::cross(direction, triangle.EdgeAC);
+        float determinant = glm::dot(triangle.EdgeAB, p);
+
+        if (cullBackFaces ? determinant >= 0.0f : determinant == 0.0f)
+            return false;
+
+        float inverseDeterminant = 1.0f / determinant;
+        glm::vec3 t = origin - triangle.A;
+        float u = glm::dot(t, p) * inverseDeterminant;
+
+        if (u < 0.0f || u > 1.0f)
+            return false;
+
+        glm::vec3 q = glm::cross(t, triangle.EdgeAB);
+        float v = glm::dot(direction, q) * inverseDeterminant;
+
+        if (v < 0.0f || u + v > 1.0f)
+            return false;
+
+        float distance = glm::dot(triangle.EdgeAC, q) * inverseDeterminant;
+
+        if (distance < minDistance || distance > maxDistance)
+            return false;
+
+        hit.Distance = distance;
+        hit.Barycentrics = { u, v };
+
+        return true;
+    }
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "BVH.hpp"
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include <vector>
+#include <optional>
+
+namespace Geometry
+{
+
+    /// Hierarchy over triangles of one mesh, built once from its vertex and index data.
+    /// Queries work in the mesh's object space and accept unnormalized directions,
+    /// so rays transformed from world space keep reporting world space distances.
+    class TriangleBVH
+    {
+    public:
+        struct Hit
+        {
+            float Distance = 0.0f;
+            uint32_t TriangleIndex = 0;
+            glm::vec2 Barycentrics;
+        };
+
+        TriangleBVH() = default;
+
+        // Every 3 indices form a triangle
+        TriangleBVH(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices);
+
+        // Culling rejects triangles wound counterclockwise as seen from the ray origin,
+        // matching the rasterizer's clockwise front faces and Collision::RayTriangle
+        std::optional<Hit> ClosestHit(const glm::vec3& origin, const glm::vec3& direction, float minDistance, float maxDistance, bool cullBackFaces) const;
+        bool AnyHit(const glm::vec3& origin, const glm::vec3& direction, float minDistance, float maxDistance, bool cullBackFaces) const;
+
+    private:
+        // Stored in BVH slot order so leaves read consecutive triangles
+        struct Triangle
+        {
+            glm::vec3 A;
+            glm::vec3 EdgeAB;
+            glm::vec3 EdgeAC;
+        };
+
+        bool IntersectTriangle(const Triangle& triangle, const glm::vec3& origin, const glm::vec3& direction, float minDistance, float maxDistance, bool cullBackFaces, Hit& hit) const;
+
+        BVH mBVH;
+        std::vector<Triangle> mTriangles;
+        AABB mBoundingBox = AABB::MaximumReversed();
+
+    public:
+        inline const BVH& Hierarchy() const { return mBVH; }
+        inline const AABB& BoundingBox() const { return mBoundingBox; }
+        inline uint64_t TriangleCount() const { return mTriangles.size(); }
+    };
+
+}
@@ -138,6 +138,46 @@ namespace HAL
         mList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
     }
 
+    void CopyCommandListBase::CopyBufferToTexture(const Buffer& buffer, const Texture& texture, const ResourceFootprint& footprint)
+    {
+        D3D12_TEXTURE_COPY_LOCATION srcLocation{};
+        D3D12_TEXTURE_COPY_LOCATION dstLocation{};
+
+        srcLocation.pResource = buffer.D3DResource();
+        srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+
+        dstLocation.pResource = texture.D3DResource();
+        dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+
+        for (const SubresourceFootprint& subresourceFootprint : footprint.SubresourceFootprints())
+        {
+            srcLocation.PlacedFootprint = subresourceFootprint.D3DFootprint();
+            dstLocation.SubresourceIndex = subresourceFootprint.IndexInResource();
+
+            mList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+        }
+    }
+
+    void CopyCommandListBase::CopyTextureToBuffer(const Texture& texture, const Buffer& buffer, const ResourceFootprint& footprint)
+    {
+        D3D12_TEXTURE_COPY_LOCATION srcLocation{};
+        D3D12_TEXTURE_COPY_LOCATION dstLocation{};
+
+        srcLocation.pResource = texture.D3DResource();
+        srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+
+        dstLocation.pResource = buffer.D3DResource();
+        dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+
+        for (const SubresourceFootprint& subresourceFootprint : footprint.SubresourceFootprints())
+        {
+            srcLocation.SubresourceIndex = subresourceFootprint.IndexInResource();
+            dstLocation.PlacedFootprint = subresourceFootprint.D3DFootprint();
+
+            mList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+        }
+    }
+
 
 
     void ComputeCommandListBase::SetComputeRootConstantBuffer(GPUAddress bufferAddress, uint32_t rootParameterIndex)
@@ -288,6 +328,34 @@ namespace HAL
         mList->BuildRaytracingAccelerationStructure(&as.D3DAccelerationStructure(), 0, nullptr);
     }
 
+    void ComputeCommandList::BuildRaytracingAccelerationStructure(const RayTracingAccelerationStructure& as, const Buffer& scratchBuffer, uint64_t scratchOffset)
+    {
+        D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC d3dDesc = as.D3DAccelerationStructure();
+        d3dDesc.ScratchAccelerationStructureData = scratchBuffer.GPUVirtualAddress() + scratchOffset;
+        mList->BuildRaytracingAccelerationStructure(&d3dDesc, 0, nullptr);
+    }
+
+    void ComputeCommandList::EmitRaytracingAccelerationStructureCompactedSizes(const std::vector<const Buffer*>& structures, const Buffer& destination, uint64_t destinationOffset)
+    {
+        std::vector<D3D12_GPU_VIRTUAL_ADDRESS> addresses;
+        addresses.reserve(structures.size());
+
+        for (const Buffer* structure : structures)
+            addresses.push_back(structure->GPUVirtualAddress());
+
+        D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_DESC d3dDesc{};
+        d3dDesc.InfoType = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_COMPACTED_SIZE;
+        d3dDesc.DestBuffer = destination.GPUVirtualAddress() + destinationOffset;
+
+        mList->EmitRaytracingAccelerationStructurePostbuildInfo(&d3dDesc, (UINT)addresses.size(), addresses.data());
+    }
+
+    void ComputeCommandList::CompactRaytracingAccelerationStructure(const Buffer& source, const Buffer& destination)
+    {
+        mList->CopyRaytracingAccelerationStructure(
+            destination.GPUVirtualAddress(), source.GPUVirtualAddress(), D3D12_RAYTRACING_ACCELERATION_STRUCTURE_COPY_MODE_COMPACT);
+    }
+
 
 
     BundleCommandList::BundleCommandList(const Device& device, BundleCommandAllocator* commandAllocator)
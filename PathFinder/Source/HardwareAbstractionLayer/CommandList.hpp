@@ -83,6 +83,10 @@ namespace HAL
 
         void CopyBufferToTexture(const Buffer& buffer, const Texture& texture, const SubresourceFootprint& footprint);
         void CopyTextureToBuffer(const Texture& texture, const Buffer& buffer, const SubresourceFootprint& footprint);
+
+        // Records copies of every subresource of the footprint back to back
+        void CopyBufferToTexture(const Buffer& buffer, const Texture& texture, const ResourceFootprint& footprint);
+        void CopyTextureToBuffer(const Texture& texture, const Buffer& buffer, const ResourceFootprint& footprint);
     };
 
 
@@ -148,6 +152,15 @@ namespace HAL
         ~ComputeCommandList() = default;
 
         void BuildRaytracingAccelerationStructure(const RayTracingAccelerationStructure& as);
+
+        // Builds into a region of a shared scratch buffer instead of the one set on the structure
+        void BuildRaytracingAccelerationStructure(const RayTracingAccelerationStructure& as, const Buffer& scratchBuffer, uint64_t scratchOffset);
+
+        // Writes one 64-bit compacted size per structure, starting at the offset in a buffer in unordered access state
+        void EmitRaytracingAccelerationStructureCompactedSizes(const std::vector<const Buffer*>& structures, const Buffer& destination, uint64_t destinationOffset);
+
+        // Source must be built with compaction allowed and destination must fit the size reported for it
+        void CompactRaytracingAccelerationStructure(const Buffer& source, const Buffer& destination);
     };
     
     class BundleCommandList : public GraphicsCommandListBase {
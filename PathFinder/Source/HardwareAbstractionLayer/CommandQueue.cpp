@@ -40,6 +40,13 @@ namespace HAL
         return frequency;
     }
 
+    std::pair<uint64_t, uint64_t> CommandQueue::GetClockCalibration() const
+    {
+        UINT64 gpuTimestamp = 0;
+        UINT64 cpuTimestamp = 0;
+        ThrowIfFailed(mQueue->GetClockCalibration(&gpuTimestamp, &cpuTimestamp));
+        return { gpuTimestamp, cpuTimestamp };
+    }
 
 
     GraphicsCommandQueue::GraphicsCommandQueue(const Device& device)
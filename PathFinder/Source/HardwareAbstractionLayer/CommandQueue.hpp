@@ -22,6 +22,9 @@ namespace HAL
         void SetDebugName(const std::string& name) override;
         uint64_t GetTimestampFrequency() const;
 
+        // Returns a pair of simultaneously sampled GPU timestamp and CPU performance counter values
+        std::pair<uint64_t, uint64_t> GetClockCalibration() const;
+
     protected:
         template <class CommandListT>
         void ExecuteCommandListsInternal(const CommandListT* const* lists, uint64_t count);
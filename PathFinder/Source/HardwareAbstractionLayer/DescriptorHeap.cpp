@@ -144,7 +144,8 @@ namespace HAL
     D3D12_SHADER_RESOURCE_VIEW_DESC CBSRUADescriptorHeap::ResourceToSRVDescription(
         const D3D12_RESOURCE_DESC& resourceDesc, 
         uint64_t bufferStride,
-        std::optional<ColorFormat> explicitFormat) const
+        std::optional<ColorFormat> explicitFormat,
+        bool isCubeMap) const
     {
         D3D12_SHADER_RESOURCE_VIEW_DESC desc{};
 
@@ -179,7 +180,23 @@ namespace HAL
             break;
 
         case D3D12_RESOURCE_DIMENSION_TEXTURE2D:
-            if (resourceDesc.DepthOrArraySize > 1)
+            if (isCubeMap && resourceDesc.DepthOrArraySize > 6)
+            {
+                desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURECUBEARRAY;
+                desc.TextureCubeArray.MostDetailedMip = 0;
+                desc.TextureCubeArray.MipLevels = resourceDesc.MipLevels;
+                desc.TextureCubeArray.First2DArrayFace = 0;
+                desc.TextureCubeArray.NumCubes = resourceDesc.DepthOrArraySize / 6;
+                desc.TextureCubeArray.ResourceMinLODClamp = 0.0f;
+            }
+            else if (isCubeMap)
+            {
+                desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURECUBE;
+                desc.TextureCube.MostDetailedMip = 0;
+                desc.TextureCube.MipLevels = resourceDesc.MipLevels;
+                desc.TextureCube.ResourceMinLODClamp = 0.0f;
+            }
+            else if (resourceDesc.DepthOrArraySize > 1)
             {
                 desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY;
                 desc.Texture2DArray.MostDetailedMip = 0;
@@ -310,7 +327,8 @@ namespace HAL
         D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle{ GetCPUAddress(indexInHeapRange, std::underlying_type_t<Range>(Range::ShaderResource)) };
         D3D12_GPU_DESCRIPTOR_HANDLE gpuHandle{ GetGPUAddress(indexInHeapRange, std::underlying_type_t<Range>(Range::ShaderResource)) };
 
-        D3D12_SHADER_RESOURCE_VIEW_DESC desc = ResourceToSRVDescription(texture.D3DDescription(), 1, shaderVisibleFormat);
+        bool isCubeMap = texture.Kind() == TextureKind::TextureCube;
+        D3D12_SHADER_RESOURCE_VIEW_DESC desc = ResourceToSRVDescription(texture.D3DDescription(), 1, shaderVisibleFormat, isCubeMap);
         mDevice->D3DDevice()->CreateShaderResourceView(texture.D3DResource(), &desc, cpuHandle);
 
         return SRDescriptor{ cpuHandle, gpuHandle, indexInHeapRange };
@@ -105,7 +105,8 @@ namespace HAL
         D3D12_SHADER_RESOURCE_VIEW_DESC ResourceToSRVDescription(
             const D3D12_RESOURCE_DESC& resourceDesc, 
             uint64_t bufferStride,
-            std::optional<ColorFormat> explicitFormat = std::nullopt) const;
+            std::optional<ColorFormat> explicitFormat = std::nullopt,
+            bool isCubeMap = false) const;
 
         D3D12_SHADER_RESOURCE_VIEW_DESC BufferToAccelerationStructureDescription(const Buffer& buffer) const;
 
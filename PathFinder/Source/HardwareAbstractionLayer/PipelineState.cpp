@@ -24,6 +24,48 @@ namespace HAL
         mDebugName = name;
     }
 
+    void PipelineState::SetCachedBlob(const void* data, uint64_t size)
+    {
+        mCachedBlob = data;
+        mCachedBlobSize = data ? size : 0;
+    }
+
+    std::vector<uint8_t> PipelineState::SerializeCachedBlob() const
+    {
+        if (!mState)
+            return {};
+
+        Microsoft::WRL::ComPtr<ID3DBlob> blob;
+
+        if (FAILED(mState->GetCachedBlob(&blob)) || !blob)
+            return {};
+
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(blob->GetBufferPointer());
+        return std::vector<uint8_t>(data, data + blob->GetBufferSize());
+    }
+
+    HRESULT PipelineState::CreateWithCachedBlobFallback(D3D12_CACHED_PIPELINE_STATE& cachedPSO, const std::function<HRESULT()>& create)
+    {
+        cachedPSO.pCachedBlob = mCachedBlob;
+        cachedPSO.CachedBlobSizeInBytes = mCachedBlobSize;
+
+        HRESULT result = create();
+        mIsCompiledFromCachedBlob = mCachedBlob && SUCCEEDED(result);
+
+        if (FAILED(result) && mCachedBlob)
+        {
+            // Driver refuses blobs produced by a different driver version or adapter
+            cachedPSO = {};
+            result = create();
+        }
+
+        // Blob memory is owned by the caller and is not guaranteed to outlive compilation
+        mCachedBlob = nullptr;
+        mCachedBlobSize = 0;
+
+        return result;
+    }
+
 
 
     void GraphicsPipelineState::Compile()
@@ -61,12 +103,13 @@ namespace HAL
         //desc.IBStripCutValue;
         //desc.SampleMask;
         //desc.StreamOutput;
-        //desc.CachedPSO;
 
 #if defined(DEBUG) || defined(_DEBUG) 
         //desc.Flags = D3D12_PIPELINE_STATE_FLAG_TOOL_DEBUG;
 #endif
-        ThrowIfFailed(mDevice->D3DDevice()->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&mState)));
+        ThrowIfFailed(CreateWithCachedBlobFallback(desc.CachedPSO, [this, &desc] {
+            return mDevice->D3DDevice()->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&mState));
+        }));
 
         mState->SetName(StringToWString(mDebugName).c_str());
     }
@@ -75,6 +118,7 @@ namespace HAL
     {
         GraphicsPipelineState newState = *this;
         newState.mState = nullptr;
+        newState.mIsCompiledFromCachedBlob = false;
         return newState;
     }
 
@@ -101,7 +145,9 @@ namespace HAL
 #if defined(DEBUG) || defined(_DEBUG) 
         //desc.Flags = D3D12_PIPELINE_STATE_FLAG_TOOL_DEBUG;
 #endif
-        ThrowIfFailed(mDevice->D3DDevice()->CreateComputePipelineState(&desc, IID_PPV_ARGS(&mState)));
+        ThrowIfFailed(CreateWithCachedBlobFallback(desc.CachedPSO, [this, &desc] {
+            return mDevice->D3DDevice()->CreateComputePipelineState(&desc, IID_PPV_ARGS(&mState));
+        }));
 
         mState->SetName(StringToWString(mDebugName).c_str());
     }
@@ -110,6 +156,7 @@ namespace HAL
     {
         ComputePipelineState newState = *this;
         newState.mState = nullptr;
+        newState.mIsCompiledFromCachedBlob = false;
         return newState;
     }
 
@@ -268,6 +315,19 @@ namespace HAL
         BuildShaderTable();
     }
 
+    RayTracingPipelineState RayTracingPipelineState::Clone() const
+    {
+        // Subobjects, associations and export collections hold pointers into
+        // the source object, but Compile() regenerates all of them from scratch
+        RayTracingPipelineState newState = *this;
+        newState.mState = nullptr;
+        newState.mProperties = nullptr;
+        newState.mCurrentLibrary = nullptr;
+        newState.mCurrentExportsCollection = nullptr;
+        newState.mShaderTable.Clear();
+        return newState;
+    }
+
     void RayTracingPipelineState::SetDebugName(const std::string& name)
     {
         if (mState)
@@ -19,6 +19,8 @@
 
 #include <variant>
 #include <unordered_map>
+#include <functional>
+#include <vector>
 
 namespace HAL
 {
@@ -33,15 +35,28 @@ namespace HAL
         virtual void Compile() = 0;
         virtual void SetDebugName(const std::string& name) override;
 
+        // Driver blob of a previously compiled identical state. Memory must stay alive until Compile() returns.
+        // Blobs rejected by the driver (after a driver or adapter change) are ignored and state is compiled from scratch.
+        void SetCachedBlob(const void* data, uint64_t size);
+
+        // Driver blob of the compiled state suitable for SetCachedBlob() in a later run
+        std::vector<uint8_t> SerializeCachedBlob() const;
+
     protected:
+        HRESULT CreateWithCachedBlobFallback(D3D12_CACHED_PIPELINE_STATE& cachedPSO, const std::function<HRESULT()>& create);
+
         Microsoft::WRL::ComPtr<ID3D12PipelineState> mState;
         const RootSignature* mRootSignature = nullptr;
         const Device* mDevice;
         std::string mDebugName;
+        const void* mCachedBlob = nullptr;
+        uint64_t mCachedBlobSize = 0;
+        bool mIsCompiledFromCachedBlob = false;
 
     public:
         inline ID3D12PipelineState* D3DCompiledState() const { return mState.Get(); }
         inline const RootSignature* GetRootSignature() const { return mRootSignature; }
+        inline bool IsCompiledFromCachedBlob() const { return mIsCompiledFromCachedBlob; }
 
         inline void SetRootSignature(const RootSignature* signature) { mRootSignature = signature; }
     };
@@ -101,13 +116,18 @@ namespace HAL
         inline const RasterizerState& GetRasterizerState() const { return mRasterizerState; }
         inline const DepthStencilState& GetDepthStencilState() const { return mDepthStencilState; }
         inline const PrimitiveTopology& GetPrimitiveTopology() const { return mPrimitiveTopology; }
+        inline const Shader* GetVertexShader() const { return mVertexShader; }
+        inline const Shader* GetPixelShader() const { return mPixelShader; }
+        inline const Shader* GetDomainShader() const { return mDomainShader; }
+        inline const Shader* GetHullShader() const { return mHullShader; }
+        inline const Shader* GetGeometryShader() const { return mGeometryShader; }
 
     private:
-        const Shader* mVertexShader;
-        const Shader* mPixelShader;
-        const Shader* mDomainShader;
-        const Shader* mHullShader;
-        const Shader* mGeometryShader;
+        const Shader* mVertexShader = nullptr;
+        const Shader* mPixelShader = nullptr;
+        const Shader* mDomainShader = nullptr;
+        const Shader* mHullShader = nullptr;
+        const Shader* mGeometryShader = nullptr;
         BlendState mBlendState;
         RasterizerState mRasterizerState;
         DepthStencilState mDepthStencilState;
@@ -127,11 +147,12 @@ namespace HAL
         void ReplaceShader(const HAL::Shader* oldShader, const HAL::Shader* newShader) override;
 
         inline void SetComputeShader(const Shader* computeShader) { mComputeShader = computeShader; }
+        inline const Shader* GetComputeShader() const { return mComputeShader; }
 
         ComputePipelineState Clone() const;
 
     private:
-        const Shader* mComputeShader;
+        const Shader* mComputeShader = nullptr;
     };
 
 
@@ -175,6 +196,9 @@ namespace HAL
         void ReplaceLibrary(const Library* oldLibrary, const Library* newLibrary);
         void Compile();
 
+        // Copy of shader setup without compiled state object, shader table is rebuilt on compilation
+        RayTracingPipelineState Clone() const;
+
         virtual void SetDebugName(const std::string& name) override;
 
     private:
@@ -32,6 +32,18 @@ namespace HAL
         if (mUpdateBuffer) mD3DAccelerationStructure.SourceAccelerationStructureData = mUpdateBuffer->GPUVirtualAddress();
 
         mD3DAccelerationStructure.Inputs = mD3DInputs;
+
+        // Update flag must not be present when memory requirements are queried, so it's only added to the build description
+        if (mUpdateBuffer) mD3DAccelerationStructure.Inputs.Flags |= D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PERFORM_UPDATE;
+    }
+
+    void RayTracingAccelerationStructure::SetBuildFlags(RayTracingBuildFlags flags)
+    {
+        mD3DInputs.Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_NONE;
+        if (EnumMaskContains(flags, RayTracingBuildFlags::PreferFastTrace)) mD3DInputs.Flags |= D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_TRACE;
+        if (EnumMaskContains(flags, RayTracingBuildFlags::PreferFastBuild)) mD3DInputs.Flags |= D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_BUILD;
+        if (EnumMaskContains(flags, RayTracingBuildFlags::AllowUpdate)) mD3DInputs.Flags |= D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_UPDATE;
+        if (EnumMaskContains(flags, RayTracingBuildFlags::AllowCompaction)) mD3DInputs.Flags |= D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_COMPACTION;
     }
 
     void RayTracingAccelerationStructure::Clear()
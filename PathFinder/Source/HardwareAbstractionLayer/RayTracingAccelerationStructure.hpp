@@ -3,6 +3,8 @@
 #include "GraphicAPIObject.hpp"
 #include "Buffer.hpp"
 
+#include <Foundation/BitwiseEnum.hpp>
+
 
 
 #include <cstdint>
@@ -13,6 +15,16 @@
 
 namespace HAL
 {
+
+    enum class RayTracingBuildFlags : uint32_t
+    {
+        None            = 0,
+        PreferFastTrace = 1 << 0,
+        PreferFastBuild = 1 << 1,
+        AllowUpdate     = 1 << 2,
+        // Allows the structure to be copied into a smaller buffer after build
+        AllowCompaction = 1 << 3
+    };
     
     struct RayTracingGeometry
     {
@@ -50,6 +62,9 @@ namespace HAL
         virtual void Clear() = 0;
         virtual void SetBuffers(const Buffer* destinationBuffer, const Buffer* scratchBuffer, const Buffer* updateBuffer = nullptr);
 
+        // Affects memory requirements, so must be set before they are queried
+        void SetBuildFlags(RayTracingBuildFlags flags);
+
     protected:
         struct CommonMemoryRequirements
         {
@@ -74,6 +89,7 @@ namespace HAL
     public:
         inline const auto& D3DAccelerationStructure() const { return mD3DAccelerationStructure; }
         inline const auto* FinalBuffer() const { return mFinalBuffer; }
+        inline const auto* UpdateBuffer() const { return mUpdateBuffer; }
     };
 
 
@@ -149,3 +165,5 @@ namespace HAL
     };
 
 }
+
+ENABLE_BITMASK_OPERATORS(HAL::RayTracingBuildFlags);
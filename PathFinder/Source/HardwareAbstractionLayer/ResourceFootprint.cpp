@@ -10,7 +10,7 @@ namespace HAL
         mOffset{ d3dFootprint.Offset }, 
         mRowPitch{ d3dFootprint.Footprint.RowPitch }, 
         mSubresourceIndex{ index },
-        mTotalSizeInBytes{ rowCount * d3dFootprint.Footprint.RowPitch }
+        mTotalSizeInBytes{ rowCount * d3dFootprint.Footprint.RowPitch * d3dFootprint.Footprint.Depth }
     {}
 
     ResourceFootprint::ResourceFootprint(const Resource& resource, uint64_t initialByteOffset)
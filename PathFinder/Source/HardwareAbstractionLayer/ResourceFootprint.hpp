@@ -39,6 +39,8 @@ namespace HAL
         inline auto RowCount() const { return mRowCount; }
         inline auto RowSizeInBytes() const { return mRowSizeInBytes; }
         inline auto RowPitch() const { return mRowPitch; }
+        inline auto SlicePitch() const { return mRowPitch * mRowCount; }
+        inline auto Depth() const { return mD3DFootprint.Footprint.Depth; }
         inline auto Offset() const { return mOffset; }
         inline auto IndexInResource() const { return mSubresourceIndex; }
         inline auto TotalSizeInBytes() const { return mTotalSizeInBytes; }
@@ -106,12 +106,13 @@ namespace HAL
         case TextureKind::Texture3D: mDescription.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE3D; break;
         case TextureKind::Texture2D: mDescription.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D; break;
         case TextureKind::Texture1D: mDescription.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE1D; break;
+        case TextureKind::TextureCube: mDescription.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D; break;
         }
 
-        bool isArray = (kind == TextureKind::Texture1D || kind == TextureKind::Texture2D) && dimensions.Depth > 1;
-        mSubresourceCount = isArray ? dimensions.Depth * mipCount : mipCount;
+        assert_format(kind != TextureKind::TextureCube || (dimensions.Depth > 0 && dimensions.Depth % 6 == 0), "Cube texture depth must be a multiple of 6 faces");
 
-        assert_format(!isArray, "Texture arrays are not supported currently. Add proper handling of texture array scheduling first, then remove this assert.");
+        bool isArray = (kind == TextureKind::Texture1D || kind == TextureKind::Texture2D || kind == TextureKind::TextureCube) && dimensions.Depth > 1;
+        mSubresourceCount = isArray ? dimensions.Depth * mipCount : mipCount;
 
         mDescription.Height = (UINT)dimensions.Height;
         mDescription.Width = dimensions.Width;
@@ -272,6 +273,8 @@ namespace HAL
         case ColorFormat::BC5_Unsigned_Norm: return DXGI_FORMAT_BC5_UNORM;
         case ColorFormat::BC5_Signed_Norm:   return DXGI_FORMAT_BC5_SNORM;
         case ColorFormat::BC7_Unsigned_Norm: return DXGI_FORMAT_BC7_UNORM;
+        case ColorFormat::BC6H_Unsigned_Float: return DXGI_FORMAT_BC6H_UF16;
+        case ColorFormat::BC6H_Signed_Float: return DXGI_FORMAT_BC6H_SF16;
 
         default: assert_format("Should never be hit"); return DXGI_FORMAT_UNKNOWN;
         }
@@ -385,6 +388,8 @@ namespace HAL
         case DXGI_FORMAT_BC5_UNORM: return ColorFormat::BC5_Unsigned_Norm;
         case DXGI_FORMAT_BC5_SNORM: return ColorFormat::BC5_Signed_Norm;
         case DXGI_FORMAT_BC7_UNORM: return ColorFormat::BC7_Unsigned_Norm;
+        case DXGI_FORMAT_BC6H_UF16: return ColorFormat::BC6H_Unsigned_Float;
+        case DXGI_FORMAT_BC6H_SF16: return ColorFormat::BC6H_Signed_Float;
 
         default:
             assert_format(false, "Unsupported D3D format");
@@ -55,7 +55,7 @@ namespace HAL
 
         // Compressed formats
         BC1_Unsigned_Norm, BC2_Unsigned_Norm, BC3_Unsigned_Norm, BC4_Unsigned_Norm,
-        BC5_Unsigned_Norm, BC5_Signed_Norm, BC7_Unsigned_Norm
+        BC5_Unsigned_Norm, BC5_Signed_Norm, BC7_Unsigned_Norm, BC6H_Unsigned_Float, BC6H_Signed_Float
     };
 
     enum class DepthStencilFormat : uint32_t
@@ -70,7 +70,9 @@ namespace HAL
 
     enum class TextureKind : uint8_t
     {
-        Texture1D, Texture2D, Texture3D 
+        Texture1D, Texture2D, Texture3D,
+        // 2D texture array with 6 faces per cube, depth of dimensions is the total face count
+        TextureCube
     };
 
     using FormatVariant = std::variant<TypelessColorFormat, ColorFormat, DepthStencilFormat>;
@@ -40,6 +40,7 @@ namespace HAL
     {
         RootSignature newSignature = *this;
         newSignature.mSignature = nullptr;
+        newSignature.mSerializedSignature.clear();
         return newSignature;
     }
 
@@ -79,6 +80,10 @@ namespace HAL
         Microsoft::WRL::ComPtr<ID3DBlob> errors;
         D3D12SerializeVersionedRootSignature(&mDesc, &signatureBlob, &errors);
         assert_format(!errors, (char*)errors->GetBufferPointer());
+
+        const uint8_t* signatureBytes = static_cast<const uint8_t*>(signatureBlob->GetBufferPointer());
+        mSerializedSignature.assign(signatureBytes, signatureBytes + signatureBlob->GetBufferSize());
+
         ThrowIfFailed(mDevice->D3DDevice()->CreateRootSignature(0, signatureBlob->GetBufferPointer(), signatureBlob->GetBufferSize(), IID_PPV_ARGS(&mSignature)));
     
         mSignature->SetName(StringToWString(mDebugName).c_str());
@@ -56,11 +56,14 @@ namespace HAL
 
         D3D12_VERSIONED_ROOT_SIGNATURE_DESC mDesc{};
         Microsoft::WRL::ComPtr<ID3D12RootSignature> mSignature;
+        std::vector<uint8_t> mSerializedSignature;
         const Device* mDevice;
         std::string mDebugName;
 
     public:
         inline ID3D12RootSignature* D3DSignature() const { return mSignature.Get(); }
+        // Layout the signature was created from, empty until compiled
+        inline const auto& SerializedSignature() const { return mSerializedSignature; }
     };
 
 }
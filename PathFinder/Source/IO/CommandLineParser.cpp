@@ -12,6 +12,44 @@ namespace PathFinder
 
         for (auto i = 1; i < argc; ++i)
         {
+            // Arguments followed by a value
+            if (strcmp(argv[i], "-analyze_graph") == 0 && i + 1 < argc)
+            {
+                mGraphRecordToAnalyze = argv[++i];
+                continue;
+            }
+
+            if (strcmp(argv[i], "-optimize_queues") == 0 && i + 1 < argc)
+            {
+                mGraphRecordToOptimize = argv[++i];
+                continue;
+            }
+
+            if (strcmp(argv[i], "-benchmark") == 0 && i + 1 < argc)
+            {
+                mBenchmarkToRun = argv[++i];
+                continue;
+            }
+
+            if (strcmp(argv[i], "-benchmark_input") == 0 && i + 1 < argc)
+            {
+                mBenchmarkInput = argv[++i];
+                continue;
+            }
+
+            if (strcmp(argv[i], "-texture_compression") == 0 && i + 1 < argc)
+            {
+                const char* preset = argv[++i];
+
+                if (strcmp(preset, "off") == 0) mTextureCompressionQuality = std::nullopt;
+                else if (strcmp(preset, "fast") == 0) mTextureCompressionQuality = TextureCompressor::Quality::Fast;
+                else if (strcmp(preset, "normal") == 0) mTextureCompressionQuality = TextureCompressor::Quality::Normal;
+                else if (strcmp(preset, "high") == 0) mTextureCompressionQuality = TextureCompressor::Quality::High;
+                else assert_format(false, "Unknown texture compression preset ", preset, ", expected off, fast, normal or high");
+
+                continue;
+            }
+
             ParseArgument(argv[i]);
         }
     }
@@ -47,6 +85,31 @@ namespace PathFinder
         {
             mDisableMemoryAliasing = true;
         }
+
+        if (strcmp(argv, "-cpu_trace") == 0)
+        {
+            mCPUTraceEnabled = true;
+        }
+
+        if (strcmp(argv, "-gpu_stats") == 0)
+        {
+            mGPUStatisticsExportEnabled = true;
+        }
+
+        if (strcmp(argv, "-pso_stats") == 0)
+        {
+            mPipelineStateStatisticsExportEnabled = true;
+        }
+
+        if (strcmp(argv, "-record_graph") == 0)
+        {
+            mGraphRecordingEnabled = true;
+        }
+
+        if (strcmp(argv, "-record_barriers") == 0)
+        {
+            mBarrierRecordingEnabled = true;
+        }
     }
 
 }
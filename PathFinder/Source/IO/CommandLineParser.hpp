@@ -1,6 +1,10 @@
 #pragma once
 
+#include <Scene/TextureCompressor.hpp>
+
 #include <filesystem>
+#include <optional>
+#include <string>
 
 namespace PathFinder 
 {
@@ -20,6 +24,16 @@ namespace PathFinder
         bool mAftermathEnabled = false;
         bool mUseWARPDevice = false;
         bool mDisableMemoryAliasing = false;
+        bool mCPUTraceEnabled = false;
+        bool mGPUStatisticsExportEnabled = false;
+        bool mPipelineStateStatisticsExportEnabled = false;
+        bool mGraphRecordingEnabled = false;
+        std::optional<std::filesystem::path> mGraphRecordToAnalyze;
+        std::optional<std::filesystem::path> mGraphRecordToOptimize;
+        bool mBarrierRecordingEnabled = false;
+        std::optional<TextureCompressor::Quality> mTextureCompressionQuality;
+        std::optional<std::string> mBenchmarkToRun;
+        std::optional<std::filesystem::path> mBenchmarkInput;
 
     public:
         inline auto ShouldEnableDebugLayer() const { return mDebugLayerEnabled; }
@@ -28,6 +42,16 @@ namespace PathFinder
         inline auto ShouldEnableAftermath() const { return mAftermathEnabled; }
         inline auto ShouldUseWARPDevice() const { return mUseWARPDevice; }
         inline auto DisableMemoryAliasing() const { return mDisableMemoryAliasing; }
+        inline auto ShouldCaptureCPUTrace() const { return mCPUTraceEnabled; }
+        inline auto ShouldExportGPUStatistics() const { return mGPUStatisticsExportEnabled; }
+        inline auto ShouldExportPipelineStateStatistics() const { return mPipelineStateStatisticsExportEnabled; }
+        inline auto ShouldRecordRenderGraph() const { return mGraphRecordingEnabled; }
+        inline const auto& GraphRecordToAnalyze() const { return mGraphRecordToAnalyze; }
+        inline const auto& GraphRecordToOptimize() const { return mGraphRecordToOptimize; }
+        inline auto ShouldRecordBarriers() const { return mBarrierRecordingEnabled; }
+        inline const auto& TextureCompressionQuality() const { return mTextureCompressionQuality; }
+        inline const auto& BenchmarkToRun() const { return mBenchmarkToRun; }
+        inline const auto& BenchmarkInput() const { return mBenchmarkInput; }
         inline const auto& ExecutableFolderPath() const { return mExecutableFolder; }
     };
 
@@ -20,6 +20,7 @@ namespace Memory
         {
             mBufferPtr = resourceAllocator->AllocateBuffer(properties);
             mGetterBufferPtr = mBufferPtr.get();
+            mIsAllocatedByResourceAllocator = true;
 
             if (mStateTracker) 
                 mStateTracker->StartTrakingResource(mBufferPtr.get());
@@ -53,6 +54,9 @@ namespace Memory
 
     Buffer::~Buffer()
     {
+        if (IsRelocating())
+            CancelRelocation();
+
         if (mStateTracker && mBufferPtr) 
             mStateTracker->StopTrakingResource(mBufferPtr.get());
     }
@@ -125,6 +129,110 @@ namespace Memory
             mGetterBufferPtr = newCurrentBuffer;
     }
 
+    void Buffer::EndFrame(uint64_t frameNumber)
+    {
+        GPUResource::EndFrame(frameNumber);
+
+        while (!mRegionUploads.empty() && mRegionUploads.front().FrameNumber <= frameNumber)
+        {
+            mRegionUploads.pop_front();
+        }
+    }
+
+    bool Buffer::CanBeRelocated() const
+    {
+        return mIsAllocatedByResourceAllocator && !mUADescriptor && mRegionUploads.empty() && IsRelocationAllowed(mProperties.ExpectedStateMask);
+    }
+
+    bool Buffer::BeginRelocation()
+    {
+        if (!CanBeRelocated())
+            return false;
+
+        mRelocationTarget = mResourceAllocator->AllocateRelocationTarget(mProperties);
+
+        if (!mRelocationTarget)
+            return false;
+
+        mRelocationTarget->SetDebugName(mDebugName);
+        mStateTracker->StartTrakingResource(mRelocationTarget.get());
+
+        mCopyRequestManager->RequestRelocation(mBufferPtr.get(), mRelocationTarget.get(),
+            [source = mBufferPtr.get(), destination = mRelocationTarget.get()](HAL::CopyCommandListBase& cmdList)
+        {
+            cmdList.CopyResource(*source, *destination);
+        });
+
+        mRelocationFrameNumber = mFrameNumber;
+
+        return true;
+    }
+
+    void Buffer::FinishRelocation()
+    {
+        // Continue from states the buffer is in right now
+        mStateTracker->RequestTransitions(mRelocationTarget.get(), mStateTracker->ResourceCurrentStates(mBufferPtr.get()));
+        mStateTracker->StopTrakingResource(mBufferPtr.get());
+
+        // Previous buffer is released through the allocator after frames that might use it complete
+        mBufferPtr = std::move(mRelocationTarget);
+        mGetterBufferPtr = mBufferPtr.get();
+
+        // Frames in flight may still read old descriptors, so their slots are released through the frame ring
+        // and getters create new ones on demand
+        mSRDescriptor = nullptr;
+        mCBDescriptor = nullptr;
+    }
+
+    void Buffer::CancelRelocation()
+    {
+        mCopyRequestManager->CancelUploadRequests(mRelocationTarget.get());
+        mStateTracker->StopTrakingResource(mRelocationTarget.get());
+        mRelocationTarget = nullptr;
+    }
+
+    void Buffer::RequestRegionUpload(const void* data, uint64_t byteOffset, uint64_t byteSize)
+    {
+        assert_format(mAccessStrategy == GPUResource::AccessStrategy::Automatic, "Region writes are only supported by buffers in GPU memory");
+        assert_format(!CurrentFrameUploadBuffer(), "Region writes can't be mixed with whole buffer writes in one frame");
+        assert_format(byteOffset + byteSize <= mProperties.Size, "Region is out of buffer bounds");
+
+        if (byteSize == 0)
+            return;
+
+        // Relocation copy would discard new contents
+        if (IsRelocating())
+        {
+            CancelRelocation();
+            mRelocationFrameNumber = std::nullopt;
+        }
+
+        bool isFirstRegionInFrame = mRegionUploads.empty() || mRegionUploads.back().FrameNumber != mFrameNumber;
+
+        auto properties = HAL::BufferProperties::Create<uint8_t>(byteSize);
+        RegionUpload& upload = mRegionUploads.emplace_back();
+        upload.UploadBuffer = mResourceAllocator->AllocateBuffer(properties, HAL::CPUAccessibleHeapType::Upload);
+        upload.UploadBuffer->SetDebugName(StringFormat("%s Region Upload Buffer [Frame %d]", mDebugName.c_str(), mFrameNumber));
+        upload.DestinationOffset = byteOffset;
+        upload.Size = byteSize;
+        upload.FrameNumber = mFrameNumber;
+
+        memcpy(upload.UploadBuffer->Map(), data, byteSize);
+
+        if (!isFirstRegionInFrame)
+            return;
+
+        // One request per frame keeps a single pair of state transitions around all region copies
+        mCopyRequestManager->RequestUpload(HALResource(), [this, frameNumber = mFrameNumber](HAL::CopyCommandListBase& cmdList)
+        {
+            for (const RegionUpload& region : mRegionUploads)
+            {
+                if (region.FrameNumber == frameNumber)
+                    cmdList.CopyBufferRegion(*region.UploadBuffer, *HALBuffer(), 0, region.Size, region.DestinationOffset);
+            }
+        });
+    }
+
     uint64_t Buffer::UploadAndReadbackResourceSize() const
     {
         return mProperties.Size;
@@ -4,6 +4,8 @@
 
 #include <HardwareAbstractionLayer/Buffer.hpp>
 
+#include <deque>
+
 namespace Memory
 {
 
@@ -39,24 +41,50 @@ namespace Memory
         template <class Element = uint8_t>
         uint64_t Capacity(uint64_t elementAlignment = 1) const;
 
+        // Uploads a region leaving the rest of the buffer intact. Regions written during a frame
+        // are copied by a single upload request, so they can't be combined with RequestWrite in the same frame.
+        template <class T = uint8_t>
+        void WriteRegion(const T* data, uint64_t startIndex, uint64_t objectCount);
+
         const HAL::Buffer* HALBuffer() const;
         const HAL::Resource* HALResource() const override;
 
+        bool CanBeRelocated() const override;
+        bool BeginRelocation() override;
+
         void BeginFrame(uint64_t frameNumber) override;
+        void EndFrame(uint64_t frameNumber) override;
 
     protected:
         uint64_t UploadAndReadbackResourceSize() const override;
         void ApplyDebugName() override;
         CopyRequestManager::CopyCommand GetUploadCommands() override;
         CopyRequestManager::CopyCommand GetReadbackCommands() override;
+        void FinishRelocation() override;
+        void CancelRelocation() override;
 
     private:
+        struct RegionUpload
+        {
+            SegregatedPoolsResourceAllocator::BufferPtr UploadBuffer;
+            uint64_t DestinationOffset = 0;
+            uint64_t Size = 0;
+            uint64_t FrameNumber = 0;
+        };
+
+        void RequestRegionUpload(const void* data, uint64_t byteOffset, uint64_t byteSize);
+
         uint64_t mRequstedStride = 1;
         HAL::BufferProperties mProperties;
 
         SegregatedPoolsResourceAllocator::BufferPtr mBufferPtr;
+        SegregatedPoolsResourceAllocator::BufferPtr mRelocationTarget;
+        std::deque<RegionUpload> mRegionUploads;
         HAL::Buffer* mGetterBufferPtr = nullptr;
 
+        // Buffers placed into explicit heaps are owned by their users
+        bool mIsAllocatedByResourceAllocator = false;
+
         // Cached values, to be mutated from getters
         mutable uint64_t mCBDescriptorRequestFrameNumber = 0;
         mutable uint64_t mSRDescriptorRequestFrameNumber = 0;
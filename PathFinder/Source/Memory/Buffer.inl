@@ -10,4 +10,10 @@ namespace Memory
         return HALBuffer()->ElementCapacity<Element>(elementAlignment);
     }
 
+    template <class T>
+    void Buffer::WriteRegion(const T* data, uint64_t startIndex, uint64_t objectCount)
+    {
+        RequestRegionUpload(data, startIndex * sizeof(T), objectCount * sizeof(T));
+    }
+
 }
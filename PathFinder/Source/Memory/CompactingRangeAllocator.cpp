@@ -0,0 +1,279 @@
+#include "CompactingRangeAllocator.hpp"
+
+#include <Foundation/Assert.hpp>
+
+#include <random>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+
+namespace Memory
+{
+
+    CompactingRangeAllocator::CompactingRangeAllocator(uint64_t initialCapacity, float growthFactor)
+        : mAllocator{ std::max(initialCapacity, uint64_t(1)) }, mGrowthFactor{ std::max(growthFactor, 1.1f) } {}
+
+    uint64_t CompactingRangeAllocator::Allocate(uint64_t owner, uint64_t size)
+    {
+        assert_format(!Contains(owner), "Owner already has a range");
+
+        std::optional<uint64_t> offset = mAllocator.Allocate(size);
+
+        if (!offset)
+        {
+            // Free space at the end is merged with the added one, so the extent is enough to fit the request
+            uint64_t newCapacity = std::max(uint64_t(mAllocator.Capacity() * mGrowthFactor), mAllocator.AllocatedExtent() + size);
+            mAllocator.Grow(newCapacity);
+            offset = mAllocator.Allocate(size);
+
+            assert_format(offset, "Range allocation failed after growth");
+        }
+
+        mRangesByOwner[owner] = Range{ *offset, size };
+        mOwnersByOffset.emplace(*offset, owner);
+
+        return *offset;
+    }
+
+    void CompactingRangeAllocator::Deallocate(uint64_t owner)
+    {
+        auto it = mRangesByOwner.find(owner);
+
+        assert_format(it != mRangesByOwner.end(), "Owner has no range to deallocate");
+
+        mAllocator.Deallocate(it->second.Offset, it->second.Size);
+        mOwnersByOffset.erase(it->second.Offset);
+        mRangesByOwner.erase(it);
+    }
+
+    void CompactingRangeAllocator::Clear()
+    {
+        mAllocator = RangeAllocator{ mAllocator.Capacity() };
+        mRangesByOwner.clear();
+        mOwnersByOffset.clear();
+    }
+
+    std::vector<CompactingRangeAllocator::Move> CompactingRangeAllocator::Compact(uint64_t sizeBudget)
+    {
+        // Ranges too large for any hole below them are skipped, but only so many times per step
+        const uint64_t MaxFailedMoveCount = 32;
+
+        std::vector<Move> moves;
+        robin_hood::unordered_flat_set<uint64_t> movedOwners;
+        uint64_t movedSize = 0;
+        uint64_t failedMoveCount = 0;
+        uint64_t cursor = mAllocator.AllocatedExtent();
+
+        while (movedSize < sizeBudget && failedMoveCount < MaxFailedMoveCount)
+        {
+            auto it = mOwnersByOffset.lower_bound(cursor);
+
+            if (it == mOwnersByOffset.begin())
+                break;
+
+            --it;
+
+            auto [offset, owner] = *it;
+            cursor = offset;
+
+            // Moved ranges land below the cursor and are met again
+            if (movedOwners.find(owner) != movedOwners.end())
+                continue;
+
+            Range& range = mRangesByOwner[owner];
+            std::optional<uint64_t> newOffset = mAllocator.AllocateLowest(range.Size, offset);
+
+            if (!newOffset)
+            {
+                ++failedMoveCount;
+                continue;
+            }
+
+            mAllocator.Deallocate(offset, range.Size);
+            mOwnersByOffset.erase(it);
+            mOwnersByOffset.emplace(*newOffset, owner);
+            movedOwners.insert(owner);
+
+            moves.push_back({ owner, offset, *newOffset, range.Size });
+            range.Offset = *newOffset;
+            movedSize += range.Size;
+        }
+
+        return moves;
+    }
+
+    std::optional<CompactingRangeAllocator::Range> CompactingRangeAllocator::Find(uint64_t owner) const
+    {
+        auto it = mRangesByOwner.find(owner);
+        return it != mRangesByOwner.end() ? std::optional<Range>{ it->second } : std::nullopt;
+    }
+
+    bool CompactingRangeAllocator::RunBenchmark(const std::filesystem::path& reportPath)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        const uint64_t InitialCapacity = 1 << 16;
+        const uint64_t InitialOwnerCount = 8000;
+        const uint64_t ChurnOperationCount = 100000;
+        const uint64_t MaxRangeSize = 2048;
+        // Same order of magnitude as vertices moved by scene storage each frame
+        const uint64_t FrameCompactionBudget = 1 << 18;
+
+        std::ofstream stream{ reportPath, std::ios::out | std::ios::trunc };
+
+        if (!stream.is_open())
+            return false;
+
+        std::mt19937_64 generator{ 4242 };
+        std::uniform_int_distribution<uint64_t> sizeDistribution{ 1, MaxRangeSize };
+
+        // Stands in for GPU buffer contents: every element holds its owner
+        std::vector<uint32_t> contents;
+        std::vector<uint64_t> liveOwners;
+        uint64_t nextOwner = 1;
+
+        CompactingRangeAllocator allocator{ InitialCapacity };
+        uint64_t growthCount = 0;
+
+        auto add = [&]
+        {
+            uint64_t owner = nextOwner++;
+            uint64_t capacity = allocator.Capacity();
+            uint64_t offset = allocator.Allocate(owner, sizeDistribution(generator));
+
+            if (allocator.Capacity() != capacity)
+            {
+                contents.resize(allocator.Capacity());
+                ++growthCount;
+            }
+
+            std::fill_n(contents.begin() + offset, allocator.Find(owner)->Size, uint32_t(owner));
+            liveOwners.push_back(owner);
+        };
+
+        auto remove = [&]
+        {
+            uint64_t ownerIdx = generator() % liveOwners.size();
+            allocator.Deallocate(liveOwners[ownerIdx]);
+            std::swap(liveOwners[ownerIdx], liveOwners.back());
+            liveOwners.pop_back();
+        };
+
+        auto areContentsIntact = [&]
+        {
+            bool isIntact = allocator.OwnerCount() == liveOwners.size();
+            uint64_t allocatedSize = 0;
+
+            for (uint64_t owner : liveOwners)
+            {
+                std::optional<Range> range = allocator.Find(owner);
+
+                if (!range || range->Offset + range->Size > allocator.Capacity())
+                    return false;
+
+                isIntact &= std::all_of(contents.begin() + range->Offset, contents.begin() + range->Offset + range->Size,
+                    [owner](uint32_t element) { return element == owner; });
+
+                allocatedSize += range->Size;
+            }
+
+            return isIntact && allocatedSize == allocator.AllocatedSize();
+        };
+
+        contents.resize(allocator.Capacity());
+
+        auto fillStart = Clock::now();
+
+        for (uint64_t ownerIdx = 0; ownerIdx < InitialOwnerCount; ++ownerIdx)
+        {
+            add();
+        }
+
+        double fillSeconds = std::chrono::duration<double>(Clock::now() - fillStart).count();
+
+        // Streaming content in and out leaves holes all over the buffer
+        auto churnStart = Clock::now();
+
+        for (uint64_t operationIdx = 0; operationIdx < ChurnOperationCount; ++operationIdx)
+        {
+            if (generator() % 2 == 0 && !liveOwners.empty())
+                remove();
+            else
+                add();
+        }
+
+        double churnSeconds = std::chrono::duration<double>(Clock::now() - churnStart).count();
+
+        // Half of the content is streamed out at once
+        uint64_t unloadCount = liveOwners.size() / 2;
+
+        for (uint64_t ownerIdx = 0; ownerIdx < unloadCount; ++ownerIdx)
+        {
+            remove();
+        }
+
+        bool isIntactAfterChurn = areContentsIntact();
+        uint64_t extentBeforeCompaction = allocator.AllocatedExtent();
+        uint64_t allocatedSizeBeforeCompaction = allocator.AllocatedSize();
+
+        // Background compaction: one budgeted step per frame, moves are applied the way GPU copies would be
+        uint64_t compactionFrameCount = 0;
+        uint64_t movedElementCount = 0;
+        uint64_t moveCount = 0;
+        bool areMovesValid = true;
+        double compactionSeconds = 0.0;
+
+        while (true)
+        {
+            auto compactionStart = Clock::now();
+            std::vector<Move> moves = allocator.Compact(FrameCompactionBudget);
+            compactionSeconds += std::chrono::duration<double>(Clock::now() - compactionStart).count();
+
+            if (moves.empty())
+                break;
+
+            for (const Move& move : moves)
+            {
+                areMovesValid &= move.Offset < move.PreviousOffset && allocator.Find(move.Owner)->Offset == move.Offset;
+                std::copy_n(contents.begin() + move.PreviousOffset, move.Size, contents.begin() + move.Offset);
+                movedElementCount += move.Size;
+            }
+
+            moveCount += moves.size();
+            ++compactionFrameCount;
+        }
+
+        bool isIntactAfterCompaction = areContentsIntact();
+        uint64_t extentAfterCompaction = allocator.AllocatedExtent();
+
+        // Space freed at the end is reused before the buffer grows again
+        uint64_t capacityBeforeRefill = allocator.Capacity();
+        uint64_t refillCount = 0;
+
+        while (allocator.Capacity() - allocator.AllocatedExtent() > MaxRangeSize)
+        {
+            add();
+            ++refillCount;
+        }
+
+        bool isRefillInPlace = allocator.Capacity() == capacityBeforeRefill && areContentsIntact();
+
+        bool isValid = isIntactAfterChurn && isIntactAfterCompaction && areMovesValid && isRefillInPlace && extentAfterCompaction <= extentBeforeCompaction;
+
+        stream.precision(6);
+        stream << "{\"initialRanges\":" << InitialOwnerCount << ",\"churnOperations\":" << ChurnOperationCount << ",\"maxRangeSize\":" << MaxRangeSize
+            << ",\"fillOpsPerSecond\":" << InitialOwnerCount / fillSeconds << ",\"churnOpsPerSecond\":" << ChurnOperationCount / churnSeconds
+            << ",\"growthCount\":" << growthCount << ",\"capacity\":" << allocator.Capacity() << ",\"allocatedSize\":" << allocator.AllocatedSize()
+            << ",\"allocatedSizeBeforeCompaction\":" << allocatedSizeBeforeCompaction << ",\"extentBeforeCompaction\":" << extentBeforeCompaction << ",\"extentAfterCompaction\":" << extentAfterCompaction
+            << ",\"compactionFrames\":" << compactionFrameCount << ",\"moves\":" << moveCount << ",\"movedElements\":" << movedElementCount
+            << ",\"compactionMilliseconds\":" << compactionSeconds * 1000.0 << ",\"refilledRanges\":" << refillCount
+            << ",\"intactAfterChurn\":" << (isIntactAfterChurn ? "true" : "false")
+            << ",\"intactAfterCompaction\":" << (isIntactAfterCompaction ? "true" : "false")
+            << ",\"refillInPlace\":" << (isRefillInPlace ? "true" : "false")
+            << ",\"valid\":" << (isValid ? "true" : "false") << "}\n";
+
+        return isValid && stream.good();
+    }
+
+}
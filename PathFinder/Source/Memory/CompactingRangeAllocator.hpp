@@ -0,0 +1,71 @@
+#pragma once
+
+#include "RangeAllocator.hpp"
+
+#include <robinhood/robin_hood.h>
+
+#include <cstdint>
+#include <map>
+#include <vector>
+#include <optional>
+#include <filesystem>
+
+namespace Memory
+{
+
+    /// Hands out ranges of a growable buffer to owners identified by a key.
+    /// Capacity grows geometrically when no free range fits a request, so existing ranges never move during allocation.
+    /// Holes left by freed ranges are closed incrementally: each compaction step moves ranges from the end
+    /// into the lowest holes that can take them, within a size budget, and reports the moves
+    /// so that owners can copy their contents and remap their offsets.
+    class CompactingRangeAllocator
+    {
+    public:
+        struct Range
+        {
+            uint64_t Offset = 0;
+            uint64_t Size = 0;
+        };
+
+        struct Move
+        {
+            uint64_t Owner;
+            uint64_t PreviousOffset;
+            uint64_t Offset;
+            uint64_t Size;
+        };
+
+        CompactingRangeAllocator(uint64_t initialCapacity, float growthFactor = 2.0f);
+
+        // Grows capacity when no free range is large enough
+        uint64_t Allocate(uint64_t owner, uint64_t size);
+        void Deallocate(uint64_t owner);
+        void Clear();
+
+        // Moves ranges towards the start until the sum of moved sizes reaches the budget.
+        // Every move is to a lower offset and targets free space, so contents can be copied in any order.
+        std::vector<Move> Compact(uint64_t sizeBudget);
+
+        std::optional<Range> Find(uint64_t owner) const;
+
+        // Allocates, frees and compacts random ranges, checking that reported moves keep contents of every owner intact
+        static bool RunBenchmark(const std::filesystem::path& reportPath);
+
+    private:
+        RangeAllocator mAllocator;
+        float mGrowthFactor;
+
+        robin_hood::unordered_flat_map<uint64_t, Range> mRangesByOwner;
+
+        // Offset -> owner, compaction takes ranges from the end
+        std::map<uint64_t, uint64_t> mOwnersByOffset;
+
+    public:
+        inline uint64_t Capacity() const { return mAllocator.Capacity(); }
+        inline uint64_t AllocatedSize() const { return mAllocator.AllocatedSize(); }
+        inline uint64_t AllocatedExtent() const { return mAllocator.AllocatedExtent(); }
+        inline uint64_t OwnerCount() const { return mRangesByOwner.size(); }
+        inline bool Contains(uint64_t owner) const { return mRangesByOwner.find(owner) != mRangesByOwner.end(); }
+    };
+
+}
@@ -1,5 +1,6 @@
 #include "CopyRequestManager.hpp"
 
+#include <algorithm>
 
 
 namespace Memory
@@ -15,6 +16,20 @@ namespace Memory
         mReadbackRequests.emplace_back(CopyRequest{ resource, copyCommand });
     }
 
+    void CopyRequestManager::RequestRelocation(const HAL::Resource* source, const HAL::Resource* destination, const CopyCommand& copyCommand)
+    {
+        mUploadRequests.emplace_back(CopyRequest{ destination, copyCommand, source });
+    }
+
+    void CopyRequestManager::CancelUploadRequests(const HAL::Resource* resource)
+    {
+        mUploadRequests.erase(std::remove_if(mUploadRequests.begin(), mUploadRequests.end(), [resource](const CopyRequest& request)
+        {
+            return request.Resource == resource;
+        }), 
+        mUploadRequests.end());
+    }
+
     void CopyRequestManager::FlushUploadRequests()
     {
         mUploadRequests.clear();
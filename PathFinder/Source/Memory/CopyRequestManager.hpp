@@ -17,11 +17,18 @@ namespace Memory
         {
             const HAL::Resource* Resource = nullptr;
             CopyCommand Command;
+            // Resource that is copied from on GPU, if any
+            const HAL::Resource* SourceResource = nullptr;
         };
 
         void RequestUpload(const HAL::Resource* resource, const CopyCommand& copyCommand);
         void RequestReadback(const HAL::Resource* resource, const CopyCommand& copyCommand);
 
+        // GPU to GPU copy of resource contents, recorded together with uploads
+        void RequestRelocation(const HAL::Resource* source, const HAL::Resource* destination, const CopyCommand& copyCommand);
+
+        void CancelUploadRequests(const HAL::Resource* resource);
+
         void FlushUploadRequests();
         void FlushReadbackRequests();
         void FlushAllRequests();
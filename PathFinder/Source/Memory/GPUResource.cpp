@@ -28,6 +28,13 @@ namespace Memory
             return;
         }
 
+        // Relocation copy would discard new contents
+        if (IsRelocating())
+        {
+            CancelRelocation();
+            mRelocationFrameNumber = std::nullopt;
+        }
+
         AllocateNewUploadBuffer();
 
         if (mAccessStrategy != AccessStrategy::DirectUpload)
@@ -111,6 +118,14 @@ namespace Memory
 
     void GPUResource::EndFrame(uint64_t frameNumber)
     {
+        // Both resources hold the same contents once the copy is complete
+        if (mRelocationFrameNumber && *mRelocationFrameNumber <= frameNumber)
+        {
+            FinishRelocation();
+            mRelocationFrameNumber = std::nullopt;
+            ++mRelocationCount;
+        }
+
         // Release upload buffers for completed frames
         while (!mUploadBuffers.empty() && mUploadBuffers.front().second <= frameNumber)
         {
@@ -137,6 +152,49 @@ namespace Memory
         return nullptr;
     }
 
+    bool GPUResource::CanBeRelocated() const
+    {
+        return false;
+    }
+
+    bool GPUResource::BeginRelocation()
+    {
+        return false;
+    }
+
+    void GPUResource::DisableRelocation()
+    {
+        mIsRelocationDisabled = true;
+    }
+
+    void GPUResource::FinishRelocation()
+    {
+    }
+
+    void GPUResource::CancelRelocation()
+    {
+    }
+
+    bool GPUResource::IsRelocationAllowed(HAL::ResourceState expectedStates) const
+    {
+        // Copy destination is allowed since uploads cancel relocations
+        HAL::ResourceState writeStates = 
+            HAL::ResourceState::UnorderedAccess | 
+            HAL::ResourceState::RenderTarget | 
+            HAL::ResourceState::DepthWrite |
+            HAL::ResourceState::StreamOut |
+            HAL::ResourceState::ResolveDestination |
+            HAL::ResourceState::RaytracingAccelerationStructure;
+
+        return !mIsRelocationDisabled && 
+            !IsRelocating() &&
+            mStateTracker &&
+            mAccessStrategy == AccessStrategy::Automatic &&
+            mUploadBuffers.empty() && 
+            mReadbackBuffers.empty() &&
+            !EnumMaskContains(expectedStates, writeStates);
+    }
+
     HAL::Buffer* GPUResource::CurrentFrameUploadBuffer()
     {
         return !mUploadBuffers.empty() && mUploadBuffers.back().second == mFrameNumber ? 
@@ -59,6 +59,15 @@ namespace Memory
         virtual void EndFrame(uint64_t frameNumber);
         virtual const HAL::Resource* HALResource() const;
 
+        // Relocation copies contents into a new resource from the allocator and swaps underlying resources
+        // once the copy completes. Descriptors are recreated at new heap indices, so users that keep indices
+        // across frames should refresh them when RelocationCount() changes. Only resources that GPU never writes to can be relocated.
+        virtual bool CanBeRelocated() const;
+        virtual bool BeginRelocation();
+
+        // Resources whose HAL objects are referenced outside of GPUResource must stay in place
+        void DisableRelocation();
+
     protected:
         using BufferFrameNumberPair = std::pair<SegregatedPoolsResourceAllocator::BufferPtr, uint64_t>;
 
@@ -71,6 +80,10 @@ namespace Memory
         virtual uint64_t UploadAndReadbackResourceSize() const = 0;
         virtual CopyRequestManager::CopyCommand GetUploadCommands() = 0;
         virtual CopyRequestManager::CopyCommand GetReadbackCommands() = 0;
+        virtual void FinishRelocation();
+        virtual void CancelRelocation();
+
+        bool IsRelocationAllowed(HAL::ResourceState expectedStates) const;
 
         AccessStrategy mAccessStrategy = AccessStrategy::Automatic;
         ResourceStateTracker* mStateTracker;
@@ -84,12 +97,21 @@ namespace Memory
         std::string mDebugName;
         uint64_t mFrameNumber = 0; 
 
+        // Frame that copies contents of a resource being relocated
+        std::optional<uint64_t> mRelocationFrameNumber;
+        uint64_t mRelocationCount = 0;
+        bool mIsRelocationDisabled = false;
+
     private:
         void AllocateNewUploadBuffer();
         void AllocateNewReadbackBuffer();
 
         SegregatedPoolsResourceAllocator::BufferPtr mCompletedReadbackBuffer;
         SegregatedPoolsResourceAllocator::BufferPtr mCompletedUploadBuffer;
+
+    public:
+        inline bool IsRelocating() const { return mRelocationFrameNumber.has_value(); }
+        inline uint64_t RelocationCount() const { return mRelocationCount; }
     };
 
 }
@@ -49,6 +49,9 @@ namespace Memory
         PoolDescriptorAllocator* mDescriptorAllocator = nullptr;
         CopyRequestManager* mCopyRequestManager = nullptr;
         std::unordered_set<GPUResource*> mAllocatedResources;
+
+    public:
+        inline const auto& AllocatedResources() const { return mAllocatedResources; }
     };
 
 }
\ No newline at end of file
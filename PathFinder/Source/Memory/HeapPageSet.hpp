@@ -0,0 +1,108 @@
+#pragma once
+
+#include "RangeAllocator.hpp"
+
+#include <vector>
+#include <memory>
+#include <optional>
+
+namespace Memory
+{
+
+    template <class PageUserData>
+    class HeapPageSet;
+
+    template <
+        class PageUserData // User data to associate with each page, e.g. the heap backing it
+    >
+    struct HeapPage
+    {
+    public:
+        HeapPage(uint64_t capacity, PageUserData&& userData);
+
+        RangeAllocator Ranges;
+        bool IsEvacuating = false;
+        PageUserData UserData;
+
+    public:
+        inline uint64_t FreeBytes() const { return Ranges.Capacity() - Ranges.AllocatedSize(); }
+        inline double Utilization() const { return double(Ranges.AllocatedSize()) / Ranges.Capacity(); }
+    };
+
+
+
+    template <class PageUserData>
+    struct HeapPageAllocation
+    {
+        HeapPage<PageUserData>* Page = nullptr;
+        uint64_t Offset = 0;
+        uint64_t Size = 0;
+    };
+
+
+
+    struct HeapPageFragmentationMetrics
+    {
+        uint64_t PageCount = 0;
+        uint64_t SparsePageCount = 0;
+        uint64_t EvacuatingPageCount = 0;
+        uint64_t CapacityBytes = 0;
+        uint64_t FreeBytes = 0;
+        uint64_t LargestFreeRangeBytes = 0;
+        uint64_t LargestFreeRangesSumBytes = 0;
+
+        // 0 when free memory of every page is a single range, approaches 1 as it's scattered in small ranges
+        double ExternalFragmentation = 0.0;
+        double Utilization = 1.0;
+    };
+
+
+    /// Sub-allocates ranges of heap pages of a single aliasing group.
+    /// Pages are added by the owner, which creates the memory backing them, when nothing fits existing ones.
+    /// Pages are evacuated one at a time: evacuating pages take no new allocations
+    /// and are released as soon as their contents are moved elsewhere.
+    template <class PageUserData>
+    class HeapPageSet
+    {
+    public:
+        using Page = HeapPage<PageUserData>;
+        using Allocation = HeapPageAllocation<PageUserData>;
+        using PageList = std::vector<std::unique_ptr<Page>>;
+
+        // New pages grow with the memory already used by the set, but stay within page size limits
+        HeapPageSet(uint64_t minimumPageSize, uint64_t maximumPageSize);
+
+        // Nothing is returned if no page outside of evacuation has an aligned range large enough
+        std::optional<Allocation> Allocate(uint64_t size, uint64_t alignment);
+        void Deallocate(const Allocation& allocation);
+
+        // Resources that don't fit a regular page get a dedicated one
+        uint64_t NewPageSize(uint64_t size, uint64_t alignment) const;
+        Page& AddPage(uint64_t capacity, PageUserData&& userData);
+
+        // Sparsest non-empty page below the utilization limit whose allocations fit into free memory of other pages.
+        // Empty pages are left to the owner to release.
+        Page* FindEvacuationCandidate(double utilizationLimit) const;
+        void AbandonEvacuations();
+        bool IsEvacuationInProgress() const;
+
+        // Returns the number of emptied evacuating pages that were removed
+        uint64_t ReleaseEvacuatedPages();
+
+        // Adds pages of this set to metrics gathered across several sets
+        void AccumulateFragmentationMetrics(float sparsePageUtilization, HeapPageFragmentationMetrics& metrics) const;
+
+    private:
+        PageList mPages;
+
+        uint64_t mMinimumPageSize = 0;
+        uint64_t mMaximumPageSize = 0;
+
+    public:
+        inline PageList& Pages() { return mPages; }
+        inline const PageList& Pages() const { return mPages; }
+    };
+
+}
+
+#include "HeapPageSet.inl"
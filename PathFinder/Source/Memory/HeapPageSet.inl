@@ -0,0 +1,142 @@
+#include <Foundation/MemoryUtils.hpp>
+#include <Foundation/Assert.hpp>
+
+#include <algorithm>
+
+namespace Memory
+{
+
+    template <class PageUserData>
+    HeapPage<PageUserData>::HeapPage(uint64_t capacity, PageUserData&& userData)
+        : Ranges{ capacity }, UserData{ std::move(userData) } {}
+
+
+
+    template <class PageUserData>
+    HeapPageSet<PageUserData>::HeapPageSet(uint64_t minimumPageSize, uint64_t maximumPageSize)
+        : mMinimumPageSize{ minimumPageSize }, mMaximumPageSize{ maximumPageSize } {}
+
+    template <class PageUserData>
+    std::optional<typename HeapPageSet<PageUserData>::Allocation> HeapPageSet<PageUserData>::Allocate(uint64_t size, uint64_t alignment)
+    {
+        assert_format(size > 0, "0 bytes allocations are forbidden");
+
+        for (const std::unique_ptr<Page>& page : mPages)
+        {
+            if (page->IsEvacuating)
+                continue;
+
+            if (std::optional<uint64_t> offset = page->Ranges.Allocate(size, alignment))
+            {
+                return Allocation{ page.get(), *offset, size };
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    template <class PageUserData>
+    void HeapPageSet<PageUserData>::Deallocate(const Allocation& allocation)
+    {
+        allocation.Page->Ranges.Deallocate(allocation.Offset, allocation.Size);
+    }
+
+    template <class PageUserData>
+    uint64_t HeapPageSet<PageUserData>::NewPageSize(uint64_t size, uint64_t alignment) const
+    {
+        uint64_t pagesCapacity = 0;
+
+        for (const std::unique_ptr<Page>& page : mPages)
+        {
+            pagesCapacity += page->Ranges.Capacity();
+        }
+
+        // Pages grow with the set to keep heap count low
+        uint64_t pageSize = std::clamp(pagesCapacity / 2, mMinimumPageSize, mMaximumPageSize);
+        return std::max(pageSize, Foundation::MemoryUtils::Align(size, alignment));
+    }
+
+    template <class PageUserData>
+    typename HeapPageSet<PageUserData>::Page& HeapPageSet<PageUserData>::AddPage(uint64_t capacity, PageUserData&& userData)
+    {
+        return *mPages.emplace_back(std::make_unique<Page>(capacity, std::move(userData)));
+    }
+
+    template <class PageUserData>
+    typename HeapPageSet<PageUserData>::Page* HeapPageSet<PageUserData>::FindEvacuationCandidate(double utilizationLimit) const
+    {
+        Page* candidate = nullptr;
+        uint64_t freeBytes = 0;
+
+        for (const std::unique_ptr<Page>& page : mPages)
+        {
+            freeBytes += page->FreeBytes();
+        }
+
+        for (const std::unique_ptr<Page>& page : mPages)
+        {
+            uint64_t otherPagesFreeBytes = freeBytes - page->FreeBytes();
+            double utilization = page->Utilization();
+
+            if (!page->Ranges.IsEmpty() && utilization < utilizationLimit && page->Ranges.AllocatedSize() <= otherPagesFreeBytes)
+            {
+                candidate = page.get();
+                utilizationLimit = utilization;
+            }
+        }
+
+        return candidate;
+    }
+
+    template <class PageUserData>
+    void HeapPageSet<PageUserData>::AbandonEvacuations()
+    {
+        for (const std::unique_ptr<Page>& page : mPages)
+        {
+            page->IsEvacuating = false;
+        }
+    }
+
+    template <class PageUserData>
+    bool HeapPageSet<PageUserData>::IsEvacuationInProgress() const
+    {
+        for (const std::unique_ptr<Page>& page : mPages)
+        {
+            if (page->IsEvacuating) return true;
+        }
+
+        return false;
+    }
+
+    template <class PageUserData>
+    uint64_t HeapPageSet<PageUserData>::ReleaseEvacuatedPages()
+    {
+        auto evacuatedIt = std::remove_if(mPages.begin(), mPages.end(), [](const std::unique_ptr<Page>& page)
+        {
+            return page->IsEvacuating && page->Ranges.IsEmpty();
+        });
+
+        uint64_t releasedPageCount = std::distance(evacuatedIt, mPages.end());
+        mPages.erase(evacuatedIt, mPages.end());
+        return releasedPageCount;
+    }
+
+    template <class PageUserData>
+    void HeapPageSet<PageUserData>::AccumulateFragmentationMetrics(float sparsePageUtilization, HeapPageFragmentationMetrics& metrics) const
+    {
+        for (const std::unique_ptr<Page>& page : mPages)
+        {
+            ++metrics.PageCount;
+            metrics.SparsePageCount += page->Utilization() < sparsePageUtilization ? 1 : 0;
+            metrics.EvacuatingPageCount += page->IsEvacuating ? 1 : 0;
+            metrics.CapacityBytes += page->Ranges.Capacity();
+            metrics.FreeBytes += page->FreeBytes();
+            metrics.LargestFreeRangeBytes = std::max(metrics.LargestFreeRangeBytes, page->Ranges.LargestFreeRangeSize());
+            metrics.LargestFreeRangesSumBytes += page->Ranges.LargestFreeRangeSize();
+        }
+
+        metrics.ExternalFragmentation = metrics.FreeBytes > 0 ? 1.0 - double(metrics.LargestFreeRangesSumBytes) / metrics.FreeBytes : 0.0;
+        metrics.Utilization = metrics.CapacityBytes > 0 ? 1.0 - double(metrics.FreeBytes) / metrics.CapacityBytes : 1.0;
+    }
+
+}
@@ -40,6 +40,7 @@ namespace Memory
 
     public:
         inline auto SlotSize() const { return mSlotSize; }
+        inline auto GrowSlotCount() const { return mGrowSlotCount; }
     };
 
 }
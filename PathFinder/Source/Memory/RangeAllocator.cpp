@@ -0,0 +1,159 @@
+#include "RangeAllocator.hpp"
+
+#include <Foundation/MemoryUtils.hpp>
+#include <Foundation/Assert.hpp>
+
+#include <iterator>
+
+namespace Memory
+{
+
+    RangeAllocator::RangeAllocator(uint64_t capacity)
+        : mCapacity{ capacity }
+    {
+        AddFreeRange(0, capacity);
+    }
+
+    std::optional<uint64_t> RangeAllocator::Allocate(uint64_t size, uint64_t alignment)
+    {
+        assert_format(size > 0, "0 bytes allocations are forbidden");
+
+        // Smallest range that fits the size is tried first. Alignment padding can make it unsuitable,
+        // in which case progressively larger ranges are checked.
+        for (auto it = mFreeRangesBySize.lower_bound({ size, 0 }); it != mFreeRangesBySize.end(); ++it)
+        {
+            auto [rangeSize, rangeOffset] = *it;
+            uint64_t alignedOffset = Foundation::MemoryUtils::Align(rangeOffset, alignment);
+            uint64_t padding = alignedOffset - rangeOffset;
+
+            if (padding + size > rangeSize)
+                continue;
+
+            return AllocateFromRange(rangeOffset, rangeSize, alignedOffset, size);
+        }
+
+        return std::nullopt;
+    }
+
+    std::optional<uint64_t> RangeAllocator::AllocateLowest(uint64_t size, uint64_t offsetLimit, uint64_t alignment)
+    {
+        assert_format(size > 0, "0 bytes allocations are forbidden");
+
+        for (auto it = mFreeRangesByOffset.begin(); it != mFreeRangesByOffset.end() && it->first < offsetLimit; ++it)
+        {
+            auto [rangeOffset, rangeSize] = *it;
+            uint64_t alignedOffset = Foundation::MemoryUtils::Align(rangeOffset, alignment);
+
+            if (alignedOffset >= offsetLimit || alignedOffset - rangeOffset + size > rangeSize)
+                continue;
+
+            return AllocateFromRange(rangeOffset, rangeSize, alignedOffset, size);
+        }
+
+        return std::nullopt;
+    }
+
+    uint64_t RangeAllocator::AllocateFromRange(uint64_t rangeOffset, uint64_t rangeSize, uint64_t alignedOffset, uint64_t size)
+    {
+        uint64_t padding = alignedOffset - rangeOffset;
+
+        RemoveFreeRange(rangeOffset, rangeSize);
+
+        // Return leading padding and trailing remainder to the free lists
+        if (padding > 0) AddFreeRange(rangeOffset, padding);
+        if (rangeSize > padding + size) AddFreeRange(alignedOffset + size, rangeSize - padding - size);
+
+        mAllocatedSize += size;
+
+        return alignedOffset;
+    }
+
+    void RangeAllocator::Deallocate(uint64_t offset, uint64_t size)
+    {
+        assert_format(offset + size <= mCapacity && size <= mAllocatedSize, "Range doesn't belong to the allocator");
+
+        mAllocatedSize -= size;
+
+        uint64_t freeOffset = offset;
+        uint64_t freeSize = size;
+
+        // Coalesce with the following free range
+        auto nextIt = mFreeRangesByOffset.lower_bound(offset);
+
+        if (nextIt != mFreeRangesByOffset.end() && nextIt->first == offset + size)
+        {
+            freeSize += nextIt->second;
+            RemoveFreeRange(nextIt->first, nextIt->second);
+            nextIt = mFreeRangesByOffset.lower_bound(offset);
+        }
+
+        // Coalesce with the preceding free range
+        if (nextIt != mFreeRangesByOffset.begin())
+        {
+            auto previousIt = std::prev(nextIt);
+
+            if (previousIt->first + previousIt->second == offset)
+            {
+                freeOffset = previousIt->first;
+                freeSize += previousIt->second;
+                RemoveFreeRange(previousIt->first, previousIt->second);
+            }
+        }
+
+        AddFreeRange(freeOffset, freeSize);
+    }
+
+    void RangeAllocator::Grow(uint64_t newCapacity)
+    {
+        assert_format(newCapacity >= mCapacity, "Range allocator can't shrink");
+
+        if (newCapacity == mCapacity)
+            return;
+
+        uint64_t freeOffset = mCapacity;
+        uint64_t freeSize = newCapacity - mCapacity;
+
+        // Coalesce with the free range at the end
+        if (!mFreeRangesByOffset.empty())
+        {
+            auto [lastOffset, lastSize] = *mFreeRangesByOffset.rbegin();
+
+            if (lastOffset + lastSize == mCapacity)
+            {
+                freeOffset = lastOffset;
+                freeSize += lastSize;
+                RemoveFreeRange(lastOffset, lastSize);
+            }
+        }
+
+        AddFreeRange(freeOffset, freeSize);
+        mCapacity = newCapacity;
+    }
+
+    uint64_t RangeAllocator::LargestFreeRangeSize() const
+    {
+        return mFreeRangesBySize.empty() ? 0 : mFreeRangesBySize.rbegin()->first;
+    }
+
+    uint64_t RangeAllocator::AllocatedExtent() const
+    {
+        if (mFreeRangesByOffset.empty())
+            return mCapacity;
+
+        auto [lastOffset, lastSize] = *mFreeRangesByOffset.rbegin();
+        return lastOffset + lastSize == mCapacity ? lastOffset : mCapacity;
+    }
+
+    void RangeAllocator::AddFreeRange(uint64_t offset, uint64_t size)
+    {
+        mFreeRangesByOffset.emplace(offset, size);
+        mFreeRangesBySize.emplace(size, offset);
+    }
+
+    void RangeAllocator::RemoveFreeRange(uint64_t offset, uint64_t size)
+    {
+        mFreeRangesByOffset.erase(offset);
+        mFreeRangesBySize.erase({ size, offset });
+    }
+
+}
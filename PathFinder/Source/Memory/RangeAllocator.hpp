@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <optional>
+
+namespace Memory
+{
+
+    /// Sub-allocates ranges of a fixed size memory block.
+    /// Free ranges are tracked both by offset, to coalesce neighbours on deallocation,
+    /// and by size, to find the best fitting range with respect to alignment.
+    class RangeAllocator
+    {
+    public:
+        RangeAllocator(uint64_t capacity);
+
+        // Returns offset of an aligned range or nothing when there is no free range large enough
+        std::optional<uint64_t> Allocate(uint64_t size, uint64_t alignment = 1);
+
+        // Lowest free range that fits and starts below the limit, used to pack allocations towards the start
+        std::optional<uint64_t> AllocateLowest(uint64_t size, uint64_t offsetLimit, uint64_t alignment = 1);
+
+        // Offset and size must match a previous allocation
+        void Deallocate(uint64_t offset, uint64_t size);
+
+        // Appends free space to the end, existing allocations stay in place
+        void Grow(uint64_t newCapacity);
+
+        uint64_t LargestFreeRangeSize() const;
+
+        // End of the last allocated range
+        uint64_t AllocatedExtent() const;
+
+    private:
+        void AddFreeRange(uint64_t offset, uint64_t size);
+        void RemoveFreeRange(uint64_t offset, uint64_t size);
+        uint64_t AllocateFromRange(uint64_t rangeOffset, uint64_t rangeSize, uint64_t alignedOffset, uint64_t size);
+
+        // Offset -> size
+        std::map<uint64_t, uint64_t> mFreeRangesByOffset;
+
+        // Size, offset pairs ordered by size
+        std::set<std::pair<uint64_t, uint64_t>> mFreeRangesBySize;
+
+        uint64_t mCapacity = 0;
+        uint64_t mAllocatedSize = 0;
+
+    public:
+        inline auto Capacity() const { return mCapacity; }
+        inline auto AllocatedSize() const { return mAllocatedSize; }
+        inline bool IsEmpty() const { return mAllocatedSize == 0; }
+    };
+
+}
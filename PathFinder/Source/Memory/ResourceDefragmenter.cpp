@@ -0,0 +1,263 @@
+#include "ResourceDefragmenter.hpp"
+
+#include <fstream>
+#include <random>
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+namespace Memory
+{
+
+    ResourceDefragmenter::ResourceDefragmenter(SegregatedPoolsResourceAllocator* resourceAllocator, GPUResourceProducer* resourceProducer)
+        : mResourceAllocator{ resourceAllocator }, mResourceProducer{ resourceProducer } {}
+
+    void ResourceDefragmenter::BeginFrame(uint64_t frameNumber)
+    {
+        if (!mIsEnabled)
+            return;
+
+        if (!mResourceAllocator->IsHeapPageEvacuationInProgress())
+        {
+            if (frameNumber < mNextEvacuationFrameNumber || !mResourceAllocator->BeginHeapPageEvacuation(SparsePageUtilization))
+                return;
+
+            ++mStatistics.EvacuationsStarted;
+            mStalledFrameCount = 0;
+        }
+
+        std::vector<GPUResource*> relocationCandidates;
+        uint64_t relocatingResourceCount = 0;
+
+        for (GPUResource* resource : mResourceProducer->AllocatedResources())
+        {
+            if (!mResourceAllocator->IsPlacedInEvacuatingHeapPage(resource->HALResource()))
+                continue;
+
+            if (resource->IsRelocating())
+            {
+                ++relocatingResourceCount;
+                continue;
+            }
+
+            // A single pinned resource keeps the page alive, moving the rest would be a waste
+            if (!resource->CanBeRelocated())
+            {
+                AbandonEvacuation(frameNumber);
+                return;
+            }
+
+            relocationCandidates.push_back(resource);
+        }
+
+        // Page is being emptied by deferred deallocations
+        if (relocationCandidates.empty() && relocatingResourceCount == 0)
+        {
+            if (++mStalledFrameCount > StalledEvacuationFrameCount)
+                AbandonEvacuation(frameNumber);
+
+            return;
+        }
+
+        mStalledFrameCount = 0;
+
+        uint64_t relocatedBytes = 0;
+
+        for (GPUResource* resource : relocationCandidates)
+        {
+            uint64_t resourceSize = resource->HALResource()->TotalMemory();
+
+            // At least one resource is moved each frame regardless of its size
+            if (relocatedBytes > 0 && relocatedBytes + resourceSize > FrameRelocationByteBudget)
+                break;
+
+            // Rest of the aliasing group turned out too fragmented to take the resource
+            if (!resource->BeginRelocation())
+            {
+                AbandonEvacuation(frameNumber);
+                return;
+            }
+
+            relocatedBytes += resourceSize;
+            ++mStatistics.RelocationsStarted;
+        }
+
+        mStatistics.RelocatedBytes += relocatedBytes;
+    }
+
+    void ResourceDefragmenter::AbandonEvacuation(uint64_t frameNumber)
+    {
+        // Relocations in flight complete normally, their previous resources return memory to the page
+        mResourceAllocator->AbandonHeapPageEvacuations();
+        mNextEvacuationFrameNumber = frameNumber + AbandonedEvacuationCooldownFrameCount;
+        ++mStatistics.EvacuationsAbandoned;
+    }
+
+    bool ResourceDefragmenter::RunBenchmark(const HAL::Device* device, const std::filesystem::path& reportPath)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        struct LiveResource
+        {
+            GPUResourceProducer::BufferPtr Buffer;
+            GPUResourceProducer::TexturePtr Texture;
+            uint64_t ReleaseFrame = 0;
+            bool IsBoundBindlessly = false;
+        };
+
+        std::ofstream stream{ reportPath, std::ios::out | std::ios::trunc };
+
+        if (!stream.is_open())
+        {
+            return false;
+        }
+
+        const uint8_t FramesInFlight = 2;
+        const uint64_t FrameCount = 30000;
+        const uint64_t SampleInterval = 1000;
+
+        // Lifetimes are log-uniform: most resources are short lived edits, a few live through the whole session
+        // and pin heap pages that would otherwise have been released
+        const double MinLifetime = 16.0;
+        const double MaxLifetime = 6000.0;
+
+        std::vector<std::string> modes = { "withoutDefragmentation", "withDefragmentation" };
+
+        stream.precision(6);
+        stream << "{\"units\":\"megabytes\",\"results\":[\n";
+
+        bool isFirstResult = true;
+
+        for (const std::string& mode : modes)
+        {
+            SegregatedPoolsResourceAllocator resourceAllocator{ device, FramesInFlight };
+            PoolDescriptorAllocator descriptorAllocator{ device, FramesInFlight };
+            ResourceStateTracker stateTracker;
+            CopyRequestManager copyRequestManager;
+            GPUResourceProducer resourceProducer{ device, &resourceAllocator, &stateTracker, &descriptorAllocator, &copyRequestManager };
+            ResourceDefragmenter defragmenter{ &resourceAllocator, &resourceProducer };
+
+            defragmenter.SetEnabled(mode == "withDefragmentation");
+
+            // Both modes replay the same session
+            std::mt19937 randomEngine{ 1337 };
+            std::uniform_real_distribution<double> logLifetimeDistribution{ std::log(MinLifetime), std::log(MaxLifetime) };
+            std::uniform_int_distribution<uint64_t> bufferSizeDistribution{ 4 * 1024, 1024 * 1024 };
+            std::uniform_int_distribution<uint32_t> textureSizeDistribution{ 7, 9 };
+            std::uniform_real_distribution<double> kindDistribution{ 0.0, 1.0 };
+
+            std::vector<LiveResource> liveResources;
+            double peakCommittedMegabytes = 0.0;
+            double defragmentationTime = 0.0;
+
+            stream << (isFirstResult ? "" : ",\n") << "{\"mode\":\"" << mode << "\",\"samples\":[";
+
+            for (uint64_t frameNumber = 1; frameNumber <= FrameCount; ++frameNumber)
+            {
+                resourceAllocator.BeginFrame(frameNumber);
+                descriptorAllocator.BeginFrame(frameNumber);
+                resourceProducer.BeginFrame(frameNumber);
+
+                auto defragmentationStart = Clock::now();
+                defragmenter.BeginFrame(frameNumber);
+                defragmentationTime += std::chrono::duration<double, std::milli>(Clock::now() - defragmentationStart).count();
+
+                liveResources.erase(std::remove_if(liveResources.begin(), liveResources.end(), [frameNumber](const LiveResource& resource)
+                {
+                    return resource.ReleaseFrame <= frameNumber;
+                }),
+                liveResources.end());
+
+                LiveResource resource{};
+                resource.ReleaseFrame = frameNumber + static_cast<uint64_t>(std::exp(logLifetimeDistribution(randomEngine)));
+                double kind = kindDistribution(randomEngine);
+
+                if (kind < 0.45)
+                {
+                    // Read only textures, e.g. imported or baked maps
+                    uint64_t dimension = 1ull << textureSizeDistribution(randomEngine);
+                    HAL::TextureProperties properties{ HAL::ColorFormat::RGBA8_Unsigned_Norm, HAL::TextureKind::Texture2D,
+                        Geometry::Dimensions{ dimension, dimension }, HAL::ResourceState::AnyShaderAccess };
+
+                    resource.Texture = resourceProducer.NewTexture(properties);
+
+                    // Some textures are bound bindlessly and get a new descriptor each time they're relocated
+                    resource.IsBoundBindlessly = kind < 0.1;
+                }
+                else if (kind < 0.85)
+                {
+                    // Read only buffers, e.g. geometry and material data
+                    auto properties = HAL::BufferProperties::Create<uint8_t>(bufferSizeDistribution(randomEngine), 1, HAL::ResourceState::AnyShaderAccess);
+                    resource.Buffer = resourceProducer.NewBuffer(properties);
+                }
+                else
+                {
+                    // GPU written buffers can't be relocated
+                    auto properties = HAL::BufferProperties::Create<uint8_t>(bufferSizeDistribution(randomEngine), 1, HAL::ResourceState::UnorderedAccess);
+                    resource.Buffer = resourceProducer.NewBuffer(properties);
+                }
+
+                liveResources.push_back(std::move(resource));
+
+                // Bindless tables are refreshed every frame, which keeps descriptors of relocated textures in use
+                for (const LiveResource& liveResource : liveResources)
+                {
+                    if (liveResource.IsBoundBindlessly)
+                        liveResource.Texture->GetSRDescriptor();
+                }
+
+                // No GPU work is executed, copies and transitions are considered done as soon as they're requested
+                copyRequestManager.FlushUploadRequests();
+                stateTracker.ApplyRequestedTransitions();
+
+                // GPU is simulated to lag one frame behind
+                resourceProducer.EndFrame(frameNumber - 1);
+                resourceAllocator.EndFrame(frameNumber - 1);
+                descriptorAllocator.EndFrame(frameNumber - 1);
+
+                SegregatedPoolsResourceAllocator::Statistics statistics = resourceAllocator.GetStatistics();
+                double committedMegabytes = statistics.CommittedHeapBytes / (1024.0 * 1024.0);
+                peakCommittedMegabytes = std::max(peakCommittedMegabytes, committedMegabytes);
+
+                if (frameNumber % SampleInterval == 0)
+                {
+                    SegregatedPoolsResourceAllocator::FragmentationMetrics metrics = resourceAllocator.GetFragmentationMetrics(SparsePageUtilization);
+
+                    stream << (frameNumber == SampleInterval ? "" : ",") << "{\"frame\":" << frameNumber
+                        << ",\"liveResources\":" << liveResources.size()
+                        << ",\"heapPages\":" << metrics.PageCount
+                        << ",\"sparseHeapPages\":" << metrics.SparsePageCount
+                        << ",\"committedHeapMegabytes\":" << committedMegabytes
+                        << ",\"freeMegabytes\":" << metrics.FreeBytes / (1024.0 * 1024.0)
+                        << ",\"utilization\":" << metrics.Utilization
+                        << ",\"externalFragmentation\":" << metrics.ExternalFragmentation << "}";
+                }
+            }
+
+            const Statistics& defragmentationStatistics = defragmenter.GetStatistics();
+
+            stream << "],\"peakCommittedHeapMegabytes\":" << peakCommittedMegabytes
+                << ",\"evacuationsStarted\":" << defragmentationStatistics.EvacuationsStarted
+                << ",\"evacuationsAbandoned\":" << defragmentationStatistics.EvacuationsAbandoned
+                << ",\"releasedHeapPages\":" << resourceAllocator.GetStatistics().EvacuatedHeapReleaseCount
+                << ",\"relocations\":" << defragmentationStatistics.RelocationsStarted
+                << ",\"relocatedMegabytes\":" << defragmentationStatistics.RelocatedBytes / (1024.0 * 1024.0)
+                << ",\"meanDefragmentationMilliseconds\":" << defragmentationTime / FrameCount << "}";
+
+            isFirstResult = false;
+
+            // Let every resource go before the allocators
+            liveResources.clear();
+            resourceProducer.EndFrame(FrameCount);
+            resourceAllocator.EndFrame(FrameCount);
+            descriptorAllocator.EndFrame(FrameCount);
+        }
+
+        stream << "]}\n";
+
+        return true;
+    }
+
+}
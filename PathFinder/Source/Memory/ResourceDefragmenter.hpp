@@ -0,0 +1,62 @@
+#pragma once
+
+#include "GPUResourceProducer.hpp"
+#include "SegregatedPoolsResourceAllocator.hpp"
+
+#include <filesystem>
+
+namespace Memory
+{
+
+    /// Moves resources out of sparse default memory heap pages so that the pages could be released.
+    /// One page is evacuated at a time. Relocations are started within a per frame byte budget
+    /// and their copies are executed together with regular uploads.
+    class ResourceDefragmenter
+    {
+    public:
+        struct Statistics
+        {
+            uint64_t EvacuationsStarted = 0;
+            uint64_t EvacuationsAbandoned = 0;
+            uint64_t RelocationsStarted = 0;
+            uint64_t RelocatedBytes = 0;
+        };
+
+        ResourceDefragmenter(SegregatedPoolsResourceAllocator* resourceAllocator, GPUResourceProducer* resourceProducer);
+
+        // Must be called after resource producer frame start and before upload requests are recorded
+        void BeginFrame(uint64_t frameNumber);
+
+        // Simulates a long editing session with and without defragmentation and reports memory and fragmentation over time
+        static bool RunBenchmark(const HAL::Device* device, const std::filesystem::path& reportPath);
+
+        // Pages filled below this fraction are evacuated
+        inline static const float SparsePageUtilization = 0.25f;
+
+    private:
+        inline static const uint64_t FrameRelocationByteBudget = 32 * 1024 * 1024;
+
+        // Frames to wait before looking for another page after an evacuation couldn't be finished
+        inline static const uint64_t AbandonedEvacuationCooldownFrameCount = 300;
+
+        // Evacuation is abandoned if the page is still not empty after this many frames without relocations,
+        // which means it's held by resources unknown to the resource producer
+        inline static const uint64_t StalledEvacuationFrameCount = 16;
+
+        void AbandonEvacuation(uint64_t frameNumber);
+
+        SegregatedPoolsResourceAllocator* mResourceAllocator = nullptr;
+        GPUResourceProducer* mResourceProducer = nullptr;
+
+        uint64_t mNextEvacuationFrameNumber = 0;
+        uint64_t mStalledFrameCount = 0;
+        bool mIsEnabled = true;
+        Statistics mStatistics;
+
+    public:
+        inline void SetEnabled(bool enabled) { mIsEnabled = enabled; }
+        inline bool IsEnabled() const { return mIsEnabled; }
+        inline const Statistics& GetStatistics() const { return mStatistics; }
+    };
+
+}
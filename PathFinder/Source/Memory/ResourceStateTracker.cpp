@@ -16,6 +16,12 @@ namespace Memory
         }
     }
 
+    void ResourceStateTracker::StartTrakingResource(const HAL::Resource* resource, const SubresourceStateList& currentStates)
+    {
+        assert_format(currentStates.size() == resource->SubresourceCount(), "Subresource states don't match the resource");
+        mCurrentResourceStates[resource] = currentStates;
+    }
+
     void ResourceStateTracker::StopTrakingResource(const HAL::Resource* resource)
     {
         mCurrentResourceStates.erase(resource);
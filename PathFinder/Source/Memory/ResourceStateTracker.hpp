@@ -20,6 +20,8 @@ namespace Memory
         using SubresourceStateList = std::vector<SubresourceState>;
 
         void StartTrakingResource(const HAL::Resource* resource);
+        // Continue tracking from known states, e.g. when a resource is reused
+        void StartTrakingResource(const HAL::Resource* resource, const SubresourceStateList& currentStates);
         void StopTrakingResource(const HAL::Resource* resource);
 
         // Queue state update but wait until ApplyRequestedTransitions
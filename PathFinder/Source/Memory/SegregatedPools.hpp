@@ -3,6 +3,7 @@
 #include "Pool.hpp"
 
 #include <vector>
+#include <limits>
 
 namespace Memory
 {
@@ -30,6 +31,7 @@ namespace Memory
 
     public:
         inline auto SlotSize() const { return mSlotSize; }
+        inline auto GrowSlotCount() const { return mSlots.GrowSlotCount(); }
     };
 
 
@@ -51,7 +53,8 @@ namespace Memory
         using Allocation = SegregatedPoolsAllocation<BucketUserData, SlotUserData>;
         using Bucket = SegregatedPoolsBucket<BucketUserData, SlotUserData>;
 
-        SegregatedPools(uint64_t minimumBucketSlotSize, uint64_t bucketGrowSlotCount);
+        // Buckets grow by a number of slots that doesn't exceed maximum grow size, but by at least one slot
+        SegregatedPools(uint64_t minimumBucketSlotSize, uint64_t bucketGrowSlotCount, uint64_t maximumBucketGrowSize = std::numeric_limits<uint64_t>::max());
 
         uint64_t SlotSizeInBucket(uint64_t bucketIndex) const;
         Bucket& GetBucket(uint64_t index);
@@ -67,6 +70,7 @@ namespace Memory
 
         uint64_t mMinimumBucketSlotSize = 4096;
         uint64_t mGrowSlotCount = 0;
+        uint64_t mMaximumBucketGrowSize = 0;
     };
 
 }
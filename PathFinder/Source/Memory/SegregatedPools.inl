@@ -1,4 +1,5 @@
 #include <cmath>
+#include <algorithm>
 
 
 namespace Memory
@@ -12,8 +13,8 @@ namespace Memory
 
 
     template <class BucketUserData, class SlotUserData>
-    SegregatedPools<BucketUserData, SlotUserData>::SegregatedPools(uint64_t minimumBucketSlotSize, uint64_t bucketGrowSlotCount)
-        : mMinimumBucketSlotSize{ minimumBucketSlotSize }, mGrowSlotCount{ bucketGrowSlotCount } {}
+    SegregatedPools<BucketUserData, SlotUserData>::SegregatedPools(uint64_t minimumBucketSlotSize, uint64_t bucketGrowSlotCount, uint64_t maximumBucketGrowSize)
+        : mMinimumBucketSlotSize{ minimumBucketSlotSize }, mGrowSlotCount{ bucketGrowSlotCount }, mMaximumBucketGrowSize{ maximumBucketGrowSize } {}
 
     template <class BucketUserData, class SlotUserData>
     uint32_t SegregatedPools<BucketUserData, SlotUserData>::CalculateBucketIndex(uint64_t allocationSize)
@@ -61,7 +62,8 @@ namespace Memory
             {
                 uint64_t newBucketIndex = mBuckets.size();
                 uint64_t slotSize = std::powf(2.0f, newBucketIndex);
-                auto& bucket = mBuckets.emplace_back(slotSize, mGrowSlotCount);
+                uint64_t growSlotCount = std::clamp<uint64_t>(mMaximumBucketGrowSize / slotSize, 1, mGrowSlotCount);
+                auto& bucket = mBuckets.emplace_back(slotSize, growSlotCount);
                 bucket.mBucketIndex = newBucketIndex;
                 bucket.mSlotSize = slotSize;
 
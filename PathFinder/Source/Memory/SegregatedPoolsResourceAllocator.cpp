@@ -1,5 +1,14 @@
 #include "SegregatedPoolsResourceAllocator.hpp"
 
+#include <Foundation/Visitor.hpp>
+
+#include <robinhood/robin_hood.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <random>
+
 namespace Memory
 {
 
@@ -7,13 +16,10 @@ namespace Memory
         : mDevice{ device }, 
         mRingFrameTracker{ simultaneousFramesInFlight },
         mSimultaneousFramesInFlight{ simultaneousFramesInFlight },
-        mUploadPools{ mMinimumSlotSize, mOnGrowSlotCount },
-        mReadbackPools{ mMinimumSlotSize, mOnGrowSlotCount },
-        mDefaultUniversalOrBufferPools{ mMinimumSlotSize, mOnGrowSlotCount },
-        mDefaultRTDSPools{ mMinimumSlotSize, mOnGrowSlotCount },
-        mDefaultNonRTDSPools{ mMinimumSlotSize, mOnGrowSlotCount }
+        mUploadPools{ mMinimumSlotSize, mOnGrowSlotCount, mMaximumPoolGrowSize },
+        mReadbackPools{ mMinimumSlotSize, mOnGrowSlotCount, mMaximumPoolGrowSize }
     {
-        mMinimumSlotSize = device->MinimumHeapSize() / mOnGrowSlotCount;
+        mMinimumSlotSize = device->MinimumHeapSize();
         mPendingDeallocations.resize(simultaneousFramesInFlight);
 
         mRingFrameTracker.SetDeallocationCallback([this](const Ring::FrameTailAttributes& frameAttributes)
@@ -23,17 +29,35 @@ namespace Memory
         });
     }
 
+    SegregatedPoolsResourceAllocator::~SegregatedPoolsResourceAllocator()
+    {
+        for (auto frameIndex = 0u; frameIndex < mPendingDeallocations.size(); ++frameIndex)
+        {
+            ExecutePendingDeallocations(frameIndex);
+        }
+
+        for (RecycledTexture& recycledTexture : mRecycledTextures)
+        {
+            delete recycledTexture.Texture;
+        }
+    }
+
     SegregatedPoolsResourceAllocator::BufferPtr SegregatedPoolsResourceAllocator::AllocateBuffer(const HAL::BufferProperties& properties, std::optional<HAL::CPUAccessibleHeapType> heapType)
     {
+        auto allocationStart = std::chrono::steady_clock::now();
+
         HAL::ResourceFormat format{ mDevice, properties };
-        Allocation allocation = FindOrAllocateMostFittingFreeSlot(format.ResourceSizeInBytes(), format, heapType);
-        PoolsAllocation& poolAllocation = allocation.PoolAllocation;
 
-        auto offsetInHeap = AdjustMemoryOffsetToPointInsideHeap(allocation);
+        ++mStatistics.AllocationCount;
 
         // If CPU accessible buffer is requested
         if (heapType)
         {
+            Allocation allocation = FindOrAllocateMostFittingFreeSlot(format.ResourceSizeInBytes(), format, heapType);
+            PoolsAllocation& poolAllocation = allocation.PoolAllocation;
+
+            auto offsetInHeap = AdjustMemoryOffsetToPointInsideHeap(allocation);
+
             // We can search for existing one
             if (!poolAllocation.Slot.UserData.Buffer)
             {
@@ -50,39 +74,85 @@ namespace Memory
                 mPendingDeallocations[mCurrentFrameIndex].emplace_back(Deallocation{ buffer, poolAllocation, poolsThatProducedAllocation, true });
             };
 
+            mStatistics.AllocationSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - allocationStart).count();
+
             // Create unique_ptr with already existing buffer ptr that's being reused
             return BufferPtr{ poolAllocation.Slot.UserData.Buffer, deallocationCallback };
         }
         else
         {
-            auto deallocationCallback = [this, poolAllocation, poolsThatProducedAllocation = allocation.PoolsPtr](HAL::Buffer* buffer)
-            {
-                mPendingDeallocations[mCurrentFrameIndex].emplace_back(Deallocation{ buffer, poolAllocation, poolsThatProducedAllocation, false });
-            };
+            // Buffers in default memory are packed into shared heap pages at placement alignment.
+            // The design decision is to recreate buffers in default memory due to different state requirements unlike upload/readback 
+            BufferPtr buffer = CreatePlacedBuffer(properties, *AllocateFromHeapPages(format));
 
-            HAL::Buffer* buffer = new HAL::Buffer{ *mDevice, properties, *allocation.HeapPtr, offsetInHeap };
+            mStatistics.AllocationSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - allocationStart).count();
 
-            // The design decision is to recreate buffers in default memory due to different state requirements unlike upload/readback 
-            return BufferPtr{ buffer, deallocationCallback };
+            return buffer;
         }
     }
 
-    SegregatedPoolsResourceAllocator::TexturePtr SegregatedPoolsResourceAllocator::AllocateTexture(const HAL::TextureProperties& properties)
+    SegregatedPoolsResourceAllocator::TexturePtr SegregatedPoolsResourceAllocator::AllocateTexture(
+        const HAL::TextureProperties& properties, ResourceStateTracker::SubresourceStateList* recycledTextureStates)
     {
+        auto allocationStart = std::chrono::steady_clock::now();
+
         HAL::ResourceFormat format{ mDevice, properties };
-        Allocation allocation = FindOrAllocateMostFittingFreeSlot(format.ResourceSizeInBytes(), format, std::nullopt);
-        PoolsAllocation& poolAllocation = allocation.PoolAllocation;
+        uint64_t descriptionHash = TextureDescriptionHash(format, properties);
 
-        auto offsetInHeap = AdjustMemoryOffsetToPointInsideHeap(allocation);
+        ++mStatistics.AllocationCount;
 
-        auto deallocationCallback = [this, poolAllocation, poolsThatProducedAllocation = allocation.PoolsPtr](HAL::Texture* texture)
+        // Recycled textures can only be handed out to callers that continue tracking from recycled states
+        if (recycledTextureStates)
         {
-            mPendingDeallocations[mCurrentFrameIndex].emplace_back(Deallocation{ texture, poolAllocation, poolsThatProducedAllocation, false });
-        };
+            auto recycledTextureIt = std::find_if(mRecycledTextures.rbegin(), mRecycledTextures.rend(), [descriptionHash](const RecycledTexture& recycledTexture)
+            {
+                return recycledTexture.DescriptionHash == descriptionHash;
+            });
+
+            if (recycledTextureIt != mRecycledTextures.rend())
+            {
+                RecycledTexture recycledTexture = std::move(*recycledTextureIt);
+                mRecycledTextures.erase(std::next(recycledTextureIt).base());
 
-        HAL::Texture* texture = new HAL::Texture{ *mDevice, *allocation.HeapPtr, offsetInHeap, properties };
+                *recycledTextureStates = std::move(recycledTexture.States);
+                ++mStatistics.TextureRecycleHitCount;
+                mStatistics.AllocationSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - allocationStart).count();
 
-        return TexturePtr{ texture, deallocationCallback };
+                return WrapPlacedTexture(recycledTexture.Texture, descriptionHash, recycledTexture.Allocation);
+            }
+        }
+
+        PageAllocation pageAllocation = *AllocateFromHeapPages(format);
+        HAL::Texture* texture = new HAL::Texture{ *mDevice, pageAllocation.Page->UserData, pageAllocation.Offset, properties };
+
+        mStatistics.AllocationSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - allocationStart).count();
+
+        return WrapPlacedTexture(texture, descriptionHash, pageAllocation);
+    }
+
+    SegregatedPoolsResourceAllocator::BufferPtr SegregatedPoolsResourceAllocator::AllocateRelocationTarget(const HAL::BufferProperties& properties)
+    {
+        HAL::ResourceFormat format{ mDevice, properties };
+        std::optional<PageAllocation> pageAllocation = AllocateFromHeapPages(format, false);
+
+        return pageAllocation ? CreatePlacedBuffer(properties, *pageAllocation) : nullptr;
+    }
+
+    SegregatedPoolsResourceAllocator::TexturePtr SegregatedPoolsResourceAllocator::AllocateRelocationTarget(const HAL::TextureProperties& properties)
+    {
+        HAL::ResourceFormat format{ mDevice, properties };
+        std::optional<PageAllocation> pageAllocation = AllocateFromHeapPages(format, false);
+
+        if (!pageAllocation)
+            return nullptr;
+
+        HAL::Texture* texture = new HAL::Texture{ *mDevice, pageAllocation->Page->UserData, pageAllocation->Offset, properties };
+        return WrapPlacedTexture(texture, TextureDescriptionHash(format, properties), *pageAllocation);
+    }
+
+    void SegregatedPoolsResourceAllocator::RecordTextureFinalStates(const HAL::Texture* texture, const ResourceStateTracker::SubresourceStateList& states)
+    {
+        mTextureFinalStates[texture] = states;
     }
 
     void SegregatedPoolsResourceAllocator::BeginFrame(uint64_t frameNumber)
@@ -94,52 +164,67 @@ namespace Memory
     void SegregatedPoolsResourceAllocator::EndFrame(uint64_t frameNumber)
     {
         mRingFrameTracker.ReleaseCompletedFrames(frameNumber);
+        TrimIdleMemory();
     }
 
-    SegregatedPoolsResourceAllocator::Allocation SegregatedPoolsResourceAllocator::FindOrAllocateMostFittingFreeSlot(
-        uint64_t allocationSizeInBytes, const HAL::ResourceFormat& resourceFormat, std::optional<HAL::CPUAccessibleHeapType> cpuHeapType)
+    SegregatedPoolsResourceAllocator::Statistics SegregatedPoolsResourceAllocator::GetStatistics() const
     {
-        assert_format(allocationSizeInBytes > 0, "0 bytes allocations are forbidden");
-        assert_format(allocationSizeInBytes < std::numeric_limits<uint32_t>::max(), "Ridiculous allocation size");
-
-        Pools* pools = nullptr;
-        std::vector<HeapList>* heapLists = nullptr;
+        Statistics statistics = mStatistics;
 
-        if (cpuHeapType)
+        for (const HeapPages* pages : { &mDefaultUniversalOrBufferHeapPages, &mDefaultRTDSHeapPages, &mDefaultNonRTDSHeapPages })
         {
-            switch (*cpuHeapType)
+            for (const std::unique_ptr<HeapPage>& page : pages->Pages())
             {
-            case HAL::CPUAccessibleHeapType::Upload:
-                pools = &mUploadPools;
-                heapLists = &mUploadHeapLists;
-                break;
-
-            case HAL::CPUAccessibleHeapType::Readback:
-                pools = &mReadbackPools;
-                heapLists = &mReadbackHeapLists;
-                break;
+                ++statistics.HeapCount;
+                statistics.CommittedHeapBytes += page->UserData.AlighnedSize();
+                statistics.PageCapacityBytes += page->Ranges.Capacity();
+                statistics.PageAllocatedBytes += page->Ranges.AllocatedSize();
             }
         }
-        else
+
+        for (const std::vector<HeapList>* heapLists : { &mUploadHeapLists, &mReadbackHeapLists })
         {
-            switch (resourceFormat.ResourceAliasingGroup())
+            for (const HeapList& heapList : *heapLists)
             {
-            case HAL::HeapAliasingGroup::Universal:
-            case HAL::HeapAliasingGroup::Buffers:
-                pools = &mDefaultUniversalOrBufferPools;
-                heapLists = &mDefaultUniversalOrBufferHeapLists;
-                break;
+                for (const HAL::Heap& heap : heapList)
+                {
+                    ++statistics.HeapCount;
+                    statistics.CommittedHeapBytes += heap.AlighnedSize();
+                }
+            }
+        }
 
-            case HAL::HeapAliasingGroup::RTDSTextures:
-                pools = &mDefaultRTDSPools;
-                heapLists = &mDefaultRTDSHeapLists;
-                break;
+        for (const RecycledTexture& recycledTexture : mRecycledTextures)
+        {
+            ++statistics.RecycledTextureCount;
+            statistics.RecycledTextureBytes += recycledTexture.Allocation.Size;
+        }
 
-            case HAL::HeapAliasingGroup::NonRTDSTextures:
-                pools = &mDefaultNonRTDSPools;
-                heapLists = &mDefaultNonRTDSHeapLists;
-                break;
-            }
+        return statistics;
+    }
+
+    SegregatedPoolsResourceAllocator::Allocation SegregatedPoolsResourceAllocator::FindOrAllocateMostFittingFreeSlot(
+        uint64_t allocationSizeInBytes, const HAL::ResourceFormat& resourceFormat, std::optional<HAL::CPUAccessibleHeapType> cpuHeapType)
+    {
+        assert_format(allocationSizeInBytes > 0, "0 bytes allocations are forbidden");
+        assert_format(allocationSizeInBytes < std::numeric_limits<uint32_t>::max(), "Ridiculous allocation size");
+
+        assert_format(cpuHeapType, "Default memory resources are allocated from heap pages");
+
+        Pools* pools = nullptr;
+        std::vector<HeapList>* heapLists = nullptr;
+
+        switch (*cpuHeapType)
+        {
+        case HAL::CPUAccessibleHeapType::Upload:
+            pools = &mUploadPools;
+            heapLists = &mUploadHeapLists;
+            break;
+
+        case HAL::CPUAccessibleHeapType::Readback:
+            pools = &mReadbackPools;
+            heapLists = &mReadbackHeapLists;
+            break;
         }
 
         PoolsAllocation allocation = pools->Allocate(allocationSizeInBytes);
@@ -158,7 +243,7 @@ namespace Memory
         HeapList& heapsList = heapLists->at(*heapListIndex);
         std::optional<uint64_t> heapIndex = allocation.Slot.UserData.HeapIndex;
 
-        auto totalHeapsSize = heapsList.size() * mOnGrowSlotCount * bucket.SlotSize();
+        auto totalHeapsSize = heapsList.size() * bucket.GrowSlotCount() * bucket.SlotSize();
 
         bool outOfAllocatedMemory = allocation.Slot.MemoryOffset >= totalHeapsSize;
         bool existingHeapIndexPresent = heapIndex != std::nullopt;
@@ -169,8 +254,9 @@ namespace Memory
         // Out of memory means we need to add another heap
         if (outOfAllocatedMemory)
         {
-            auto newHeapSize = mOnGrowSlotCount * bucket.SlotSize();
+            auto newHeapSize = bucket.GrowSlotCount() * bucket.SlotSize();
             heapsList.emplace_back(*mDevice, newHeapSize, resourceFormat.ResourceAliasingGroup(), cpuHeapType);
+            ++mStatistics.HeapCreationCount;
         }
 
         // Heap definitely exists at this point but its index is not recorded in the slot,
@@ -185,9 +271,10 @@ namespace Memory
 
     uint64_t SegregatedPoolsResourceAllocator::AdjustMemoryOffsetToPointInsideHeap(const SegregatedPoolsResourceAllocator::Allocation& allocation)
     {
-        // One heap is created per OnGrowSlotCount slots in a bucket.
+        // One heap is created per bucket grow slot count slots.
         // So we can calculate an offset local to a particular heap.
-        uint64_t bytesPerHeap = mOnGrowSlotCount * allocation.PoolsPtr->SlotSizeInBucket(allocation.PoolAllocation.BucketIndex);
+        const Pools::Bucket& bucket = allocation.PoolsPtr->GetBucket(allocation.PoolAllocation.BucketIndex);
+        uint64_t bytesPerHeap = bucket.GrowSlotCount() * bucket.SlotSize();
         uint64_t allocationHeapIndex = allocation.PoolAllocation.Slot.MemoryOffset / bytesPerHeap;
         uint64_t localOffset = allocation.PoolAllocation.Slot.MemoryOffset - allocationHeapIndex * bytesPerHeap;
 
@@ -198,6 +285,22 @@ namespace Memory
     {
         for (Deallocation& deallocation : mPendingDeallocations[frameIndex])
         {
+            // Texture memory stays occupied until recycled texture is reused or trimmed.
+            // Evacuating pages are emptied instead.
+            if (deallocation.TextureToRecycle && !deallocation.HeapPageAllocation.Page->IsEvacuating)
+            {
+                deallocation.Resource->SetDebugName("Resource Allocator Recycled Texture");
+                mRecycledTextures.emplace_back(std::move(*deallocation.TextureToRecycle));
+                continue;
+            }
+
+            if (deallocation.HeapPageAllocation.Page)
+            {
+                delete deallocation.Resource;
+                DeallocateFromHeapPage(deallocation.HeapPageAllocation);
+                continue;
+            }
+
             if (!deallocation.ResourceWillBeReused)
             {
                 delete deallocation.Resource;
@@ -212,4 +315,385 @@ namespace Memory
         mPendingDeallocations[frameIndex].clear();
     }
 
+    std::optional<SegregatedPoolsResourceAllocator::PageAllocation> SegregatedPoolsResourceAllocator::AllocateFromHeapPages(const HAL::ResourceFormat& resourceFormat, bool canCreatePage)
+    {
+        HeapPages& pages = GetHeapPagesForAliasingGroup(resourceFormat.ResourceAliasingGroup());
+        uint64_t size = resourceFormat.ResourceSizeInBytes();
+        uint64_t alignment = resourceFormat.ResourceAlighnment();
+
+        if (std::optional<PageAllocation> allocation = pages.Allocate(size, alignment))
+            return allocation;
+
+        if (!canCreatePage)
+            return std::nullopt;
+
+        HAL::Heap heap{ *mDevice, pages.NewPageSize(size, alignment), resourceFormat.ResourceAliasingGroup() };
+        uint64_t heapSize = heap.AlighnedSize();
+        HeapPage& page = pages.AddPage(heapSize, std::move(heap));
+        ++mStatistics.HeapCreationCount;
+
+        std::optional<uint64_t> offset = page.Ranges.Allocate(size, alignment);
+        assert_format(offset, "Implementation error. Resource doesn't fit a new heap page.");
+
+        return PageAllocation{ &page, *offset, size };
+    }
+
+    void SegregatedPoolsResourceAllocator::DeallocateFromHeapPage(const PageAllocation& allocation)
+    {
+        allocation.Page->Ranges.Deallocate(allocation.Offset, allocation.Size);
+    }
+
+    SegregatedPoolsResourceAllocator::BufferPtr SegregatedPoolsResourceAllocator::CreatePlacedBuffer(const HAL::BufferProperties& properties, const PageAllocation& pageAllocation)
+    {
+        HAL::Buffer* buffer = new HAL::Buffer{ *mDevice, properties, pageAllocation.Page->UserData, pageAllocation.Offset };
+        mResourcePlacements[buffer] = pageAllocation;
+
+        auto deallocationCallback = [this, pageAllocation](HAL::Buffer* buffer)
+        {
+            mResourcePlacements.erase(buffer);
+
+            Deallocation deallocation{};
+            deallocation.Resource = buffer;
+            deallocation.HeapPageAllocation = pageAllocation;
+            mPendingDeallocations[mCurrentFrameIndex].emplace_back(std::move(deallocation));
+        };
+
+        return BufferPtr{ buffer, deallocationCallback };
+    }
+
+    SegregatedPoolsResourceAllocator::TexturePtr SegregatedPoolsResourceAllocator::WrapPlacedTexture(HAL::Texture* texture, uint64_t descriptionHash, const PageAllocation& pageAllocation)
+    {
+        mResourcePlacements[texture] = pageAllocation;
+
+        auto deallocationCallback = [this, descriptionHash, pageAllocation](HAL::Texture* texture)
+        {
+            mResourcePlacements.erase(texture);
+
+            Deallocation deallocation{};
+            deallocation.Resource = texture;
+            deallocation.HeapPageAllocation = pageAllocation;
+
+            auto finalStatesIt = mTextureFinalStates.find(texture);
+
+            if (finalStatesIt != mTextureFinalStates.end())
+            {
+                deallocation.TextureToRecycle = RecycledTexture{ texture, pageAllocation, descriptionHash, std::move(finalStatesIt->second) };
+                mTextureFinalStates.erase(finalStatesIt);
+            }
+
+            mPendingDeallocations[mCurrentFrameIndex].emplace_back(std::move(deallocation));
+        };
+
+        return TexturePtr{ texture, deallocationCallback };
+    }
+
+    SegregatedPoolsResourceAllocator::HeapPages& SegregatedPoolsResourceAllocator::GetHeapPagesForAliasingGroup(HAL::HeapAliasingGroup group)
+    {
+        switch (group)
+        {
+        case HAL::HeapAliasingGroup::RTDSTextures: return mDefaultRTDSHeapPages;
+        case HAL::HeapAliasingGroup::NonRTDSTextures: return mDefaultNonRTDSHeapPages;
+        default: return mDefaultUniversalOrBufferHeapPages;
+        }
+    }
+
+    uint64_t SegregatedPoolsResourceAllocator::TextureDescriptionHash(const HAL::ResourceFormat& resourceFormat, const HAL::TextureProperties& properties) const
+    {
+        const D3D12_RESOURCE_DESC& description = resourceFormat.D3DResourceDescription();
+
+        uint64_t hash = robin_hood::hash_int(description.Width);
+        hash = robin_hood::hash_int(hash ^ (uint64_t(description.Height) << 32 | uint64_t(description.DepthOrArraySize) << 16 | description.MipLevels));
+        hash = robin_hood::hash_int(hash ^ (uint64_t(description.Format) << 32 | uint64_t(description.Flags)));
+        hash = robin_hood::hash_int(hash ^ (uint64_t(description.Dimension) << 32 | uint64_t(properties.InitialStateMask)));
+        hash = robin_hood::hash_int(hash ^ uint64_t(properties.ExpectedStateMask));
+
+        // Optimized clear value is a part of resource creation
+        std::visit(Foundation::MakeVisitor(
+            [&hash](const HAL::ColorClearValue& color)
+            {
+                hash = robin_hood::hash_int(hash ^ robin_hood::hash_bytes(&color, sizeof(color)));
+            },
+            [&hash](const HAL::DepthStencilClearValue& depthStencil)
+            {
+                hash = robin_hood::hash_int(hash ^ robin_hood::hash_bytes(&depthStencil.Depth, sizeof(depthStencil.Depth)) ^ depthStencil.Stencil);
+            }),
+            properties.OptimizedClearValue);
+
+        return hash;
+    }
+
+    SegregatedPoolsResourceAllocator::FragmentationMetrics SegregatedPoolsResourceAllocator::GetFragmentationMetrics(float sparsePageUtilization) const
+    {
+        FragmentationMetrics metrics{};
+
+        for (const HeapPages* pages : { &mDefaultUniversalOrBufferHeapPages, &mDefaultRTDSHeapPages, &mDefaultNonRTDSHeapPages })
+        {
+            pages->AccumulateFragmentationMetrics(sparsePageUtilization, metrics);
+        }
+
+        return metrics;
+    }
+
+    bool SegregatedPoolsResourceAllocator::BeginHeapPageEvacuation(float sparsePageUtilization)
+    {
+        HeapPage* pageToEvacuate = nullptr;
+        double lowestUtilization = sparsePageUtilization;
+
+        // Empty pages are left to idle memory trimming
+        for (const HeapPages* pages : { &mDefaultUniversalOrBufferHeapPages, &mDefaultRTDSHeapPages, &mDefaultNonRTDSHeapPages })
+        {
+            if (HeapPage* candidate = pages->FindEvacuationCandidate(lowestUtilization))
+            {
+                pageToEvacuate = candidate;
+                lowestUtilization = candidate->Utilization();
+            }
+        }
+
+        if (!pageToEvacuate)
+            return false;
+
+        pageToEvacuate->IsEvacuating = true;
+
+        // Recycled textures are idle and don't need to be moved
+        auto evictedIt = std::stable_partition(mRecycledTextures.begin(), mRecycledTextures.end(), [pageToEvacuate](const RecycledTexture& recycledTexture)
+        {
+            return recycledTexture.Allocation.Page != pageToEvacuate;
+        });
+
+        for (auto it = evictedIt; it != mRecycledTextures.end(); ++it)
+        {
+            delete it->Texture;
+            DeallocateFromHeapPage(it->Allocation);
+        }
+
+        mRecycledTextures.erase(evictedIt, mRecycledTextures.end());
+
+        return true;
+    }
+
+    void SegregatedPoolsResourceAllocator::AbandonHeapPageEvacuations()
+    {
+        for (HeapPages* pages : { &mDefaultUniversalOrBufferHeapPages, &mDefaultRTDSHeapPages, &mDefaultNonRTDSHeapPages })
+        {
+            pages->AbandonEvacuations();
+        }
+    }
+
+    bool SegregatedPoolsResourceAllocator::IsHeapPageEvacuationInProgress() const
+    {
+        for (const HeapPages* pages : { &mDefaultUniversalOrBufferHeapPages, &mDefaultRTDSHeapPages, &mDefaultNonRTDSHeapPages })
+        {
+            if (pages->IsEvacuationInProgress()) return true;
+        }
+
+        return false;
+    }
+
+    bool SegregatedPoolsResourceAllocator::IsPlacedInEvacuatingHeapPage(const HAL::Resource* resource) const
+    {
+        auto placementIt = mResourcePlacements.find(resource);
+        return placementIt != mResourcePlacements.end() && placementIt->second.Page->IsEvacuating;
+    }
+
+    void SegregatedPoolsResourceAllocator::TrimIdleMemory()
+    {
+        HeapPages* pageSets[] = { &mDefaultUniversalOrBufferHeapPages, &mDefaultRTDSHeapPages, &mDefaultNonRTDSHeapPages };
+
+        // Evacuated pages are released regardless of the budget
+        for (HeapPages* pages : pageSets)
+        {
+            mStatistics.EvacuatedHeapReleaseCount += pages->ReleaseEvacuatedPages();
+        }
+
+        uint64_t recycledTextureBytes = 0;
+        uint64_t emptyPageBytes = 0;
+
+        for (const RecycledTexture& recycledTexture : mRecycledTextures)
+        {
+            recycledTextureBytes += recycledTexture.Allocation.Size;
+        }
+
+        for (HeapPages* pages : pageSets)
+        {
+            for (const std::unique_ptr<HeapPage>& page : pages->Pages())
+            {
+                if (page->Ranges.IsEmpty()) emptyPageBytes += page->Ranges.Capacity();
+            }
+        }
+
+        // Least recently released textures are the least likely to be requested again
+        uint64_t evictedTextureCount = 0;
+
+        while (recycledTextureBytes + emptyPageBytes > mIdleMemoryBudget && evictedTextureCount < mRecycledTextures.size())
+        {
+            RecycledTexture& recycledTexture = mRecycledTextures[evictedTextureCount++];
+            HeapPage* page = recycledTexture.Allocation.Page;
+
+            delete recycledTexture.Texture;
+            DeallocateFromHeapPage(recycledTexture.Allocation);
+            recycledTextureBytes -= recycledTexture.Allocation.Size;
+
+            if (page->Ranges.IsEmpty()) emptyPageBytes += page->Ranges.Capacity();
+        }
+
+        mRecycledTextures.erase(mRecycledTextures.begin(), mRecycledTextures.begin() + evictedTextureCount);
+
+        // Then give empty pages back to the OS
+        for (HeapPages* pages : pageSets)
+        {
+            HeapPages::PageList& pageList = pages->Pages();
+            auto pageIt = pageList.begin();
+
+            while (pageIt != pageList.end() && recycledTextureBytes + emptyPageBytes > mIdleMemoryBudget)
+            {
+                if ((*pageIt)->Ranges.IsEmpty())
+                {
+                    emptyPageBytes -= (*pageIt)->Ranges.Capacity();
+                    pageIt = pageList.erase(pageIt);
+                }
+                else
+                {
+                    ++pageIt;
+                }
+            }
+        }
+    }
+
+    bool SegregatedPoolsResourceAllocator::RunBenchmark(const HAL::Device* device, const std::filesystem::path& reportPath)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        struct LiveResource
+        {
+            BufferPtr Buffer;
+            TexturePtr Texture;
+            uint64_t ReleaseFrame = 0;
+        };
+
+        std::ofstream stream{ reportPath, std::ios::out | std::ios::trunc };
+
+        if (!stream.is_open())
+        {
+            return false;
+        }
+
+        const uint8_t FramesInFlight = 2;
+        const uint64_t FrameCount = 120;
+        const uint64_t BuffersPerFrame = 48;
+        const uint64_t TexturesPerFrame = 8;
+
+        // Textures come from a small set of descriptions, like render targets and streamed textures of a scene do
+        std::vector<HAL::TextureProperties> textureDescriptions;
+        textureDescriptions.emplace_back(HAL::ColorFormat::RGBA8_Unsigned_Norm, HAL::TextureKind::Texture2D, Geometry::Dimensions{ 1024, 1024 }, HAL::ResourceState::AnyShaderAccess);
+        textureDescriptions.emplace_back(HAL::ColorFormat::RGBA8_Unsigned_Norm, HAL::TextureKind::Texture2D, Geometry::Dimensions{ 512, 512 }, HAL::ResourceState::AnyShaderAccess);
+        textureDescriptions.emplace_back(HAL::ColorFormat::RGBA16_Float, HAL::TextureKind::Texture2D, Geometry::Dimensions{ 1920, 1080 },
+            HAL::ResourceState::RenderTarget, HAL::ResourceState::RenderTarget | HAL::ResourceState::PixelShaderAccess);
+        textureDescriptions.emplace_back(HAL::ColorFormat::R16_Float, HAL::TextureKind::Texture2D, Geometry::Dimensions{ 960, 540 },
+            HAL::ResourceState::UnorderedAccess, HAL::ResourceState::UnorderedAccess | HAL::ResourceState::AnyShaderAccess);
+
+        std::vector<std::string> modes = { "committed", "heapPages" };
+
+        stream.precision(6);
+        stream << "{\"units\":\"microseconds\",\"results\":[\n";
+
+        bool isFirstResult = true;
+
+        for (const std::string& mode : modes)
+        {
+            bool isCommitted = mode == "committed";
+
+            // Both modes replay the same allocation sequence
+            std::mt19937 randomEngine{ 42 };
+            std::uniform_int_distribution<uint64_t> bufferSizeDistribution{ 256, 1024 * 1024 };
+            std::uniform_int_distribution<uint64_t> lifetimeDistribution{ 1, 16 };
+            std::uniform_int_distribution<uint64_t> textureDistribution{ 0, textureDescriptions.size() - 1 };
+
+            SegregatedPoolsResourceAllocator allocator{ device, FramesInFlight };
+            std::vector<LiveResource> liveResources;
+
+            uint64_t allocationCount = 0;
+            double allocationTime = 0.0;
+            double worstFrameAllocationTime = 0.0;
+
+            for (uint64_t frameNumber = 1; frameNumber <= FrameCount; ++frameNumber)
+            {
+                allocator.BeginFrame(frameNumber);
+
+                // Recorded states make released textures eligible for recycling, as Memory::Texture does
+                auto released = std::remove_if(liveResources.begin(), liveResources.end(), [frameNumber](const LiveResource& resource) { return resource.ReleaseFrame <= frameNumber; });
+
+                for (auto it = released; it != liveResources.end(); ++it)
+                {
+                    if (it->Texture) allocator.RecordTextureFinalStates(it->Texture.get(), {});
+                }
+
+                liveResources.erase(released, liveResources.end());
+
+                double frameAllocationTime = 0.0;
+
+                for (uint64_t bufferIdx = 0; bufferIdx < BuffersPerFrame; ++bufferIdx)
+                {
+                    auto properties = HAL::BufferProperties::Create<uint8_t>(bufferSizeDistribution(randomEngine));
+                    uint64_t releaseFrame = frameNumber + lifetimeDistribution(randomEngine);
+                    auto allocationStart = Clock::now();
+
+                    BufferPtr buffer = isCommitted ?
+                        BufferPtr{ new HAL::Buffer{ *device, properties }, [](HAL::Buffer* buffer) { delete buffer; } } :
+                        allocator.AllocateBuffer(properties);
+
+                    frameAllocationTime += std::chrono::duration<double, std::micro>(Clock::now() - allocationStart).count();
+                    liveResources.push_back({ std::move(buffer), nullptr, releaseFrame });
+                }
+
+                for (uint64_t textureIdx = 0; textureIdx < TexturesPerFrame; ++textureIdx)
+                {
+                    const HAL::TextureProperties& properties = textureDescriptions[textureDistribution(randomEngine)];
+                    uint64_t releaseFrame = frameNumber + lifetimeDistribution(randomEngine);
+                    ResourceStateTracker::SubresourceStateList recycledStates;
+                    auto allocationStart = Clock::now();
+
+                    TexturePtr texture = isCommitted ?
+                        TexturePtr{ new HAL::Texture{ *device, properties }, [](HAL::Texture* texture) { delete texture; } } :
+                        allocator.AllocateTexture(properties, &recycledStates);
+
+                    frameAllocationTime += std::chrono::duration<double, std::micro>(Clock::now() - allocationStart).count();
+                    liveResources.push_back({ nullptr, std::move(texture), releaseFrame });
+                }
+
+                allocationCount += BuffersPerFrame + TexturesPerFrame;
+                allocationTime += frameAllocationTime;
+                worstFrameAllocationTime = std::max(worstFrameAllocationTime, frameAllocationTime);
+
+                // GPU is simulated to lag one frame behind
+                allocator.EndFrame(frameNumber - 1);
+            }
+
+            Statistics statistics = allocator.GetStatistics();
+
+            // Committed resources get an implicit heap each
+            uint64_t heapCreations = isCommitted ? allocationCount : statistics.HeapCreationCount;
+            double utilization = statistics.PageCapacityBytes > 0 ? double(statistics.PageAllocatedBytes) / statistics.PageCapacityBytes : 1.0;
+
+            stream << (isFirstResult ? "" : ",\n") << "{\"mode\":\"" << mode << "\""
+                << ",\"allocations\":" << allocationCount
+                << ",\"heapCreations\":" << heapCreations
+                << ",\"heapCount\":" << statistics.HeapCount
+                << ",\"committedHeapMegabytes\":" << statistics.CommittedHeapBytes / (1024.0 * 1024.0)
+                << ",\"heapUtilization\":" << utilization
+                << ",\"recycledTextureHits\":" << statistics.TextureRecycleHitCount
+                << ",\"meanAllocationTime\":" << allocationTime / std::max<uint64_t>(allocationCount, 1)
+                << ",\"worstFrameAllocationTime\":" << worstFrameAllocationTime << "}";
+
+            isFirstResult = false;
+
+            // Let every released resource go before heap pages they were placed in
+            liveResources.clear();
+            allocator.EndFrame(FrameCount);
+        }
+
+        stream << "]}\n";
+
+        return true;
+    }
+
 }
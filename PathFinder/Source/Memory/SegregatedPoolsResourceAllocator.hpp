@@ -1,7 +1,9 @@
 #pragma once
 
 #include "SegregatedPools.hpp"
+#include "HeapPageSet.hpp"
 #include "Ring.hpp"
+#include "ResourceStateTracker.hpp"
 
 #include <HardwareAbstractionLayer/Device.hpp>
 #include <HardwareAbstractionLayer/Heap.hpp>
@@ -10,24 +12,75 @@
 
 #include <memory>
 #include <vector>
+#include <unordered_map>
+#include <filesystem>
 
 namespace Memory
 {
 
+    /// Upload and readback buffers are kept in segregated pools of reusable slots.
+    /// Default memory resources are placed into large heap pages and packed with respect to their alignment.
+    /// Released textures are recycled by description, as long as their final states are known.
     class SegregatedPoolsResourceAllocator
     {
     public:
         using BufferPtr = std::unique_ptr<HAL::Buffer, std::function<void(HAL::Buffer*)>>;
         using TexturePtr = std::unique_ptr<HAL::Texture, std::function<void(HAL::Texture*)>>;
 
+        struct Statistics
+        {
+            uint64_t HeapCount = 0;
+            uint64_t HeapCreationCount = 0;
+            uint64_t CommittedHeapBytes = 0;
+
+            // Heap page memory occupied by resources, including recycled textures
+            uint64_t PageCapacityBytes = 0;
+            uint64_t PageAllocatedBytes = 0;
+
+            uint64_t RecycledTextureCount = 0;
+            uint64_t RecycledTextureBytes = 0;
+            uint64_t TextureRecycleHitCount = 0;
+
+            uint64_t AllocationCount = 0;
+            double AllocationSeconds = 0.0;
+
+            uint64_t EvacuatedHeapReleaseCount = 0;
+        };
+
+        using FragmentationMetrics = HeapPageFragmentationMetrics;
+
         SegregatedPoolsResourceAllocator(const HAL::Device* device, uint8_t simultaneousFramesInFlight);
+        ~SegregatedPoolsResourceAllocator();
 
         BufferPtr AllocateBuffer(const HAL::BufferProperties& properties, std::optional<HAL::CPUAccessibleHeapType> heapType = std::nullopt);
-        TexturePtr AllocateTexture(const HAL::TextureProperties& properties);
+
+        // Fills recycled texture states when a recycled texture is returned, so that state tracking continues where it stopped
+        TexturePtr AllocateTexture(const HAL::TextureProperties& properties, ResourceStateTracker::SubresourceStateList* recycledTextureStates = nullptr);
+
+        // Textures are recycled only if their states at release are recorded
+        void RecordTextureFinalStates(const HAL::Texture* texture, const ResourceStateTracker::SubresourceStateList& states);
 
         void BeginFrame(uint64_t frameNumber);
         void EndFrame(uint64_t frameNumber);
 
+        Statistics GetStatistics() const;
+        FragmentationMetrics GetFragmentationMetrics(float sparsePageUtilization) const;
+
+        // Marks the sparsest heap page, whose resources fit into free memory of other pages of its aliasing group, as evacuating.
+        // Evacuating pages receive no new allocations and are released as soon as they're emptied.
+        bool BeginHeapPageEvacuation(float sparsePageUtilization);
+        void AbandonHeapPageEvacuations();
+        bool IsHeapPageEvacuationInProgress() const;
+        bool IsPlacedInEvacuatingHeapPage(const HAL::Resource* resource) const;
+
+        // Allocate resources to move contents of evacuated ones to. 
+        // Nothing is returned if that would require a new heap page.
+        BufferPtr AllocateRelocationTarget(const HAL::BufferProperties& properties);
+        TexturePtr AllocateRelocationTarget(const HAL::TextureProperties& properties);
+
+        // Measures heap creations, allocation latency and utilization on a synthetic allocation pattern
+        static bool RunBenchmark(const HAL::Device* device, const std::filesystem::path& reportPath);
+
     private:
         using HeapList = std::vector<HAL::Heap>;
         using HeapIterator = HeapList::iterator;
@@ -60,12 +113,28 @@ namespace Memory
             HAL::Heap* HeapPtr;
         };
 
+        using HeapPages = HeapPageSet<HAL::Heap>;
+        using HeapPage = HeapPages::Page;
+        using PageAllocation = HeapPages::Allocation;
+
+        struct RecycledTexture
+        {
+            HAL::Texture* Texture = nullptr;
+            PageAllocation Allocation;
+            uint64_t DescriptionHash = 0;
+            ResourceStateTracker::SubresourceStateList States;
+        };
+
         struct Deallocation
         {
             HAL::Resource* Resource = nullptr;
             PoolsAllocation Allocation;
-            Pools* PoolsThatProducedAllocation;
+            Pools* PoolsThatProducedAllocation = nullptr;
             bool ResourceWillBeReused = false;
+
+            // Default memory resources are deallocated from heap pages instead of pools
+            PageAllocation HeapPageAllocation;
+            std::optional<RecycledTexture> TextureToRecycle;
         };
 
         Allocation FindOrAllocateMostFittingFreeSlot(
@@ -76,6 +145,14 @@ namespace Memory
         uint64_t AdjustMemoryOffsetToPointInsideHeap(const SegregatedPoolsResourceAllocator::Allocation& allocation);
         void ExecutePendingDeallocations(uint64_t frameIndex);
 
+        std::optional<PageAllocation> AllocateFromHeapPages(const HAL::ResourceFormat& resourceFormat, bool canCreatePage = true);
+        void DeallocateFromHeapPage(const PageAllocation& allocation);
+        BufferPtr CreatePlacedBuffer(const HAL::BufferProperties& properties, const PageAllocation& pageAllocation);
+        TexturePtr WrapPlacedTexture(HAL::Texture* texture, uint64_t descriptionHash, const PageAllocation& pageAllocation);
+        HeapPages& GetHeapPagesForAliasingGroup(HAL::HeapAliasingGroup group);
+        uint64_t TextureDescriptionHash(const HAL::ResourceFormat& resourceFormat, const HAL::TextureProperties& properties) const;
+        void TrimIdleMemory();
+
         const HAL::Device* mDevice = nullptr;
 
         Ring mRingFrameTracker;
@@ -86,8 +163,17 @@ namespace Memory
         // Minimum allocation size
         uint64_t mMinimumSlotSize = 65536;
 
-        // Amount of slots to allocate at once when out of allocated memory
-        uint32_t mOnGrowSlotCount = 1; 
+        // Amount of slots to allocate at once when out of allocated memory.
+        // Buckets of large slots grow by fewer slots so that upload and readback heaps don't exceed the maximum grow size.
+        uint32_t mOnGrowSlotCount = 16; 
+        uint64_t mMaximumPoolGrowSize = 64 * 1024 * 1024;
+
+        // Default memory heap pages grow with the amount of memory already used by an aliasing group
+        uint64_t mMinimumHeapPageSize = 64 * 1024 * 1024;
+        uint64_t mMaximumHeapPageSize = 256 * 1024 * 1024;
+
+        // Memory that recycled textures and empty heap pages are allowed to hold
+        uint64_t mIdleMemoryBudget = 256 * 1024 * 1024;
 
         // Buffer only upload heaps
         Pools mUploadPools;
@@ -97,20 +183,23 @@ namespace Memory
         Pools mReadbackPools;
         std::vector<HeapList> mReadbackHeapLists;
 
-        // Used for universal heaps when supported by hardware.
-        // Used only for default memory buffer heaps otherwise.
-        Pools mDefaultUniversalOrBufferPools;
-        std::vector<HeapList> mDefaultUniversalOrBufferHeapLists;
+        // Default memory heap pages. Universal heaps are used when supported by hardware,
+        // otherwise buffers, RT & DS textures and other textures are placed into separate heaps.
+        HeapPages mDefaultUniversalOrBufferHeapPages{ mMinimumHeapPageSize, mMaximumHeapPageSize };
+        HeapPages mDefaultRTDSHeapPages{ mMinimumHeapPageSize, mMaximumHeapPageSize };
+        HeapPages mDefaultNonRTDSHeapPages{ mMinimumHeapPageSize, mMaximumHeapPageSize };
 
-        // RT & DS texture only, default memory heaps. Unused when universal heaps are supported by HW.
-        Pools mDefaultRTDSPools;
-        std::vector<HeapList> mDefaultRTDSHeapLists;
+        // Ordered from the least to the most recently released.
+        // Lookup is linear, the list is bounded by idle memory budget.
+        std::vector<RecycledTexture> mRecycledTextures;
+        std::unordered_map<const HAL::Texture*, ResourceStateTracker::SubresourceStateList> mTextureFinalStates;
 
-        // Other texture type, default memory heaps. Unused when universal heaps are supported by HW.
-        Pools mDefaultNonRTDSPools;
-        std::vector<HeapList> mDefaultNonRTDSHeapLists;
+        // Placements of live default memory resources
+        std::unordered_map<const HAL::Resource*, PageAllocation> mResourcePlacements;
         
         std::vector<std::vector<Deallocation>> mPendingDeallocations;
+
+        Statistics mStatistics;
     };
 
 }
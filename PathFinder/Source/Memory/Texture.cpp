@@ -1,6 +1,8 @@
 #include "Texture.hpp"
 #include "CopyRequestManager.hpp"
 
+#include <algorithm>
+
 namespace Memory
 {
 
@@ -12,11 +14,24 @@ namespace Memory
         CopyRequestManager* copyRequestManager)
         :
         GPUResource(AccessStrategy::Automatic, stateTracker, resourceAllocator, descriptorAllocator, copyRequestManager),
-        mTexturePtr{ resourceAllocator->AllocateTexture(properties) },
         mProperties{ properties }
     {
-        if (mStateTracker) 
-            mStateTracker->StartTrakingResource(mTexturePtr.get());
+        // Textures are recycled by the allocator only when their states can be carried over
+        if (mStateTracker)
+        {
+            ResourceStateTracker::SubresourceStateList recycledTextureStates;
+            mTexturePtr = resourceAllocator->AllocateTexture(properties, &recycledTextureStates);
+            mIsRecyclable = true;
+
+            if (recycledTextureStates.empty())
+                mStateTracker->StartTrakingResource(mTexturePtr.get());
+            else
+                mStateTracker->StartTrakingResource(mTexturePtr.get(), recycledTextureStates);
+        }
+        else
+        {
+            mTexturePtr = resourceAllocator->AllocateTexture(properties);
+        }
 
         ReserveDiscriptorArrays(properties.MipCount);
     }
@@ -69,6 +84,12 @@ namespace Memory
 
     Texture::~Texture()
     {
+        if (IsRelocating())
+            CancelRelocation();
+
+        if (mIsRecyclable)
+            mResourceAllocator->RecordTextureFinalStates(mTexturePtr.get(), mStateTracker->ResourceCurrentStates(mTexturePtr.get()));
+
         if (mStateTracker) 
             mStateTracker->StopTrakingResource(mTexturePtr.get());
     }
@@ -127,6 +148,60 @@ namespace Memory
         return mTexturePtr.get();
     }
 
+    bool Texture::CanBeRelocated() const
+    {
+        // Only shader resource descriptors are expected for textures that GPU doesn't write to
+        bool hasWriteDescriptors = mDSDescriptor ||
+            std::any_of(mRTDescriptors.begin(), mRTDescriptors.end(), [](auto& descriptor) { return descriptor != nullptr; }) ||
+            std::any_of(mUADescriptors.begin(), mUADescriptors.end(), [](auto& descriptor) { return descriptor != nullptr; });
+
+        return mIsRecyclable && !hasWriteDescriptors && IsRelocationAllowed(mProperties.ExpectedStateMask);
+    }
+
+    bool Texture::BeginRelocation()
+    {
+        if (!CanBeRelocated())
+            return false;
+
+        mRelocationTarget = mResourceAllocator->AllocateRelocationTarget(mProperties);
+
+        if (!mRelocationTarget)
+            return false;
+
+        mRelocationTarget->SetDebugName(mDebugName);
+        mStateTracker->StartTrakingResource(mRelocationTarget.get());
+
+        mCopyRequestManager->RequestRelocation(mTexturePtr.get(), mRelocationTarget.get(), 
+            [source = mTexturePtr.get(), destination = mRelocationTarget.get()](HAL::CopyCommandListBase& cmdList)
+        {
+            cmdList.CopyResource(*source, *destination);
+        });
+
+        mRelocationFrameNumber = mFrameNumber;
+
+        return true;
+    }
+
+    void Texture::FinishRelocation()
+    {
+        // Continue from states the texture is in right now
+        mStateTracker->RequestTransitions(mRelocationTarget.get(), mStateTracker->ResourceCurrentStates(mTexturePtr.get()));
+        mStateTracker->StopTrakingResource(mTexturePtr.get());
+
+        // Previous texture is released through the allocator after frames that might use it complete
+        mTexturePtr = std::move(mRelocationTarget);
+
+        // Frames in flight may still read the old descriptor, so its slot is released through the frame ring
+        mSRDescriptor = nullptr;
+    }
+
+    void Texture::CancelRelocation()
+    {
+        mCopyRequestManager->CancelUploadRequests(mRelocationTarget.get());
+        mStateTracker->StopTrakingResource(mRelocationTarget.get());
+        mRelocationTarget = nullptr;
+    }
+
     uint64_t Texture::UploadAndReadbackResourceSize() const
     {
         return Footprint().TotalSizeInBytes();
@@ -146,12 +221,8 @@ namespace Memory
     {
         return [&](HAL::CopyCommandListBase& cmdList)
         {
-            HAL::ResourceFootprint footprint{ *HALTexture() };
-
-            for (const HAL::SubresourceFootprint& subresourceFootprint : footprint.SubresourceFootprints())
-            {
-                cmdList.CopyBufferToTexture(*CurrentFrameUploadBuffer(), *HALTexture(), subresourceFootprint);
-            }
+            // Footprint is cached and matches the layout subresources were written in
+            cmdList.CopyBufferToTexture(*CurrentFrameUploadBuffer(), *HALTexture(), Footprint());
         };
     }
 
@@ -159,12 +230,7 @@ namespace Memory
     {
         return [&](HAL::CopyCommandListBase& cmdList)
         {
-            HAL::ResourceFootprint textureFootprint{ *HALTexture() };
-
-            for (const HAL::SubresourceFootprint& subresourceFootprint : textureFootprint.SubresourceFootprints())
-            {
-                cmdList.CopyTextureToBuffer(*HALTexture(), *CurrentFrameReadbackBuffer(), subresourceFootprint);
-            }
+            cmdList.CopyTextureToBuffer(*HALTexture(), *CurrentFrameReadbackBuffer(), Footprint());
         };
     }
 
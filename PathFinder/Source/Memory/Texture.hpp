@@ -48,16 +48,23 @@ namespace Memory
         const HAL::Texture* HALTexture() const;
         const HAL::Resource* HALResource() const override;
 
+        bool CanBeRelocated() const override;
+        bool BeginRelocation() override;
+
     protected:
         uint64_t UploadAndReadbackResourceSize() const override;
         void ApplyDebugName() override;
         CopyRequestManager::CopyCommand GetUploadCommands() override;
         CopyRequestManager::CopyCommand GetReadbackCommands() override;
+        void FinishRelocation() override;
+        void CancelRelocation() override;
         void ReserveDiscriptorArrays(uint8_t mipCount);
 
     private:
         SegregatedPoolsResourceAllocator::TexturePtr mTexturePtr;
+        SegregatedPoolsResourceAllocator::TexturePtr mRelocationTarget;
         HAL::TextureProperties mProperties;
+        bool mIsRecyclable = false;
         
         mutable std::optional<HAL::ResourceFootprint> mFootprint;
 
@@ -0,0 +1,358 @@
+#include "TransientHeapPool.hpp"
+
+#include <Foundation/MemoryUtils.hpp>
+
+#include <fstream>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <type_traits>
+
+namespace Memory
+{
+
+    TransientHeapPool::TransientHeapPool(const HAL::Device* device, uint8_t simultaneousFramesInFlight)
+        : mDevice{ device }, mRingFrameTracker{ simultaneousFramesInFlight }
+    {
+        mPendingReleases.resize(simultaneousFramesInFlight);
+
+        mRingFrameTracker.SetDeallocationCallback([this](const Ring::FrameTailAttributes& frameAttributes)
+        {
+            auto frameIndex = frameAttributes.Tail - frameAttributes.Size;
+            ExecutePendingReleases(frameIndex);
+        });
+    }
+
+    HAL::Heap* TransientHeapPool::AcquireHeap(HAL::HeapAliasingGroup group, uint64_t requiredSize)
+    {
+        uint32_t requiredSizeClass = SizeClass(requiredSize);
+        GroupHeaps& heaps = mGroupHeaps[std::underlying_type_t<HAL::HeapAliasingGroup>(group)];
+
+        auto isSuitable = [requiredSizeClass](uint32_t sizeClass)
+        {
+            return sizeClass >= requiredSizeClass && sizeClass <= requiredSizeClass + ShrinkHysteresisClassCount;
+        };
+
+        if (heaps.Current.Heap)
+        {
+            if (isSuitable(heaps.Current.SizeClass))
+            {
+                ++mStatistics.HeapsKept;
+                return heaps.Current.Heap.get();
+            }
+
+            // Previous layout could still be in use by frames in flight
+            mPendingReleases[mCurrentFrameIndex].Heaps.emplace_back(group, std::move(heaps.Current));
+            heaps.Current = {};
+            ++mStatistics.HeapsRetired;
+        }
+
+        // Pick the smallest suitable idle heap
+        auto idleHeapIt = heaps.Idle.end();
+
+        for (auto it = heaps.Idle.begin(); it != heaps.Idle.end(); ++it)
+        {
+            if (isSuitable(it->SizeClass) && (idleHeapIt == heaps.Idle.end() || it->SizeClass < idleHeapIt->SizeClass))
+            {
+                idleHeapIt = it;
+            }
+        }
+
+        if (idleHeapIt != heaps.Idle.end())
+        {
+            heaps.Current = std::move(*idleHeapIt);
+            heaps.Idle.erase(idleHeapIt);
+            ++mStatistics.HeapsRecycled;
+            return heaps.Current.Heap.get();
+        }
+
+        heaps.Current.Heap = std::make_unique<HAL::Heap>(*mDevice, SizeClassBytes(requiredSizeClass), group);
+        heaps.Current.SizeClass = requiredSizeClass;
+
+        ++mStatistics.HeapsCreated;
+        mStatistics.CreatedHeapBytes += heaps.Current.Heap->AlighnedSize();
+
+        return heaps.Current.Heap.get();
+    }
+
+    void TransientHeapPool::RetireResource(GPUResourceProducer::TexturePtr texture)
+    {
+        if (!texture)
+            return;
+
+        mPendingReleases[mCurrentFrameIndex].Textures.emplace_back(std::move(texture));
+        ++mStatistics.ResourcesRetired;
+    }
+
+    void TransientHeapPool::RetireResource(GPUResourceProducer::BufferPtr buffer)
+    {
+        if (!buffer)
+            return;
+
+        mPendingReleases[mCurrentFrameIndex].Buffers.emplace_back(std::move(buffer));
+        ++mStatistics.ResourcesRetired;
+    }
+
+    void TransientHeapPool::BeginFrame(uint64_t frameNumber)
+    {
+        mCurrentFrameIndex = mRingFrameTracker.Allocate(1);
+        mRingFrameTracker.FinishCurrentFrame(frameNumber);
+    }
+
+    void TransientHeapPool::EndFrame(uint64_t completedFrameNumber)
+    {
+        mRingFrameTracker.ReleaseCompletedFrames(completedFrameNumber);
+    }
+
+    uint32_t TransientHeapPool::SizeClass(uint64_t size)
+    {
+        uint32_t sizeClass = 0;
+
+        while (SizeClassBytes(sizeClass) < size)
+        {
+            ++sizeClass;
+        }
+
+        return sizeClass;
+    }
+
+    uint64_t TransientHeapPool::SizeClassBytes(uint32_t sizeClass)
+    {
+        uint64_t octaveSize = MinimumHeapSize << (sizeClass / SizeClassesPerOctave);
+        return octaveSize / SizeClassesPerOctave * (SizeClassesPerOctave + sizeClass % SizeClassesPerOctave);
+    }
+
+    void TransientHeapPool::ExecutePendingReleases(uint64_t frameIndex)
+    {
+        PendingRelease& release = mPendingReleases[frameIndex];
+
+        // Placed resources go first, heaps they were placed in after
+        release.Textures.clear();
+        release.Buffers.clear();
+
+        for (auto& [group, pooledHeap] : release.Heaps)
+        {
+            GroupHeaps& heaps = mGroupHeaps[std::underlying_type_t<HAL::HeapAliasingGroup>(group)];
+            heaps.Idle.emplace_back(std::move(pooledHeap));
+
+            if (heaps.Idle.size() > MaxIdleHeapsPerGroup)
+            {
+                heaps.Idle.erase(heaps.Idle.begin());
+                ++mStatistics.HeapsReleased;
+            }
+        }
+
+        release.Heaps.clear();
+    }
+
+    bool TransientHeapPool::RunBenchmark(const HAL::Device* device, GPUResourceProducer* resourceProducer, const std::filesystem::path& reportPath)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        struct SimulatedTarget
+        {
+            HAL::ColorFormat Format;
+            float ResolutionScale = 1.0f;
+            // Target belongs to a pass that is toggled on and off
+            bool IsToggled = false;
+
+            GPUResourceProducer::TexturePtr Texture;
+            const HAL::Heap* Heap = nullptr;
+            uint64_t HeapOffset = 0;
+            Geometry::Dimensions Dimensions;
+        };
+
+        struct Phase
+        {
+            std::string Name;
+            uint64_t StepCount = 0;
+        };
+
+        struct Measurement
+        {
+            uint64_t RelayoutCount = 0;
+            uint64_t HeapsCreated = 0;
+            uint64_t CreatedHeapBytes = 0;
+            uint64_t ResourcesCreated = 0;
+            uint64_t ResourcesKept = 0;
+            double TotalTime = 0.0;
+            double WorstTime = 0.0;
+        };
+
+        std::ofstream stream{ reportPath, std::ios::out | std::ios::trunc };
+
+        if (!stream.is_open())
+        {
+            return false;
+        }
+
+        const uint8_t FramesInFlight = 2;
+        const uint64_t ResizeStepCount = 60;
+        const uint64_t ToggleStepCount = 40;
+
+        // Mimics a deferred pipeline: G-Buffer, lighting, denoiser and bloom chains
+        auto makeTargets = []
+        {
+            std::vector<SimulatedTarget> targets;
+            for (auto i = 0; i < 6; ++i) targets.push_back({ HAL::ColorFormat::RGBA16_Float, 1.0f, false });
+            for (auto i = 0; i < 4; ++i) targets.push_back({ HAL::ColorFormat::RGBA8_Unsigned_Norm, 1.0f, false });
+            for (auto i = 0; i < 4; ++i) targets.push_back({ HAL::ColorFormat::R16_Float, 0.5f, false });
+            for (auto i = 0; i < 2; ++i) targets.push_back({ HAL::ColorFormat::R32_Float, 1.0f, true });
+            for (auto i = 0; i < 4; ++i) targets.push_back({ HAL::ColorFormat::RGBA16_Float, 0.5f, true });
+            for (auto i = 0; i < 4; ++i) targets.push_back({ HAL::ColorFormat::RG16_Float, 0.25f, true });
+            return targets;
+        };
+
+        std::vector<Phase> phases = { { "resize", ResizeStepCount }, { "toggle", ToggleStepCount } };
+        std::vector<std::string> modes = { "fullRecreation", "incremental" };
+
+        stream.precision(6);
+        stream << "{\"units\":\"milliseconds\",\"results\":[\n";
+
+        bool isFirstResult = true;
+
+        for (const std::string& mode : modes)
+        {
+            bool isIncremental = mode == "incremental";
+
+            std::vector<SimulatedTarget> targets = makeTargets();
+            TransientHeapPool pool{ device, FramesInFlight };
+            std::unique_ptr<HAL::Heap> recreatedHeap;
+            uint64_t frameNumber = 0;
+
+            for (const Phase& phase : phases)
+            {
+                Measurement measurement{};
+                Statistics statisticsBefore = pool.GetStatistics();
+
+                for (uint64_t step = 0; step < phase.StepCount; ++step)
+                {
+                    ++frameNumber;
+                    pool.BeginFrame(frameNumber);
+
+                    // Window is dragged from 720p to 1080p during resize, toggled passes flip on every other frame afterwards
+                    bool isResizing = phase.Name == "resize";
+                    uint64_t width = isResizing ? 1280 + step * (640 / ResizeStepCount) : 1920;
+                    uint64_t height = width * 9 / 16;
+                    bool areToggledPassesEnabled = isResizing || step % 2 == 0;
+
+                    std::vector<HAL::TextureProperties> properties;
+                    std::vector<uint64_t> offsets;
+                    uint64_t requiredSize = 0;
+                    HAL::HeapAliasingGroup group = HAL::HeapAliasingGroup::RTDSTextures;
+
+                    for (const SimulatedTarget& target : targets)
+                    {
+                        Geometry::Dimensions dimensions{
+                            std::max<uint64_t>(static_cast<uint64_t>(width * target.ResolutionScale), 1),
+                            std::max<uint64_t>(static_cast<uint64_t>(height * target.ResolutionScale), 1) };
+
+                        properties.emplace_back(target.Format, HAL::TextureKind::Texture2D, dimensions,
+                            HAL::ResourceState::RenderTarget, HAL::ResourceState::RenderTarget | HAL::ResourceState::PixelShaderAccess);
+
+                        bool isActive = !target.IsToggled || areToggledPassesEnabled;
+
+                        if (!isActive)
+                        {
+                            offsets.push_back(0);
+                            continue;
+                        }
+
+                        // Linear packing stands in for the aliaser, offsets of subsequent targets shift when anything changes
+                        HAL::ResourceFormat format{ device, properties.back() };
+                        group = format.ResourceAliasingGroup();
+                        requiredSize = Foundation::MemoryUtils::Align(requiredSize, format.ResourceAlighnment());
+                        offsets.push_back(requiredSize);
+                        requiredSize += format.ResourceSizeInBytes();
+                    }
+
+                    auto relayoutStart = Clock::now();
+
+                    HAL::Heap* heap = nullptr;
+
+                    if (isIncremental)
+                    {
+                        heap = pool.AcquireHeap(group, requiredSize);
+                    }
+                    else
+                    {
+                        for (SimulatedTarget& target : targets) target.Texture = nullptr;
+                        recreatedHeap = std::make_unique<HAL::Heap>(*device, requiredSize, group);
+                        heap = recreatedHeap.get();
+                        ++measurement.HeapsCreated;
+                        measurement.CreatedHeapBytes += heap->AlighnedSize();
+                    }
+
+                    for (auto targetIdx = 0u; targetIdx < targets.size(); ++targetIdx)
+                    {
+                        SimulatedTarget& target = targets[targetIdx];
+                        const HAL::TextureProperties& targetProperties = properties[targetIdx];
+                        bool isActive = !target.IsToggled || areToggledPassesEnabled;
+
+                        if (!isActive)
+                        {
+                            pool.RetireResource(std::move(target.Texture));
+                            continue;
+                        }
+
+                        bool isPlacementValid =
+                            target.Texture &&
+                            target.Heap == heap &&
+                            target.HeapOffset == offsets[targetIdx] &&
+                            target.Dimensions.Width == targetProperties.Dimensions.Width &&
+                            target.Dimensions.Height == targetProperties.Dimensions.Height;
+
+                        if (isPlacementValid)
+                        {
+                            ++measurement.ResourcesKept;
+                            continue;
+                        }
+
+                        pool.RetireResource(std::move(target.Texture));
+                        target.Texture = resourceProducer->NewTexture(targetProperties, *heap, offsets[targetIdx]);
+                        target.Heap = heap;
+                        target.HeapOffset = offsets[targetIdx];
+                        target.Dimensions = targetProperties.Dimensions;
+                        ++measurement.ResourcesCreated;
+                    }
+
+                    double relayoutTime = std::chrono::duration<double, std::milli>(Clock::now() - relayoutStart).count();
+
+                    ++measurement.RelayoutCount;
+                    measurement.TotalTime += relayoutTime;
+                    measurement.WorstTime = std::max(measurement.WorstTime, relayoutTime);
+
+                    // GPU is simulated to lag one frame behind
+                    pool.EndFrame(frameNumber - 1);
+                }
+
+                if (isIncremental)
+                {
+                    measurement.HeapsCreated = pool.GetStatistics().HeapsCreated - statisticsBefore.HeapsCreated;
+                    measurement.CreatedHeapBytes = pool.GetStatistics().CreatedHeapBytes - statisticsBefore.CreatedHeapBytes;
+                }
+
+                stream << (isFirstResult ? "" : ",\n") << "{\"mode\":\"" << mode << "\""
+                    << ",\"phase\":\"" << phase.Name << "\""
+                    << ",\"relayouts\":" << measurement.RelayoutCount
+                    << ",\"heapsCreated\":" << measurement.HeapsCreated
+                    << ",\"createdHeapMegabytes\":" << measurement.CreatedHeapBytes / (1024.0 * 1024.0)
+                    << ",\"resourcesCreated\":" << measurement.ResourcesCreated
+                    << ",\"resourcesKept\":" << measurement.ResourcesKept
+                    << ",\"meanRelayoutTime\":" << measurement.TotalTime / std::max<uint64_t>(measurement.RelayoutCount, 1)
+                    << ",\"worstRelayoutTime\":" << measurement.WorstTime << "}";
+
+                isFirstResult = false;
+            }
+
+            // Let every retired resource go before the heaps they were placed in
+            pool.EndFrame(frameNumber);
+            targets.clear();
+        }
+
+        stream << "]}\n";
+
+        return true;
+    }
+
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Ring.hpp"
+#include "GPUResourceProducer.hpp"
+
+#include <HardwareAbstractionLayer/Device.hpp>
+#include <HardwareAbstractionLayer/Heap.hpp>
+
+#include <memory>
+#include <vector>
+#include <array>
+#include <filesystem>
+
+namespace Memory
+{
+
+    /// Owns heaps that back aliased transient resources of the render pipeline.
+    /// Heaps are sized in geometric size classes and survive memory relayouts as long as they still fit
+    /// the new layout, so that growing or shrinking requirements don't translate into a new heap every time.
+    /// Heaps and placed resources that go out of use are kept alive until frames that could reference them complete.
+    class TransientHeapPool
+    {
+    public:
+        struct Statistics
+        {
+            uint64_t HeapsCreated = 0;
+            uint64_t HeapsKept = 0;
+            uint64_t HeapsRecycled = 0;
+            uint64_t HeapsRetired = 0;
+            uint64_t HeapsReleased = 0;
+            uint64_t ResourcesRetired = 0;
+            uint64_t CreatedHeapBytes = 0;
+        };
+
+        TransientHeapPool(const HAL::Device* device, uint8_t simultaneousFramesInFlight);
+
+        // Returns a heap that can hold requested amount of memory for the aliasing group.
+        // Heap of the previous layout is returned if it fits and isn't excessively large,
+        // otherwise it's retired and replaced by an idle heap of a suitable size class or a new one.
+        HAL::Heap* AcquireHeap(HAL::HeapAliasingGroup group, uint64_t requiredSize);
+
+        // Defer destruction of resources that could still be referenced by frames in flight
+        void RetireResource(GPUResourceProducer::TexturePtr texture);
+        void RetireResource(GPUResourceProducer::BufferPtr buffer);
+
+        void BeginFrame(uint64_t frameNumber);
+        void EndFrame(uint64_t completedFrameNumber);
+
+        static uint32_t SizeClass(uint64_t size);
+        static uint64_t SizeClassBytes(uint32_t sizeClass);
+
+        // Simulates resize storms and pass toggles on the device and compares incremental relayouts to full recreation
+        static bool RunBenchmark(const HAL::Device* device, GPUResourceProducer* resourceProducer, const std::filesystem::path& reportPath);
+
+    private:
+        // Smallest size class, subsequent classes grow by a quarter of an octave
+        inline static const uint64_t MinimumHeapSize = 4 * 1024 * 1024;
+        inline static const uint32_t SizeClassesPerOctave = 4;
+
+        // Heap is replaced by a smaller one only when requirements drop by more than an octave
+        inline static const uint32_t ShrinkHysteresisClassCount = SizeClassesPerOctave;
+
+        // Idle heaps are kept to be picked up by subsequent relayouts, e.g. when a pass is toggled back
+        inline static const uint64_t MaxIdleHeapsPerGroup = 2;
+
+        inline static const uint64_t AliasingGroupCount = 4;
+
+        struct PooledHeap
+        {
+            std::unique_ptr<HAL::Heap> Heap;
+            uint32_t SizeClass = 0;
+        };
+
+        struct GroupHeaps
+        {
+            PooledHeap Current;
+            // Ordered from the least to the most recently retired
+            std::vector<PooledHeap> Idle;
+        };
+
+        struct PendingRelease
+        {
+            std::vector<std::pair<HAL::HeapAliasingGroup, PooledHeap>> Heaps;
+            std::vector<GPUResourceProducer::TexturePtr> Textures;
+            std::vector<GPUResourceProducer::BufferPtr> Buffers;
+        };
+
+        void ExecutePendingReleases(uint64_t frameIndex);
+
+        const HAL::Device* mDevice = nullptr;
+
+        Ring mRingFrameTracker;
+
+        uint64_t mCurrentFrameIndex = 0;
+        std::array<GroupHeaps, AliasingGroupCount> mGroupHeaps;
+        std::vector<PendingRelease> mPendingReleases;
+        Statistics mStatistics;
+
+    public:
+        inline const Statistics& GetStatistics() const { return mStatistics; }
+    };
+
+}
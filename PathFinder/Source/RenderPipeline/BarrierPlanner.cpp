@@ -0,0 +1,543 @@
+#include "BarrierPlanner.hpp"
+
+#include <bitsery/adapter/stream.h>
+#include <bitsery/traits/vector.h>
+
+#include <robinhood/robin_hood.h>
+
+#include <fstream>
+#include <algorithm>
+#include <numeric>
+
+namespace PathFinder
+{
+
+    namespace
+    {
+        std::vector<std::vector<uint64_t>> GroupPassesPerQueue(const BarrierPlanner::FrameTransitions& frame)
+        {
+            std::vector<std::vector<uint64_t>> passesPerQueue(frame.QueueCount);
+
+            for (auto passIdx = 0u; passIdx < frame.Passes.size(); ++passIdx)
+            {
+                const BarrierPlanner::PassInfo& pass = frame.Passes[passIdx];
+                std::vector<uint64_t>& queuePasses = passesPerQueue[pass.QueueIndex];
+
+                if (queuePasses.size() <= pass.LocalToQueueExecutionIndex)
+                    queuePasses.resize(pass.LocalToQueueExecutionIndex + 1, BarrierPlanner::InvalidIndex);
+
+                queuePasses[pass.LocalToQueueExecutionIndex] = passIdx;
+            }
+
+            return passesPerQueue;
+        }
+
+        // Whether previous pass from another queue is known to be complete by the time pass starts
+        bool IsSynchronizedWith(const BarrierPlanner::PassInfo& pass, const BarrierPlanner::PassInfo& previousPass)
+        {
+            if (previousPass.QueueIndex >= pass.SynchronizationIndices.size())
+                return false;
+
+            uint64_t syncIndex = pass.SynchronizationIndices[previousPass.QueueIndex];
+            return syncIndex != BarrierPlanner::InvalidIndex && syncIndex >= previousPass.LocalToQueueExecutionIndex;
+        }
+
+        void AssignRerouteEventQueues(const BarrierPlanner::FrameTransitions& frame, BarrierPlanner::RerouteEvent& event)
+        {
+            std::vector<uint64_t> queues;
+
+            for (uint64_t dlIndex : event.ServedDependencyLevels)
+            {
+                const std::vector<uint64_t>& dlQueues = frame.DependencyLevelReroutingQueues[dlIndex];
+                queues.insert(queues.end(), dlQueues.begin(), dlQueues.end());
+            }
+
+            std::sort(queues.begin(), queues.end());
+            queues.erase(std::unique(queues.begin(), queues.end()), queues.end());
+
+            // Graphics queue is at index 0 and compute queues follow,
+            // so the most competent queue is the one with minimum index
+            event.QueueIndex = queues.empty() ? 0 : queues.front();
+            event.QueuesToSync.assign(queues.begin() + std::min<size_t>(1, queues.size()), queues.end());
+        }
+    }
+
+    BarrierPlanner::BarrierPlanner(float minSplitOverlap)
+        : mMinSplitOverlap{ minSplitOverlap } {}
+
+    BarrierPlanner::Plan BarrierPlanner::PlanTransitions(const FrameTransitions& frame, bool splitBarriersEnabled) const
+    {
+        Plan plan;
+        plan.Placements.resize(frame.Requests.size());
+
+        std::vector<std::vector<uint64_t>> passesPerQueue = GroupPassesPerQueue(frame);
+        robin_hood::unordered_flat_map<uint64_t, Usage> usages;
+
+        uint64_t dependencyLevelCount = frame.DependencyLevelReroutingQueues.size();
+        std::vector<std::vector<uint64_t>> rerouteRequestsPerDL(dependencyLevelCount);
+        std::vector<std::optional<uint64_t>> reroutingBoundsPerDL(dependencyLevelCount);
+
+        for (auto requestIdx = 0u; requestIdx < frame.Requests.size(); ++requestIdx)
+        {
+            const TransitionRequest& request = frame.Requests[requestIdx];
+            const PassInfo& pass = frame.Passes[request.PassIndex];
+            TransitionPlacement& placement = plan.Placements[requestIdx];
+
+            auto previousUsageIt = usages.find(request.SubresourceName);
+            std::optional<Usage> previousUsage = previousUsageIt != usages.end() ? std::optional{ previousUsageIt->second } : std::nullopt;
+
+            switch (request.Type)
+            {
+            case TransitionType::Usage:
+            {
+                usages[request.SubresourceName] = { request.PassIndex, false };
+                break;
+            }
+
+            case TransitionType::Standard:
+            {
+                bool previouslyUsedByPass = previousUsage && !previousUsage->IsRerouteUsage;
+                const PassInfo* previousPass = previouslyUsedByPass ? &frame.Passes[previousUsage->UserIndex] : nullptr;
+
+                // Decay happens when ExecuteCommandLists that used the resource completes. Same queue and batch means
+                // it didn't complete yet, another queue without synchronization means we can't be sure it did.
+                bool previousBatchMayBeInFlight = previousPass && (previousPass->QueueIndex == pass.QueueIndex ?
+                    previousPass->BatchIndex == pass.BatchIndex : !IsSynchronizedWith(pass, *previousPass));
+
+                if (request.IsImplicitTransitionPossible && !previousBatchMayBeInFlight)
+                {
+                    placement.Type = Placement::Omitted;
+                }
+                else
+                {
+                    std::optional<uint64_t> beginPass = splitBarriersEnabled && previouslyUsedByPass ?
+                        FindSplitBeginPass(frame, passesPerQueue, *previousUsage, request.PassIndex) : std::nullopt;
+
+                    placement.Type = beginPass ? Placement::Split : Placement::Full;
+                    placement.BeginPassIndex = beginPass.value_or(InvalidIndex);
+                }
+
+                // Omitted transitions are still usages, split barriers placed later must not begin before them
+                usages[request.SubresourceName] = { request.PassIndex, false };
+                break;
+            }
+
+            case TransitionType::Reroute:
+            {
+                uint64_t dlIndex = pass.DependencyLevelIndex;
+
+                if (previousUsage)
+                {
+                    std::optional<uint64_t> previousDLIndex = FindPreviousUsageDependencyLevel(frame, *previousUsage);
+                    std::optional<uint64_t>& bound = reroutingBoundsPerDL[dlIndex];
+
+                    // Same resource read by multiple queues in one dependency level doesn't constrain rerouting
+                    if (previousDLIndex && *previousDLIndex != dlIndex && (!bound || *previousDLIndex > *bound))
+                        bound = previousDLIndex;
+                }
+
+                placement.Type = Placement::Full;
+                rerouteRequestsPerDL[dlIndex].push_back(requestIdx);
+                usages[request.SubresourceName] = { dlIndex, true };
+                break;
+            }
+            }
+        }
+
+        // Transitions rerouted for dependency level K may be executed anywhere after the last dependency level
+        // that used any of their resources and before K. Dependency levels whose windows intersect share one event.
+        std::optional<uint64_t> eventBound;
+        uint64_t eventFirstDL = 0;
+
+        for (auto dlIndex = 0u; dlIndex < dependencyLevelCount; ++dlIndex)
+        {
+            if (rerouteRequestsPerDL[dlIndex].empty())
+                continue;
+
+            std::optional<uint64_t> bound = reroutingBoundsPerDL[dlIndex];
+            std::optional<uint64_t> mergedBound = eventBound;
+
+            if (bound && (!mergedBound || *bound > *mergedBound))
+                mergedBound = bound;
+
+            bool canMerge = !plan.RerouteEvents.empty() && (!mergedBound || *mergedBound < eventFirstDL);
+
+            if (canMerge)
+            {
+                plan.RerouteEvents.back().AfterDependencyLevel = mergedBound;
+                plan.RerouteEvents.back().ServedDependencyLevels.push_back(dlIndex);
+                eventBound = mergedBound;
+            }
+            else
+            {
+                RerouteEvent& event = plan.RerouteEvents.emplace_back();
+                event.AfterDependencyLevel = bound;
+                event.ServedDependencyLevels.push_back(dlIndex);
+                eventBound = bound;
+                eventFirstDL = dlIndex;
+            }
+
+            for (uint64_t requestIdx : rerouteRequestsPerDL[dlIndex])
+            {
+                plan.Placements[requestIdx].RerouteEventIndex = plan.RerouteEvents.size() - 1;
+            }
+        }
+
+        for (RerouteEvent& event : plan.RerouteEvents)
+        {
+            AssignRerouteEventQueues(frame, event);
+        }
+
+        return plan;
+    }
+
+    BarrierPlanner::Plan BarrierPlanner::PlanLegacyTransitions(const FrameTransitions& frame, bool splitBarriersEnabled)
+    {
+        struct LegacyUsage
+        {
+            Usage User;
+            uint64_t BatchIndex = 0;
+        };
+
+        Plan plan;
+        plan.Placements.resize(frame.Requests.size());
+
+        robin_hood::unordered_flat_map<uint64_t, LegacyUsage> usages;
+
+        uint64_t dependencyLevelCount = frame.DependencyLevelReroutingQueues.size();
+        std::vector<std::vector<uint64_t>> rerouteRequestsPerDL(dependencyLevelCount);
+        std::vector<std::optional<uint64_t>> reroutingBoundsPerDL(dependencyLevelCount);
+
+        for (auto requestIdx = 0u; requestIdx < frame.Requests.size(); ++requestIdx)
+        {
+            const TransitionRequest& request = frame.Requests[requestIdx];
+            const PassInfo& pass = frame.Passes[request.PassIndex];
+            TransitionPlacement& placement = plan.Placements[requestIdx];
+
+            auto previousUsageIt = usages.find(request.SubresourceName);
+            bool foundPreviousUsage = previousUsageIt != usages.end();
+
+            if (request.Type == TransitionType::Usage)
+            {
+                usages[request.SubresourceName] = { { request.PassIndex, false }, pass.BatchIndex };
+                continue;
+            }
+
+            if (request.Type == TransitionType::Reroute)
+            {
+                uint64_t dlIndex = pass.DependencyLevelIndex;
+
+                if (foundPreviousUsage)
+                {
+                    std::optional<uint64_t> previousDLIndex = FindPreviousUsageDependencyLevel(frame, previousUsageIt->second.User);
+                    std::optional<uint64_t>& bound = reroutingBoundsPerDL[dlIndex];
+
+                    if (previousDLIndex && *previousDLIndex != dlIndex && (!bound || *previousDLIndex > *bound))
+                        bound = previousDLIndex;
+                }
+
+                placement.Type = Placement::Full;
+                rerouteRequestsPerDL[dlIndex].push_back(requestIdx);
+                usages[request.SubresourceName] = { { dlIndex, true }, 0 };
+                continue;
+            }
+
+            bool subresourceTransitionedAtLeastOnce = foundPreviousUsage && previousUsageIt->second.BatchIndex == pass.BatchIndex;
+
+            if (!subresourceTransitionedAtLeastOnce && request.IsImplicitTransitionPossible)
+            {
+                placement.Type = Placement::Omitted;
+                continue;
+            }
+
+            placement.Type = Placement::Full;
+
+            if (foundPreviousUsage && !previousUsageIt->second.User.IsRerouteUsage)
+            {
+                uint64_t previousPassIndex = previousUsageIt->second.User.UserIndex;
+                const PassInfo& previousPass = frame.Passes[previousPassIndex];
+
+                bool isSplitBarrierPossible = splitBarriersEnabled && (request.SupportingQueueMask & (1u << previousPass.QueueIndex));
+                bool currentPassIsNextToPrevious = pass.LocalToQueueExecutionIndex - previousPass.LocalToQueueExecutionIndex <= 1;
+
+                if (isSplitBarrierPossible && !currentPassIsNextToPrevious)
+                {
+                    placement.Type = Placement::Split;
+                    placement.BeginPassIndex = previousPassIndex;
+                }
+            }
+
+            usages[request.SubresourceName] = { { request.PassIndex, false }, pass.BatchIndex };
+        }
+
+        // Every dependency level involving rerouting queues gets its own event, even if all of its transitions turned out to be redundant
+        for (auto dlIndex = 0u; dlIndex < dependencyLevelCount; ++dlIndex)
+        {
+            if (frame.DependencyLevelReroutingQueues[dlIndex].empty())
+                continue;
+
+            RerouteEvent& event = plan.RerouteEvents.emplace_back();
+            event.AfterDependencyLevel = reroutingBoundsPerDL[dlIndex];
+            event.ServedDependencyLevels.push_back(dlIndex);
+            AssignRerouteEventQueues(frame, event);
+
+            for (uint64_t requestIdx : rerouteRequestsPerDL[dlIndex])
+            {
+                plan.Placements[requestIdx].RerouteEventIndex = plan.RerouteEvents.size() - 1;
+            }
+        }
+
+        return plan;
+    }
+
+    BarrierPlanner::Score BarrierPlanner::Evaluate(const FrameTransitions& frame, const Plan& plan)
+    {
+        return Evaluate(frame, plan, CostModel{});
+    }
+
+    BarrierPlanner::Score BarrierPlanner::Evaluate(const FrameTransitions& frame, const Plan& plan, const CostModel& costModel)
+    {
+        Score score;
+
+        std::vector<std::vector<uint64_t>> passesPerQueue = GroupPassesPerQueue(frame);
+        // Stall before pass work caused by its pre-work barrier batch. Batch waits for its slowest barrier.
+        std::vector<float> passStalls(frame.Passes.size(), 0.0f);
+
+        for (auto requestIdx = 0u; requestIdx < frame.Requests.size(); ++requestIdx)
+        {
+            const TransitionRequest& request = frame.Requests[requestIdx];
+            const TransitionPlacement& placement = plan.Placements[requestIdx];
+
+            if (request.Type == TransitionType::Usage)
+                continue;
+
+            switch (placement.Type)
+            {
+            case Placement::Omitted:
+            {
+                ++score.OmittedTransitionCount;
+                break;
+            }
+
+            case Placement::Full:
+            {
+                if (placement.RerouteEventIndex != InvalidIndex)
+                {
+                    ++score.ReroutedTransitionCount;
+                }
+                else
+                {
+                    ++score.FullBarrierCount;
+                    passStalls[request.PassIndex] = std::max(passStalls[request.PassIndex], costModel.DrainCost);
+                }
+                break;
+            }
+
+            case Placement::Split:
+            {
+                ++score.SplitBarrierCount;
+
+                // Work executed on the ending queue between begin and end halves hides the transition
+                const PassInfo& beginPass = frame.Passes[placement.BeginPassIndex];
+                const PassInfo& endPass = frame.Passes[request.PassIndex];
+                float overlap = 0.0f;
+
+                for (uint64_t passIdx : passesPerQueue[endPass.QueueIndex])
+                {
+                    const PassInfo& pass = frame.Passes[passIdx];
+
+                    if (passIdx > placement.BeginPassIndex && pass.LocalToQueueExecutionIndex < endPass.LocalToQueueExecutionIndex)
+                        overlap += PassDuration(pass, costModel);
+                }
+
+                float stall = std::max(0.0f, costModel.DrainCost - overlap);
+                passStalls[request.PassIndex] = std::max(passStalls[request.PassIndex], stall);
+                break;
+            }
+            }
+        }
+
+        score.RerouteEventCount = plan.RerouteEvents.size();
+        score.BarrierCount = score.FullBarrierCount + 2 * score.SplitBarrierCount + score.ReroutedTransitionCount;
+
+        score.EstimatedStallCost =
+            std::accumulate(passStalls.begin(), passStalls.end(), 0.0f) +
+            score.BarrierCount * costModel.BarrierCost +
+            score.RerouteEventCount * (costModel.RerouteEventCost + costModel.DrainCost);
+
+        return score;
+    }
+
+    bool BarrierPlanner::SaveFrame(const FrameTransitions& frame, const std::filesystem::path& path)
+    {
+        std::fstream stream{ path, std::ios::binary | std::ios::trunc | std::ios::out };
+
+        if (!stream.is_open())
+            return false;
+
+        bitsery::Serializer<bitsery::OutputBufferedStreamAdapter> ser{ stream };
+        ser.object(frame);
+        ser.adapter().flush();
+
+        return stream.good();
+    }
+
+    std::optional<BarrierPlanner::FrameTransitions> BarrierPlanner::LoadFrame(const std::filesystem::path& path)
+    {
+        std::fstream stream{ path, std::ios::binary | std::ios::in };
+
+        if (!stream.is_open())
+            return std::nullopt;
+
+        FrameTransitions frame;
+        bitsery::Deserializer<bitsery::InputStreamAdapter> des{ stream };
+        des.object(frame);
+
+        if (des.adapter().error() != bitsery::ReaderError::NoError || frame.Version != FrameTransitions::CurrentVersion || frame.QueueCount > 32)
+            return std::nullopt;
+
+        // Reject records referencing passes, queues or dependency levels that don't exist
+        for (const PassInfo& pass : frame.Passes)
+        {
+            if (pass.QueueIndex >= frame.QueueCount || pass.DependencyLevelIndex >= frame.DependencyLevelReroutingQueues.size())
+                return std::nullopt;
+        }
+
+        // Local to queue indices must enumerate passes on each queue without gaps
+        uint64_t groupedPassCount = 0;
+
+        for (const std::vector<uint64_t>& queuePasses : GroupPassesPerQueue(frame))
+        {
+            if (std::find(queuePasses.begin(), queuePasses.end(), InvalidIndex) != queuePasses.end())
+                return std::nullopt;
+
+            groupedPassCount += queuePasses.size();
+        }
+
+        if (groupedPassCount != frame.Passes.size())
+            return std::nullopt;
+
+        for (const TransitionRequest& request : frame.Requests)
+        {
+            if (request.PassIndex >= frame.Passes.size())
+                return std::nullopt;
+        }
+
+        for (const std::vector<uint64_t>& queues : frame.DependencyLevelReroutingQueues)
+        {
+            if (std::any_of(queues.begin(), queues.end(), [&frame](uint64_t queue) { return queue >= frame.QueueCount; }))
+                return std::nullopt;
+        }
+
+        return frame;
+    }
+
+    bool BarrierPlanner::RunBenchmark(const std::filesystem::path& recordPath, const std::filesystem::path& reportPath)
+    {
+        std::optional<FrameTransitions> frame = LoadFrame(recordPath);
+
+        if (!frame)
+            return false;
+
+        BarrierPlanner planner;
+
+        std::ofstream stream{ reportPath, std::ios::out | std::ios::trunc };
+
+        if (!stream.is_open())
+            return false;
+
+        stream.precision(9);
+
+        auto writeScore = [&stream](const char* name, const Score& score)
+        {
+            stream << "\"" << name << "\":{\"barriers\":" << score.BarrierCount << ",\"fullBarriers\":" << score.FullBarrierCount
+                << ",\"splitBarriers\":" << score.SplitBarrierCount << ",\"omittedTransitions\":" << score.OmittedTransitionCount
+                << ",\"rerouteEvents\":" << score.RerouteEventCount << ",\"reroutedTransitions\":" << score.ReroutedTransitionCount
+                << ",\"estimatedStallCost\":" << score.EstimatedStallCost << "}";
+        };
+
+        stream << "{\"units\":\"seconds\",\"passes\":" << frame->Passes.size() << ",\"requests\":" << frame->Requests.size() << ",\n";
+
+        for (bool splitBarriersEnabled : { true, false })
+        {
+            Score legacyScore = Evaluate(*frame, PlanLegacyTransitions(*frame, splitBarriersEnabled));
+            Score plannedScore = Evaluate(*frame, planner.PlanTransitions(*frame, splitBarriersEnabled));
+
+            stream << (splitBarriersEnabled ? "\"splitBarriersEnabled\":{" : ",\n\"splitBarriersDisabled\":{");
+            writeScore("legacy", legacyScore);
+            stream << ",";
+            writeScore("planned", plannedScore);
+            stream << "}";
+        }
+
+        stream << "}\n";
+
+        return stream.good();
+    }
+
+    std::optional<uint64_t> BarrierPlanner::FindPreviousUsageDependencyLevel(const FrameTransitions& frame, const Usage& usage)
+    {
+        if (usage.UserIndex == InvalidIndex)
+            return std::nullopt;
+
+        return usage.IsRerouteUsage ? usage.UserIndex : frame.Passes[usage.UserIndex].DependencyLevelIndex;
+    }
+
+    float BarrierPlanner::PassDuration(const PassInfo& pass, const CostModel& costModel)
+    {
+        return pass.Duration > 0.0f ? pass.Duration : costModel.FallbackPassDuration;
+    }
+
+    std::optional<uint64_t> BarrierPlanner::FindSplitBeginPass(
+        const FrameTransitions& frame, const std::vector<std::vector<uint64_t>>& passesPerQueue, const Usage& previousUsage, uint64_t endPassIndex) const
+    {
+        if (previousUsage.IsRerouteUsage)
+            return std::nullopt;
+
+        const PassInfo& endPass = frame.Passes[endPassIndex];
+        const PassInfo& previousPass = frame.Passes[previousUsage.UserIndex];
+        const std::vector<uint64_t>& queuePasses = passesPerQueue[endPass.QueueIndex];
+
+        // Both halves of a split barrier are kept on the queue that needs the new state. When the subresource was
+        // last used on another queue, begin is placed after the earliest pass that is synchronized with that usage.
+        std::optional<uint64_t> beginLocalIndex;
+
+        if (previousPass.QueueIndex == endPass.QueueIndex)
+        {
+            beginLocalIndex = previousPass.LocalToQueueExecutionIndex;
+        }
+        else
+        {
+            for (auto localIdx = 0u; localIdx < endPass.LocalToQueueExecutionIndex; ++localIdx)
+            {
+                if (IsSynchronizedWith(frame.Passes[queuePasses[localIdx]], previousPass))
+                {
+                    beginLocalIndex = localIdx;
+                    break;
+                }
+            }
+        }
+
+        // There is no sense in splitting barriers between two adjacent render passes.
+        // That will only double the amount of barriers without any performance gain.
+        if (!beginLocalIndex || endPass.LocalToQueueExecutionIndex - *beginLocalIndex <= 1)
+            return std::nullopt;
+
+        // Require enough work in between to hide the transition, when timings are known
+        float overlap = 0.0f;
+        bool timingsKnown = false;
+
+        for (auto localIdx = *beginLocalIndex + 1; localIdx < endPass.LocalToQueueExecutionIndex; ++localIdx)
+        {
+            const PassInfo& pass = frame.Passes[queuePasses[localIdx]];
+            overlap += pass.Duration;
+            timingsKnown = timingsKnown || pass.Duration > 0.0f;
+        }
+
+        if (timingsKnown && overlap < mMinSplitOverlap)
+            return std::nullopt;
+
+        return queuePasses[*beginLocalIndex];
+    }
+
+}
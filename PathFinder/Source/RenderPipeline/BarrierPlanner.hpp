@@ -0,0 +1,197 @@
+#pragma once
+
+#include <bitsery/bitsery.h>
+
+#include <vector>
+#include <optional>
+#include <filesystem>
+
+namespace PathFinder
+{
+
+    /// Decides where resource transitions of a whole frame are recorded.
+    /// Works on a device-independent description of the frame: passes with their queue placement and
+    /// synchronization indices plus transition requests in the order the render device produced them.
+    /// Placement drops transitions made implicit by promotion/decay, moves begin halves of split barriers
+    /// to the earliest point on the receiving queue where the previous usage is known to be complete,
+    /// and merges rerouted transitions of several dependency levels into a single rerouting event
+    /// when no resource involved is used in between.
+    /// A deterministic cost model scores a placement so that it can be compared to the legacy one.
+    class BarrierPlanner
+    {
+    public:
+        inline static const uint64_t InvalidIndex = std::numeric_limits<uint64_t>::max();
+
+        struct PassInfo
+        {
+            uint64_t QueueIndex = 0;
+            uint64_t LocalToQueueExecutionIndex = 0;
+            uint64_t DependencyLevelIndex = 0;
+            // Estimated command list batch the pass is submitted in on its queue
+            uint64_t BatchIndex = 0;
+            // For each queue, local index of the latest pass known to be complete when this pass starts
+            std::vector<uint64_t> SynchronizationIndices;
+            // Measured work duration, zero if unknown
+            float Duration = 0.0f;
+
+            template <typename S>
+            void serialize(S& s)
+            {
+                s.value8b(QueueIndex);
+                s.value8b(LocalToQueueExecutionIndex);
+                s.value8b(DependencyLevelIndex);
+                s.value8b(BatchIndex);
+                s.container8b(SynchronizationIndices, std::numeric_limits<uint64_t>::max());
+                s.value4b(Duration);
+            }
+        };
+
+        enum class TransitionType : uint8_t
+        {
+            // Subresource is used by the pass in its current state, only usage history is affected
+            Usage,
+            // Transition is recorded on the queue of the pass
+            Standard,
+            // Transition can't be performed by the queue of the pass and is executed by a rerouting event
+            Reroute
+        };
+
+        struct TransitionRequest
+        {
+            uint64_t SubresourceName = 0;
+            uint64_t PassIndex = 0;
+            TransitionType Type = TransitionType::Usage;
+            // Transition can happen by implicit state promotion or decay
+            bool IsImplicitTransitionPossible = false;
+            // Bit per queue able to perform the transition
+            uint32_t SupportingQueueMask = 0;
+
+            template <typename S>
+            void serialize(S& s)
+            {
+                s.value8b(SubresourceName);
+                s.value8b(PassIndex);
+                s.value1b(Type);
+                s.boolValue(IsImplicitTransitionPossible);
+                s.value4b(SupportingQueueMask);
+            }
+        };
+
+        struct FrameTransitions
+        {
+            inline static const uint32_t CurrentVersion = 1;
+
+            uint32_t Version = CurrentVersion;
+            uint64_t QueueCount = 1;
+            // Passes in global execution order
+            std::vector<PassInfo> Passes;
+            // Requests in the order resource states were tracked: dependency level by dependency level,
+            // pass requests first, then requests rerouted in the dependency level
+            std::vector<TransitionRequest> Requests;
+            // Queues involved in transition rerouting for each dependency level
+            std::vector<std::vector<uint64_t>> DependencyLevelReroutingQueues;
+
+            template <typename S>
+            void serialize(S& s)
+            {
+                s.value4b(Version);
+                s.value8b(QueueCount);
+                s.container(Passes, std::numeric_limits<uint64_t>::max());
+                s.container(Requests, std::numeric_limits<uint64_t>::max());
+                s.container(DependencyLevelReroutingQueues, std::numeric_limits<uint64_t>::max(), [](S& s, std::vector<uint64_t>& queues)
+                {
+                    s.container8b(queues, std::numeric_limits<uint64_t>::max());
+                });
+            }
+        };
+
+        enum class Placement : uint8_t
+        {
+            Omitted, Full, Split
+        };
+
+        struct TransitionPlacement
+        {
+            Placement Type = Placement::Omitted;
+            // Pass after which work the begin half of a split barrier is recorded
+            uint64_t BeginPassIndex = InvalidIndex;
+            // Rerouting event the transition is recorded in
+            uint64_t RerouteEventIndex = InvalidIndex;
+        };
+
+        struct RerouteEvent
+        {
+            // Event is executed after passes of this dependency level, at the start of the frame if empty
+            std::optional<uint64_t> AfterDependencyLevel;
+            // Dependency levels whose transitions are executed by the event, ascending
+            std::vector<uint64_t> ServedDependencyLevels;
+            uint64_t QueueIndex = 0;
+            std::vector<uint64_t> QueuesToSync;
+        };
+
+        struct Plan
+        {
+            // Parallel to FrameTransitions::Requests
+            std::vector<TransitionPlacement> Placements;
+            std::vector<RerouteEvent> RerouteEvents;
+        };
+
+        struct CostModel
+        {
+            // Fixed cost of every barrier handed to the API
+            float BarrierCost = 1e-6f;
+            // Time GPU drains in-flight work before a full barrier or an end barrier without overlap
+            float DrainCost = 20e-6f;
+            // Extra submission and fence signal/wait of a rerouting event
+            float RerouteEventCost = 50e-6f;
+            // Pass duration used for overlap estimation when timing is unknown
+            float FallbackPassDuration = 50e-6f;
+        };
+
+        struct Score
+        {
+            uint64_t BarrierCount = 0;
+            uint64_t FullBarrierCount = 0;
+            uint64_t SplitBarrierCount = 0;
+            uint64_t OmittedTransitionCount = 0;
+            uint64_t RerouteEventCount = 0;
+            uint64_t ReroutedTransitionCount = 0;
+            float EstimatedStallCost = 0.0f;
+        };
+
+        BarrierPlanner(float minSplitOverlap = 10e-6f);
+
+        Plan PlanTransitions(const FrameTransitions& frame, bool splitBarriersEnabled) const;
+
+        // Reproduces placement the render device used before planning was introduced:
+        // begin barriers at the previous usage regardless of its queue, implicit transitions judged by batch index only
+        // and a rerouting event per dependency level
+        static Plan PlanLegacyTransitions(const FrameTransitions& frame, bool splitBarriersEnabled);
+
+        static Score Evaluate(const FrameTransitions& frame, const Plan& plan);
+        static Score Evaluate(const FrameTransitions& frame, const Plan& plan, const CostModel& costModel);
+
+        static bool SaveFrame(const FrameTransitions& frame, const std::filesystem::path& path);
+        static std::optional<FrameTransitions> LoadFrame(const std::filesystem::path& path);
+
+        // Loads recorded frame transitions, scores legacy and planned placements and writes the comparison to the report
+        static bool RunBenchmark(const std::filesystem::path& recordPath, const std::filesystem::path& reportPath);
+
+    private:
+        struct Usage
+        {
+            // Pass index or dependency level index for usages in rerouting events
+            uint64_t UserIndex = InvalidIndex;
+            bool IsRerouteUsage = false;
+        };
+
+        static std::optional<uint64_t> FindPreviousUsageDependencyLevel(const FrameTransitions& frame, const Usage& usage);
+        static float PassDuration(const PassInfo& pass, const CostModel& costModel);
+
+        // Earliest pass on the queue of the ending pass after which the begin half of a split barrier may be recorded
+        std::optional<uint64_t> FindSplitBeginPass(const FrameTransitions& frame, const std::vector<std::vector<uint64_t>>& passesPerQueue, const Usage& previousUsage, uint64_t endPassIndex) const;
+
+        float mMinSplitOverlap;
+    };
+
+}
@@ -3,8 +3,13 @@
 namespace PathFinder
 {
 
-    BottomRTAS::BottomRTAS(const HAL::Device* device, Memory::GPUResourceProducer* resourceProducer)
-        : RTAS(resourceProducer), mAccelerationStructure{ device } {}
+    BottomRTAS::BottomRTAS(const HAL::Device* device, Memory::GPUResourceProducer* resourceProducer, Usage usage)
+        : RTAS(resourceProducer), mAccelerationStructure{ device }, mUsage{ usage }
+    {
+        mAccelerationStructure.SetBuildFlags(usage == Usage::Static ?
+            HAL::RayTracingBuildFlags::PreferFastTrace | HAL::RayTracingBuildFlags::AllowCompaction :
+            HAL::RayTracingBuildFlags::PreferFastBuild | HAL::RayTracingBuildFlags::AllowUpdate);
+    }
 
     void BottomRTAS::AddGeometry(const HAL::RayTracingGeometry& geometry)
     {
@@ -14,21 +19,54 @@ namespace PathFinder
     void BottomRTAS::Build()
     {
         auto memoryRequirements = mAccelerationStructure.QueryMemoryRequirements();
-        AllocateBuffersForBuildIfNeeded(memoryRequirements.DestinationBufferMaxSizeInBytes, memoryRequirements.BuildScratchBufferSizeInBytes);
-        mAccelerationStructure.SetBuffers(mDestinationBuffer->HALBuffer(), mScratchBuffer->HALBuffer(), nullptr);
+        const Memory::Buffer* previousDestinationBuffer = mDestinationBuffer.get();
+        AllocateBuffersForBuildIfNeeded(memoryRequirements.DestinationBufferMaxSizeInBytes, 0);
+
+        // Newly allocated destination memory holds nothing until the build is recorded
+        mHoldsRecordedBuild &= mDestinationBuffer.get() == previousDestinationBuffer;
+        mAccelerationStructure.SetBuffers(mDestinationBuffer->HALBuffer(), nullptr, nullptr);
+        mScratchSize = memoryRequirements.BuildScratchBufferSizeInBytes;
+        mIsCompacted = false;
+        ++mBuildGeneration;
     }
 
     void BottomRTAS::Update()
     {
+        assert_format(mUsage == Usage::Deforming, "Only deforming structures are built with updates allowed");
+
         auto memoryRequirements = mAccelerationStructure.QueryMemoryRequirements();
-        AllocateBuffersForUpdateIfNeeded(memoryRequirements.DestinationBufferMaxSizeInBytes, memoryRequirements.UpdateScratchBufferSizeInBytes);
-        mAccelerationStructure.SetBuffers(mDestinationBuffer->HALBuffer(), mScratchBuffer->HALBuffer(), mUpdateSourceBuffer->HALBuffer());
+        AllocateBuffersForUpdateIfNeeded(memoryRequirements.DestinationBufferMaxSizeInBytes, 0);
+        mAccelerationStructure.SetBuffers(mDestinationBuffer->HALBuffer(), nullptr, mUpdateSourceBuffer->HALBuffer());
+        mScratchSize = memoryRequirements.UpdateScratchBufferSizeInBytes;
+        // Update writes into the buffer that previously served as its source
+        mHoldsRecordedBuild = false;
+        ++mBuildGeneration;
     }
 
     void BottomRTAS::Clear()
     {
         RTAS::Clear();
         mAccelerationStructure.Clear();
+
+        // Work planned for the previous contents must not touch the structure anymore
+        ++mBuildGeneration;
+    }
+
+    void BottomRTAS::ReplaceWithCompactedCopy(Memory::GPUResourceProducer::BufferPtr compactedBuffer)
+    {
+        // Previous buffer is released once frames still tracing against it complete
+        mDestinationBuffer = std::move(compactedBuffer);
+        mUABarrier = HAL::UnorderedAccessResourceBarrier{ mDestinationBuffer->HALBuffer() };
+        mAccelerationStructure.SetBuffers(mDestinationBuffer->HALBuffer(), nullptr, nullptr);
+        mIsCompacted = true;
+        mHoldsRecordedBuild = true;
+
+        ApplyDebugName();
+    }
+
+    void BottomRTAS::NotifyBuildRecorded()
+    {
+        mHoldsRecordedBuild = true;
     }
 
 }
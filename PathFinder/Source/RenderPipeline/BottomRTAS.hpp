@@ -8,23 +8,49 @@ namespace PathFinder
     class BottomRTAS : public RTAS
     {
     public:
-        BottomRTAS(const HAL::Device* device, Memory::GPUResourceProducer* resourceProducer);
+        // Static geometry is traced fast and compacted after build,
+        // deforming geometry is built fast and refitted through updates
+        enum class Usage
+        {
+            Static, Deforming
+        };
+
+        BottomRTAS(const HAL::Device* device, Memory::GPUResourceProducer* resourceProducer, Usage usage = Usage::Static);
         BottomRTAS(BottomRTAS&& that) = default;
         BottomRTAS(const BottomRTAS& that) = delete;
         BottomRTAS& operator=(BottomRTAS&& that) = default;
         BottomRTAS& operator=(const BottomRTAS& that) = delete;
         ~BottomRTAS() = default;
 
+        // Builds and updates are recorded by the render engine in a shared scratch buffer of ScratchSize() bytes
         void AddGeometry(const HAL::RayTracingGeometry& geometry);
         void Build();
         void Update();
         void Clear() override;
 
+        // Takes a buffer that a compacted copy of the current structure is recorded into
+        void ReplaceWithCompactedCopy(Memory::GPUResourceProducer::BufferPtr compactedBuffer);
+
+        // Called once a build or an update of the structure is recorded
+        void NotifyBuildRecorded();
+
     private:
         HAL::RayTracingBottomAccelerationStructure mAccelerationStructure;
+        Usage mUsage;
+        uint64_t mScratchSize = 0;
+        uint64_t mBuildGeneration = 0;
+        bool mIsCompacted = false;
+        bool mHoldsRecordedBuild = false;
 
     public:
         inline const auto& HALAccelerationStructure() const { return mAccelerationStructure; }
+        inline Usage StructureUsage() const { return mUsage; }
+        inline bool AllowsCompaction() const { return mUsage == Usage::Static; }
+        inline bool IsCompacted() const { return mIsCompacted; }
+        inline uint64_t ScratchSize() const { return mScratchSize; }
+        inline uint64_t BuildGeneration() const { return mBuildGeneration; }
+        // Destination memory still holds a complete structure, so tracing against it stays valid until the next build is recorded
+        inline bool HoldsRecordedBuild() const { return mHoldsRecordedBuild; }
     };
 
 }
@@ -0,0 +1,135 @@
+#include "BottomRTASWorkRecorder.hpp"
+
+namespace PathFinder
+{
+
+    BottomRTASWorkRecorder::BottomRTASWorkRecorder(Memory::GPUResourceProducer* resourceProducer, Memory::ResourceStateTracker* stateTracker, GPUProfiler* gpuProfiler)
+        : mResourceProducer{ resourceProducer }, mStateTracker{ stateTracker }, mGPUProfiler{ gpuProfiler } {}
+
+    uint64_t BottomRTASWorkRecorder::StructureKey(const BottomRTAS* blas)
+    {
+        return reinterpret_cast<uint64_t>(blas);
+    }
+
+    BottomRTAS* BottomRTASWorkRecorder::Structure(uint64_t key)
+    {
+        return reinterpret_cast<BottomRTAS*>(key);
+    }
+
+    void BottomRTASWorkRecorder::BeginRecording(HAL::ComputeCommandList& cmdList, uint64_t queueIndex)
+    {
+        mCommandList = &cmdList;
+
+        // Recorded every frame so that the event keeps its slot in the profiler
+        mGPUEventID = mGPUProfiler->RecordEventStart(cmdList, queueIndex);
+    }
+
+    void BottomRTASWorkRecorder::EndRecording()
+    {
+        mGPUProfiler->RecordEventEnd(*mCommandList, *mGPUEventID);
+        mCommandList = nullptr;
+    }
+
+    void BottomRTASWorkRecorder::BeginFrame()
+    {
+        mGPUEventID = std::nullopt;
+
+        if (!mCompactedSizes)
+        {
+            auto properties = HAL::BufferProperties::Create<uint64_t>(
+                RTASManager::MaxSizeQueriesPerFrame, 1, HAL::ResourceState::UnorderedAccess, HAL::ResourceState::UnorderedAccess | HAL::ResourceState::CopySource);
+
+            mCompactedSizes = mResourceProducer->NewBuffer(properties);
+            mCompactedSizes->SetDebugName("BLAS Compacted Sizes");
+
+            mCompactedSizesReadback = mResourceProducer->NewBuffer(
+                HAL::BufferProperties::Create<uint64_t>(RTASManager::MaxSizeQueriesPerFrame), Memory::GPUResource::AccessStrategy::DirectReadback);
+
+            mCompactedSizesReadback->SetDebugName("BLAS Compacted Sizes");
+        }
+    }
+
+    void BottomRTASWorkRecorder::EndFrame()
+    {
+        if (mGPUEventID)
+            mGPUMilliseconds = mGPUProfiler->GetCompletedEvent(*mGPUEventID).DurationSeconds * 1000.0f;
+    }
+
+    RTASManager::WorkRecorder::StructureDescription BottomRTASWorkRecorder::DescribeStructure(uint64_t key) const
+    {
+        const BottomRTAS* blas = Structure(key);
+
+        return { blas->BuildGeneration(), blas->ScratchSize(), blas->AccelerationStructureBuffer()->Capacity(), blas->AllowsCompaction(), blas->HoldsRecordedBuild() };
+    }
+
+    void BottomRTASWorkRecorder::AllocateScratchArena(uint64_t size)
+    {
+        if (mScratchArena && mScratchArena->Capacity() >= size)
+            return;
+
+        HAL::BufferProperties properties{ size, 1, HAL::ResourceState::UnorderedAccess };
+        mScratchArena = mResourceProducer->NewBuffer(properties);
+        mScratchArena->SetDebugName("BLAS Build Scratch Arena");
+    }
+
+    void BottomRTASWorkRecorder::RecordScratchArenaBarrier()
+    {
+        mCommandList->InsertBarrier(HAL::UnorderedAccessResourceBarrier{ mScratchArena->HALBuffer() });
+    }
+
+    void BottomRTASWorkRecorder::RecordBuild(uint64_t key, uint64_t scratchOffset)
+    {
+        BottomRTAS* blas = Structure(key);
+
+        mCommandList->BuildRaytracingAccelerationStructure(blas->HALAccelerationStructure(), *mScratchArena->HALBuffer(), scratchOffset);
+        blas->NotifyBuildRecorded();
+    }
+
+    void BottomRTASWorkRecorder::RecordCompaction(uint64_t key, uint64_t compactedSize)
+    {
+        BottomRTAS* blas = Structure(key);
+
+        HAL::BufferProperties properties{ compactedSize, 1, HAL::ResourceState::RaytracingAccelerationStructure, HAL::ResourceState::UnorderedAccess };
+        Memory::GPUResourceProducer::BufferPtr compactedBuffer = mResourceProducer->NewBuffer(properties);
+
+        mCommandList->CompactRaytracingAccelerationStructure(*blas->AccelerationStructureBuffer()->HALBuffer(), *compactedBuffer->HALBuffer());
+        blas->ReplaceWithCompactedCopy(std::move(compactedBuffer));
+    }
+
+    void BottomRTASWorkRecorder::RecordCompactedSizeQueries(const std::vector<uint64_t>& keys)
+    {
+        std::vector<const HAL::Buffer*> structureBuffers;
+        structureBuffers.reserve(keys.size());
+
+        for (uint64_t key : keys)
+        {
+            structureBuffers.push_back(Structure(key)->AccelerationStructureBuffer()->HALBuffer());
+        }
+
+        const HAL::Buffer& compactedSizes = *mCompactedSizes->HALBuffer();
+
+        mCommandList->EmitRaytracingAccelerationStructureCompactedSizes(structureBuffers, compactedSizes, 0);
+        mCommandList->InsertBarriers(mStateTracker->TransitionToStateImmediately(&compactedSizes, HAL::ResourceState::CopySource));
+        mCommandList->CopyBufferRegion(compactedSizes, *mCompactedSizesReadback->HALBuffer(), 0, structureBuffers.size() * sizeof(uint64_t), 0);
+        mCommandList->InsertBarriers(mStateTracker->TransitionToStateImmediately(&compactedSizes, HAL::ResourceState::UnorderedAccess));
+    }
+
+    void BottomRTASWorkRecorder::RecordStructureBarriers(const std::vector<uint64_t>& keys)
+    {
+        HAL::ResourceBarrierCollection bottomRTASUABarriers{};
+
+        for (uint64_t key : keys)
+        {
+            bottomRTASUABarriers.AddBarrier(Structure(key)->UABarrier());
+        }
+
+        mCommandList->InsertBarriers(bottomRTASUABarriers);
+    }
+
+    void BottomRTASWorkRecorder::ReadCompactedSizes(const std::function<void(const uint64_t*)>& callback)
+    {
+        // Readback buffer is allocated every frame, so the freshest completed one belongs to the completed frame
+        mCompactedSizesReadback->Read<uint64_t>(callback);
+    }
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "BottomRTAS.hpp"
+#include "RTASManager.hpp"
+#include "GPUProfiler.hpp"
+
+#include <Memory/GPUResourceProducer.hpp>
+#include <Memory/ResourceStateTracker.hpp>
+#include <HardwareAbstractionLayer/CommandList.hpp>
+
+#include <optional>
+
+namespace PathFinder
+{
+
+    /// Records work planned by RTASManager into a compute command list. Structure keys are BottomRTAS addresses,
+    /// so structures must outlive the manager or at least stay unused once destroyed.
+    class BottomRTASWorkRecorder : public RTASManager::WorkRecorder
+    {
+    public:
+        BottomRTASWorkRecorder(Memory::GPUResourceProducer* resourceProducer, Memory::ResourceStateTracker* stateTracker, GPUProfiler* gpuProfiler);
+
+        static uint64_t StructureKey(const BottomRTAS* blas);
+
+        // Manager work of a frame is recorded in between
+        void BeginRecording(HAL::ComputeCommandList& cmdList, uint64_t queueIndex);
+        void EndRecording();
+
+        // Must be called after resource producer and GPU profiler frame notifications
+        void BeginFrame();
+        void EndFrame();
+
+        StructureDescription DescribeStructure(uint64_t key) const override;
+        void AllocateScratchArena(uint64_t size) override;
+        void RecordScratchArenaBarrier() override;
+        void RecordBuild(uint64_t key, uint64_t scratchOffset) override;
+        void RecordCompaction(uint64_t key, uint64_t compactedSize) override;
+        void RecordCompactedSizeQueries(const std::vector<uint64_t>& keys) override;
+        void RecordStructureBarriers(const std::vector<uint64_t>& keys) override;
+        void ReadCompactedSizes(const std::function<void(const uint64_t*)>& callback) override;
+
+    private:
+        static BottomRTAS* Structure(uint64_t key);
+
+        Memory::GPUResourceProducer* mResourceProducer;
+        Memory::ResourceStateTracker* mStateTracker;
+        GPUProfiler* mGPUProfiler;
+
+        HAL::ComputeCommandList* mCommandList = nullptr;
+
+        Memory::GPUResourceProducer::BufferPtr mScratchArena;
+        Memory::GPUResourceProducer::BufferPtr mCompactedSizes;
+        Memory::GPUResourceProducer::BufferPtr mCompactedSizesReadback;
+
+        std::optional<GPUProfiler::EventID> mGPUEventID;
+        // Measured for the latest completed frame
+        float mGPUMilliseconds = 0.0f;
+
+    public:
+        inline float GPUMilliseconds() const { return mGPUMilliseconds; }
+    };
+
+}
@@ -28,6 +28,16 @@ namespace PathFinder
                 barriers = stateTracker.TransitionToStatesImmediately(copyRequest.Resource, prevStates);
                 postCopyTransisions.AddBarriers(barriers);
             }
+
+            if (copyRequest.SourceResource)
+            {
+                const Memory::ResourceStateTracker::SubresourceStateList prevSourceStates = stateTracker.ResourceCurrentStates(copyRequest.SourceResource);
+
+                preCopyTransisions.AddBarriers(stateTracker.TransitionToStateImmediately(copyRequest.SourceResource, HAL::ResourceState::CopySource));
+                
+                // Source is still in use until relocation finishes and has to be returned in any case
+                postCopyTransisions.AddBarriers(stateTracker.TransitionToStatesImmediately(copyRequest.SourceResource, prevSourceStates));
+            }
         }
 
         cmdList.InsertBarriers(preCopyTransisions);
@@ -27,6 +27,7 @@ namespace PathFinder
 
         mEventInfos[index].IsStarted = true;
         mEventInfos[index].TickFrequency = mPerQueueTimestampFrequencies[queueIndex];
+        mEventInfos[index].QueueIndex = queueIndex;
 
         auto [start, end] = GetEventIndicesInHeap(index);
         cmdList.EndQuery(mQueryHeap, start);
@@ -80,6 +81,8 @@ namespace PathFinder
             if (!ticks)
                 return;
 
+            mCompletedFrameNumber = frameNumber;
+
             for (uint64_t eventIdx = 0; eventIdx < requestedEventCount; ++eventIdx)
             {
                 uint64_t eventStartIndexInHeap = eventIdx * 2;
@@ -95,6 +98,9 @@ namespace PathFinder
                 //assert_format(endTick >= startTick, "Profiler ticks are messed up");
 
                 event.DurationSeconds = float(endTick - startTick) / eventInfo.TickFrequency;
+                event.StartTimestamp = startTick;
+                event.EndTimestamp = endTick;
+                event.QueueIndex = eventInfo.QueueIndex;
 
                 eventInfo.IsStarted = false;
                 eventInfo.IsCompleted = false;
@@ -17,6 +17,9 @@ namespace PathFinder
         struct Event
         {
             float DurationSeconds;
+            uint64_t StartTimestamp = 0;
+            uint64_t EndTimestamp = 0;
+            uint64_t QueueIndex = 0;
         };
 
         GPUProfiler(const HAL::Device& device, uint64_t maxEventsPerFrame, uint64_t simultaneousFramesInFlight, Memory::GPUResourceProducer* resourceProducer);
@@ -35,6 +38,7 @@ namespace PathFinder
             bool IsStarted = false;
             bool IsCompleted = false;
             uint64_t TickFrequency = 1;
+            uint64_t QueueIndex = 0;
         };
 
         std::pair<uint64_t, uint64_t> GetEventIndicesInHeap(EventID id) const;
@@ -49,8 +53,13 @@ namespace PathFinder
         std::vector<EventInfo> mEventInfos;
         uint64_t mSimultaneousFramesInFlight = 1;
         uint64_t mCurrentFrameIndex = 0;
+        uint64_t mCompletedFrameNumber = 0;
         EventID mCurrentFrameEventID = 0;
         std::mutex mAccessMutex;
+
+    public:
+        // Frame that completed events were measured in, 0 until the first readback
+        inline uint64_t CompletedFrameNumber() const { return mCompletedFrameNumber; }
     };
 
 }
@@ -0,0 +1,285 @@
+#include "PipelineMeasurementStorage.hpp"
+
+#include <Foundation/Assert.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <cmath>
+
+namespace PathFinder
+{
+
+    PipelineMeasurementStorage::PipelineMeasurementStorage(uint64_t historyLength, float spikeDeviationThreshold, float spikeMinRelativeIncrease)
+        : mHistoryLength{ historyLength },
+        mSpikeDeviationThreshold{ spikeDeviationThreshold },
+        mSpikeMinRelativeIncrease{ spikeMinRelativeIncrease }
+    {
+        assert_format(historyLength > 1, "History should contain at least 2 samples");
+        mSortScratch.resize(historyLength);
+    }
+
+    void PipelineMeasurementStorage::BeginFrame()
+    {
+        ++mFrameNumber;
+
+        std::fill(mQueueWorkAccumulators.begin(), mQueueWorkAccumulators.end(), 0.0f);
+        std::fill(mQueueBarrierAccumulators.begin(), mQueueBarrierAccumulators.end(), 0.0f);
+    }
+
+    void PipelineMeasurementStorage::AddPassWorkSample(Foundation::Name passName, uint64_t queueIndex, float durationSeconds)
+    {
+        if (queueIndex >= mQueueWorkAccumulators.size())
+        {
+            mQueueWorkAccumulators.resize(queueIndex + 1, 0.0f);
+            mQueueBarrierAccumulators.resize(queueIndex + 1, 0.0f);
+        }
+
+        mQueueWorkAccumulators[queueIndex] += durationSeconds;
+        AddSample(GetOrCreateSeries(passName, MeasurementType::PassWork, queueIndex), durationSeconds);
+    }
+
+    void PipelineMeasurementStorage::AddBarrierSample(uint64_t queueIndex, float durationSeconds, std::optional<Foundation::Name> passName)
+    {
+        if (queueIndex >= mQueueBarrierAccumulators.size())
+        {
+            mQueueWorkAccumulators.resize(queueIndex + 1, 0.0f);
+            mQueueBarrierAccumulators.resize(queueIndex + 1, 0.0f);
+        }
+
+        mQueueBarrierAccumulators[queueIndex] += durationSeconds;
+
+        if (!passName)
+            return;
+
+        Series& series = GetOrCreateSeries(*passName, MeasurementType::PassBarriers, queueIndex);
+
+        // A pass can have barriers both before and after its work. Sum them into a single per-frame sample.
+        if (series.LastUpdateFrame == mFrameNumber && series.WriteIndex > 0)
+        {
+            float& lastSample = series.Samples[(series.WriteIndex - 1) % mHistoryLength];
+            series.Sum -= lastSample;
+            series.SumOfSquares -= double(lastSample) * lastSample;
+            lastSample += durationSeconds;
+            series.Sum += lastSample;
+            series.SumOfSquares += double(lastSample) * lastSample;
+            series.Stats.Last = lastSample;
+            return;
+        }
+
+        AddSample(series, durationSeconds);
+    }
+
+    void PipelineMeasurementStorage::AddFrameSample(Foundation::Name name, float durationSeconds)
+    {
+        AddSample(GetOrCreateSeries(name, MeasurementType::Frame, 0), durationSeconds);
+    }
+
+    void PipelineMeasurementStorage::EndFrame()
+    {
+        static const Foundation::Name QueueWorkSeriesName{ "Queue Work" };
+        static const Foundation::Name QueueBarriersSeriesName{ "Queue Barriers" };
+
+        for (auto queueIdx = 0u; queueIdx < mQueueWorkAccumulators.size(); ++queueIdx)
+        {
+            AddSample(GetOrCreateSeries(QueueWorkSeriesName, MeasurementType::QueueWork, queueIdx), mQueueWorkAccumulators[queueIdx]);
+            AddSample(GetOrCreateSeries(QueueBarriersSeriesName, MeasurementType::QueueBarriers, queueIdx), mQueueBarrierAccumulators[queueIdx]);
+        }
+
+        for (Series& series : mSeries)
+        {
+            if (series.LastUpdateFrame == mFrameNumber)
+                UpdateStatistics(series);
+        }
+    }
+
+    const PipelineMeasurementStorage::Series* PipelineMeasurementStorage::GetSeries(Foundation::Name name, MeasurementType type, uint64_t queueIndex) const
+    {
+        auto it = mSeriesIndices.find(SeriesKey(name, type, queueIndex));
+        return it != mSeriesIndices.end() ? &mSeries[it->second] : nullptr;
+    }
+
+    bool PipelineMeasurementStorage::ExportCSV(const std::filesystem::path& path) const
+    {
+        std::ofstream stream{ path, std::ios::out | std::ios::trunc };
+
+        if (!stream.is_open())
+            return false;
+
+        stream << "Name,Type,Queue,Samples,Last (ms),Min (ms),Max (ms),Mean (ms),P50 (ms),P95 (ms),P99 (ms),StdDev (ms),Frame-to-Frame Variance (ms^2)\n";
+        stream.precision(5);
+        stream << std::fixed;
+
+        for (const Series& series : mSeries)
+        {
+            const Statistics& stats = series.Stats;
+
+            stream << "\"" << series.Name.ToString() << "\"," << TypeString(series.Type) << "," << series.QueueIndex << "," << stats.SampleCount << ","
+                << stats.Last * 1e3f << "," << stats.Min * 1e3f << "," << stats.Max * 1e3f << "," << stats.Mean * 1e3f << ","
+                << stats.P50 * 1e3f << "," << stats.P95 * 1e3f << "," << stats.P99 * 1e3f << ","
+                << stats.StandardDeviation * 1e3f << "," << stats.FrameToFrameVariance * 1e6f << "\n";
+        }
+
+        return stream.good();
+    }
+
+    bool PipelineMeasurementStorage::ExportJSON(const std::filesystem::path& path) const
+    {
+        std::ofstream stream{ path, std::ios::out | std::ios::trunc };
+
+        if (!stream.is_open())
+            return false;
+
+        stream.precision(9);
+        stream << "{\"units\":\"seconds\",\"historyLength\":" << mHistoryLength << ",\"series\":[\n";
+
+        for (auto seriesIdx = 0u; seriesIdx < mSeries.size(); ++seriesIdx)
+        {
+            const Series& series = mSeries[seriesIdx];
+            const Statistics& stats = series.Stats;
+
+            stream << "{\"name\":\"" << series.Name.ToString() << "\",\"type\":\"" << TypeString(series.Type) << "\",\"queue\":" << series.QueueIndex
+                << ",\"samples\":" << stats.SampleCount << ",\"last\":" << stats.Last << ",\"min\":" << stats.Min << ",\"max\":" << stats.Max
+                << ",\"mean\":" << stats.Mean << ",\"p50\":" << stats.P50 << ",\"p95\":" << stats.P95 << ",\"p99\":" << stats.P99
+                << ",\"stdDev\":" << stats.StandardDeviation << ",\"frameToFrameVariance\":" << stats.FrameToFrameVariance
+                << ",\"history\":[";
+
+            // Write history in chronological order
+            uint64_t count = std::min(series.WriteIndex, mHistoryLength);
+            uint64_t first = series.WriteIndex - count;
+
+            for (uint64_t i = first; i < series.WriteIndex; ++i)
+            {
+                stream << (i != first ? "," : "") << series.Samples[i % mHistoryLength];
+            }
+
+            stream << "]}" << (seriesIdx + 1 < mSeries.size() ? ",\n" : "\n");
+        }
+
+        stream << "]}\n";
+
+        return stream.good();
+    }
+
+    uint64_t PipelineMeasurementStorage::SeriesKey(Foundation::Name name, MeasurementType type, uint64_t queueIndex) const
+    {
+        return (uint64_t(name.ToId()) << 32) | (uint64_t(type) << 16) | (queueIndex & 0xFFFF);
+    }
+
+    PipelineMeasurementStorage::Series& PipelineMeasurementStorage::GetOrCreateSeries(Foundation::Name name, MeasurementType type, uint64_t queueIndex)
+    {
+        uint64_t key = SeriesKey(name, type, queueIndex);
+        auto it = mSeriesIndices.find(key);
+
+        if (it != mSeriesIndices.end())
+            return mSeries[it->second];
+
+        mSeriesIndices[key] = mSeries.size();
+
+        Series& series = mSeries.emplace_back();
+        series.Name = name;
+        series.Type = type;
+        series.QueueIndex = queueIndex;
+        series.Samples.resize(mHistoryLength, 0.0f);
+
+        return series;
+    }
+
+    void PipelineMeasurementStorage::AddSample(Series& series, float durationSeconds)
+    {
+        // Evaluate spike against history that doesn't yet contain the new sample
+        constexpr uint64_t MinSamplesForSpikeDetection = 16;
+
+        Statistics& stats = series.Stats;
+
+        stats.IsSpike = stats.SampleCount >= MinSamplesForSpikeDetection &&
+            durationSeconds > stats.Mean + mSpikeDeviationThreshold * stats.StandardDeviation &&
+            durationSeconds > stats.Mean * (1.0f + mSpikeMinRelativeIncrease);
+
+        uint64_t slot = series.WriteIndex % mHistoryLength;
+
+        // Evict oldest sample from running sums when ring is full
+        if (series.WriteIndex >= mHistoryLength)
+        {
+            float evicted = series.Samples[slot];
+            series.Sum -= evicted;
+            series.SumOfSquares -= double(evicted) * evicted;
+        }
+
+        series.Samples[slot] = durationSeconds;
+        series.Sum += durationSeconds;
+        series.SumOfSquares += double(durationSeconds) * durationSeconds;
+        series.WriteIndex++;
+        series.LastUpdateFrame = mFrameNumber;
+
+        stats.Last = durationSeconds;
+        stats.SampleCount = std::min(series.WriteIndex, mHistoryLength);
+    }
+
+    void PipelineMeasurementStorage::UpdateStatistics(Series& series)
+    {
+        Statistics& stats = series.Stats;
+        uint64_t count = stats.SampleCount;
+
+        if (count == 0)
+            return;
+
+        uint64_t first = series.WriteIndex - count;
+
+        double mean = series.Sum / count;
+        double variance = std::max(series.SumOfSquares / count - mean * mean, 0.0);
+
+        stats.Mean = float(mean);
+        stats.StandardDeviation = float(std::sqrt(variance));
+
+        // Frame-to-frame differences in chronological order
+        double deltaSum = 0.0;
+        double deltaSumOfSquares = 0.0;
+
+        for (uint64_t i = first + 1; i < series.WriteIndex; ++i)
+        {
+            double delta = double(series.Samples[i % mHistoryLength]) - series.Samples[(i - 1) % mHistoryLength];
+            deltaSum += delta;
+            deltaSumOfSquares += delta * delta;
+        }
+
+        if (count > 1)
+        {
+            double deltaMean = deltaSum / (count - 1);
+            stats.FrameToFrameVariance = float(std::max(deltaSumOfSquares / (count - 1) - deltaMean * deltaMean, 0.0));
+        }
+
+        // Order statistics on a copy. Ring order doesn't matter here.
+        auto begin = mSortScratch.begin();
+        auto end = begin + count;
+        std::copy(series.Samples.begin(), series.Samples.begin() + count, begin);
+
+        auto percentile = [&](float p) -> float
+        {
+            auto nth = begin + std::min<uint64_t>(uint64_t(p * (count - 1) + 0.5f), count - 1);
+            std::nth_element(begin, nth, end);
+            return *nth;
+        };
+
+        stats.P50 = percentile(0.50f);
+        stats.P95 = percentile(0.95f);
+        stats.P99 = percentile(0.99f);
+
+        auto [minIt, maxIt] = std::minmax_element(begin, end);
+        stats.Min = *minIt;
+        stats.Max = *maxIt;
+    }
+
+    const char* PipelineMeasurementStorage::TypeString(MeasurementType type) const
+    {
+        switch (type)
+        {
+        case MeasurementType::PassWork: return "PassWork";
+        case MeasurementType::PassBarriers: return "PassBarriers";
+        case MeasurementType::QueueWork: return "QueueWork";
+        case MeasurementType::QueueBarriers: return "QueueBarriers";
+        case MeasurementType::Frame: return "Frame";
+        default: return "Unknown";
+        }
+    }
+
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <Foundation/Name.hpp>
+
+#include <robinhood/robin_hood.h>
+
+#include <vector>
+#include <optional>
+#include <filesystem>
+
+namespace PathFinder
+{
+
+    /// Keeps a fixed-size history of GPU measurements per render pass and per queue
+    /// and derives rolling statistics from it. Storage for a series is allocated once,
+    /// when the series is first encountered, after that recording and statistics
+    /// evaluation don't allocate.
+    class PipelineMeasurementStorage
+    {
+    public:
+        enum class MeasurementType : uint8_t
+        {
+            // Work of a particular render pass
+            PassWork,
+            // Barriers executed on behalf of a particular render pass
+            PassBarriers,
+            // Summed render pass work on a queue
+            QueueWork,
+            // Summed barriers on a queue
+            QueueBarriers,
+            // Whole frame
+            Frame
+        };
+
+        struct Statistics
+        {
+            float Last = 0.0f;
+            float Min = 0.0f;
+            float Max = 0.0f;
+            float Mean = 0.0f;
+            float P50 = 0.0f;
+            float P95 = 0.0f;
+            float P99 = 0.0f;
+            float StandardDeviation = 0.0f;
+            // Variance of frame-to-frame differences. Captures jitter that plain variance hides.
+            float FrameToFrameVariance = 0.0f;
+            uint64_t SampleCount = 0;
+            bool IsSpike = false;
+        };
+
+        struct Series
+        {
+            Foundation::Name Name;
+            MeasurementType Type = MeasurementType::PassWork;
+            uint64_t QueueIndex = 0;
+            Statistics Stats;
+            uint64_t LastUpdateFrame = 0;
+
+        private:
+            friend PipelineMeasurementStorage;
+
+            std::vector<float> Samples;
+            uint64_t WriteIndex = 0;
+            double Sum = 0.0;
+            double SumOfSquares = 0.0;
+        };
+
+        PipelineMeasurementStorage(uint64_t historyLength = 256, float spikeDeviationThreshold = 4.0f, float spikeMinRelativeIncrease = 0.25f);
+
+        void BeginFrame();
+        void AddPassWorkSample(Foundation::Name passName, uint64_t queueIndex, float durationSeconds);
+        void AddBarrierSample(uint64_t queueIndex, float durationSeconds, std::optional<Foundation::Name> passName = std::nullopt);
+        void AddFrameSample(Foundation::Name name, float durationSeconds);
+        void EndFrame();
+
+        const Series* GetSeries(Foundation::Name name, MeasurementType type, uint64_t queueIndex = 0) const;
+
+        bool ExportCSV(const std::filesystem::path& path) const;
+        bool ExportJSON(const std::filesystem::path& path) const;
+
+    private:
+        uint64_t SeriesKey(Foundation::Name name, MeasurementType type, uint64_t queueIndex) const;
+        Series& GetOrCreateSeries(Foundation::Name name, MeasurementType type, uint64_t queueIndex);
+        void AddSample(Series& series, float durationSeconds);
+        void UpdateStatistics(Series& series);
+        const char* TypeString(MeasurementType type) const;
+
+        uint64_t mHistoryLength;
+        float mSpikeDeviationThreshold;
+        float mSpikeMinRelativeIncrease;
+        uint64_t mFrameNumber = 0;
+
+        std::vector<Series> mSeries;
+        robin_hood::unordered_flat_map<uint64_t, uint64_t> mSeriesIndices;
+
+        // Scratch memory for order statistics, sized to history length once
+        std::vector<float> mSortScratch;
+
+        // Per-queue accumulators for the frame in flight
+        std::vector<float> mQueueWorkAccumulators;
+        std::vector<float> mQueueBarrierAccumulators;
+
+    public:
+        inline const auto& AllSeries() const { return mSeries; }
+        inline auto HistoryLength() const { return mHistoryLength; }
+    };
+
+}
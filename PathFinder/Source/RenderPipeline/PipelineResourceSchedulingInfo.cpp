@@ -6,6 +6,12 @@ namespace PathFinder
     PipelineResourceSchedulingInfo::PipelineResourceSchedulingInfo(Foundation::Name resourceName, const HAL::ResourceFormat& format)
         : mResourceFormat{ format }, mResourceName{ resourceName }, mCombinedResourceNames{ resourceName.ToString() }, mSubresourceCount{ format.SubresourceCount() }
     {
+        bool isTextureArray =
+            std::holds_alternative<HAL::TextureProperties>(format.ResourceProperties()) &&
+            format.D3DResourceDescription().Dimension != D3D12_RESOURCE_DIMENSION_TEXTURE3D &&
+            format.D3DResourceDescription().DepthOrArraySize > 1;
+
+        assert_format(!isTextureArray, "Texture arrays are not supported by render graph scheduling currently. Add proper handling of texture array scheduling first, then remove this assert.");
     }
 
     void PipelineResourceSchedulingInfo::AddExpectedStates(HAL::ResourceState states)
@@ -61,4 +67,30 @@ namespace PathFinder
         mExpectedStates |= state;
     }
 
+    uint64_t PipelineResourceSchedulingInfo::ScheduledStatesHash() const
+    {
+        uint64_t hash = robin_hood::hash_int(mResourceName.ToId());
+
+        for (const auto& [passName, passInfo] : mPassInfoMap)
+        {
+            // Fold words one by one so that hashing doesn't allocate
+            uint64_t passHash = robin_hood::hash_int(passName.ToId());
+            auto fold = [&passHash](uint64_t word) { passHash = robin_hood::hash_int(passHash ^ word); };
+
+            fold(passInfo.NeedsUnorderedAccessBarrier);
+            fold(passInfo.NeedsAliasingBarrier);
+            fold(passInfo.IsReadbackRequested);
+
+            for (const std::optional<SubresourceInfo>& subresourceInfo : passInfo.SubresourceInfos)
+            {
+                fold(subresourceInfo ? uint64_t(subresourceInfo->RequestedState) : std::numeric_limits<uint64_t>::max());
+            }
+
+            // Pass infos are unordered, so combine them in an order-independent way
+            hash += passHash;
+        }
+
+        return hash;
+    }
+
 }
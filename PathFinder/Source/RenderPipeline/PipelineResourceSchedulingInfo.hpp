@@ -54,6 +54,9 @@ namespace PathFinder
             std::optional<HAL::ColorFormat> shaderVisibleFormat = std::nullopt
         );
 
+        // Hash of per-pass requested states and barrier flags, i.e. of everything resource transitions are derived from
+        uint64_t ScheduledStatesHash() const;
+
         uint64_t HeapOffset = 0;
         bool CanBeAliased = true;
         bool WasAliased = false;
@@ -0,0 +1,32 @@
+#include "PipelineResourceSchedulingRequests.hpp"
+
+namespace PathFinder
+{
+
+    void PipelineResourceSchedulingRequests::Clear()
+    {
+        Creations.clear();
+        Requests.clear();
+        ExplicitMips.clear();
+        RequestedQueue = std::nullopt;
+        WritesToBackBuffer = false;
+        UsesRayTracing = false;
+        IsRecorded = false;
+    }
+
+    bool PipelineResourceSchedulingRequests::IsCreation(const Request& request)
+    {
+        switch (request.Type)
+        {
+        case RequestType::NewRenderTarget:
+        case RequestType::NewDepthStencil:
+        case RequestType::NewTexture:
+        case RequestType::NewBuffer:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+}
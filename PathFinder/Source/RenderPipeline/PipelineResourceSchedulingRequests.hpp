@@ -0,0 +1,77 @@
+#pragma once
+
+#include <Foundation/Name.hpp>
+#include <HardwareAbstractionLayer/ResourceState.hpp>
+#include <HardwareAbstractionLayer/ResourceFormat.hpp>
+
+#include "RenderPassMetadata.hpp"
+
+#include <vector>
+#include <optional>
+#include <limits>
+
+namespace PathFinder
+{
+
+    /// Resource requests of a single render pass as recorded by ResourceScheduler.
+    /// Requests are plain values, so passes can record them on any thread and the engine
+    /// can merge them into resource scheduling infos later, in pass order, without closures.
+    /// Containers keep their capacity between frames, so recording doesn't allocate in steady state.
+    struct PipelineResourceSchedulingRequests
+    {
+        enum class RequestType : uint8_t
+        {
+            NewRenderTarget, NewDepthStencil, NewTexture, NewBuffer,
+            UseRenderTarget, UseDepthStencil, ReadTexture, WriteTexture, Export
+        };
+
+        enum class MipSelection : uint8_t
+        {
+            None, Explicit, Range, IndexFromStart, IndexFromEnd
+        };
+
+        struct Mips
+        {
+            inline static const uint32_t LastMip = std::numeric_limits<uint32_t>::max();
+
+            MipSelection Selection = MipSelection::None;
+            // Mip range bounds, mip index for single mip selections
+            // or offset and count in ExplicitMips for explicit mip lists
+            uint32_t First = 0;
+            uint32_t Last = 0;
+        };
+
+        struct Request
+        {
+            Foundation::Name ResourceName;
+            Foundation::Name OutputAliasName;
+            Mips SubresourceMips;
+            std::optional<HAL::ColorFormat> ConcreteFormat;
+            // Base state of read requests, depth read state is added for depth-stencil textures on merge
+            HAL::ResourceState ReadState = HAL::ResourceState::Common;
+            RequestType Type = RequestType::ReadTexture;
+            bool CanBeReadAcrossFrames = false;
+        };
+
+        struct Creation
+        {
+            HAL::ResourcePropertiesVariant Properties;
+            Foundation::Name ResourceName;
+            std::optional<Foundation::Name> PropertyCopySourceName;
+        };
+
+        void Clear();
+        static bool IsCreation(const Request& request);
+
+        std::vector<Creation> Creations;
+        std::vector<Request> Requests;
+        std::vector<uint32_t> ExplicitMips;
+        std::optional<RenderPassExecutionQueue> RequestedQueue;
+        bool WritesToBackBuffer = false;
+        bool UsesRayTracing = false;
+
+        // Requests of passes with frame-invariant scheduling are recorded once and reused
+        bool IsRecorded = false;
+    };
+
+}
@@ -16,11 +16,13 @@ namespace PathFinder
         Memory::GPUResourceProducer* resourceProducer,
         Memory::PoolDescriptorAllocator* descriptorAllocator,
         Memory::ResourceStateTracker* stateTracker,
+        Memory::TransientHeapPool* transientHeapPool,
         const RenderSurfaceDescription& defaultRenderSurface,
         const RenderPassGraph* passExecutionGraph)
         :
         mDevice{ device },
         mResourceStateTracker{ stateTracker },
+        mTransientHeapPool{ transientHeapPool },
         mRTDSMemoryAliaser{ passExecutionGraph },
         mNonRTDSMemoryAliaser{ passExecutionGraph },
         mUniversalMemoryAliaser{ passExecutionGraph },
@@ -99,11 +101,13 @@ namespace PathFinder
         return mMemoryLayoutChanged;
     }
 
+    uint64_t PipelineResourceStorage::MemoryLayoutVersion() const
+    {
+        return mMemoryLayoutVersion;
+    }
+
     void PipelineResourceStorage::StartResourceScheduling()
     {
-        mSchedulingCreationRequests.clear();
-        mSchedulingUsageRequests.clear();
-        mSchedulingReadbackRequests.clear();
         mPrimaryResourceCreationRequests.clear();
         mSecondaryResourceCreationRequests.clear();
         mAliasMap.clear();
@@ -164,34 +168,6 @@ namespace PathFinder
                 resourceData.SchedulingInfo.AddNameAlias(alias);
             }
         }
-
-        // Run scheduling creation callbacks
-        for (SchedulingRequest& request : mSchedulingCreationRequests)
-        {
-            uint64_t resourceDataIndex = mCurrentFrameResourceMap->at(request.ResourceName);
-            PipelineResourceStorageResource& resourceData = mCurrentFrameResources->at(resourceDataIndex);
-            request.Configurator(resourceData.SchedulingInfo);
-        }
-
-        // Run scheduling usage callbacks
-        for (SchedulingRequest& request : mSchedulingUsageRequests)
-        {
-            auto indexIt = mCurrentFrameResourceMap->find(request.ResourceName);
-            assert_format(indexIt != mCurrentFrameResourceMap->end(), request.PassName.ToString(), " tries to use a resource that wasn't created: ", request.ResourceName.ToString());
-
-            PipelineResourceStorageResource& resourceData = mCurrentFrameResources->at(indexIt->second);
-            request.Configurator(resourceData.SchedulingInfo);
-        }
-
-        // Run scheduling readback callbacks
-        for (SchedulingRequest& request : mSchedulingReadbackRequests)
-        {
-            auto indexIt = mCurrentFrameResourceMap->find(request.ResourceName);
-            assert_format(indexIt != mCurrentFrameResourceMap->end(), request.PassName.ToString(), " tries to readback a resource that wasn't created: ", request.ResourceName.ToString());
-
-            PipelineResourceStorageResource& resourceData = mCurrentFrameResources->at(indexIt->second);
-            request.Configurator(resourceData.SchedulingInfo);
-        }
     }
 
     void PipelineResourceStorage::OptimizeScheduledResourceStates(const RenderPassGraph& passGraph)
@@ -298,25 +274,42 @@ namespace PathFinder
         {
             // Re-alias memory, then reallocate resources only if memory was invalidated
             // which can happen on first run or when resource properties were changed by the user.
+            // Heaps that still fit the new layout are kept by the pool, so resources that
+            // ended up at the same offset in the same heap don't need to be placed again.
             //
-            if (!mRTDSMemoryAliaser.IsEmpty()) mRTDSHeap = std::make_unique<HAL::Heap>(*mDevice, mRTDSMemoryAliaser.Alias(), HAL::HeapAliasingGroup::RTDSTextures);
-            if (!mNonRTDSMemoryAliaser.IsEmpty()) mNonRTDSHeap = std::make_unique<HAL::Heap>(*mDevice, mNonRTDSMemoryAliaser.Alias(), HAL::HeapAliasingGroup::NonRTDSTextures);
-            if (!mBufferMemoryAliaser.IsEmpty()) mBufferHeap = std::make_unique<HAL::Heap>(*mDevice, mBufferMemoryAliaser.Alias(), HAL::HeapAliasingGroup::Buffers);
-            if (!mUniversalMemoryAliaser.IsEmpty()) mUniversalHeap = std::make_unique<HAL::Heap>(*mDevice, mUniversalMemoryAliaser.Alias(), HAL::HeapAliasingGroup::Universal);
+            if (!mRTDSMemoryAliaser.IsEmpty()) mRTDSHeap = mTransientHeapPool->AcquireHeap(HAL::HeapAliasingGroup::RTDSTextures, mRTDSMemoryAliaser.Alias());
+            if (!mNonRTDSMemoryAliaser.IsEmpty()) mNonRTDSHeap = mTransientHeapPool->AcquireHeap(HAL::HeapAliasingGroup::NonRTDSTextures, mNonRTDSMemoryAliaser.Alias());
+            if (!mBufferMemoryAliaser.IsEmpty()) mBufferHeap = mTransientHeapPool->AcquireHeap(HAL::HeapAliasingGroup::Buffers, mBufferMemoryAliaser.Alias());
+            if (!mUniversalMemoryAliaser.IsEmpty()) mUniversalHeap = mTransientHeapPool->AcquireHeap(HAL::HeapAliasingGroup::Universal, mUniversalMemoryAliaser.Alias());
 
             for (PipelineResourceStorageResource& resourceData : *mCurrentFrameResources)
             {
+                const HAL::ResourceFormat& format = resourceData.SchedulingInfo.ResourceFormat();
+                HAL::Heap* heap = GetHeapForAliasingGroup(format.ResourceAliasingGroup());
+
                 // A case when resource is already allocated, but did not and will not participate in aliasing
                 bool isAllocationRedundant =
                     resourceData.GetGPUResource() &&
                     !resourceData.SchedulingInfo.WasAliased &&
                     !resourceData.SchedulingInfo.CanBeAliased;
 
-                if (isAllocationRedundant)
+                // A case when aliased resource is unchanged and aliasing put it at the same place again
+                bool isPlacementValid =
+                    resourceData.GetGPUResource() &&
+                    resourceData.SchedulingInfo.WasAliased &&
+                    resourceData.SchedulingInfo.CanBeAliased &&
+                    resourceData.PlacementHeap == heap &&
+                    resourceData.PlacementHeapOffset == resourceData.SchedulingInfo.HeapOffset;
+
+                if (isAllocationRedundant || isPlacementValid)
                     continue;
 
-                const HAL::ResourceFormat& format = resourceData.SchedulingInfo.ResourceFormat();
-                HAL::Heap* heap = GetHeapForAliasingGroup(format.ResourceAliasingGroup());
+                // Frames in flight could still reference the resource
+                mTransientHeapPool->RetireResource(std::move(resourceData.Texture));
+                mTransientHeapPool->RetireResource(std::move(resourceData.Buffer));
+
+                resourceData.PlacementHeap = resourceData.SchedulingInfo.CanBeAliased ? heap : nullptr;
+                resourceData.PlacementHeapOffset = resourceData.SchedulingInfo.HeapOffset;
 
                 std::visit(Foundation::MakeVisitor(
                     [&resourceData, heap, this](const HAL::TextureProperties& textureProps)
@@ -337,18 +330,37 @@ namespace PathFinder
                     }),
                     format.ResourceProperties());
             }
+
+            // Resources of the previous layout that weren't transferred are retired as well
+            for (PipelineResourceStorageResource& previousResourceData : *mPreviousFrameResources)
+            {
+                mTransientHeapPool->RetireResource(std::move(previousResourceData.Texture));
+                mTransientHeapPool->RetireResource(std::move(previousResourceData.Buffer));
+            }
         }
+
+        uint64_t scheduledStatesHash = 0;
+
+        for (const PipelineResourceStorageResource& resourceData : *mCurrentFrameResources)
+        {
+            scheduledStatesHash = robin_hood::hash_int(scheduledStatesHash ^ resourceData.SchedulingInfo.ScheduledStatesHash());
+        }
+
+        // Resource pointers or requested states changed, which invalidates anything derived from them
+        if (mMemoryLayoutChanged || scheduledStatesHash != mScheduledStatesHash)
+        {
+            ++mMemoryLayoutVersion;
+        }
+
+        mScheduledStatesHash = scheduledStatesHash;
     }
 
     void PipelineResourceStorage::QueueResourceAllocationIfNeeded(
         PassName passName,
         ResourceName resourceName,
         const HAL::ResourcePropertiesVariant& properties,
-        std::optional<Foundation::Name> propertyCopySourceName,
-        const SchedulingInfoConfigurator& siConfigurator)
+        std::optional<Foundation::Name> propertyCopySourceName)
     {
-        mSchedulingCreationRequests.emplace_back(SchedulingRequest{ siConfigurator, resourceName, passName });
-
         if (propertyCopySourceName)
         {
             mSecondaryResourceCreationRequests.emplace_back(ResourceCreationRequest{ properties, resourceName, *propertyCopySourceName, passName });
@@ -358,21 +370,9 @@ namespace PathFinder
         }
     }
 
-    void PipelineResourceStorage::QueueResourceUsage(PassName passName, ResourceName resourceName, std::optional<ResourceName> aliasName, const SchedulingInfoConfigurator& siConfigurator)
-    {
-        if (aliasName)
-        {
-            mSchedulingUsageRequests.emplace_back(SchedulingRequest{ siConfigurator, *aliasName, passName });
-            mAliasMap[*aliasName] = resourceName;
-        }
-        else {
-            mSchedulingUsageRequests.emplace_back(SchedulingRequest{ siConfigurator, resourceName, passName });
-        }
-    }
-
-    void PipelineResourceStorage::QueueResourceReadback(PassName passName, ResourceName resourceName, const SchedulingInfoConfigurator& siConfigurator)
+    void PipelineResourceStorage::QueueResourceAlias(ResourceName resourceName, ResourceName aliasName)
     {
-        mSchedulingReadbackRequests.push_back(SchedulingRequest{ siConfigurator, resourceName, passName });
+        mAliasMap[aliasName] = resourceName;
     }
 
     void PipelineResourceStorage::AddSampler(Foundation::Name samplerName, const HAL::Sampler& sampler)
@@ -398,10 +398,10 @@ namespace PathFinder
     {
         switch (group)
         {
-        case HAL::HeapAliasingGroup::RTDSTextures: return mRTDSHeap.get(); 
-        case HAL::HeapAliasingGroup::NonRTDSTextures: return mNonRTDSHeap.get(); 
-        case HAL::HeapAliasingGroup::Buffers: return mBufferHeap.get(); 
-        case HAL::HeapAliasingGroup::Universal: return mUniversalHeap.get();
+        case HAL::HeapAliasingGroup::RTDSTextures: return mRTDSHeap; 
+        case HAL::HeapAliasingGroup::NonRTDSTextures: return mNonRTDSHeap; 
+        case HAL::HeapAliasingGroup::Buffers: return mBufferHeap; 
+        case HAL::HeapAliasingGroup::Universal: return mUniversalHeap;
         default: return nullptr;
         }
     }
@@ -443,6 +443,8 @@ namespace PathFinder
                 // Transfer GPU resources from previous frame
                 resourceData.Texture = std::move(prevResourceData.Texture);
                 resourceData.Buffer = std::move(prevResourceData.Buffer);
+                resourceData.PlacementHeap = prevResourceData.PlacementHeap;
+                resourceData.PlacementHeapOffset = prevResourceData.PlacementHeapOffset;
 
                 resourceData.SchedulingInfo.WasAliased = prevResourceData.SchedulingInfo.CanBeAliased;
             }
@@ -14,6 +14,7 @@
 #include <Memory/GPUResourceProducer.hpp>
 #include <Memory/PoolDescriptorAllocator.hpp>
 #include <Memory/ResourceStateTracker.hpp>
+#include <Memory/TransientHeapPool.hpp>
 
 #include <vector>
 #include <functional>
@@ -40,12 +41,12 @@ namespace PathFinder
             Memory::GPUResourceProducer* resourceProducer,
             Memory::PoolDescriptorAllocator* descriptorAllocator,
             Memory::ResourceStateTracker* stateTracker,
+            Memory::TransientHeapPool* transientHeapPool,
             const RenderSurfaceDescription& defaultRenderSurface,
             const RenderPassGraph* passExecutionGraph
         );
 
         using DebugBufferIteratorFunc = std::function<void(PassName passName, const float* debugData)>;
-        using SchedulingInfoConfigurator = std::function<void(PipelineResourceSchedulingInfo&)>;
 
         const HAL::RTDescriptor* GetRenderTargetDescriptor(Foundation::Name resourceName, Foundation::Name passName, uint64_t mipIndex = 0) const;
         const HAL::DSDescriptor* GetDepthStencilDescriptor(Foundation::Name resourceName, Foundation::Name passName) const;
@@ -55,6 +56,9 @@ namespace PathFinder
         void EndFrame();
 
         bool HasMemoryLayoutChange() const;
+
+        // Advances every time resources are reallocated or their scheduled per-pass states change
+        uint64_t MemoryLayoutVersion() const;
         
         PipelineResourceStoragePass& CreatePerPassData(PassName name);
 
@@ -89,11 +93,10 @@ namespace PathFinder
             PassName passName,
             ResourceName resourceName, 
             const HAL::ResourcePropertiesVariant& properties, 
-            std::optional<Foundation::Name> propertyCopySourceName,
-            const SchedulingInfoConfigurator& siConfigurator);
+            std::optional<Foundation::Name> propertyCopySourceName);
 
-        void QueueResourceUsage(PassName passName, ResourceName resourceName, std::optional<ResourceName> aliasName, const SchedulingInfoConfigurator& siConfigurator);
-        void QueueResourceReadback(PassName passName, ResourceName resourceName, const SchedulingInfoConfigurator& siConfigurator);
+        // Makes alias name resolve to the same resource data as the original name once scheduling ends
+        void QueueResourceAlias(ResourceName resourceName, ResourceName aliasName);
         void AddSampler(Foundation::Name samplerName, const HAL::Sampler& sampler);
 
     private:
@@ -112,13 +115,6 @@ namespace PathFinder
             Foundation::Name PassName;
         };
 
-        struct SchedulingRequest
-        {
-            SchedulingInfoConfigurator Configurator;
-            Foundation::Name ResourceName;
-            Foundation::Name PassName;
-        };
-
         PipelineResourceStorageResource& CreatePerResourceData(ResourceName name, const HAL::ResourceFormat& resourceFormat);
         HAL::Heap* GetHeapForAliasingGroup(HAL::HeapAliasingGroup group);
 
@@ -128,12 +124,14 @@ namespace PathFinder
         Memory::GPUResourceProducer* mResourceProducer;
         Memory::PoolDescriptorAllocator* mDescriptorAllocator;
         Memory::ResourceStateTracker* mResourceStateTracker;
+        Memory::TransientHeapPool* mTransientHeapPool;
         const RenderPassGraph* mPassExecutionGraph;
 
-        std::unique_ptr<HAL::Heap> mRTDSHeap;
-        std::unique_ptr<HAL::Heap> mNonRTDSHeap;
-        std::unique_ptr<HAL::Heap> mBufferHeap;
-        std::unique_ptr<HAL::Heap> mUniversalHeap;
+        // Heaps of current memory layout, owned by transient heap pool
+        HAL::Heap* mRTDSHeap = nullptr;
+        HAL::Heap* mNonRTDSHeap = nullptr;
+        HAL::Heap* mBufferHeap = nullptr;
+        HAL::Heap* mUniversalHeap = nullptr;
 
         RenderSurfaceDescription mDefaultRenderSurface;
 
@@ -150,9 +148,6 @@ namespace PathFinder
 
         robin_hood::unordered_node_map<PassName, PipelineResourceStoragePass> mPerPassData;
 
-        std::vector<SchedulingRequest> mSchedulingCreationRequests;
-        std::vector<SchedulingRequest> mSchedulingUsageRequests;
-        std::vector<SchedulingRequest> mSchedulingReadbackRequests;
         std::vector<ResourceCreationRequest> mPrimaryResourceCreationRequests;
         std::vector<ResourceCreationRequest> mSecondaryResourceCreationRequests;
 
@@ -175,6 +170,8 @@ namespace PathFinder
         HAL::ResourceBarrierCollection mReadbackBarriers;
 
         bool mMemoryLayoutChanged = false;
+        uint64_t mMemoryLayoutVersion = 0;
+        uint64_t mScheduledStatesHash = 0;
     };
 
 }
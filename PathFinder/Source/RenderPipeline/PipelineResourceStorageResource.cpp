@@ -4,6 +4,8 @@
 
 #include <Foundation/STDHelpers.hpp>
 
+#include <robinhood/robin_hood.h>
+
 namespace PathFinder
 {
 
@@ -26,11 +28,19 @@ namespace PathFinder
 
     PipelineResourceStorageResource::DiffEntry PipelineResourceStorageResource::GetDiffEntry() const
     {
+        const D3D12_RESOURCE_DESC& description = SchedulingInfo.ResourceFormat().D3DResourceDescription();
+
+        uint64_t descriptionHash = robin_hood::hash_int(description.Width);
+        descriptionHash = robin_hood::hash_int(descriptionHash ^ (uint64_t(description.Height) << 32 | uint64_t(description.DepthOrArraySize) << 16 | description.MipLevels));
+        descriptionHash = robin_hood::hash_int(descriptionHash ^ (uint64_t(description.Format) << 32 | uint64_t(description.Flags)));
+        descriptionHash = robin_hood::hash_int(descriptionHash ^ uint64_t(description.Dimension));
+
         return { 
             mResourceName, 
             SchedulingInfo.CanBeAliased, 
             SchedulingInfo.ExpectedStates(), 
             SchedulingInfo.TotalRequiredMemory(), 
+            descriptionHash,
             SchedulingInfo.AliasingLifetime.first, 
             SchedulingInfo.AliasingLifetime.second 
         };
@@ -38,12 +48,13 @@ namespace PathFinder
 
     bool PipelineResourceStorageResource::DiffEntry::operator==(const DiffEntry& that) const
     {
-        // Pipeline Resource is identified by its name, memory footprint and lifetime,
+        // Pipeline Resource is identified by its name, description, memory footprint and lifetime,
         // which is sufficient to understand when
         // resource allocation, reallocation or deallocation is required.
         bool equal = 
             ResourceName == that.ResourceName &&
             MemoryFootprint == that.MemoryFootprint &&
+            DescriptionHash == that.DescriptionHash &&
             CanBeAliased == that.CanBeAliased &&
             ExpectedStates == that.ExpectedStates;
 
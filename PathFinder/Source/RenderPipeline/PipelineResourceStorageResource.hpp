@@ -29,6 +29,9 @@ namespace PathFinder
             // Compare by total occupied memory
             uint64_t MemoryFootprint = 0;
 
+            // Compare by resource description, since format or layout can change without changing the footprint
+            uint64_t DescriptionHash = 0;
+
             // Compare by lifetimes when aliasing is possible 
             uint64_t LifetimeStart = 0;
             uint64_t LifetimeEnd = 0;
@@ -40,6 +43,10 @@ namespace PathFinder
         Memory::GPUResourceProducer::TexturePtr Texture;
         Memory::GPUResourceProducer::BufferPtr Buffer;
 
+        // Where aliased resource was placed, so that relayouts could skip resources that stay in place
+        const HAL::Heap* PlacementHeap = nullptr;
+        uint64_t PlacementHeapOffset = 0;
+
         const Memory::GPUResource* GetGPUResource() const;
         Memory::GPUResource* GetGPUResource();
 
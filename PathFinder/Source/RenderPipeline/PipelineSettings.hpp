@@ -8,6 +8,14 @@ namespace PathFinder
         bool IsMemoryAliasingEnabled = true;
         bool IsAsyncComputeEnabled = true;
         bool IsSplitBarriersEnabled = true;
+        // Let measured pass timings decide which compute passes go to async compute queue
+        bool IsAutomaticQueueAssignmentEnabled = false;
+        // Record resource requests of render passes on task scheduler threads
+        bool IsParallelResourceSchedulingEnabled = true;
+        // Replay transitions and synchronization of previous frame while graph and resource layout stay the same
+        bool IsFramePlanCachingEnabled = true;
+        // Score planned barrier placement against the legacy one whenever transitions are planned, for the profiler
+        bool IsBarrierPlanScoringEnabled = false;
     };
 
 }
@@ -0,0 +1,129 @@
+#include "PipelineStateCache.hpp"
+
+#include <bitsery/adapter/stream.h>
+#include <bitsery/traits/vector.h>
+
+#include <fstream>
+
+namespace PathFinder
+{
+
+    namespace
+    {
+        struct CacheRecord
+        {
+            uint32_t Version = 0;
+            std::vector<PipelineStateCache::Entry> Entries;
+
+            template <typename S>
+            void serialize(S& s)
+            {
+                s.value4b(Version);
+                s.container(Entries, std::numeric_limits<uint64_t>::max());
+            }
+        };
+    }
+
+    std::optional<std::vector<uint8_t>> PipelineStateCache::Find(uint64_t key) const
+    {
+        std::lock_guard lock{ mMutex };
+
+        auto it = mBlobs.find(key);
+        if (it == mBlobs.end()) return std::nullopt;
+        return it->second.Blob;
+    }
+
+    void PipelineStateCache::Store(uint64_t key, uint64_t owner, std::vector<uint8_t>&& blob)
+    {
+        if (blob.empty())
+            return;
+
+        std::lock_guard lock{ mMutex };
+        Insert(key, owner, std::move(blob));
+        mIsDirty = true;
+    }
+
+    bool PipelineStateCache::Load(const std::filesystem::path& path)
+    {
+        std::fstream stream{ path, std::ios::binary | std::ios::in };
+
+        if (!stream.is_open())
+            return false;
+
+        CacheRecord record;
+        bitsery::Deserializer<bitsery::InputStreamAdapter> des{ stream };
+        des.object(record);
+
+        if (des.adapter().error() != bitsery::ReaderError::NoError || record.Version != CacheVersion)
+            return false;
+
+        std::lock_guard lock{ mMutex };
+
+        for (Entry& entry : record.Entries)
+        {
+            Insert(entry.Key, entry.Owner, std::move(entry.Blob));
+        }
+
+        return true;
+    }
+
+    bool PipelineStateCache::Save(const std::filesystem::path& path)
+    {
+        CacheRecord record{ CacheVersion };
+
+        {
+            std::lock_guard lock{ mMutex };
+
+            record.Entries.reserve(mBlobs.size());
+
+            for (const auto& [key, ownedBlob] : mBlobs)
+            {
+                record.Entries.push_back(Entry{ key, ownedBlob.Owner, ownedBlob.Blob });
+            }
+
+            mIsDirty = false;
+        }
+
+        std::fstream stream{ path, std::ios::binary | std::ios::trunc | std::ios::out };
+
+        if (!stream.is_open())
+            return false;
+
+        bitsery::Serializer<bitsery::OutputBufferedStreamAdapter> ser{ stream };
+        ser.object(record);
+        ser.adapter().flush();
+
+        return stream.good();
+    }
+
+    bool PipelineStateCache::IsDirty() const
+    {
+        std::lock_guard lock{ mMutex };
+        return mIsDirty;
+    }
+
+    void PipelineStateCache::Insert(uint64_t key, uint64_t owner, std::vector<uint8_t>&& blob)
+    {
+        auto [ownerIt, isNewOwner] = mOwnerKeys.insert({ owner, key });
+
+        if (!isNewOwner && ownerIt->second != key)
+        {
+            // Identical states share a key, so the blob is evicted only by the state that stored it last
+            auto previousIt = mBlobs.find(ownerIt->second);
+
+            if (previousIt != mBlobs.end() && previousIt->second.Owner == owner)
+                mBlobs.erase(previousIt);
+
+            ownerIt->second = key;
+        }
+
+        mBlobs[key] = OwnedBlob{ owner, std::move(blob) };
+    }
+
+    uint64_t PipelineStateCache::CombineHashes(uint64_t hash, uint64_t otherHash)
+    {
+        uint64_t hashes[2] = { hash, otherHash };
+        return robin_hood::hash_bytes(hashes, sizeof(hashes));
+    }
+
+}
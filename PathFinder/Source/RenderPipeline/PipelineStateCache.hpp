@@ -0,0 +1,64 @@
+#pragma once
+
+#include <robinhood/robin_hood.h>
+#include <bitsery/bitsery.h>
+
+#include <vector>
+#include <optional>
+#include <filesystem>
+#include <mutex>
+
+namespace PathFinder
+{
+
+    /// Thread safe storage of driver blobs of compiled graphics and compute pipeline states persisted between runs.
+    /// Blobs are keyed by a hash of the state description combined with hashes of the serialized root signature
+    /// and bytecode of every shader in the state, so editing a shader produces a new key.
+    /// Every blob belongs to a state and storing a new one for it evicts the old one, keeping at most one blob per state.
+    class PipelineStateCache
+    {
+    public:
+        inline static const uint32_t CacheVersion = 2;
+
+        struct Entry
+        {
+            uint64_t Key = 0;
+            // Identifies the state the blob was compiled for, stable between runs
+            uint64_t Owner = 0;
+            std::vector<uint8_t> Blob;
+
+            template <typename S>
+            void serialize(S& s)
+            {
+                s.value8b(Key);
+                s.value8b(Owner);
+                s.container1b(Blob, std::numeric_limits<uint64_t>::max());
+            }
+        };
+
+        std::optional<std::vector<uint8_t>> Find(uint64_t key) const;
+        // Replaces the blob previously stored for the owner
+        void Store(uint64_t key, uint64_t owner, std::vector<uint8_t>&& blob);
+
+        bool Load(const std::filesystem::path& path);
+        bool Save(const std::filesystem::path& path);
+        bool IsDirty() const;
+
+        static uint64_t CombineHashes(uint64_t hash, uint64_t otherHash);
+
+    private:
+        struct OwnedBlob
+        {
+            uint64_t Owner = 0;
+            std::vector<uint8_t> Blob;
+        };
+
+        void Insert(uint64_t key, uint64_t owner, std::vector<uint8_t>&& blob);
+
+        robin_hood::unordered_node_map<uint64_t, OwnedBlob> mBlobs;
+        robin_hood::unordered_flat_map<uint64_t, uint64_t> mOwnerKeys;
+        mutable std::mutex mMutex;
+        bool mIsDirty = false;
+    };
+
+}
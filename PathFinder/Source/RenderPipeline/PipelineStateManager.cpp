@@ -1,22 +1,38 @@
 #include "PipelineStateManager.hpp"
 
+#include <Foundation/TaskScheduler.hpp>
 
+#include <fstream>
+#include <chrono>
+#include <algorithm>
 
 namespace PathFinder
 {
 
+    namespace
+    {
+        // Names are interned in creation order, so hash their strings to stay stable between runs
+        uint64_t StateNameHash(Foundation::Name name)
+        {
+            std::string string = name.ToString();
+            return robin_hood::hash_bytes(string.data(), string.size());
+        }
+    }
+
     PipelineStateManager::PipelineStateManager(
         HAL::Device* device,
         ShaderManager* shaderManager, 
         Memory::GPUResourceProducer* resourceProducer,
-        const RenderSurfaceDescription& defaultRenderSurface)
+        const RenderSurfaceDescription& defaultRenderSurface,
+        const std::filesystem::path& cacheFolder)
         : 
         mDevice{ device }, 
         mShaderManager{ shaderManager },
         mResourceProducer{ resourceProducer },
         mDefaultRenderSurfaceDesc{ defaultRenderSurface }, 
         mBaseRootSignature{ device },
-        mDefaultGraphicsState{ device }
+        mDefaultGraphicsState{ device },
+        mCachePath{ cacheFolder / "PipelineStateCache.pfpso" }
     {
         ConfigureDefaultStates();
         AddCommonRootSignatureParameters(mBaseRootSignature);
@@ -25,6 +41,24 @@ namespace PathFinder
 
         mShaderManager->ShaderRecompilationEvent() += { "shader.recompilation", this, &PipelineStateManager::RecompileStatesWithNewShader };
         mShaderManager->LibraryRecompilationEvent() += { "library.recompilation", this, &PipelineStateManager::RecompileStatesWithNewLibrary };
+
+        // Missing or outdated cache is not an error, states are compiled from scratch and cache is rewritten on exit
+        mCache.Load(mCachePath);
+
+        mCompilationThread = std::thread{ &PipelineStateManager::RunBackgroundCompilation, this };
+    }
+
+    PipelineStateManager::~PipelineStateManager()
+    {
+        {
+            std::lock_guard lock{ mCompilationMutex };
+            mStopCompilationThread = true;
+        }
+
+        mCompilationCondition.notify_all();
+        mCompilationThread.join();
+
+        SaveCache();
     }
 
     void PipelineStateManager::CreateRootSignature(RootSignatureName name, const RootSignatureConfigurator& configurator)
@@ -119,6 +153,7 @@ namespace PathFinder
 
         auto [iter, success] = mPipelineStates.emplace(name, std::move(newState));
         mStatesToCompile.insert(&iter->second);
+        mCacheIdentities[&iter->second] = { StateNameHash(name), proxy.DescriptionHash() };
 
         AssociateStateWithShader(&iter->second, vertexShader);
         AssociateStateWithShader(&iter->second, pixelShader);
@@ -146,6 +181,7 @@ namespace PathFinder
 
         auto [iter, success] = mPipelineStates.emplace(name, std::move(newState));
         mStatesToCompile.insert(&iter->second);
+        mCacheIdentities[&iter->second] = { StateNameHash(name), proxy.DescriptionHash() };
 
         AssociateStateWithShader(&iter->second, computeShader);
     }
@@ -265,6 +301,20 @@ namespace PathFinder
         return mBaseRootSignature;
     }
 
+    void PipelineStateManager::BeginFrame(uint64_t newFrameNumber)
+    {
+        mFrameNumber = newFrameNumber;
+    }
+
+    void PipelineStateManager::EndFrame(uint64_t completedFrameNumber)
+    {
+        auto retiredEnd = std::remove_if(mRetiredStates.begin(), mRetiredStates.end(), [completedFrameNumber](const RetiredState& retiredState) {
+            return retiredState.FrameNumber <= completedFrameNumber;
+        });
+
+        mRetiredStates.erase(retiredEnd, mRetiredStates.end());
+    }
+
     void PipelineStateManager::CompileUncompiledSignaturesAndStates()
     {
         for (HAL::RootSignature* signature : mSignaturesToCompile)
@@ -272,26 +322,62 @@ namespace PathFinder
             signature->Compile();
         }
 
+        SwapInBackgroundCompiledStates();
+
+        std::vector<PipelineStateVariantInternal*> requiredStates;
+
         for (PipelineStateVariantInternal* state : mStatesToCompile)
         {
-            if (auto pso = std::get_if<HAL::GraphicsPipelineState>(state))
+            // Previous version keeps rendering until recompiled one is ready
+            if (IsCompiled(*state))
             {
-                pso->Compile();
+                EnqueueBackgroundCompilation(state);
             }
-            else if (auto pso = std::get_if<HAL::ComputePipelineState>(state))
+            else
             {
-                pso->Compile();
-            }
-            else if (auto psoWrapper = std::get_if<RayTracingStateWrapper>(state))
-            {
-                CompileRayTracingState(*psoWrapper);
+                requiredStates.push_back(state);
             }
         }
 
+        CompileRequiredStates(requiredStates);
+
         mSignaturesToCompile.clear();
         mStatesToCompile.clear();
     }
 
+    bool PipelineStateManager::SaveCache()
+    {
+        if (!mCache.IsDirty())
+            return true;
+
+        return mCache.Save(mCachePath);
+    }
+
+    bool PipelineStateManager::ExportStatistics(const std::filesystem::path& path) const
+    {
+        std::ofstream stream{ path, std::ios::out | std::ios::trunc };
+
+        if (!stream.is_open())
+            return false;
+
+        stream.precision(6);
+        stream << "{\"units\":\"seconds\",\"compiledStates\":" << mStatistics.CompiledStateCount
+            << ",\"backgroundCompiledStates\":" << mStatistics.BackgroundCompiledStateCount
+            << ",\"cacheHits\":" << mStatistics.CacheHitCount
+            << ",\"cacheMisses\":" << mStatistics.CacheMissCount
+            << ",\"cacheRejections\":" << mStatistics.CacheRejectionCount
+            << ",\"blockingCompilations\":" << mStatistics.BlockingCompilationCount
+            << ",\"stallsAvoided\":" << mStatistics.StallsAvoidedCount
+            << ",\"discardedCompilations\":" << mStatistics.DiscardedCompilationCount
+            << ",\"totalCompilationTime\":" << mStatistics.TotalCompilationTime
+            << ",\"maxCompilationTime\":" << mStatistics.MaxCompilationTime
+            << ",\"blockingTime\":" << mStatistics.BlockingTime
+            << ",\"stallTimeAvoided\":" << mStatistics.StallTimeAvoided
+            << "}\n";
+
+        return stream.good();
+    }
+
     void PipelineStateManager::AssociateStateWithShader(PipelineStateVariantInternal* state, const HAL::Shader* shader)
     {
         mShaderToPSOAssociations[shader].insert(state);
@@ -392,9 +478,8 @@ namespace PathFinder
         signature.AddDescriptorParameter(debugBuffer);
     }
 
-    void PipelineStateManager::CompileRayTracingState(RayTracingStateWrapper& stateWrapper)
+    void PipelineStateManager::UploadShaderTable(RayTracingStateWrapper& stateWrapper)
     {
-        stateWrapper.State.Compile();
         HAL::ShaderTable& shaderTable = stateWrapper.State.GetShaderTable();
         HAL::BufferProperties properties{ shaderTable.GetMemoryRequirements().TableSizeInBytes };
         stateWrapper.ShaderTableBuffer = mResourceProducer->NewBuffer(properties);
@@ -412,6 +497,9 @@ namespace PathFinder
 
         for (PipelineStateVariantInternal* stateVariant : statePtrs)
         {
+            // Old shader is destroyed right after this event
+            CancelBackgroundCompilation(stateVariant);
+
             if (auto pso = std::get_if<HAL::GraphicsPipelineState>(stateVariant)) pso->ReplaceShader(oldShader, newShader);
             else if (auto pso = std::get_if<HAL::ComputePipelineState>(stateVariant)) pso->ReplaceShader(oldShader, newShader);
 
@@ -432,6 +520,9 @@ namespace PathFinder
 
         for (PipelineStateVariantInternal* stateVariant : statePtrs)
         {
+            // Old library is destroyed right after this event
+            CancelBackgroundCompilation(stateVariant);
+
             if (auto psoWrapper = std::get_if<RayTracingStateWrapper>(stateVariant))
             {
                 psoWrapper->State.ReplaceLibrary(oldLibrary, newLibrary);
@@ -444,4 +535,247 @@ namespace PathFinder
         mLibraryToPSOAssociations.erase(oldLibrary);
     }
 
-}
\ No newline at end of file
+    bool PipelineStateManager::IsCompiled(const PipelineStateVariantInternal& state) const
+    {
+        if (auto pso = std::get_if<HAL::GraphicsPipelineState>(&state)) return pso->D3DCompiledState() != nullptr;
+        else if (auto pso = std::get_if<HAL::ComputePipelineState>(&state)) return pso->D3DCompiledState() != nullptr;
+        else if (auto psoWrapper = std::get_if<RayTracingStateWrapper>(&state)) return psoWrapper->State.D3DCompiledState() != nullptr;
+
+        return false;
+    }
+
+    PipelineStateManager::PipelineStateVariantInternal PipelineStateManager::CloneUncompiled(const PipelineStateVariantInternal& state) const
+    {
+        if (auto pso = std::get_if<HAL::GraphicsPipelineState>(&state)) return pso->Clone();
+        else if (auto pso = std::get_if<HAL::ComputePipelineState>(&state)) return pso->Clone();
+        
+        const RayTracingStateWrapper& psoWrapper = std::get<RayTracingStateWrapper>(state);
+        return RayTracingStateWrapper{ psoWrapper.Name, psoWrapper.State.Clone(), nullptr };
+    }
+
+    void PipelineStateManager::AssignCacheKey(CompilationJob& job) const
+    {
+        // D3D12 provides no way to cache ray tracing state objects
+        auto identityIt = mCacheIdentities.find(job.Target);
+        if (identityIt == mCacheIdentities.end()) return;
+
+        uint64_t key = identityIt->second.DescriptionHash;
+
+        auto addShader = [&key](const HAL::Shader* shader)
+        {
+            D3D12_SHADER_BYTECODE bytecode = shader ? shader->D3DBytecode() : D3D12_SHADER_BYTECODE{};
+            uint64_t bytecodeHash = bytecode.pShaderBytecode ? robin_hood::hash_bytes(bytecode.pShaderBytecode, bytecode.BytecodeLength) : 0;
+            key = PipelineStateCache::CombineHashes(key, bytecodeHash);
+        };
+
+        // Layout may change under the same signature name, so its serialized form is hashed.
+        // Signatures are compiled before states, so it's available by the time compilation is scheduled.
+        auto addRootSignature = [&key](const HAL::RootSignature* signature)
+        {
+            const std::vector<uint8_t>& serialized = signature->SerializedSignature();
+            key = PipelineStateCache::CombineHashes(key, robin_hood::hash_bytes(serialized.data(), serialized.size()));
+        };
+
+        if (auto pso = std::get_if<HAL::GraphicsPipelineState>(job.Target))
+        {
+            addRootSignature(pso->GetRootSignature());
+            addShader(pso->GetVertexShader());
+            addShader(pso->GetPixelShader());
+            addShader(pso->GetHullShader());
+            addShader(pso->GetDomainShader());
+            addShader(pso->GetGeometryShader());
+        }
+        else if (auto pso = std::get_if<HAL::ComputePipelineState>(job.Target))
+        {
+            addRootSignature(pso->GetRootSignature());
+            addShader(pso->GetComputeShader());
+        }
+
+        job.CacheKey = key;
+        job.CacheOwner = identityIt->second.Owner;
+    }
+
+    void PipelineStateManager::Compile(PipelineStateVariantInternal& state, CompilationJob& job)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+
+        auto compileWithCache = [this, &job](HAL::PipelineState& pso)
+        {
+            std::optional<std::vector<uint8_t>> blob = job.CacheKey ? mCache.Find(*job.CacheKey) : std::nullopt;
+
+            if (blob) pso.SetCachedBlob(blob->data(), blob->size());
+
+            pso.Compile();
+
+            job.IsCacheHit = pso.IsCompiledFromCachedBlob();
+            job.IsCacheRejection = blob && !job.IsCacheHit;
+
+            if (job.CacheKey && !job.IsCacheHit)
+            {
+                mCache.Store(*job.CacheKey, job.CacheOwner, pso.SerializeCachedBlob());
+            }
+        };
+
+        if (auto pso = std::get_if<HAL::GraphicsPipelineState>(&state))
+        {
+            compileWithCache(*pso);
+        }
+        else if (auto pso = std::get_if<HAL::ComputePipelineState>(&state))
+        {
+            compileWithCache(*pso);
+        }
+        else if (auto psoWrapper = std::get_if<RayTracingStateWrapper>(&state))
+        {
+            // Shader table upload needs resource producer which is not thread safe, so it's done by the caller
+            psoWrapper->State.Compile();
+        }
+
+        job.Duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    void PipelineStateManager::CompileRequiredStates(const std::vector<PipelineStateVariantInternal*>& states)
+    {
+        if (states.empty())
+            return;
+
+        auto startTime = std::chrono::steady_clock::now();
+
+        std::vector<CompilationJob> jobs;
+        jobs.reserve(states.size());
+
+        for (PipelineStateVariantInternal* state : states)
+        {
+            CompilationJob& job = jobs.emplace_back();
+            job.Target = state;
+            AssignCacheKey(job);
+        }
+
+        Foundation::TaskScheduler::SharedInstance().ParallelFor(jobs.size(), 1, [this, &jobs](uint64_t first, uint64_t last)
+        {
+            for (uint64_t jobIdx = first; jobIdx < last; ++jobIdx)
+            {
+                Compile(*jobs[jobIdx].Target, jobs[jobIdx]);
+            }
+        });
+
+        for (const CompilationJob& job : jobs)
+        {
+            if (auto psoWrapper = std::get_if<RayTracingStateWrapper>(job.Target))
+            {
+                UploadShaderTable(*psoWrapper);
+            }
+
+            AccumulateStatistics(job);
+        }
+
+        mStatistics.BlockingCompilationCount++;
+        mStatistics.BlockingTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    void PipelineStateManager::EnqueueBackgroundCompilation(PipelineStateVariantInternal* state)
+    {
+        CancelBackgroundCompilation(state);
+
+        CompilationJob job;
+        job.Target = state;
+        job.State = CloneUncompiled(*state);
+        AssignCacheKey(job);
+
+        {
+            std::lock_guard lock{ mCompilationMutex };
+            mQueuedJobs.push_back(std::move(job));
+        }
+
+        mCompilationCondition.notify_all();
+    }
+
+    void PipelineStateManager::CancelBackgroundCompilation(PipelineStateVariantInternal* state)
+    {
+        std::unique_lock lock{ mCompilationMutex };
+
+        auto targets = [state](const CompilationJob& job) { return job.Target == state; };
+
+        mQueuedJobs.erase(std::remove_if(mQueuedJobs.begin(), mQueuedJobs.end(), targets), mQueuedJobs.end());
+
+        // Job in progress references shaders of the state and cannot be interrupted
+        mCompilationCondition.wait(lock, [this, state] { return mStateInCompilation != state; });
+
+        auto completedEnd = std::remove_if(mCompletedJobs.begin(), mCompletedJobs.end(), targets);
+        mStatistics.DiscardedCompilationCount += std::distance(completedEnd, mCompletedJobs.end());
+        mCompletedJobs.erase(completedEnd, mCompletedJobs.end());
+    }
+
+    void PipelineStateManager::SwapInBackgroundCompiledStates()
+    {
+        std::vector<CompilationJob> completedJobs;
+
+        {
+            std::lock_guard lock{ mCompilationMutex };
+            completedJobs.swap(mCompletedJobs);
+        }
+
+        for (CompilationJob& job : completedJobs)
+        {
+            if (auto psoWrapper = std::get_if<RayTracingStateWrapper>(&(*job.State)))
+            {
+                UploadShaderTable(*psoWrapper);
+            }
+
+            // Frames in flight may still reference the previous version
+            mRetiredStates.push_back(RetiredState{ mFrameNumber, std::move(*job.Target) });
+            *job.Target = std::move(*job.State);
+
+            mStatistics.BackgroundCompiledStateCount++;
+            mStatistics.StallsAvoidedCount++;
+            mStatistics.StallTimeAvoided += job.Duration;
+
+            AccumulateStatistics(job);
+        }
+    }
+
+    void PipelineStateManager::AccumulateStatistics(const CompilationJob& job)
+    {
+        mStatistics.CompiledStateCount++;
+        mStatistics.TotalCompilationTime += job.Duration;
+        mStatistics.MaxCompilationTime = std::max(mStatistics.MaxCompilationTime, job.Duration);
+
+        if (!job.CacheKey)
+            return;
+
+        if (job.IsCacheHit) mStatistics.CacheHitCount++;
+        else mStatistics.CacheMissCount++;
+
+        if (job.IsCacheRejection) mStatistics.CacheRejectionCount++;
+    }
+
+    void PipelineStateManager::RunBackgroundCompilation()
+    {
+        while (true)
+        {
+            CompilationJob job;
+
+            {
+                std::unique_lock lock{ mCompilationMutex };
+                mCompilationCondition.wait(lock, [this] { return mStopCompilationThread || !mQueuedJobs.empty(); });
+
+                if (mStopCompilationThread)
+                    return;
+
+                job = std::move(mQueuedJobs.front());
+                mQueuedJobs.pop_front();
+                mStateInCompilation = job.Target;
+            }
+
+            Compile(*job.State, job);
+
+            {
+                std::lock_guard lock{ mCompilationMutex };
+                mStateInCompilation = nullptr;
+                mCompletedJobs.push_back(std::move(job));
+            }
+
+            mCompilationCondition.notify_all();
+        }
+    }
+
+}
@@ -10,14 +10,26 @@
 #include "RenderSurfaceDescription.hpp"
 #include "PipelineStateProxy.hpp"
 #include "RootSignatureProxy.hpp"
+#include "PipelineStateCache.hpp"
 
 #include <unordered_map>
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
 
 namespace PathFinder
 {
     using PSOName = Foundation::Name;
     using RootSignatureName = Foundation::Name;
 
+    /// States are compiled at frame boundaries in CompileUncompiledSignaturesAndStates().
+    /// States that were never compiled are required by the frame, so they are compiled in parallel while the render thread waits.
+    /// States that already have a compiled version (shader hot reload) are compiled by a background thread
+    /// while the previous version keeps rendering and are swapped in at the next frame boundary.
+    /// Replaced versions are released only after frames that could have used them complete on the GPU.
+    /// Graphics and compute driver blobs are persisted in a disk cache between runs.
     class PipelineStateManager
     {
     public:
@@ -39,13 +51,37 @@ namespace PathFinder
             const HAL::RayDispatchInfo* BaseRayDispatchInfo = nullptr;
         };
 
+        struct CompilationStatistics
+        {
+            uint64_t CompiledStateCount = 0;
+            uint64_t BackgroundCompiledStateCount = 0;
+            uint64_t CacheHitCount = 0;
+            uint64_t CacheMissCount = 0;
+            // Blobs found in the cache but refused by the driver
+            uint64_t CacheRejectionCount = 0;
+            // Frame boundaries at which render thread waited for required states
+            uint64_t BlockingCompilationCount = 0;
+            // Recompiled states swapped in without render thread waiting for them
+            uint64_t StallsAvoidedCount = 0;
+            // Background results dropped because their shaders were replaced again before swap
+            uint64_t DiscardedCompilationCount = 0;
+            // Seconds
+            double TotalCompilationTime = 0.0;
+            double MaxCompilationTime = 0.0;
+            double BlockingTime = 0.0;
+            double StallTimeAvoided = 0.0;
+        };
+
         PipelineStateManager(
             HAL::Device* device,
             ShaderManager* shaderManager,
             Memory::GPUResourceProducer* resourceProducer, 
-            const RenderSurfaceDescription& defaultRenderSurface
+            const RenderSurfaceDescription& defaultRenderSurface,
+            const std::filesystem::path& cacheFolder
         );
 
+        ~PipelineStateManager();
+
         void CreateRootSignature(RootSignatureName name, const RootSignatureConfigurator& configurator);
         void CreateGraphicsState(PSOName name, const GraphicsStateConfigurator& configurator);
         void CreateComputeState(PSOName name, const ComputeStateConfigurator& configurator);
@@ -55,8 +91,14 @@ namespace PathFinder
         const HAL::RootSignature* GetRootSignature(RootSignatureName name) const;
         const HAL::RootSignature& BaseRootSignature() const;
 
+        void BeginFrame(uint64_t newFrameNumber);
+        void EndFrame(uint64_t completedFrameNumber);
+
         void CompileUncompiledSignaturesAndStates();
 
+        bool SaveCache();
+        bool ExportStatistics(const std::filesystem::path& path) const;
+
     private:
         struct RayTracingStateWrapper
         {
@@ -73,6 +115,26 @@ namespace PathFinder
         // Store graphic and compute states directly, but store ray tracing one in a wrapper because we need to manage and associate additional memory with it
         using PipelineStateVariantInternal = std::variant<HAL::GraphicsPipelineState, HAL::ComputePipelineState, RayTracingStateWrapper>;
 
+        struct CompilationJob
+        {
+            // Live state that receives compilation result
+            PipelineStateVariantInternal* Target = nullptr;
+            // Uncompiled copy of the live state
+            std::optional<PipelineStateVariantInternal> State;
+            std::optional<uint64_t> CacheKey;
+            uint64_t CacheOwner = 0;
+            bool IsCacheHit = false;
+            bool IsCacheRejection = false;
+            // Seconds
+            double Duration = 0.0;
+        };
+
+        struct RetiredState
+        {
+            uint64_t FrameNumber = 0;
+            PipelineStateVariantInternal State;
+        };
+
         const HAL::RootSignature* GetNamedRootSignatureOrDefault(std::optional<RootSignatureName> name) const;
         const HAL::RootSignature* GetNamedRootSignatureOrNull(std::optional<RootSignatureName> name) const;
 
@@ -81,7 +143,18 @@ namespace PathFinder
 
         void ConfigureDefaultStates();
         void AddCommonRootSignatureParameters(HAL::RootSignature& signature) const;
-        void CompileRayTracingState(RayTracingStateWrapper& stateWrapper);
+        void UploadShaderTable(RayTracingStateWrapper& stateWrapper);
+
+        bool IsCompiled(const PipelineStateVariantInternal& state) const;
+        PipelineStateVariantInternal CloneUncompiled(const PipelineStateVariantInternal& state) const;
+        void AssignCacheKey(CompilationJob& job) const;
+        void Compile(PipelineStateVariantInternal& state, CompilationJob& job);
+        void CompileRequiredStates(const std::vector<PipelineStateVariantInternal*>& states);
+        void EnqueueBackgroundCompilation(PipelineStateVariantInternal* state);
+        void CancelBackgroundCompilation(PipelineStateVariantInternal* state);
+        void SwapInBackgroundCompiledStates();
+        void AccumulateStatistics(const CompilationJob& job);
+        void RunBackgroundCompilation();
 
         void RecompileStatesWithNewShader(const HAL::Shader* oldShader, const HAL::Shader* newShader);
         void RecompileStatesWithNewLibrary(const HAL::Library* oldLibrary, const HAL::Library* newLibrary);
@@ -101,6 +174,30 @@ namespace PathFinder
         robin_hood::unordered_set<PipelineStateVariantInternal*> mStatesToCompile;
         robin_hood::unordered_set<HAL::RootSignature*> mSignaturesToCompile;
 
+        struct CacheIdentity
+        {
+            // Hash of the state name, stable between runs
+            uint64_t Owner = 0;
+            // Description part of cache keys, root signature and shader bytecode hashes are added when compilation is scheduled
+            uint64_t DescriptionHash = 0;
+        };
+
+        robin_hood::unordered_map<const PipelineStateVariantInternal*, CacheIdentity> mCacheIdentities;
+        PipelineStateCache mCache;
+        std::filesystem::path mCachePath;
+
+        std::thread mCompilationThread;
+        std::mutex mCompilationMutex;
+        std::condition_variable mCompilationCondition;
+        std::deque<CompilationJob> mQueuedJobs;
+        std::vector<CompilationJob> mCompletedJobs;
+        const PipelineStateVariantInternal* mStateInCompilation = nullptr;
+        bool mStopCompilationThread = false;
+
+        std::vector<RetiredState> mRetiredStates;
+        uint64_t mFrameNumber = 0;
+        CompilationStatistics mStatistics;
+
         std::string mDefaultVertexEntryPointName = "VSMain";
         std::string mDefaultPixelEntryPointName = "PSMain";
         std::string mDefaultGeometryEntryPointName = "GSMain";
@@ -113,6 +210,7 @@ namespace PathFinder
 
     public:
         inline const auto CommonRootSignatureParameterCount() const { return mBaseRootSignature.ParameterCount(); }
+        inline const auto& Statistics() const { return mStatistics; }
     };
 
 }
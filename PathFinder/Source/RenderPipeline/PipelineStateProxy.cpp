@@ -1,10 +1,125 @@
 #include "PipelineStateProxy.hpp"
 
-
+#include <robinhood/robin_hood.h>
 
 namespace PathFinder
 {
 
+    namespace
+    {
+        class DescriptionHasher
+        {
+        public:
+            template <class T>
+            void Add(const T& value)
+            {
+                static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "Only scalars are hashed directly to stay clear of padding bytes");
+                const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+                mBytes.insert(mBytes.end(), bytes, bytes + sizeof(T));
+            }
+
+            void Add(const std::string& string)
+            {
+                Add(string.size());
+                mBytes.insert(mBytes.end(), string.begin(), string.end());
+            }
+
+            void Add(const std::optional<std::string>& string)
+            {
+                Add(string.has_value());
+                if (string) Add(*string);
+            }
+
+            uint64_t Hash() const
+            {
+                return robin_hood::hash_bytes(mBytes.data(), mBytes.size());
+            }
+
+        private:
+            std::vector<uint8_t> mBytes;
+        };
+    }
+
+    uint64_t GraphicsStateProxy::DescriptionHash() const
+    {
+        DescriptionHasher hasher;
+
+        hasher.Add(VertexShaderFileName);
+        hasher.Add(PixelShaderFileName);
+        hasher.Add(GeometryShaderFileName);
+        hasher.Add(VertexShaderEntryPoint);
+        hasher.Add(PixelShaderEntryPoint);
+        hasher.Add(GeometryShaderEntryPoint);
+
+        const D3D12_BLEND_DESC& blend = BlendState.D3DState();
+        hasher.Add(blend.AlphaToCoverageEnable);
+        hasher.Add(blend.IndependentBlendEnable);
+
+        for (const D3D12_RENDER_TARGET_BLEND_DESC& rtBlend : blend.RenderTarget)
+        {
+            hasher.Add(rtBlend.BlendEnable);
+            hasher.Add(rtBlend.LogicOpEnable);
+            hasher.Add(rtBlend.SrcBlend);
+            hasher.Add(rtBlend.DestBlend);
+            hasher.Add(rtBlend.BlendOp);
+            hasher.Add(rtBlend.SrcBlendAlpha);
+            hasher.Add(rtBlend.DestBlendAlpha);
+            hasher.Add(rtBlend.BlendOpAlpha);
+            hasher.Add(rtBlend.LogicOp);
+            hasher.Add(rtBlend.RenderTargetWriteMask);
+        }
+
+        const D3D12_RASTERIZER_DESC& rasterizer = RasterizerState.D3DState();
+        hasher.Add(rasterizer.FillMode);
+        hasher.Add(rasterizer.CullMode);
+        hasher.Add(rasterizer.FrontCounterClockwise);
+        hasher.Add(rasterizer.DepthBias);
+        hasher.Add(rasterizer.DepthBiasClamp);
+        hasher.Add(rasterizer.SlopeScaledDepthBias);
+        hasher.Add(rasterizer.DepthClipEnable);
+        hasher.Add(rasterizer.MultisampleEnable);
+        hasher.Add(rasterizer.AntialiasedLineEnable);
+        hasher.Add(rasterizer.ForcedSampleCount);
+        hasher.Add(rasterizer.ConservativeRaster);
+
+        const D3D12_DEPTH_STENCIL_DESC& depthStencil = DepthStencilState.D3DState();
+        hasher.Add(depthStencil.DepthEnable);
+        hasher.Add(depthStencil.DepthWriteMask);
+        hasher.Add(depthStencil.DepthFunc);
+        hasher.Add(depthStencil.StencilEnable);
+        hasher.Add(depthStencil.StencilReadMask);
+        hasher.Add(depthStencil.StencilWriteMask);
+
+        for (const D3D12_DEPTH_STENCILOP_DESC& face : { depthStencil.FrontFace, depthStencil.BackFace })
+        {
+            hasher.Add(face.StencilFailOp);
+            hasher.Add(face.StencilDepthFailOp);
+            hasher.Add(face.StencilPassOp);
+            hasher.Add(face.StencilFunc);
+        }
+
+        hasher.Add(DepthStencilFormat);
+        hasher.Add(PrimitiveTopology);
+        hasher.Add(RenderTargetFormats.size());
+
+        for (const HAL::GraphicsPipelineState::RenderTargetFormat& format : RenderTargetFormats)
+        {
+            hasher.Add(format.index());
+            std::visit([&hasher](auto&& concreteFormat) { hasher.Add(concreteFormat); }, format);
+        }
+
+        return hasher.Hash();
+    }
+
+    uint64_t ComputeStateProxy::DescriptionHash() const
+    {
+        DescriptionHasher hasher;
+
+        hasher.Add(ComputeShaderFileName);
+        hasher.Add(EntryPoint);
+        return hasher.Hash();
+    }
+
     HAL::ShaderTableIndex RayTracingStateProxy::AddCallableShader(const std::string& fileName, const std::string& entryPoint, std::optional<Foundation::Name> localRootSignatureName)
     {
         // PSO Implementation is expected to put shaders exactly in order they were put into this state proxy's array
@@ -12,6 +12,10 @@ namespace PathFinder
     class GraphicsStateProxy
     {
     public:
+        // Hash of everything that affects compiled state except shader bytecode and root signature layout.
+        // Stable between runs, used as a key into pipeline state cache.
+        uint64_t DescriptionHash() const;
+
         std::string VertexShaderFileName;
         std::string PixelShaderFileName;
         std::optional<std::string> GeometryShaderFileName;
@@ -30,6 +34,8 @@ namespace PathFinder
     class ComputeStateProxy
     {
     public:
+        uint64_t DescriptionHash() const;
+
         std::string ComputeShaderFileName;
         std::optional<std::string> EntryPoint;
         std::optional<Foundation::Name> RootSignatureName;
@@ -0,0 +1,383 @@
+#include "QueueAssignmentOptimizer.hpp"
+
+#include <Foundation/Assert.hpp>
+
+#include <fstream>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace PathFinder
+{
+
+    namespace
+    {
+        const uint64_t GraphicsQueueIndex = std::underlying_type_t<RenderPassExecutionQueue>(RenderPassExecutionQueue::Graphics);
+        const uint64_t AsyncComputeQueueIndex = std::underlying_type_t<RenderPassExecutionQueue>(RenderPassExecutionQueue::AsyncCompute);
+
+        // Ignore drift on tiny passes where relative changes are mostly noise
+        const float MinAbsoluteDrift = 20e-6f;
+    }
+
+    QueueAssignmentOptimizer::QueueAssignmentOptimizer(float syncCost, float driftThreshold, float minRelativeImprovement, uint64_t minFramesBetweenEvaluations)
+        : mSyncCost{ syncCost },
+        mDriftThreshold{ driftThreshold },
+        mMinRelativeImprovement{ minRelativeImprovement },
+        mMinFramesBetweenEvaluations{ minFramesBetweenEvaluations } {}
+
+    QueueAssignmentOptimizer::Result QueueAssignmentOptimizer::Optimize(const RenderPassGraphAnalyzer::GraphRecord& record, float syncCost)
+    {
+        Search search{ record, syncCost };
+        search.Step(std::numeric_limits<uint64_t>::max());
+        return search.GetResult();
+    }
+
+    bool QueueAssignmentOptimizer::OptimizeRecordedGraph(const std::filesystem::path& recordPath, float syncCost)
+    {
+        std::optional<RenderPassGraphAnalyzer::GraphRecord> record = RenderPassGraphAnalyzer::LoadRecord(recordPath);
+
+        if (!record)
+            return false;
+
+        Result result = Optimize(*record, syncCost);
+
+        RenderPassGraphAnalyzer::GraphRecord optimizedRecord = *record;
+        RenderPassGraphAnalyzer::ReassignQueues(optimizedRecord, result.PassQueueIndices);
+        RenderPassGraphAnalyzer::Report optimizedReport = RenderPassGraphAnalyzer::Analyze(optimizedRecord, syncCost);
+
+        // Same search spread over frames the way Update() runs it
+        Search frameSearch{ *record, syncCost };
+        uint64_t frameCount = 1;
+
+        while (!frameSearch.Step(MaxEvaluationsPerFrame))
+            ++frameCount;
+
+        // Only eligible passes move and only between graphics and async compute queues
+        bool isAssignmentValid = result.PassQueueIndices.size() == record->Passes.size();
+
+        for (auto passIdx = 0u; passIdx < record->Passes.size() && isAssignmentValid; ++passIdx)
+        {
+            const RenderPassGraphAnalyzer::PassRecord& pass = record->Passes[passIdx];
+            uint64_t queueIndex = result.PassQueueIndices[passIdx];
+
+            isAssignmentValid &= pass.IsAsyncComputeEligible ?
+                queueIndex == GraphicsQueueIndex || queueIndex == AsyncComputeQueueIndex :
+                queueIndex == pass.QueueIndex;
+        }
+
+        bool isImprovementValid = result.EstimatedFrameDuration <= result.BaselineFrameDuration;
+        // Estimate comes from the scratch record of the search and has to match a full analysis of the reassigned graph
+        bool isEstimateConsistent = std::abs(optimizedReport.FrameDuration - result.EstimatedFrameDuration) <= 1e-4f * std::max(result.EstimatedFrameDuration, 1e-6f);
+        bool isFrameSearchConsistent = frameSearch.GetResult().PassQueueIndices == result.PassQueueIndices &&
+            frameSearch.GetResult().EvaluatedAssignments == result.EvaluatedAssignments;
+
+        bool isValid = isAssignmentValid && isImprovementValid && isEstimateConsistent && isFrameSearchConsistent;
+
+        std::filesystem::path basePath = recordPath;
+        basePath.replace_extension();
+
+        std::filesystem::path dotPath = basePath;
+        std::filesystem::path analysisPath = basePath;
+        std::filesystem::path assignmentPath = basePath;
+
+        dotPath += ".optimized.dot";
+        analysisPath += ".optimized.json";
+        assignmentPath += ".assignment.json";
+
+        if (!RenderPassGraphAnalyzer::ExportDOT(optimizedRecord, optimizedReport, dotPath) ||
+            !RenderPassGraphAnalyzer::ExportJSON(optimizedRecord, optimizedReport, analysisPath))
+        {
+            return false;
+        }
+
+        std::ofstream stream{ assignmentPath, std::ios::out | std::ios::trunc };
+
+        if (!stream.is_open())
+            return false;
+
+        stream.precision(9);
+        stream << "{\"syncCost\":" << syncCost << ",\"baselineFrameDuration\":" << result.BaselineFrameDuration
+            << ",\"estimatedFrameDuration\":" << result.EstimatedFrameDuration
+            << ",\"evaluatedAssignments\":" << result.EvaluatedAssignments << ",\"searchFrames\":" << frameCount
+            << ",\"assignmentValid\":" << (isAssignmentValid ? "true" : "false")
+            << ",\"improvementValid\":" << (isImprovementValid ? "true" : "false")
+            << ",\"estimateConsistent\":" << (isEstimateConsistent ? "true" : "false")
+            << ",\"frameSearchConsistent\":" << (isFrameSearchConsistent ? "true" : "false")
+            << ",\"valid\":" << (isValid ? "true" : "false") << ",\"passes\":[\n";
+
+        for (auto passIdx = 0u; passIdx < record->Passes.size(); ++passIdx)
+        {
+            const RenderPassGraphAnalyzer::PassRecord& pass = record->Passes[passIdx];
+
+            stream << "{\"name\":\"" << pass.Name << "\",\"eligible\":" << (pass.IsAsyncComputeEligible ? "true" : "false")
+                << ",\"recordedQueue\":" << pass.QueueIndex << ",\"assignedQueue\":" << result.PassQueueIndices[passIdx] << "}"
+                << (passIdx + 1 < record->Passes.size() ? ",\n" : "\n");
+        }
+
+        stream << "]}\n";
+
+        return isValid && stream.good();
+    }
+
+    bool QueueAssignmentOptimizer::Update(const RenderPassGraph& graph, const PipelineMeasurementStorage& measurements)
+    {
+        mFramesSinceEvaluation++;
+
+        uint64_t graphSignature = GraphSignature(graph);
+
+        // Pass set or dependencies changed: previous timing baseline and search in progress no longer describe this graph
+        if (graphSignature != mGraphSignature)
+        {
+            mGraphSignature = graphSignature;
+            mTimingSnapshot.clear();
+            mSearch = std::nullopt;
+        }
+
+        if (!mSearch)
+        {
+            // Passes that were just moved need to accumulate history on their new queue first
+            if (!AreTimingsAvailable(graph, measurements))
+                return false;
+
+            bool shouldEvaluate = mTimingSnapshot.empty() ||
+                (mFramesSinceEvaluation >= mMinFramesBetweenEvaluations && HaveTimingsDrifted(graph, measurements));
+
+            if (!shouldEvaluate)
+                return false;
+
+            mSearch.emplace(RenderPassGraphAnalyzer::Record(graph, measurements), mSyncCost);
+
+            TakeTimingSnapshot(graph, measurements);
+        }
+
+        if (!mSearch->Step(MaxEvaluationsPerFrame))
+            return false;
+
+        Result result = mSearch->GetResult();
+
+        mSearch = std::nullopt;
+        mLastResult = result;
+        mFramesSinceEvaluation = 0;
+        mEvaluationCount++;
+
+        return ApplyResult(graph, result);
+    }
+
+    bool QueueAssignmentOptimizer::ApplyResult(const RenderPassGraph& graph, const Result& result)
+    {
+        // Avoid flipping passes back and forth for marginal gains
+        if (result.EstimatedFrameDuration > result.BaselineFrameDuration * (1.0f - mMinRelativeImprovement))
+            return false;
+
+        bool isAssignmentChanged = false;
+
+        for (auto passIdx = 0u; passIdx < result.PassQueueIndices.size(); ++passIdx)
+        {
+            const RenderPassGraph::Node* node = graph.NodesInGlobalExecutionOrder()[passIdx];
+
+            if (!node->IsAsyncComputeEligible)
+                continue;
+
+            RenderPassExecutionQueue queue = RenderPassExecutionQueue(result.PassQueueIndices[passIdx]);
+            auto [it, inserted] = mAssignments.insert({ node->PassMetadata().Name, queue });
+
+            if (inserted || it->second != queue)
+            {
+                it->second = queue;
+                isAssignmentChanged = true;
+            }
+        }
+
+        return isAssignmentChanged;
+    }
+
+    std::optional<RenderPassExecutionQueue> QueueAssignmentOptimizer::AssignedQueue(Foundation::Name passName) const
+    {
+        auto it = mAssignments.find(passName);
+        return it != mAssignments.end() ? std::optional{ it->second } : std::nullopt;
+    }
+
+    void QueueAssignmentOptimizer::Reset()
+    {
+        mAssignments.clear();
+        mTimingSnapshot.clear();
+        mSearch = std::nullopt;
+        mLastResult = {};
+        mGraphSignature = 0;
+        mFramesSinceEvaluation = 0;
+    }
+
+    QueueAssignmentOptimizer::Search::Search(const RenderPassGraphAnalyzer::GraphRecord& record, float syncCost)
+        : mRecord{ record }, mCandidateRecord{ record }, mSyncCost{ syncCost }
+    {
+        for (auto passIdx = 0u; passIdx < mRecord.Passes.size(); ++passIdx)
+        {
+            const RenderPassGraphAnalyzer::PassRecord& pass = mRecord.Passes[passIdx];
+            mResult.PassQueueIndices.push_back(pass.QueueIndex);
+
+            if (pass.IsAsyncComputeEligible)
+                mEligiblePassIndices.push_back(passIdx);
+        }
+
+        // Baseline is evaluated with the same sync model as candidates to keep comparison fair
+        mResult.BaselineFrameDuration = Evaluate(mResult.PassQueueIndices);
+        mResult.EstimatedFrameDuration = mResult.BaselineFrameDuration;
+        mResult.EvaluatedAssignments = 1;
+
+        mCandidate = mResult.PassQueueIndices;
+        mBestMoveDuration = mResult.EstimatedFrameDuration;
+        mIsExhaustive = mEligiblePassIndices.size() <= MaxEligiblePassesForExhaustiveSearch;
+        mIsComplete = mEligiblePassIndices.empty();
+    }
+
+    bool QueueAssignmentOptimizer::Search::Step(uint64_t maxEvaluations)
+    {
+        uint64_t evaluationsLeft = maxEvaluations;
+
+        if (mIsExhaustive)
+        {
+            uint64_t combinationCount = 1ull << mEligiblePassIndices.size();
+
+            for (; !mIsComplete && mNextCombination < combinationCount && evaluationsLeft > 0; ++mNextCombination, --evaluationsLeft)
+            {
+                for (auto eligibleIdx = 0u; eligibleIdx < mEligiblePassIndices.size(); ++eligibleIdx)
+                {
+                    bool onAsyncQueue = (mNextCombination >> eligibleIdx) & 1;
+                    mCandidate[mEligiblePassIndices[eligibleIdx]] = onAsyncQueue ? AsyncComputeQueueIndex : GraphicsQueueIndex;
+                }
+
+                float frameDuration = Evaluate(mCandidate);
+                mResult.EvaluatedAssignments++;
+
+                // Strict comparison keeps current assignment on ties
+                if (frameDuration < mResult.EstimatedFrameDuration)
+                {
+                    mResult.EstimatedFrameDuration = frameDuration;
+                    mResult.PassQueueIndices = mCandidate;
+                }
+            }
+
+            mIsComplete |= mNextCombination == combinationCount;
+
+            return mIsComplete;
+        }
+
+        // Too many combinations. Repeatedly apply the single move that improves the frame the most.
+        while (!mIsComplete && evaluationsLeft > 0)
+        {
+            if (mNextMove < mEligiblePassIndices.size())
+            {
+                uint64_t passIdx = mEligiblePassIndices[mNextMove];
+
+                mCandidate = mResult.PassQueueIndices;
+                mCandidate[passIdx] = mCandidate[passIdx] == AsyncComputeQueueIndex ? GraphicsQueueIndex : AsyncComputeQueueIndex;
+
+                float frameDuration = Evaluate(mCandidate);
+                mResult.EvaluatedAssignments++;
+
+                if (frameDuration < mBestMoveDuration)
+                {
+                    mBestMoveDuration = frameDuration;
+                    mBestMovePassIdx = passIdx;
+                }
+
+                ++mNextMove;
+                --evaluationsLeft;
+                continue;
+            }
+
+            bool improved = mBestMovePassIdx != RenderPassGraphAnalyzer::InvalidPassIndex;
+
+            if (improved)
+            {
+                uint64_t& queueIndex = mResult.PassQueueIndices[mBestMovePassIdx];
+                queueIndex = queueIndex == AsyncComputeQueueIndex ? GraphicsQueueIndex : AsyncComputeQueueIndex;
+                mResult.EstimatedFrameDuration = mBestMoveDuration;
+            }
+
+            // Best assignment found so far is kept when the search runs out of evaluations
+            mIsComplete = !improved || mResult.EvaluatedAssignments >= MaxEvaluationsPerSearch;
+            mNextMove = 0;
+            mBestMovePassIdx = RenderPassGraphAnalyzer::InvalidPassIndex;
+        }
+
+        return mIsComplete;
+    }
+
+    float QueueAssignmentOptimizer::Search::Evaluate(const std::vector<uint64_t>& passQueueIndices)
+    {
+        // Only durations are resolved from what ReassignQueues left behind, everything else it rewrites
+        for (auto passIdx = 0u; passIdx < mRecord.Passes.size(); ++passIdx)
+        {
+            mCandidateRecord.Passes[passIdx].WorkDuration = mRecord.Passes[passIdx].WorkDuration;
+            mCandidateRecord.Passes[passIdx].BarrierDuration = mRecord.Passes[passIdx].BarrierDuration;
+        }
+
+        RenderPassGraphAnalyzer::ReassignQueues(mCandidateRecord, passQueueIndices);
+        return RenderPassGraphAnalyzer::Analyze(mCandidateRecord, mSyncCost).FrameDuration;
+    }
+
+    uint64_t QueueAssignmentOptimizer::GraphSignature(const RenderPassGraph& graph) const
+    {
+        // Queue indices are deliberately left out: they are the output of this optimizer
+        std::vector<uint64_t> signatureData;
+
+        for (const RenderPassGraph::Node* node : graph.NodesInGlobalExecutionOrder())
+        {
+            signatureData.push_back(node->PassMetadata().Name.ToId());
+            signatureData.push_back(node->IsAsyncComputeEligible);
+            signatureData.push_back(node->DependencyLevelIndex());
+        }
+
+        return robin_hood::hash_bytes(signatureData.data(), signatureData.size() * sizeof(uint64_t));
+    }
+
+    bool QueueAssignmentOptimizer::AreTimingsAvailable(const RenderPassGraph& graph, const PipelineMeasurementStorage& measurements) const
+    {
+        for (const RenderPassGraph::Node* node : graph.NodesInGlobalExecutionOrder())
+        {
+            const PipelineMeasurementStorage::Series* series = measurements.GetSeries(
+                node->PassMetadata().Name, PipelineMeasurementStorage::MeasurementType::PassWork, node->ExecutionQueueIndex);
+
+            if (!series || series->Stats.SampleCount < MinSamplesForEvaluation)
+                return false;
+        }
+
+        return true;
+    }
+
+    bool QueueAssignmentOptimizer::HaveTimingsDrifted(const RenderPassGraph& graph, const PipelineMeasurementStorage& measurements) const
+    {
+        for (const RenderPassGraph::Node* node : graph.NodesInGlobalExecutionOrder())
+        {
+            const PipelineMeasurementStorage::Series* series = measurements.GetSeries(
+                node->PassMetadata().Name, PipelineMeasurementStorage::MeasurementType::PassWork, node->ExecutionQueueIndex);
+
+            auto snapshotIt = mTimingSnapshot.find(node->PassMetadata().Name);
+
+            if (snapshotIt == mTimingSnapshot.end())
+                return true;
+
+            float drift = std::abs(series->Stats.Mean - snapshotIt->second);
+
+            if (drift > MinAbsoluteDrift && drift > snapshotIt->second * mDriftThreshold)
+                return true;
+        }
+
+        return false;
+    }
+
+    void QueueAssignmentOptimizer::TakeTimingSnapshot(const RenderPassGraph& graph, const PipelineMeasurementStorage& measurements)
+    {
+        mTimingSnapshot.clear();
+
+        for (const RenderPassGraph::Node* node : graph.NodesInGlobalExecutionOrder())
+        {
+            const PipelineMeasurementStorage::Series* series = measurements.GetSeries(
+                node->PassMetadata().Name, PipelineMeasurementStorage::MeasurementType::PassWork, node->ExecutionQueueIndex);
+
+            mTimingSnapshot[node->PassMetadata().Name] = series->Stats.Mean;
+        }
+    }
+
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "RenderPassGraph.hpp"
+#include "RenderPassGraphAnalyzer.hpp"
+#include "PipelineMeasurementStorage.hpp"
+#include "RenderPassMetadata.hpp"
+
+#include <robinhood/robin_hood.h>
+
+#include <vector>
+#include <optional>
+#include <filesystem>
+
+namespace PathFinder
+{
+
+    /// Decides which compute-eligible render passes run on the async compute queue.
+    /// Candidate assignments are evaluated by simulating the frame with RenderPassGraphAnalyzer
+    /// using rolling per-pass GPU timings, with a fixed cost charged for every cross-queue sync.
+    /// Chosen assignment is cached and only re-evaluated when the graph changes
+    /// or pass timings drift away from those the assignment was based on.
+    /// Re-evaluation is spread over frames, a few candidate assignments per frame.
+    class QueueAssignmentOptimizer
+    {
+    public:
+        struct Result
+        {
+            // Queue per pass in global execution order
+            std::vector<uint64_t> PassQueueIndices;
+            float BaselineFrameDuration = 0.0f;
+            float EstimatedFrameDuration = 0.0f;
+            uint64_t EvaluatedAssignments = 0;
+        };
+
+        QueueAssignmentOptimizer(
+            float syncCost = 50e-6f,
+            float driftThreshold = 0.15f,
+            float minRelativeImprovement = 0.02f,
+            uint64_t minFramesBetweenEvaluations = 60);
+
+        // Searches for an assignment of eligible passes to graphics and async compute queues
+        // that minimizes simulated frame duration. Exhaustive for a small number of eligible passes,
+        // greedy single-pass moves otherwise.
+        static Result Optimize(const RenderPassGraphAnalyzer::GraphRecord& record, float syncCost);
+
+        // Runs search on a recorded graph and writes the assignment and before/after analyses next to it.
+        // Fails if the assignment is invalid, worse than the recorded one or differs from the one found frame by frame.
+        static bool OptimizeRecordedGraph(const std::filesystem::path& recordPath, float syncCost = 50e-6f);
+
+        // Expected to be called once per frame after measurements are gathered.
+        // Returns true when assignment changed and will be used for the next scheduling.
+        // Evaluates at most MaxEvaluationsPerFrame candidates per call.
+        bool Update(const RenderPassGraph& graph, const PipelineMeasurementStorage& measurements);
+
+        std::optional<RenderPassExecutionQueue> AssignedQueue(Foundation::Name passName) const;
+
+        void Reset();
+
+        inline static const uint64_t MaxEvaluationsPerFrame = 16;
+
+    private:
+        inline static const uint64_t MaxEligiblePassesForExhaustiveSearch = 10;
+        inline static const uint64_t MaxEvaluationsPerSearch = 4096;
+        inline static const uint64_t MinSamplesForEvaluation = 32;
+
+        // Search state that lets one optimization run over several calls
+        class Search
+        {
+        public:
+            Search(const RenderPassGraphAnalyzer::GraphRecord& record, float syncCost);
+
+            // Returns true once the search is complete
+            bool Step(uint64_t maxEvaluations);
+
+        private:
+            // Candidates are analyzed in one scratch record instead of a fresh copy of the recorded graph each
+            float Evaluate(const std::vector<uint64_t>& passQueueIndices);
+
+            RenderPassGraphAnalyzer::GraphRecord mRecord;
+            RenderPassGraphAnalyzer::GraphRecord mCandidateRecord;
+            std::vector<uint64_t> mEligiblePassIndices;
+            std::vector<uint64_t> mCandidate;
+            float mSyncCost;
+            Result mResult;
+            bool mIsExhaustive = false;
+            bool mIsComplete = false;
+            uint64_t mNextCombination = 0;
+            // Greedy search tries every single-pass move of a round before applying the best one
+            uint64_t mNextMove = 0;
+            uint64_t mBestMovePassIdx = RenderPassGraphAnalyzer::InvalidPassIndex;
+            float mBestMoveDuration = 0.0f;
+
+        public:
+            inline const Result& GetResult() const { return mResult; }
+        };
+
+        bool ApplyResult(const RenderPassGraph& graph, const Result& result);
+
+        uint64_t GraphSignature(const RenderPassGraph& graph) const;
+        bool AreTimingsAvailable(const RenderPassGraph& graph, const PipelineMeasurementStorage& measurements) const;
+        bool HaveTimingsDrifted(const RenderPassGraph& graph, const PipelineMeasurementStorage& measurements) const;
+        void TakeTimingSnapshot(const RenderPassGraph& graph, const PipelineMeasurementStorage& measurements);
+
+        float mSyncCost;
+        float mDriftThreshold;
+        float mMinRelativeImprovement;
+        uint64_t mMinFramesBetweenEvaluations;
+        uint64_t mFramesSinceEvaluation = 0;
+        uint64_t mGraphSignature = 0;
+        uint64_t mEvaluationCount = 0;
+
+        robin_hood::unordered_flat_map<Foundation::Name, RenderPassExecutionQueue> mAssignments;
+        robin_hood::unordered_flat_map<Foundation::Name, float> mTimingSnapshot;
+        std::optional<Search> mSearch;
+        Result mLastResult;
+
+    public:
+        inline const auto& LastResult() const { return mLastResult; }
+        inline auto EvaluationCount() const { return mEvaluationCount; }
+        inline bool IsSearching() const { return mSearch.has_value(); }
+    };
+
+}
@@ -17,7 +17,8 @@ namespace PathFinder
             mUABarrier = HAL::UnorderedAccessResourceBarrier{ mDestinationBuffer->HALBuffer() };
         }
 
-        if (!mScratchBuffer || mScratchBuffer->Capacity() < scratchBufferSize)
+        // Structures built in a shared scratch buffer don't keep their own
+        if (scratchBufferSize > 0 && (!mScratchBuffer || mScratchBuffer->Capacity() < scratchBufferSize))
         {
             HAL::BufferProperties properties{ scratchBufferSize, 1, HAL::ResourceState::UnorderedAccess };
             mScratchBuffer = mResourceProducer->NewBuffer(properties);
@@ -42,7 +43,7 @@ namespace PathFinder
             mUABarrier = HAL::UnorderedAccessResourceBarrier{ mDestinationBuffer->HALBuffer() };
         }
 
-        if (!mScratchBuffer || mScratchBuffer->Capacity() < scratchBufferSize)
+        if (scratchBufferSize > 0 && (!mScratchBuffer || mScratchBuffer->Capacity() < scratchBufferSize))
         {
             HAL::BufferProperties properties{ scratchBufferSize, 1, HAL::ResourceState::UnorderedAccess };
             mScratchBuffer = mResourceProducer->NewBuffer(properties);
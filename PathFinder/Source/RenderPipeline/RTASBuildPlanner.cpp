@@ -0,0 +1,427 @@
+#include "RTASBuildPlanner.hpp"
+
+#include <Foundation/Assert.hpp>
+
+#include <random>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+
+namespace PathFinder
+{
+
+    namespace
+    {
+        uint64_t AlignScratchSize(uint64_t size)
+        {
+            return (size + RTASBuildPlanner::ScratchAlignment - 1) / RTASBuildPlanner::ScratchAlignment * RTASBuildPlanner::ScratchAlignment;
+        }
+    }
+
+    RTASBuildPlanner::RTASBuildPlanner(uint64_t scratchArenaSize, uint64_t buildBudgetPerFrame, uint64_t compactionBudgetPerFrame, uint64_t maxSizeQueriesPerFrame)
+        : mScratchArenaSize{ AlignScratchSize(scratchArenaSize) },
+        mBuildBudgetPerFrame{ buildBudgetPerFrame },
+        mCompactionBudgetPerFrame{ compactionBudgetPerFrame },
+        mMaxSizeQueriesPerFrame{ std::max(maxSizeQueriesPerFrame, uint64_t(1)) } {}
+
+    RTASBuildPlanner::FramePlan RTASBuildPlanner::PlanFrame(uint64_t frameNumber, const std::vector<Build>& builds)
+    {
+        FramePlan plan{};
+        plan.Builds.reserve(builds.size());
+
+        // Mandatory builds are taken first so that deferrable ones get what's left of the budget
+        uint64_t builtBytes = 0;
+        uint64_t mandatoryBuildCount = 0;
+
+        for (const Build& build : builds)
+        {
+            if (!build.CanBeDeferred)
+            {
+                builtBytes += build.DestinationSize;
+                ++mandatoryBuildCount;
+            }
+        }
+
+        std::vector<const Build*> acceptedBuilds;
+        acceptedBuilds.reserve(builds.size());
+
+        for (const Build& build : builds)
+        {
+            // Stale compactions and size queries are cancelled by deferred builds as well
+            mLatestGenerations[build.Key] = build.Generation;
+
+            if (build.CanBeDeferred)
+            {
+                // At least one build per frame so that large structures are not starved by the budget
+                bool isFirstBuild = mandatoryBuildCount == 0 && acceptedBuilds.empty();
+
+                if (!isFirstBuild && builtBytes + build.DestinationSize > mBuildBudgetPerFrame)
+                {
+                    plan.DeferredBuilds.push_back(build);
+                    continue;
+                }
+
+                builtBytes += build.DestinationSize;
+            }
+
+            acceptedBuilds.push_back(&build);
+        }
+
+        // Arena has to take the largest build whole
+        for (const Build* build : acceptedBuilds)
+        {
+            mScratchArenaSize = std::max(mScratchArenaSize, AlignScratchSize(build->ScratchSize));
+        }
+
+        uint64_t scratchCursor = 0;
+        uint32_t batch = 0;
+
+        for (const Build* acceptedBuild : acceptedBuilds)
+        {
+            const Build& build = *acceptedBuild;
+            uint64_t scratchSize = AlignScratchSize(build.ScratchSize);
+
+            if (scratchCursor + scratchSize > mScratchArenaSize)
+            {
+                ++batch;
+                scratchCursor = 0;
+            }
+
+            plan.Builds.push_back({ build.Key, scratchCursor, batch });
+            scratchCursor += scratchSize;
+
+            uint64_t& knownScratchSize = mScratchSizes[build.Key];
+            mTotalScratchSize = mTotalScratchSize - knownScratchSize + scratchSize;
+            knownScratchSize = scratchSize;
+
+            // Rebuild replaces compacted memory with a full size one
+            auto savingsIt = mCompactionSavings.find(build.Key);
+
+            if (savingsIt != mCompactionSavings.end())
+            {
+                mTotalCompactionSavings -= savingsIt->second;
+                mCompactionSavings.erase(savingsIt);
+            }
+
+            if (build.AllowsCompaction)
+                mPendingSizeQueries.push_back({ build.Key, build.Generation, build.DestinationSize });
+        }
+
+        // Structures rebuilt since their sizes were read back are dropped here
+        uint64_t compactedOriginalSize = 0;
+
+        while (!mPendingCompactions.empty())
+        {
+            const Compaction& compaction = mPendingCompactions.front();
+
+            if (IsCurrent(compaction.Key, compaction.Generation))
+            {
+                // At least one compaction per frame so that large structures are not starved by the budget
+                if (!plan.Compactions.empty() && compactedOriginalSize + compaction.OriginalSize > mCompactionBudgetPerFrame)
+                    break;
+
+                compactedOriginalSize += compaction.OriginalSize;
+                plan.Statistics.CompactionBytesSaved += compaction.OriginalSize - compaction.CompactedSize;
+                mCompactionSavings[compaction.Key] = compaction.OriginalSize - compaction.CompactedSize;
+                mTotalCompactionSavings += compaction.OriginalSize - compaction.CompactedSize;
+                plan.Compactions.push_back(compaction);
+            }
+
+            mPendingCompactions.pop_front();
+        }
+
+        while (!mPendingSizeQueries.empty() && plan.SizeQueries.size() < mMaxSizeQueriesPerFrame)
+        {
+            const SizeQuery& query = mPendingSizeQueries.front();
+
+            if (IsCurrent(query.Key, query.Generation))
+                plan.SizeQueries.push_back(query);
+
+            mPendingSizeQueries.pop_front();
+        }
+
+        if (!plan.SizeQueries.empty())
+            mSizeQueriesInFlight[frameNumber] = plan.SizeQueries;
+
+        plan.Statistics.BuildCount = plan.Builds.size();
+        plan.Statistics.DeferredBuildCount = plan.DeferredBuilds.size();
+        plan.Statistics.BatchCount = plan.Builds.empty() ? 0 : batch + 1;
+        plan.Statistics.ScratchArenaSize = mScratchArenaSize;
+        plan.Statistics.ScratchBytesSaved = int64_t(mTotalScratchSize) - int64_t(mScratchArenaSize);
+        plan.Statistics.SizeQueryCount = plan.SizeQueries.size();
+        plan.Statistics.CompactionCount = plan.Compactions.size();
+        plan.Statistics.TotalCompactionBytesSaved = mTotalCompactionSavings;
+
+        return plan;
+    }
+
+    void RTASBuildPlanner::ReportCompactedSizes(uint64_t frameNumber, const uint64_t* compactedSizes)
+    {
+        // Readback only delivers the latest completed frame, results of frames before it are lost
+        auto it = mSizeQueriesInFlight.begin();
+
+        for (; it != mSizeQueriesInFlight.end() && it->first < frameNumber; it = mSizeQueriesInFlight.erase(it))
+        {
+            mPendingSizeQueries.insert(mPendingSizeQueries.end(), it->second.begin(), it->second.end());
+        }
+
+        if (it == mSizeQueriesInFlight.end() || it->first != frameNumber)
+            return;
+
+        assert_format(compactedSizes, "Compacted sizes are missing for a frame with size queries");
+
+        for (auto queryIdx = 0u; queryIdx < it->second.size(); ++queryIdx)
+        {
+            const SizeQuery& query = it->second[queryIdx];
+            uint64_t compactedSize = compactedSizes[queryIdx];
+
+            if (IsCurrent(query.Key, query.Generation) && compactedSize > 0 && compactedSize < query.DestinationSize)
+                mPendingCompactions.push_back({ query.Key, query.Generation, query.DestinationSize, compactedSize });
+        }
+
+        mSizeQueriesInFlight.erase(it);
+    }
+
+    void RTASBuildPlanner::RemoveStructure(uint64_t key)
+    {
+        mLatestGenerations.erase(key);
+
+        auto scratchIt = mScratchSizes.find(key);
+
+        if (scratchIt != mScratchSizes.end())
+        {
+            mTotalScratchSize -= scratchIt->second;
+            mScratchSizes.erase(scratchIt);
+        }
+
+        auto savingsIt = mCompactionSavings.find(key);
+
+        if (savingsIt != mCompactionSavings.end())
+        {
+            mTotalCompactionSavings -= savingsIt->second;
+            mCompactionSavings.erase(savingsIt);
+        }
+    }
+
+    bool RTASBuildPlanner::IsCurrent(uint64_t key, uint64_t generation) const
+    {
+        auto it = mLatestGenerations.find(key);
+        return it != mLatestGenerations.end() && it->second == generation;
+    }
+
+    bool RTASBuildPlanner::RunBenchmark(const std::filesystem::path& reportPath)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        const uint64_t StaticStructureCount = 3000;
+        const uint64_t DeformingStructureCount = 24;
+        const uint64_t StreamedInPerFrame = 150;
+        const uint64_t StaticRebuildsPerFrame = 4;
+        const uint64_t EditFrameCount = 60;
+        const uint64_t FramesInFlight = 2;
+        // Every few frames readback skips a frame the way it does when the GPU runs ahead
+        const uint64_t LostReadbackPeriod = 7;
+        const uint64_t ScratchArenaSize = 32ull << 20;
+        // Benchmark structures are never deferred, budget only has to be there
+        const uint64_t BuildBudget = 256ull << 20;
+        const uint64_t CompactionBudget = 64ull << 20;
+        const uint64_t MaxSizeQueries = 256;
+        const uint64_t MaxFrameCount = 2000;
+
+        std::ofstream stream{ reportPath, std::ios::out | std::ios::trunc };
+
+        if (!stream.is_open())
+            return false;
+
+        // Synthetic prebuild info in the ranges drivers report for 1K-100K triangle meshes
+        struct Structure
+        {
+            uint64_t Generation = 0;
+            uint64_t ScratchSize = 0;
+            uint64_t DestinationSize = 0;
+            uint64_t CompactedSize = 0;
+            bool IsStatic = true;
+            bool IsCompacted = false;
+        };
+
+        std::mt19937_64 generator{ 5050 };
+        std::uniform_int_distribution<uint64_t> triangleDistribution{ 1000, 100000 };
+        std::uniform_real_distribution<double> compactionRatioDistribution{ 0.4, 0.75 };
+
+        std::vector<Structure> structures(StaticStructureCount + DeformingStructureCount);
+        uint64_t nextGeneration = 1;
+
+        for (uint64_t key = StaticStructureCount; key < structures.size(); ++key)
+        {
+            structures[key].IsStatic = false;
+        }
+
+        RTASBuildPlanner planner{ ScratchArenaSize, BuildBudget, CompactionBudget, MaxSizeQueries };
+
+        // Stands in for the readback buffer: query results of a frame become visible once it completes
+        std::map<uint64_t, std::vector<uint64_t>> queryResults;
+
+        bool areBuildsValid = true;
+        bool areCompactionsValid = true;
+        uint64_t streamedCount = 0;
+        uint64_t buildCount = 0;
+        uint64_t batchCount = 0;
+        uint64_t maxBatchCount = 0;
+        uint64_t sizeQueryCount = 0;
+        uint64_t compactionCount = 0;
+        uint64_t maxCompactedSizePerFrame = 0;
+        uint64_t frameNumber = 0;
+        int64_t scratchBytesSaved = 0;
+        double planSeconds = 0.0;
+
+        for (; frameNumber < MaxFrameCount; ++frameNumber)
+        {
+            std::vector<Build> builds;
+
+            auto rebuild = [&](uint64_t key)
+            {
+                Structure& structure = structures[key];
+                uint64_t triangleCount = triangleDistribution(generator);
+                structure.Generation = nextGeneration++;
+                structure.DestinationSize = triangleCount * 64;
+                structure.ScratchSize = triangleCount * 40 + 1000;
+                structure.CompactedSize = uint64_t(structure.DestinationSize * compactionRatioDistribution(generator));
+                structure.IsCompacted = false;
+                builds.push_back({ key, structure.Generation, structure.ScratchSize, structure.DestinationSize, structure.IsStatic });
+            };
+
+            // Static geometry streams in over the first frames, a few static meshes get edited for a while
+            for (uint64_t key = 0; key < StreamedInPerFrame && streamedCount < StaticStructureCount; ++key)
+            {
+                rebuild(streamedCount++);
+            }
+
+            for (uint64_t rebuildIdx = 0; frameNumber < EditFrameCount && frameNumber % 3 == 0 && rebuildIdx < StaticRebuildsPerFrame; ++rebuildIdx)
+            {
+                uint64_t key = generator() % streamedCount;
+
+                if (structures[key].Generation < nextGeneration - builds.size())
+                    rebuild(key);
+            }
+
+            // Deforming geometry is rebuilt every frame
+            for (uint64_t key = StaticStructureCount; key < structures.size(); ++key)
+            {
+                rebuild(key);
+            }
+
+            auto planStart = Clock::now();
+            FramePlan plan = planner.PlanFrame(frameNumber, builds);
+            planSeconds += std::chrono::duration<double>(Clock::now() - planStart).count();
+
+            // Slices of one batch must not overlap and must fit into the arena
+            areBuildsValid &= plan.Builds.size() == builds.size();
+            uint64_t batchEnd = 0;
+
+            for (auto buildIdx = 0u; buildIdx < plan.Builds.size() && areBuildsValid; ++buildIdx)
+            {
+                const ScheduledBuild& scheduled = plan.Builds[buildIdx];
+                uint64_t scratchSize = AlignScratchSize(structures[scheduled.Key].ScratchSize);
+
+                if (buildIdx > 0 && scheduled.Batch != plan.Builds[buildIdx - 1].Batch)
+                {
+                    areBuildsValid &= scheduled.Batch == plan.Builds[buildIdx - 1].Batch + 1;
+                    batchEnd = 0;
+                }
+
+                areBuildsValid &= scheduled.Key == builds[buildIdx].Key && scheduled.ScratchOffset % ScratchAlignment == 0 &&
+                    scheduled.ScratchOffset >= batchEnd && scheduled.ScratchOffset + scratchSize <= plan.Statistics.ScratchArenaSize;
+
+                batchEnd = scheduled.ScratchOffset + scratchSize;
+            }
+
+            // Only unchanged static structures that actually shrink get compacted, and only once
+            uint64_t compactedSize = 0;
+
+            for (const Compaction& compaction : plan.Compactions)
+            {
+                Structure& structure = structures[compaction.Key];
+
+                areCompactionsValid &= structure.IsStatic && !structure.IsCompacted && compaction.Generation == structure.Generation &&
+                    compaction.CompactedSize == structure.CompactedSize && compaction.OriginalSize == structure.DestinationSize;
+
+                structure.IsCompacted = true;
+                compactedSize += compaction.OriginalSize;
+            }
+
+            areCompactionsValid &= plan.Compactions.size() <= 1 || compactedSize <= CompactionBudget;
+
+            std::vector<uint64_t>& results = queryResults[frameNumber];
+
+            for (const SizeQuery& query : plan.SizeQueries)
+            {
+                const Structure& structure = structures[query.Key];
+                areCompactionsValid &= structure.IsStatic && query.Generation == structure.Generation;
+                results.push_back(structure.CompactedSize);
+            }
+
+            if (frameNumber >= FramesInFlight)
+            {
+                uint64_t completedFrame = frameNumber - FramesInFlight;
+
+                if (completedFrame % LostReadbackPeriod != 0)
+                    planner.ReportCompactedSizes(completedFrame, queryResults[completedFrame].data());
+
+                queryResults.erase(completedFrame);
+            }
+
+            buildCount += plan.Statistics.BuildCount;
+            batchCount += plan.Statistics.BatchCount;
+            maxBatchCount = std::max(maxBatchCount, plan.Statistics.BatchCount);
+            sizeQueryCount += plan.Statistics.SizeQueryCount;
+            compactionCount += plan.Statistics.CompactionCount;
+            maxCompactedSizePerFrame = std::max(maxCompactedSizePerFrame, compactedSize);
+            scratchBytesSaved = plan.Statistics.ScratchBytesSaved;
+
+            bool isSettled = streamedCount == StaticStructureCount && planner.PendingSizeQueryCount() == 0 &&
+                planner.PendingCompactionCount() == 0 && std::all_of(queryResults.begin(), queryResults.end(), [](auto& results) { return results.second.empty(); });
+
+            if (isSettled && frameNumber > EditFrameCount)
+                break;
+        }
+
+        // Once settled every live static structure is compacted and savings match what compactions gave
+        uint64_t expectedSavings = 0;
+        uint64_t uncompactedStaticCount = 0;
+        uint64_t destinationSize = 0;
+
+        for (const Structure& structure : structures)
+        {
+            destinationSize += structure.DestinationSize;
+
+            if (!structure.IsStatic)
+                continue;
+
+            if (structure.IsCompacted)
+                expectedSavings += structure.DestinationSize - structure.CompactedSize;
+            else
+                ++uncompactedStaticCount;
+        }
+
+        bool isSettled = frameNumber < MaxFrameCount;
+        bool areSavingsConsistent = expectedSavings == planner.TotalCompactionBytesSaved();
+        bool isCompactionComplete = uncompactedStaticCount == 0;
+
+        bool isValid = areBuildsValid && areCompactionsValid && isSettled && areSavingsConsistent && isCompactionComplete && scratchBytesSaved > 0;
+
+        stream.precision(6);
+        stream << "{\"staticStructures\":" << StaticStructureCount << ",\"deformingStructures\":" << DeformingStructureCount
+            << ",\"frames\":" << frameNumber << ",\"builds\":" << buildCount << ",\"batches\":" << batchCount << ",\"maxBatchesPerFrame\":" << maxBatchCount
+            << ",\"scratchArenaSize\":" << planner.ScratchArenaSize() << ",\"scratchBytesSaved\":" << scratchBytesSaved
+            << ",\"sizeQueries\":" << sizeQueryCount << ",\"compactions\":" << compactionCount << ",\"maxCompactedBytesPerFrame\":" << maxCompactedSizePerFrame
+            << ",\"destinationBytes\":" << destinationSize << ",\"compactionBytesSaved\":" << planner.TotalCompactionBytesSaved()
+            << ",\"uncompactedStatic\":" << uncompactedStaticCount << ",\"planMicrosecondsPerFrame\":" << planSeconds * 1e6 / std::max(frameNumber, uint64_t(1))
+            << ",\"buildsValid\":" << (areBuildsValid ? "true" : "false")
+            << ",\"compactionsValid\":" << (areCompactionsValid ? "true" : "false")
+            << ",\"savingsConsistent\":" << (areSavingsConsistent ? "true" : "false")
+            << ",\"valid\":" << (isValid ? "true" : "false") << "}\n";
+
+        return isValid && stream.good();
+    }
+
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <robinhood/robin_hood.h>
+
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <map>
+#include <filesystem>
+
+namespace PathFinder
+{
+
+    /// Decides bottom acceleration structure work of a frame from structure sizes alone, so it runs without a device.
+    /// Builds take aligned slices of one shared scratch arena. Builds that don't fit into what's left of the arena
+    /// start a new batch, which reuses the arena after the previous batch completes.
+    /// Builds of structures that stay traceable with their previous contents are spread over frames within a per-frame byte budget.
+    /// Structures that allow compaction get their compacted sizes queried after build. Once sizes are read back,
+    /// structures are compacted a few at a time within a per-frame byte budget. A rebuild in between cancels compaction.
+    class RTASBuildPlanner
+    {
+    public:
+        struct Build
+        {
+            // Identifies a structure across frames
+            uint64_t Key = 0;
+            // Changes with every build of the structure
+            uint64_t Generation = 0;
+            uint64_t ScratchSize = 0;
+            uint64_t DestinationSize = 0;
+            bool AllowsCompaction = false;
+            // Previous contents stay valid until the build is recorded, so it can wait for a later frame
+            bool CanBeDeferred = false;
+        };
+
+        struct ScheduledBuild
+        {
+            uint64_t Key = 0;
+            uint64_t ScratchOffset = 0;
+            uint32_t Batch = 0;
+        };
+
+        // Results are expected in query order
+        struct SizeQuery
+        {
+            uint64_t Key = 0;
+            uint64_t Generation = 0;
+            uint64_t DestinationSize = 0;
+        };
+
+        struct Compaction
+        {
+            uint64_t Key = 0;
+            uint64_t Generation = 0;
+            uint64_t OriginalSize = 0;
+            uint64_t CompactedSize = 0;
+        };
+
+        struct FrameStatistics
+        {
+            uint64_t BuildCount = 0;
+            uint64_t DeferredBuildCount = 0;
+            uint64_t BatchCount = 0;
+            uint64_t ScratchArenaSize = 0;
+            // Scratch memory kept by every structure separately minus the arena
+            int64_t ScratchBytesSaved = 0;
+            uint64_t SizeQueryCount = 0;
+            uint64_t CompactionCount = 0;
+            // Destination memory saved by compactions of this frame and by all compacted structures alive
+            uint64_t CompactionBytesSaved = 0;
+            uint64_t TotalCompactionBytesSaved = 0;
+        };
+
+        struct FramePlan
+        {
+            std::vector<ScheduledBuild> Builds;
+            // Expected to be passed again next frame, ahead of newer builds
+            std::vector<Build> DeferredBuilds;
+            std::vector<SizeQuery> SizeQueries;
+            std::vector<Compaction> Compactions;
+            FrameStatistics Statistics;
+        };
+
+        // Required by D3D12 for both scratch and destination memory of acceleration structures
+        inline static const uint64_t ScratchAlignment = 256;
+
+        RTASBuildPlanner(uint64_t scratchArenaSize, uint64_t buildBudgetPerFrame, uint64_t compactionBudgetPerFrame, uint64_t maxSizeQueriesPerFrame);
+
+        // Builds are recorded in the given order. Compactions and size queries go after all builds of the frame.
+        // Build budget counts destination bytes. Builds that can't be deferred always go in and take from the budget too.
+        FramePlan PlanFrame(uint64_t frameNumber, const std::vector<Build>& builds);
+
+        // Takes compacted sizes of structures queried in a completed frame.
+        // Queries of earlier frames that never got their results are issued again.
+        void ReportCompactedSizes(uint64_t frameNumber, const uint64_t* compactedSizes);
+
+        // Forgets a structure cleared outside of planned work, cancelling its queries and compactions
+        void RemoveStructure(uint64_t key);
+
+        // Feeds synthetic prebuild and compacted sizes through streaming frames and validates produced plans
+        static bool RunBenchmark(const std::filesystem::path& reportPath);
+
+    private:
+        bool IsCurrent(uint64_t key, uint64_t generation) const;
+
+        uint64_t mScratchArenaSize;
+        uint64_t mBuildBudgetPerFrame;
+        uint64_t mCompactionBudgetPerFrame;
+        uint64_t mMaxSizeQueriesPerFrame;
+
+        robin_hood::unordered_flat_map<uint64_t, uint64_t> mLatestGenerations;
+        robin_hood::unordered_flat_map<uint64_t, uint64_t> mScratchSizes;
+        robin_hood::unordered_flat_map<uint64_t, uint64_t> mCompactionSavings;
+        uint64_t mTotalScratchSize = 0;
+        uint64_t mTotalCompactionSavings = 0;
+
+        std::deque<SizeQuery> mPendingSizeQueries;
+        std::map<uint64_t, std::vector<SizeQuery>> mSizeQueriesInFlight;
+        std::deque<Compaction> mPendingCompactions;
+
+    public:
+        inline uint64_t ScratchArenaSize() const { return mScratchArenaSize; }
+        inline uint64_t PendingSizeQueryCount() const { return mPendingSizeQueries.size(); }
+        inline uint64_t PendingCompactionCount() const { return mPendingCompactions.size(); }
+        inline uint64_t TotalCompactionBytesSaved() const { return mTotalCompactionSavings; }
+    };
+
+}
@@ -0,0 +1,138 @@
+#include "RTASManager.hpp"
+
+#include <Foundation/CPUProfiler.hpp>
+
+#include <chrono>
+
+namespace PathFinder
+{
+
+    RTASManager::RTASManager(WorkRecorder* recorder)
+        : mRecorder{ recorder },
+        mPlanner{ InitialScratchArenaSize, BuildByteBudgetPerFrame, CompactionByteBudgetPerFrame, MaxSizeQueriesPerFrame } {}
+
+    void RTASManager::AddStructure(uint64_t key)
+    {
+        // A fresh request supersedes the deferred one
+        mDeferredGenerations.erase(key);
+
+        if (mQueuedStructures.insert(key).second)
+            mStructuresToBuild.push_back(key);
+    }
+
+    void RTASManager::RecordBottomRTASWork()
+    {
+        PF_CPU_ZONE("RTASManager::RecordBottomRTASWork");
+
+        auto recordingStart = std::chrono::steady_clock::now();
+
+        std::vector<RTASBuildPlanner::Build> builds;
+        builds.reserve(mStructuresToBuild.size());
+
+        for (uint64_t key : mStructuresToBuild)
+        {
+            WorkRecorder::StructureDescription structure = mRecorder->DescribeStructure(key);
+            auto deferredIt = mDeferredGenerations.find(key);
+
+            // Structure waiting since an earlier frame was cleared without being built again
+            if (deferredIt != mDeferredGenerations.end() && deferredIt->second != structure.Generation)
+            {
+                mPlanner.RemoveStructure(key);
+                continue;
+            }
+
+            builds.push_back({ key, structure.Generation, structure.ScratchSize, structure.DestinationSize, structure.AllowsCompaction, structure.HoldsRecordedBuild });
+        }
+
+        RTASBuildPlanner::FramePlan plan = mPlanner.PlanFrame(mFrameNumber, builds);
+
+        std::vector<uint64_t> writtenStructures;
+        writtenStructures.reserve(plan.Builds.size() + plan.Compactions.size());
+
+        if (!plan.Builds.empty())
+        {
+            mRecorder->AllocateScratchArena(plan.Statistics.ScratchArenaSize);
+
+            uint32_t batch = 0;
+
+            for (const RTASBuildPlanner::ScheduledBuild& build : plan.Builds)
+            {
+                // Next batch reuses scratch memory of the previous one
+                if (build.Batch != batch)
+                {
+                    mRecorder->RecordScratchArenaBarrier();
+                    batch = build.Batch;
+                }
+
+                mRecorder->RecordBuild(build.Key, build.ScratchOffset);
+                writtenStructures.push_back(build.Key);
+            }
+        }
+
+        for (const RTASBuildPlanner::Compaction& compaction : plan.Compactions)
+        {
+            // Structure could have been cleared after its size was queried
+            if (mRecorder->DescribeStructure(compaction.Key).Generation != compaction.Generation)
+            {
+                mPlanner.RemoveStructure(compaction.Key);
+                continue;
+            }
+
+            mRecorder->RecordCompaction(compaction.Key, compaction.CompactedSize);
+            writtenStructures.push_back(compaction.Key);
+        }
+
+        mRecorder->RecordStructureBarriers(writtenStructures);
+
+        if (!plan.SizeQueries.empty())
+        {
+            std::vector<uint64_t> queriedStructures;
+            queriedStructures.reserve(plan.SizeQueries.size());
+
+            for (const RTASBuildPlanner::SizeQuery& query : plan.SizeQueries)
+            {
+                queriedStructures.push_back(query.Key);
+            }
+
+            mRecorder->RecordCompactedSizeQueries(queriedStructures);
+        }
+
+        mStructuresToBuild.clear();
+        mQueuedStructures.clear();
+        mDeferredGenerations.clear();
+
+        for (const RTASBuildPlanner::Build& build : plan.DeferredBuilds)
+        {
+            mStructuresToBuild.push_back(build.Key);
+            mQueuedStructures.insert(build.Key);
+            mDeferredGenerations[build.Key] = build.Generation;
+        }
+
+        mStatistics.Plan = plan.Statistics;
+        // Skipped compactions are taken back by the planner
+        mStatistics.Plan.TotalCompactionBytesSaved = mPlanner.TotalCompactionBytesSaved();
+        mStatistics.RecordingMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - recordingStart).count();
+
+        PF_CPU_COUNTER("BLAS Builds", double(plan.Statistics.BuildCount));
+        PF_CPU_COUNTER("BLAS Deferred Builds", double(plan.Statistics.DeferredBuildCount));
+        PF_CPU_COUNTER("BLAS Build Batches", double(plan.Statistics.BatchCount));
+        PF_CPU_COUNTER("BLAS Compactions", double(plan.Statistics.CompactionCount));
+        PF_CPU_COUNTER("BLAS Compaction MB Saved", mStatistics.Plan.TotalCompactionBytesSaved / (1024.0 * 1024.0));
+        PF_CPU_COUNTER("BLAS Scratch MB Saved", plan.Statistics.ScratchBytesSaved / (1024.0 * 1024.0));
+    }
+
+    void RTASManager::BeginFrame(uint64_t frameNumber)
+    {
+        mFrameNumber = frameNumber;
+    }
+
+    void RTASManager::EndFrame(uint64_t completedFrameNumber)
+    {
+        mRecorder->ReadCompactedSizes([&](const uint64_t* compactedSizes)
+        {
+            if (compactedSizes)
+                mPlanner.ReportCompactedSizes(completedFrameNumber, compactedSizes);
+        });
+    }
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "RTASBuildPlanner.hpp"
+
+#include <robinhood/robin_hood.h>
+
+#include <vector>
+#include <functional>
+
+namespace PathFinder
+{
+
+    /// Records bottom acceleration structure builds, compactions and compacted size queries as planned by RTASBuildPlanner.
+    /// Builds share one scratch arena instead of every structure keeping its own scratch buffer.
+    /// Compacted sizes are read back a few frames later, after which structures are compacted in the background.
+    /// Rebuilds of structures that stay traceable with their previous contents are spread over frames within a build budget.
+    /// Structures are referred to by key and all device work goes through a WorkRecorder, so the manager itself never touches the device.
+    class RTASManager
+    {
+    public:
+        class WorkRecorder
+        {
+        public:
+            struct StructureDescription
+            {
+                // Changes with every build or clear of the structure
+                uint64_t Generation = 0;
+                uint64_t ScratchSize = 0;
+                uint64_t DestinationSize = 0;
+                bool AllowsCompaction = false;
+                // Destination memory still holds the last recorded build, so top structures can keep using it while a rebuild waits
+                bool HoldsRecordedBuild = false;
+            };
+
+            virtual ~WorkRecorder() = default;
+
+            virtual StructureDescription DescribeStructure(uint64_t key) const = 0;
+            virtual void AllocateScratchArena(uint64_t size) = 0;
+            // Separates builds of consecutive batches that reuse the same scratch memory
+            virtual void RecordScratchArenaBarrier() = 0;
+            virtual void RecordBuild(uint64_t key, uint64_t scratchOffset) = 0;
+            virtual void RecordCompaction(uint64_t key, uint64_t compactedSize) = 0;
+            // Results are expected in key order once the frame completes
+            virtual void RecordCompactedSizeQueries(const std::vector<uint64_t>& keys) = 0;
+            // Leaves structures built or compacted this frame ready to be referenced by top structure builds
+            virtual void RecordStructureBarriers(const std::vector<uint64_t>& keys) = 0;
+            // Calls back with sizes queried in the latest completed frame or with nullptr when there is nothing to read
+            virtual void ReadCompactedSizes(const std::function<void(const uint64_t*)>& callback) = 0;
+        };
+
+        struct Statistics
+        {
+            RTASBuildPlanner::FrameStatistics Plan;
+            float RecordingMilliseconds = 0.0f;
+        };
+
+        inline static const uint64_t InitialScratchArenaSize = 32 * 1024 * 1024;
+        inline static const uint64_t BuildByteBudgetPerFrame = 128 * 1024 * 1024;
+        inline static const uint64_t CompactionByteBudgetPerFrame = 64 * 1024 * 1024;
+        inline static const uint64_t MaxSizeQueriesPerFrame = 512;
+
+        RTASManager(WorkRecorder* recorder);
+
+        // Adding a structure again before it's built is a no-op
+        void AddStructure(uint64_t key);
+
+        void RecordBottomRTASWork();
+
+        // Must be called after frame notifications of the work recorder
+        void BeginFrame(uint64_t frameNumber);
+        void EndFrame(uint64_t completedFrameNumber);
+
+    private:
+        WorkRecorder* mRecorder;
+        RTASBuildPlanner mPlanner;
+
+        std::vector<uint64_t> mStructuresToBuild;
+        robin_hood::unordered_flat_set<uint64_t> mQueuedStructures;
+
+        // Generations that builds were deferred with. A structure that changed without being added again was cleared meanwhile.
+        robin_hood::unordered_flat_map<uint64_t, uint64_t> mDeferredGenerations;
+
+        uint64_t mFrameNumber = 0;
+        Statistics mStatistics;
+
+    public:
+        inline const Statistics& GetStatistics() const { return mStatistics; }
+        inline uint64_t QueuedStructureCount() const { return mStructuresToBuild.size(); }
+    };
+
+}
@@ -1,10 +1,18 @@
 #include "RenderDevice.hpp"
 
 #include <Foundation/Visitor.hpp>
+#include <Foundation/CPUProfiler.hpp>
+
+#include <chrono>
 
 namespace PathFinder
 {
 
+    namespace
+    {
+        const Foundation::Name BarriersMeasurementName{ "Barriers" };
+    }
+
     RenderDevice::RenderDevice(
         const HAL::Device& device, 
         Memory::PoolDescriptorAllocator* descriptorAllocator,
@@ -44,7 +52,7 @@ namespace PathFinder
 
     RenderDevice::PassCommandLists& RenderDevice::CommandListsForPass(const RenderPassGraph::Node& node)
     {
-        return mFrameBlueprint.GetRenderPassEvent(node).CommandLists;
+        return mPerPassCommandLists[node.GlobalExecutionIndex()];
     }
 
     RenderDevice::PassHelpers& RenderDevice::PassHelpersForPass(const RenderPassGraph::Node& node)
@@ -80,8 +88,6 @@ namespace PathFinder
 
     void RenderDevice::PrepareForGraphExecution()
     {
-        mFrameBlueprint.Build();
-
         mPassHelpers.resize(mRenderPassGraph->NodesInGlobalExecutionOrder().size());
 
         for (const RenderPassGraph::Node* node : mRenderPassGraph->NodesInGlobalExecutionOrder())
@@ -100,6 +106,9 @@ namespace PathFinder
 
         mPassBarrierMeasurements.clear();
 
+        mPerPassCommandLists.clear();
+        mPerPassCommandLists.resize(mRenderPassGraph->NodesInGlobalExecutionOrder().size());
+
         mGPUProfiler->SetPerQueueTimestampFrequencies(GetQueueTimestampFrequencies());
 
         // If memory layout did not change we reuse aliasing barriers from previous frame.
@@ -114,7 +123,7 @@ namespace PathFinder
         {
             CommandListPtrVariant cmdListVariant = AllocateCommandListForQueue(node->ExecutionQueueIndex);
             GetComputeCommandListBase(cmdListVariant)->SetDebugName(node->PassMetadata().Name.ToString() + " Worker Cmd List");
-            mFrameBlueprint.GetRenderPassEvent(*node).CommandLists.WorkCommandList = std::move(cmdListVariant);
+            mPerPassCommandLists[node->GlobalExecutionIndex()].WorkCommandList = std::move(cmdListVariant);
 
             // UAV barriers must be ready before command list recording.
             // Process aliasing barriers while we're at it too.
@@ -154,49 +163,370 @@ namespace PathFinder
 
     void RenderDevice::GatherMeasurements()
     {
+        // Completed events only change when another GPU frame completes. Storing them on every CPU frame
+        // would record the same timings several times and skew percentiles and spike detection.
+        uint64_t gpuFrameNumber = mGPUProfiler->CompletedFrameNumber();
+        bool isNewGPUFrame = gpuFrameNumber != mLastMeasuredGPUFrameNumber;
+
+        mLastMeasuredGPUFrameNumber = gpuFrameNumber;
+
+        if (isNewGPUFrame)
+            mMeasurementStorage.BeginFrame();
+
         for (PipelineMeasurement& measurement : mPassWorkMeasurements)
         {
             const GPUProfiler::Event& event = mGPUProfiler->GetCompletedEvent(measurement.ProfilerEventID);
             measurement.DurationSeconds = event.DurationSeconds;
+
+            if (isNewGPUFrame)
+                mMeasurementStorage.AddPassWorkSample(measurement.Name, event.QueueIndex, event.DurationSeconds);
         }
 
         for (PipelineMeasurement& measurement : mPassBarrierMeasurements)
         {
             const GPUProfiler::Event& event = mGPUProfiler->GetCompletedEvent(measurement.ProfilerEventID);
             measurement.DurationSeconds = event.DurationSeconds;
+
+            if (isNewGPUFrame)
+                mMeasurementStorage.AddBarrierSample(event.QueueIndex, event.DurationSeconds, measurement.PassName);
         }
 
         mFrameMeasurement.DurationSeconds = mGPUProfiler->GetCompletedEvent(mFrameMeasurement.ProfilerEventID).DurationSeconds;
+
+        if (isNewGPUFrame)
+        {
+            mMeasurementStorage.AddFrameSample(mFrameMeasurement.Name, mFrameMeasurement.DurationSeconds);
+            mMeasurementStorage.EndFrame();
+        }
+
+        SubmitMeasurementsToCPUProfiler();
     }
 
-    void RenderDevice::RecordNonWorkerCommandLists()
+    void RenderDevice::SubmitMeasurementsToCPUProfiler()
     {
-        mPerNodeBeginBarriers.clear();
-        mPerNodeBeginBarriers.resize(mRenderPassGraph->NodesInGlobalExecutionOrder().size());
+        Foundation::CPUProfiler& cpuProfiler = Foundation::CPUProfiler::SharedInstance();
+
+        // Events belong to the latest completed GPU frame, which lags behind the CPU frame being recorded.
+        // They are only refreshed once another frame completes, so the same events are never submitted twice.
+        uint64_t gpuFrameNumber = mGPUProfiler->CompletedFrameNumber();
+
+        if (!cpuProfiler.IsCaptureEnabled() || gpuFrameNumber == mLastProfiledGPUFrameNumber)
+            return;
+
+        mLastProfiledGPUFrameNumber = gpuFrameNumber;
+
+        // CPU profiler uses steady_clock which is backed by QPC, 
+        // so calibrated CPU timestamps map directly onto the profiler timeline
+        LARGE_INTEGER qpcFrequency{};
+        QueryPerformanceFrequency(&qpcFrequency);
 
+        std::vector<uint64_t> timestampFrequencies = GetQueueTimestampFrequencies();
+        std::vector<std::pair<uint64_t, uint64_t>> calibrations;
+        std::vector<std::vector<Foundation::CPUProfiler::ExternalEvent>> perQueueEvents(mQueueCount);
+
+        for (auto queueIdx = 0; queueIdx < mQueueCount; ++queueIdx)
+            calibrations.push_back(GetCommandQueue(queueIdx).GetClockCalibration());
+
+        auto toProfilerTimeNS = [&](uint64_t queueIndex, uint64_t gpuTimestamp) -> uint64_t
+        {
+            auto [gpuCalibrationTimestamp, cpuCalibrationTimestamp] = calibrations[queueIndex];
+            double cpuSeconds = double(cpuCalibrationTimestamp) / qpcFrequency.QuadPart;
+            double gpuDeltaSeconds = (double(gpuTimestamp) - double(gpuCalibrationTimestamp)) / timestampFrequencies[queueIndex];
+            return uint64_t((cpuSeconds + gpuDeltaSeconds) * 1e9);
+        };
+
+        auto addEvent = [&](const PipelineMeasurement& measurement)
+        {
+            const GPUProfiler::Event& event = mGPUProfiler->GetCompletedEvent(measurement.ProfilerEventID);
+
+            if (event.StartTimestamp == 0 || event.EndTimestamp < event.StartTimestamp)
+                return;
+
+            perQueueEvents[event.QueueIndex].push_back({ 
+                measurement.Name, 
+                toProfilerTimeNS(event.QueueIndex, event.StartTimestamp), 
+                toProfilerTimeNS(event.QueueIndex, event.EndTimestamp),
+                gpuFrameNumber });
+        };
+
+        addEvent(mFrameMeasurement);
+
+        for (const PipelineMeasurement& measurement : mPassWorkMeasurements)
+            addEvent(measurement);
+
+        for (const PipelineMeasurement& measurement : mPassBarrierMeasurements)
+            addEvent(measurement);
+
+        for (auto queueIdx = 0; queueIdx < mQueueCount; ++queueIdx)
+            cpuProfiler.RecordExternalEvents(StringFormat("GPU Queue %d", queueIdx), perQueueEvents[queueIdx]);
+    }
+
+    void RenderDevice::RecordNonWorkerCommandLists()
+    {
         mPerNodeReadbackInfo.clear();
         mPerNodeReadbackInfo.resize(mRenderPassGraph->NodesInGlobalExecutionOrder().size());
 
-        mSubresourcesPreviousUsageInfo.clear();
+        mBackBufferTransition = std::nullopt;
+        mBackBufferBeginTransition = std::nullopt;
+
+        auto planningStartTime = std::chrono::steady_clock::now();
+
+        bool isReplayed = CanReplayCompiledFrame();
+
+        if (isReplayed)
+        {
+            PF_CPU_ZONE("ReplayCompiledFrame");
+            ReplayCompiledFrame();
+        }
+        else
+        {
+            PF_CPU_ZONE("CompileFrame");
+            CompileFrame();
+        }
+
+        double planningSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - planningStartTime).count();
+
+        // Smooth out timings so that compile and replay costs could be compared on live frames
+        auto accumulate = [](double& average, double sample, uint64_t sampleCount)
+        {
+            average = sampleCount == 1 ? sample : average + (sample - average) * 0.05;
+        };
+
+        if (isReplayed)
+            accumulate(mFramePlanStatistics.ReplaySeconds, planningSeconds, ++mFramePlanStatistics.HitCount);
+        else
+            accumulate(mFramePlanStatistics.CompileSeconds, planningSeconds, ++mFramePlanStatistics.MissCount);
+
+        RecordResourceTransitions();
+        RecordPostWorkCommandLists();
+    }
+
+    bool RenderDevice::CanReplayCompiledFrame() const
+    {
+        if (!mPipelinesSettings->IsFramePlanCachingEnabled)
+            return false;
+
+        bool isCompatible =
+            mCompiledFrame.IsReplayable &&
+            mCompiledFrame.GraphStructureHash == mRenderPassGraph->StructureHash() &&
+            mCompiledFrame.MemoryLayoutVersion == mResourceStorage->MemoryLayoutVersion() &&
+            mCompiledFrame.IsSplitBarriersEnabled == mPipelinesSettings->IsSplitBarriersEnabled;
+
+        if (!isCompatible)
+            return false;
+
+        // Barriers were recorded for particular states resources enter the frame in.
+        // They usually match after the first frame that compiled the plan, but uploads 
+        // or other frame layouts in between may have left resources in different states.
+        for (const CompiledFrame::SubresourceStates& states : mCompiledFrame.TrackedSubresourceStates)
+        {
+            if (mResourceStateTracker->ResourceCurrentStates(states.Resource)[states.SubresourceIndex].State != states.EntryState)
+                return false;
+        }
+
+        return true;
+    }
+
+    void RenderDevice::ReplayCompiledFrame()
+    {
+        // Bring state tracker to where the frame leaves resources, as if transitions were requested one by one
+        for (const CompiledFrame::SubresourceStates& states : mCompiledFrame.TrackedSubresourceStates)
+        {
+            mResourceStateTracker->TransitionToStateImmediately(states.Resource, states.ExitState, states.SubresourceIndex, false);
+        }
+
+        if (mCompiledFrame.BackBufferTransitionPassIndex != BarrierPlanner::InvalidIndex)
+        {
+            mBackBufferTransition = mResourceStateTracker->TransitionToStateImmediately(mBackBuffer->HALResource(), HAL::ResourceState::RenderTarget, 0, false);
+        }
+
+        // Readbacks are requested every frame, but frames that read back graph resources are never replayed,
+        // so readback transitions here only touch resources the compiled frame doesn't know about
+        robin_hood::unordered_flat_set<Memory::GPUResource*> resourcesToReadback;
 
         for (const RenderPassGraph::DependencyLevel& dependencyLevel : mRenderPassGraph->DependencyLevels())
         {
-            mDependencyLevelStandardTransitions.clear();
-    
-            mDependencyLevelStandardTransitions.resize(dependencyLevel.Nodes().size());
+            for (const RenderPassGraph::Node* node : dependencyLevel.Nodes())
+            {
+                resourcesToReadback.clear();
+                GatherNodeReadbacks(*node, resourcesToReadback);
+            }
+        }
+    }
 
-            mDependencyLevelTransitionsToReroute.clear();
+    void RenderDevice::CompileFrame()
+    {
+        mFrameBlueprint.Build();
+
+        mPerNodeInterpassUAVBarriers.clear();
+        mPerNodeInterpassUAVBarriers.resize(mRenderPassGraph->NodesInGlobalExecutionOrder().size());
+
+        mPerNodeTransitionRequests.clear();
+        mPerNodeTransitionRequests.resize(mRenderPassGraph->NodesInGlobalExecutionOrder().size());
 
-            mDependencyLevelInterpassUAVBarriers.clear();
-            mDependencyLevelInterpassUAVBarriers.resize(dependencyLevel.Nodes().size());
+        mFrameTransitionInfos.clear();
+        mTrackedSubresourceStateIndices.clear();
+        mBackBufferTransitionRequestIndex = BarrierPlanner::InvalidIndex;
 
+        mCompiledFrame.GraphStructureHash = mRenderPassGraph->StructureHash();
+        mCompiledFrame.MemoryLayoutVersion = mResourceStorage->MemoryLayoutVersion();
+        mCompiledFrame.IsSplitBarriersEnabled = mPipelinesSettings->IsSplitBarriersEnabled;
+        mCompiledFrame.IsReplayable = true;
+        mCompiledFrame.BackBufferTransitionPassIndex = BarrierPlanner::InvalidIndex;
+        mCompiledFrame.TrackedSubresourceStates.clear();
+
+        GatherPassPlanningInfo();
+
+        // Transitions of the whole frame are gathered first, so that the planner
+        // could see all usages of a subresource before deciding where to place barriers
+        for (const RenderPassGraph::DependencyLevel& dependencyLevel : mRenderPassGraph->DependencyLevels())
+        {
+            mDependencyLevelTransitionsToReroute.clear();
             mDependencyLevelQueuesThatRequireTransitionRerouting.clear();
 
             GatherResourceTransitionKnowledge(dependencyLevel);
-            RecordResourceTransitions(dependencyLevel);
         }
 
-        RecordPostWorkCommandLists();
+        for (CompiledFrame::SubresourceStates& states : mCompiledFrame.TrackedSubresourceStates)
+        {
+            states.ExitState = mResourceStateTracker->ResourceCurrentStates(states.Resource)[states.SubresourceIndex].State;
+        }
+
+        PlanResourceTransitions();
+        CompileFrameBarriers();
+        CompileFrameBlueprint();
+    }
+
+    void RenderDevice::CompileFrameBarriers()
+    {
+        mCompiledFrame.PerPassPreWorkBarriers.clear();
+        mCompiledFrame.PerPassPreWorkBarriers.resize(mRenderPassGraph->NodesInGlobalExecutionOrder().size());
+
+        mCompiledFrame.PerPassBeginBarriers.clear();
+        mCompiledFrame.PerPassBeginBarriers.resize(mRenderPassGraph->NodesInGlobalExecutionOrder().size());
+
+        for (const RenderPassGraph::Node* node : mRenderPassGraph->NodesInGlobalExecutionOrder())
+        {
+            HAL::ResourceBarrierCollection& nodeBarriers = mCompiledFrame.PerPassPreWorkBarriers[node->GlobalExecutionIndex()];
+            CollectNodeStandardTransitions(*node, nodeBarriers);
+            CollectNodeUAVAndAliasingBarriers(*node, nodeBarriers);
+        }
+
+        mCompiledFrame.ReroutedTransitionBarriers.clear();
+        mCompiledFrame.ReroutedTransitionBarriers.resize(mBarrierPlan.RerouteEvents.size());
+
+        for (auto requestIdx = 0u; requestIdx < mBarrierPlan.Placements.size(); ++requestIdx)
+        {
+            uint64_t eventIdx = mBarrierPlan.Placements[requestIdx].RerouteEventIndex;
+
+            if (eventIdx != BarrierPlanner::InvalidIndex)
+                mCompiledFrame.ReroutedTransitionBarriers[eventIdx].AddBarrier(*mFrameTransitionInfos[requestIdx].TransitionBarrier);
+        }
+
+        if (mBackBufferTransitionRequestIndex != BarrierPlanner::InvalidIndex)
+        {
+            mCompiledFrame.BackBufferTransitionPlacement = mBarrierPlan.Placements[mBackBufferTransitionRequestIndex];
+            mBackBufferTransition = mFrameTransitionInfos[mBackBufferTransitionRequestIndex].TransitionBarrier;
+        }
+    }
+
+    void RenderDevice::CompileFrameBlueprint()
+    {
+        // Events are ordered by dependency level, which blueprint relies on when inserting them
+        for (auto eventIdx = 0u; eventIdx < mBarrierPlan.RerouteEvents.size(); ++eventIdx)
+        {
+            const BarrierPlanner::RerouteEvent& rerouteEvent = mBarrierPlan.RerouteEvents[eventIdx];
+
+            mFrameBlueprint.InsertReroutedTransitionsEvent(
+                rerouteEvent.AfterDependencyLevel, rerouteEvent.ServedDependencyLevels, rerouteEvent.QueueIndex, rerouteEvent.QueuesToSync, eventIdx
+            );
+        }
+
+        mCompiledFrame.Operations.clear();
+        mCompiledFrame.Signals.clear();
+        mCompiledFrame.Waits.clear();
+
+        // Waits may refer to signals on queues that are traversed later, so all signals are enumerated first.
+        // Signals are enumerated in traversal order, which is also the order fence values are generated in.
+        robin_hood::unordered_flat_map<const FrameBlueprint::Signal*, uint64_t> signalIndices;
+
+        auto addSignal = [&](const FrameBlueprint::Signal& signal)
+        {
+            signalIndices[&signal] = mCompiledFrame.Signals.size();
+            mCompiledFrame.Signals.push_back(CompiledFrame::Signal{ signal.Fence, signal.SignalName });
+        };
+
+        mFrameBlueprint.Traverse([&](uint64_t queueIndex, FrameBlueprint::Event& event)
+        {
+            std::visit(Foundation::MakeVisitor(
+            [&](FrameBlueprint::RenderPassEvent& e) { if (e.SignalEvent) addSignal(*e.SignalEvent); },
+            [&](FrameBlueprint::ReroutedTransitionsEvent& e) { addSignal(e.SignalEvent); }),
+            event);
+        });
+
+        auto addOperation = [&](CompiledFrame::OperationType type, uint64_t queueIndex, uint64_t index)
+        {
+            mCompiledFrame.Operations.push_back(CompiledFrame::Operation{ type, queueIndex, index });
+        };
+
+        auto addWait = [&](const FrameBlueprint::Wait& wait, uint64_t queueIndex)
+        {
+            for (auto signalIdx = 0; signalIdx < wait.SignalsToWait.size(); ++signalIdx)
+            {
+                const FrameBlueprint::Signal* signal = wait.SignalsToWait[signalIdx];
+                uint64_t compiledSignalIdx = signal == mFrameBlueprint.BVHBuildSignal() ? CompiledFrame::BVHBuildSignalIndex : signalIndices[signal];
+
+                addOperation(CompiledFrame::OperationType::Wait, queueIndex, mCompiledFrame.Waits.size());
+                mCompiledFrame.Waits.push_back(CompiledFrame::Wait{ compiledSignalIdx, wait.EventNamesToWait[signalIdx] });
+            }
+        };
+
+        mFrameBlueprint.Traverse([&](uint64_t queueIndex, FrameBlueprint::Event& event)
+        {
+            std::visit(Foundation::MakeVisitor(
+            [&](FrameBlueprint::RenderPassEvent& e)
+            {
+                if (e.WaitEvent)
+                    addWait(*e.WaitEvent, queueIndex);
+
+                addOperation(CompiledFrame::OperationType::ExecutePass, queueIndex, e.PassIndex);
+
+                if (e.SignalEvent)
+                    addOperation(CompiledFrame::OperationType::Signal, queueIndex, signalIndices[&(*e.SignalEvent)]);
+            },
+            [&](FrameBlueprint::ReroutedTransitionsEvent& e)
+            {
+                addWait(e.WaitEvent, queueIndex);
+                addOperation(CompiledFrame::OperationType::ExecuteReroutedTransitions, queueIndex, e.RerouteEventIndex);
+                addOperation(CompiledFrame::OperationType::Signal, queueIndex, signalIndices[&e.SignalEvent]);
+            }),
+            event);
+        });
+    }
+
+    void RenderDevice::GatherPassPlanningInfo()
+    {
+        mFrameTransitions = {};
+        mFrameTransitions.QueueCount = mQueueCount;
+        mFrameTransitions.Passes.resize(mRenderPassGraph->NodesInGlobalExecutionOrder().size());
+        mFrameTransitions.DependencyLevelReroutingQueues.resize(mRenderPassGraph->DependencyLevels().size());
+
+        for (const RenderPassGraph::Node* node : mRenderPassGraph->NodesInGlobalExecutionOrder())
+        {
+            BarrierPlanner::PassInfo& passInfo = mFrameTransitions.Passes[node->GlobalExecutionIndex()];
+            passInfo.QueueIndex = node->ExecutionQueueIndex;
+            passInfo.LocalToQueueExecutionIndex = node->LocalToQueueExecutionIndex();
+            passInfo.DependencyLevelIndex = node->DependencyLevelIndex();
+            passInfo.BatchIndex = mFrameBlueprint.GetRenderPassEvent(*node).EstimatedBatchIndex;
+            passInfo.SynchronizationIndices = node->SynchronizationIndices();
+
+            // Timings from previous frames let the planner judge whether a split barrier has enough work to overlap with
+            if (const PipelineMeasurementStorage::Series* series = mMeasurementStorage.GetSeries(
+                node->PassMetadata().Name, PipelineMeasurementStorage::MeasurementType::PassWork, node->ExecutionQueueIndex))
+            {
+                passInfo.Duration = series->Stats.Mean;
+            }
+        }
     }
 
     void RenderDevice::GatherResourceTransitionKnowledge(const RenderPassGraph::DependencyLevel& dependencyLevel)
@@ -225,6 +555,20 @@ namespace PathFinder
 
                 PipelineResourceStorageResource* resourceData = mResourceStorage->GetPerResourceData(resourceName);
                 const PipelineResourceSchedulingInfo::PassInfo* passInfo = resourceData->SchedulingInfo.GetInfoForPass(node->PassMetadata().Name);
+                const HAL::Resource* resource = resourceData->GetGPUResource()->HALResource();
+
+                // Render graph works with resource name aliases, so we need to track transitions for the resource using its original name,
+                // otherwise we would lose transition history and place incorrect Begin/End barriers
+                RenderPassGraph::SubresourceName originalSubresourceName = RenderPassGraph::ConstructSubresourceName(resourceData->ResourceName(), subresourceIndex);
+
+                // Remember state subresource enters the frame in, compiled frame is only valid for the same entry states
+                auto [stateIndexIt, isFirstUsageInFrame] = mTrackedSubresourceStateIndices.try_emplace(originalSubresourceName, mCompiledFrame.TrackedSubresourceStates.size());
+
+                if (isFirstUsageInFrame)
+                {
+                    HAL::ResourceState entryState = mResourceStateTracker->ResourceCurrentStates(resource)[subresourceIndex].State;
+                    mCompiledFrame.TrackedSubresourceStates.push_back(CompiledFrame::SubresourceStates{ resource, subresourceIndex, entryState });
+                }
 
                 // When read by multiple queues is requested we can't just take read state from the current render pass,
                 // we need to gather read states from all render passes in dependency level that read this resource
@@ -233,7 +577,7 @@ namespace PathFinder
                     passInfo->SubresourceInfos[subresourceIndex]->RequestedState;
 
                 std::optional<HAL::ResourceTransitionBarrier> barrier =
-                    mResourceStateTracker->TransitionToStateImmediately(resourceData->GetGPUResource()->HALResource(), newState, subresourceIndex, false);
+                    mResourceStateTracker->TransitionToStateImmediately(resource, newState, subresourceIndex, false);
 
                 // First pass on graphic queue needs to transition back buffer to RenderTarget state
                 if (node->ExecutionQueueIndex == 0 && !backBufferTransitioned)
@@ -243,16 +587,16 @@ namespace PathFinder
 
                     if (backBufferBarrier)
                     {
-                        mDependencyLevelStandardTransitions[node->LocalToDependencyLevelExecutionIndex()].push_back({ 0, *backBufferBarrier, mBackBuffer->HALResource() });
+                        mBackBufferTransitionRequestIndex = mFrameTransitions.Requests.size();
+                        AddTransitionRequest(*node, { 0, *backBufferBarrier, mBackBuffer->HALResource() }, false);
                     }
 
+                    // Back buffer is different each frame, so compiled frame only remembers where to transition it
+                    mCompiledFrame.BackBufferTransitionPassIndex = node->GlobalExecutionIndex();
                     backBufferTransitioned = true; 
                 }
                 
-                // Render graph works with resource name aliases, so we need to track transitions for the resource using its original name,
-                // otherwise we would lose transition history and place incorrect Begin/End barriers
-                RenderPassGraph::SubresourceName originalSubresourceName = RenderPassGraph::ConstructSubresourceName(resourceData->ResourceName(), subresourceIndex);
-                SubresourceTransitionInfo transitionInfo{ originalSubresourceName, barrier, resourceData->GetGPUResource()->HALResource() };
+                SubresourceTransitionInfo transitionInfo{ originalSubresourceName, barrier, resource };
 
                 bool doesTransitionNeedRerouting = false;
 
@@ -262,8 +606,7 @@ namespace PathFinder
                     // If barrier is redundant but new state contains UnorderedAccess, we have a case of UAV->UAV usage between render passes
                     if (EnumMaskContains(newState, HAL::ResourceState::UnorderedAccess))
                     {
-                        mDependencyLevelInterpassUAVBarriers[node->LocalToDependencyLevelExecutionIndex()].AddBarrier(
-                            HAL::UnorderedAccessResourceBarrier{ resourceData->GetGPUResource()->HALResource() });
+                        mPerNodeInterpassUAVBarriers[node->GlobalExecutionIndex()].AddBarrier(HAL::UnorderedAccessResourceBarrier{ resource });
                     }
                 }
                 else
@@ -285,14 +628,22 @@ namespace PathFinder
                 }
 
                 // Keep track even of redundant transitions for later stage to correctly keep track of resource usage history
-                doesTransitionNeedRerouting ?
-                    mDependencyLevelTransitionsToReroute.push_back(transitionInfo) :
-                    mDependencyLevelStandardTransitions[node->LocalToDependencyLevelExecutionIndex()].push_back(transitionInfo);
+                if (doesTransitionNeedRerouting)
+                {
+                    mDependencyLevelTransitionsToReroute.emplace_back(node, transitionInfo);
+                }
+                else
+                {
+                    AddTransitionRequest(*node, transitionInfo, false);
+                }
 
-                // Prepare list of resources that need to be read back after render pass work is completed
+                // Prepare list of resources that need to be read back after render pass work is completed.
+                // Readback transitions happen in the middle of a frame outside of planned transitions, 
+                // which compiled frame can't reproduce.
                 if (passInfo->IsReadbackRequested)
                 {
                     resourcesToReadback.insert(resourceData->GetGPUResource());
+                    mCompiledFrame.IsReplayable = false;
                 }
             };
 
@@ -306,28 +657,88 @@ namespace PathFinder
                 requestTransition(subresourceName, false);
             }
 
-            // Readback GPU inspector buffer for pass
-            if (Memory::Buffer* buffer = mGPUDataInspector->BufferForPass(*node))
-                resourcesToReadback.insert(buffer);
+            GatherNodeReadbacks(*node, resourcesToReadback);
+        }
 
-            // Now that we know resources that need to be read back we gather 
-            // and then batch transitions and copy commands
-            for (Memory::GPUResource* resourceToReadback : resourcesToReadback)
-            {
-                resourceToReadback->RequestRead();
-            }
+        for (const auto& [node, transitionInfo] : mDependencyLevelTransitionsToReroute)
+        {
+            AddTransitionRequest(*node, transitionInfo, true);
+        }
+
+        std::vector<uint64_t>& reroutingQueues = mFrameTransitions.DependencyLevelReroutingQueues[dependencyLevel.LevelIndex()];
+        reroutingQueues.assign(mDependencyLevelQueuesThatRequireTransitionRerouting.begin(), mDependencyLevelQueuesThatRequireTransitionRerouting.end());
+        std::sort(reroutingQueues.begin(), reroutingQueues.end());
+    }
+
+    void RenderDevice::GatherNodeReadbacks(const RenderPassGraph::Node& node, robin_hood::unordered_flat_set<Memory::GPUResource*>& resourcesToReadback)
+    {
+        // Readback GPU inspector buffer for pass
+        if (Memory::Buffer* buffer = mGPUDataInspector->BufferForPass(node))
+            resourcesToReadback.insert(buffer);
+
+        // Now that we know resources that need to be read back we gather 
+        // and then batch transitions and copy commands
+        for (Memory::GPUResource* resourceToReadback : resourcesToReadback)
+        {
+            resourceToReadback->RequestRead();
+        }
+
+        ResourceReadbackInfo& readbackInfo = mPerNodeReadbackInfo[node.GlobalExecutionIndex()];
+
+        for (const Memory::CopyRequestManager::CopyRequest& request : mCopyRequestManager->ReadbackRequests())
+        {
+            HAL::ResourceBarrierCollection toCopyBarriers = mResourceStateTracker->TransitionToStateImmediately(request.Resource, HAL::ResourceState::CopySource);
+            readbackInfo.CopyCommands.push_back(request.Command);
+            readbackInfo.ToCopyStateTransitions.AddBarriers(toCopyBarriers);
+        }
+
+        mCopyRequestManager->FlushReadbackRequests();
+    }
+
+    void RenderDevice::AddTransitionRequest(const RenderPassGraph::Node& node, const SubresourceTransitionInfo& transitionInfo, bool needsRerouting)
+    {
+        BarrierPlanner::TransitionRequest request{};
+        request.SubresourceName = transitionInfo.SubresourceName;
+        request.PassIndex = node.GlobalExecutionIndex();
 
-            ResourceReadbackInfo& readbackInfo = mPerNodeReadbackInfo[node->GlobalExecutionIndex()];
+        if (transitionInfo.TransitionBarrier)
+        {
+            HAL::ResourceState beforeStates = transitionInfo.TransitionBarrier->BeforeStates();
+            HAL::ResourceState afterStates = transitionInfo.TransitionBarrier->AfterStates();
+
+            request.Type = needsRerouting ? BarrierPlanner::TransitionType::Reroute : BarrierPlanner::TransitionType::Standard;
+            request.IsImplicitTransitionPossible = Memory::ResourceStateTracker::CanResourceBeImplicitlyTransitioned(*transitionInfo.Resource, beforeStates, afterStates);
 
-            for (const Memory::CopyRequestManager::CopyRequest& request : mCopyRequestManager->ReadbackRequests())
+            for (auto queueIdx = 0; queueIdx < mQueueCount; ++queueIdx)
             {
-                HAL::ResourceBarrierCollection toCopyBarriers = mResourceStateTracker->TransitionToStateImmediately(request.Resource, HAL::ResourceState::CopySource);
-                readbackInfo.CopyCommands.push_back(request.Command);
-                readbackInfo.ToCopyStateTransitions.AddBarriers(toCopyBarriers);
+                if (IsStateTransitionSupportedOnQueue(queueIdx, beforeStates, afterStates))
+                    request.SupportingQueueMask |= 1u << queueIdx;
             }
+        }
+
+        if (!needsRerouting)
+        {
+            mPerNodeTransitionRequests[node.GlobalExecutionIndex()].push_back(mFrameTransitions.Requests.size());
+        }
 
-            mCopyRequestManager->FlushReadbackRequests();
+        mFrameTransitions.Requests.push_back(request);
+        mFrameTransitionInfos.push_back(transitionInfo);
+    }
+
+    void RenderDevice::PlanResourceTransitions()
+    {
+        mBarrierPlan = mBarrierPlanner.PlanTransitions(mFrameTransitions, mPipelinesSettings->IsSplitBarriersEnabled);
+
+        // Scoring plans the frame a second time, so it's only done on request
+        if (!mPipelinesSettings->IsBarrierPlanScoringEnabled)
+        {
+            mBarrierPlanScore = std::nullopt;
+            mLegacyBarrierPlanScore = std::nullopt;
+            return;
         }
+
+        mBarrierPlanScore = BarrierPlanner::Evaluate(mFrameTransitions, mBarrierPlan);
+        mLegacyBarrierPlanScore = BarrierPlanner::Evaluate(mFrameTransitions, BarrierPlanner::PlanLegacyTransitions(mFrameTransitions, mPipelinesSettings->IsSplitBarriersEnabled));
     }
 
     void RenderDevice::AllocateAndRecordPreWorkCommandList(const RenderPassGraph::Node& node, const HAL::ResourceBarrierCollection& barriers, const std::string& cmdListName)
@@ -344,7 +755,7 @@ namespace PathFinder
         
         mEventTracker.StartGPUEvent(node.PassMetadata().Name.ToString() + " " + cmdListName, *transitionsCommandList);
         GPUProfiler::EventID profilerEventID = mGPUProfiler->RecordEventStart(*transitionsCommandList, node.ExecutionQueueIndex);
-        mPassBarrierMeasurements.emplace_back(PipelineMeasurement{ "", profilerEventID, 0 });
+        mPassBarrierMeasurements.emplace_back(PipelineMeasurement{ BarriersMeasurementName, profilerEventID, 0, node.PassMetadata().Name });
 
         transitionsCommandList->InsertBarriers(barriers);
 
@@ -354,31 +765,23 @@ namespace PathFinder
         transitionsCommandList->Close();
     }
 
-    void RenderDevice::AllocateAndRecordReroutedTransitionsCommandList(std::optional<uint64_t> reroutingDependencyLevelIndex, uint64_t currentDependencyLevelIndex, const HAL::ResourceBarrierCollection& barriers)
+    void RenderDevice::AllocateAndRecordReroutedTransitionsCommandList(uint64_t rerouteEventIndex, const HAL::ResourceBarrierCollection& barriers)
     {
-        uint64_t mostCompetentQueueIndex = FindMostCompetentQueueIndex(mDependencyLevelQueuesThatRequireTransitionRerouting);
-
-        std::vector<uint64_t> queuesToSync;
-
-        for (uint64_t queueIndex : mDependencyLevelQueuesThatRequireTransitionRerouting)
-        {
-            if (queueIndex != mostCompetentQueueIndex)
-                queuesToSync.push_back(queueIndex);
-        }
+        const BarrierPlanner::RerouteEvent& rerouteEvent = mBarrierPlan.RerouteEvents[rerouteEventIndex];
 
-        FrameBlueprint::ReroutedTransitionsEvent& transitionsEvent = mFrameBlueprint.InsertReroutedTransitionsEvent(
-            reroutingDependencyLevelIndex, currentDependencyLevelIndex, mostCompetentQueueIndex, queuesToSync
-        );
+        uint64_t firstServedDependencyLevel = rerouteEvent.ServedDependencyLevels.front();
+        uint64_t lastServedDependencyLevel = rerouteEvent.ServedDependencyLevels.back();
 
-        transitionsEvent.CommandList = AllocateCommandListForQueue(mostCompetentQueueIndex);
+        CommandListPtrVariant& commandList = mReroutedTransitionCommandLists[rerouteEventIndex];
+        commandList = AllocateCommandListForQueue(rerouteEvent.QueueIndex);
 
-        HAL::ComputeCommandListBase* transitionsCommandList = GetComputeCommandListBase(transitionsEvent.CommandList);
-        transitionsCommandList->SetDebugName(StringFormat("Rerouted Transitions for Dependency Level %d Cmd List", currentDependencyLevelIndex));
+        HAL::ComputeCommandListBase* transitionsCommandList = GetComputeCommandListBase(commandList);
+        transitionsCommandList->SetDebugName(StringFormat("Rerouted Transitions for Dependency Levels %d-%d Cmd List", firstServedDependencyLevel, lastServedDependencyLevel));
         transitionsCommandList->Reset();
         
-        mEventTracker.StartGPUEvent(StringFormat("Rerouting Transitions for Dependency Level %d", currentDependencyLevelIndex), *transitionsCommandList);
-        GPUProfiler::EventID profilerEventID = mGPUProfiler->RecordEventStart(*transitionsCommandList, mostCompetentQueueIndex);
-        mPassBarrierMeasurements.emplace_back(PipelineMeasurement{ "", profilerEventID, 0 });
+        mEventTracker.StartGPUEvent(StringFormat("Rerouting Transitions for Dependency Levels %d-%d", firstServedDependencyLevel, lastServedDependencyLevel), *transitionsCommandList);
+        GPUProfiler::EventID profilerEventID = mGPUProfiler->RecordEventStart(*transitionsCommandList, rerouteEvent.QueueIndex);
+        mPassBarrierMeasurements.emplace_back(PipelineMeasurement{ BarriersMeasurementName, profilerEventID, 0 });
 
         transitionsCommandList->InsertBarriers(barriers);
 
@@ -388,141 +791,86 @@ namespace PathFinder
         transitionsCommandList->Close();
     }
 
-    void RenderDevice::CollectNodeStandardTransitions(const RenderPassGraph::Node* node, uint64_t currentCommandListBatchIndex, HAL::ResourceBarrierCollection& collection)
+    void RenderDevice::CollectNodeStandardTransitions(const RenderPassGraph::Node& node, HAL::ResourceBarrierCollection& collection)
     {
-        const std::vector<SubresourceTransitionInfo>& nodeTransitionBarriers = mDependencyLevelStandardTransitions[node->LocalToDependencyLevelExecutionIndex()];
-
-        for (const SubresourceTransitionInfo& transitionInfo : nodeTransitionBarriers)
+        for (uint64_t requestIdx : mPerNodeTransitionRequests[node.GlobalExecutionIndex()])
         {
-            // Transition is implicit, we need to only keep track of previous resource usage 
-            // to correctly place split barriers later, if needed, graphic API transition for this pass is not required
-            if (!transitionInfo.TransitionBarrier)
-            {
-                mSubresourcesPreviousUsageInfo[transitionInfo.SubresourceName] = { SubresourcePreviousUsageInfo::ResourceUser{node}, currentCommandListBatchIndex };
+            // Back buffer transition is requested on every frame separately
+            if (requestIdx == mBackBufferTransitionRequestIndex)
                 continue;
-            }
 
-            // Transition is explicit. Look for previous transition info to see whether current explicit transition can be made
-            // implicit due to automatic promotion/decay.
-            auto previousTransitionInfoIt = mSubresourcesPreviousUsageInfo.find(transitionInfo.SubresourceName);
-            bool foundPreviousTransition = previousTransitionInfoIt != mSubresourcesPreviousUsageInfo.end();
-            bool subresourceTransitionedAtLeastOnce = foundPreviousTransition && previousTransitionInfoIt->second.EstimatedCommandListBatchIndex == currentCommandListBatchIndex;
+            const BarrierPlanner::TransitionPlacement& placement = mBarrierPlan.Placements[requestIdx];
+            const SubresourceTransitionInfo& transitionInfo = mFrameTransitionInfos[requestIdx];
 
-            if (!subresourceTransitionedAtLeastOnce)
+            switch (placement.Type)
             {
-                bool implicitTransitionPossible = Memory::ResourceStateTracker::CanResourceBeImplicitlyTransitioned(
-                    *transitionInfo.Resource, transitionInfo.TransitionBarrier->BeforeStates(), transitionInfo.TransitionBarrier->AfterStates());
-
-                if (implicitTransitionPossible)
-                    continue;
-            }
-
-            // When previous transition is found and(!) previous usage was on render pass and not in rerouted transitions, we can try to split the barrier
-            if (foundPreviousTransition && std::holds_alternative<const RenderPassGraph::Node*>(previousTransitionInfoIt->second.User))
-            {
-                const RenderPassGraph::Node* previousTransitionNode = std::get<const RenderPassGraph::Node*>(previousTransitionInfoIt->second.User);
-
-                // Split barrier is only possible when transmitting queue supports transitions for both before and after states
-                bool isSplitBarrierPossible = IsStateTransitionSupportedOnQueue(
-                    previousTransitionNode->ExecutionQueueIndex, transitionInfo.TransitionBarrier->BeforeStates(), transitionInfo.TransitionBarrier->AfterStates()
-                );
-
-                // Respect settings
-                isSplitBarrierPossible = isSplitBarrierPossible && mPipelinesSettings->IsSplitBarriersEnabled;
-
-                // There is no sense in splitting barriers between two adjacent render passes. 
-                // That will only double the amount of barriers without any performance gain.
-                bool currentNodeIsNextToPrevious = node->LocalToQueueExecutionIndex() - previousTransitionNode->LocalToQueueExecutionIndex() <= 1;
-
-                if (isSplitBarrierPossible && !currentNodeIsNextToPrevious)
-                {
-                    auto [beginBarrier, endBarrier] = transitionInfo.TransitionBarrier->Split();
-                    collection.AddBarrier(endBarrier);
-                    mPerNodeBeginBarriers[previousTransitionNode->GlobalExecutionIndex()].AddBarrier(beginBarrier);
-                }
-                else
-                {
-                    collection.AddBarrier(*transitionInfo.TransitionBarrier);
-                }
-            }
-            else
+            case BarrierPlanner::Placement::Full:
             {
                 collection.AddBarrier(*transitionInfo.TransitionBarrier);
+                break;
             }
 
-            mSubresourcesPreviousUsageInfo[transitionInfo.SubresourceName] = { SubresourcePreviousUsageInfo::ResourceUser{node}, currentCommandListBatchIndex };
-        }
-    }
-
-    void RenderDevice::CollectNodeTransitionsToReroute(std::optional<uint64_t>& reroutingDependencyLevelIndex, HAL::ResourceBarrierCollection& collection, const RenderPassGraph::DependencyLevel& currentDL)
-    {
-        // We want to execute rerouted transitions as early in the frame as we can, 
-        // but only after closest dependency level that uses any of the resources,
-        // transitions for which need to be rerouted. 
-
-        for (const SubresourceTransitionInfo& transitionInfo : mDependencyLevelTransitionsToReroute)
-        {
-            collection.AddBarrier(*transitionInfo.TransitionBarrier);
-
-            auto previousUsageInfoIt = mSubresourcesPreviousUsageInfo.find(transitionInfo.SubresourceName);
-            bool previousUsageExists = previousUsageInfoIt != mSubresourcesPreviousUsageInfo.end();
-
-            if (previousUsageExists)
+            case BarrierPlanner::Placement::Split:
             {
-                uint64_t previousUsageDLIndex = 0;
-                
-                // Previous usage was either on a render pass OR on a rerouted transitions event
-                std::visit(Foundation::MakeVisitor(
-                    [&previousUsageDLIndex](const RenderPassGraph::Node* previousUsageNode) { previousUsageDLIndex = previousUsageNode->DependencyLevelIndex(); },
-                    [&previousUsageDLIndex](SubresourcePreviousUsageInfo::DependencyLevelIndex previousUsageDLIndex) { previousUsageDLIndex = previousUsageDLIndex; }),
-                    previousUsageInfoIt->second.User);
-
-                bool reroutingDLIndexNeedsUpdate = !reroutingDependencyLevelIndex || previousUsageDLIndex > (*reroutingDependencyLevelIndex);
-                // Happens when same resource is read by multiple queues in one dependency level
-                bool previousUsageIsInCurrentDL = previousUsageDLIndex == currentDL.LevelIndex();
-
-                if (reroutingDLIndexNeedsUpdate && !previousUsageIsInCurrentDL)
-                {
-                    reroutingDependencyLevelIndex = previousUsageDLIndex;
-                }
+                auto [beginBarrier, endBarrier] = transitionInfo.TransitionBarrier->Split();
+                collection.AddBarrier(endBarrier);
+                mCompiledFrame.PerPassBeginBarriers[placement.BeginPassIndex].AddBarrier(beginBarrier);
+                break;
             }
 
-            // We update index of dependency level the resource was last used in
-            mSubresourcesPreviousUsageInfo[transitionInfo.SubresourceName] = { SubresourcePreviousUsageInfo::ResourceUser{ currentDL.LevelIndex() } };
+            default:
+                // Redundant or implicit transition, graphic API transition for this pass is not required
+                break;
+            }
         }
     }
 
     void RenderDevice::CollectNodeUAVAndAliasingBarriers(const RenderPassGraph::Node& node, HAL::ResourceBarrierCollection& collection)
     {
-        const HAL::ResourceBarrierCollection& nodeInterpassUAVBarriers = mDependencyLevelInterpassUAVBarriers[node.LocalToDependencyLevelExecutionIndex()];
+        const HAL::ResourceBarrierCollection& nodeInterpassUAVBarriers = mPerNodeInterpassUAVBarriers[node.GlobalExecutionIndex()];
         const HAL::ResourceBarrierCollection& nodeAliasingBarriers = mPerNodeAliasingBarriers[node.GlobalExecutionIndex()];
 
         collection.AddBarriers(nodeAliasingBarriers);
         collection.AddBarriers(nodeInterpassUAVBarriers);
     }
 
-    void RenderDevice::RecordResourceTransitions(const RenderPassGraph::DependencyLevel& dependencyLevel)
+    void RenderDevice::RecordResourceTransitions()
     {
-        bool willRerouteTransitions = !mDependencyLevelQueuesThatRequireTransitionRerouting.empty();
-        
-        std::optional<uint64_t> reroutingDependencyLevelIndex = std::nullopt;
+        const BarrierPlanner::TransitionPlacement& backBufferPlacement = mCompiledFrame.BackBufferTransitionPlacement;
 
-        for (const RenderPassGraph::Node* node : dependencyLevel.Nodes())
+        for (const RenderPassGraph::Node* node : mRenderPassGraph->NodesInGlobalExecutionOrder())
         {
-            HAL::ResourceBarrierCollection nodeBarriers{};
+            const HAL::ResourceBarrierCollection* nodeBarriers = &mCompiledFrame.PerPassPreWorkBarriers[node->GlobalExecutionIndex()];
+            HAL::ResourceBarrierCollection nodeBarriersWithBackBuffer{};
 
-            uint64_t currentCommandListBatchIndex = mFrameBlueprint.GetRenderPassEvent(*node).EstimatedBatchIndex;
-            
-            CollectNodeStandardTransitions(node, currentCommandListBatchIndex, nodeBarriers);
-            CollectNodeUAVAndAliasingBarriers(*node, nodeBarriers);
-            AllocateAndRecordPreWorkCommandList(*node, nodeBarriers, "Pre Work (Transitions | UAV | Aliasing)");
+            // Place back buffer transition the same way the planner did when frame was compiled
+            if (mBackBufferTransition && node->GlobalExecutionIndex() == mCompiledFrame.BackBufferTransitionPassIndex)
+            {
+                nodeBarriersWithBackBuffer = *nodeBarriers;
+                nodeBarriers = &nodeBarriersWithBackBuffer;
+
+                if (backBufferPlacement.Type == BarrierPlanner::Placement::Split)
+                {
+                    auto [beginBarrier, endBarrier] = mBackBufferTransition->Split();
+                    nodeBarriersWithBackBuffer.AddBarrier(endBarrier);
+                    mBackBufferBeginTransition = beginBarrier;
+                }
+                else
+                {
+                    // Transition could've been redundant on compilation, but it's required now
+                    nodeBarriersWithBackBuffer.AddBarrier(*mBackBufferTransition);
+                }
+            }
+
+            AllocateAndRecordPreWorkCommandList(*node, *nodeBarriers, "Pre Work (Transitions | UAV | Aliasing)");
         }
 
-        if (willRerouteTransitions)
+        mReroutedTransitionCommandLists.clear();
+        mReroutedTransitionCommandLists.resize(mCompiledFrame.ReroutedTransitionBarriers.size());
+
+        for (auto eventIdx = 0u; eventIdx < mCompiledFrame.ReroutedTransitionBarriers.size(); ++eventIdx)
         {
-            HAL::ResourceBarrierCollection transitionsToReroute{};
-            CollectNodeTransitionsToReroute(reroutingDependencyLevelIndex, transitionsToReroute, dependencyLevel);
-            AllocateAndRecordReroutedTransitionsCommandList(reroutingDependencyLevelIndex, dependencyLevel.LevelIndex(), transitionsToReroute);
+            AllocateAndRecordReroutedTransitionsCommandList(eventIdx, mCompiledFrame.ReroutedTransitionBarriers[eventIdx]);
         }
     }
 
@@ -532,11 +880,12 @@ namespace PathFinder
 
         for (const RenderPassGraph::Node* node : mRenderPassGraph->NodesInGlobalExecutionOrder())
         {
-            const HAL::ResourceBarrierCollection& beginBarriers = mPerNodeBeginBarriers[node->GlobalExecutionIndex()];
+            const HAL::ResourceBarrierCollection& beginBarriers = mCompiledFrame.PerPassBeginBarriers[node->GlobalExecutionIndex()];
             const ResourceReadbackInfo& readbackInfo = mPerNodeReadbackInfo[node->GlobalExecutionIndex()];
 
             bool lastGraphicNode = node->LocalToQueueExecutionIndex() == graphicNodesCount - 1;
-            bool beginBarriersExist = beginBarriers.BarrierCount() > 0;
+            bool backBufferBeginBarrierExists = mBackBufferBeginTransition && node->GlobalExecutionIndex() == mCompiledFrame.BackBufferTransitionPlacement.BeginPassIndex;
+            bool beginBarriersExist = beginBarriers.BarrierCount() > 0 || backBufferBeginBarrierExists;
             bool readbackRequestsExist = readbackInfo.CopyCommands.size() > 0;
 
             bool postWorkExists = lastGraphicNode || beginBarriersExist || readbackRequestsExist;
@@ -553,6 +902,11 @@ namespace PathFinder
                 barriers.AddBarriers(beginBarriers);
             }
 
+            if (backBufferBeginBarrierExists)
+            {
+                barriers.AddBarrier(*mBackBufferBeginTransition);
+            }
+
             // Transition back buffer after last graphic render pass
             if (lastGraphicNode)
             {
@@ -580,7 +934,7 @@ namespace PathFinder
             }
 
             GPUProfiler::EventID profilerEventID = mGPUProfiler->RecordEventStart(*cmdList, node->ExecutionQueueIndex);
-            mPassBarrierMeasurements.emplace_back(PipelineMeasurement{ "", profilerEventID, 0 });
+            mPassBarrierMeasurements.emplace_back(PipelineMeasurement{ BarriersMeasurementName, profilerEventID, 0, node->PassMetadata().Name });
 
             // Then apply begin and back buffer barriers
             cmdList->InsertBarriers(barriers);
@@ -668,7 +1022,13 @@ namespace PathFinder
 
     void RenderDevice::TraverseAndExecuteFrameBlueprint()
     {
-        mFrameBlueprint.PropagateFenceUpdates();
+        // Generate consecutive fence values that signals and waits of the frame rely on
+        mCompiledFrame.SignalFenceValues.resize(mCompiledFrame.Signals.size());
+
+        for (auto signalIdx = 0u; signalIdx < mCompiledFrame.Signals.size(); ++signalIdx)
+        {
+            mCompiledFrame.SignalFenceValues[signalIdx] = mCompiledFrame.Signals[signalIdx].Fence->IncrementExpectedValue();
+        }
 
         std::vector<std::vector<CommandListPtrVariant>> commandLists;
         commandLists.resize(mRenderPassGraph->DetectedQueueCount());
@@ -683,10 +1043,8 @@ namespace PathFinder
 
         auto flushBatch = [this, &commandLists](HAL::CommandQueue& queue, uint64_t queueIndex)
         {
-            if (!commandLists.empty())
+            if (!commandLists[queueIndex].empty())
             {
-                HAL::CommandQueue& queue = GetCommandQueue(queueIndex);
-
                 if (RenderPassExecutionQueue{ queueIndex } == RenderPassExecutionQueue::Graphics)
                     ExecuteCommandListBatch<HAL::GraphicsCommandQueue, HAL::GraphicsCommandList>(commandLists[queueIndex], queue);
                 else
@@ -696,66 +1054,63 @@ namespace PathFinder
             }
         };
 
-        auto signal = [this](const FrameBlueprint::Signal& signal, HAL::CommandQueue& queue)
+        auto addCommandList = [this, &commandLists](CommandListPtrVariant& commandList, uint64_t queueIndex)
         {
-            mEventTracker.StartGPUEvent(signal.SignalName, queue);
-            queue.SignalFence(*signal.Fence, signal.FenceValue);
-            mEventTracker.EndGPUEvent(queue);
+            if (!IsNullCommandList(commandList))
+                commandLists[queueIndex].push_back(std::move(commandList));
         };
 
-        auto wait = [this](const FrameBlueprint::Wait& wait, HAL::CommandQueue& queue)
+        for (const CompiledFrame::Operation& operation : mCompiledFrame.Operations)
         {
-            for (auto signalIdx = 0; signalIdx < wait.SignalsToWait.size(); ++signalIdx)
+            HAL::CommandQueue& queue = GetCommandQueue(operation.QueueIndex);
+
+            switch (operation.Type)
             {
-                const FrameBlueprint::Signal* signalToWait = wait.SignalsToWait[signalIdx];
-                const std::string& signalName = wait.EventNamesToWait[signalIdx];
+            case CompiledFrame::OperationType::Wait:
+            {
+                const CompiledFrame::Wait& wait = mCompiledFrame.Waits[operation.Index];
+                bool waitsForBVHBuild = wait.SignalIndex == CompiledFrame::BVHBuildSignalIndex;
+
+                // BVH fence value has been increased outside of the compiled frame
+                HAL::Fence& fence = waitsForBVHBuild ? mBVHFence : *mCompiledFrame.Signals[wait.SignalIndex].Fence;
+                uint64_t fenceValue = waitsForBVHBuild ? mBVHFence.ExpectedValue() : mCompiledFrame.SignalFenceValues[wait.SignalIndex];
+
+                flushBatch(queue, operation.QueueIndex);
 
-                mEventTracker.StartGPUEvent(signalName, queue);
-                queue.WaitFence(*signalToWait->Fence, signalToWait->FenceValue);
+                mEventTracker.StartGPUEvent(wait.EventName, queue);
+                queue.WaitFence(fence, fenceValue);
                 mEventTracker.EndGPUEvent(queue);
+                break;
             }
-        };
 
-        mFrameBlueprint.Traverse([&](uint64_t queueIndex, FrameBlueprint::Event& event)
-        {
-            HAL::CommandQueue& queue = GetCommandQueue(queueIndex);
-
-            std::visit(Foundation::MakeVisitor(
-            [&](FrameBlueprint::RenderPassEvent& e)
+            case CompiledFrame::OperationType::ExecutePass:
             {
-                if (e.WaitEvent)
-                {
-                    flushBatch(queue, queueIndex);
-                    wait(*e.WaitEvent, queue);
-                }
-
-                if (!IsNullCommandList(e.CommandLists.PreWorkCommandList)) 
-                    commandLists[queueIndex].push_back(std::move(e.CommandLists.PreWorkCommandList));
-
-                if (!IsNullCommandList(e.CommandLists.WorkCommandList)) 
-                    commandLists[queueIndex].push_back(std::move(e.CommandLists.WorkCommandList));
+                PassCommandLists& passCommandLists = mPerPassCommandLists[operation.Index];
+                addCommandList(passCommandLists.PreWorkCommandList, operation.QueueIndex);
+                addCommandList(passCommandLists.WorkCommandList, operation.QueueIndex);
+                addCommandList(passCommandLists.PostWorkCommandList, operation.QueueIndex);
+                break;
+            }
 
-                if (!IsNullCommandList(e.CommandLists.PostWorkCommandList))
-                    commandLists[queueIndex].push_back(std::move(e.CommandLists.PostWorkCommandList));
+            case CompiledFrame::OperationType::ExecuteReroutedTransitions:
+            {
+                addCommandList(mReroutedTransitionCommandLists[operation.Index], operation.QueueIndex);
+                break;
+            }
 
-                if (e.SignalEvent)
-                {
-                    flushBatch(queue, queueIndex);
-                    signal(*e.SignalEvent, queue);
-                }
-            },
-            [&](FrameBlueprint::ReroutedTransitionsEvent& e)
+            case CompiledFrame::OperationType::Signal:
             {
-                flushBatch(queue, queueIndex);
-                wait(e.WaitEvent, queue);
+                const CompiledFrame::Signal& signal = mCompiledFrame.Signals[operation.Index];
 
-                commandLists[queueIndex].emplace_back(std::move(e.CommandList));
-                flushBatch(queue, queueIndex);
+                flushBatch(queue, operation.QueueIndex);
 
-                signal(e.SignalEvent, queue);
-            }),
-            event);
-        });
+                mEventTracker.StartGPUEvent(signal.SignalName, queue);
+                queue.SignalFence(*signal.Fence, mCompiledFrame.SignalFenceValues[operation.Index]);
+                mEventTracker.EndGPUEvent(queue);
+                break;
+            }
+            }
+        }
 
         // Flush last batches on each queue
         for (auto queueIdx = 0; queueIdx < mRenderPassGraph->DetectedQueueCount(); ++queueIdx)
@@ -803,20 +1158,6 @@ namespace PathFinder
         return mComputeQueue;
     }
 
-    uint64_t RenderDevice::FindMostCompetentQueueIndex(const robin_hood::unordered_flat_set<RenderPassGraph::Node::QueueIndex>& queueIndices) const
-    {
-        auto mostCompetentQueueIndex = std::numeric_limits<RenderPassGraph::Node::QueueIndex>::max();
-
-        // Engine is designed to have graphics queue at index 0 and compute at indices 1 and onward hence 
-        // most competent queue will always have minimum index out of the index set
-        for (auto index : queueIndices)
-        {
-            mostCompetentQueueIndex = std::min(index, mostCompetentQueueIndex);
-        }
-
-        return mostCompetentQueueIndex;
-    }
-
     uint64_t RenderDevice::FindQueueSupportingTransition(HAL::ResourceState beforeStates, HAL::ResourceState afterStates) const
     {
         // At the moment engine only supports 1 graphics and 1 compute queue,
@@ -926,74 +1267,58 @@ namespace PathFinder
                     ++mCurrentBatchIndices[node->ExecutionQueueIndex];
                 }
 
+                passEvent.PassIndex = node->GlobalExecutionIndex();
                 passEvent.EstimatedBatchIndex = currentBatchIndex;
             }
         }
     }
 
-    void RenderDevice::FrameBlueprint::PropagateFenceUpdates()
-    {
-        // When blueprint is completed and all events are placed we can finally 
-        // generate consecutive fence values that events will rely on
-        //
-        for (auto& events : mEventsPerQueue)
-        {
-            for (Event& event : *events)
-            {
-                std::visit(Foundation::MakeVisitor(
-                [&](RenderPassEvent& e)
-                {
-                    if (e.SignalEvent)
-                        e.SignalEvent->FenceValue = e.SignalEvent->Fence->IncrementExpectedValue();
-                },
-                [&](ReroutedTransitionsEvent& e)
-                {
-                    e.SignalEvent.FenceValue = e.SignalEvent.Fence->IncrementExpectedValue();
-                }),
-                event);
-            }
-        }
-
-        // BVH Fence Value has been increased outside of the blueprint
-        mBVHBuildSignal.FenceValue = mBVHBuildSignal.Fence->ExpectedValue();
-    }
-
     RenderDevice::FrameBlueprint::ReroutedTransitionsEvent& RenderDevice::FrameBlueprint::InsertReroutedTransitionsEvent(
         std::optional<uint64_t> afterDependencyLevel,
-        uint64_t waitingDependencyLevel,
+        const std::vector<uint64_t>& waitingDependencyLevels,
         uint64_t queueIndex,
-        const std::vector<uint64_t>& queuesToSyncWith)
+        const std::vector<uint64_t>& queuesToSyncWith,
+        uint64_t rerouteEventIndex)
     {
+        assert_format(!waitingDependencyLevels.empty(), "Rerouted transitions must serve at least one dependency level");
+
+        uint64_t firstWaitingDependencyLevel = waitingDependencyLevels.front();
+        uint64_t lastWaitingDependencyLevel = waitingDependencyLevels.back();
+
         EventList& events = *mEventsPerQueue[queueIndex];
         ReroutedTransitionsEvent newTransitionsEvent{};
-        EventIt transitionsEventIt{};
+        EventIt insertionIt = events.begin();
 
+        newTransitionsEvent.RerouteEventIndex = rerouteEventIndex;
         newTransitionsEvent.SignalEvent.Fence = mQueueFences[queueIndex];
-        newTransitionsEvent.SignalEvent.SignalName = StringFormat("Rerouted Transitions for Dependency Level %d", waitingDependencyLevel);
+        newTransitionsEvent.SignalEvent.SignalName = StringFormat("Rerouted Transitions for Dependency Levels %d-%d", firstWaitingDependencyLevel, lastWaitingDependencyLevel);
 
-        if (afterDependencyLevel)
+        // We may have encounter a case when there is nothing to sync with on a particular queue.
+        // If dependency level doesn't contain render passes on a particular queue, we search
+        // in previous dependency levels until we hit the start of the frame or we find a suitable render pass.
+        //
+        auto findLastNodeOnQueue = [this](int64_t dlIndex, uint64_t queue) -> const RenderPassGraph::Node*
         {
-            assert_format(*afterDependencyLevel < waitingDependencyLevel, "Synchronization order is wrong");
+            while (dlIndex >= 0 && mPassGraph->DependencyLevels()[dlIndex].NodesForQueue(queue).empty())
+            {
+                --dlIndex;
+            }
+
+            return dlIndex < 0 ? nullptr : mPassGraph->DependencyLevels()[dlIndex].NodesForQueue(queue).back();
+        };
 
-            const RenderPassGraph::DependencyLevel& dl = mPassGraph->DependencyLevels()[*afterDependencyLevel];
+        if (afterDependencyLevel)
+        {
+            assert_format(*afterDependencyLevel < firstWaitingDependencyLevel, "Synchronization order is wrong");
 
             // Make rerouted transitions wait for passes in dependency level we're inserting them after
             for (uint64_t queueToWait : queuesToSyncWith)
             {   
-                // We may have encounter a case when there is nothing to sync with on a particular queue.
-                // If dependency level doesn't contain render passes on a particular queue, we search
-                // in previous dependency levels until we hit the start of the frame or we find a suitable render pass to sync with.
-                //
-                int64_t dlIndex = *afterDependencyLevel;
-                while (dlIndex >= 0 && mPassGraph->DependencyLevels()[dlIndex].NodesForQueue(queueToWait).empty())
-                {
-                    --dlIndex;
-                }
+                const RenderPassGraph::Node* nodeToWait = findLastNodeOnQueue(*afterDependencyLevel, queueToWait);
 
-                if (dlIndex < 0)
+                if (!nodeToWait)
                     continue;
 
-                const RenderPassGraph::Node* nodeToWait = mPassGraph->DependencyLevels()[dlIndex].NodesForQueue(queueToWait).back();
                 RenderPassEvent& passEvent = GetRenderPassEvent(*nodeToWait);
                 
                 if (!passEvent.SignalEvent)
@@ -1007,28 +1332,42 @@ namespace PathFinder
                 newTransitionsEvent.WaitEvent.EventNamesToWait.push_back(StringFormat("Waiting %s Pass", nodeToWait->PassMetadata().Name.ToString().c_str()));
             }
 
-            const RenderPassGraph::Node* lastNodeInDL = dl.NodesForQueue(queueIndex).back();
-            EventIt passEventIt = mRenderPassEventRefs[queueIndex][lastNodeInDL->LocalToQueueExecutionIndex()];
-            transitionsEventIt = events.emplace(++passEventIt, std::move(newTransitionsEvent));
+            if (const RenderPassGraph::Node* lastNode = findLastNodeOnQueue(*afterDependencyLevel, queueIndex))
+            {
+                insertionIt = std::next(mRenderPassEventRefs[queueIndex][lastNode->LocalToQueueExecutionIndex()]);
+            }
         }
-        else
+
+        // Keep rerouted transitions inserted at the same spot in the order they were requested
+        while (insertionIt != events.end() && std::holds_alternative<ReroutedTransitionsEvent>(*insertionIt))
         {
-            // Insert rerouted transitions before any render pass on the queue
-            transitionsEventIt = events.emplace(events.begin(), std::move(newTransitionsEvent));
+            ++insertionIt;
         }
 
+        EventIt transitionsEventIt = events.emplace(insertionIt, std::move(newTransitionsEvent));
+
         mReroutedTransitionEventRefs[queueIndex].push_back(transitionsEventIt);
 
         ReroutedTransitionsEvent& transitionsEvent = std::get<ReroutedTransitionsEvent>(*transitionsEventIt);
 
-        // Now make first passes in waiting dependency level wait for rerouted transitions
-        const RenderPassGraph::DependencyLevel& waitingDL = mPassGraph->DependencyLevels()[waitingDependencyLevel];
-
-        // Make rerouted transitions wait for passes in dependency level we're inserting them after
+        // Now make first passes on other queues in waiting dependency levels wait for rerouted transitions.
+        // Passes that follow on the same queue are ordered after the first one anyway.
         for (uint64_t waitingQueue : queuesToSyncWith)
         {
-            const RenderPassGraph::Node* firstNodeInDL = waitingDL.NodesForQueue(waitingQueue).front();
-            RenderPassEvent& passEvent = GetRenderPassEvent(*firstNodeInDL);
+            const RenderPassGraph::Node* firstNode = nullptr;
+
+            for (auto dlIndex = firstWaitingDependencyLevel; dlIndex <= lastWaitingDependencyLevel && !firstNode; ++dlIndex)
+            {
+                const auto& queueNodes = mPassGraph->DependencyLevels()[dlIndex].NodesForQueue(waitingQueue);
+
+                if (!queueNodes.empty())
+                    firstNode = queueNodes.front();
+            }
+
+            if (!firstNode)
+                continue;
+
+            RenderPassEvent& passEvent = GetRenderPassEvent(*firstNode);
             
             if (!passEvent.WaitEvent)
                 passEvent.WaitEvent = Wait{};
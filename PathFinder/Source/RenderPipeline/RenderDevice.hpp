@@ -7,6 +7,8 @@
 #include "GPUProfiler.hpp"
 #include "GPUDataInspector.hpp"
 #include "PipelineSettings.hpp"
+#include "PipelineMeasurementStorage.hpp"
+#include "BarrierPlanner.hpp"
 
 #include <Foundation/Name.hpp>
 #include <Utility/EventTracker.hpp>
@@ -27,6 +29,7 @@
 
 #include <robinhood/robin_hood.h>
 #include <forward_list>
+#include <optional>
 
 #include "DrawablePrimitive.hpp"
 
@@ -43,9 +46,11 @@ namespace PathFinder
         
         struct PipelineMeasurement
         {
-            std::string Name;
+            Foundation::Name Name;
             GPUProfiler::EventID ProfilerEventID;
             float DurationSeconds;
+            // Pass on whose behalf the work was performed, if any
+            std::optional<Foundation::Name> PassName;
         };
 
         struct PassCommandLists
@@ -81,6 +86,18 @@ namespace PathFinder
             std::optional<PipelineStateManager::PipelineStateVariant> LastSetPipelineState;
         };
 
+        struct FramePlanStatistics
+        {
+            // Frames that replayed a compiled frame plan and frames that had to compile a new one
+            uint64_t HitCount = 0;
+            uint64_t MissCount = 0;
+
+            // Moving averages of CPU time spent determining frame transitions and synchronization 
+            // when a plan is compiled and when a compiled plan is validated and replayed
+            double CompileSeconds = 0.0;
+            double ReplaySeconds = 0.0;
+        };
+
         RenderDevice(
             const HAL::Device& device,
             Memory::PoolDescriptorAllocator* descriptorAllocator,
@@ -115,8 +132,8 @@ namespace PathFinder
         void RecordWorkerCommandList(const RenderPassGraph::Node& passNode, const Lambda& action);
 
     private:
-        // Helper data structure that manages fences and holds command lists. 
-        // Converted into API calls after render pass work and rerouted transitions are determined and placed.
+        // Helper data structure that manages fences and synchronization events. 
+        // Compiled into a flat frame plan after render pass work and rerouted transitions are determined and placed.
         class FrameBlueprint
         {
         public:
@@ -135,17 +152,17 @@ namespace PathFinder
 
             struct RenderPassEvent
             {
-                PassCommandLists CommandLists;
                 std::optional<Wait> WaitEvent;
                 std::optional<Signal> SignalEvent;
+                uint64_t PassIndex = 0;
                 uint64_t EstimatedBatchIndex = 0;
             };
 
             struct ReroutedTransitionsEvent
             {
-                CommandListPtrVariant CommandList;
                 Signal SignalEvent;
                 Wait WaitEvent;
+                uint64_t RerouteEventIndex = 0;
             };
 
             using Event = std::variant<RenderPassEvent, ReroutedTransitionsEvent>;
@@ -156,13 +173,13 @@ namespace PathFinder
             FrameBlueprint(const RenderPassGraph* graph, uint64_t bvhBuildQueueIndex, HAL::Fence* bvhFence, const std::vector<HAL::Fence*>& queueFences);
 
             void Build();
-            void PropagateFenceUpdates();
 
             ReroutedTransitionsEvent& InsertReroutedTransitionsEvent(
                 std::optional<uint64_t> afterDependencyLevel,
-                uint64_t waitingDependencyLevel, 
+                const std::vector<uint64_t>& waitingDependencyLevels, 
                 uint64_t queueIndex, 
-                const std::vector<uint64_t>& queuesToSyncWith);
+                const std::vector<uint64_t>& queuesToSyncWith,
+                uint64_t rerouteEventIndex);
 
             void Traverse(const BlueprintTraverser& traverser);
 
@@ -180,6 +197,77 @@ namespace PathFinder
             uint64_t mBVHBuildQueueIndex;
             Signal mBVHBuildSignal;
             std::vector<HAL::Fence*> mQueueFences;
+
+        public:
+            inline const Signal* BVHBuildSignal() const { return &mBVHBuildSignal; }
+        };
+
+        // Flat form of a frame blueprint together with barrier batches placed for it.
+        // Compiled when graph structure, resource memory layout or resource entry states change 
+        // and replayed as is on all other frames, skipping transition gathering, planning and blueprint building.
+        struct CompiledFrame
+        {
+            enum class OperationType : uint8_t
+            {
+                Wait, ExecutePass, ExecuteReroutedTransitions, Signal
+            };
+
+            struct Operation
+            {
+                OperationType Type = OperationType::ExecutePass;
+                uint64_t QueueIndex = 0;
+                // Pass global execution index, rerouted transitions event index or index of a wait or a signal
+                uint64_t Index = 0;
+            };
+
+            struct Signal
+            {
+                HAL::Fence* Fence = nullptr;
+                std::string SignalName;
+            };
+
+            struct Wait
+            {
+                // Index of a signal in the frame or BVHBuildSignalIndex
+                uint64_t SignalIndex = 0;
+                std::string EventName;
+            };
+
+            struct SubresourceStates
+            {
+                const HAL::Resource* Resource = nullptr;
+                uint64_t SubresourceIndex = 0;
+                HAL::ResourceState EntryState = HAL::ResourceState::Common;
+                HAL::ResourceState ExitState = HAL::ResourceState::Common;
+            };
+
+            inline static const uint64_t BVHBuildSignalIndex = std::numeric_limits<uint64_t>::max();
+
+            uint64_t GraphStructureHash = 0;
+            uint64_t MemoryLayoutVersion = 0;
+            bool IsSplitBarriersEnabled = false;
+
+            // Frames that read back graph resources transition them outside of the plan, so they're never replayed
+            bool IsReplayable = false;
+
+            std::vector<Operation> Operations;
+            std::vector<Signal> Signals;
+            std::vector<Wait> Waits;
+
+            // Fence values of signals, generated anew each frame
+            std::vector<uint64_t> SignalFenceValues;
+
+            // Barrier batches of the frame. Back buffer changes every frame 
+            // and is not a part of them, its transition is requested on each frame.
+            std::vector<HAL::ResourceBarrierCollection> PerPassPreWorkBarriers;
+            std::vector<HAL::ResourceBarrierCollection> PerPassBeginBarriers;
+            std::vector<HAL::ResourceBarrierCollection> ReroutedTransitionBarriers;
+
+            uint64_t BackBufferTransitionPassIndex = BarrierPlanner::InvalidIndex;
+            BarrierPlanner::TransitionPlacement BackBufferTransitionPlacement;
+
+            // States graph subresources must be in for the plan to be valid and states the plan leaves them in
+            std::vector<SubresourceStates> TrackedSubresourceStates;
         };
 
         struct SubresourceTransitionInfo
@@ -190,17 +278,6 @@ namespace PathFinder
             const HAL::Resource* Resource = nullptr;
         };
 
-        struct SubresourcePreviousUsageInfo
-        {
-            using DependencyLevelIndex = uint64_t;
-            using ResourceUser = std::variant<const RenderPassGraph::Node*, DependencyLevelIndex>;
-            
-            // Previous usage can indicate usage in a single render pass in a dependency level
-            // or a whole dependency level when we're dealing with rerouted transitions
-            ResourceUser User;
-            uint64_t EstimatedCommandListBatchIndex = 0;
-        };
-
         struct ResourceReadbackInfo
         {
             std::vector<Memory::CopyRequestManager::CopyCommand> CopyCommands;
@@ -208,15 +285,24 @@ namespace PathFinder
         };
 
         void RecordNonWorkerCommandLists();
+        void SubmitMeasurementsToCPUProfiler();
         void TraverseAndExecuteFrameBlueprint();
 
+        bool CanReplayCompiledFrame() const;
+        void ReplayCompiledFrame();
+        void CompileFrame();
+        void CompileFrameBarriers();
+        void CompileFrameBlueprint();
+        void GatherPassPlanningInfo();
         void GatherResourceTransitionKnowledge(const RenderPassGraph::DependencyLevel& dependencyLevel);
+        void GatherNodeReadbacks(const RenderPassGraph::Node& node, robin_hood::unordered_flat_set<Memory::GPUResource*>& resourcesToReadback);
+        void AddTransitionRequest(const RenderPassGraph::Node& node, const SubresourceTransitionInfo& transitionInfo, bool needsRerouting);
+        void PlanResourceTransitions();
         void AllocateAndRecordPreWorkCommandList(const RenderPassGraph::Node& node, const HAL::ResourceBarrierCollection& barriers, const std::string& cmdListName);
-        void AllocateAndRecordReroutedTransitionsCommandList(std::optional<uint64_t> reroutingDependencyLevelIndex, uint64_t currentDependencyLevelIndex, const HAL::ResourceBarrierCollection& barriers);
-        void CollectNodeStandardTransitions(const RenderPassGraph::Node* node, uint64_t currentCommandListBatchIndex, HAL::ResourceBarrierCollection& collection);
-        void CollectNodeTransitionsToReroute(std::optional<uint64_t>& reroutingDependencyLevelIndex, HAL::ResourceBarrierCollection& collection, const RenderPassGraph::DependencyLevel& currentDL);
+        void AllocateAndRecordReroutedTransitionsCommandList(uint64_t rerouteEventIndex, const HAL::ResourceBarrierCollection& barriers);
+        void CollectNodeStandardTransitions(const RenderPassGraph::Node& node, HAL::ResourceBarrierCollection& collection);
         void CollectNodeUAVAndAliasingBarriers(const RenderPassGraph::Node& node, HAL::ResourceBarrierCollection& collection);
-        void RecordResourceTransitions(const RenderPassGraph::DependencyLevel& dependencyLevel); 
+        void RecordResourceTransitions(); 
         void RecordPostWorkCommandLists();
         void ExecuteUploadCommands();
         void ExecuteBVHBuildCommands();
@@ -224,7 +310,6 @@ namespace PathFinder
         bool IsStateTransitionSupportedOnQueue(uint64_t queueIndex, HAL::ResourceState beforeState, HAL::ResourceState afterState) const;
         bool IsStateTransitionSupportedOnQueue(uint64_t queueIndex, HAL::ResourceState afterState) const;
         HAL::CommandQueue& GetCommandQueue(uint64_t queueIndex);
-        uint64_t FindMostCompetentQueueIndex(const robin_hood::unordered_flat_set<RenderPassGraph::Node::QueueIndex>& queueIndices) const;
         uint64_t FindQueueSupportingTransition(HAL::ResourceState beforeStates, HAL::ResourceState afterStates) const;
         CommandListPtrVariant AllocateCommandListForQueue(uint64_t queueIndex) const;
         bool IsNullCommandList(CommandListPtrVariant& variant) const;
@@ -267,27 +352,49 @@ namespace PathFinder
 
         uint64_t mQueueCount = 2;
         uint64_t mBVHBuildsQueueIndex = 1;
+        uint64_t mLastProfiledGPUFrameNumber = 0;
+        uint64_t mLastMeasuredGPUFrameNumber = 0;
 
         FrameBlueprint mFrameBlueprint;
+        CompiledFrame mCompiledFrame;
+        FramePlanStatistics mFramePlanStatistics;
+
+        // Command lists of the frame, owned outside of the blueprint so that compiled frames could execute them
+        std::vector<PassCommandLists> mPerPassCommandLists;
+        std::vector<CommandListPtrVariant> mReroutedTransitionCommandLists;
 
-        // Keep track of nodes where transitions previously occurred (where resource was used last) to insert Begin part of split barriers there
-        robin_hood::unordered_flat_map<RenderPassGraph::SubresourceName, SubresourcePreviousUsageInfo> mSubresourcesPreviousUsageInfo;
+        // Back buffer transition of the current frame, placed as compiled frame dictates
+        std::optional<HAL::ResourceTransitionBarrier> mBackBufferTransition;
+        std::optional<HAL::ResourceTransitionBarrier> mBackBufferBeginTransition;
 
-        // Keep list of separate barriers gathered for dependency level so we could cull them, if conditions are met, when command list batches are determined
-        std::vector<std::vector<SubresourceTransitionInfo>> mDependencyLevelStandardTransitions;
+        // Index of the back buffer transition request and indices of tracked subresource states when compiling a frame
+        uint64_t mBackBufferTransitionRequestIndex = BarrierPlanner::InvalidIndex;
+        robin_hood::unordered_flat_map<RenderPassGraph::SubresourceName, uint64_t> mTrackedSubresourceStateIndices;
 
-        // Keep list of transitions in the current dependency level that need to be rerouted 
-        std::vector<SubresourceTransitionInfo> mDependencyLevelTransitionsToReroute;
+        // Places transitions of the whole frame once all of them are known
+        BarrierPlanner mBarrierPlanner;
+        BarrierPlanner::FrameTransitions mFrameTransitions;
+        BarrierPlanner::Plan mBarrierPlan;
+        // Present only while scoring is enabled in pipeline settings
+        std::optional<BarrierPlanner::Score> mBarrierPlanScore;
+        std::optional<BarrierPlanner::Score> mLegacyBarrierPlanScore;
+
+        // Transitions of the whole frame, parallel to planner requests
+        std::vector<SubresourceTransitionInfo> mFrameTransitionInfos;
+
+        // Indices of planner requests issued by each pass
+        std::vector<std::vector<uint64_t>> mPerNodeTransitionRequests;
+
+        // Keep list of transitions in the current dependency level that need to be rerouted.
+        // Handed to the planner after transitions of all passes in the dependency level.
+        std::vector<std::pair<const RenderPassGraph::Node*, SubresourceTransitionInfo>> mDependencyLevelTransitionsToReroute;
 
         // UAV barriers to be applied between passes (not between draw/dispatch calls) when UAV->UAV usage is detected
-        std::vector<HAL::ResourceBarrierCollection> mDependencyLevelInterpassUAVBarriers;        
+        std::vector<HAL::ResourceBarrierCollection> mPerNodeInterpassUAVBarriers;        
 
         // Keep track of queues inside a graph dependency layer that require transition rerouting
         robin_hood::unordered_flat_set<RenderPassGraph::Node::QueueIndex> mDependencyLevelQueuesThatRequireTransitionRerouting;
 
-        // Collect begin barriers for passes that may issue them to be applied in batches after all nodes are processed
-        std::vector<HAL::ResourceBarrierCollection> mPerNodeBeginBarriers;
-
         // Collect aliasing barriers for passes
         std::vector<HAL::ResourceBarrierCollection> mPerNodeAliasingBarriers;
 
@@ -299,15 +406,24 @@ namespace PathFinder
         std::vector<PipelineMeasurement> mPassBarrierMeasurements;
         PipelineMeasurement mFrameMeasurement;
 
+        // Rolling history and statistics of the measurements above
+        PipelineMeasurementStorage mMeasurementStorage;
+
     public:
         inline HAL::GraphicsCommandQueue& GraphicsCommandQueue() { return mGraphicsQueue; }
         inline HAL::ComputeCommandQueue& ComputeCommandQueue() { return mComputeQueue; }
         inline HAL::GraphicsCommandList* PreRenderUploadsCommandList() { return mPreRenderUploadsCommandList.get(); }
         inline HAL::ComputeCommandList* RTASBuildsCommandList() { return mRTASBuildsCommandList.get(); }
+        inline uint64_t BVHBuildsQueueIndex() const { return mBVHBuildsQueueIndex; }
         inline const RenderSurfaceDescription& DefaultRenderSurfaceDesc() { return mDefaultRenderSurface; }
         inline const auto& RenderPassWorkMeasurements() const { return mPassWorkMeasurements; }
         inline const auto& RenderPassBarrierMeasurements() const { return mPassBarrierMeasurements; }
         inline const PipelineMeasurement& FrameMeasurement() const { return mFrameMeasurement; }
+        inline const PipelineMeasurementStorage& MeasurementStorage() const { return mMeasurementStorage; }
+        inline const BarrierPlanner::FrameTransitions& FrameTransitions() const { return mFrameTransitions; }
+        inline const std::optional<BarrierPlanner::Score>& BarrierPlanScore() const { return mBarrierPlanScore; }
+        inline const std::optional<BarrierPlanner::Score>& LegacyBarrierPlanScore() const { return mLegacyBarrierPlanScore; }
+        inline const FramePlanStatistics& FramePlanStats() const { return mFramePlanStatistics; }
     };
 
 }
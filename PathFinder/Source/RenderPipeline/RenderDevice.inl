@@ -6,7 +6,7 @@ namespace PathFinder
     template <class Lambda>
     void RenderDevice::RecordWorkerCommandList(const RenderPassGraph::Node& passNode, const Lambda& action)
     {
-        HAL::ComputeCommandListBase* worker = GetComputeCommandListBase(mFrameBlueprint.GetRenderPassEvent(passNode).CommandLists.WorkCommandList);
+        HAL::ComputeCommandListBase* worker = GetComputeCommandListBase(CommandListsForPass(passNode).WorkCommandList);
         worker->Reset();
 
         const std::string& passName = passNode.PassMetadata().Name.ToString();
@@ -14,7 +14,7 @@ namespace PathFinder
 
         GPUProfiler::EventID profilerEventID = mGPUProfiler->RecordEventStart(*worker, passNode.ExecutionQueueIndex);
         PipelineMeasurement& measurement = mPassWorkMeasurements[passNode.GlobalExecutionIndex()];
-        measurement.Name = passName;
+        measurement.Name = passNode.PassMetadata().Name;
         measurement.ProfilerEventID = profilerEventID;
 
         if (worker->AftermathHandle())
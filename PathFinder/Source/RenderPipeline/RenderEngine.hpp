@@ -12,6 +12,7 @@
 
 #include <Scene/Scene.hpp>
 #include <Foundation/Event.hpp>
+#include <Foundation/TaskScheduler.hpp>
 #include <IO/CommandLineParser.hpp>
 #include <Utility/AftermathCrashTracker.hpp>
 
@@ -20,6 +21,8 @@
 #include <Memory/ResourceStateTracker.hpp>
 #include <Memory/GPUResourceProducer.hpp>
 #include <Memory/CopyRequestManager.hpp>
+#include <Memory/TransientHeapPool.hpp>
+#include <Memory/ResourceDefragmenter.hpp>
 
 #include "RenderPassMediators/ResourceScheduler.hpp"
 #include "RenderPassMediators/RootConstantsUpdater.hpp"
@@ -38,10 +41,13 @@
 #include "RenderPassGraph.hpp"
 #include "BottomRTAS.hpp"
 #include "TopRTAS.hpp"
+#include "RTASManager.hpp"
+#include "BottomRTASWorkRecorder.hpp"
 #include "GPUProfiler.hpp"
 #include "GPUDataInspector.hpp"
 #include "FrameFence.hpp"
 #include "PipelineSettings.hpp"
+#include "QueueAssignmentOptimizer.hpp"
 
 namespace PathFinder
 {
@@ -61,7 +67,7 @@ namespace PathFinder
         void Render();
         void FlushAllQueuedFrames();
 
-        void AddBottomRayTracingAccelerationStructure(const BottomRTAS* bottomRTAS);
+        void AddBottomRayTracingAccelerationStructure(BottomRTAS* bottomRTAS);
         void AddTopRayTracingAccelerationStructure(const TopRTAS* topRTAS);
 
         void SetContentMediator(ContentMediator* mediator);
@@ -82,6 +88,10 @@ namespace PathFinder
         void ScheduleFrame();
         void UpdateBackBuffers();
 
+        // Records resource requests of passes, in parallel if enabled, and merges them in pass order
+        template <class PassHelpersT>
+        void ScheduleResources(const std::vector<PassHelpersT*>& passes);
+
         RenderPassGraph mRenderPassGraph;
 
         uint8_t mCurrentBackBufferIndex = 0;
@@ -101,6 +111,8 @@ namespace PathFinder
         std::unique_ptr<Memory::ResourceStateTracker> mResourceStateTracker;
         std::unique_ptr<Memory::CopyRequestManager> mCopyRequestManager;
         std::unique_ptr<Memory::GPUResourceProducer> mResourceProducer;
+        std::unique_ptr<Memory::TransientHeapPool> mTransientHeapPool;
+        std::unique_ptr<Memory::ResourceDefragmenter> mResourceDefragmenter;
 
         std::unique_ptr<AftermathCrashTracker> mAftermathCrashTracker;
         std::unique_ptr<RenderPassUtilityProvider> mPassUtilityProvider;
@@ -116,6 +128,9 @@ namespace PathFinder
         std::unique_ptr<RenderPassContainer<ContentMediator>> mRenderPassContainer;
         std::unique_ptr<GPUProfiler> mGPUProfiler;
         std::unique_ptr<GPUDataInspector> mGPUDataInspector;
+        std::unique_ptr<BottomRTASWorkRecorder> mBottomRTASWorkRecorder;
+        std::unique_ptr<RTASManager> mRTASManager;
+        std::unique_ptr<QueueAssignmentOptimizer> mQueueAssignmentOptimizer;
 
         std::unique_ptr<HAL::SwapChain> mSwapChain;
         std::unique_ptr<FrameFence> mFrameFence;
@@ -128,15 +143,24 @@ namespace PathFinder
         Event mPostRenderEvent;
 
         std::vector<const TopRTAS*> mTopRTASes;
-        std::vector<const BottomRTAS*> mBottomRTASes;
         std::vector<Memory::GPUResourceProducer::TexturePtr> mBackBuffers;
+        std::vector<typename RenderPassContainer<ContentMediator>::RenderPassHelpers*> mScheduledRenderPasses;
+        std::vector<typename RenderPassContainer<ContentMediator>::RenderSubPassHelpers*> mScheduledRenderSubPasses;
+        std::vector<typename ResourceScheduler<ContentMediator>::RecordedPassRequests> mRecordedPassRequests;
 
     public:
         inline PipelineResourceStorage* ResourceStorage() { return mPipelineResourceStorage.get(); }
         inline const RenderSurfaceDescription& RenderSurface() const { return mRenderSurfaceDescription; }
         inline Memory::GPUResourceProducer* ResourceProducer() { return mResourceProducer.get(); }
+        inline const Memory::SegregatedPoolsResourceAllocator* ResourceAllocator() const { return mResourceAllocator.get(); }
+        inline Memory::ResourceDefragmenter* ResourceDefragmenter() { return mResourceDefragmenter.get(); }
+        inline const Memory::ResourceDefragmenter* ResourceDefragmenter() const { return mResourceDefragmenter.get(); }
         inline const RenderDevice* RendererDevice() const { return mRenderDevice.get(); }
         inline const GPUDataInspector* GPUInspector() const { return mGPUDataInspector.get(); }
+        inline const RTASManager* AccelerationStructureManager() const { return mRTASManager.get(); }
+        inline const BottomRTASWorkRecorder* AccelerationStructureRecorder() const { return mBottomRTASWorkRecorder.get(); }
+        inline const QueueAssignmentOptimizer* QueueAssigner() const { return mQueueAssignmentOptimizer.get(); }
+        inline PipelineStateManager* PipelineStates() { return mPipelineStateManager.get(); }
         inline const RenderPassGraph* RenderGraph() const { return &mRenderPassGraph; }
         inline HAL::Device* Device() { return mDevice.get(); }
         inline HAL::SwapChain* SwapChain() { return mSwapChain.get(); }
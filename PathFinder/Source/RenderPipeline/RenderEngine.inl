@@ -1,6 +1,8 @@
 #include <HardwareAbstractionLayer/DebugLayer.hpp>
 #include "CopyRequestHandling.hpp"
 
+#include <Foundation/CPUProfiler.hpp>
+
 #include <pix.h>
 
 namespace PathFinder
@@ -38,6 +40,7 @@ namespace PathFinder
         mResourceAllocator = std::make_unique<Memory::SegregatedPoolsResourceAllocator>(mDevice.get(), mSimultaneousFramesInFlight);
         mCommandListAllocator = std::make_unique<Memory::PoolCommandListAllocator>(mDevice.get(), mSimultaneousFramesInFlight);
         mDescriptorAllocator = std::make_unique<Memory::PoolDescriptorAllocator>(mDevice.get(), mSimultaneousFramesInFlight);
+        mTransientHeapPool = std::make_unique<Memory::TransientHeapPool>(mDevice.get(), mSimultaneousFramesInFlight);
         mCopyRequestManager = std::make_unique<Memory::CopyRequestManager>();
 
         mResourceProducer = std::make_unique<Memory::GPUResourceProducer>(
@@ -47,19 +50,25 @@ namespace PathFinder
             mDescriptorAllocator.get(),
             mCopyRequestManager.get());
 
+        mResourceDefragmenter = std::make_unique<Memory::ResourceDefragmenter>(mResourceAllocator.get(), mResourceProducer.get());
+
         mPipelineResourceStorage = std::make_unique<PipelineResourceStorage>(
             mDevice.get(), 
             mResourceProducer.get(), 
             mDescriptorAllocator.get(), 
             mResourceStateTracker.get(), 
+            mTransientHeapPool.get(),
             mRenderSurfaceDescription, 
             &mRenderPassGraph);
 
+        mQueueAssignmentOptimizer = std::make_unique<QueueAssignmentOptimizer>();
+
         mResourceScheduler = std::make_unique<ResourceScheduler<ContentMediator>>(
             mPipelineResourceStorage.get(),
             mPassUtilityProvider.get(),
             &mRenderPassGraph,
-            &mPipelineSettings);
+            &mPipelineSettings,
+            mQueueAssignmentOptimizer.get());
 
         mShaderManager = std::make_unique<ShaderManager>(
             commandLineParser.ExecutableFolderPath(),
@@ -72,13 +81,16 @@ namespace PathFinder
             mDevice.get(),
             mShaderManager.get(), 
             mResourceProducer.get(), 
-            mRenderSurfaceDescription);
+            mRenderSurfaceDescription,
+            commandLineParser.ExecutableFolderPath());
 
         mPipelineStateCreator = std::make_unique<PipelineStateCreator>(mPipelineStateManager.get());
         mRootSignatureCreator = std::make_unique<RootSignatureCreator>(mPipelineStateManager.get());
         mSamplerCreator = std::make_unique<SamplerCreator>(mPipelineResourceStorage.get());
         mGPUProfiler = std::make_unique<GPUProfiler>(*mDevice, 1024, mSimultaneousFramesInFlight, mResourceProducer.get());
         mGPUDataInspector = std::make_unique<GPUDataInspector>();
+        mBottomRTASWorkRecorder = std::make_unique<BottomRTASWorkRecorder>(mResourceProducer.get(), mResourceStateTracker.get(), mGPUProfiler.get());
+        mRTASManager = std::make_unique<RTASManager>(mBottomRTASWorkRecorder.get());
 
         mRenderDevice = std::make_unique<RenderDevice>(
             *mDevice,
@@ -138,9 +150,9 @@ namespace PathFinder
     }
 
     template <class ContentMediator>
-    void RenderEngine<ContentMediator>::AddBottomRayTracingAccelerationStructure(const BottomRTAS* bottomRTAS)
+    void RenderEngine<ContentMediator>::AddBottomRayTracingAccelerationStructure(BottomRTAS* bottomRTAS)
     {
-        mBottomRTASes.push_back(bottomRTAS);
+        mRTASManager->AddStructure(BottomRTASWorkRecorder::StructureKey(bottomRTAS));
     }
 
     template <class ContentMediator>
@@ -155,6 +167,8 @@ namespace PathFinder
         if (mRenderPassGraph.Nodes().empty()) 
             return;
 
+        PF_CPU_ZONE("RenderEngine::Render");
+
         // First frame starts in constructor
         if (mFrameNumber > 0)
         {
@@ -169,10 +183,16 @@ namespace PathFinder
         mGPUDataInspector->PreparePerPassBuffers(&mRenderPassGraph, mResourceProducer.get());
 
         // Compile new states and signatures, if any
-        mPipelineStateManager->CompileUncompiledSignaturesAndStates();
+        {
+            PF_CPU_ZONE("CompileUncompiledSignaturesAndStates");
+            mPipelineStateManager->CompileUncompiledSignaturesAndStates();
+        }
 
         // Notify external listeners
-        mPreRenderEvent.Raise();
+        {
+            PF_CPU_ZONE("PreRenderEvent");
+            mPreRenderEvent.Raise();
+        }
 
         // External listeners might've caused back buffer reallocation
         if (mSwapChain->AreBackBuffersUpdated())
@@ -182,31 +202,61 @@ namespace PathFinder
         mRenderDevice->SetBackBuffer(mBackBuffers[mCurrentBackBufferIndex].get());
 
         // Render
-        mRenderDevice->PrepareForGraphExecution();
+        {
+            PF_CPU_ZONE("PrepareForGraphExecution");
+            mRenderDevice->PrepareForGraphExecution();
+        }
+
         RecordCommandLists();
         // Record uploads after constant buffers for passes has been modified by render passes
         PerformPreRenderUploads();
         // BVH build must be recorded after uploads
         BuildAccelerationStructures();
         // Finally, execute command lists
-        mRenderDevice->ExecuteRenderGraph();
+        {
+            PF_CPU_ZONE("ExecuteRenderGraph");
+            mRenderDevice->ExecuteRenderGraph();
+        }
 
         // Put the picture on the screen
-        mSwapChain->Present();
+        {
+            PF_CPU_ZONE("Present");
+            mSwapChain->Present();
+        }
 
         // Issue a CPU wait if necessary
-        mRenderDevice->GraphicsCommandQueue().SignalFence(mFrameFence->HALFence());
-        mFrameFence->StallCurrentThreadUntilCompletion(mSimultaneousFramesInFlight);
+        {
+            PF_CPU_ZONE("Wait For Frame Fence");
+            mRenderDevice->GraphicsCommandQueue().SignalFence(mFrameFence->HALFence());
+            mFrameFence->StallCurrentThreadUntilCompletion(mSimultaneousFramesInFlight);
+        }
 
         // Notify internal listeners
         NotifyEndFrame(mFrameFence->HALFence().CompletedValue());
 
         // Gather extracted measurement
-        mRenderDevice->GatherMeasurements();
+        {
+            PF_CPU_ZONE("GatherMeasurements");
+            mRenderDevice->GatherMeasurements();
+        }
+
+        if (mPipelineSettings.IsAutomaticQueueAssignmentEnabled && mPipelineSettings.IsAsyncComputeEnabled)
+        {
+            PF_CPU_ZONE("QueueAssignmentOptimizer::Update");
+            mQueueAssignmentOptimizer->Update(mRenderPassGraph, mRenderDevice->MeasurementStorage());
+        }
+        else
+        {
+            mQueueAssignmentOptimizer->Reset();
+        }
+
         mGPUDataInspector->DecodeAvailableInspectionData();
 
         // Notify external listeners
-        mPostRenderEvent.Raise();
+        {
+            PF_CPU_ZONE("PostRenderEvent");
+            mPostRenderEvent.Raise();
+        }
 
         MoveToNextFrame();
     }
@@ -225,8 +275,15 @@ namespace PathFinder
         mDescriptorAllocator->BeginFrame(newFrameNumber);
         mCommandListAllocator->BeginFrame(newFrameNumber);
         mResourceProducer->BeginFrame(newFrameNumber);
+        mResourceDefragmenter->BeginFrame(newFrameNumber);
+        mTransientHeapPool->BeginFrame(newFrameNumber);
         mPipelineResourceStorage->BeginFrame();
+        mPipelineStateManager->BeginFrame(newFrameNumber);
         mGPUProfiler->BeginFrame(newFrameNumber);
+        mBottomRTASWorkRecorder->BeginFrame();
+        mRTASManager->BeginFrame(newFrameNumber);
+
+        Foundation::CPUProfiler::SharedInstance().BeginFrame(newFrameNumber);
 
         mFrameStartTimestamp = std::chrono::steady_clock::now();
     }
@@ -240,7 +297,11 @@ namespace PathFinder
         mDescriptorAllocator->EndFrame(completedFrameNumber);
         mCommandListAllocator->EndFrame(completedFrameNumber);
         mPipelineResourceStorage->EndFrame();
+        mTransientHeapPool->EndFrame(completedFrameNumber);
+        mPipelineStateManager->EndFrame(completedFrameNumber);
         mGPUProfiler->EndFrame(completedFrameNumber);
+        mBottomRTASWorkRecorder->EndFrame();
+        mRTASManager->EndFrame(completedFrameNumber);
 
         using namespace std::chrono;
         mFrameDuration = duration_cast<microseconds>(steady_clock::now() - mFrameStartTimestamp);
@@ -253,13 +314,14 @@ namespace PathFinder
         mFrameNumber++;
         mPassUtilityProvider->FrameNumber = mFrameNumber;
 
-        mBottomRTASes.clear();
         mTopRTASes.clear();
     }
 
     template <class ContentMediator>
     void RenderEngine<ContentMediator>::PerformPreRenderUploads()
     {
+        PF_CPU_ZONE("PerformPreRenderUploads");
+
         mRenderDevice->AllocateUploadCommandList();
         RecordUploadRequests(*mRenderDevice->PreRenderUploadsCommandList(), *mResourceStateTracker, *mCopyRequestManager, true);
         mRenderDevice->PreRenderUploadsCommandList()->Close();
@@ -270,18 +332,14 @@ namespace PathFinder
     template <class ContentMediator>
     void RenderEngine<ContentMediator>::BuildAccelerationStructures()
     {
-        mRenderDevice->AllocateRTASBuildsCommandList();
-
-        HAL::ResourceBarrierCollection bottomRTASUABarriers{};
+        PF_CPU_ZONE("BuildAccelerationStructures");
 
-        for (const BottomRTAS* blas : mBottomRTASes)
-        {
-            bottomRTASUABarriers.AddBarrier(blas->UABarrier());
-            mRenderDevice->RTASBuildsCommandList()->BuildRaytracingAccelerationStructure(blas->HALAccelerationStructure());
-        }
+        mRenderDevice->AllocateRTASBuildsCommandList();
 
-        // Top RTAS needs to wait for Bottom RTAS
-        mRenderDevice->RTASBuildsCommandList()->InsertBarriers(bottomRTASUABarriers);
+        // Top RTAS needs to wait for Bottom RTAS, manager inserts the barriers
+        mBottomRTASWorkRecorder->BeginRecording(*mRenderDevice->RTASBuildsCommandList(), mRenderDevice->BVHBuildsQueueIndex());
+        mRTASManager->RecordBottomRTASWork();
+        mBottomRTASWorkRecorder->EndRecording();
 
         HAL::ResourceBarrierCollection topRTASUABarriers{};
         for (const TopRTAS* tlas : mTopRTASes)
@@ -297,6 +355,8 @@ namespace PathFinder
     template <class ContentMediator>
     void RenderEngine<ContentMediator>::RecordCommandLists()
     {
+        PF_CPU_ZONE("RecordCommandLists");
+
         Memory::Texture* currentBackBuffer = mBackBuffers[mCurrentBackBufferIndex].get();
         mRenderDevice->SetBackBuffer(currentBackBuffer);
 
@@ -326,10 +386,10 @@ namespace PathFinder
     template <class ContentMediator>
     void RenderEngine<ContentMediator>::ScheduleFrame()
     {
+        PF_CPU_ZONE("ScheduleFrame");
+
         mRenderPassGraph.Clear();
 
-        // Run scheduling for standard render passes
-        mPipelineResourceStorage->StartResourceScheduling();
         mResourceScheduler->SetContent(mContentMediator);
         mSubPassScheduler->SetContent(mContentMediator);
 
@@ -343,47 +403,113 @@ namespace PathFinder
             }
         }
 
+        mScheduledRenderPasses.clear();
+
         for (auto& [passName, passHelpers] : mRenderPassContainer->RenderPasses())
         {
-            mResourceScheduler->SetCurrentlySchedulingPassNode(&mRenderPassGraph.Nodes()[passHelpers.GraphNodeIndex]);
-            passHelpers.Pass->ScheduleResources(mResourceScheduler.get());
+            mScheduledRenderPasses.push_back(&passHelpers);
+        }
+
+        // Run scheduling for standard render passes
+        ScheduleResources(mScheduledRenderPasses);
 
-            if (!passHelpers.ArePipelineStatesScheduled)
+        for (auto passHelpers : mScheduledRenderPasses)
+        {
+            if (!passHelpers->ArePipelineStatesScheduled)
             {
-                passHelpers.Pass->SetupPipelineStates(mPipelineStateCreator.get());
-                passHelpers.ArePipelineStatesScheduled = true;
+                passHelpers->Pass->SetupPipelineStates(mPipelineStateCreator.get());
+                passHelpers->ArePipelineStatesScheduled = true;
             }
 
-            if (!passHelpers.AreSamplersScheduled)
+            if (!passHelpers->AreSamplersScheduled)
             {
-                passHelpers.Pass->ScheduleSamplers(mSamplerCreator.get());
-                passHelpers.AreSamplersScheduled = true;
+                passHelpers->Pass->ScheduleSamplers(mSamplerCreator.get());
+                passHelpers->AreSamplersScheduled = true;
             }
         }
 
-        mPipelineResourceStorage->EndResourceScheduling();
-
         // Run sub pass scheduling after scheduling first wave of resources
-        for (auto& [passName, passHelpers] : mRenderPassContainer->RenderPasses())
+        for (auto passHelpers : mScheduledRenderPasses)
         {
-            passHelpers.Pass->ScheduleSubPasses(mSubPassScheduler.get());
+            passHelpers->Pass->ScheduleSubPasses(mSubPassScheduler.get());
         }
 
-        // Run scheduling for sub render passes
-        mPipelineResourceStorage->StartResourceScheduling();
+        mScheduledRenderSubPasses.clear();
 
         for (auto& [passName, passHelpers] : mRenderPassContainer->RenderSubPasses())
         {
-            mResourceScheduler->SetCurrentlySchedulingPassNode(&mRenderPassGraph.Nodes()[passHelpers.GraphNodeIndex]);
-            passHelpers.Pass->ScheduleResources(mResourceScheduler.get());
+            mScheduledRenderSubPasses.push_back(&passHelpers);
         }
 
-        mPipelineResourceStorage->EndResourceScheduling();
+        // Run scheduling for sub render passes
+        ScheduleResources(mScheduledRenderSubPasses);
 
         // Finish graph and allocate memory 
-        mRenderPassGraph.Build();
-        mPipelineResourceStorage->OptimizeScheduledResourceStates(mRenderPassGraph);
-        mPipelineResourceStorage->AllocateScheduledResources();
+        {
+            PF_CPU_ZONE("RenderPassGraph::Build");
+            mRenderPassGraph.Build();
+        }
+
+        {
+            PF_CPU_ZONE("AllocateScheduledResources");
+            mPipelineResourceStorage->OptimizeScheduledResourceStates(mRenderPassGraph);
+            mPipelineResourceStorage->AllocateScheduledResources();
+        }
+    }
+
+    template <class ContentMediator>
+    template <class PassHelpersT>
+    void RenderEngine<ContentMediator>::ScheduleResources(const std::vector<PassHelpersT*>& passes)
+    {
+        auto recordRequests = [this, &passes](uint64_t firstPass, uint64_t lastPass)
+        {
+            // Passes of a batch record through a scheduler copy of their own,
+            // recording only writes into request buffers of the passes themselves
+            ResourceScheduler<ContentMediator> scheduler = *mResourceScheduler;
+
+            for (auto passIdx = firstPass; passIdx < lastPass; ++passIdx)
+            {
+                PassHelpersT* passHelpers = passes[passIdx];
+                PipelineResourceSchedulingRequests& requests = passHelpers->SchedulingRequests;
+
+                if (requests.IsRecorded && passHelpers->Pass->IsSchedulingFrameInvariant())
+                {
+                    continue;
+                }
+
+                requests.Clear();
+                scheduler.SetRecordingTarget(&requests);
+                passHelpers->Pass->ScheduleResources(&scheduler);
+                requests.IsRecorded = true;
+            }
+        };
+
+        {
+            PF_CPU_ZONE("RecordResourceRequests");
+
+            if (mPipelineSettings.IsParallelResourceSchedulingEnabled)
+            {
+                Foundation::TaskScheduler::SharedInstance().ParallelFor(passes.size(), 1, recordRequests, "RecordResourceRequests");
+            }
+            else
+            {
+                recordRequests(0, passes.size());
+            }
+        }
+
+        PF_CPU_ZONE("MergeResourceRequests");
+
+        mRecordedPassRequests.clear();
+
+        for (PassHelpersT* passHelpers : passes)
+        {
+            mRecordedPassRequests.emplace_back(&mRenderPassGraph.Nodes()[passHelpers->GraphNodeIndex], &passHelpers->SchedulingRequests);
+        }
+
+        mPipelineResourceStorage->StartResourceScheduling();
+        mResourceScheduler->QueueRecordedRequests(mRecordedPassRequests);
+        mPipelineResourceStorage->EndResourceScheduling();
+        mResourceScheduler->MergeRecordedRequests(mRecordedPassRequests);
     }
 
     template <class ContentMediator>
@@ -28,6 +28,9 @@ namespace PathFinder
         virtual void SetupRootSignatures(RootSignatureCreator* rootSignatureCreator) {};
         virtual void SetupPipelineStates(PipelineStateCreator* stateCreator) {};
         virtual void ScheduleResources(ResourceScheduler<ContentMediator>* scheduler) {};
+        // Passes that schedule the same resources every frame can return true
+        // to have requests recorded once and reused in later frames
+        virtual bool IsSchedulingFrameInvariant() const { return false; }
         virtual void ScheduleSubPasses(SubPassScheduler<ContentMediator>* scheduler) {};
         virtual void ScheduleSamplers(SamplerCreator* samplerCreator) {};
         virtual void Render(RenderContext<ContentMediator>* context) {};
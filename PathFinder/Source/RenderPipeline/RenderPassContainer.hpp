@@ -6,6 +6,7 @@
 #include "RenderDevice.hpp"
 #include "PipelineResourceStorage.hpp"
 #include "PipelineStateManager.hpp"
+#include "PipelineResourceSchedulingRequests.hpp"
 #include "RenderContext.hpp"
 #include "GPUDataInspector.hpp"
 
@@ -52,6 +53,7 @@ namespace PathFinder
             ResourceProvider PassResourceProvider;
             RootConstantsUpdater PassRootConstantsUpdater;
             RenderPassUtilityProvider* UtilityProvider;
+            PipelineResourceSchedulingRequests SchedulingRequests;
             uint64_t GraphNodeIndex;
 
             bool AreRootSignaturesScheduled = false;
@@ -2,7 +2,7 @@
 
 #include "RenderPass.hpp"
 
-
+#include <algorithm>
 
 namespace PathFinder
 {
@@ -55,6 +55,7 @@ namespace PathFinder
         BuildDependencyLevels();
         FinalizeDependencyLevels();
         CullRedundantSynchronizations();
+        ComputeStructureHash();
     }
 
     void RenderPassGraph::Clear()
@@ -69,6 +70,7 @@ namespace PathFinder
         mDetectedQueueCount = 1;
         mNodesPerQueue.clear();
         mFirstNodesThatUseRayTracing.clear();
+        mStructureHash = 0;
 
         for (Node& node : mPassNodes)
         {
@@ -480,6 +482,50 @@ namespace PathFinder
         }
     }
 
+    void RenderPassGraph::ComputeStructureHash()
+    {
+        std::vector<uint64_t> words;
+        std::vector<SubresourceName> sortedSubresources;
+
+        // Subresource sets are unordered, so sort them to get the same words for the same sets
+        auto addSubresources = [&](const robin_hood::unordered_flat_set<SubresourceName>& subresources)
+        {
+            sortedSubresources.assign(subresources.begin(), subresources.end());
+            std::sort(sortedSubresources.begin(), sortedSubresources.end());
+            words.push_back(sortedSubresources.size());
+            words.insert(words.end(), sortedSubresources.begin(), sortedSubresources.end());
+        };
+
+        words.push_back(mDetectedQueueCount);
+
+        for (const DependencyLevel& dependencyLevel : mDependencyLevels)
+        {
+            words.push_back(dependencyLevel.Nodes().size());
+
+            for (const Node* node : dependencyLevel.Nodes())
+            {
+                words.push_back(node->PassMetadata().Name.ToId());
+                words.push_back(node->ExecutionQueueIndex);
+                words.push_back(node->UsesRayTracing);
+                words.push_back(node->IsSyncSignalRequired());
+
+                addSubresources(node->ReadSubresources());
+                addSubresources(node->WrittenSubresources());
+
+                words.push_back(node->NodesToSyncWith().size());
+
+                for (const Node* nodeToSyncWith : node->NodesToSyncWith())
+                    words.push_back(nodeToSyncWith->GlobalExecutionIndex());
+
+                words.insert(words.end(), node->SynchronizationIndices().begin(), node->SynchronizationIndices().end());
+            }
+
+            addSubresources(dependencyLevel.SubresourcesReadByMultipleQueues());
+        }
+
+        mStructureHash = robin_hood::hash_bytes(words.data(), words.size() * sizeof(uint64_t));
+    }
+
     RenderPassGraph::Node::Node(const RenderPassMetadata& passMetadata, WriteDependencyRegistry* writeDependencyRegistry)
         : mPassMetadata{ passMetadata }, mWriteDependencyRegistry{ writeDependencyRegistry } {}
 
@@ -600,6 +646,7 @@ namespace PathFinder
         mSyncSignalRequired = false;
         ExecutionQueueIndex = 0;
         UsesRayTracing = false;
+        IsAsyncComputeEligible = false;
         mGlobalExecutionIndex = 0;
         mLocalToDependencyLevelExecutionIndex = 0;
     }
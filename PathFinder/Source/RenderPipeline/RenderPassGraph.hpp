@@ -51,6 +51,8 @@ namespace PathFinder
 
             uint64_t ExecutionQueueIndex = 0;
             bool UsesRayTracing = false;
+            // Pass only records compute work and can be executed on either graphics or async compute queue
+            bool IsAsyncComputeEligible = false;
 
         private:
             using SynchronizationIndexSet = std::vector<uint64_t>;
@@ -94,6 +96,8 @@ namespace PathFinder
             inline auto DependencyLevelIndex() const { return mDependencyLevelIndex; }
             inline auto LocalToDependencyLevelExecutionIndex() const { return mLocalToDependencyLevelExecutionIndex; }
             inline auto LocalToQueueExecutionIndex() const { return mLocalToQueueExecutionIndex; }
+            inline auto IndexInUnorderedList() const { return mIndexInUnorderedList; }
+            inline const auto& SynchronizationIndices() const { return mSynchronizationIndexSet; }
             inline bool IsSyncSignalRequired() const { return mSyncSignalRequired; }
         };
 
@@ -165,6 +169,7 @@ namespace PathFinder
         void BuildDependencyLevels();
         void FinalizeDependencyLevels();
         void CullRedundantSynchronizations();
+        void ComputeStructureHash();
 
         NodeList mPassNodes;
         AdjacencyLists mAdjacencyLists;
@@ -185,14 +190,20 @@ namespace PathFinder
         std::vector<std::vector<const Node*>> mNodesPerQueue;
         std::vector<const Node*> mFirstNodesThatUseRayTracing;
 
+        // Identifies everything derived from the graph by execution infrastructure:
+        // execution order, queues, synchronization and subresource dependencies
+        uint64_t mStructureHash = 0;
+
     public:
         inline const auto& NodesInGlobalExecutionOrder() const { return mNodesInGlobalExecutionOrder; }
         inline const auto& Nodes() const { return mPassNodes; }
         inline auto& Nodes() { return mPassNodes; }
         inline const auto& DependencyLevels() const { return mDependencyLevels; }
+        inline const auto& NodeAdjacencyLists() const { return mAdjacencyLists; }
         inline auto DetectedQueueCount() const { return mDetectedQueueCount; }
         inline const auto& NodesForQueue(Node::QueueIndex queueIndex) const { return mNodesPerQueue[queueIndex]; }
         inline const Node* FirstNodeThatUsesRayTracingOnQueue(Node::QueueIndex queueIndex) const { return mFirstNodesThatUseRayTracing[queueIndex]; }
+        inline auto StructureHash() const { return mStructureHash; }
     };
 
 }
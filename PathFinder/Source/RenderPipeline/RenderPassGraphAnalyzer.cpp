@@ -0,0 +1,560 @@
+#include "RenderPassGraphAnalyzer.hpp"
+
+#include <Foundation/Assert.hpp>
+
+#include <bitsery/adapter/stream.h>
+#include <bitsery/traits/vector.h>
+#include <bitsery/traits/string.h>
+
+#include <fstream>
+#include <algorithm>
+
+namespace PathFinder
+{
+
+    namespace
+    {
+        std::string EscapeString(const std::string& string)
+        {
+            std::string escaped;
+            escaped.reserve(string.size());
+
+            for (char c : string)
+            {
+                if (c == '"' || c == '\\') escaped += '\\';
+                escaped += c;
+            }
+
+            return escaped;
+        }
+    }
+
+    RenderPassGraphAnalyzer::GraphRecord RenderPassGraphAnalyzer::Record(const RenderPassGraph& graph, const PipelineMeasurementStorage& measurements, TimingSource timingSource)
+    {
+        using MeasurementType = PipelineMeasurementStorage::MeasurementType;
+
+        GraphRecord record;
+        // Always record async compute queue, even if it's unused in this graph
+        record.QueueCount = std::max<uint64_t>(graph.DetectedQueueCount(), 2);
+        record.Passes.resize(graph.NodesInGlobalExecutionOrder().size());
+
+        auto timing = [&](Foundation::Name name, MeasurementType type, uint64_t queueIndex) -> float
+        {
+            const PipelineMeasurementStorage::Series* series = measurements.GetSeries(name, type, queueIndex);
+
+            if (!series)
+                return 0.0f;
+
+            switch (timingSource)
+            {
+            case TimingSource::Last: return series->Stats.Last;
+            case TimingSource::Median: return series->Stats.P50;
+            case TimingSource::P95: return series->Stats.P95;
+            default: return series->Stats.Mean;
+            }
+        };
+
+        // Adjacency lists are indexed by node's position in the unordered list
+        std::vector<uint64_t> unorderedToGlobalIndices(graph.Nodes().size(), InvalidPassIndex);
+
+        for (const RenderPassGraph::Node* node : graph.NodesInGlobalExecutionOrder())
+        {
+            unorderedToGlobalIndices[node->IndexInUnorderedList()] = node->GlobalExecutionIndex();
+        }
+
+        for (const RenderPassGraph::Node* node : graph.NodesInGlobalExecutionOrder())
+        {
+            PassRecord& pass = record.Passes[node->GlobalExecutionIndex()];
+            pass.Name = node->PassMetadata().Name.ToString();
+            pass.QueueIndex = node->ExecutionQueueIndex;
+            pass.DependencyLevelIndex = node->DependencyLevelIndex();
+            pass.WorkDuration = timing(node->PassMetadata().Name, MeasurementType::PassWork, node->ExecutionQueueIndex);
+            pass.BarrierDuration = timing(node->PassMetadata().Name, MeasurementType::PassBarriers, node->ExecutionQueueIndex);
+            pass.IsAsyncComputeEligible = node->IsAsyncComputeEligible;
+
+            for (auto queueIdx = 0u; queueIdx < record.QueueCount; ++queueIdx)
+            {
+                pass.QueueWorkDurations.push_back(timing(node->PassMetadata().Name, MeasurementType::PassWork, queueIdx));
+                pass.QueueBarrierDurations.push_back(timing(node->PassMetadata().Name, MeasurementType::PassBarriers, queueIdx));
+            }
+
+            for (const RenderPassGraph::Node* nodeToSyncWith : node->NodesToSyncWith())
+            {
+                pass.SyncedPasses.push_back(nodeToSyncWith->GlobalExecutionIndex());
+            }
+
+            for (uint64_t dependentNodeIndex : graph.NodeAdjacencyLists()[node->IndexInUnorderedList()])
+            {
+                uint64_t dependentGlobalIndex = unorderedToGlobalIndices[dependentNodeIndex];
+
+                if (dependentGlobalIndex != InvalidPassIndex)
+                {
+                    record.Passes[dependentGlobalIndex].Dependencies.push_back(node->GlobalExecutionIndex());
+                }
+            }
+        }
+
+        return record;
+    }
+
+    RenderPassGraphAnalyzer::Report RenderPassGraphAnalyzer::Analyze(const GraphRecord& record, float syncCost)
+    {
+        Report report;
+
+        uint64_t passCount = record.Passes.size();
+
+        report.Passes.resize(passCount);
+        report.Queues.resize(record.QueueCount);
+
+        std::vector<float> queueAvailableTimes(record.QueueCount, 0.0f);
+        std::vector<uint64_t> queuePreviousPasses(record.QueueCount, InvalidPassIndex);
+        std::vector<uint64_t> nextPassesOnQueue(passCount, InvalidPassIndex);
+        std::vector<float> dependencyBoundFinishTimes(passCount, 0.0f);
+
+        // Forward pass: simulate queues executing passes in their order.
+        // Passes are stored in global execution order which respects both queue order and dependencies.
+        for (auto passIdx = 0u; passIdx < passCount; ++passIdx)
+        {
+            const PassRecord& pass = record.Passes[passIdx];
+            PassAnalysis& analysis = report.Passes[passIdx];
+
+            assert_format(pass.QueueIndex < record.QueueCount, "Pass ", pass.Name, " is assigned to a queue that doesn't exist in the record");
+
+            float queueAvailableTime = queueAvailableTimes[pass.QueueIndex];
+            float start = queueAvailableTime;
+            uint64_t bindingPredecessor = queuePreviousPasses[pass.QueueIndex];
+
+            for (uint64_t syncedPassIdx : pass.SyncedPasses)
+            {
+                assert_format(syncedPassIdx < passIdx, "Pass ", pass.Name, " synchronizes with a pass that executes later");
+
+                float signalTime = report.Passes[syncedPassIdx].Finish;
+
+                SyncPointAnalysis& syncPoint = report.SyncPoints.emplace_back();
+                syncPoint.WaitingPass = passIdx;
+                syncPoint.SignalingPass = syncedPassIdx;
+                syncPoint.Stall = std::max(signalTime - queueAvailableTime, 0.0f);
+
+                if (signalTime > start)
+                {
+                    start = signalTime;
+                    bindingPredecessor = syncedPassIdx;
+                }
+            }
+
+            if (!pass.SyncedPasses.empty())
+            {
+                start += syncCost;
+            }
+
+            analysis.Start = start;
+            analysis.Finish = start + PassDuration(pass);
+            analysis.SyncWait = start - queueAvailableTime;
+            analysis.BindingPredecessor = bindingPredecessor;
+
+            if (analysis.SyncWait > 0.0f)
+            {
+                report.Queues[pass.QueueIndex].IdleGaps.push_back({ queueAvailableTime, start, passIdx });
+            }
+
+            if (queuePreviousPasses[pass.QueueIndex] != InvalidPassIndex)
+            {
+                nextPassesOnQueue[queuePreviousPasses[pass.QueueIndex]] = passIdx;
+            }
+
+            queueAvailableTimes[pass.QueueIndex] = analysis.Finish;
+            queuePreviousPasses[pass.QueueIndex] = passIdx;
+
+            report.Queues[pass.QueueIndex].WorkTime += pass.WorkDuration;
+            report.Queues[pass.QueueIndex].BarrierTime += pass.BarrierDuration;
+            report.SerialDuration += PassDuration(pass);
+            report.FrameDuration = std::max(report.FrameDuration, analysis.Finish);
+
+            // Longest path over data dependencies only
+            float dependencyBoundStart = 0.0f;
+
+            for (uint64_t dependencyIdx : pass.Dependencies)
+            {
+                dependencyBoundStart = std::max(dependencyBoundStart, dependencyBoundFinishTimes[dependencyIdx]);
+            }
+
+            dependencyBoundFinishTimes[passIdx] = dependencyBoundStart + PassDuration(pass);
+            report.DependencyBoundDuration = std::max(report.DependencyBoundDuration, dependencyBoundFinishTimes[passIdx]);
+        }
+
+        // Backward pass: latest start times that don't delay the frame.
+        // Successors of a pass are the next pass on its queue and passes that wait for it.
+        // A pass that waits pays sync cost after its predecessors finish, so they must finish that much earlier.
+        std::vector<float> latestFinishTimes(passCount, report.FrameDuration);
+        std::vector<float> latestPredecessorFinishTimes(passCount, report.FrameDuration);
+
+        for (auto passIdx = int64_t(passCount) - 1; passIdx >= 0; --passIdx)
+        {
+            const PassRecord& pass = record.Passes[passIdx];
+            PassAnalysis& analysis = report.Passes[passIdx];
+            uint64_t nextPassIdx = nextPassesOnQueue[passIdx];
+
+            if (nextPassIdx != InvalidPassIndex)
+            {
+                latestFinishTimes[passIdx] = std::min(latestFinishTimes[passIdx], latestPredecessorFinishTimes[nextPassIdx]);
+            }
+
+            analysis.LatestStart = latestFinishTimes[passIdx] - PassDuration(pass);
+            analysis.Slack = std::max(analysis.LatestStart - analysis.Start, 0.0f);
+
+            latestPredecessorFinishTimes[passIdx] = pass.SyncedPasses.empty() ? analysis.LatestStart : analysis.LatestStart - syncCost;
+
+            for (uint64_t syncedPassIdx : pass.SyncedPasses)
+            {
+                latestFinishTimes[syncedPassIdx] = std::min(latestFinishTimes[syncedPassIdx], latestPredecessorFinishTimes[passIdx]);
+            }
+        }
+
+        // Critical path: walk binding predecessors back from the pass that finishes last
+        auto lastPassIt = std::max_element(report.Passes.begin(), report.Passes.end(),
+            [](const PassAnalysis& a, const PassAnalysis& b) { return a.Finish < b.Finish; });
+
+        uint64_t criticalPassIdx = lastPassIt != report.Passes.end() ? std::distance(report.Passes.begin(), lastPassIt) : InvalidPassIndex;
+
+        while (criticalPassIdx != InvalidPassIndex)
+        {
+            report.CriticalPath.push_back(criticalPassIdx);
+            report.Passes[criticalPassIdx].IsCritical = true;
+            criticalPassIdx = report.Passes[criticalPassIdx].BindingPredecessor;
+        }
+
+        std::reverse(report.CriticalPath.begin(), report.CriticalPath.end());
+
+        for (SyncPointAnalysis& syncPoint : report.SyncPoints)
+        {
+            const PassAnalysis& waitingPass = report.Passes[syncPoint.WaitingPass];
+            syncPoint.IsBinding = syncPoint.Stall > 0.0f && waitingPass.BindingPredecessor == syncPoint.SignalingPass;
+            syncPoint.LengthensFrame = syncPoint.IsBinding && waitingPass.IsCritical;
+        }
+
+        for (auto queueIdx = 0u; queueIdx < record.QueueCount; ++queueIdx)
+        {
+            QueueAnalysis& queue = report.Queues[queueIdx];
+
+            if (queueAvailableTimes[queueIdx] < report.FrameDuration)
+            {
+                queue.IdleGaps.push_back({ queueAvailableTimes[queueIdx], report.FrameDuration, InvalidPassIndex });
+            }
+
+            queue.IdleTime = report.FrameDuration - queue.WorkTime - queue.BarrierTime;
+            queue.Utilization = report.FrameDuration > 0.0f ? (queue.WorkTime + queue.BarrierTime) / report.FrameDuration : 0.0f;
+        }
+
+        return report;
+    }
+
+    void RenderPassGraphAnalyzer::ReassignQueues(GraphRecord& record, const std::vector<uint64_t>& passQueueIndices)
+    {
+        assert_format(passQueueIndices.size() == record.Passes.size(), "Queue assignment doesn't match pass count");
+
+        using SynchronizationIndexSet = std::vector<uint64_t>;
+
+        // For each pass, indices of the latest passes on every queue that are known 
+        // to be complete by the time the pass starts. Mirrors SSIS in RenderPassGraph.
+        std::vector<SynchronizationIndexSet> synchronizationIndexSets(record.Passes.size());
+        std::vector<uint64_t> queuePreviousPasses;
+
+        for (uint64_t queueIndex : passQueueIndices)
+        {
+            record.QueueCount = std::max(record.QueueCount, queueIndex + 1);
+        }
+
+        queuePreviousPasses.resize(record.QueueCount, InvalidPassIndex);
+
+        for (auto passIdx = 0u; passIdx < record.Passes.size(); ++passIdx)
+        {
+            PassRecord& pass = record.Passes[passIdx];
+            uint64_t queueIndex = passQueueIndices[passIdx];
+
+            auto measuredOrFallback = [queueIndex](const std::vector<float>& perQueue, float fallback)
+            {
+                return queueIndex < perQueue.size() && perQueue[queueIndex] > 0.0f ? perQueue[queueIndex] : fallback;
+            };
+
+            // Pass that never ran on the target queue is assumed to cost the same as where it was measured
+            pass.WorkDuration = measuredOrFallback(pass.QueueWorkDurations, pass.WorkDuration);
+            pass.BarrierDuration = measuredOrFallback(pass.QueueBarrierDurations, pass.BarrierDuration);
+            pass.QueueIndex = queueIndex;
+            pass.SyncedPasses.clear();
+
+            SynchronizationIndexSet& indexSet = synchronizationIndexSets[passIdx];
+            uint64_t previousPassIdx = queuePreviousPasses[queueIndex];
+
+            indexSet = previousPassIdx != InvalidPassIndex ? 
+                synchronizationIndexSets[previousPassIdx] : 
+                SynchronizationIndexSet(record.QueueCount, InvalidPassIndex);
+
+            // Closest producer on every other queue
+            std::vector<uint64_t> closestProducers(record.QueueCount, InvalidPassIndex);
+
+            for (uint64_t dependencyIdx : pass.Dependencies)
+            {
+                uint64_t dependencyQueueIndex = record.Passes[dependencyIdx].QueueIndex;
+                uint64_t& closest = closestProducers[dependencyQueueIndex];
+
+                if (dependencyQueueIndex != queueIndex && (closest == InvalidPassIndex || dependencyIdx > closest))
+                {
+                    closest = dependencyIdx;
+                }
+            }
+
+            // Sync with the latest producers first, they're the most likely to cover other queues indirectly
+            std::sort(closestProducers.begin(), closestProducers.end(), [](uint64_t a, uint64_t b) 
+            {
+                return a != InvalidPassIndex && (b == InvalidPassIndex || a > b);
+            });
+
+            for (uint64_t producerIdx : closestProducers)
+            {
+                if (producerIdx == InvalidPassIndex)
+                    break;
+
+                uint64_t producerQueueIndex = record.Passes[producerIdx].QueueIndex;
+                uint64_t syncedIndex = indexSet[producerQueueIndex];
+
+                // Already synchronized indirectly
+                if (syncedIndex != InvalidPassIndex && syncedIndex >= producerIdx)
+                    continue;
+
+                pass.SyncedPasses.push_back(producerIdx);
+
+                const SynchronizationIndexSet& producerIndexSet = synchronizationIndexSets[producerIdx];
+
+                for (auto queueIdx = 0u; queueIdx < record.QueueCount; ++queueIdx)
+                {
+                    if (producerIndexSet[queueIdx] != InvalidPassIndex && (indexSet[queueIdx] == InvalidPassIndex || producerIndexSet[queueIdx] > indexSet[queueIdx]))
+                    {
+                        indexSet[queueIdx] = producerIndexSet[queueIdx];
+                    }
+                }
+            }
+
+            indexSet[queueIndex] = passIdx;
+            queuePreviousPasses[queueIndex] = passIdx;
+        }
+    }
+
+    bool RenderPassGraphAnalyzer::SaveRecord(const GraphRecord& record, const std::filesystem::path& path)
+    {
+        std::fstream stream{ path, std::ios::binary | std::ios::trunc | std::ios::out };
+
+        if (!stream.is_open())
+            return false;
+
+        bitsery::Serializer<bitsery::OutputBufferedStreamAdapter> ser{ stream };
+        ser.object(record);
+        ser.adapter().flush();
+
+        return stream.good();
+    }
+
+    std::optional<RenderPassGraphAnalyzer::GraphRecord> RenderPassGraphAnalyzer::LoadRecord(const std::filesystem::path& path)
+    {
+        std::fstream stream{ path, std::ios::binary | std::ios::in };
+
+        if (!stream.is_open())
+            return std::nullopt;
+
+        GraphRecord record;
+        bitsery::Deserializer<bitsery::InputStreamAdapter> des{ stream };
+        des.object(record);
+
+        if (des.adapter().error() != bitsery::ReaderError::NoError || record.Version != GraphRecord::CurrentVersion)
+            return std::nullopt;
+
+        // Reject records referencing passes that don't exist
+        for (auto passIdx = 0u; passIdx < record.Passes.size(); ++passIdx)
+        {
+            const PassRecord& pass = record.Passes[passIdx];
+
+            auto isValidReference = [&](uint64_t index) { return index < passIdx; };
+
+            if (pass.QueueIndex >= record.QueueCount ||
+                !std::all_of(pass.Dependencies.begin(), pass.Dependencies.end(), isValidReference) ||
+                !std::all_of(pass.SyncedPasses.begin(), pass.SyncedPasses.end(), isValidReference))
+            {
+                return std::nullopt;
+            }
+        }
+
+        return record;
+    }
+
+    bool RenderPassGraphAnalyzer::ExportDOT(const GraphRecord& record, const Report& report, const std::filesystem::path& path)
+    {
+        std::ofstream stream{ path, std::ios::out | std::ios::trunc };
+
+        if (!stream.is_open())
+            return false;
+
+        stream.precision(3);
+        stream << std::fixed;
+
+        stream << "digraph RenderPassGraph {\n";
+        stream << "  rankdir=LR;\n";
+        stream << "  node [shape=box, style=filled, fillcolor=white, fontname=\"Consolas\"];\n";
+        stream << "  label=\"Frame " << report.FrameDuration * 1e3f << " ms | Serial " << report.SerialDuration * 1e3f
+            << " ms | Dependency Bound " << report.DependencyBoundDuration * 1e3f << " ms\";\n";
+
+        for (auto queueIdx = 0u; queueIdx < record.QueueCount; ++queueIdx)
+        {
+            const QueueAnalysis& queue = report.Queues[queueIdx];
+
+            stream << "  subgraph cluster_queue_" << queueIdx << " {\n";
+            stream << "    label=\"Queue " << queueIdx << " (" << queue.Utilization * 100.0f << "% busy, " << queue.IdleTime * 1e3f << " ms idle)\";\n";
+
+            for (auto passIdx = 0u; passIdx < record.Passes.size(); ++passIdx)
+            {
+                const PassRecord& pass = record.Passes[passIdx];
+                const PassAnalysis& analysis = report.Passes[passIdx];
+
+                if (pass.QueueIndex != queueIdx)
+                    continue;
+
+                stream << "    p" << passIdx << " [label=\"" << EscapeString(pass.Name)
+                    << "\\nwork " << pass.WorkDuration * 1e3f << " ms, barriers " << pass.BarrierDuration * 1e3f << " ms"
+                    << "\\nstart " << analysis.Start * 1e3f << " ms, slack " << analysis.Slack * 1e3f << " ms\"";
+
+                if (analysis.IsCritical)
+                    stream << ", fillcolor=\"#ffb3b3\", penwidth=2";
+
+                stream << "];\n";
+            }
+
+            stream << "  }\n";
+        }
+
+        for (auto passIdx = 0u; passIdx < record.Passes.size(); ++passIdx)
+        {
+            for (uint64_t dependencyIdx : record.Passes[passIdx].Dependencies)
+            {
+                stream << "  p" << dependencyIdx << " -> p" << passIdx << ";\n";
+            }
+        }
+
+        for (const SyncPointAnalysis& syncPoint : report.SyncPoints)
+        {
+            stream << "  p" << syncPoint.SignalingPass << " -> p" << syncPoint.WaitingPass
+                << " [style=dashed, constraint=false, label=\"sync " << syncPoint.Stall * 1e3f << " ms\"";
+
+            if (syncPoint.LengthensFrame)
+                stream << ", color=red, fontcolor=red, penwidth=2";
+
+            stream << "];\n";
+        }
+
+        stream << "}\n";
+
+        return stream.good();
+    }
+
+    bool RenderPassGraphAnalyzer::ExportJSON(const GraphRecord& record, const Report& report, const std::filesystem::path& path)
+    {
+        std::ofstream stream{ path, std::ios::out | std::ios::trunc };
+
+        if (!stream.is_open())
+            return false;
+
+        stream.precision(9);
+
+        auto writeIndices = [&stream](const std::vector<uint64_t>& indices)
+        {
+            stream << "[";
+            for (auto i = 0u; i < indices.size(); ++i)
+                stream << (i ? "," : "") << indices[i];
+            stream << "]";
+        };
+
+        stream << "{\"units\":\"seconds\",\"frameDuration\":" << report.FrameDuration
+            << ",\"serialDuration\":" << report.SerialDuration
+            << ",\"dependencyBoundDuration\":" << report.DependencyBoundDuration
+            << ",\"criticalPath\":";
+
+        writeIndices(report.CriticalPath);
+
+        stream << ",\n\"passes\":[\n";
+
+        for (auto passIdx = 0u; passIdx < record.Passes.size(); ++passIdx)
+        {
+            const PassRecord& pass = record.Passes[passIdx];
+            const PassAnalysis& analysis = report.Passes[passIdx];
+
+            stream << "{\"index\":" << passIdx << ",\"name\":\"" << EscapeString(pass.Name) << "\",\"queue\":" << pass.QueueIndex
+                << ",\"dependencyLevel\":" << pass.DependencyLevelIndex << ",\"work\":" << pass.WorkDuration << ",\"barriers\":" << pass.BarrierDuration
+                << ",\"start\":" << analysis.Start << ",\"finish\":" << analysis.Finish << ",\"latestStart\":" << analysis.LatestStart
+                << ",\"slack\":" << analysis.Slack << ",\"syncWait\":" << analysis.SyncWait << ",\"critical\":" << (analysis.IsCritical ? "true" : "false")
+                << ",\"dependencies\":";
+
+            writeIndices(pass.Dependencies);
+            stream << ",\"syncedPasses\":";
+            writeIndices(pass.SyncedPasses);
+            stream << "}" << (passIdx + 1 < record.Passes.size() ? ",\n" : "\n");
+        }
+
+        stream << "],\n\"queues\":[\n";
+
+        for (auto queueIdx = 0u; queueIdx < report.Queues.size(); ++queueIdx)
+        {
+            const QueueAnalysis& queue = report.Queues[queueIdx];
+
+            stream << "{\"index\":" << queueIdx << ",\"work\":" << queue.WorkTime << ",\"barriers\":" << queue.BarrierTime
+                << ",\"idle\":" << queue.IdleTime << ",\"utilization\":" << queue.Utilization << ",\"idleGaps\":[";
+
+            for (auto gapIdx = 0u; gapIdx < queue.IdleGaps.size(); ++gapIdx)
+            {
+                const IdleGap& gap = queue.IdleGaps[gapIdx];
+                stream << (gapIdx ? "," : "") << "{\"start\":" << gap.Start << ",\"end\":" << gap.End << ",\"blockedPass\":";
+
+                if (gap.BlockedPass != InvalidPassIndex) stream << gap.BlockedPass;
+                else stream << "null";
+
+                stream << "}";
+            }
+
+            stream << "]}" << (queueIdx + 1 < report.Queues.size() ? ",\n" : "\n");
+        }
+
+        stream << "],\n\"syncPoints\":[\n";
+
+        for (auto syncIdx = 0u; syncIdx < report.SyncPoints.size(); ++syncIdx)
+        {
+            const SyncPointAnalysis& syncPoint = report.SyncPoints[syncIdx];
+
+            stream << "{\"waitingPass\":" << syncPoint.WaitingPass << ",\"signalingPass\":" << syncPoint.SignalingPass
+                << ",\"stall\":" << syncPoint.Stall << ",\"binding\":" << (syncPoint.IsBinding ? "true" : "false")
+                << ",\"lengthensFrame\":" << (syncPoint.LengthensFrame ? "true" : "false") << "}"
+                << (syncIdx + 1 < report.SyncPoints.size() ? ",\n" : "\n");
+        }
+
+        stream << "]}\n";
+
+        return stream.good();
+    }
+
+    bool RenderPassGraphAnalyzer::AnalyzeRecordedGraph(const std::filesystem::path& recordPath)
+    {
+        std::optional<GraphRecord> record = LoadRecord(recordPath);
+
+        if (!record)
+            return false;
+
+        Report report = Analyze(*record);
+
+        std::filesystem::path dotPath = recordPath;
+        std::filesystem::path jsonPath = recordPath;
+
+        return ExportDOT(*record, report, dotPath.replace_extension(".dot")) &&
+            ExportJSON(*record, report, jsonPath.replace_extension(".json"));
+    }
+
+    float RenderPassGraphAnalyzer::PassDuration(const PassRecord& pass)
+    {
+        return pass.WorkDuration + pass.BarrierDuration;
+    }
+
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "RenderPassGraph.hpp"
+#include "PipelineMeasurementStorage.hpp"
+
+#include <bitsery/bitsery.h>
+
+#include <vector>
+#include <string>
+#include <optional>
+#include <filesystem>
+
+namespace PathFinder
+{
+
+    /// Offline view of a built render pass graph combined with measured pass timings.
+    /// Simulates queue execution using the graph's queue assignment and culled cross-queue
+    /// synchronizations to find the critical path, per-queue idle gaps, per-pass slack
+    /// and synchronization points that lengthen the frame.
+    /// Graphs can be recorded to disk and analyzed later without a device.
+    class RenderPassGraphAnalyzer
+    {
+    public:
+        inline static const uint64_t InvalidPassIndex = std::numeric_limits<uint64_t>::max();
+
+        enum class TimingSource : uint8_t
+        {
+            Last, Mean, Median, P95
+        };
+
+        struct PassRecord
+        {
+            std::string Name;
+            uint64_t QueueIndex = 0;
+            uint64_t DependencyLevelIndex = 0;
+            float WorkDuration = 0.0f;
+            float BarrierDuration = 0.0f;
+            // Pass can be moved between graphics and async compute queues
+            bool IsAsyncComputeEligible = false;
+            // Timings measured on each queue. Zero if pass never ran on a queue.
+            std::vector<float> QueueWorkDurations;
+            std::vector<float> QueueBarrierDurations;
+            // Global execution indices of passes producing data this pass consumes
+            std::vector<uint64_t> Dependencies;
+            // Global execution indices of passes on other queues this pass waits for
+            std::vector<uint64_t> SyncedPasses;
+
+            template <typename S>
+            void serialize(S& s)
+            {
+                s.container1b(Name, 1000);
+                s.value8b(QueueIndex);
+                s.value8b(DependencyLevelIndex);
+                s.value4b(WorkDuration);
+                s.value4b(BarrierDuration);
+                s.boolValue(IsAsyncComputeEligible);
+                s.container4b(QueueWorkDurations, std::numeric_limits<uint64_t>::max());
+                s.container4b(QueueBarrierDurations, std::numeric_limits<uint64_t>::max());
+                s.container8b(Dependencies, std::numeric_limits<uint64_t>::max());
+                s.container8b(SyncedPasses, std::numeric_limits<uint64_t>::max());
+            }
+        };
+
+        struct GraphRecord
+        {
+            inline static const uint32_t CurrentVersion = 1;
+
+            uint32_t Version = CurrentVersion;
+            uint64_t QueueCount = 1;
+            // Passes in global execution order
+            std::vector<PassRecord> Passes;
+
+            template <typename S>
+            void serialize(S& s)
+            {
+                s.value4b(Version);
+                s.value8b(QueueCount);
+                s.container(Passes, std::numeric_limits<uint64_t>::max());
+            }
+        };
+
+        struct PassAnalysis
+        {
+            float Start = 0.0f;
+            float Finish = 0.0f;
+            float LatestStart = 0.0f;
+            float Slack = 0.0f;
+            // Time the pass's queue sat idle waiting for other queues before this pass could start
+            float SyncWait = 0.0f;
+            // Predecessor that determined the start time: previous pass on the queue or a synced pass
+            uint64_t BindingPredecessor = InvalidPassIndex;
+            bool IsCritical = false;
+        };
+
+        struct IdleGap
+        {
+            float Start = 0.0f;
+            float End = 0.0f;
+            // Pass that couldn't start earlier. Invalid for a gap at the end of the frame.
+            uint64_t BlockedPass = InvalidPassIndex;
+        };
+
+        struct QueueAnalysis
+        {
+            float WorkTime = 0.0f;
+            float BarrierTime = 0.0f;
+            float IdleTime = 0.0f;
+            float Utilization = 0.0f;
+            std::vector<IdleGap> IdleGaps;
+        };
+
+        struct SyncPointAnalysis
+        {
+            uint64_t WaitingPass = InvalidPassIndex;
+            uint64_t SignalingPass = InvalidPassIndex;
+            // How long the waiting queue was stalled by this particular sync
+            float Stall = 0.0f;
+            bool IsBinding = false;
+            // Stall lies on the critical path, removing it would shorten the frame
+            bool LengthensFrame = false;
+        };
+
+        struct Report
+        {
+            // Simulated frame length with current queue assignment and synchronization
+            float FrameDuration = 0.0f;
+            // Frame length if every pass ran on a single queue
+            float SerialDuration = 0.0f;
+            // Lower bound defined by data dependencies alone, as if every pass had its own queue
+            float DependencyBoundDuration = 0.0f;
+            std::vector<uint64_t> CriticalPath;
+            std::vector<PassAnalysis> Passes;
+            std::vector<QueueAnalysis> Queues;
+            std::vector<SyncPointAnalysis> SyncPoints;
+        };
+
+        static GraphRecord Record(const RenderPassGraph& graph, const PipelineMeasurementStorage& measurements, TimingSource timingSource = TimingSource::Mean);
+        // Sync cost models fence wait and command list submission split on the waiting queue
+        static Report Analyze(const GraphRecord& record, float syncCost = 0.0f);
+
+        // Moves passes to the provided queues, picks up timings measured on those queues
+        // and recomputes cross-queue synchronizations the same way the render pass graph would
+        static void ReassignQueues(GraphRecord& record, const std::vector<uint64_t>& passQueueIndices);
+
+        static bool SaveRecord(const GraphRecord& record, const std::filesystem::path& path);
+        static std::optional<GraphRecord> LoadRecord(const std::filesystem::path& path);
+
+        static bool ExportDOT(const GraphRecord& record, const Report& report, const std::filesystem::path& path);
+        static bool ExportJSON(const GraphRecord& record, const Report& report, const std::filesystem::path& path);
+
+        // Loads a recorded graph and writes .dot and .json analysis files next to it
+        static bool AnalyzeRecordedGraph(const std::filesystem::path& recordPath);
+
+    private:
+        static float PassDuration(const PassRecord& pass);
+    };
+
+}
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "../PipelineResourceStorage.hpp"
+#include "../PipelineResourceSchedulingRequests.hpp"
 #include "../PipelineSettings.hpp"
+#include "../QueueAssignmentOptimizer.hpp"
 #include "../RenderPassGraph.hpp"
 
 #include "RenderPassUtilityProvider.hpp"
@@ -117,11 +119,21 @@ namespace PathFinder
 
     struct NewByteBufferProperties : public NewBufferProperties<uint32_t> {};
 
+    /// Records resource requests of a render pass into the pass's request buffer.
+    /// Recording only touches the buffer, so schedulers copied per thread can record different passes in parallel.
+    /// The engine then merges recorded buffers, in pass order, into scheduling infos of resources and the render pass graph.
     template <class ContentMediator>
     class ResourceScheduler
     {
     public:
-        ResourceScheduler(PipelineResourceStorage* manager, RenderPassUtilityProvider* utilityProvider, RenderPassGraph* passGraph, const PipelineSettings* settings);
+        using RecordedPassRequests = std::pair<RenderPassGraph::Node*, const PipelineResourceSchedulingRequests*>;
+
+        ResourceScheduler(
+            PipelineResourceStorage* manager, 
+            RenderPassUtilityProvider* utilityProvider, 
+            RenderPassGraph* passGraph, 
+            const PipelineSettings* settings,
+            const QueueAssignmentOptimizer* queueAssignmentOptimizer);
 
         // Allocates new render target texture (Write Only)
         void NewRenderTarget(
@@ -223,17 +235,47 @@ namespace PathFinder
         void Export(Foundation::Name resourceName);
 
         // To be called by the engine, not render passes
-        void SetCurrentlySchedulingPassNode(RenderPassGraph::Node* node);
+        void SetRecordingTarget(PipelineResourceSchedulingRequests* requests);
         void SetContent(const ContentMediator* content);
 
+        // Queues resource creations and aliases with resource storage and applies pass node requests.
+        // To be called between PipelineResourceStorage::StartResourceScheduling() and EndResourceScheduling().
+        void QueueRecordedRequests(const std::vector<RecordedPassRequests>& passRequests);
+
+        // Merges recorded requests into scheduling infos of resources and graph dependencies of pass nodes.
+        // To be called after PipelineResourceStorage::EndResourceScheduling().
+        void MergeRecordedRequests(const std::vector<RecordedPassRequests>& passRequests);
+
     private:
+        using Request = PipelineResourceSchedulingRequests::Request;
+        using RequestType = PipelineResourceSchedulingRequests::RequestType;
+        using RequestMips = PipelineResourceSchedulingRequests::Mips;
+
+        void RecordRequest(
+            RequestType type,
+            Foundation::Name resourceName,
+            Foundation::Name outputAliasName,
+            const MipSet& mips,
+            std::optional<HAL::ColorFormat> concreteFormat,
+            HAL::ResourceState readState = HAL::ResourceState::Common,
+            bool canBeReadAcrossFrames = false);
+
+        RequestMips RecordMips(const MipSet& mips);
+
+        void MergeRequest(RenderPassGraph::Node& passNode, const PipelineResourceSchedulingRequests& requests, const Request& request);
+        void ApplyExecutionQueue(RenderPassGraph::Node& passNode, RenderPassExecutionQueue queue) const;
+
+        template <class Function>
+        void ForEachMip(const RequestMips& mips, const PipelineResourceSchedulingRequests& requests, uint32_t resourceMipCount, const Function& function) const;
+
         NewTextureProperties FillMissingFields(std::optional<NewTextureProperties> properties) const;
         NewDepthStencilProperties FillMissingFields(std::optional<NewDepthStencilProperties> properties) const;
         uint32_t MaxMipCount(const Geometry::Dimensions& dimensions) const;
 
         void RegisterGraphDependency(
             RenderPassGraph::Node& passNode, 
-            const MipSet& subresources, 
+            const RequestMips& mips, 
+            const PipelineResourceSchedulingRequests& requests,
             Foundation::Name resourceName,
             Foundation::Name outputAliasName,
             uint32_t resourceMipCount, 
@@ -241,7 +283,8 @@ namespace PathFinder
 
         void UpdateSubresourceInfos(
             PipelineResourceSchedulingInfo& resourceShcedulingInfo,
-            const MipSet& mips,
+            const RequestMips& mips,
+            const PipelineResourceSchedulingRequests& requests,
             Foundation::Name passName,
             HAL::ResourceState state, 
             PipelineResourceSchedulingInfo::SubresourceInfo::AccessFlag accessFlag,
@@ -250,12 +293,13 @@ namespace PathFinder
         template <class Lambda>
         void FillCurrentPassInfo(const PipelineResourceStorageResource* resourceData, const MipList& mipList, const Lambda& lambda);
 
-        RenderPassGraph::Node* mCurrentlySchedulingPassNode = nullptr;
+        PipelineResourceSchedulingRequests* mRequests = nullptr;
         PipelineResourceStorage* mResourceStorage = nullptr;
         RenderPassUtilityProvider* mUtilityProvider = nullptr;
         RenderPassGraph* mRenderPassGraph = nullptr;
         const ContentMediator* mContent = nullptr;
         const PipelineSettings* mPipelineSettings = nullptr;
+        const QueueAssignmentOptimizer* mQueueAssignmentOptimizer = nullptr;
 
     public:
         inline const RenderSurfaceDescription& GetDefaultRenderSurfaceDesc() const { return mUtilityProvider->DefaultRenderSurfaceDescription; }
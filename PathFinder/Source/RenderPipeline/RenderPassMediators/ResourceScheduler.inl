@@ -6,12 +6,14 @@ namespace PathFinder
         PipelineResourceStorage* manager, 
         RenderPassUtilityProvider* utilityProvider, 
         RenderPassGraph* passGraph, 
-        const PipelineSettings* settings)
+        const PipelineSettings* settings,
+        const QueueAssignmentOptimizer* queueAssignmentOptimizer)
         :
         mResourceStorage{ manager },
         mUtilityProvider{ utilityProvider },
         mRenderPassGraph{ passGraph },
-        mPipelineSettings{ settings }
+        mPipelineSettings{ settings },
+        mQueueAssignmentOptimizer{ queueAssignmentOptimizer }
     {}
 
     template <class ContentMediator>
@@ -30,32 +32,19 @@ namespace PathFinder
         HAL::FormatVariant format = *props.ShaderVisibleFormat;
         if (props.TypelessFormat) format = *props.TypelessFormat;
 
-        mResourceStorage->QueueResourceAllocationIfNeeded(
-            mCurrentlySchedulingPassNode->PassMetadata().Name,
-            resourceName,
+        mRequests->Creations.push_back(PipelineResourceSchedulingRequests::Creation{
             HAL::TextureProperties{ format, *props.Kind, *props.Dimensions, *props.ClearValues, HAL::ResourceState::Common, *props.MipCount },
-            props.TextureToCopyPropertiesFrom,
+            resourceName,
+            props.TextureToCopyPropertiesFrom });
 
-            [canBeReadAcrossFrames,
-            passNode = mCurrentlySchedulingPassNode,
-            typelessFormat = props.TypelessFormat,
-            shaderVisibleFormat = props.ShaderVisibleFormat,
+        RecordRequest(
+            RequestType::NewRenderTarget,
             resourceName,
+            {},
             writtenMips,
-            this]
-        (PipelineResourceSchedulingInfo& schedulingInfo)
-        {
-            schedulingInfo.CanBeAliased = !canBeReadAcrossFrames && mPipelineSettings->IsMemoryAliasingEnabled;
-            RegisterGraphDependency(*passNode, writtenMips, resourceName, {}, schedulingInfo.ResourceFormat().GetTextureProperties().MipCount, true);
-            UpdateSubresourceInfos(
-                schedulingInfo,
-                writtenMips,
-                passNode->PassMetadata().Name,
-                HAL::ResourceState::RenderTarget,
-                PipelineResourceSchedulingInfo::SubresourceInfo::AccessFlag::TextureRT,
-                typelessFormat ? shaderVisibleFormat : std::nullopt);
-        }
-        );
+            props.TypelessFormat ? props.ShaderVisibleFormat : std::nullopt,
+            HAL::ResourceState::Common,
+            canBeReadAcrossFrames);
     }
 
     template <class ContentMediator>
@@ -71,30 +60,12 @@ namespace PathFinder
         bool canBeReadAcrossFrames = EnumMaskContains(props.Flags, ResourceSchedulingFlags::CrossFrameRead);
         HAL::DepthStencilClearValue clearValue{ 1.0, 0 };
 
-        mResourceStorage->QueueResourceAllocationIfNeeded(
-            mCurrentlySchedulingPassNode->PassMetadata().Name,
-            resourceName,
+        mRequests->Creations.push_back(PipelineResourceSchedulingRequests::Creation{
             HAL::TextureProperties{ *props.Format, HAL::TextureKind::Texture2D, *props.Dimensions, clearValue, HAL::ResourceState::Common, *props.MipCount },
-            props.TextureToCopyPropertiesFrom,
-
-            [canBeReadAcrossFrames,
-            passNode = mCurrentlySchedulingPassNode,
             resourceName,
-            writtenMips,
-            this]
-        (PipelineResourceSchedulingInfo& schedulingInfo)
-            {
-                schedulingInfo.CanBeAliased = !canBeReadAcrossFrames && mPipelineSettings->IsMemoryAliasingEnabled;
-                RegisterGraphDependency(*passNode, writtenMips, resourceName, {}, schedulingInfo.ResourceFormat().GetTextureProperties().MipCount, true);
-                UpdateSubresourceInfos(
-                    schedulingInfo,
-                    writtenMips,
-                    passNode->PassMetadata().Name,
-                    HAL::ResourceState::DepthWrite,
-                    PipelineResourceSchedulingInfo::SubresourceInfo::AccessFlag::TextureDS,
-                    std::nullopt);
-            }
-        );
+            props.TextureToCopyPropertiesFrom });
+
+        RecordRequest(RequestType::NewDepthStencil, resourceName, {}, writtenMips, std::nullopt, HAL::ResourceState::Common, canBeReadAcrossFrames);
     }
 
     template <class ContentMediator>
@@ -112,32 +83,19 @@ namespace PathFinder
         HAL::FormatVariant format = *props.ShaderVisibleFormat;
         if (props.TypelessFormat) format = *props.TypelessFormat;
 
-        mResourceStorage->QueueResourceAllocationIfNeeded(
-            mCurrentlySchedulingPassNode->PassMetadata().Name,
-            resourceName,
+        mRequests->Creations.push_back(PipelineResourceSchedulingRequests::Creation{
             HAL::TextureProperties{ format, *props.Kind, *props.Dimensions, *props.ClearValues, HAL::ResourceState::Common, *props.MipCount },
-            props.TextureToCopyPropertiesFrom,
+            resourceName,
+            props.TextureToCopyPropertiesFrom });
 
-            [canBeReadAcrossFrames,
-            passNode = mCurrentlySchedulingPassNode,
-            typelessFormat = props.TypelessFormat,
-            shaderVisibleFormat = props.ShaderVisibleFormat,
+        RecordRequest(
+            RequestType::NewTexture,
             resourceName,
+            {},
             writtenMips,
-            this]
-        (PipelineResourceSchedulingInfo& schedulingInfo)
-        {
-            schedulingInfo.CanBeAliased = !canBeReadAcrossFrames && mPipelineSettings->IsMemoryAliasingEnabled;
-            RegisterGraphDependency(*passNode, writtenMips, resourceName, {}, schedulingInfo.ResourceFormat().GetTextureProperties().MipCount, true);
-            UpdateSubresourceInfos(
-                schedulingInfo,
-                writtenMips,
-                passNode->PassMetadata().Name,
-                HAL::ResourceState::UnorderedAccess,
-                PipelineResourceSchedulingInfo::SubresourceInfo::AccessFlag::TextureUA,
-                typelessFormat ? shaderVisibleFormat : std::nullopt);
-        }
-        );
+            props.TypelessFormat ? props.ShaderVisibleFormat : std::nullopt,
+            HAL::ResourceState::Common,
+            canBeReadAcrossFrames);
     }
 
     template <class ContentMediator>
@@ -149,33 +107,7 @@ namespace PathFinder
     template <class ContentMediator>
     void ResourceScheduler<ContentMediator>::AliasAndUseRenderTarget(Foundation::Name resourceName, Foundation::Name outputAliasName, const MipSet& writtenMips, std::optional<HAL::ColorFormat> concreteFormat)
     {
-        mResourceStorage->QueueResourceUsage(
-            mCurrentlySchedulingPassNode->PassMetadata().Name,
-            resourceName, 
-            outputAliasName.IsValid() ? std::optional(outputAliasName) : std::nullopt,
-
-            [passNode = mCurrentlySchedulingPassNode,
-            concreteFormat,
-            writtenMips,
-            resourceName,
-            outputAliasName,
-            this]
-        (PipelineResourceSchedulingInfo& schedulingInfo)
-            {
-                bool isTypeless = std::holds_alternative<HAL::TypelessColorFormat>(schedulingInfo.ResourceFormat().GetTextureProperties().Format);
-
-                assert_format(concreteFormat || !isTypeless, "Redefinition of Render target format is not allowed");
-                assert_format(!concreteFormat || isTypeless, "Render target is typeless and concrete color format was not provided");
-
-                RegisterGraphDependency(*passNode, writtenMips, resourceName, outputAliasName, schedulingInfo.ResourceFormat().GetTextureProperties().MipCount, true);
-                UpdateSubresourceInfos(
-                    schedulingInfo,
-                    writtenMips,
-                    passNode->PassMetadata().Name,
-                    HAL::ResourceState::RenderTarget,
-                    PipelineResourceSchedulingInfo::SubresourceInfo::AccessFlag::TextureRT,
-                    isTypeless ? concreteFormat : std::nullopt);
-            });
+        RecordRequest(RequestType::UseRenderTarget, resourceName, outputAliasName, writtenMips, concreteFormat);
     }
 
     template <class ContentMediator>
@@ -187,71 +119,21 @@ namespace PathFinder
     template <class ContentMediator>
     void ResourceScheduler<ContentMediator>::AliasAndUseDepthStencil(Foundation::Name resourceName, Foundation::Name outputAliasName)
     {
-        mResourceStorage->QueueResourceUsage(
-            mCurrentlySchedulingPassNode->PassMetadata().Name,
-            resourceName, 
-            outputAliasName.IsValid() ? std::optional(outputAliasName) : std::nullopt,
-
-            [passNode = mCurrentlySchedulingPassNode,
-            resourceName,
-            outputAliasName,
-            this]
-        (PipelineResourceSchedulingInfo& schedulingInfo)
-            {
-                assert_format(std::holds_alternative<HAL::DepthStencilFormat>(schedulingInfo.ResourceFormat().GetTextureProperties().Format), "Cannot reuse non-depth-stencil texture");
-
-                RegisterGraphDependency(*passNode, MipSet::FirstMip(), resourceName, outputAliasName, schedulingInfo.ResourceFormat().GetTextureProperties().MipCount, true);
-                UpdateSubresourceInfos(
-                    schedulingInfo,
-                    MipSet::FirstMip(),
-                    passNode->PassMetadata().Name,
-                    HAL::ResourceState::DepthWrite,
-                    PipelineResourceSchedulingInfo::SubresourceInfo::AccessFlag::TextureDS,
-                    std::nullopt);
-            });
+        RecordRequest(RequestType::UseDepthStencil, resourceName, outputAliasName, MipSet::FirstMip(), std::nullopt);
     }
 
     template <class ContentMediator>
     void ResourceScheduler<ContentMediator>::ReadTexture(Foundation::Name resourceName, TextureReadContext readContext, const MipSet& readMips, std::optional<HAL::ColorFormat> concreteFormat)
     {
-        mResourceStorage->QueueResourceUsage(
-            mCurrentlySchedulingPassNode->PassMetadata().Name,
-            resourceName, 
-            {},
-
-            [passNode = mCurrentlySchedulingPassNode,
-            readContext,
-            readMips,
-            concreteFormat,
-            resourceName,
-            this]
-        (PipelineResourceSchedulingInfo& schedulingInfo)
-            {
-                bool isTypeless = std::holds_alternative<HAL::TypelessColorFormat>(schedulingInfo.ResourceFormat().GetTextureProperties().Format);
-                assert_format(concreteFormat || !isTypeless, "Redefinition of texture format is not allowed");
-
-                HAL::ResourceState state = HAL::ResourceState::Common;
-                switch (readContext)
-                {
-                case TextureReadContext::AnyShader: state = HAL::ResourceState::AnyShaderAccess; break;
-                case TextureReadContext::PixelShader: state = HAL::ResourceState::PixelShaderAccess; break;
-                case TextureReadContext::NonPixelShader: state = HAL::ResourceState::NonPixelShaderAccess; break;
-                }
-
-                if (std::holds_alternative<HAL::DepthStencilFormat>(schedulingInfo.ResourceFormat().GetTextureProperties().Format))
-                {
-                    state |= HAL::ResourceState::DepthRead;
-                }
+        HAL::ResourceState state = HAL::ResourceState::Common;
+        switch (readContext)
+        {
+        case TextureReadContext::AnyShader: state = HAL::ResourceState::AnyShaderAccess; break;
+        case TextureReadContext::PixelShader: state = HAL::ResourceState::PixelShaderAccess; break;
+        case TextureReadContext::NonPixelShader: state = HAL::ResourceState::NonPixelShaderAccess; break;
+        }
 
-                RegisterGraphDependency(*passNode, readMips, resourceName, {}, schedulingInfo.ResourceFormat().GetTextureProperties().MipCount, false);
-                UpdateSubresourceInfos(
-                    schedulingInfo,
-                    readMips,
-                    passNode->PassMetadata().Name,
-                    state,
-                    PipelineResourceSchedulingInfo::SubresourceInfo::AccessFlag::TextureSR,
-                    std::nullopt);
-            });
+        RecordRequest(RequestType::ReadTexture, resourceName, {}, readMips, concreteFormat, state);
     }
 
     template <class ContentMediator>
@@ -263,33 +145,7 @@ namespace PathFinder
     template <class ContentMediator>
     void ResourceScheduler<ContentMediator>::AliasAndWriteTexture(Foundation::Name resourceName, Foundation::Name outputAliasName, const MipSet& writtenMips, std::optional<HAL::ColorFormat> concreteFormat)
     {
-        mResourceStorage->QueueResourceUsage(
-            mCurrentlySchedulingPassNode->PassMetadata().Name,
-            resourceName, 
-            outputAliasName.IsValid() ? std::optional(outputAliasName) : std::nullopt,
-
-            [passNode = mCurrentlySchedulingPassNode,
-            concreteFormat,
-            resourceName,
-            outputAliasName,
-            writtenMips,
-            this]
-        (PipelineResourceSchedulingInfo& schedulingInfo)
-            {
-                bool isTypeless = std::holds_alternative<HAL::TypelessColorFormat>(schedulingInfo.ResourceFormat().GetTextureProperties().Format);
-
-                assert_format(concreteFormat || !isTypeless, "Redefinition of texture format is not allowed");
-                assert_format(!concreteFormat || isTypeless, "Texture is typeless and concrete color format was not provided");
-
-                RegisterGraphDependency(*passNode, writtenMips, resourceName, outputAliasName, schedulingInfo.ResourceFormat().GetTextureProperties().MipCount, true);
-                UpdateSubresourceInfos(
-                    schedulingInfo,
-                    writtenMips,
-                    passNode->PassMetadata().Name,
-                    HAL::ResourceState::UnorderedAccess,
-                    PipelineResourceSchedulingInfo::SubresourceInfo::AccessFlag::TextureUA,
-                    isTypeless ? concreteFormat : std::nullopt);
-            });
+        RecordRequest(RequestType::WriteTexture, resourceName, outputAliasName, writtenMips, concreteFormat);
     }
 
     template <class ContentMediator>
@@ -313,41 +169,32 @@ namespace PathFinder
     template <class ContentMediator>
     void ResourceScheduler<ContentMediator>::WriteToBackBuffer()
     {
-        mCurrentlySchedulingPassNode->AddWriteDependency(RenderPassGraph::Node::BackBufferName, std::nullopt, 1);
+        mRequests->WritesToBackBuffer = true;
     }
 
     template <class ContentMediator>
     void ResourceScheduler<ContentMediator>::ExecuteOnQueue(RenderPassExecutionQueue queue)
     {
-        // Ignore render pass queue preference if async is disabled
-        mCurrentlySchedulingPassNode->ExecutionQueueIndex =
-            mPipelineSettings->IsAsyncComputeEnabled ?
-            std::underlying_type_t<RenderPassExecutionQueue>(queue) :
-            std::underlying_type_t<RenderPassExecutionQueue>(RenderPassExecutionQueue::Graphics);
+        // Queue is resolved on merge, because automatic queue assignment can change between frames
+        mRequests->RequestedQueue = queue;
     }
 
     template <class ContentMediator>
     void ResourceScheduler<ContentMediator>::UseRayTracing()
     {
-        mCurrentlySchedulingPassNode->UsesRayTracing = true;
+        mRequests->UsesRayTracing = true;
     }
 
     template <class ContentMediator>
     void ResourceScheduler<ContentMediator>::Export(Foundation::Name resourceName)
     {
-        mResourceStorage->QueueResourceReadback(mCurrentlySchedulingPassNode->PassMetadata().Name, resourceName,
-            [resourceName, node = mCurrentlySchedulingPassNode](PipelineResourceSchedulingInfo& schedulingInfo)
-        {
-            PipelineResourceSchedulingInfo::PassInfo* passInfo = schedulingInfo.GetInfoForPass(node->PassMetadata().Name);
-            assert_format(passInfo, "Resource ", resourceName.ToString(), " wasn't scheduled for usage in ", node->PassMetadata().Name.ToString());
-            passInfo->IsReadbackRequested = true;
-        });
+        RecordRequest(RequestType::Export, resourceName, {}, MipSet::Empty(), std::nullopt);
     }
 
     template <class ContentMediator>
-    void ResourceScheduler<ContentMediator>::SetCurrentlySchedulingPassNode(RenderPassGraph::Node* node)
+    void ResourceScheduler<ContentMediator>::SetRecordingTarget(PipelineResourceSchedulingRequests* requests)
     {
-        mCurrentlySchedulingPassNode = node;
+        mRequests = requests;
     }
 
     template <class ContentMediator>
@@ -356,6 +203,262 @@ namespace PathFinder
         mContent = content;
     }
 
+    template <class ContentMediator>
+    void ResourceScheduler<ContentMediator>::QueueRecordedRequests(const std::vector<RecordedPassRequests>& passRequests)
+    {
+        for (const auto& [passNode, requests] : passRequests)
+        {
+            for (const PipelineResourceSchedulingRequests::Creation& creation : requests->Creations)
+            {
+                mResourceStorage->QueueResourceAllocationIfNeeded(
+                    passNode->PassMetadata().Name, creation.ResourceName, creation.Properties, creation.PropertyCopySourceName);
+            }
+
+            for (const Request& request : requests->Requests)
+            {
+                if (request.OutputAliasName.IsValid())
+                {
+                    mResourceStorage->QueueResourceAlias(request.ResourceName, request.OutputAliasName);
+                }
+            }
+
+            if (requests->WritesToBackBuffer)
+            {
+                passNode->AddWriteDependency(RenderPassGraph::Node::BackBufferName, std::nullopt, 1);
+            }
+
+            if (requests->RequestedQueue)
+            {
+                ApplyExecutionQueue(*passNode, *requests->RequestedQueue);
+            }
+
+            passNode->UsesRayTracing = requests->UsesRayTracing;
+        }
+    }
+
+    template <class ContentMediator>
+    void ResourceScheduler<ContentMediator>::MergeRecordedRequests(const std::vector<RecordedPassRequests>& passRequests)
+    {
+        // Merge in the order requests would have been applied if passes were scheduled one after another:
+        // resource creations of all passes first, then usages and readbacks last
+        for (const auto& [passNode, requests] : passRequests)
+        {
+            for (const Request& request : requests->Requests)
+            {
+                if (PipelineResourceSchedulingRequests::IsCreation(request))
+                {
+                    MergeRequest(*passNode, *requests, request);
+                }
+            }
+        }
+
+        for (const auto& [passNode, requests] : passRequests)
+        {
+            for (const Request& request : requests->Requests)
+            {
+                if (!PipelineResourceSchedulingRequests::IsCreation(request) && request.Type != RequestType::Export)
+                {
+                    MergeRequest(*passNode, *requests, request);
+                }
+            }
+        }
+
+        for (const auto& [passNode, requests] : passRequests)
+        {
+            for (const Request& request : requests->Requests)
+            {
+                if (request.Type == RequestType::Export)
+                {
+                    MergeRequest(*passNode, *requests, request);
+                }
+            }
+        }
+    }
+
+    template <class ContentMediator>
+    void ResourceScheduler<ContentMediator>::RecordRequest(
+        RequestType type,
+        Foundation::Name resourceName,
+        Foundation::Name outputAliasName,
+        const MipSet& mips,
+        std::optional<HAL::ColorFormat> concreteFormat,
+        HAL::ResourceState readState,
+        bool canBeReadAcrossFrames)
+    {
+        assert_format(mRequests, "Resources can only be scheduled from ScheduleResources()");
+
+        Request request{};
+        request.ResourceName = resourceName;
+        request.OutputAliasName = outputAliasName;
+        request.SubresourceMips = RecordMips(mips);
+        request.ConcreteFormat = concreteFormat;
+        request.ReadState = readState;
+        request.Type = type;
+        request.CanBeReadAcrossFrames = canBeReadAcrossFrames;
+
+        mRequests->Requests.push_back(request);
+    }
+
+    template <class ContentMediator>
+    typename ResourceScheduler<ContentMediator>::RequestMips ResourceScheduler<ContentMediator>::RecordMips(const MipSet& mips)
+    {
+        using Selection = PipelineResourceSchedulingRequests::MipSelection;
+
+        RequestMips recordedMips{};
+
+        if (!mips.Combination)
+        {
+            return recordedMips;
+        }
+
+        if (const MipList* explicitMipList = std::get_if<0>(&mips.Combination.value()))
+        {
+            recordedMips.Selection = Selection::Explicit;
+            recordedMips.First = mRequests->ExplicitMips.size();
+            recordedMips.Last = explicitMipList->size();
+            mRequests->ExplicitMips.insert(mRequests->ExplicitMips.end(), explicitMipList->begin(), explicitMipList->end());
+        }
+        else if (const MipRange* mipRange = std::get_if<1>(&mips.Combination.value()))
+        {
+            recordedMips.Selection = Selection::Range;
+            recordedMips.First = mipRange->first;
+            recordedMips.Last = mipRange->second.value_or(RequestMips::LastMip);
+        }
+        else if (const uint32_t* indexFromStart = std::get_if<2>(&mips.Combination.value()))
+        {
+            recordedMips.Selection = Selection::IndexFromStart;
+            recordedMips.First = *indexFromStart;
+        }
+        else if (const uint32_t* indexFromEnd = std::get_if<3>(&mips.Combination.value()))
+        {
+            recordedMips.Selection = Selection::IndexFromEnd;
+            recordedMips.First = *indexFromEnd;
+        }
+
+        return recordedMips;
+    }
+
+    template <class ContentMediator>
+    void ResourceScheduler<ContentMediator>::MergeRequest(RenderPassGraph::Node& passNode, const PipelineResourceSchedulingRequests& requests, const Request& request)
+    {
+        using AccessFlag = PipelineResourceSchedulingInfo::SubresourceInfo::AccessFlag;
+
+        Foundation::Name passName = passNode.PassMetadata().Name;
+        Foundation::Name schedulingName = request.OutputAliasName.IsValid() ? request.OutputAliasName : request.ResourceName;
+        PipelineResourceStorageResource* resourceData = mResourceStorage->GetPerResourceData(schedulingName);
+
+        assert_format(resourceData, passName.ToString(), " tries to use a resource that wasn't created: ", schedulingName.ToString());
+
+        PipelineResourceSchedulingInfo& schedulingInfo = resourceData->SchedulingInfo;
+        bool canBeAliased = !request.CanBeReadAcrossFrames && mPipelineSettings->IsMemoryAliasingEnabled;
+
+        if (request.Type == RequestType::NewBuffer)
+        {
+            RegisterGraphDependency(passNode, request.SubresourceMips, requests, request.ResourceName, {}, 1, true);
+            schedulingInfo.SetSubresourceInfo(passName, 0, HAL::ResourceState::UnorderedAccess, AccessFlag::BufferUA, std::nullopt);
+            schedulingInfo.CanBeAliased = canBeAliased;
+            return;
+        }
+
+        if (request.Type == RequestType::Export)
+        {
+            PipelineResourceSchedulingInfo::PassInfo* passInfo = schedulingInfo.GetInfoForPass(passName);
+            assert_format(passInfo, "Resource ", request.ResourceName.ToString(), " wasn't scheduled for usage in ", passName.ToString());
+            passInfo->IsReadbackRequested = true;
+            return;
+        }
+
+        const HAL::TextureProperties& textureProperties = schedulingInfo.ResourceFormat().GetTextureProperties();
+        bool isTypeless = std::holds_alternative<HAL::TypelessColorFormat>(textureProperties.Format);
+        bool isDepthStencil = std::holds_alternative<HAL::DepthStencilFormat>(textureProperties.Format);
+
+        switch (request.Type)
+        {
+        case RequestType::NewRenderTarget:
+            schedulingInfo.CanBeAliased = canBeAliased;
+            RegisterGraphDependency(passNode, request.SubresourceMips, requests, request.ResourceName, {}, textureProperties.MipCount, true);
+            UpdateSubresourceInfos(schedulingInfo, request.SubresourceMips, requests, passName, HAL::ResourceState::RenderTarget, AccessFlag::TextureRT, request.ConcreteFormat);
+            break;
+
+        case RequestType::NewDepthStencil:
+            schedulingInfo.CanBeAliased = canBeAliased;
+            RegisterGraphDependency(passNode, request.SubresourceMips, requests, request.ResourceName, {}, textureProperties.MipCount, true);
+            UpdateSubresourceInfos(schedulingInfo, request.SubresourceMips, requests, passName, HAL::ResourceState::DepthWrite, AccessFlag::TextureDS, std::nullopt);
+            break;
+
+        case RequestType::NewTexture:
+            schedulingInfo.CanBeAliased = canBeAliased;
+            RegisterGraphDependency(passNode, request.SubresourceMips, requests, request.ResourceName, {}, textureProperties.MipCount, true);
+            UpdateSubresourceInfos(schedulingInfo, request.SubresourceMips, requests, passName, HAL::ResourceState::UnorderedAccess, AccessFlag::TextureUA, request.ConcreteFormat);
+            break;
+
+        case RequestType::UseRenderTarget:
+            assert_format(request.ConcreteFormat || !isTypeless, "Redefinition of Render target format is not allowed");
+            assert_format(!request.ConcreteFormat || isTypeless, "Render target is typeless and concrete color format was not provided");
+
+            RegisterGraphDependency(passNode, request.SubresourceMips, requests, request.ResourceName, request.OutputAliasName, textureProperties.MipCount, true);
+            UpdateSubresourceInfos(
+                schedulingInfo, request.SubresourceMips, requests, passName,
+                HAL::ResourceState::RenderTarget, AccessFlag::TextureRT, isTypeless ? request.ConcreteFormat : std::nullopt);
+            break;
+
+        case RequestType::UseDepthStencil:
+            assert_format(isDepthStencil, "Cannot reuse non-depth-stencil texture");
+
+            RegisterGraphDependency(passNode, request.SubresourceMips, requests, request.ResourceName, request.OutputAliasName, textureProperties.MipCount, true);
+            UpdateSubresourceInfos(schedulingInfo, request.SubresourceMips, requests, passName, HAL::ResourceState::DepthWrite, AccessFlag::TextureDS, std::nullopt);
+            break;
+
+        case RequestType::ReadTexture:
+        {
+            assert_format(request.ConcreteFormat || !isTypeless, "Redefinition of texture format is not allowed");
+
+            HAL::ResourceState state = request.ReadState;
+
+            if (isDepthStencil)
+            {
+                state |= HAL::ResourceState::DepthRead;
+            }
+
+            RegisterGraphDependency(passNode, request.SubresourceMips, requests, request.ResourceName, {}, textureProperties.MipCount, false);
+            UpdateSubresourceInfos(schedulingInfo, request.SubresourceMips, requests, passName, state, AccessFlag::TextureSR, std::nullopt);
+            break;
+        }
+
+        case RequestType::WriteTexture:
+            assert_format(request.ConcreteFormat || !isTypeless, "Redefinition of texture format is not allowed");
+            assert_format(!request.ConcreteFormat || isTypeless, "Texture is typeless and concrete color format was not provided");
+
+            RegisterGraphDependency(passNode, request.SubresourceMips, requests, request.ResourceName, request.OutputAliasName, textureProperties.MipCount, true);
+            UpdateSubresourceInfos(
+                schedulingInfo, request.SubresourceMips, requests, passName,
+                HAL::ResourceState::UnorderedAccess, AccessFlag::TextureUA, isTypeless ? request.ConcreteFormat : std::nullopt);
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    template <class ContentMediator>
+    void ResourceScheduler<ContentMediator>::ApplyExecutionQueue(RenderPassGraph::Node& passNode, RenderPassExecutionQueue queue) const
+    {
+        // Passes requesting async compute only record compute work and can run on either queue
+        passNode.IsAsyncComputeEligible = queue == RenderPassExecutionQueue::AsyncCompute;
+
+        if (passNode.IsAsyncComputeEligible && mPipelineSettings->IsAutomaticQueueAssignmentEnabled)
+        {
+            std::optional<RenderPassExecutionQueue> assignedQueue = mQueueAssignmentOptimizer->AssignedQueue(passNode.PassMetadata().Name);
+            queue = assignedQueue.value_or(queue);
+        }
+
+        // Ignore render pass queue preference if async is disabled
+        passNode.ExecutionQueueIndex =
+            mPipelineSettings->IsAsyncComputeEnabled ?
+            std::underlying_type_t<RenderPassExecutionQueue>(queue) :
+            std::underlying_type_t<RenderPassExecutionQueue>(RenderPassExecutionQueue::Graphics);
+    }
+
     template <class ContentMediator>
     NewTextureProperties ResourceScheduler<ContentMediator>::FillMissingFields(std::optional<NewTextureProperties> properties) const
     {
@@ -423,100 +526,91 @@ namespace PathFinder
     }
 
     template <class ContentMediator>
-    void ResourceScheduler<ContentMediator>::RegisterGraphDependency(
-        RenderPassGraph::Node& passNode,
-        const MipSet& mips,
-        Foundation::Name resourceName,
-        Foundation::Name outputAliasName,
+    template <class Function>
+    void ResourceScheduler<ContentMediator>::ForEachMip(
+        const RequestMips& mips,
+        const PipelineResourceSchedulingRequests& requests,
         uint32_t resourceMipCount,
-        bool isWriteDependency)
+        const Function& function) const
     {
-        if (!mips.Combination)
+        using Selection = PipelineResourceSchedulingRequests::MipSelection;
+
+        uint32_t firstMip = 0;
+        uint32_t lastMip = resourceMipCount - 1;
+
+        switch (mips.Selection)
         {
+        case Selection::None:
             // No dependency is a valid case also
             return;
-        }
 
-        // If resource name aliasing is involved we need to provide both new name and old name to the graph
-        Foundation::Name newResourceName = outputAliasName.IsValid() ? outputAliasName : resourceName;
-        std::optional<Foundation::Name> originalResourceName = outputAliasName.IsValid() ? std::optional(resourceName) : std::nullopt;
+        case Selection::Explicit:
+            for (auto i = mips.First; i < mips.First + mips.Last; ++i)
+            {
+                function(requests.ExplicitMips[i]);
+            }
+            return;
 
-        if (const MipList* explicitMipList = std::get_if<0>(&mips.Combination.value()))
-        {
-            isWriteDependency ?
-                passNode.AddWriteDependency(newResourceName, originalResourceName, *explicitMipList) :
-                passNode.AddReadDependency(newResourceName, *explicitMipList);
-        }
-        else if (const MipRange* mipRange = std::get_if<1>(&mips.Combination.value()))
-        {
-            uint32_t lastMip = mipRange->second.value_or(resourceMipCount - 1);
+        case Selection::Range:
+            firstMip = mips.First;
+            lastMip = mips.Last == RequestMips::LastMip ? lastMip : mips.Last;
+            break;
 
-            isWriteDependency ?
-                passNode.AddWriteDependency(newResourceName, originalResourceName, mipRange->first, lastMip) :
-                passNode.AddReadDependency(newResourceName, mipRange->first, lastMip);
+        case Selection::IndexFromStart:
+            firstMip = mips.First;
+            lastMip = mips.First;
+            break;
+
+        case Selection::IndexFromEnd:
+            firstMip = lastMip - mips.First;
+            lastMip = firstMip;
+            break;
         }
-        else if (const uint32_t* indexFromStart = std::get_if<2>(&mips.Combination.value()))
+
+        for (auto mip = firstMip; mip <= lastMip; ++mip)
         {
-            isWriteDependency ?
-                passNode.AddWriteDependency(newResourceName, originalResourceName, *indexFromStart, *indexFromStart) :
-                passNode.AddReadDependency(newResourceName, *indexFromStart, *indexFromStart);
+            function(mip);
         }
-        else if (const uint32_t* indexFromEnd = std::get_if<3>(&mips.Combination.value()))
-        {
-            uint32_t index = resourceMipCount - *indexFromEnd - 1;
+    }
+
+    template <class ContentMediator>
+    void ResourceScheduler<ContentMediator>::RegisterGraphDependency(
+        RenderPassGraph::Node& passNode,
+        const RequestMips& mips,
+        const PipelineResourceSchedulingRequests& requests,
+        Foundation::Name resourceName,
+        Foundation::Name outputAliasName,
+        uint32_t resourceMipCount,
+        bool isWriteDependency)
+    {
+        // If resource name aliasing is involved we need to provide both new name and old name to the graph
+        Foundation::Name newResourceName = outputAliasName.IsValid() ? outputAliasName : resourceName;
+        std::optional<Foundation::Name> originalResourceName = outputAliasName.IsValid() ? std::optional(resourceName) : std::nullopt;
 
+        ForEachMip(mips, requests, resourceMipCount, [&](uint32_t mip)
+        {
             isWriteDependency ?
-                passNode.AddWriteDependency(newResourceName, originalResourceName, index, index) :
-                passNode.AddReadDependency(newResourceName, index, index);
-        }
+                passNode.AddWriteDependency(newResourceName, originalResourceName, mip, mip) :
+                passNode.AddReadDependency(newResourceName, mip, mip);
+        });
     }
 
     template <class ContentMediator>
     void ResourceScheduler<ContentMediator>::UpdateSubresourceInfos(
         PipelineResourceSchedulingInfo& resourceShcedulingInfo,
-        const MipSet& mips,
+        const RequestMips& mips,
+        const PipelineResourceSchedulingRequests& requests,
         Foundation::Name passName,
         HAL::ResourceState state,
         PipelineResourceSchedulingInfo::SubresourceInfo::AccessFlag accessFlag,
         std::optional<HAL::ColorFormat> concreteFormat)
     {
-        if (!mips.Combination)
-        {
-            return;
-        }
-
-        uint32_t firstMip = 0;
-        uint32_t lastMip = resourceShcedulingInfo.ResourceFormat().GetTextureProperties().MipCount - 1;
-
-        if (const MipList* explicitMipList = std::get_if<0>(&mips.Combination.value()))
-        {
-            for (uint32_t mip : *explicitMipList)
-            {
-                resourceShcedulingInfo.SetSubresourceInfo(passName, mip, state, accessFlag, concreteFormat);
-            }
+        uint32_t mipCount = resourceShcedulingInfo.ResourceFormat().GetTextureProperties().MipCount;
 
-            return;
-        }
-        else if (const MipRange* mipRange = std::get_if<1>(&mips.Combination.value()))
-        {
-            firstMip = mipRange->first;
-            lastMip = mipRange->second.value_or(lastMip);
-        }
-        else if (const uint32_t* indexFromStart = std::get_if<2>(&mips.Combination.value()))
-        {
-            firstMip = *indexFromStart;
-            lastMip = *indexFromStart;
-        }
-        else if (const uint32_t* indexFromEnd = std::get_if<3>(&mips.Combination.value()))
-        {
-            firstMip = lastMip - *indexFromEnd;
-            lastMip = lastMip - *indexFromEnd;
-        }
-
-        for (auto mip = firstMip; mip <= lastMip; ++mip)
+        ForEachMip(mips, requests, mipCount, [&](uint32_t mip)
         {
             resourceShcedulingInfo.SetSubresourceInfo(passName, mip, state, accessFlag, concreteFormat);
-        }
+        });
     }
 
     template <class ContentMediator>
@@ -525,26 +619,12 @@ namespace PathFinder
     {
         bool canBeReadAcrossFrames = EnumMaskContains(bufferProperties.Flags, ResourceSchedulingFlags::CrossFrameRead);
 
-        mResourceStorage->QueueResourceAllocationIfNeeded(
-            mCurrentlySchedulingPassNode->PassMetadata().Name,
-            resourceName,
+        mRequests->Creations.push_back(PipelineResourceSchedulingRequests::Creation{
             HAL::BufferProperties::Create<T>(bufferProperties.Capacity, bufferProperties.PerElementAlignment),
-            bufferProperties.BufferToCopyPropertiesFrom,
-
-            [this, resourceName, canBeReadAcrossFrames, node = mCurrentlySchedulingPassNode](PipelineResourceSchedulingInfo& schedulingInfo)
-            {
-                RegisterGraphDependency(*node, MipSet::FirstMip(), resourceName, {}, 1, true);
-
-                schedulingInfo.SetSubresourceInfo(
-                    node->PassMetadata().Name,
-                    0, 
-                    HAL::ResourceState::UnorderedAccess,
-                    PipelineResourceSchedulingInfo::SubresourceInfo::AccessFlag::BufferUA,
-                    std::nullopt);
+            resourceName,
+            bufferProperties.BufferToCopyPropertiesFrom });
 
-                schedulingInfo.CanBeAliased = !canBeReadAcrossFrames && mPipelineSettings->IsMemoryAliasingEnabled;
-            }
-        );
+        RecordRequest(RequestType::NewBuffer, resourceName, {}, MipSet::FirstMip(), std::nullopt, HAL::ResourceState::Common, canBeReadAcrossFrames);
     }
 
     template <class ContentMediator>
@@ -35,6 +35,11 @@ namespace PathFinder
         scheduler->WriteToBackBuffer();
     } 
 
+    bool BackBufferOutputPass::IsSchedulingFrameInvariant() const
+    {
+        return true;
+    }
+
     void BackBufferOutputPass::Render(RenderContext<RenderPassContentMediator>* context)
     {
         Foundation::Name psoName = context->GetContent()->DisplayController()->IsHDREnabled() ? 
@@ -1,7 +1,7 @@
 #include "BloomBlurRenderPass.hpp"
 #include "BlurCBContent.hpp"
 
-#include <Foundation/Gaussian.hpp>
+#include <Foundation/SamplingService.hpp>
 
 namespace PathFinder
 {
@@ -32,6 +32,11 @@ namespace PathFinder
         scheduler->NewTexture(ResourceNames::BloomBlurIntermediate, NewTextureProperties{ ResourceNames::CombinedShadingOversaturated });
         scheduler->NewTexture(ResourceNames::BloomBlurOutput, NewTextureProperties{ ResourceNames::CombinedShadingOversaturated });
     }
+
+    bool BloomBlurRenderPass::IsSchedulingFrameInvariant() const
+    {
+        return true;
+    }
      
     void BloomBlurRenderPass::Render(RenderContext<RenderPassContentMediator>* context)
     {
@@ -54,8 +59,8 @@ namespace PathFinder
         SeparableBlurCBContent blurInputs{};
 
         // Blur horizontal
-        auto kernel = Foundation::Gaussian::Kernel1D(radius, sigma);
-        std::move(kernel.begin(), kernel.end(), blurInputs.Weights.begin());
+        const Foundation::Gaussian::Kernel& kernel = Foundation::SamplingService::SharedInstance().GaussianKernel(radius, sigma);
+        std::copy(kernel.begin(), kernel.end(), blurInputs.Weights.begin());
 
         blurInputs.IsHorizontal = true;
         blurInputs.BlurRadius = radius;
@@ -20,6 +20,7 @@ namespace PathFinder
         ~BloomBlurRenderPass() = default;
 
         virtual void ScheduleResources(ResourceScheduler<RenderPassContentMediator>* scheduler) override;
+        virtual bool IsSchedulingFrameInvariant() const override;
         virtual void ScheduleSubPasses(SubPassScheduler<RenderPassContentMediator>* scheduler) override;
         virtual void Render(RenderContext<RenderPassContentMediator>* context) override;
 
@@ -21,6 +21,11 @@ namespace PathFinder
         scheduler->ReadTexture(ResourceNames::BloomBlurOutput);
         scheduler->NewTexture(ResourceNames::BloomCompositionOutput);
     }
+
+    bool BloomCompositionRenderPass::IsSchedulingFrameInvariant() const
+    {
+        return true;
+    }
      
     void BloomCompositionRenderPass::Render(RenderContext<RenderPassContentMediator>* context)
     {
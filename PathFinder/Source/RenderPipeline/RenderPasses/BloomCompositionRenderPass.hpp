@@ -29,6 +29,7 @@ namespace PathFinder
 
         virtual void SetupPipelineStates(PipelineStateCreator* stateCreator) override;
         virtual void ScheduleResources(ResourceScheduler<RenderPassContentMediator>* scheduler) override;
+        virtual bool IsSchedulingFrameInvariant() const override;
         virtual void Render(RenderContext<RenderPassContentMediator>* context) override;
     };
 
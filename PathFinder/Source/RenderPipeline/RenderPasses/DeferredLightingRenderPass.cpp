@@ -1,7 +1,7 @@
 #include "DeferredLightingRenderPass.hpp"
 #include "ResourceNameResolving.hpp"
 
-#include <Foundation/Halton.hpp>
+#include <Foundation/SamplingService.hpp>
 
 namespace PathFinder
 {
@@ -81,11 +81,11 @@ namespace PathFinder
         cbContent.SkyTexIdx = resourceProvider->GetSRTextureIndex(ResourceNames::SkyLuminance);
         cbContent.FrameNumber = context->GetFrameNumber();
 
-        auto haltonSequence = Foundation::Halton::Sequence(0, 3);
+        const Foundation::SamplingService& sampling = Foundation::SamplingService::SharedInstance();
 
         for (auto i = 0; i < 4; ++i)
         {
-            cbContent.Halton[i] = haltonSequence[i];
+            cbContent.Halton[i] = sampling.Halton(i, 0);
         }
 
         context->GetConstantsUpdater()->UpdateRootConstantBuffer(cbContent);
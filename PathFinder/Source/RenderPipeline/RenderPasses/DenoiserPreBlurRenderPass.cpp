@@ -1,7 +1,7 @@
 #include "DenoiserPreBlurRenderPass.hpp"
 #include "BlurCBContent.hpp"
 
-#include <Foundation/Gaussian.hpp>
+#include <Foundation/SamplingService.hpp>
 
 namespace PathFinder
 {
@@ -55,8 +55,8 @@ namespace PathFinder
         cbContent.BlurRadius = context->GetContent()->GetSettings()->IsDenoiserEnabled ? 2 : 0;
         cbContent.IsHorizontal = true;
         cbContent.Weights.fill(1.0f / cbContent.BlurRadius);
-        auto kernel = Foundation::Gaussian::Kernel1D(cbContent.BlurRadius);
-        std::move(kernel.begin(), kernel.end(), cbContent.Weights.begin());
+        const Foundation::Gaussian::Kernel& kernel = Foundation::SamplingService::SharedInstance().GaussianKernel(cbContent.BlurRadius);
+        std::copy(kernel.begin(), kernel.end(), cbContent.Weights.begin());
         cbContent.ImageSize = { dispatchDimensions.Width, dispatchDimensions.Height };
 
         cbContent.InputTexIdx = resourceProvider->GetSRTextureIndex(inputName);
@@ -124,7 +124,7 @@ namespace PathFinder
 
         auto& instances = context->GetContent()->GetScene()->GetMeshInstances();
 
-        if (instances.empty()) 
+        if (instances.Empty()) 
             return;
 
         // Use vertex and index buffers as normal structured buffers
@@ -134,10 +134,10 @@ namespace PathFinder
         context->GetCommandRecorder()->BindExternalBuffer(*meshStorage->MeshInstanceTable(), 2, 0, HAL::ShaderRegister::ShaderResource);
         context->GetCommandRecorder()->BindExternalBuffer(*meshStorage->MaterialTable(), 3, 0, HAL::ShaderRegister::ShaderResource);
 
-        for (const MeshInstance& instance : instances)
+        for (uint32_t index = 0; index < instances.Size(); ++index)
         {
-            context->GetCommandRecorder()->SetRootConstants(instance.GetIndexInGPUTable(), 0, 0);
-            context->GetCommandRecorder()->Draw(instance.GetAssociatedMesh()->GetLocationInVertexStorage().IndexCount);
+            context->GetCommandRecorder()->SetRootConstants(instances.GPUTableIndices()[index], 0, 0);
+            context->GetCommandRecorder()->Draw(instances.Meshes()[index]->GetLocationInVertexStorage().IndexCount);
         }
     }
 
@@ -8,11 +8,20 @@ namespace PathFinder
     GIProbeUpdateRenderPass::GIProbeUpdateRenderPass()
         : RenderPass("GIProbeUpdate") {} 
 
+    void GIProbeUpdateRenderPass::SetupRootSignatures(RootSignatureCreator* rootSignatureCreator)
+    {
+        rootSignatureCreator->CreateRootSignature(RootSignatureNames::GIProbeUpdate, [](RootSignatureProxy& signatureProxy)
+        {
+            signatureProxy.AddShaderResourceBufferParameter(0, 0); // Probe State Table | t0 - s0
+        });
+    }
+
     void GIProbeUpdateRenderPass::SetupPipelineStates(PipelineStateCreator* stateCreator)
     {
         stateCreator->CreateComputeState(PSONames::GIProbeUpdate, [](ComputeStateProxy& state)
         {
             state.ComputeShaderFileName = "GIProbeUpdate.hlsl";
+            state.RootSignatureName = RootSignatureNames::GIProbeUpdate;
         });
 
         stateCreator->CreateComputeState(PSONames::GIIlluminanceProbeCornerUpdate, [](ComputeStateProxy& state)
@@ -96,6 +105,9 @@ namespace PathFinder
        
         context->GetConstantsUpdater()->UpdateRootConstantBuffer(cbContent);
 
+        const Memory::Buffer* probeStates = sceneStorage->GIProbeStateTable();
+        if (probeStates) context->GetCommandRecorder()->BindExternalBuffer(*probeStates, 0, 0, HAL::ShaderRegister::ShaderResource);
+
         // Build atlas
         auto depthProbeTexelCount = cbContent.ProbeField.DepthProbeSize * cbContent.ProbeField.DepthProbeSize;
         context->GetCommandRecorder()->Dispatch({ cbContent.ProbeField.TotalProbeCount * depthProbeTexelCount, 1 }, { depthProbeTexelCount, 1 });
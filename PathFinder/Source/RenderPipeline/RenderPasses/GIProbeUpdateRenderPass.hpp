@@ -19,6 +19,7 @@ namespace PathFinder
         GIProbeUpdateRenderPass();
         ~GIProbeUpdateRenderPass() = default;
 
+        virtual void SetupRootSignatures(RootSignatureCreator* rootSignatureCreator) override;
         virtual void SetupPipelineStates(PipelineStateCreator* stateCreator) override;
         virtual void ScheduleResources(ResourceScheduler<RenderPassContentMediator>* scheduler) override; 
         virtual void Render(RenderContext<RenderPassContentMediator>* context) override;
@@ -1,6 +1,6 @@
 #include "GIRayTracingRenderPass.hpp"
 
-#include <Foundation/Halton.hpp>
+#include <Foundation/SamplingService.hpp>
 
 namespace PathFinder
 {
@@ -8,6 +8,21 @@ namespace PathFinder
     GIRayTracingRenderPass::GIRayTracingRenderPass()
         : RenderPass("GIRayTracing") {} 
 
+    void GIRayTracingRenderPass::SetupRootSignatures(RootSignatureCreator* rootSignatureCreator)
+    {
+        rootSignatureCreator->CreateRootSignature(RootSignatureNames::GIRayTracing, [](RootSignatureProxy& signatureProxy)
+        {
+            signatureProxy.AddRootConstantsParameter<uint32_t>(0, 0);
+            signatureProxy.AddShaderResourceBufferParameter(0, 0); // Scene BVH | t0 - s0
+            signatureProxy.AddShaderResourceBufferParameter(1, 0); // Light Table | t1 - s0
+            signatureProxy.AddShaderResourceBufferParameter(2, 0); // Material Table | t2 - s0
+            signatureProxy.AddShaderResourceBufferParameter(3, 0); // Vertex Buffer | t3 - s0
+            signatureProxy.AddShaderResourceBufferParameter(4, 0); // Index Buffer | t4 - s0
+            signatureProxy.AddShaderResourceBufferParameter(5, 0); // Mesh Instance Table | t5 - s0
+            signatureProxy.AddShaderResourceBufferParameter(6, 0); // Scheduled Probe Table | t6 - s0
+        });
+    }
+
     void GIRayTracingRenderPass::SetupPipelineStates(PipelineStateCreator* stateCreator)
     {
         stateCreator->CreateRayTracingState(PSONames::GIRayTracing, [this](RayTracingStateProxy& state)
@@ -28,7 +43,7 @@ namespace PathFinder
             state.AddMissShader({ "GIProbeRayTracing.hlsl", "ProbeRayMiss" });
             state.AddMissShader({ "GIProbeRayTracing.hlsl", "SecondaryShadowRayMiss" });
             state.ShaderConfig = HAL::RayTracingShaderConfig{ sizeof(float), sizeof(float) * 2 };
-            state.GlobalRootSignatureName = RootSignatureNames::ShadingCommon; // Reuse root sig from shading pass
+            state.GlobalRootSignatureName = RootSignatureNames::GIRayTracing;
             state.PipelineConfig = HAL::RayTracingPipelineConfig{ 2 };
         });
     }
@@ -74,13 +89,12 @@ namespace PathFinder
         cbContent.BlueNoiseTexSize = { blueNoiseTexture->Properties().Dimensions.Width, blueNoiseTexture->Properties().Dimensions.Height };
         cbContent.SkyTexIdx = context->GetResourceProvider()->GetSRTextureIndex(ResourceNames::SkyLuminance);
 
+        const Foundation::SamplingService& sampling = Foundation::SamplingService::SharedInstance();
         auto start = context->GetFrameNumber() * 3;
-        auto end = start + 3;
-        auto haltonSequence = Foundation::Halton::Sequence(start, end);
 
         for (auto i = 0; i < 4; ++i)
         {
-            cbContent.Halton[i] = haltonSequence[i];
+            cbContent.Halton[i] = sampling.Halton(start + i, 0);
         }
 
         context->GetConstantsUpdater()->UpdateRootConstantBuffer(cbContent);
@@ -92,6 +106,7 @@ namespace PathFinder
         const Memory::Buffer* vertices = sceneStorage->UnifiedVertexBuffer();
         const Memory::Buffer* indices = sceneStorage->UnifiedIndexBuffer();
         const Memory::Buffer* meshInstances = sceneStorage->MeshInstanceTable();
+        const Memory::Buffer* scheduledProbes = sceneStorage->GIScheduledProbeTable();
 
         if (bvh) context->GetCommandRecorder()->BindExternalBuffer(*bvh, 0, 0, HAL::ShaderRegister::ShaderResource);
         if (lights) context->GetCommandRecorder()->BindExternalBuffer(*lights, 1, 0, HAL::ShaderRegister::ShaderResource);
@@ -99,8 +114,13 @@ namespace PathFinder
         if (vertices) context->GetCommandRecorder()->BindExternalBuffer(*vertices, 3, 0, HAL::ShaderRegister::ShaderResource);
         if (indices) context->GetCommandRecorder()->BindExternalBuffer(*indices, 4, 0, HAL::ShaderRegister::ShaderResource);
         if (meshInstances) context->GetCommandRecorder()->BindExternalBuffer(*meshInstances, 5, 0, HAL::ShaderRegister::ShaderResource);
+        if (scheduledProbes) context->GetCommandRecorder()->BindExternalBuffer(*scheduledProbes, 6, 0, HAL::ShaderRegister::ShaderResource);
+
+        // Rays are only traced for probes scheduled this frame, the rest keep their history
+        uint64_t rayCount = sceneStorage->GIScheduledProbeCount() * cbContent.ProbeField.RaysPerProbe;
 
-        context->GetCommandRecorder()->DispatchRays(context->GetContent()->GetSettings()->GlobalIlluminationSettings.GetTotalRayCount());
+        if (scheduledProbes && rayCount > 0)
+            context->GetCommandRecorder()->DispatchRays(rayCount);
     }
 
 }
@@ -23,6 +23,7 @@ namespace PathFinder
         GIRayTracingRenderPass();
         ~GIRayTracingRenderPass() = default;
 
+        virtual void SetupRootSignatures(RootSignatureCreator* rootSignatureCreator) override;
         virtual void SetupPipelineStates(PipelineStateCreator* stateCreator) override;
         virtual void ScheduleResources(ResourceScheduler<RenderPassContentMediator>* scheduler) override; 
         virtual void Render(RenderContext<RenderPassContentMediator>* context) override;
@@ -1,31 +0,0 @@
-#pragma once
-
-#include "../RenderPass.hpp"
-#include "../RenderPassContentMediator.hpp"
-
-#include "GBufferTextureIndices.hpp"
-#include "PipelineNames.hpp"
-
-#include <glm/mat4x4.hpp>
-
-namespace PathFinder
-{
-
-    struct GeometryPickingCBContent
-    {
-        glm::uvec2 MousePosition;
-    };
-
-    class GeometryPickingRenderPass : public RenderPass<RenderPassContentMediator>
-    {
-    public:
-        GeometryPickingRenderPass();
-        ~GeometryPickingRenderPass() = default;
-
-        virtual void SetupRootSignatures(RootSignatureCreator* rootSignatureCreator) override;
-        virtual void SetupPipelineStates(PipelineStateCreator* stateCreator) override;
-        virtual void ScheduleResources(ResourceScheduler<RenderPassContentMediator>* scheduler) override; 
-        virtual void Render(RenderContext<RenderPassContentMediator>* context) override;
-    };
-
-}
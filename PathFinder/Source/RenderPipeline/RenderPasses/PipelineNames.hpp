@@ -85,8 +85,6 @@ namespace PathFinder
         inline Foundation::Name SMAADetectedEdges{ "Resource_SMAA_Detected_Edges" };
         inline Foundation::Name SMAABlendingWeights{ "Resource_SMAA_Blending_Weights" };
         inline Foundation::Name SMAAAntialiased{ "Resource_SMAA_Antialiased_Image" };
-
-        inline Foundation::Name PickedGeometryInfo{ "Resource_Picked_Geometry_Info" };
     }
 
     namespace PSONames
@@ -110,7 +108,6 @@ namespace PathFinder
         inline Foundation::Name GIDepthProbeBorderUpdate{ "PSO_GI_Depth_Probe_Border_Update" };
         inline Foundation::Name GIProbeDebug{ "PSO_GI_Probe_Debug" };
         inline Foundation::Name GIRaysDebug{ "PSO_GI_Rays_Debug" };
-        inline Foundation::Name GeometryPicking{ "PSO_GeometryPicking" };
         inline Foundation::Name SeparableBlur{ "PSO_SeparableBlur" };
         inline Foundation::Name BloomBlur{ "PSO_BloomBlur" };
         inline Foundation::Name BloomComposition{ "PSO_BloomComposition" };
@@ -141,8 +138,8 @@ namespace PathFinder
         inline Foundation::Name GBufferLights{ "GBuffer_Lights_Root_Sig" };
         inline Foundation::Name ShadingCommon{ "Shading_Common_Root_Sig" };
         inline Foundation::Name GIRayTracing{ "GI_Ray_Tracing_Root_Sig" };
+        inline Foundation::Name GIProbeUpdate{ "GI_Probe_Update_Root_Sig" };
         inline Foundation::Name ToneMapping{ "Tone_Mapping_Root_Sig" };
-        inline Foundation::Name GeometryPicking{ "Geometry_Picking_Root_Sig" };
         inline Foundation::Name UI{ "UI_Root_Sig" };
         inline Foundation::Name DisplacementDistanceMapGeneration{ "Distance_Map_Generation_Root_Sig" };
     }
@@ -24,6 +24,11 @@ namespace PathFinder
         scheduler->NewRenderTarget(ResourceNames::SMAABlendingWeights, NewTextureProperties{ HAL::ColorFormat::RGBA16_Float });
     }
 
+    bool SMAABlendingWeightCalculationRenderPass::IsSchedulingFrameInvariant() const
+    {
+        return true;
+    }
+
     void SMAABlendingWeightCalculationRenderPass::Render(RenderContext<RenderPassContentMediator>* context)
     {
         context->GetCommandRecorder()->ApplyPipelineState(PSONames::SMAABlendingWeightCalculation);
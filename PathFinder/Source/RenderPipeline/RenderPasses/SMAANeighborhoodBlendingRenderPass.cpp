@@ -25,6 +25,11 @@ namespace PathFinder
         scheduler->NewRenderTarget(ResourceNames::SMAAAntialiased);
     }
 
+    bool SMAANeighborhoodBlendingRenderPass::IsSchedulingFrameInvariant() const
+    {
+        return true;
+    }
+
     void SMAANeighborhoodBlendingRenderPass::Render(RenderContext<RenderPassContentMediator>* context)
     {
         context->GetCommandRecorder()->ApplyPipelineState(PSONames::SMAANeighborhoodBlending);
@@ -23,6 +23,11 @@ namespace PathFinder
         scheduler->NewTexture(ResourceNames::SkyLuminance, skyProperties);
         scheduler->ExecuteOnQueue(RenderPassExecutionQueue::AsyncCompute);
     }
+
+    bool SkyGenerationRenderPass::IsSchedulingFrameInvariant() const
+    {
+        return true;
+    }
      
     void SkyGenerationRenderPass::Render(RenderContext<RenderPassContentMediator>* context)
     {
@@ -38,6 +38,11 @@ namespace PathFinder
         scheduler->AliasAndUseRenderTarget(ResourceNames::ToneMappingOutput, ResourceNames::UIOutput);
     }  
 
+    bool UIRenderPass::IsSchedulingFrameInvariant() const
+    {
+        return true;
+    }
+
     void UIRenderPass::Render(RenderContext<RenderPassContentMediator>* context)
     {
         context->GetCommandRecorder()->ApplyPipelineState(PSONames::UI);
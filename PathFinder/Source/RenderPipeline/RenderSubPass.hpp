@@ -20,6 +20,8 @@ namespace PathFinder
         virtual ~RenderSubPass() = 0;
 
         virtual void ScheduleResources(ResourceScheduler<ContentMediator>* scheduler) {};
+        // See RenderPass::IsSchedulingFrameInvariant()
+        virtual bool IsSchedulingFrameInvariant() const { return false; }
         virtual void Render(RenderContext<ContentMediator>* context) {};
 
     private:
@@ -86,8 +86,13 @@ float3 FetchNormalMap(VertexOut vertex, Material material, SamplerState sampler)
 {
     Texture2D normalMap = Textures2D[material.NormalMapIndex];
     
-    float3 normal = normalMap.Sample(sampler, vertex.UV).xyz;
-    normal = normal * 2.0 - 1.0;
+    float3 normal = normalMap.Sample(sampler, vertex.UV).xyz * 2.0 - 1.0;
+
+    // BC5 normal maps only store X and Y
+    if (material.HasTwoChannelNormalMap)
+    {
+        normal.z = sqrt(saturate(1.0 - dot(normal.xy, normal.xy)));
+    }
 
     return normalize(mul(vertex.TBN, normal));
 }
@@ -32,7 +32,7 @@ ProbeVertexOut ProbeVSMain(uint vertexId : SV_VertexID)
     uint probeIndex = PassDataCB.ExplicitProbeIndex >= 0 ? PassDataCB.ExplicitProbeIndex : vertexId / 6;
 
     float probeRadius = PassDataCB.ProbeField.DebugProbeRadius;
-    float3 probePosition = ProbePositionFrom3DIndex(Probe3DIndexFrom1D(probeIndex, PassDataCB.ProbeField), PassDataCB.ProbeField);
+    float3 probePosition = ProbePositionFromIndex(probeIndex, PassDataCB.ProbeField);
     float3 billboardToCamera = normalize(FrameDataCB.CurrentFrameCamera.Position.xyz - probePosition);
     float4x4 billboardRotation = RotationMatrix4x4(billboardToCamera, GetUpVectorForOrientaion(billboardToCamera));
 
@@ -65,10 +65,12 @@ ProbeVertexOut ProbeVSMain(uint vertexId : SV_VertexID)
     output.NonTransformedPosition = normVertex;
     output.ProbeIndex = probeIndex;
 
-    uint3 index3D = Probe3DIndexFrom1D(probeIndex, PassDataCB.ProbeField);
+    uint cascadeIndex = ProbeCascadeIndex(probeIndex, PassDataCB.ProbeField);
+    int3 probeCell = ProbeCellFromIndex(probeIndex, PassDataCB.ProbeField.Cascades[cascadeIndex]);
 
     SetDataInspectorWriteCondition(PassDataCB.ExplicitProbeIndex >= 0);
-    OutputDataInspectorValue(index3D);
+    OutputDataInspectorValue(probeCell);
+    OutputDataInspectorValue(cascadeIndex);
     OutputDataInspectorValue(probeIndex);
 
     return output;
@@ -125,7 +127,7 @@ RayVertexOut RaysVSMain(uint vertexId : SV_VertexID)
     uint vertexIndex = vertexId % 36;
     uint probeIndex = PassDataCB.ExplicitProbeIndex;
     float probeRadius = PassDataCB.ProbeField.DebugProbeRadius;
-    float3 probePosition = ProbePositionFrom3DIndex(Probe3DIndexFrom1D(probeIndex, PassDataCB.ProbeField), PassDataCB.ProbeField);
+    float3 probePosition = ProbePositionFromIndex(probeIndex, PassDataCB.ProbeField);
     float3 rayDirection = ProbeSamplingVector(rayIndex, PassDataCB.ProbeField);
     float4x4 vertexRotation = RotationMatrix4x4(rayDirection, GetUpVectorForOrientaion(rayDirection));
 
@@ -9,18 +9,34 @@
 static const float ProbeIlluminanceGamma = 5.0;
 static const float ProbeRayBackfaceIndicator = -1.0;
 
-struct IlluminanceField
+// Must match IlluminanceField::MaxCascadeCount
+static const uint MaxIlluminanceFieldCascadeCount = 4;
+
+// Cascade probes are stored toroidally: probe slot is its world cell wrapped by the grid size,
+// so probes keep their slots, and atlas texels, while the cascade scrolls
+struct IlluminanceFieldCascade
 {
-    uint3 GridSize;
+    int3 CornerCell;
     float CellSize;
     // 16 byte boundary
-    float3 GridCornerPosition;
-    uint RaysPerProbe;
+    int3 PreviousCornerCell;
+    uint ProbeOffset;
     // 16 byte boundary
+    uint3 GridSize;
+    uint ProbeCount;
+};
+
+struct IlluminanceField
+{
+    uint CascadeCount;
+    uint RaysPerProbe;
     uint TotalProbeCount;
-    uint2 RayHitInfoTextureSize;
     uint RayHitInfoTextureIdx;
     // 16 byte boundary
+    uint2 RayHitInfoTextureSize;
+    float DebugProbeRadius;
+    uint Pad0__;
+    // 16 byte boundary
     float4x4 ProbeRotation;
     // 16 byte boundary
     uint2 IlluminanceProbeAtlasSize;
@@ -34,50 +50,78 @@ struct IlluminanceField
     uint CurrentIlluminanceProbeAtlasTexIdx;
     uint CurrentDepthProbeAtlasTexIdx;
     // 16 byte boundary
-    // How many probe planes were spawned this frame on each axis.
-    // Can be negative if probes are spawned along negative axis direction.
-    int3 SpawnedProbePlanesCount; 
-    float DebugProbeRadius;
-    // 16 byte boundary
     uint PreviousIlluminanceProbeAtlasTexIdx;
     uint PreviousDepthProbeAtlasTexIdx;
     float IlluminanceHysteresisDecrease;
     float DepthHysteresisDecrease;
+    // 16 byte boundary
+    IlluminanceFieldCascade Cascades[MaxIlluminanceFieldCascadeCount];
+};
+
+struct IlluminanceProbeState
+{
+    float IlluminanceHysteresisDecrease;
+    float DepthHysteresisDecrease;
+    float UpdatePriority;
+    uint IsScheduled;
 };
 
-uint3 Probe3DIndexFrom1D(uint index, IlluminanceField field)
+int3 WrapProbeCell(int3 cell, uint3 gridSize)
+{
+    int3 size = gridSize;
+    return ((cell % size) + size) % size;
+}
+
+uint ProbeCascadeIndex(uint probeIndex, IlluminanceField field)
+{
+    uint cascadeIndex = 0;
+
+    for (uint i = 1; i < field.CascadeCount; ++i)
+    {
+        if (probeIndex >= field.Cascades[i].ProbeOffset)
+            cascadeIndex = i;
+    }
+
+    return cascadeIndex;
+}
+
+int3 ProbeCellFromIndex(uint probeIndex, IlluminanceFieldCascade cascade)
+{
+    uint localIndex = probeIndex - cascade.ProbeOffset;
+
+    int3 slot;
+    slot.x = localIndex % cascade.GridSize.x;
+    slot.y = (localIndex % (cascade.GridSize.x * cascade.GridSize.y)) / cascade.GridSize.x;
+    slot.z = localIndex / (cascade.GridSize.x * cascade.GridSize.y);
+
+    // Slot of the corner cell is where the cascade starts in the wrapped storage
+    return cascade.CornerCell + WrapProbeCell(slot - WrapProbeCell(cascade.CornerCell, cascade.GridSize), cascade.GridSize);
+}
+
+uint ProbeIndexFromCell(int3 cell, IlluminanceFieldCascade cascade)
 {
-    uint3 index3d;
-
-    /* Works for any # of probes */
-    index3d.x = index % field.GridSize.x;
-    index3d.y = (index % (field.GridSize.x * field.GridSize.y)) / field.GridSize.x;
-    index3d.z = index / (field.GridSize.x * field.GridSize.y);
-
-    // Assumes probe counts are powers of two.
-    // Saves time compared to the divisions above
-    // Precomputing the MSB actually slows this code down substantially
-   /* 
-    index3d.x = index & (field.GridSize.x - 1);
-    index3d.y = (index & ((field.GridSize.x * field.GridSize.y) - 1)) >> FindMSB(field.GridSize.x);
-    index3d.z = index >> FindMSB(field.GridSize.x * field.GridSize.y);*/
-
-    return index3d;
+    uint3 slot = WrapProbeCell(cell, cascade.GridSize);
+    return cascade.ProbeOffset + slot.x + slot.y * cascade.GridSize.x + slot.z * cascade.GridSize.x * cascade.GridSize.y;
 }
 
-uint Probe1DIndexFrom3D(uint3 index, IlluminanceField field)
+float3 ProbePositionFromCell(int3 cell, IlluminanceFieldCascade cascade)
 {
-    return index.x + index.y * field.GridSize.x + index.z * field.GridSize.x * field.GridSize.y;
+    return float3(cell) * cascade.CellSize;
 }
 
-uint Probe1DIndexFromRayIndex(uint rayIndex, IlluminanceField field)
+float3 ProbePositionFromIndex(uint probeIndex, IlluminanceField field)
 {
-    return rayIndex / field.RaysPerProbe;
+    IlluminanceFieldCascade cascade = field.Cascades[ProbeCascadeIndex(probeIndex, field)];
+    return ProbePositionFromCell(ProbeCellFromIndex(probeIndex, cascade), cascade);
 }
 
-float3 ProbePositionFrom3DIndex(uint3 index, IlluminanceField field)
+// Probe's slot held a probe of another cell last frame, so there is no history to blend with
+bool IsProbeNewlySpawned(uint probeIndex, IlluminanceField field)
 {
-    return field.CellSize * index + field.GridCornerPosition;
+    IlluminanceFieldCascade cascade = field.Cascades[ProbeCascadeIndex(probeIndex, field)];
+    int3 cell = ProbeCellFromIndex(probeIndex, cascade);
+
+    return any(cell < cascade.PreviousCornerCell) || any(cell >= cascade.PreviousCornerCell + int3(cascade.GridSize));
 }
 
 uint2 RayHitTexelIndex(uint rayIndex, uint probeIndex, IlluminanceField field)
@@ -91,15 +135,6 @@ float3 ProbeSamplingVector(uint rayIndex, IlluminanceField field)
     return mul(field.ProbeRotation, float4(v, 0.0)).xyz;
 }
 
-float3 ProbePositionFromRayIndex(uint rayIndex, IlluminanceField field)
-{
-    uint probeIndex = Probe1DIndexFromRayIndex(rayIndex, field);
-    uint3 probe3DIndex = Probe3DIndexFrom1D(probeIndex, field);
-    float3 probePosition = ProbePositionFrom3DIndex(probe3DIndex, field);
-
-    return probePosition;
-}
-
 uint2 ProbeAtlasTexelIndex(uint probeIndex, uint2 probeLocalTexelIndex, uint probeSize, uint2 probesPerDimension)
 {
     uint probeSizeWithBorders = probeSize + 2;
@@ -169,7 +204,7 @@ float3 DecodeProbeIlluminance(float3 encoded)
     return pow(encoded, ProbeIlluminanceGamma);
 }
 
-float3 RetrieveGIIlluminance(
+float3 RetrieveGIIlluminanceFromCascade(
     float3 surfacePosition,
     float3 surfaceNormal, 
     float3 viewDirection,
@@ -177,19 +212,20 @@ float3 RetrieveGIIlluminance(
     Texture2D depthProbeAtlas,
     SamplerState sampler,
     IlluminanceField field,
+    IlluminanceFieldCascade cascade,
     bool samplingLastFrame)
 {
-    const float D = field.CellSize;
+    const float D = cascade.CellSize;
     const float B = 0.3;
     float3 selfShadowBias = (surfaceNormal * 0.2 + viewDirection * 0.8) * (0.75 * D) * B;
 
     float3 trueSurfacePosition = surfacePosition;
     surfacePosition += selfShadowBias;
 
-    float3 firstProbe3DIndex = (surfacePosition - field.GridCornerPosition) / field.CellSize;
+    float3 firstProbeCell = surfacePosition / cascade.CellSize;
     // alpha is how far from the floor(currentVertex) position. on [0, 1] for each axis.
-    float3 alpha = frac(firstProbe3DIndex);
-    firstProbe3DIndex = floor(firstProbe3DIndex);
+    float3 alpha = frac(firstProbeCell);
+    firstProbeCell = floor(firstProbeCell);
 
     //        5-------6
     //       /|      /|
@@ -208,14 +244,14 @@ float3 RetrieveGIIlluminance(
     float3 irradiance = 0.0;
     float totalWeight = 0.0;
 
-    // If we're sampling last frame data, we need to adjust 3D indices
-    int3 index3DLastFrameCorrection = samplingLastFrame ? field.SpawnedProbePlanesCount : 0;
+    // Probes keep their slots when cascade scrolls, last frame data only needs last frame bounds
+    int3 cornerCell = samplingLastFrame ? cascade.PreviousCornerCell : cascade.CornerCell;
 
     for (uint i = 0; i < 8; ++i)
     {
-        uint3 probe3DIndex = clamp(firstProbe3DIndex + IndexOffsets[i] + index3DLastFrameCorrection, 0, field.GridSize - 1);
-        uint probeIndex = Probe1DIndexFrom3D(probe3DIndex, field);
-        float3 probePosition = ProbePositionFrom3DIndex(probe3DIndex, field);
+        int3 probeCell = clamp(int3(firstProbeCell) + int3(IndexOffsets[i]), cornerCell, cornerCell + int3(cascade.GridSize) - 1);
+        uint probeIndex = ProbeIndexFromCell(probeCell, cascade);
+        float3 probePosition = ProbePositionFromCell(probeCell, cascade);
         float3 surfaceToProbe = probePosition - surfacePosition;
         float distToProbe = length(surfaceToProbe);
         surfaceToProbe /= distToProbe;
@@ -307,4 +343,50 @@ float3 RetrieveGIIlluminance(
     return irradiance;
 }
 
+float3 RetrieveGIIlluminance(
+    float3 surfacePosition,
+    float3 surfaceNormal, 
+    float3 viewDirection,
+    Texture2D irradianceProbeAtlas,
+    Texture2D depthProbeAtlas,
+    SamplerState sampler,
+    IlluminanceField field,
+    bool samplingLastFrame)
+{
+    // Distance to cascade border, in cells, over which finer cascade fades into the coarser one
+    const float CascadeBlendCellCount = 2.0;
+
+    // Finest cascade whose probes surround the surface is used
+    for (uint cascadeIndex = 0; cascadeIndex < field.CascadeCount; ++cascadeIndex)
+    {
+        IlluminanceFieldCascade cascade = field.Cascades[cascadeIndex];
+        bool isLastCascade = cascadeIndex + 1 == field.CascadeCount;
+
+        int3 cornerCell = samplingLastFrame ? cascade.PreviousCornerCell : cascade.CornerCell;
+        float3 cascadePosition = surfacePosition / cascade.CellSize - cornerCell;
+        float3 distancesToBorder = min(cascadePosition, float3(cascade.GridSize - 1) - cascadePosition);
+        float distanceToBorder = min(min(distancesToBorder.x, distancesToBorder.y), distancesToBorder.z);
+
+        if (distanceToBorder < 0.0 && !isLastCascade)
+            continue;
+
+        float3 irradiance = RetrieveGIIlluminanceFromCascade(
+            surfacePosition, surfaceNormal, viewDirection, irradianceProbeAtlas, depthProbeAtlas, sampler, field, cascade, samplingLastFrame);
+
+        float cascadeWeight = saturate(distanceToBorder / CascadeBlendCellCount);
+
+        if (cascadeWeight < 1.0 && !isLastCascade)
+        {
+            float3 coarserIrradiance = RetrieveGIIlluminanceFromCascade(
+                surfacePosition, surfaceNormal, viewDirection, irradianceProbeAtlas, depthProbeAtlas, sampler, field, field.Cascades[cascadeIndex + 1], samplingLastFrame);
+
+            irradiance = lerp(coarserIrradiance, irradiance, cascadeWeight);
+        }
+
+        return irradiance;
+    }
+
+    return 0.0;
+}
+
 #endif
\ No newline at end of file
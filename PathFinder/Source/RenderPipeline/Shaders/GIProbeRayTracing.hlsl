@@ -25,10 +25,18 @@ struct PassData
 
 #include "ShadingCommon.hlsl"
 
+StructuredBuffer<uint> ScheduledProbeTable : register(t6);
+
+// Rays are dispatched only for probes scheduled for update this frame, RaysPerProbe rays for each
+uint ProbeIndexFromDispatchedRayIndex(uint rayIndex)
+{
+    return ScheduledProbeTable[rayIndex / PassDataCB.ProbeField.RaysPerProbe];
+}
+
 void OutputResult(float4 value)
 {
     uint rayIndex = DispatchRaysIndex().x;
-    uint probeIndex = Probe1DIndexFromRayIndex(rayIndex, PassDataCB.ProbeField);
+    uint probeIndex = ProbeIndexFromDispatchedRayIndex(rayIndex);
 
     RWTexture2D<float4> rayHitInfoOutputTexture = RW_Float4_Textures2D[PassDataCB.ProbeField.RayHitInfoTextureIdx];
     uint2 outputTexelIdx = RayHitTexelIndex(rayIndex, probeIndex, PassDataCB.ProbeField);
@@ -89,9 +97,8 @@ void MeshRayClosestHit(inout ProbeRayPayload payload, BuiltInTriangleIntersectio
     randomSequences.BlueNoise = Textures2D[PassDataCB.BlueNoiseTexIdx][Index2DFrom1D(wrappedRayIndex, PassDataCB.BlueNoiseTexSize)];
     randomSequences.Halton = PassDataCB.Halton;
 
-    uint probeIndex = Probe1DIndexFromRayIndex(rayIndex, PassDataCB.ProbeField);
-    uint3 probe3DIndex = Probe3DIndexFrom1D(probeIndex, PassDataCB.ProbeField);
-    float3 probePosition = ProbePositionFrom3DIndex(probe3DIndex, PassDataCB.ProbeField);
+    uint probeIndex = ProbeIndexFromDispatchedRayIndex(rayIndex);
+    float3 probePosition = ProbePositionFromIndex(probeIndex, PassDataCB.ProbeField);
     float3 surfacePosition = WorldRayOrigin() + WorldRayDirection() * RayTCurrent();
     float3x3 surfaceTangentToWorld = RotationMatrix3x3(gBuffer.Normal);
     float3x3 surfaceWorldToTangent = transpose(surfaceTangentToWorld);
@@ -202,7 +209,6 @@ void ProbeRayMiss(inout ProbeRayPayload payload)
     float3 worldDirection = WorldRayDirection();
     float2 skyUV = (OctEncode(worldDirection) + 1.0) * 0.5;
     float3 skyLuminance = skyLuminanceTexture.SampleLevel(LinearClampSampler(), skyUV, 0.0).rgb;
-    float maxRayLength = length(PassDataCB.ProbeField.CellSize.xxx);
     OutputResult(float4(skyLuminance, FloatMax));
 }
 
@@ -216,7 +222,8 @@ void SecondaryShadowRayMiss(inout ProbeRayPayload payload)
 void RayGeneration()
 {
     uint rayIndex = DispatchRaysIndex().x;
-    float3 probePosition = ProbePositionFromRayIndex(rayIndex, PassDataCB.ProbeField);
+    uint probeIndex = ProbeIndexFromDispatchedRayIndex(rayIndex);
+    float3 probePosition = ProbePositionFromIndex(probeIndex, PassDataCB.ProbeField);
     float3 rayDir = ProbeSamplingVector(rayIndex, PassDataCB.ProbeField);
 
     RayDesc dxrRay;
@@ -14,6 +14,8 @@ struct PassData
 
 #include "MandatoryEntryPointInclude.hlsl"
 
+StructuredBuffer<IlluminanceProbeState> ProbeStateTable : register(t0);
+
 // Following constants *must* match values in IlluminanceField
 static const uint IlluminanceProbeSize = 8;
 static const uint IlluminanceProbeTexelCount = IlluminanceProbeSize * IlluminanceProbeSize;
@@ -34,12 +36,28 @@ void CSMain(uint3 gtID : SV_GroupThreadID, uint3 dtID : SV_DispatchThreadID)
     uint probeIndex = dtID.x / DepthProbeTexelCount;
     uint probeLocal1DTexelIndex = gtID.x % DepthProbeTexelCount;
     uint2 probeLocal2DTexelIndex = Index2DFrom1D(probeLocal1DTexelIndex, DepthProbeSize);
-    uint3 probe3DIndex = Probe3DIndexFrom1D(probeIndex, PassDataCB.ProbeField);
-    float3 probePosition = ProbePositionFrom3DIndex(probe3DIndex, PassDataCB.ProbeField); 
+    IlluminanceFieldCascade cascade = PassDataCB.ProbeField.Cascades[ProbeCascadeIndex(probeIndex, PassDataCB.ProbeField)];
+
+    // Probes are stored toroidally, so previous frame data of a probe is in the same slot
+    bool isNewlySpawnedProbe = IsProbeNewlySpawned(probeIndex, PassDataCB.ProbeField);
+
+    IlluminanceProbeState probeState = ProbeStateTable[probeIndex];
+
+    // Probes that weren't traced this frame carry their history over unchanged.
+    // Whole group works on a single probe, so the early out is uniform.
+    if (!probeState.IsScheduled && !isNewlySpawnedProbe)
+    {
+        if (all(probeLocal2DTexelIndex < IlluminanceProbeSize))
+        {
+            uint2 texelIndex = IlluminanceProbeAtlasTexelIndex(probeIndex, probeLocal2DTexelIndex, PassDataCB.ProbeField);
+            RW_Float4_Textures2D[PassDataCB.ProbeField.CurrentIlluminanceProbeAtlasTexIdx][texelIndex] = Textures2D[PassDataCB.ProbeField.PreviousIlluminanceProbeAtlasTexIdx][texelIndex];
+        }
+
+        uint2 texelIndex = DepthProbeAtlasTexelIndex(probeIndex, probeLocal2DTexelIndex, PassDataCB.ProbeField);
+        RW_Float4_Textures2D[PassDataCB.ProbeField.CurrentDepthProbeAtlasTexIdx][texelIndex].rg = Textures2D[PassDataCB.ProbeField.PreviousDepthProbeAtlasTexIdx][texelIndex].rg;
 
-    int3 previous3DIndex = probe3DIndex + PassDataCB.ProbeField.SpawnedProbePlanesCount;
-    uint previousProbeIndex = Probe1DIndexFrom3D(previous3DIndex, PassDataCB.ProbeField);
-    bool isNewlySpawnedProbe = any(previous3DIndex < 0) || any(previous3DIndex >= PassDataCB.ProbeField.GridSize);
+        return;
+    }
 
     // Read ray hit info into shared memory.
     // It is important to have enough threads in the group 
@@ -66,7 +84,7 @@ void CSMain(uint3 gtID : SV_GroupThreadID, uint3 dtID : SV_DispatchThreadID)
 
     // Switch to disable probes inside of geometry
     float insideWallWeight = 1.0;
-    float maxRayLength = length(PassDataCB.ProbeField.CellSize.xxx);
+    float maxRayLength = length(cascade.CellSize.xxx);
 
     // For each ray
     for (uint rayIdx = 0; rayIdx < RaysPerProbe; ++rayIdx)
@@ -112,20 +130,10 @@ void CSMain(uint3 gtID : SV_GroupThreadID, uint3 dtID : SV_DispatchThreadID)
             RWTexture2D<float4> currentAtlas = RW_Float4_Textures2D[PassDataCB.ProbeField.CurrentIlluminanceProbeAtlasTexIdx];
 
             uint2 texelIndex = IlluminanceProbeAtlasTexelIndex(probeIndex, probeLocal2DTexelIndex, PassDataCB.ProbeField);
-            uint2 previousTexelIndex = texelIndex;
-
-            float hysteresis = 0.985 - PassDataCB.ProbeField.IlluminanceHysteresisDecrease;
 
-            if (isNewlySpawnedProbe)
-            {
-                hysteresis = 0.0;
-            } 
-            else
-            {
-                previousTexelIndex = IlluminanceProbeAtlasTexelIndex(previousProbeIndex, probeLocal2DTexelIndex, PassDataCB.ProbeField);
-            }
+            float hysteresis = 0.985 - max(PassDataCB.ProbeField.IlluminanceHysteresisDecrease, probeState.IlluminanceHysteresisDecrease);
 
-            float4 previousIlluminanceAndBackfaceWeight = previousAtlas[previousTexelIndex];
+            float4 previousIlluminanceAndBackfaceWeight = previousAtlas[texelIndex];
             float3 previousIlluminance = previousIlluminanceAndBackfaceWeight.rgb;
             float previousInsideWallWeight = previousIlluminanceAndBackfaceWeight.w;
 
@@ -158,19 +166,14 @@ void CSMain(uint3 gtID : SV_GroupThreadID, uint3 dtID : SV_DispatchThreadID)
         RWTexture2D<float4> currentAtlas = RW_Float4_Textures2D[PassDataCB.ProbeField.CurrentDepthProbeAtlasTexIdx];
 
         uint2 texelIndex = DepthProbeAtlasTexelIndex(probeIndex, probeLocal2DTexelIndex, PassDataCB.ProbeField);
-        uint2 previousTexelIndex = texelIndex;
-        float hysteresis = 0.985 - PassDataCB.ProbeField.DepthHysteresisDecrease;
+        float hysteresis = 0.985 - max(PassDataCB.ProbeField.DepthHysteresisDecrease, probeState.DepthHysteresisDecrease);
 
         if (isNewlySpawnedProbe) 
         {
             hysteresis = 0.0;
         }
-        else
-        {
-            previousTexelIndex = DepthProbeAtlasTexelIndex(previousProbeIndex, probeLocal2DTexelIndex, PassDataCB.ProbeField);
-        }
         
-        float2 previousDepth = previousAtlas[previousTexelIndex].rg;
+        float2 previousDepth = previousAtlas[texelIndex].rg;
 
         currentAtlas[texelIndex].rg = lerp(depthResult.xy, previousDepth, hysteresis);
     }
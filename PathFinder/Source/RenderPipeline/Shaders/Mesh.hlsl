@@ -49,6 +49,8 @@ struct Material
     // 16 byte boundary
     float3 TransmissionFilter;
     float TranslucencyOverride;
+    // 16 byte boundary
+    uint HasTwoChannelNormalMap;
 };
 
 #endif
\ No newline at end of file
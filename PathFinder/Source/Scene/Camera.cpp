@@ -1,5 +1,7 @@
 #include "Camera.hpp"
 
+#include <Foundation/SamplingService.hpp>
+
 #include <glm/gtc/matrix_transform.hpp>
 
 namespace PathFinder
@@ -95,6 +97,14 @@ namespace PathFinder
         return fabs(clipSpaceVector.w) > std::numeric_limits<float>::epsilon() ? clipSpaceVector / clipSpaceVector.w : clipSpaceVector;
     }
 
+    Geometry::Ray3D Camera::WorldRay(const glm::vec2& screenUV) const
+    {
+        glm::vec2 ndc{ screenUV.x * 2.0f - 1.0f, (1.0f - screenUV.y) * 2.0f - 1.0f };
+        glm::vec4 farPlanePoint = GetInverseViewProjection() * glm::vec4{ ndc, 1.0f, 1.0f };
+
+        return { mPosition, glm::vec3{ farPlanePoint } / farPlanePoint.w - mPosition };
+    }
+
     std::array<glm::vec3, 8> Camera::GetFrustumCorners() const
     {
         // Z from 0 to 1
@@ -154,15 +164,17 @@ namespace PathFinder
     {
         Jitter jitter{};
 
-        maxJitterFrames = std::max(maxJitterFrames, JitterHaltonSamples.size());
-        frameIndex = frameIndex % maxJitterFrames;
+        maxJitterFrames = std::max(maxJitterFrames, uint64_t(1));
+
+        // Halton (2, 3) sequence skipping the first sample, which is always at the origin
+        const float* haltonSample = Foundation::SamplingService::SharedInstance().HaltonSample(frameIndex % maxJitterFrames + 1);
 
         glm::vec2 texelSizeInNDC = 2.0f / glm::vec2{ frameResolution };
         glm::mat4 jitterMatrix{ 1.0f };
 
-        // Halton sequence samples are in [-0.5, 0.5] range
-        jitterMatrix[3][0] = texelSizeInNDC.x * JitterHaltonSamples[frameIndex].x;
-        jitterMatrix[3][1] = texelSizeInNDC.y * JitterHaltonSamples[frameIndex].y;
+        // Shift samples into [-0.5, 0.5] range
+        jitterMatrix[3][0] = texelSizeInNDC.x * (haltonSample[0] - 0.5f);
+        jitterMatrix[3][1] = texelSizeInNDC.y * (haltonSample[1] - 0.5f);
 
         jitter.JitterMatrix = jitterMatrix;
         // Jitter is in NDC space, so we need to divide it by 2 to account for UV space being 2 times smaller
@@ -48,29 +48,12 @@ namespace PathFinder
         void SetFieldOfView(float degrees);
 
         glm::vec3 WorldToNDC(const glm::vec3 &v) const;
+
+        // Ray from the camera through a point on the screen, UV origin is at the top left corner
+        Geometry::Ray3D WorldRay(const glm::vec2& screenUV) const;
         std::array<glm::vec3, 8> GetFrustumCorners() const;
 
     private:
-        static constexpr std::array<glm::vec2, 16> JitterHaltonSamples =
-        {
-            glm::vec2{0.000000, -0.166667},
-            glm::vec2{-0.250000,  0.166667},
-            glm::vec2{0.250000, -0.388889},
-            glm::vec2{-0.375000, -0.055556},
-            glm::vec2{0.125000,  0.277778},
-            glm::vec2{-0.125000, -0.277778},
-            glm::vec2{0.375000,  0.055556},
-            glm::vec2{-0.437500,  0.388889},
-            glm::vec2{0.062500, -0.462963},
-            glm::vec2{-0.187500, -0.129630},
-            glm::vec2{0.312500,  0.203704},
-            glm::vec2{-0.312500, -0.351852},
-            glm::vec2{0.187500, -0.018519},
-            glm::vec2{-0.062500,  0.314815},
-            glm::vec2{0.437500, -0.240741},
-            glm::vec2{-0.468750,  0.092593},
-        };
-
         glm::vec3 mFront;
         glm::vec3 mRight;
         glm::vec3 mUp;
@@ -0,0 +1,794 @@
+#include "DisplacementDistanceFieldBaker.hpp"
+
+#include <bitsery/bitsery.h>
+#include <bitsery/adapter/stream.h>
+#include <bitsery/traits/vector.h>
+
+#include <robinhood/robin_hood.h>
+
+#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <immintrin.h>
+
+namespace PathFinder
+{
+
+    namespace
+    {
+        struct DistanceFieldCacheRecord
+        {
+            uint32_t Version = 0;
+            uint64_t InputHash = 0;
+            uint64_t Width = 0;
+            uint64_t Height = 0;
+            uint64_t Depth = 0;
+            std::vector<uint32_t> PackedField;
+
+            template <typename S>
+            void serialize(S& s)
+            {
+                s.value4b(Version);
+                s.value8b(InputHash);
+                s.value8b(Width);
+                s.value8b(Height);
+                s.value8b(Depth);
+                s.container4b(PackedField, std::numeric_limits<uint64_t>::max());
+            }
+        };
+
+        struct EnvelopeScratch
+        {
+            std::vector<double> Vertices;
+            std::vector<double> VertexValues;
+            std::vector<double> Boundaries;
+
+            EnvelopeScratch(uint64_t lineLength)
+                : Vertices(lineLength), VertexValues(lineLength), Boundaries(lineLength) {}
+        };
+
+        // Per worker buffers of one Y slice, rows along X
+        struct SliceScratch
+        {
+            std::vector<float> Partial;
+            std::vector<float> Cone;
+            EnvelopeScratch Envelope;
+
+            SliceScratch(uint64_t sliceSize, uint64_t lineLength)
+                : Partial(sliceSize), Cone(sliceSize), Envelope{ lineLength } {}
+        };
+
+        // Computes out[q] = min(in[p] + weight * (p - q)^2) over p >= q + gap for positive direction, p <= q - gap otherwise.
+        // Parabolas are added to the lower envelope in traversal order, so after adding the one at r
+        // the envelope contains exactly the parabolas allowed for the query 'gap' steps further.
+        void OneSidedDistanceTransform(const float* in, float* out, uint64_t lineLength, uint64_t gap, float weight, bool positiveDirection, EnvelopeScratch& scratch)
+        {
+            const double infinity = std::numeric_limits<double>::infinity();
+            uint64_t parabolaCount = 0;
+
+            auto lineIndex = [&](uint64_t r) { return positiveDirection ? lineLength - 1 - r : r; };
+
+            for (uint64_t r = 0; r < std::min(gap, lineLength); ++r)
+            {
+                out[lineIndex(r)] = std::numeric_limits<float>::infinity();
+            }
+
+            for (uint64_t r = 0; r + gap < lineLength; ++r)
+            {
+                double position = double(r);
+                double value = double(in[lineIndex(r)]) / weight;
+
+                if (std::isfinite(value))
+                {
+                    double boundary = -infinity;
+
+                    while (parabolaCount > 0)
+                    {
+                        uint64_t top = parabolaCount - 1;
+                        double topVertex = scratch.Vertices[top];
+
+                        boundary = ((value + position * position) - (scratch.VertexValues[top] + topVertex * topVertex)) / (2.0 * (position - topVertex));
+
+                        if (boundary > scratch.Boundaries[top])
+                            break;
+
+                        --parabolaCount;
+                        boundary = -infinity;
+                    }
+
+                    scratch.Vertices[parabolaCount] = position;
+                    scratch.VertexValues[parabolaCount] = value;
+                    scratch.Boundaries[parabolaCount] = boundary;
+                    ++parabolaCount;
+                }
+
+                uint64_t queryIndex = lineIndex(r + gap);
+
+                if (parabolaCount == 0)
+                {
+                    out[queryIndex] = std::numeric_limits<float>::infinity();
+                    continue;
+                }
+
+                double queryPosition = double(r + gap);
+                auto boundariesEnd = scratch.Boundaries.begin() + parabolaCount;
+                uint64_t closest = std::distance(scratch.Boundaries.begin(), std::upper_bound(scratch.Boundaries.begin(), boundariesEnd, queryPosition)) - 1;
+                double offset = queryPosition - scratch.Vertices[closest];
+
+                out[queryIndex] = float((scratch.VertexValues[closest] + offset * offset) * weight);
+            }
+        }
+
+        // destination[i] = min(destination[i], source[i] + bias), the inner step of all wedge passes
+        void MinOfBiased(float* destination, const float* source, float bias, uint64_t count)
+        {
+            __m128 biasVector = _mm_set1_ps(bias);
+            uint64_t i = 0;
+
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 candidate = _mm_add_ps(_mm_loadu_ps(source + i), biasVector);
+                _mm_storeu_ps(destination + i, _mm_min_ps(_mm_loadu_ps(destination + i), candidate));
+            }
+
+            for (; i < count; ++i)
+            {
+                destination[i] = std::min(destination[i], source[i] + bias);
+            }
+        }
+
+        // Mirrors VectorOctant() of Utils.hlsl: X and Z split into 4 wedges by the dominant axis (ties go to Z),
+        // negative Y adds 4. Applied to offsets from a voxel to a seed.
+        uint64_t VectorOctant(int64_t dx, int64_t dy, int64_t dz)
+        {
+            uint64_t octant = 0;
+
+            if (std::abs(dx) > std::abs(dz))
+            {
+                octant = dx < 0 ? 0 : 2;
+            }
+            else {
+                octant = dz < 0 ? 3 : 1;
+            }
+
+            if (dy < 0)
+            {
+                octant += 4;
+            }
+
+            return octant;
+        }
+
+        // Neighbour offsets of DistanceMapGeneration.hlsl, in shader order since it decides ties
+        const int64_t JumpFloodingOffsets[26][3] = {
+            { 0,0,1 }, { 1,0,1 }, { -1,0,1 },
+            { 0,1,1 }, { 0,-1,1 }, { 1,1,1 },
+            { 1,-1,1 }, { -1,1,1 }, { -1,-1,1 },
+            { 1,0,0 }, { -1,0,0 }, { 0,1,0 },
+            { 0,-1,0 }, { 1,1,0 }, { 1,-1,0 },
+            { -1,1,0 }, { -1,-1,0 }, { 0,0,-1 },
+            { 1,0,-1 }, { -1,0,-1 }, { 0,1,-1 },
+            { 0,-1,-1 }, { 1,1,-1 },
+            { 1,-1,-1 }, { -1,1,-1 }, { -1,-1,-1 }
+        };
+
+        DisplacementDistanceFieldBaker::HeightField GenerateSyntheticHeightField(uint64_t width, uint64_t height)
+        {
+            DisplacementDistanceFieldBaker::HeightField heightField{ width, height };
+            heightField.Heights.resize(width * height);
+
+            for (uint64_t y = 0; y < height; ++y)
+            {
+                for (uint64_t x = 0; x < width; ++x)
+                {
+                    float u = float(x) / width * 6.2831853f;
+                    float v = float(y) / height * 6.2831853f;
+                    float h = 0.5f + 0.25f * std::sin(3.0f * u) * std::cos(2.0f * v) + 0.15f * std::sin(11.0f * u + 7.0f * v) + 0.08f * std::cos(29.0f * v);
+                    heightField.Heights[y * width + x] = std::clamp(h, 0.0f, 1.0f);
+                }
+            }
+
+            return heightField;
+        }
+    }
+
+    DisplacementDistanceFieldBaker::DisplacementDistanceFieldBaker(uint64_t threadCount)
+        : mThreadCount{ threadCount == 1 ? 1 : Foundation::TaskScheduler::SharedInstance().ThreadCount() } {}
+
+    std::vector<uint32_t> DisplacementDistanceFieldBaker::Bake(const HeightField& heightField, const Geometry::Dimensions& gridSize) const
+    {
+        return PackDistances(BakeDistances(heightField, gridSize));
+    }
+
+    std::vector<float> DisplacementDistanceFieldBaker::BakeDistances(const HeightField& heightField, const Geometry::Dimensions& gridSize) const
+    {
+        const uint64_t width = gridSize.Width;
+        const uint64_t height = gridSize.Height;
+        const uint64_t depth = gridSize.Depth;
+        const uint64_t voxelCount = width * height * depth;
+        // Y slices are processed independently, each is a depth x width plane with rows along X
+        const uint64_t sliceSize = width * depth;
+
+        const float xWeight = 1.0f / float(width * width);
+        const float yWeight = 1.0f / float(height * height);
+        const float zWeight = 1.0f / float(depth * depth);
+
+        std::vector<uint8_t> seeds = ClassifyVoxels(heightField, gridSize);
+
+        // Y pass: squared distance to the nearest seed of the column with offset Y >= 0 for upper octants and < 0 for lower ones
+        std::vector<std::vector<float>> yDistances(2, std::vector<float>(voxelCount));
+
+        ParallelFor(depth, [&](uint64_t begin, uint64_t end)
+        {
+            std::vector<int64_t> nearestSeeds(width);
+
+            for (uint64_t z = begin; z < end; ++z)
+            {
+                for (uint64_t lower = 0; lower < 2; ++lower)
+                {
+                    std::fill(nearestSeeds.begin(), nearestSeeds.end(), -1);
+
+                    for (uint64_t i = 0; i < height; ++i)
+                    {
+                        uint64_t y = lower ? i : height - 1 - i;
+                        const uint8_t* seedRow = seeds.data() + (z * height + y) * width;
+                        float* output = yDistances[lower].data() + y * sliceSize + z * width;
+
+                        // Upper octants include the row itself
+                        if (!lower)
+                        {
+                            for (uint64_t x = 0; x < width; ++x)
+                                if (seedRow[x]) nearestSeeds[x] = y;
+                        }
+
+                        for (uint64_t x = 0; x < width; ++x)
+                        {
+                            float offset = float(std::abs(nearestSeeds[x] - int64_t(y)));
+                            output[x] = nearestSeeds[x] >= 0 ? offset * offset * yWeight : std::numeric_limits<float>::infinity();
+                        }
+
+                        if (lower)
+                        {
+                            for (uint64_t x = 0; x < width; ++x)
+                                if (seedRow[x]) nearestSeeds[x] = y;
+                        }
+                    }
+                }
+            }
+        });
+
+        std::vector<float> distances(voxelCount * OctantCount);
+
+        // X and Z: each octant restricts offsets to a wedge, which is built up one offset magnitude at a time
+        // from a partial transform along the wedge axis, keeping work to vectorized row minimums
+        ParallelFor(height, [&](uint64_t begin, uint64_t end)
+        {
+            SliceScratch scratch{ sliceSize, std::max(width, depth) };
+            float* partial = scratch.Partial.data();
+            float* cone = scratch.Cone.data();
+
+            auto rowMinimum = [&](float* destination, uint64_t destinationZ, const float* source, uint64_t sourceZ, uint64_t destinationX, uint64_t sourceX, float bias, uint64_t count)
+            {
+                MinOfBiased(destination + destinationZ * width + destinationX, source + sourceZ * width + sourceX, bias, count);
+            };
+
+            for (uint64_t y = begin; y < end; ++y)
+            {
+                for (uint64_t lower = 0; lower < 2; ++lower)
+                {
+                    const float* columnDistances = yDistances[lower].data() + y * sliceSize;
+                    uint64_t octantOffset = lower ? 4 : 0;
+
+                    auto storeOctant = [&](uint64_t octant)
+                    {
+                        for (uint64_t z = 0; z < depth; ++z)
+                        {
+                            for (uint64_t x = 0; x < width; ++x)
+                                distances[(((z * height + y) * width) + x) * OctantCount + octantOffset + octant] = cone[z * width + x];
+                        }
+                    };
+
+                    // Octants 1 and 3: |dx| <= dz and |dx| <= -dz, dz < 0.
+                    // Partial holds min over dz >= t (dz <= -t) of column distance + dz^2, combined with dx = +-t.
+                    for (uint64_t negativeZ = 0; negativeZ < 2; ++negativeZ)
+                    {
+                        std::fill(scratch.Partial.begin(), scratch.Partial.end(), std::numeric_limits<float>::infinity());
+                        std::fill(scratch.Cone.begin(), scratch.Cone.end(), std::numeric_limits<float>::infinity());
+
+                        uint64_t minOffset = negativeZ ? 1 : 0;
+
+                        for (uint64_t t = depth - 1; t + 1 > minOffset; --t)
+                        {
+                            float zBias = float(t * t) * zWeight;
+                            float xBias = float(t * t) * xWeight;
+
+                            for (uint64_t z = 0; z + t < depth; ++z)
+                            {
+                                if (negativeZ)
+                                    rowMinimum(partial, z + t, columnDistances, z, 0, 0, zBias, width);
+                                else
+                                    rowMinimum(partial, z, columnDistances, z + t, 0, 0, zBias, width);
+                            }
+
+                            for (uint64_t z = 0; z + t < depth && t < width; ++z)
+                            {
+                                uint64_t partialZ = negativeZ ? z + t : z;
+                                rowMinimum(cone, partialZ, partial, partialZ, 0, t, xBias, width - t);
+
+                                if (t > 0)
+                                    rowMinimum(cone, partialZ, partial, partialZ, t, 0, xBias, width - t);
+                            }
+
+                            // dx = 0 still needs dz <= -1, which is what the partial holds after the last step
+                            if (negativeZ && t == 1)
+                            {
+                                for (uint64_t z = 1; z < depth; ++z)
+                                    rowMinimum(cone, z, partial, z, 0, 0, 0.0f, width);
+                            }
+                        }
+
+                        storeOctant(negativeZ ? 3 : 1);
+                    }
+
+                    // Octants 2 and 0: dx >= |dz| + 1 and -dx >= |dz| + 1.
+                    // Partial holds min over dx >= t (dx <= -t) of column distance + dx^2, combined with dz = +-(t - 1).
+                    for (uint64_t negativeX = 0; negativeX < 2; ++negativeX)
+                    {
+                        std::fill(scratch.Cone.begin(), scratch.Cone.end(), std::numeric_limits<float>::infinity());
+
+                        uint64_t maxOffset = std::min(width, depth);
+
+                        for (uint64_t z = 0; z < depth; ++z)
+                            OneSidedDistanceTransform(columnDistances + z * width, partial + z * width, width, maxOffset, xWeight, !negativeX, scratch.Envelope);
+
+                        for (uint64_t t = maxOffset; t >= 1; --t)
+                        {
+                            uint64_t k = t - 1;
+                            float zBias = float(k * k) * zWeight;
+
+                            for (uint64_t z = 0; z + k < depth; ++z)
+                            {
+                                rowMinimum(cone, z, partial, z + k, 0, 0, zBias, width);
+
+                                if (k > 0)
+                                    rowMinimum(cone, z + k, partial, z, 0, 0, zBias, width);
+                            }
+
+                            if (k == 0)
+                                break;
+
+                            float xBias = float(k * k) * xWeight;
+
+                            for (uint64_t z = 0; z < depth; ++z)
+                            {
+                                if (negativeX)
+                                    rowMinimum(partial, z, columnDistances, z, k, 0, xBias, width - k);
+                                else
+                                    rowMinimum(partial, z, columnDistances, z, 0, k, xBias, width - k);
+                            }
+                        }
+
+                        storeOctant(negativeX ? 0 : 2);
+                    }
+                }
+            }
+        });
+
+        ParallelFor(voxelCount, [&](uint64_t begin, uint64_t end)
+        {
+            for (uint64_t voxel = begin; voxel < end; ++voxel)
+            {
+                float* voxelDistances = distances.data() + voxel * OctantCount;
+
+                // Seeds hold themselves in every octant, as in the GPU baker
+                if (seeds[voxel])
+                    std::fill(voxelDistances, voxelDistances + OctantCount, 0.0f);
+
+                for (uint64_t octant = 0; octant < OctantCount; octant += 4)
+                    _mm_storeu_ps(voxelDistances + octant, _mm_sqrt_ps(_mm_loadu_ps(voxelDistances + octant)));
+            }
+        });
+
+        return distances;
+    }
+
+    std::vector<float> DisplacementDistanceFieldBaker::BakeDistancesBruteForce(const HeightField& heightField, const Geometry::Dimensions& gridSize)
+    {
+        const int64_t width = gridSize.Width;
+        const int64_t height = gridSize.Height;
+        const int64_t depth = gridSize.Depth;
+
+        std::vector<uint8_t> seeds = DisplacementDistanceFieldBaker{ 1 }.ClassifyVoxels(heightField, gridSize);
+        std::vector<float> distances(seeds.size() * OctantCount, std::numeric_limits<float>::infinity());
+
+        for (int64_t z = 0; z < depth; ++z)
+        {
+            for (int64_t y = 0; y < height; ++y)
+            {
+                for (int64_t x = 0; x < width; ++x)
+                {
+                    float* voxelDistances = distances.data() + ((z * height + y) * width + x) * OctantCount;
+
+                    for (uint64_t seedIndex = 0; seedIndex < seeds.size(); ++seedIndex)
+                    {
+                        if (!seeds[seedIndex])
+                            continue;
+
+                        int64_t dx = int64_t(seedIndex % width) - x;
+                        int64_t dy = int64_t((seedIndex / width) % height) - y;
+                        int64_t dz = int64_t(seedIndex / (width * height)) - z;
+
+                        double nx = double(dx) / width;
+                        double ny = double(dy) / height;
+                        double nz = double(dz) / depth;
+                        float distance = float(std::sqrt(nx * nx + ny * ny + nz * nz));
+
+                        // Voxel that is a seed itself is closest in every octant
+                        if (dx == 0 && dy == 0 && dz == 0)
+                        {
+                            std::fill(voxelDistances, voxelDistances + OctantCount, 0.0f);
+                            continue;
+                        }
+
+                        uint64_t octant = VectorOctant(dx, dy, dz);
+                        voxelDistances[octant] = std::min(voxelDistances[octant], distance);
+                    }
+                }
+            }
+        }
+
+        return distances;
+    }
+
+    std::vector<float> DisplacementDistanceFieldBaker::BakeDistancesJumpFlooding(const HeightField& heightField, const Geometry::Dimensions& gridSize)
+    {
+        const int64_t width = gridSize.Width;
+        const int64_t height = gridSize.Height;
+        const int64_t depth = gridSize.Depth;
+        const int64_t voxelCount = width * height * depth;
+
+        // Closest seed and distance to it per octant, negative distance marks a free octant as VoxelFree does
+        struct Cone
+        {
+            int64_t X = -1;
+            int64_t Y = -1;
+            int64_t Z = -1;
+            float Distance = -1.0f;
+        };
+
+        std::vector<uint8_t> seeds = DisplacementDistanceFieldBaker{ 1 }.ClassifyVoxels(heightField, gridSize);
+        std::vector<Cone> readCones(voxelCount * OctantCount);
+
+        for (int64_t voxel = 0; voxel < voxelCount; ++voxel)
+        {
+            if (seeds[voxel])
+                std::fill_n(readCones.begin() + voxel * OctantCount, OctantCount, Cone{ voxel % width, (voxel / width) % height, voxel / (width * height), 0.0f });
+        }
+
+        std::vector<Cone> writeCones = readCones;
+
+        // Same float math as VoxelCentersDistance()
+        auto voxelCentersDistance = [&](int64_t x0, int64_t y0, int64_t z0, int64_t x1, int64_t y1, int64_t z1)
+        {
+            float dx = (float(x1) / width + 0.5f / width) - (float(x0) / width + 0.5f / width);
+            float dy = (float(y1) / height + 0.5f / height) - (float(y0) / height + 0.5f / height);
+            float dz = (float(z1) / depth + 0.5f / depth) - (float(z0) / depth + 0.5f / depth);
+            return std::sqrt(dx * dx + dy * dy + dz * dz);
+        };
+
+        auto floodPass = [&](int64_t step)
+        {
+            for (int64_t z = 0; z < depth; ++z)
+            {
+                for (int64_t y = 0; y < height; ++y)
+                {
+                    for (int64_t x = 0; x < width; ++x)
+                    {
+                        int64_t voxel = (z * height + y) * width + x;
+                        const Cone* cones = readCones.data() + voxel * OctantCount;
+                        Cone* outputCones = writeCones.data() + voxel * OctantCount;
+
+                        std::copy(cones, cones + OctantCount, outputCones);
+
+                        if (seeds[voxel])
+                            continue;
+
+                        for (const int64_t* offset : JumpFloodingOffsets)
+                        {
+                            int64_t nx = x + offset[0] * step;
+                            int64_t ny = y + offset[1] * step;
+                            int64_t nz = z + offset[2] * step;
+
+                            if (nx < 0 || ny < 0 || nz < 0 || nx >= width || ny >= height || nz >= depth)
+                                continue;
+
+                            uint64_t octant = VectorOctant(offset[0], offset[1], offset[2]);
+                            const Cone& neighbourCone = readCones[((nz * height + ny) * width + nx) * OctantCount + octant];
+
+                            if (neighbourCone.X < 0)
+                                continue;
+
+                            float distance = voxelCentersDistance(x, y, z, neighbourCone.X, neighbourCone.Y, neighbourCone.Z);
+                            Cone& outputCone = outputCones[octant];
+
+                            if (outputCone.Distance < 0.0f || distance < outputCone.Distance)
+                                outputCone = Cone{ neighbourCone.X, neighbourCone.Y, neighbourCone.Z, distance };
+                        }
+                    }
+                }
+            }
+
+            std::swap(readCones, writeCones);
+        };
+
+        // JFA + 4, steps halve from half the largest dimension down to 1
+        uint64_t largestDimension = gridSize.LargestDimension();
+        uint64_t stepCount = uint64_t(std::log2(largestDimension));
+        uint64_t step = largestDimension / 2;
+
+        for (uint64_t i = 0; i < stepCount + 4; ++i)
+        {
+            floodPass(int64_t(std::max(step, uint64_t(1))));
+            step /= 2;
+        }
+
+        std::vector<float> distances(readCones.size());
+
+        for (uint64_t i = 0; i < readCones.size(); ++i)
+        {
+            distances[i] = readCones[i].Distance < 0.0f ? std::numeric_limits<float>::infinity() : readCones[i].Distance;
+        }
+
+        return distances;
+    }
+
+    std::vector<uint32_t> DisplacementDistanceFieldBaker::PackDistances(const std::vector<float>& distances)
+    {
+        // Matches PackUnorm2x16 in shaders: first value of a pair occupies high 16 bits
+        auto quantize = [](float distance) -> uint32_t
+        {
+            return uint32_t(std::min(distance, MaxDistance) / MaxDistance * 65535.0f);
+        };
+
+        std::vector<uint32_t> packed(distances.size() / 2);
+
+        for (uint64_t i = 0; i < packed.size(); ++i)
+        {
+            packed[i] = (quantize(distances[i * 2]) << 16) | quantize(distances[i * 2 + 1]);
+        }
+
+        return packed;
+    }
+
+    uint64_t DisplacementDistanceFieldBaker::InputHash(const HeightField& heightField, const Geometry::Dimensions& gridSize)
+    {
+        uint64_t heightsHash = robin_hood::hash_bytes(heightField.Heights.data(), heightField.Heights.size() * sizeof(float));
+
+        uint64_t inputData[] = {
+            heightsHash, heightField.Width, heightField.Height,
+            gridSize.Width, gridSize.Height, gridSize.Depth, CacheVersion
+        };
+
+        return robin_hood::hash_bytes(inputData, sizeof(inputData));
+    }
+
+    bool DisplacementDistanceFieldBaker::SaveCache(const std::filesystem::path& path, uint64_t inputHash, const Geometry::Dimensions& gridSize, const std::vector<uint32_t>& packedField)
+    {
+        std::fstream stream{ path, std::ios::binary | std::ios::trunc | std::ios::out };
+
+        if (!stream.is_open())
+            return false;
+
+        DistanceFieldCacheRecord record{ CacheVersion, inputHash, gridSize.Width, gridSize.Height, gridSize.Depth, packedField };
+
+        bitsery::Serializer<bitsery::OutputBufferedStreamAdapter> ser{ stream };
+        ser.object(record);
+        ser.adapter().flush();
+
+        return stream.good();
+    }
+
+    std::optional<std::vector<uint32_t>> DisplacementDistanceFieldBaker::LoadCache(const std::filesystem::path& path, uint64_t inputHash, const Geometry::Dimensions& gridSize)
+    {
+        std::fstream stream{ path, std::ios::binary | std::ios::in };
+
+        if (!stream.is_open())
+            return std::nullopt;
+
+        DistanceFieldCacheRecord record;
+        bitsery::Deserializer<bitsery::InputStreamAdapter> des{ stream };
+        des.object(record);
+
+        bool isValid =
+            des.adapter().error() == bitsery::ReaderError::NoError &&
+            record.Version == CacheVersion &&
+            record.InputHash == inputHash &&
+            record.Width == gridSize.Width && record.Height == gridSize.Height && record.Depth == gridSize.Depth &&
+            record.PackedField.size() == gridSize.Width * gridSize.Height * gridSize.Depth * OctantCount / 2;
+
+        if (!isValid)
+            return std::nullopt;
+
+        return std::move(record.PackedField);
+    }
+
+    bool DisplacementDistanceFieldBaker::RunBenchmark(const std::filesystem::path& reportPath)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        auto measure = [](const DisplacementDistanceFieldBaker& baker, const HeightField& heightField, const Geometry::Dimensions& gridSize)
+        {
+            Clock::time_point start = Clock::now();
+            std::vector<uint32_t> field = baker.Bake(heightField, gridSize);
+            return std::chrono::duration<double>(Clock::now() - start).count();
+        };
+
+        // Full size bake, same grid the material loader uses
+        Geometry::Dimensions gridSize{ 128, 128, 64 };
+        HeightField heightField = GenerateSyntheticHeightField(512, 512);
+
+        DisplacementDistanceFieldBaker serialBaker{ 1 };
+        DisplacementDistanceFieldBaker parallelBaker;
+
+        double serialDuration = measure(serialBaker, heightField, gridSize);
+        double parallelDuration = measure(parallelBaker, heightField, gridSize);
+
+        // Exactness check against the brute force reference on grids small enough for it,
+        // one flatter and one deeper than wide so that wedges of both axis pairs get clipped
+        Geometry::Dimensions validationGridSizes[]{ { 32, 32, 8 }, { 16, 24, 32 } };
+        HeightField validationHeightField = GenerateSyntheticHeightField(64, 64);
+
+        float maxError = 0.0f;
+        uint64_t mismatchCount = 0;
+        bool isPackingEqual = true;
+
+        for (const Geometry::Dimensions& validationGridSize : validationGridSizes)
+        {
+            std::vector<float> distances = parallelBaker.BakeDistances(validationHeightField, validationGridSize);
+            std::vector<float> referenceDistances = BakeDistancesBruteForce(validationHeightField, validationGridSize);
+
+            for (uint64_t i = 0; i < distances.size(); ++i)
+            {
+                bool bothInfinite = std::isinf(distances[i]) && std::isinf(referenceDistances[i]);
+                float error = bothInfinite ? 0.0f : std::abs(distances[i] - referenceDistances[i]);
+
+                if (!(error <= 1e-5f))
+                    ++mismatchCount;
+
+                if (std::isfinite(error))
+                    maxError = std::max(maxError, error);
+            }
+
+            isPackingEqual = isPackingEqual && PackDistances(distances) == PackDistances(referenceDistances);
+        }
+
+        // GPU baker check: jump flooding only ever finds seeds inside the octant it fills, since octants are convex cones,
+        // so with matching octant order its distances can't be below exact ones and every octant it reaches must have a seed
+        Geometry::Dimensions floodingGridSize{ 64, 64, 32 };
+        HeightField floodingHeightField = GenerateSyntheticHeightField(256, 256);
+
+        std::vector<float> distances = parallelBaker.BakeDistances(floodingHeightField, floodingGridSize);
+        std::vector<float> floodingDistances = BakeDistancesJumpFlooding(floodingHeightField, floodingGridSize);
+
+        uint64_t floodingViolationCount = 0;
+        uint64_t floodingMatchCount = 0;
+        uint64_t floodingMissCount = 0;
+        float floodingMaxExcess = 0.0f;
+
+        for (uint64_t i = 0; i < distances.size(); ++i)
+        {
+            if (std::isinf(floodingDistances[i]))
+            {
+                floodingMissCount += std::isfinite(distances[i]);
+                continue;
+            }
+
+            float excess = floodingDistances[i] - distances[i];
+
+            if (!(excess >= -1e-5f))
+                ++floodingViolationCount;
+            else if (excess <= 1e-5f)
+                ++floodingMatchCount;
+            else
+                floodingMaxExcess = std::max(floodingMaxExcess, excess);
+        }
+
+        bool isFloodingConsistent = floodingViolationCount == 0;
+        bool passed = mismatchCount == 0 && isPackingEqual && isFloodingConsistent;
+
+        std::ofstream stream{ reportPath, std::ios::out | std::ios::trunc };
+
+        if (!stream.is_open())
+            return false;
+
+        stream.precision(9);
+        stream << "{\"units\":\"seconds\",\"grid\":[" << gridSize.Width << "," << gridSize.Height << "," << gridSize.Depth << "]"
+            << ",\"heightField\":[" << heightField.Width << "," << heightField.Height << "]"
+            << ",\"threads\":" << parallelBaker.ThreadCount()
+            << ",\"serialDuration\":" << serialDuration
+            << ",\"parallelDuration\":" << parallelDuration
+            << ",\"speedup\":" << (parallelDuration > 0.0 ? serialDuration / parallelDuration : 0.0)
+            << ",\n\"validation\":{\"grids\":" << std::size(validationGridSizes)
+            << ",\"maxError\":" << maxError << ",\"mismatches\":" << mismatchCount << ",\"packingEqual\":" << (isPackingEqual ? "true" : "false") << "}"
+            << ",\n\"jumpFlooding\":{\"grid\":[" << floodingGridSize.Width << "," << floodingGridSize.Height << "," << floodingGridSize.Depth << "]"
+            << ",\"matchRatio\":" << double(floodingMatchCount) / distances.size() << ",\"maxExcess\":" << floodingMaxExcess
+            << ",\"unreachedOctants\":" << floodingMissCount << ",\"violations\":" << floodingViolationCount
+            << ",\"consistent\":" << (isFloodingConsistent ? "true" : "false") << "}"
+            << ",\"passed\":" << (passed ? "true" : "false") << "}\n";
+
+        return stream.good() && passed;
+    }
+
+    std::vector<uint8_t> DisplacementDistanceFieldBaker::ClassifyVoxels(const HeightField& heightField, const Geometry::Dimensions& gridSize) const
+    {
+        const uint64_t width = gridSize.Width;
+        const uint64_t height = gridSize.Height;
+        const uint64_t depth = gridSize.Depth;
+
+        std::vector<uint8_t> seeds(width * height * depth, 0);
+
+        if (heightField.Heights.empty())
+            return seeds;
+
+        // Texel footprint of a voxel column, at least one texel wide
+        auto texelRange = [](uint64_t voxel, uint64_t voxelCount, uint64_t texelCount)
+        {
+            uint64_t begin = std::min(voxel * texelCount / voxelCount, texelCount - 1);
+            uint64_t end = std::max(begin + 1, std::min((voxel + 1) * texelCount / voxelCount, texelCount));
+            return std::make_pair(begin, end);
+        };
+
+        ParallelFor(height, [&](uint64_t begin, uint64_t end)
+        {
+            for (uint64_t y = begin; y < end; ++y)
+            {
+                auto [texelYBegin, texelYEnd] = texelRange(y, height, heightField.Height);
+
+                for (uint64_t x = 0; x < width; ++x)
+                {
+                    auto [texelXBegin, texelXEnd] = texelRange(x, width, heightField.Width);
+
+                    float minHeight = std::numeric_limits<float>::max();
+                    float maxHeight = std::numeric_limits<float>::lowest();
+
+                    for (uint64_t texelY = texelYBegin; texelY < texelYEnd; ++texelY)
+                    {
+                        for (uint64_t texelX = texelXBegin; texelX < texelXEnd; ++texelX)
+                        {
+                            float texelHeight = heightField.Heights[texelY * heightField.Width + texelX];
+                            minHeight = std::min(minHeight, texelHeight);
+                            maxHeight = std::max(maxHeight, texelHeight);
+                        }
+                    }
+
+                    for (uint64_t z = 0; z < depth; ++z)
+                    {
+                        float voxelBottom = float(z) / depth;
+                        float voxelTop = float(z + 1) / depth;
+
+                        bool isUnderSurface = voxelTop <= minHeight;
+                        bool isIntersected = maxHeight >= voxelBottom && minHeight < voxelTop;
+
+                        seeds[(z * height + y) * width + x] = isUnderSurface || isIntersected;
+                    }
+                }
+            }
+        });
+
+        return seeds;
+    }
+
+    template <class Function>
+    void DisplacementDistanceFieldBaker::ParallelFor(uint64_t count, const Function& function) const
+    {
+        if (mThreadCount <= 1)
+        {
+            function(0, count);
+            return;
+        }
+
+        Foundation::TaskScheduler::SharedInstance().ParallelFor(count, 1, function);
+    }
+
+}
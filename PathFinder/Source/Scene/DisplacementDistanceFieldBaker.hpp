@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Geometry/Dimensions.hpp>
+#include <Foundation/TaskScheduler.hpp>
+
+#include <vector>
+#include <optional>
+#include <filesystem>
+
+namespace PathFinder
+{
+
+    /// Bakes cone distance field used by displacement mapping on the CPU.
+    /// For each voxel of a W x H x D grid laid over a height field (x, y map to UV, z to height)
+    /// stores Euclidean distance, in normalized UVW units between voxel centers, to the closest voxel
+    /// intersected by or lying under the height surface within each of 8 octants.
+    /// Octants are those of VectorOctant() in Utils.hlsl, which displacement shaders index cones with:
+    /// 0 - X dominant negative, 1 - Z dominant positive, 2 - X dominant positive, 3 - Z dominant negative,
+    /// X and Z compared by magnitude with ties going to Z, plus 4 for negative Y. Seeds are at zero distance in all octants.
+    /// Distances are exact: a one-sided Y pass is followed by wedge passes over X-Z slices
+    /// built from vectorized row minimums, with slices processed in parallel.
+    class DisplacementDistanceFieldBaker
+    {
+    public:
+        inline static const uint32_t CacheVersion = 2;
+        inline static const float MaxDistance = 1.7320508f; // sqrt(3), distance range of packed values
+        inline static const uint64_t OctantCount = 8;
+
+        struct HeightField
+        {
+            uint64_t Width = 0;
+            uint64_t Height = 0;
+            // Row-major normalized heights
+            std::vector<float> Heights;
+        };
+
+        // Thread count of 1 bakes on the calling thread, any other value uses all threads of the shared task scheduler
+        DisplacementDistanceFieldBaker(uint64_t threadCount = 0);
+
+        // Returns 4 uints per voxel with distances packed in unorm16 pairs as the displacement shaders expect
+        std::vector<uint32_t> Bake(const HeightField& heightField, const Geometry::Dimensions& gridSize) const;
+
+        // Unpacked distances indexed as [voxelIndex * OctantCount + octant], infinity if octant has no seeds
+        std::vector<float> BakeDistances(const HeightField& heightField, const Geometry::Dimensions& gridSize) const;
+
+        // Reference O(voxels * seeds) implementation for validation
+        static std::vector<float> BakeDistancesBruteForce(const HeightField& heightField, const Geometry::Dimensions& gridSize);
+
+        // Serial port of the GPU jump flooding baker (DistanceMapGeneration.hlsl, JFA + 4) over the same seeds,
+        // infinity where flooding didn't reach
+        static std::vector<float> BakeDistancesJumpFlooding(const HeightField& heightField, const Geometry::Dimensions& gridSize);
+
+        static std::vector<uint32_t> PackDistances(const std::vector<float>& distances);
+
+        // Hash identifying the bake input, used to validate cached distance fields
+        static uint64_t InputHash(const HeightField& heightField, const Geometry::Dimensions& gridSize);
+
+        static bool SaveCache(const std::filesystem::path& path, uint64_t inputHash, const Geometry::Dimensions& gridSize, const std::vector<uint32_t>& packedField);
+        static std::optional<std::vector<uint32_t>> LoadCache(const std::filesystem::path& path, uint64_t inputHash, const Geometry::Dimensions& gridSize);
+
+        // Bakes a synthetic height field serially and in parallel, validates against brute force
+        // on small grids and against the GPU baker port, writes timings and error to a JSON report
+        static bool RunBenchmark(const std::filesystem::path& reportPath);
+
+    private:
+        // Seeds are voxels intersected by the height surface or lying entirely under it
+        std::vector<uint8_t> ClassifyVoxels(const HeightField& heightField, const Geometry::Dimensions& gridSize) const;
+
+        template <class Function>
+        void ParallelFor(uint64_t count, const Function& function) const;
+
+        uint64_t mThreadCount;
+
+    public:
+        inline auto ThreadCount() const { return mThreadCount; }
+    };
+
+}
@@ -2,8 +2,10 @@
 #include "Scene.hpp"
 
 #include <Foundation/Pi.hpp>
+#include <Foundation/Assert.hpp>
+#include <Foundation/SamplingService.hpp>
 #include <Geometry/Utils.hpp>
-#include <random>
+#include <limits>
 #include <glm/gtx/compatibility.hpp>
 
 namespace PathFinder 
@@ -14,30 +16,28 @@ namespace PathFinder
 
     void GIManager::Update()
     {
-        UpdateGridCornerPosition();
+        UpdateCascadePositions();
         UpdateHysteresisDecrease();
+        InvalidateProbes();
 
         if (!DoNotRotateProbeRays)
         {
-            std::random_device rd;  //Will be used to obtain a seed for the random number engine
-            std::mt19937 gen(rd()); //Standard mersenne_twister_engine seeded with rd()
-            std::uniform_real_distribution<> dis(0.0, 1.0);
-
-            ProbeField.GenerateProbeRotation(glm::vec2{ dis(gen), dis(gen) });
+            // Lattice rotations cover the sphere evenly over consecutive frames and replay identically between runs
+            const Foundation::SamplingService& sampling = Foundation::SamplingService::SharedInstance();
+            ProbeField.GenerateProbeRotation(glm::vec2{ sampling.Rank1Lattice(mFrameIndex, 0), sampling.Rank1Lattice(mFrameIndex, 1) });
         }
         else
         {
             ProbeField.GenerateProbeRotation(glm::vec2{ 0.0 });
         }
 
-        ProbeField.SetDebugProbeRadius(ProbeField.GetCellSize() / 7.0);
+        ProbeField.SetDebugProbeRadius(ProbeField.GetCascades().front().GetCellSize() / 7.0);
+
+        ++mFrameIndex;
     }
 
-    void GIManager::UpdateGridCornerPosition()
+    void GIManager::UpdateCascadePositions()
     {
-        glm::vec3 gridSize = glm::vec3{ ProbeField.GetGridSize() } * ProbeField.GetCellSize();
-        glm::vec3 halfGridSize = gridSize * 0.5f;
-
         // 4 front corners
         constexpr std::array<glm::vec3, 4> NDCCorners = { 
             glm::vec3(-1,-1,1), glm::vec3(-1,1,1), glm::vec3(1,1,1), glm::vec3(1,-1,1)
@@ -65,34 +65,37 @@ namespace PathFinder
         glm::vec3 normIntersectionPoint = mScene->GetMainCamera().GetPosition() - frustumAABB.GetMin();
         normIntersectionPoint /= frustumAABB.GetMax() - frustumAABB.GetMin();
 
-        // Get cascades min point by centering cascade around the camera position
-        glm::vec3 cascadeMinPoint = mScene->GetMainCamera().GetPosition() - halfGridSize;
+        for (uint64_t cascadeIndex = 0; cascadeIndex < ProbeField.GetCascades().size(); ++cascadeIndex)
+        {
+            const IlluminanceFieldCascade& cascade = ProbeField.GetCascades()[cascadeIndex];
+            glm::vec3 gridSize = glm::vec3{ cascade.GetGridSize() } * cascade.GetCellSize();
+            glm::vec3 halfGridSize = gridSize * 0.5f;
+
+            // Get cascades min point by centering cascade around the camera position
+            glm::vec3 cascadeMinPoint = mScene->GetMainCamera().GetPosition() - halfGridSize;
 
-        // Compute anchor which is a point on the cascade's AABB 
-        glm::vec3 cascadeAnchor = normIntersectionPoint * gridSize + cascadeMinPoint;
+            // Compute anchor which is a point on the cascade's AABB 
+            glm::vec3 cascadeAnchor = normIntersectionPoint * gridSize + cascadeMinPoint;
 
-        // We want to move cascade so that anchor point is at the same place as camera position
-        glm::vec3 giCascadeDisplacement = mScene->GetMainCamera().GetPosition() - cascadeAnchor;
+            // We want to move cascade so that anchor point is at the same place as camera position
+            glm::vec3 giCascadeDisplacement = mScene->GetMainCamera().GetPosition() - cascadeAnchor;
 
-        // We move cascade to camera but then move it backwards by one cell size so that we always have a probe behind the camera, for more smooth GI
-        glm::vec3 cascadeOptimalMinPoint = cascadeMinPoint + giCascadeDisplacement - mScene->GetMainCamera().GetFront() * ProbeField.GetCellSize();
+            // We move cascade to camera but then move it backwards by one cell size so that we always have a probe behind the camera, for more smooth GI
+            glm::vec3 cascadeOptimalMinPoint = cascadeMinPoint + giCascadeDisplacement - mScene->GetMainCamera().GetFront() * cascade.GetCellSize();
 
-        ProbeField.SetCornerPosition(Geometry::Snap(cascadeOptimalMinPoint, glm::vec3{ ProbeField.GetCellSize() }));
+            // Cascade scrolls toroidally, only slabs of probes exposed by the move are invalidated
+            ProbeField.ScrollCascade(cascadeIndex, Geometry::Snap(cascadeOptimalMinPoint, glm::vec3{ cascade.GetCellSize() }));
+        }
     }
 
     void GIManager::UpdateHysteresisDecrease()
     {
-        // Very rough heuristic. Ideally should be made per probe.
+        // Sun lights the whole field, so its changes, as well as application startup, decrease hysteresis of every probe.
+        // Local changes are routed to the probes they affect by the invalidation grid.
         float irradianceHysteresisDecrease = 0.0f;
         float depthHysteresisDecrease = 0.0f;
 
-        auto perceptuallyEncodeLuminance = [](float luminance) -> float
-        {
-            return std::pow(luminance, 1.0 / 2.0);
-        };
-
-        float maxHysteresisDecrease = 0.5f;
-        float geometricChangeSensitivity = 3.0f;
+        float maxHysteresisDecrease = GIProbeInvalidationGrid::MaxHysteresisDecrease;
 
         // Sun
         float angleCos = glm::clamp(glm::dot(mScene->GetSky().GetSunDirection(), mScene->GetSky().GetPreviousSunDirection()), 0.0f, 1.0f);
@@ -101,8 +104,100 @@ namespace PathFinder
         float hysteresisDecreaseDueToSun = glm::mix(0.0f, maxHysteresisDecrease, sunDirectionLerpFactor);
         irradianceHysteresisDecrease = hysteresisDecreaseDueToSun;
 
+        // The larger the hysteresis decrease, the larger the frame count that we must keep it
+        float irradianceDecreaseFrameDuration = glm::mix(0.0f, 10.0f, irradianceHysteresisDecrease / maxHysteresisDecrease);
+        float depthDecreaseFrameDuration = glm::mix(0.0f, 7.0f, depthHysteresisDecrease / maxHysteresisDecrease);
+
+        mIlluminanceHysteresisDecreseFrameCount = std::max(mIlluminanceHysteresisDecreseFrameCount, uint64_t(irradianceDecreaseFrameDuration));
+        irradianceHysteresisDecrease = std::max(irradianceHysteresisDecrease, ProbeField.GetIlluminanceHysteresisDecrease());
+
+        mDepthHysteresisDecreseFrameCount = std::max(mDepthHysteresisDecreseFrameCount, uint64_t(depthDecreaseFrameDuration));
+        depthHysteresisDecrease = std::max(depthHysteresisDecrease, ProbeField.GetDepthHysteresisDecrease());
+
+        // We stop decreasing hysteresis if there is no decrease this frame and we have no frames left
+        if (mIlluminanceHysteresisDecreseFrameCount == 0)
+            irradianceHysteresisDecrease = 0;    
+
+        if (mDepthHysteresisDecreseFrameCount == 0)
+            depthHysteresisDecrease = 0;
+
+        // Decrease frame count
+        if (mIlluminanceHysteresisDecreseFrameCount > 0)
+            mIlluminanceHysteresisDecreseFrameCount -= 1;
+
+        if (mDepthHysteresisDecreseFrameCount > 0)
+            mDepthHysteresisDecreseFrameCount -= 1;
+
+        ProbeField.SetIlluminanceHysteresisDecrease(irradianceHysteresisDecrease);
+        ProbeField.SetDepthHysteresisDecrease(depthHysteresisDecrease);
+    }
+
+    void GIManager::InvalidateProbes()
+    {
+        mProbeInvalidationGrid.BeginFrame(ProbeField.GetCascades());
+
+        auto perceptuallyEncodeLuminance = [](float luminance) -> float
+        {
+            return std::pow(luminance, 1.0 / 2.0);
+        };
+
+        float maxHysteresisDecrease = GIProbeInvalidationGrid::MaxHysteresisDecrease;
+        float geometricChangeSensitivity = 3.0f;
+
+        // Changes are weighted relative to the finest cascade, coarser ones are invalidated as a whole cell anyway
+        float cellSize = ProbeField.GetCascades().front().GetCellSize();
+
+        const auto& meshInstances = mScene->GetMeshInstances();
+        uint64_t slotCount = meshInstances.Size() + mScene->GetSphericalLights().size() + mScene->GetRectangularLights().size() + mScene->GetDiskLights().size();
+
+        // Removal moves the last instance into the removed one's place and shifts lights down,
+        // so slots are matched against entities that held them last frame
+        mProbeInvalidationGrid.ResizeEntitySlots(slotCount);
+        uint64_t slot = 0;
+
+        // Mesh instances
+        for (uint32_t index = 0; index < meshInstances.Size(); ++index)
+        {
+            MeshInstanceHandle handle = meshInstances.HandleAt(index);
+            bool isNewInSlot = mProbeInvalidationGrid.AssignEntity(slot, (uint64_t(handle.Generation) << 32) | handle.Slot);
+
+            // Transform hierarchy tracks which world matrices were recomputed this frame
+            bool isStatic = !meshInstances.HasChanged(index);
+
+            // Static instances are skipped without transforming their bounds
+            if (isStatic && !isNewInSlot)
+            {
+                ++slot;
+                continue;
+            }
+
+            const Geometry::AABB& previousAABB = meshInstances.PreviousWorldBounds()[index];
+            const Geometry::AABB& currentAABB = meshInstances.WorldBounds()[index];
+
+            float diagonalChange = std::abs(previousAABB.Diagonal() - currentAABB.Diagonal());
+            float distanceTravelled = glm::distance(glm::vec3{ meshInstances.PreviousWorldMatrix(index)[3] }, glm::vec3{ meshInstances.WorldMatrix(index)[3] });
+
+            // The bigger the mesh, the more impact it has on indirect lighting
+            float importance = currentAABB.Diagonal() / cellSize;
+
+            float diagonalLerpFactor = glm::clamp(diagonalChange / cellSize, 0.0f, 1.0f);
+            // Movement weight depends on how large the object is in relation to probe grid
+            float movementLerpFactor = glm::clamp(distanceTravelled / cellSize * importance, 0.0f, 1.0f);
+
+            float hysteresisDecreaseDueSizeChange = glm::mix(0.0f, maxHysteresisDecrease, diagonalLerpFactor);
+            float hysteresisDecreaseDueToMovement = glm::mix(0.0f, maxHysteresisDecrease, movementLerpFactor);
+
+            float hysteresisDecrease = isNewInSlot ? maxHysteresisDecrease : std::max(hysteresisDecreaseDueSizeChange, hysteresisDecreaseDueToMovement);
+
+            // Large meshes occlude and bounce light further away from their bounds
+            float margin = std::min(currentAABB.Diagonal() * 0.5f, cellSize);
+
+            mProbeInvalidationGrid.RefitEntity(slot, currentAABB, margin, hysteresisDecrease, hysteresisDecrease);
+            ++slot;
+        }
+
         // Local lights
-        auto computeHysteresisDecreaseForLights = [&](auto&& lights)
+        auto invalidateProbesForLights = [&](auto&& lights)
         {
             for (auto& light : lights)
             {
@@ -113,81 +208,66 @@ namespace PathFinder
                 float luminanceChange = std::abs(perceptualPreviousLumianance - perceptualLumianance);
                 float distanceTravelled = glm::distance(light.GetPosition(), light.GetPreviousPosition());
 
+                // Lights live in lists, so their addresses identify them
+                bool isNewInSlot = mProbeInvalidationGrid.AssignEntity(slot, reinterpret_cast<uint64_t>(&light));
+
+                if (areaChange == 0.0f && luminanceChange == 0.0f && distanceTravelled == 0.0f && !isNewInSlot)
+                {
+                    ++slot;
+                    continue;
+                }
+
                 // Computing heuristics relative to probe cell sizes
                 // Light area, luminance or movement change means lighting condition change, so we need to drop history
-                float areaLerpFactor = glm::clamp(areaChange / ProbeField.GetCellSize() * geometricChangeSensitivity, 0.0f, 1.0f);
+                float areaLerpFactor = glm::clamp(areaChange / cellSize * geometricChangeSensitivity, 0.0f, 1.0f);
                 float hysteresisDecreaseDueToAreaChange = glm::mix(0.0f, maxHysteresisDecrease, areaLerpFactor);
 
                 float luminanceLerpFactor = glm::clamp(
-                    std::max(perceptualPreviousLumianance, perceptualLumianance) / std::min(perceptualPreviousLumianance, perceptualLumianance), 
+                    luminanceChange / std::max(std::max(perceptualPreviousLumianance, perceptualLumianance), std::numeric_limits<float>::epsilon()),
                     0.0f, 1.0f);
                 float hysteresisDecreaseDueToLuminanceChange = glm::mix(0.0f, maxHysteresisDecrease, luminanceLerpFactor);
 
-                float movementLerpFactor = glm::clamp(distanceTravelled / ProbeField.GetCellSize() * geometricChangeSensitivity, 0.0f, 1.0f);
+                float movementLerpFactor = glm::clamp(distanceTravelled / cellSize * geometricChangeSensitivity, 0.0f, 1.0f);
                 float hysteresisDecreaseDueToMovement = glm::mix(0.0f, maxHysteresisDecrease, movementLerpFactor);
 
-                float lightHysteresisDecrease = std::max(hysteresisDecreaseDueToAreaChange, std::max(hysteresisDecreaseDueToLuminanceChange, hysteresisDecreaseDueToMovement));
+                float lightHysteresisDecrease = isNewInSlot ? maxHysteresisDecrease :
+                    std::max(hysteresisDecreaseDueToAreaChange, std::max(hysteresisDecreaseDueToLuminanceChange, hysteresisDecreaseDueToMovement));
+
+                // Distance at which point light of the same power gives threshold illuminance
+                float influenceRadius = std::sqrt(light.GetLuminousPower() / (4.0f * float(M_PI) * LightInfluenceIlluminanceThreshold));
+                float lightExtent = std::sqrt(light.GetArea()) * 0.5f;
+                Geometry::AABB lightAABB{ light.GetPosition() - lightExtent, light.GetPosition() + lightExtent };
 
-                irradianceHysteresisDecrease = std::max(irradianceHysteresisDecrease, lightHysteresisDecrease);
+                mProbeInvalidationGrid.RefitEntity(slot, lightAABB, influenceRadius, lightHysteresisDecrease, 0.0f);
+                ++slot;
             }
         };
 
-        computeHysteresisDecreaseForLights(mScene->GetSphericalLights());
-        computeHysteresisDecreaseForLights(mScene->GetRectangularLights());
-        computeHysteresisDecreaseForLights(mScene->GetDiskLights());
+        invalidateProbesForLights(mScene->GetSphericalLights());
+        invalidateProbesForLights(mScene->GetRectangularLights());
+        invalidateProbesForLights(mScene->GetDiskLights());
 
-        // Mesh instances
-        for (const MeshInstance& instance : mScene->GetMeshInstances())
-        {
-            const Geometry::AABB& aabb = instance.GetAssociatedMesh()->GetBoundingBox();
-            const Geometry::AABB previousAABB = aabb.TransformedBy(instance.GetPreviousTransformation());
-            const Geometry::AABB currentAABB = aabb.TransformedBy(instance.GetTransformation());
+        // Whole field is already converging, every probe has to be traced
+        bool isFieldInvalidated = ProbeField.GetIlluminanceHysteresisDecrease() > 0.0f || ProbeField.GetDepthHysteresisDecrease() > 0.0f;
 
-            float diagonalChange = std::abs(previousAABB.Diagonal() - currentAABB.Diagonal());
-            float distanceTravelled = glm::distance(instance.GetPreviousTransformation().GetTranslation(), instance.GetTransformation().GetTranslation());
+        mProbeInvalidationGrid.ScheduleProbeUpdates(ProbeField.GetStableProbeUpdateBudget(), isFieldInvalidated);
+    }
 
-            // The bigger the mesh, the more impact it has on indirect lighting
-            float importance = currentAABB.Diagonal() / ProbeField.GetCellSize();
+    IlluminanceField::IlluminanceField()
+    {
+        // Fine cascade keeps the detail around the camera, coarse one covers distant geometry
+        mCascades.emplace_back(glm::uvec3{ 20, 14, 20 }, 3.0f);
+        mCascades.emplace_back(glm::uvec3{ 16, 8, 16 }, 12.0f);
 
-            float diagonalLerpFactor = glm::clamp(diagonalChange / ProbeField.GetCellSize(), 0.0f, 1.0f);
-            // Movement weight depends on how large the object is in relation to probe grid
-            float movementLerpFactor = glm::clamp(distanceTravelled / ProbeField.GetCellSize() * importance, 0.0f, 1.0f);
+        assert_format(mCascades.size() <= MaxCascadeCount, "Too many illuminance field cascades");
 
-            float hysteresisDecreaseDueSizeChange = glm::mix(0.0f, maxHysteresisDecrease, diagonalLerpFactor);
-            float hysteresisDecreaseDueToMovement = glm::mix(0.0f, maxHysteresisDecrease, movementLerpFactor);
-
-            float hysteresisDecrease = std::max(hysteresisDecreaseDueSizeChange, hysteresisDecreaseDueToMovement);
+        uint64_t probeOffset = 0;
 
-            irradianceHysteresisDecrease = std::max(irradianceHysteresisDecrease, hysteresisDecrease);
-            depthHysteresisDecrease = std::max(depthHysteresisDecrease, hysteresisDecrease);
+        for (IlluminanceFieldCascade& cascade : mCascades)
+        {
+            cascade.SetProbeOffset(probeOffset);
+            probeOffset += cascade.ProbeCount();
         }
-
-        // The larger the hysteresis decrease, the larger the frame count that we must keep it
-        float irradianceDecreaseFrameDuration = glm::mix(0.0f, 10.0f, irradianceHysteresisDecrease / maxHysteresisDecrease);
-        float depthDecreaseFrameDuration = glm::mix(0.0f, 7.0f, depthHysteresisDecrease / maxHysteresisDecrease);
-
-        mIlluminanceHysteresisDecreseFrameCount = std::max(mIlluminanceHysteresisDecreseFrameCount, uint64_t(irradianceDecreaseFrameDuration));
-        irradianceHysteresisDecrease = std::max(irradianceHysteresisDecrease, ProbeField.GetIlluminanceHysteresisDecrease());
-
-        mDepthHysteresisDecreseFrameCount = std::max(mDepthHysteresisDecreseFrameCount, uint64_t(depthDecreaseFrameDuration));
-        depthHysteresisDecrease = std::max(depthHysteresisDecrease, ProbeField.GetDepthHysteresisDecrease());
-
-        // We stop decreasing hysteresis if there is no decrease this frame and we have no frames left
-        if (mIlluminanceHysteresisDecreseFrameCount == 0)
-            irradianceHysteresisDecrease = 0;    
-
-        if (mDepthHysteresisDecreseFrameCount == 0)
-            depthHysteresisDecrease = 0;
-
-        // Decrease frame count
-        if (mIlluminanceHysteresisDecreseFrameCount > 0)
-            mIlluminanceHysteresisDecreseFrameCount -= 1;
-
-        if (mDepthHysteresisDecreseFrameCount > 0)
-            mDepthHysteresisDecreseFrameCount -= 1;
-
-        ProbeField.SetIlluminanceHysteresisDecrease(irradianceHysteresisDecrease);
-        ProbeField.SetDepthHysteresisDecrease(depthHysteresisDecrease);
     }
 
     void IlluminanceField::GenerateProbeRotation(const glm::vec2& random0to1)
@@ -202,11 +282,9 @@ namespace PathFinder
         mProbeRotation = glm::lookAt(glm::zero<glm::vec3>(), viewDir, up);
     }
 
-    void IlluminanceField::SetCornerPosition(const glm::vec3& position)
+    void IlluminanceField::ScrollCascade(uint64_t cascadeIndex, const glm::vec3& cornerPosition)
     {
-        glm::vec3 distanceTravelled = position - mCornerPosition;
-        mSpawnedProbePlanesCount = distanceTravelled / mCellSize;
-        mCornerPosition = position;
+        mCascades[cascadeIndex].Scroll(cornerPosition);
     }
 
     void IlluminanceField::SetDebugProbeRadius(float radius)
@@ -279,11 +357,17 @@ namespace PathFinder
 
     glm::vec3 IlluminanceField::GetProbePosition(uint64_t probeIndex) const
     {
-        auto x = probeIndex % mProbeGridSize.x;
-        auto y = (probeIndex % (mProbeGridSize.x * mProbeGridSize.y)) / mProbeGridSize.x;
-        auto z = probeIndex / (mProbeGridSize.x * mProbeGridSize.y);
+        return mCascades[GetProbeCascadeIndex(probeIndex)].ProbePosition(probeIndex);
+    }
+
+    uint64_t IlluminanceField::GetProbeCascadeIndex(uint64_t probeIndex) const
+    {
+        uint64_t cascadeIndex = 0;
+
+        while (cascadeIndex + 1 < mCascades.size() && probeIndex >= mCascades[cascadeIndex + 1].GetProbeOffset())
+            ++cascadeIndex;
 
-        return glm::vec3{ float(x * mCellSize), float(y * mCellSize), float(z * mCellSize) } + mCornerPosition;
+        return cascadeIndex;
     }
 
     glm::uvec2 IlluminanceField::GetIlluminanceProbeAtlasProbesPerDimension() const
@@ -301,7 +385,13 @@ namespace PathFinder
 
     uint64_t IlluminanceField::GetTotalProbeCount() const
     {
-        return mProbeGridSize.x * mProbeGridSize.y * mProbeGridSize.z;
+        const IlluminanceFieldCascade& lastCascade = mCascades.back();
+        return lastCascade.GetProbeOffset() + lastCascade.ProbeCount();
+    }
+
+    uint64_t IlluminanceField::GetStableProbeUpdateBudget() const
+    {
+        return uint64_t(std::ceil(GetTotalProbeCount() * mStableProbeUpdateFraction));
     }
 
 }
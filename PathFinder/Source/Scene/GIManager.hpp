@@ -4,15 +4,24 @@
 #include <glm/mat4x4.hpp>
 #include <Geometry/Dimensions.hpp>
 
+#include "GIProbeInvalidationGrid.hpp"
+#include "IlluminanceFieldCascade.hpp"
+
+#include <vector>
+
 namespace PathFinder
 {
     class Scene;
 
+    /// Probe volumes of increasing cell size centered around the camera.
+    /// Probes of all cascades share atlases, each cascade owning a contiguous range of probe indices.
     class IlluminanceField
     {
     public:
+        IlluminanceField();
+
         void GenerateProbeRotation(const glm::vec2& random0to1);
-        void SetCornerPosition(const glm::vec3& position);
+        void ScrollCascade(uint64_t cascadeIndex, const glm::vec3& cornerPosition);
         void SetDebugProbeRadius(float radius);
         void SetIlluminanceHysteresisDecrease(float decrease);
         void SetDepthHysteresisDecrease(float decrease);
@@ -21,18 +30,18 @@ namespace PathFinder
         inline static const uint64_t IlluminanceProbeSize = 8; // Should less or equal to depth probe size
         inline static const uint64_t DepthProbeSize = 16;
 
-        // Should be power of 2
-        glm::uvec3 mProbeGridSize = glm::uvec3{ 20, 14, 20 };
-        float mCellSize = 3.0f;
+        std::vector<IlluminanceFieldCascade> mCascades;
         float mDebugProbeRadius = 0.3f;
         float mIlluminanceHysteresisDecrease = 0.5f; // Quickly update probes at application startup
         float mDepthHysteresisDecrease = 0.5f;
         uint64_t mRaysPerProbe = 256;
+        float mStableProbeUpdateFraction = 0.125f; // Share of probes without reported changes refreshed each frame
         glm::mat4 mProbeRotation{ 1.0f };
-        glm::vec3 mCornerPosition{ 0.0f };
-        glm::ivec3 mSpawnedProbePlanesCount;
 
     public:
+        // Must match the shader side
+        inline static const uint64_t MaxCascadeCount = 4;
+
         Geometry::Dimensions GetRayHitInfoTextureSize() const;
         Geometry::Dimensions GetIlluminanceProbeSize() const;
         Geometry::Dimensions GetIlluminanceProbeSizeWithBorder() const;
@@ -41,16 +50,15 @@ namespace PathFinder
         Geometry::Dimensions GetDepthProbeSizeWithBorder() const;
         Geometry::Dimensions GetDepthProbeAtlasSize() const;
         glm::vec3 GetProbePosition(uint64_t probeIndex) const;
+        uint64_t GetProbeCascadeIndex(uint64_t probeIndex) const;
         glm::uvec2 GetIlluminanceProbeAtlasProbesPerDimension() const;
         glm::uvec2 GetDepthProbeAtlasProbesPerDimension() const;
         uint64_t GetTotalRayCount() const;
         uint64_t GetTotalProbeCount() const;
+        uint64_t GetStableProbeUpdateBudget() const;
 
-        const glm::uvec3& GetGridSize() const { return mProbeGridSize; }
-        const glm::vec3& GetCornerPosition() const { return mCornerPosition; }
-        const glm::ivec3& GetSpawnedProbePlanesCount() const { return mSpawnedProbePlanesCount; }
+        const auto& GetCascades() const { return mCascades; }
         const auto GetRaysPerProbe() const { return mRaysPerProbe; }
-        const auto GetCellSize() const { return mCellSize; }
         const auto GetDebugProbeRadius() const { return mDebugProbeRadius; }
         const auto GetIlluminanceHysteresisDecrease() const { return mIlluminanceHysteresisDecrease; }
         const auto GetDepthHysteresisDecrease() const { return mDepthHysteresisDecrease; }
@@ -70,12 +78,21 @@ namespace PathFinder
         bool DoNotRotateProbeRays = false;
 
     private:
-        void UpdateGridCornerPosition();
+        void UpdateCascadePositions();
         void UpdateHysteresisDecrease();
+        void InvalidateProbes();
+
+        // Light is considered to affect probes until its illuminance falls below this value, in lux
+        inline static const float LightInfluenceIlluminanceThreshold = 1.0f;
 
         const Scene* mScene = nullptr;
+        GIProbeInvalidationGrid mProbeInvalidationGrid;
         uint64_t mIlluminanceHysteresisDecreseFrameCount = 10; // Quickly update probes at application startup
         uint64_t mDepthHysteresisDecreseFrameCount = 7; // Quickly update probes at application startup
+        uint64_t mFrameIndex = 0;
+
+    public:
+        inline const GIProbeInvalidationGrid& GetProbeInvalidationGrid() const { return mProbeInvalidationGrid; }
     };
 
 }
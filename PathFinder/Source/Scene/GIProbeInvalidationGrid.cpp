@@ -0,0 +1,415 @@
+#include "GIProbeInvalidationGrid.hpp"
+
+#include <Geometry/Transformation.hpp>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vector_relational.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <cmath>
+
+namespace PathFinder
+{
+
+    void GIProbeInvalidationGrid::BeginFrame(const std::vector<IlluminanceFieldCascade>& cascades)
+    {
+        bool isLayoutChanged = IsLayoutChanged(cascades);
+
+        mCascades = &cascades;
+        mInvalidatedProbeCount = 0;
+
+        if (isLayoutChanged)
+        {
+            uint64_t probeCount = 0;
+            mCascadeGridSizes.clear();
+            mCascadeCellSizes.clear();
+
+            for (const IlluminanceFieldCascade& cascade : cascades)
+            {
+                probeCount += cascade.ProbeCount();
+                mCascadeGridSizes.push_back(cascade.GetGridSize());
+                mCascadeCellSizes.push_back(cascade.GetCellSize());
+            }
+
+            // Cached entity footprints are in the old cell units, entities are refit as if they were new
+            mProbeStates.assign(probeCount, ProbeState{});
+            mEntityCells.assign(mEntityKeys.size() * cascades.size(), CellBox{});
+            mEntityKeys.assign(mEntityKeys.size(), NoEntity);
+            InvalidateAllProbes(MaxHysteresisDecrease, MaxHysteresisDecrease);
+            return;
+        }
+
+        // Probes that stayed inside a cascade keep their slots and states.
+        // Slots of newly exposed cells hold probes that left the cascade, they have no history and must be traced right away.
+        for (const IlluminanceFieldCascade& cascade : cascades)
+        {
+            for (const CellBox& slab : cascade.GetDirtySlabs())
+            {
+                for (int32_t z = slab.Min.z; z <= slab.Max.z; ++z)
+                {
+                    for (int32_t y = slab.Min.y; y <= slab.Max.y; ++y)
+                    {
+                        for (int32_t x = slab.Min.x; x <= slab.Max.x; ++x)
+                        {
+                            ProbeState& state = mProbeStates[cascade.ProbeIndex({ x, y, z })];
+                            state = ProbeState{};
+                            InvalidateProbe(state, MaxHysteresisDecrease, MaxHysteresisDecrease);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void GIProbeInvalidationGrid::InvalidateAllProbes(float illuminanceDecrease, float depthDecrease)
+    {
+        for (ProbeState& state : mProbeStates)
+        {
+            InvalidateProbe(state, illuminanceDecrease, depthDecrease);
+        }
+    }
+
+    void GIProbeInvalidationGrid::ResizeEntitySlots(uint64_t slotCount)
+    {
+        uint64_t cascadeCount = mCascades->size();
+
+        // Entities of dropped slots were removed or took other slots
+        for (uint64_t slot = slotCount; slot < mEntityKeys.size(); ++slot)
+        {
+            for (uint64_t cascadeIndex = 0; cascadeIndex < cascadeCount; ++cascadeIndex)
+            {
+                InvalidateCells((*mCascades)[cascadeIndex], mEntityCells[slot * cascadeCount + cascadeIndex], MaxHysteresisDecrease, MaxHysteresisDecrease);
+            }
+        }
+
+        mEntityKeys.resize(slotCount, NoEntity);
+        mEntityCells.resize(slotCount * cascadeCount, CellBox{});
+    }
+
+    bool GIProbeInvalidationGrid::AssignEntity(uint64_t slot, uint64_t key)
+    {
+        if (mEntityKeys[slot] == key)
+            return false;
+
+        mEntityKeys[slot] = key;
+        return true;
+    }
+
+    void GIProbeInvalidationGrid::RefitEntity(uint64_t slot, const Geometry::AABB& bounds, float margin, float illuminanceDecrease, float depthDecrease)
+    {
+        bool isChanged = illuminanceDecrease > 0.0f || depthDecrease > 0.0f;
+
+        for (uint64_t cascadeIndex = 0; cascadeIndex < mCascades->size(); ++cascadeIndex)
+        {
+            const IlluminanceFieldCascade& cascade = (*mCascades)[cascadeIndex];
+            CellBox& cachedCells = mEntityCells[slot * mCascades->size() + cascadeIndex];
+            CellBox cells = CellBoxFromBounds(cascade, bounds, margin);
+
+            if (isChanged)
+            {
+                // Lighting changes where the entity was as well as where it is now
+                InvalidateCells(cascade, cachedCells, illuminanceDecrease, depthDecrease);
+
+                if (cells.Min != cachedCells.Min || cells.Max != cachedCells.Max)
+                    InvalidateCells(cascade, cells, illuminanceDecrease, depthDecrease);
+            }
+
+            cachedCells = cells;
+        }
+    }
+
+    void GIProbeInvalidationGrid::ScheduleProbeUpdates(uint64_t stableProbeBudget, bool scheduleAllProbes)
+    {
+        mScheduledProbes.clear();
+        mStableProbes.clear();
+        mInvalidatedProbeCount = 0;
+
+        for (uint32_t probeIndex = 0; probeIndex < mProbeStates.size(); ++probeIndex)
+        {
+            ProbeState& state = mProbeStates[probeIndex];
+
+            // Decrease is kept for as many frames as the largest invalidation requested
+            if (state.IlluminanceDecreaseFrameCount == 0) state.IlluminanceHysteresisDecrease = 0.0f;
+            else --state.IlluminanceDecreaseFrameCount;
+
+            if (state.DepthDecreaseFrameCount == 0) state.DepthHysteresisDecrease = 0.0f;
+            else --state.DepthDecreaseFrameCount;
+
+            float decrease = std::max(state.IlluminanceHysteresisDecrease, state.DepthHysteresisDecrease);
+
+            if (decrease > 0.0f)
+            {
+                // Invalidated probes always outrank stable ones
+                state.UpdatePriority = 1.0f + decrease / MaxHysteresisDecrease;
+                mScheduledProbes.push_back(probeIndex);
+                ++mInvalidatedProbeCount;
+            }
+            else
+            {
+                state.UpdatePriority = 1.0f - 1.0f / (1.0f + state.FramesSinceUpdate);
+
+                if (scheduleAllProbes) mScheduledProbes.push_back(probeIndex);
+                else mStableProbes.push_back(probeIndex);
+            }
+        }
+
+        // Stable probes are refreshed in round robin to pick up changes nobody reported, e.g. material edits
+        if (mStableProbes.size() > stableProbeBudget)
+        {
+            auto isStaler = [this](uint32_t left, uint32_t right)
+            {
+                uint16_t leftAge = mProbeStates[left].FramesSinceUpdate;
+                uint16_t rightAge = mProbeStates[right].FramesSinceUpdate;
+                return leftAge != rightAge ? leftAge > rightAge : left < right;
+            };
+
+            std::nth_element(mStableProbes.begin(), mStableProbes.begin() + stableProbeBudget, mStableProbes.end(), isStaler);
+            mStableProbes.resize(stableProbeBudget);
+        }
+
+        mScheduledProbes.insert(mScheduledProbes.end(), mStableProbes.begin(), mStableProbes.end());
+
+        for (ProbeState& state : mProbeStates)
+        {
+            if (state.FramesSinceUpdate < std::numeric_limits<uint16_t>::max())
+                ++state.FramesSinceUpdate;
+        }
+
+        for (uint32_t probeIndex : mScheduledProbes)
+        {
+            mProbeStates[probeIndex].FramesSinceUpdate = 0;
+        }
+
+        // Sorted list keeps neighbouring probes in neighbouring dispatch groups
+        std::sort(mScheduledProbes.begin(), mScheduledProbes.end());
+    }
+
+    GIProbeInvalidationGrid::CellBox GIProbeInvalidationGrid::CellBoxFromBounds(const IlluminanceFieldCascade& cascade, const Geometry::AABB& bounds, float margin) const
+    {
+        // A probe contributes to points closer than a cell along each axis,
+        // so probes at cell corners around the bounds are the ones affected
+        CellBox cells;
+        cells.Min = glm::ivec3{ glm::floor((bounds.GetMin() - margin) / cascade.GetCellSize()) };
+        cells.Max = glm::ivec3{ glm::ceil((bounds.GetMax() + margin) / cascade.GetCellSize()) };
+        return cells;
+    }
+
+    void GIProbeInvalidationGrid::InvalidateCells(const IlluminanceFieldCascade& cascade, const CellBox& cells, float illuminanceDecrease, float depthDecrease)
+    {
+        // Cells are in world space, cascade only covers a part of them
+        CellBox cascadeCells = cascade.GetCellBox();
+        glm::ivec3 min = glm::max(cells.Min, cascadeCells.Min);
+        glm::ivec3 max = glm::min(cells.Max, cascadeCells.Max);
+
+        for (int32_t z = min.z; z <= max.z; ++z)
+        {
+            for (int32_t y = min.y; y <= max.y; ++y)
+            {
+                for (int32_t x = min.x; x <= max.x; ++x)
+                {
+                    InvalidateProbe(mProbeStates[cascade.ProbeIndex({ x, y, z })], illuminanceDecrease, depthDecrease);
+                }
+            }
+        }
+    }
+
+    void GIProbeInvalidationGrid::InvalidateProbe(ProbeState& state, float illuminanceDecrease, float depthDecrease)
+    {
+        // The larger the hysteresis decrease, the larger the frame count that we must keep it
+        uint8_t illuminanceFrameCount = uint8_t(glm::mix(0.0f, IlluminanceDecreaseMaxFrameCount, illuminanceDecrease / MaxHysteresisDecrease));
+        uint8_t depthFrameCount = uint8_t(glm::mix(0.0f, DepthDecreaseMaxFrameCount, depthDecrease / MaxHysteresisDecrease));
+
+        state.IlluminanceHysteresisDecrease = std::max(state.IlluminanceHysteresisDecrease, illuminanceDecrease);
+        state.DepthHysteresisDecrease = std::max(state.DepthHysteresisDecrease, depthDecrease);
+        state.IlluminanceDecreaseFrameCount = std::max(state.IlluminanceDecreaseFrameCount, illuminanceFrameCount);
+        state.DepthDecreaseFrameCount = std::max(state.DepthDecreaseFrameCount, depthFrameCount);
+    }
+
+    bool GIProbeInvalidationGrid::IsLayoutChanged(const std::vector<IlluminanceFieldCascade>& cascades) const
+    {
+        if (cascades.size() != mCascadeGridSizes.size())
+            return true;
+
+        for (uint64_t cascadeIndex = 0; cascadeIndex < cascades.size(); ++cascadeIndex)
+        {
+            if (cascades[cascadeIndex].GetGridSize() != mCascadeGridSizes[cascadeIndex] ||
+                cascades[cascadeIndex].GetCellSize() != mCascadeCellSizes[cascadeIndex])
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool GIProbeInvalidationGrid::RunBenchmark(const std::filesystem::path& reportPath)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        struct DynamicObject
+        {
+            Geometry::AABB LocalBounds;
+            Geometry::Transformation PreviousTransformation;
+            Geometry::Transformation Transformation;
+        };
+
+        struct Scenario
+        {
+            uint64_t ObjectCount;
+            float MovingFraction;
+        };
+
+        // Same layout as the finest cascade of the default illuminance field
+        const glm::uvec3 GridSize{ 20, 14, 20 };
+        const float CellSize = 3.0f;
+        const glm::vec3 CornerPosition = -glm::vec3{ GridSize } * CellSize * 0.5f;
+        const uint64_t ProbeCount = uint64_t(GridSize.x) * GridSize.y * GridSize.z;
+
+        // Field stays in place, objects move
+        std::vector<IlluminanceFieldCascade> cascades = { { GridSize, CellSize } };
+        const uint64_t RaysPerProbe = 256;
+        const uint64_t StableProbeBudget = ProbeCount / 8;
+        const uint64_t FrameCount = 300;
+
+        // Longer than any invalidation is kept for
+        const uint64_t WarmUpFrameCount = 16;
+
+        std::vector<Scenario> scenarios = { { 1024, 0.01f }, { 1024, 0.1f }, { 4096, 0.01f }, { 4096, 0.1f }, { 16384, 0.01f }, { 16384, 0.1f } };
+
+        std::ofstream stream{ reportPath, std::ios::out | std::ios::trunc };
+
+        if (!stream.is_open())
+            return false;
+
+        stream.precision(6);
+        stream << "{\"units\":\"milliseconds\",\"probes\":" << ProbeCount << ",\"raysPerProbe\":" << RaysPerProbe << ",\"results\":[\n";
+
+        for (uint64_t scenarioIndex = 0; scenarioIndex < scenarios.size(); ++scenarioIndex)
+        {
+            const Scenario& scenario = scenarios[scenarioIndex];
+
+            std::mt19937 randomEngine{ 12345 };
+            std::uniform_real_distribution<float> positionDistribution{ 0.0f, 1.0f };
+            std::uniform_real_distribution<float> extentDistribution{ 0.1f, 1.5f };
+            std::uniform_real_distribution<float> stepDistribution{ -0.3f, 0.3f };
+            std::bernoulli_distribution movementDistribution{ scenario.MovingFraction };
+
+            std::vector<DynamicObject> objects(scenario.ObjectCount);
+
+            for (DynamicObject& object : objects)
+            {
+                glm::vec3 extent{ extentDistribution(randomEngine), extentDistribution(randomEngine), extentDistribution(randomEngine) };
+                glm::vec3 position = CornerPosition + glm::vec3{ positionDistribution(randomEngine), positionDistribution(randomEngine), positionDistribution(randomEngine) } * glm::vec3{ GridSize } * CellSize;
+
+                object.LocalBounds = Geometry::AABB{ -extent, extent };
+                object.Transformation = Geometry::Transformation{ glm::vec3{ 1.0f }, position, glm::quat{} };
+                object.PreviousTransformation = object.Transformation;
+            }
+
+            GIProbeInvalidationGrid grid;
+
+            double wholeFieldTime = 0.0;
+            double perProbeTime = 0.0;
+            double invalidatedProbes = 0.0;
+            double scheduledProbes = 0.0;
+
+            // Warm up frame lets initial invalidation settle and caches footprints of all objects
+            cascades.front().Reset();
+            cascades.front().Scroll(CornerPosition);
+            grid.BeginFrame(cascades);
+            grid.ResizeEntitySlots(objects.size());
+
+            for (uint64_t slot = 0; slot < objects.size(); ++slot)
+            {
+                grid.AssignEntity(slot, slot);
+                Geometry::AABB bounds = objects[slot].LocalBounds.TransformedBy(objects[slot].Transformation);
+                grid.RefitEntity(slot, bounds, std::min(bounds.Diagonal() * 0.5f, CellSize), 0.0f, 0.0f);
+            }
+
+            for (uint64_t frame = 0; frame < WarmUpFrameCount; ++frame)
+            {
+                grid.ScheduleProbeUpdates(StableProbeBudget, false);
+            }
+
+            for (uint64_t frame = 0; frame < FrameCount; ++frame)
+            {
+                for (DynamicObject& object : objects)
+                {
+                    object.PreviousTransformation = object.Transformation;
+
+                    if (movementDistribution(randomEngine))
+                    {
+                        glm::vec3 step{ stepDistribution(randomEngine), stepDistribution(randomEngine), stepDistribution(randomEngine) };
+                        object.Transformation.SetTranslation(object.Transformation.GetTranslation() + step);
+                    }
+                }
+
+                // Whole field invalidation transforms bounds of every object to find out whether anything changed
+                Clock::time_point wholeFieldStart = Clock::now();
+                float wholeFieldDecrease = 0.0f;
+
+                for (const DynamicObject& object : objects)
+                {
+                    Geometry::AABB previousBounds = object.LocalBounds.TransformedBy(object.PreviousTransformation);
+                    Geometry::AABB currentBounds = object.LocalBounds.TransformedBy(object.Transformation);
+                    float distanceTravelled = glm::distance(object.PreviousTransformation.GetTranslation(), object.Transformation.GetTranslation());
+                    float diagonalChange = std::abs(previousBounds.Diagonal() - currentBounds.Diagonal());
+                    float lerpFactor = glm::clamp((distanceTravelled + diagonalChange) / CellSize, 0.0f, 1.0f);
+                    wholeFieldDecrease = std::max(wholeFieldDecrease, lerpFactor * MaxHysteresisDecrease);
+                }
+
+                wholeFieldTime += std::chrono::duration<double, std::milli>(Clock::now() - wholeFieldStart).count();
+
+                // Per probe invalidation only touches objects that changed
+                Clock::time_point perProbeStart = Clock::now();
+
+                cascades.front().Scroll(CornerPosition);
+                grid.BeginFrame(cascades);
+
+                for (uint64_t slot = 0; slot < objects.size(); ++slot)
+                {
+                    const DynamicObject& object = objects[slot];
+
+                    if (object.Transformation.GetTranslation() == object.PreviousTransformation.GetTranslation())
+                        continue;
+
+                    float distanceTravelled = glm::distance(object.PreviousTransformation.GetTranslation(), object.Transformation.GetTranslation());
+                    float decrease = glm::clamp(distanceTravelled / CellSize, 0.0f, 1.0f) * MaxHysteresisDecrease;
+
+                    // Same margin mesh instances get in GI manager
+                    Geometry::AABB bounds = object.LocalBounds.TransformedBy(object.Transformation);
+                    grid.RefitEntity(slot, bounds, std::min(bounds.Diagonal() * 0.5f, CellSize), decrease, decrease);
+                }
+
+                grid.ScheduleProbeUpdates(StableProbeBudget, false);
+
+                perProbeTime += std::chrono::duration<double, std::milli>(Clock::now() - perProbeStart).count();
+
+                invalidatedProbes += grid.InvalidatedProbeCount();
+                scheduledProbes += grid.ScheduledProbes().size();
+            }
+
+            double meanScheduledProbes = scheduledProbes / FrameCount;
+
+            stream << (scenarioIndex == 0 ? "" : ",\n") << "{\"objects\":" << scenario.ObjectCount
+                << ",\"movingFraction\":" << scenario.MovingFraction
+                << ",\"wholeFieldMeanTime\":" << wholeFieldTime / FrameCount
+                << ",\"perProbeMeanTime\":" << perProbeTime / FrameCount
+                << ",\"meanInvalidatedProbes\":" << invalidatedProbes / FrameCount
+                << ",\"meanScheduledProbes\":" << meanScheduledProbes
+                << ",\"wholeFieldRays\":" << ProbeCount * RaysPerProbe
+                << ",\"perProbeMeanRays\":" << meanScheduledProbes * RaysPerProbe
+                << ",\"rayReduction\":" << 1.0 - meanScheduledProbes / ProbeCount << "}";
+        }
+
+        stream << "]}\n";
+
+        return stream.good();
+    }
+
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "IlluminanceFieldCascade.hpp"
+
+#include <Geometry/AABB.hpp>
+
+#include <glm/vec3.hpp>
+#include <vector>
+#include <limits>
+#include <filesystem>
+
+namespace PathFinder
+{
+
+    /// Routes geometry and lighting changes to illuminance field probes they affect.
+    /// Grid cells coincide with probe cells of each field cascade and are addressed in world space, so cells
+    /// that tracked entities covered last time stay valid when cascades scroll with the camera.
+    /// Produces per probe hysteresis decrease and the list of probes to trace this frame.
+    class GIProbeInvalidationGrid
+    {
+    public:
+        struct ProbeState
+        {
+            float IlluminanceHysteresisDecrease = 0.0f;
+            float DepthHysteresisDecrease = 0.0f;
+            float UpdatePriority = 0.0f;
+            uint8_t IlluminanceDecreaseFrameCount = 0;
+            uint8_t DepthDecreaseFrameCount = 0;
+            uint16_t FramesSinceUpdate = 0;
+        };
+
+        // Follows scrolled cascades and resets states of probes in their newly exposed slabs.
+        // Cascades must stay alive until the next frame begins.
+        void BeginFrame(const std::vector<IlluminanceFieldCascade>& cascades);
+
+        void InvalidateAllProbes(float illuminanceDecrease, float depthDecrease);
+
+        // Probes around last footprints of entities in dropped slots are invalidated
+        void ResizeEntitySlots(uint64_t slotCount);
+
+        // Entities are identified by keys that stay the same while they live, such as handles or addresses.
+        // Returns true if the slot held a different entity before, in which case the entity must be refit.
+        // Refit invalidates probes around footprints of both the previous and the new occupant.
+        bool AssignEntity(uint64_t slot, uint64_t key);
+
+        // Invalidates probes of every cascade that interpolate lighting around both previous and current entity footprint,
+        // footprint being the bounds expanded by the margin
+        void RefitEntity(uint64_t slot, const Geometry::AABB& bounds, float margin, float illuminanceDecrease, float depthDecrease);
+
+        // Schedules every invalidated probe and the least recently updated stable ones within the budget
+        void ScheduleProbeUpdates(uint64_t stableProbeBudget, bool scheduleAllProbes);
+
+        // Simulates thousands of dynamic objects and compares routing changes to probes with whole field invalidation
+        static bool RunBenchmark(const std::filesystem::path& reportPath);
+
+        inline static const float MaxHysteresisDecrease = 0.5f;
+        inline static const uint64_t NoEntity = std::numeric_limits<uint64_t>::max();
+
+    private:
+        inline static const float IlluminanceDecreaseMaxFrameCount = 10.0f;
+        inline static const float DepthDecreaseMaxFrameCount = 7.0f;
+
+        using CellBox = IlluminanceFieldCascade::CellBox;
+
+        CellBox CellBoxFromBounds(const IlluminanceFieldCascade& cascade, const Geometry::AABB& bounds, float margin) const;
+        void InvalidateCells(const IlluminanceFieldCascade& cascade, const CellBox& cells, float illuminanceDecrease, float depthDecrease);
+        void InvalidateProbe(ProbeState& state, float illuminanceDecrease, float depthDecrease);
+        bool IsLayoutChanged(const std::vector<IlluminanceFieldCascade>& cascades) const;
+
+        const std::vector<IlluminanceFieldCascade>* mCascades = nullptr;
+        std::vector<glm::uvec3> mCascadeGridSizes;
+        std::vector<float> mCascadeCellSizes;
+        std::vector<ProbeState> mProbeStates;
+
+        // Footprints of every entity in cells of each cascade, cascade count entries per entity
+        std::vector<CellBox> mEntityCells;
+        std::vector<uint64_t> mEntityKeys;
+        std::vector<uint32_t> mScheduledProbes;
+        std::vector<uint32_t> mStableProbes;
+        uint64_t mInvalidatedProbeCount = 0;
+
+    public:
+        inline const auto& ProbeStates() const { return mProbeStates; }
+        inline const auto& ScheduledProbes() const { return mScheduledProbes; }
+        inline auto InvalidatedProbeCount() const { return mInvalidatedProbeCount; }
+    };
+
+}
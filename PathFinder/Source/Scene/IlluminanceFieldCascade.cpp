@@ -0,0 +1,227 @@
+#include "IlluminanceFieldCascade.hpp"
+
+#include <glm/common.hpp>
+#include <glm/vector_relational.hpp>
+#include <glm/trigonometric.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <cmath>
+
+namespace PathFinder
+{
+
+    uint64_t IlluminanceFieldCascade::CellBox::CellCount() const
+    {
+        if (glm::any(glm::lessThan(Max, Min)))
+            return 0;
+
+        glm::ivec3 extent = Max - Min + 1;
+        return uint64_t(extent.x) * extent.y * extent.z;
+    }
+
+    IlluminanceFieldCascade::IlluminanceFieldCascade(const glm::uvec3& gridSize, float cellSize)
+        : mGridSize{ gridSize }, mCellSize{ cellSize } {}
+
+    void IlluminanceFieldCascade::Scroll(const glm::vec3& cornerPosition)
+    {
+        mPreviousCornerCell = mCornerCell;
+        mCornerCell = glm::ivec3{ glm::round(cornerPosition / mCellSize) };
+        mDirtySlabs.clear();
+
+        glm::ivec3 displacement = mCornerCell - mPreviousCornerCell;
+        CellBox remainingBox = GetCellBox();
+        CellBox previousBox{ mPreviousCornerCell, mPreviousCornerCell + glm::ivec3{ mGridSize } - 1 };
+
+        // Nothing to keep when the volume moved further than its size
+        if (mIsReset || glm::any(glm::greaterThanEqual(glm::abs(displacement), glm::ivec3{ mGridSize })))
+        {
+            mDirtySlabs.push_back(remainingBox);
+            mIsReset = false;
+            return;
+        }
+
+        // Exposed region is split into at most 3 disjoint slabs, one per axis of movement.
+        // Each slab is cut off the remaining box so that later slabs don't overlap earlier ones.
+        for (auto axis = 0; axis < 3; ++axis)
+        {
+            if (displacement[axis] == 0)
+                continue;
+
+            CellBox slab = remainingBox;
+
+            if (displacement[axis] > 0)
+            {
+                slab.Min[axis] = previousBox.Max[axis] + 1;
+                remainingBox.Max[axis] = previousBox.Max[axis];
+            }
+            else
+            {
+                slab.Max[axis] = previousBox.Min[axis] - 1;
+                remainingBox.Min[axis] = previousBox.Min[axis];
+            }
+
+            mDirtySlabs.push_back(slab);
+        }
+    }
+
+    void IlluminanceFieldCascade::Reset()
+    {
+        mIsReset = true;
+    }
+
+    bool IlluminanceFieldCascade::ContainsCell(const glm::ivec3& cell) const
+    {
+        return glm::all(glm::greaterThanEqual(cell, mCornerCell)) &&
+            glm::all(glm::lessThan(cell, mCornerCell + glm::ivec3{ mGridSize }));
+    }
+
+    uint64_t IlluminanceFieldCascade::ProbeIndex(const glm::ivec3& cell) const
+    {
+        glm::ivec3 slot = WrapCell(cell);
+        return mProbeOffset + slot.x + slot.y * mGridSize.x + uint64_t(slot.z) * mGridSize.x * mGridSize.y;
+    }
+
+    glm::ivec3 IlluminanceFieldCascade::ProbeCell(uint64_t probeIndex) const
+    {
+        uint64_t localIndex = probeIndex - mProbeOffset;
+
+        glm::ivec3 slot{
+            localIndex % mGridSize.x,
+            (localIndex % (mGridSize.x * mGridSize.y)) / mGridSize.x,
+            localIndex / (mGridSize.x * mGridSize.y)
+        };
+
+        // Slot of the corner cell is where the volume starts in the wrapped storage
+        return mCornerCell + WrapCell(slot - WrapCell(mCornerCell));
+    }
+
+    glm::vec3 IlluminanceFieldCascade::ProbePosition(uint64_t probeIndex) const
+    {
+        return glm::vec3{ ProbeCell(probeIndex) } * mCellSize;
+    }
+
+    uint64_t IlluminanceFieldCascade::ProbeCount() const
+    {
+        return uint64_t(mGridSize.x) * mGridSize.y * mGridSize.z;
+    }
+
+    uint64_t IlluminanceFieldCascade::DirtyProbeCount() const
+    {
+        uint64_t count = 0;
+
+        for (const CellBox& slab : mDirtySlabs)
+        {
+            count += slab.CellCount();
+        }
+
+        return count;
+    }
+
+    glm::ivec3 IlluminanceFieldCascade::WrapCell(const glm::ivec3& cell) const
+    {
+        glm::ivec3 size{ mGridSize };
+        return ((cell % size) + size) % size;
+    }
+
+    bool IlluminanceFieldCascade::RunBenchmark(const std::filesystem::path& reportPath)
+    {
+        struct Sweep
+        {
+            std::string Name;
+            float Speed; // Meters per second
+        };
+
+        struct CascadeStatistics
+        {
+            uint64_t ScrollFrameCount = 0;
+            uint64_t DirtyProbeCount = 0;
+            uint64_t MaxDirtyProbeCount = 0;
+        };
+
+        const uint64_t FrameCount = 600;
+        const float FrameTime = 1.0f / 60.0f;
+
+        // Teleports happen with this period in the teleport sweep
+        const uint64_t TeleportPeriod = 120;
+
+        std::vector<Sweep> sweeps = {
+            { "walk", 1.5f }, { "run_diagonal", 6.0f }, { "vehicle", 40.0f }, { "orbit", 15.0f }, { "teleport", 1.5f }
+        };
+
+        std::ofstream stream{ reportPath, std::ios::out | std::ios::trunc };
+
+        if (!stream.is_open())
+            return false;
+
+        stream.precision(6);
+        stream << "{\"frames\":" << FrameCount << ",\"sweeps\":[\n";
+
+        for (uint64_t sweepIndex = 0; sweepIndex < sweeps.size(); ++sweepIndex)
+        {
+            const Sweep& sweep = sweeps[sweepIndex];
+
+            // Same layout as the default illuminance field
+            std::vector<IlluminanceFieldCascade> cascades = { { { 20, 14, 20 }, 3.0f }, { { 16, 8, 16 }, 12.0f } };
+            std::vector<CascadeStatistics> statistics(cascades.size());
+
+            for (uint64_t frame = 0; frame < FrameCount; ++frame)
+            {
+                float time = frame * FrameTime;
+                glm::vec3 cameraPosition{ 0.0f, 2.0f, 0.0f };
+
+                if (sweep.Name == "walk") cameraPosition.x += sweep.Speed * time;
+                else if (sweep.Name == "run_diagonal") cameraPosition += glm::vec3{ 1.0f, 0.1f, 1.0f } * sweep.Speed * time / std::sqrt(2.01f);
+                else if (sweep.Name == "vehicle") cameraPosition.z += sweep.Speed * time;
+                else if (sweep.Name == "orbit") cameraPosition += glm::vec3{ std::cos(time * 0.5f), 0.0f, std::sin(time * 0.5f) } * (sweep.Speed / 0.5f);
+                else if (sweep.Name == "teleport") cameraPosition.x += sweep.Speed * time + 500.0f * float(frame / TeleportPeriod);
+
+                for (uint64_t cascadeIndex = 0; cascadeIndex < cascades.size(); ++cascadeIndex)
+                {
+                    IlluminanceFieldCascade& cascade = cascades[cascadeIndex];
+                    CascadeStatistics& cascadeStatistics = statistics[cascadeIndex];
+
+                    cascade.Scroll(cameraPosition - glm::vec3{ cascade.GetGridSize() } * cascade.GetCellSize() * 0.5f);
+
+                    // First frame fills the whole volume and is not a scroll
+                    if (frame == 0)
+                        continue;
+
+                    uint64_t dirtyProbeCount = cascade.DirtyProbeCount();
+
+                    cascadeStatistics.DirtyProbeCount += dirtyProbeCount;
+                    cascadeStatistics.MaxDirtyProbeCount = std::max(cascadeStatistics.MaxDirtyProbeCount, dirtyProbeCount);
+
+                    if (dirtyProbeCount > 0)
+                        ++cascadeStatistics.ScrollFrameCount;
+                }
+            }
+
+            stream << (sweepIndex == 0 ? "" : ",\n") << "{\"name\":\"" << sweep.Name << "\",\"speed\":" << sweep.Speed << ",\"cascades\":[";
+
+            for (uint64_t cascadeIndex = 0; cascadeIndex < cascades.size(); ++cascadeIndex)
+            {
+                const IlluminanceFieldCascade& cascade = cascades[cascadeIndex];
+                const CascadeStatistics& cascadeStatistics = statistics[cascadeIndex];
+                uint64_t scrollFrameCount = std::max(cascadeStatistics.ScrollFrameCount, uint64_t(1));
+
+                // Shifting the whole field, as a non-toroidal layout does, moves every probe on each scroll
+                stream << (cascadeIndex == 0 ? "" : ",") << "{\"cellSize\":" << cascade.GetCellSize()
+                    << ",\"probes\":" << cascade.ProbeCount()
+                    << ",\"scrollFrames\":" << cascadeStatistics.ScrollFrameCount
+                    << ",\"meanInvalidatedProbesPerFrame\":" << double(cascadeStatistics.DirtyProbeCount) / (FrameCount - 1)
+                    << ",\"meanInvalidatedProbesPerScroll\":" << double(cascadeStatistics.DirtyProbeCount) / scrollFrameCount
+                    << ",\"maxInvalidatedProbesPerFrame\":" << cascadeStatistics.MaxDirtyProbeCount
+                    << ",\"shiftedProbesPerScroll\":" << cascade.ProbeCount() << "}";
+            }
+
+            stream << "]}";
+        }
+
+        stream << "]}\n";
+
+        return stream.good();
+    }
+
+}
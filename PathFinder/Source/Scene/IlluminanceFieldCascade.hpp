@@ -0,0 +1,74 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+#include <vector>
+#include <filesystem>
+
+namespace PathFinder
+{
+
+    /// Probe volume of a single illuminance field level that follows the camera.
+    /// Probes are addressed toroidally: a probe's slot is its world cell wrapped by the grid size,
+    /// so probes that stay inside the volume when it scrolls keep their slots and their history,
+    /// and only slabs of newly exposed cells need to be traced from scratch.
+    class IlluminanceFieldCascade
+    {
+    public:
+        // Inclusive range of world space probe cells
+        struct CellBox
+        {
+            glm::ivec3 Min{ 0 };
+            glm::ivec3 Max{ -1 };
+
+            uint64_t CellCount() const;
+        };
+
+        IlluminanceFieldCascade(const glm::uvec3& gridSize, float cellSize);
+
+        // Moves the volume so that its first probe is at the snapped corner position
+        // and computes slabs of cells that were not covered by the volume before the move
+        void Scroll(const glm::vec3& cornerPosition);
+
+        // Makes the whole volume dirty on the next scroll
+        void Reset();
+
+        bool ContainsCell(const glm::ivec3& cell) const;
+
+        // Field-wide probe index of a cell inside the volume
+        uint64_t ProbeIndex(const glm::ivec3& cell) const;
+
+        // Inverse of ProbeIndex for indices in [ProbeOffset, ProbeOffset + ProbeCount)
+        glm::ivec3 ProbeCell(uint64_t probeIndex) const;
+        glm::vec3 ProbePosition(uint64_t probeIndex) const;
+
+        uint64_t ProbeCount() const;
+        uint64_t DirtyProbeCount() const;
+
+        // Sweeps cascades with a simulated camera and reports how many probes get invalidated per frame
+        static bool RunBenchmark(const std::filesystem::path& reportPath);
+
+    private:
+        glm::ivec3 WrapCell(const glm::ivec3& cell) const;
+
+        glm::uvec3 mGridSize;
+        float mCellSize;
+        glm::ivec3 mCornerCell{ 0 };
+        glm::ivec3 mPreviousCornerCell{ 0 };
+        uint64_t mProbeOffset = 0;
+        std::vector<CellBox> mDirtySlabs;
+        bool mIsReset = true;
+
+    public:
+        inline void SetProbeOffset(uint64_t offset) { mProbeOffset = offset; }
+
+        inline const glm::uvec3& GetGridSize() const { return mGridSize; }
+        inline float GetCellSize() const { return mCellSize; }
+        inline const glm::ivec3& GetCornerCell() const { return mCornerCell; }
+        inline const glm::ivec3& GetPreviousCornerCell() const { return mPreviousCornerCell; }
+        inline glm::vec3 GetCornerPosition() const { return glm::vec3{ mCornerCell } * mCellSize; }
+        inline uint64_t GetProbeOffset() const { return mProbeOffset; }
+        inline const auto& GetDirtySlabs() const { return mDirtySlabs; }
+        inline CellBox GetCellBox() const { return { mCornerCell, mCornerCell + glm::ivec3{ mGridSize } - 1 }; }
+    };
+
+}
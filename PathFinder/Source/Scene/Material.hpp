@@ -60,6 +60,8 @@ namespace PathFinder
 
         std::string Name;
         uint32_t GPUMaterialTableIndex = 0;
+        // Sum of texture relocations at the time material table entry was written
+        uint64_t GPUTextureRelocationCount = 0;
 
         template <typename S>
         void serialize(S& s)
@@ -1,6 +1,7 @@
 #include "MaterialLoader.hpp"
 
 #include <glm/gtc/type_precision.hpp>
+#include <glm/gtc/packing.hpp>
 
 namespace PathFinder
 {
@@ -32,9 +33,26 @@ namespace PathFinder
         loadTexture(material.DisplacementMap);
         loadTexture(material.DistanceField);
 
+        if (!material.DistanceField.Texture && material.DisplacementMap.Texture)
+            BakeDistanceField(material);
+
+        // Displacement stays uncompressed: parallax and distance field baking need full height precision
+        CompressTexture(material.DiffuseAlbedoMap, TextureCompressor::ContentType::Color);
+        CompressTexture(material.SpecularAlbedoMap, TextureCompressor::ContentType::Color);
+        CompressTexture(material.NormalMap, TextureCompressor::ContentType::Normal);
+        CompressTexture(material.RoughnessMap, TextureCompressor::ContentType::Data);
+        CompressTexture(material.MetalnessMap, TextureCompressor::ContentType::Data);
+        CompressTexture(material.TranslucencyMap, TextureCompressor::ContentType::Data);
+
         SetCommonMaterialTextures(material);
     }
 
+    void MaterialLoader::SetTextureCompressionQuality(std::optional<TextureCompressor::Quality> quality)
+    {
+        mTextureCompressionQuality = quality;
+        mTextureCompressor = TextureCompressor{ quality.value_or(TextureCompressor::Quality::Normal) };
+    }
+
     void MaterialLoader::SetCommonMaterialTextures(Material& material)
     {
         if (!material.DiffuseAlbedoMap.Texture)
@@ -70,6 +88,244 @@ namespace PathFinder
         material.LTC_LUT_Terms_Diffuse = mLTC_LUT_Terms_DisneyDiffuseNormalized.get();
     }
 
+    void MaterialLoader::BakeDistanceField(Material& material)
+    {
+        std::optional<DisplacementDistanceFieldBaker::HeightField> heightField = ExtractHeightField(material.DisplacementMap);
+
+        if (!heightField)
+            return;
+
+        uint64_t inputHash = DisplacementDistanceFieldBaker::InputHash(*heightField, DistanceFieldTextureSize);
+        std::filesystem::path cachePath = material.DisplacementMap.FilePath;
+        cachePath.replace_extension(".pfdistfield");
+
+        std::optional<std::vector<uint32_t>> packedField = DisplacementDistanceFieldBaker::LoadCache(cachePath, inputHash, DistanceFieldTextureSize);
+
+        if (!packedField)
+        {
+            packedField = mDistanceFieldBaker.Bake(*heightField, DistanceFieldTextureSize);
+            // Failing to write the cache only costs a rebake next time
+            DisplacementDistanceFieldBaker::SaveCache(cachePath, inputHash, DistanceFieldTextureSize, *packedField);
+        }
+
+        HAL::TextureProperties properties{
+            HAL::ColorFormat::RGBA32_Unsigned, HAL::TextureKind::Texture3D,
+            DistanceFieldTextureSize, HAL::ResourceState::AnyShaderAccess };
+
+        material.DistanceField.Texture = mResourceProducer->NewTexture(properties);
+        material.DistanceField.Texture->SetDebugName(material.Name + " Distance Field");
+
+        // Rows of RGBA32 texels at this width already satisfy row pitch alignment, so packed field matches texture footprint as is
+        uint64_t byteCount = packedField->size() * sizeof(uint32_t);
+        assert_format(byteCount == material.DistanceField.Texture->Footprint().TotalSizeInBytes(), "Baked distance field does not match texture footprint");
+
+        // Keep the blob so that the baked field is serialized along with other material textures
+        material.DistanceField.RowMajorBlob.resize(byteCount);
+        std::memcpy(material.DistanceField.RowMajorBlob.data(), packedField->data(), byteCount);
+
+        material.DistanceField.Texture->RequestWrite();
+        material.DistanceField.Texture->Write(material.DistanceField.RowMajorBlob.data(), 0, byteCount);
+    }
+
+    std::optional<DisplacementDistanceFieldBaker::HeightField> MaterialLoader::ExtractHeightField(const Material::TextureData& displacementMap) const
+    {
+        std::optional<TextureCompressor::Image> image = DecodeImage(displacementMap);
+
+        if (!image)
+            return std::nullopt;
+
+        DisplacementDistanceFieldBaker::HeightField heightField{ image->Width, image->Height };
+        heightField.Heights.reserve(image->Texels.size());
+
+        for (const glm::vec4& texel : image->Texels)
+        {
+            heightField.Heights.push_back(texel.r);
+        }
+
+        return heightField;
+    }
+
+    void MaterialLoader::CompressTexture(Material::TextureData& textureData, TextureCompressor::ContentType contentType)
+    {
+        if (!mTextureCompressionQuality || !textureData.Texture)
+            return;
+
+        std::optional<TextureCompressor::Image> image = DecodeImage(textureData);
+
+        if (!image || !TextureCompressor::IsCompressible(image->Width, image->Height))
+            return;
+
+        const HAL::ColorFormat* sourceFormat = std::get_if<HAL::ColorFormat>(&textureData.Texture->Properties().Format);
+
+        bool isHDRSource = sourceFormat && (
+            *sourceFormat == HAL::ColorFormat::RGBA16_Float ||
+            *sourceFormat == HAL::ColorFormat::R32_Float ||
+            *sourceFormat == HAL::ColorFormat::RGBA32_Float);
+
+        if (contentType == TextureCompressor::ContentType::Color && isHDRSource)
+            contentType = TextureCompressor::ContentType::HDRColor;
+
+        TextureCompressor::BlockFormat blockFormat = TextureCompressor::BlockFormat::BC4;
+        HAL::ColorFormat compressedFormat = HAL::ColorFormat::BC4_Unsigned_Norm;
+
+        switch (contentType)
+        {
+        case TextureCompressor::ContentType::Color:
+            // Alpha is not sampled from color maps, so fast preset can afford 4 bits per texel
+            blockFormat = *mTextureCompressionQuality == TextureCompressor::Quality::Fast ? TextureCompressor::BlockFormat::BC1 : TextureCompressor::BlockFormat::BC7;
+            compressedFormat = *mTextureCompressionQuality == TextureCompressor::Quality::Fast ? HAL::ColorFormat::BC1_Unsigned_Norm : HAL::ColorFormat::BC7_Unsigned_Norm;
+            break;
+
+        case TextureCompressor::ContentType::HDRColor:
+            blockFormat = TextureCompressor::BlockFormat::BC6H;
+            compressedFormat = HAL::ColorFormat::BC6H_Unsigned_Float;
+            break;
+
+        case TextureCompressor::ContentType::Normal:
+            blockFormat = TextureCompressor::BlockFormat::BC5;
+            compressedFormat = HAL::ColorFormat::BC5_Unsigned_Norm;
+            break;
+
+        default:
+            break;
+        }
+
+        uint64_t inputHash = TextureCompressor::InputHash(*image, blockFormat, contentType, *mTextureCompressionQuality);
+        std::filesystem::path cachePath = textureData.FilePath;
+        cachePath.replace_extension(std::string{ "." } + TextureCompressor::FormatName(blockFormat) + ".pfbc");
+
+        std::optional<TextureCompressor::CompressedTexture> compressed = TextureCompressor::LoadCache(cachePath, inputHash);
+
+        if (!compressed)
+        {
+            compressed = mTextureCompressor.Compress(*image, blockFormat, contentType, true);
+            // Failing to write the cache only costs a recompression next time
+            TextureCompressor::SaveCache(cachePath, inputHash, *compressed);
+        }
+
+        HAL::TextureProperties properties{
+            compressedFormat, HAL::TextureKind::Texture2D, Geometry::Dimensions{ image->Width, image->Height },
+            HAL::ResourceState::AnyShaderAccess, uint32_t(compressed->Mips.size()) };
+
+        Memory::GPUResourceProducer::TexturePtr texture = mResourceProducer->NewTexture(properties);
+        std::vector<uint8_t> blob(texture->Footprint().TotalSizeInBytes(), 0);
+        uint64_t blockSize = TextureCompressor::BlockSizeInBytes(blockFormat);
+
+        // Compressed mips are tightly packed while texture rows of blocks are pitch aligned
+        for (uint32_t mipIndex = 0; mipIndex < compressed->Mips.size(); ++mipIndex)
+        {
+            const TextureCompressor::CompressedMip& mip = compressed->Mips[mipIndex];
+            const HAL::SubresourceFootprint& mipFootprint = texture->Footprint().GetSubresourceFootprint(mipIndex);
+
+            uint64_t rowSize = ((mip.Width + 3) / 4) * blockSize;
+            uint64_t rowCount = (mip.Height + 3) / 4;
+
+            for (uint64_t row = 0; row < rowCount; ++row)
+            {
+                std::memcpy(blob.data() + mipFootprint.Offset() + row * mipFootprint.RowPitch(), mip.Blocks.data() + row * rowSize, rowSize);
+            }
+        }
+
+        texture->RequestWrite();
+        texture->Write(blob.data(), 0, blob.size());
+
+        // Uncompressed texture is released here, blob goes to material data in place of the uncompressed one
+        textureData.Texture = std::move(texture);
+        textureData.RowMajorBlob = std::move(blob);
+    }
+
+    std::optional<TextureCompressor::Image> MaterialLoader::DecodeImage(const Material::TextureData& textureData) const
+    {
+        if (textureData.RowMajorBlob.empty())
+            return std::nullopt;
+
+        const HAL::TextureProperties& properties = textureData.Texture->Properties();
+        const HAL::ColorFormat* format = std::get_if<HAL::ColorFormat>(&properties.Format);
+
+        if (!format || properties.Kind != HAL::TextureKind::Texture2D)
+            return std::nullopt;
+
+        uint64_t texelSize = 0;
+
+        switch (*format)
+        {
+        case HAL::ColorFormat::R8_Unsigned_Norm: texelSize = 1; break;
+        case HAL::ColorFormat::RG8_Usigned_Norm: texelSize = 2; break;
+        case HAL::ColorFormat::RGBA8_Unsigned_Norm: texelSize = 4; break;
+        case HAL::ColorFormat::BGRA8_Unsigned_Norm: texelSize = 4; break;
+        case HAL::ColorFormat::R16_Unsigned: texelSize = 2; break;
+        case HAL::ColorFormat::RGBA16_Float: texelSize = 8; break;
+        case HAL::ColorFormat::R32_Float: texelSize = 4; break;
+        case HAL::ColorFormat::RGBA32_Float: texelSize = 16; break;
+        default: return std::nullopt;
+        }
+
+        const HAL::SubresourceFootprint& footprint = textureData.Texture->Footprint().GetSubresourceFootprint(0);
+
+        TextureCompressor::Image image{ properties.Dimensions.Width, properties.Dimensions.Height };
+        image.Texels.resize(image.Width * image.Height);
+
+        for (uint64_t y = 0; y < image.Height; ++y)
+        {
+            const uint8_t* row = textureData.RowMajorBlob.data() + footprint.Offset() + y * footprint.RowPitch();
+
+            for (uint64_t x = 0; x < image.Width; ++x)
+            {
+                const uint8_t* texel = row + x * texelSize;
+                glm::vec4& decoded = image.Texels[y * image.Width + x];
+
+                switch (*format)
+                {
+                case HAL::ColorFormat::R8_Unsigned_Norm:
+                    decoded = glm::vec4{ glm::vec3{ texel[0] / 255.0f }, 1.0f };
+                    break;
+
+                case HAL::ColorFormat::RG8_Usigned_Norm:
+                    decoded = glm::vec4{ texel[0] / 255.0f, texel[1] / 255.0f, 0.0f, 1.0f };
+                    break;
+
+                case HAL::ColorFormat::RGBA8_Unsigned_Norm:
+                    decoded = glm::vec4{ texel[0], texel[1], texel[2], texel[3] } / 255.0f;
+                    break;
+
+                case HAL::ColorFormat::BGRA8_Unsigned_Norm:
+                    decoded = glm::vec4{ texel[2], texel[1], texel[0], texel[3] } / 255.0f;
+                    break;
+
+                case HAL::ColorFormat::R16_Unsigned:
+                {
+                    uint16_t value;
+                    std::memcpy(&value, texel, sizeof(value));
+                    decoded = glm::vec4{ glm::vec3{ value / 65535.0f }, 1.0f };
+                    break;
+                }
+
+                case HAL::ColorFormat::RGBA16_Float:
+                {
+                    uint64_t value;
+                    std::memcpy(&value, texel, sizeof(value));
+                    decoded = glm::unpackHalf4x16(value);
+                    break;
+                }
+
+                case HAL::ColorFormat::R32_Float:
+                {
+                    float value;
+                    std::memcpy(&value, texel, sizeof(value));
+                    decoded = glm::vec4{ glm::vec3{ value }, 1.0f };
+                    break;
+                }
+
+                default:
+                    std::memcpy(&decoded, texel, sizeof(decoded));
+                    break;
+                }
+            }
+        }
+
+        return image;
+    }
+
     void MaterialLoader::CreateDefaultTextures()
     {
         HAL::TextureProperties dummy2DTextureProperties{
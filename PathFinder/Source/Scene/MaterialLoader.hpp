@@ -2,6 +2,8 @@
 
 #include "Material.hpp"
 #include "ResourceLoader.hpp"
+#include "DisplacementDistanceFieldBaker.hpp"
+#include "TextureCompressor.hpp"
 
 #include <HardwareAbstractionLayer/Buffer.hpp>
 #include <Memory/GPUResourceProducer.hpp>
@@ -17,15 +19,32 @@ namespace PathFinder
     class MaterialLoader
     {
     public:
+        inline static const Geometry::Dimensions DistanceFieldTextureSize{ 128, 128, 64 };
+
         MaterialLoader(const std::filesystem::path& executableFolderPath, Memory::GPUResourceProducer* resourceProducer);
 
         void LoadMaterial(Material& material);
         void SetCommonMaterialTextures(Material& material);
 
+        // Uncompressed textures are block compressed on load when quality is set, which is off by default
+        void SetTextureCompressionQuality(std::optional<TextureCompressor::Quality> quality);
+
     private:
         Memory::Texture* GetOrAllocateTexture(const std::string& materialName, const std::filesystem::path& texturePath);
         Memory::Texture* AllocateAndStoreTexture(const HAL::TextureProperties& properties, const std::string& cacheKey);
 
+        // Bakes distance field for materials that have a displacement map but no precomputed distance field.
+        // Baked fields are cached next to the displacement map and reused while the map is unchanged.
+        void BakeDistanceField(Material& material);
+        std::optional<DisplacementDistanceFieldBaker::HeightField> ExtractHeightField(const Material::TextureData& displacementMap) const;
+
+        // Replaces an uncompressed texture with a block compressed one with a full mip chain.
+        // Compressed data is cached next to the source texture and reused while the source is unchanged.
+        void CompressTexture(Material::TextureData& textureData, TextureCompressor::ContentType contentType);
+
+        // Top mip of an uncompressed texture as float texels, empty for unsupported formats
+        std::optional<TextureCompressor::Image> DecodeImage(const Material::TextureData& textureData) const;
+
         void CreateDefaultTextures();
         void LoadLTCLookupTables(const std::filesystem::path& executableFolderPath);
 
@@ -43,6 +62,9 @@ namespace PathFinder
 
         Memory::GPUResourceProducer* mResourceProducer;
         ResourceLoader mResourceLoader;
+        DisplacementDistanceFieldBaker mDistanceFieldBaker;
+        TextureCompressor mTextureCompressor;
+        std::optional<TextureCompressor::Quality> mTextureCompressionQuality;
     };
 
 }
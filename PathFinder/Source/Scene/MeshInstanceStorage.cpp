@@ -0,0 +1,494 @@
+#include "MeshInstanceStorage.hpp"
+
+#include <Foundation/TaskScheduler.hpp>
+
+#include <list>
+#include <random>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+
+namespace PathFinder
+{
+
+    MeshInstanceHandle MeshInstanceStorage::Add(Mesh* mesh, Material* material, TransformHierarchy::NodeId parent)
+    {
+        MeshInstanceHandle handle = mHandles.Insert();
+
+        mMeshes.push_back(mesh);
+        mMaterials.push_back(material);
+        mNodes.push_back(mHierarchy.AddNode(Geometry::Transformation{}, parent));
+        mWorldBounds.push_back(mesh->GetBoundingBox());
+        mPreviousWorldBounds.push_back(mWorldBounds.back());
+        mGPUTableIndices.push_back(0);
+        mFlags.push_back(MeshInstanceFlags::None);
+
+        return handle;
+    }
+
+    void MeshInstanceStorage::Remove(MeshInstanceHandle handle)
+    {
+        mHierarchy.RemoveNode(mNodes[Index(handle)]);
+
+        Foundation::HandleTable::Erasure erasure = mHandles.Erase(handle);
+
+        Foundation::EraseFromArrays(erasure,
+            mMeshes, mMaterials, mNodes, mWorldBounds, mPreviousWorldBounds, mGPUTableIndices, mFlags);
+    }
+
+    void MeshInstanceStorage::Clear()
+    {
+        mHandles.Clear();
+        mHierarchy.Clear();
+        mMeshes.clear();
+        mMaterials.clear();
+        mNodes.clear();
+        mWorldBounds.clear();
+        mPreviousWorldBounds.clear();
+        mGPUTableIndices.clear();
+        mFlags.clear();
+    }
+
+    std::vector<MeshInstanceStorage::Record> MeshInstanceStorage::ExportRecords() const
+    {
+        std::vector<Record> records(Size());
+
+        for (uint32_t index = 0; index < Size(); ++index)
+        {
+            Record& record = records[index];
+            record.AssociatedMesh = mMeshes[index];
+            record.AssociatedMaterial = mMaterials[index];
+            record.IsSelected = HasFlag(index, MeshInstanceFlags::Selected);
+            record.IsHighlighted = HasFlag(index, MeshInstanceFlags::Highlighted);
+            record.PreviousTransform = Geometry::Transformation{ PreviousWorldMatrix(index) };
+            record.Transform = Geometry::Transformation{ WorldMatrix(index) };
+        }
+
+        return records;
+    }
+
+    void MeshInstanceStorage::ImportRecords(const std::vector<Record>& records)
+    {
+        Clear();
+
+        for (const Record& record : records)
+        {
+            MeshInstanceHandle handle = Add(record.AssociatedMesh, record.AssociatedMaterial);
+
+            SetFlag(handle, MeshInstanceFlags::Selected, record.IsSelected);
+            SetFlag(handle, MeshInstanceFlags::Highlighted, record.IsHighlighted);
+            SetTransformation(handle, record.Transform);
+        }
+
+        UpdateTransforms();
+    }
+
+    void MeshInstanceStorage::SetTransformation(MeshInstanceHandle handle, const Geometry::Transformation& transform)
+    {
+        mHierarchy.SetLocalTransform(mNodes[Index(handle)], transform);
+    }
+
+    void MeshInstanceStorage::SetWorldMatrix(MeshInstanceHandle handle, const glm::mat4& worldMatrix)
+    {
+        TransformHierarchy::NodeId node = mNodes[Index(handle)];
+        TransformHierarchy::NodeId parent = mHierarchy.Parent(node);
+
+        if (parent == TransformHierarchy::NoParent)
+        {
+            mHierarchy.SetLocalTransform(node, Geometry::Transformation{ worldMatrix });
+        }
+        else
+        {
+            mHierarchy.SetLocalTransform(node, Geometry::Transformation{ glm::inverse(mHierarchy.WorldMatrix(parent)) * worldMatrix });
+        }
+    }
+
+    void MeshInstanceStorage::SetMaterial(MeshInstanceHandle handle, Material* material)
+    {
+        mMaterials[Index(handle)] = material;
+    }
+
+    void MeshInstanceStorage::SetFlag(MeshInstanceHandle handle, MeshInstanceFlags flag, bool enabled)
+    {
+        MeshInstanceFlags& flags = mFlags[Index(handle)];
+        flags = enabled ? flags | flag : EnumMaskRemoveBit(flags, flag);
+    }
+
+    bool MeshInstanceStorage::HasFlag(uint32_t index, MeshInstanceFlags flag) const
+    {
+        return EnumMaskEquals(mFlags[index], flag);
+    }
+
+    void MeshInstanceStorage::UpdateTransforms()
+    {
+        mHierarchy.Update();
+
+        if (mHierarchy.LastUpdatedNodeCount() == 0)
+            return;
+
+        Foundation::TaskScheduler::SharedInstance().ParallelFor(Size(), 4096, [this](uint64_t first, uint64_t last)
+        {
+            for (uint64_t index = first; index < last; ++index)
+            {
+                TransformHierarchy::NodeId node = mNodes[index];
+
+                if (!mHierarchy.HasChanged(node))
+                    continue;
+
+                const Geometry::AABB& bounds = mMeshes[index]->GetBoundingBox();
+                mWorldBounds[index] = bounds.TransformedBy(mHierarchy.WorldMatrix(node));
+                // Matches world bounds for instances composed for the first time
+                mPreviousWorldBounds[index] = bounds.TransformedBy(mHierarchy.PreviousWorldMatrix(node));
+            }
+        },
+        "MeshInstanceStorage::UpdateTransforms");
+    }
+
+    void MeshInstanceStorage::UpdatePreviousFrameValues()
+    {
+        Foundation::TaskScheduler::SharedInstance().ParallelFor(Size(), 4096, [this](uint64_t first, uint64_t last)
+        {
+            for (uint64_t index = first; index < last; ++index)
+            {
+                if (mHierarchy.HasChanged(mNodes[index]))
+                    mPreviousWorldBounds[index] = mWorldBounds[index];
+            }
+        },
+        "MeshInstanceStorage::UpdatePreviousFrameValues");
+
+        mHierarchy.UpdatePreviousFrameValues();
+    }
+
+    bool MeshInstanceStorage::HasChanged(uint32_t index) const
+    {
+        return mHierarchy.HasChanged(mNodes[index]);
+    }
+
+    bool MeshInstanceStorage::RunBenchmark(const std::filesystem::path& reportPath)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        const uint32_t InstanceCounts[] = { 1000, 10000, 100000 };
+        const uint32_t MeshCount = 64;
+        const uint32_t FrameCount = 16;
+        // Every N-th instance is moved each frame, the rest stays static the way most of a scene does
+        const uint32_t MovedInstanceStride = 10;
+
+        std::ofstream stream{ reportPath, std::ios::out | std::ios::trunc };
+
+        if (!stream.is_open())
+            return false;
+
+        // Instances the way scenes stored them before: one heap node per instance
+        struct ListInstance
+        {
+            Mesh* AssociatedMesh;
+            Material* AssociatedMaterial;
+            bool IsSelected;
+            bool IsHighlighted;
+            bool IsDoubleSided;
+            Geometry::Transformation Transform;
+            Geometry::Transformation PreviousTransform;
+            uint32_t IndexInGPUTable;
+        };
+
+        // What GPU instance table upload extracts from every instance
+        struct GPUEntry
+        {
+            glm::mat4 World;
+            glm::mat4 PreviousWorld;
+            glm::mat4 Normal;
+            uint32_t VertexBufferOffset;
+            uint32_t IndexBufferOffset;
+            uint32_t IndexCount;
+        };
+
+        std::mt19937 generator{ 12345 };
+        std::uniform_real_distribution<float> distribution{ -100.0f, 100.0f };
+
+        auto randomTransform = [&]
+        {
+            glm::vec3 axis = glm::normalize(glm::vec3{ distribution(generator), distribution(generator), distribution(generator) } + 0.001f);
+            glm::vec3 scale{ 1.0f + std::abs(distribution(generator)) * 0.01f };
+            glm::vec3 translation{ distribution(generator), distribution(generator), distribution(generator) };
+            return Geometry::Transformation{ scale, translation, glm::angleAxis(distribution(generator) * 0.01f, axis) };
+        };
+
+        std::vector<Mesh> meshes(MeshCount);
+
+        for (uint32_t meshIdx = 0; meshIdx < MeshCount; ++meshIdx)
+        {
+            for (uint32_t vertexIdx = 0; vertexIdx < 3; ++vertexIdx)
+            {
+                Vertex1P1N1UV1T1BT vertex{};
+                vertex.Position = glm::vec4{ distribution(generator), distribution(generator), distribution(generator), 1.0f } * 0.05f;
+                meshes[meshIdx].AddVertex(vertex);
+            }
+
+            meshes[meshIdx].SetVertexStorageLocation({ meshIdx * 3, 3, meshIdx * 3, 3, 0 });
+        }
+
+        auto gpuEntry = [](const Geometry::Transformation& transform, const Geometry::Transformation& previousTransform, const Mesh& mesh)
+        {
+            const VertexStorageLocation& location = mesh.GetLocationInVertexStorage();
+            return GPUEntry{ transform.GetMatrix(), previousTransform.GetMatrix(), transform.GetNormalMatrix(), location.VertexBufferOffset, location.IndexBufferOffset, location.IndexCount };
+        };
+
+        auto isStatic = [](const Geometry::Transformation& transform, const Geometry::Transformation& previousTransform)
+        {
+            return transform.GetTranslation() == previousTransform.GetTranslation() &&
+                transform.GetRotation() == previousTransform.GetRotation() &&
+                transform.GetScale() == previousTransform.GetScale();
+        };
+
+        bool isValid = true;
+
+        stream.precision(6);
+        stream << "{\"frames\":" << FrameCount << ",\"movedInstanceStride\":" << MovedInstanceStride << ",\"unit\":\"ms/frame\",\"scenes\":[\n";
+
+        for (uint32_t countIdx = 0; countIdx < std::size(InstanceCounts); ++countIdx)
+        {
+            uint32_t instanceCount = InstanceCounts[countIdx];
+
+            std::vector<uint32_t> meshIndices(instanceCount);
+            std::vector<Geometry::Transformation> initialTransforms(instanceCount);
+            std::vector<std::vector<Geometry::Transformation>> frameTransforms(FrameCount, std::vector<Geometry::Transformation>(instanceCount / MovedInstanceStride));
+
+            for (uint32_t instanceIdx = 0; instanceIdx < instanceCount; ++instanceIdx)
+            {
+                meshIndices[instanceIdx] = generator() % MeshCount;
+                initialTransforms[instanceIdx] = randomTransform();
+            }
+
+            for (auto& transforms : frameTransforms)
+            {
+                std::generate(transforms.begin(), transforms.end(), randomTransform);
+            }
+
+            std::list<ListInstance> list;
+            MeshInstanceStorage storage;
+            std::vector<MeshInstanceHandle> handles;
+
+            for (uint32_t instanceIdx = 0; instanceIdx < instanceCount; ++instanceIdx)
+            {
+                Mesh* mesh = &meshes[meshIndices[instanceIdx]];
+                list.push_back({ mesh, nullptr, false, false, false, initialTransforms[instanceIdx], initialTransforms[instanceIdx], 0 });
+                handles.push_back(storage.Add(mesh, nullptr));
+                storage.SetTransformation(handles.back(), initialTransforms[instanceIdx]);
+            }
+
+            std::vector<GPUEntry> gpuEntries(instanceCount);
+            std::vector<ListInstance*> listGPUMappings(instanceCount);
+            std::vector<MeshInstanceHandle> storageGPUMappings(instanceCount);
+
+            // Same passes scene update runs each frame: animation, GI invalidation, GPU table upload,
+            // GPU index mapping and previous frame values
+            auto runListFrame = [&](std::list<ListInstance>& instances, std::vector<ListInstance*>& movedInstances, uint32_t frame)
+            {
+                double checksum = 0.0;
+
+                for (uint64_t movedIdx = 0; movedIdx < movedInstances.size(); ++movedIdx)
+                {
+                    movedInstances[movedIdx]->Transform = frameTransforms[frame][movedIdx];
+                }
+
+                for (const ListInstance& instance : instances)
+                {
+                    if (isStatic(instance.Transform, instance.PreviousTransform))
+                        continue;
+
+                    const Geometry::AABB& aabb = instance.AssociatedMesh->GetBoundingBox();
+                    checksum += std::abs(aabb.TransformedBy(instance.PreviousTransform).Diagonal() - aabb.TransformedBy(instance.Transform).Diagonal());
+                }
+
+                uint32_t gpuIndex = 0;
+
+                for (ListInstance& instance : instances)
+                {
+                    instance.IndexInGPUTable = gpuIndex;
+                    gpuEntries[gpuIndex] = gpuEntry(instance.Transform, instance.PreviousTransform, *instance.AssociatedMesh);
+                    checksum += gpuEntries[gpuIndex].World[3][0];
+                    ++gpuIndex;
+                }
+
+                for (ListInstance& instance : instances)
+                {
+                    listGPUMappings[instance.IndexInGPUTable] = &instance;
+                }
+
+                for (ListInstance& instance : instances)
+                {
+                    instance.PreviousTransform = instance.Transform;
+                }
+
+                return checksum;
+            };
+
+            auto runStorageFrame = [&](uint32_t frame)
+            {
+                double checksum = 0.0;
+
+                for (uint64_t movedIdx = 0; movedIdx < frameTransforms[frame].size(); ++movedIdx)
+                {
+                    storage.SetTransformation(handles[movedIdx * MovedInstanceStride], frameTransforms[frame][movedIdx]);
+                }
+
+                storage.UpdateTransforms();
+
+                const std::vector<Mesh*>& instanceMeshes = storage.Meshes();
+                std::vector<uint32_t>& gpuIndices = storage.GPUTableIndices();
+
+                for (uint32_t index = 0; index < storage.Size(); ++index)
+                {
+                    if (!storage.HasChanged(index))
+                        continue;
+
+                    checksum += std::abs(storage.PreviousWorldBounds()[index].Diagonal() - storage.WorldBounds()[index].Diagonal());
+                }
+
+                for (uint32_t index = 0; index < storage.Size(); ++index)
+                {
+                    const VertexStorageLocation& location = instanceMeshes[index]->GetLocationInVertexStorage();
+                    gpuIndices[index] = index;
+                    gpuEntries[index] = GPUEntry{ storage.WorldMatrix(index), storage.PreviousWorldMatrix(index), storage.NormalMatrix(index),
+                        location.VertexBufferOffset, location.IndexBufferOffset, location.IndexCount };
+                    checksum += gpuEntries[index].World[3][0];
+                }
+
+                for (uint32_t index = 0; index < storage.Size(); ++index)
+                {
+                    storageGPUMappings[gpuIndices[index]] = storage.HandleAt(index);
+                }
+
+                storage.UpdatePreviousFrameValues();
+
+                return checksum;
+            };
+
+            std::vector<ListInstance*> listInstances;
+            std::vector<ListInstance*> listMovedInstances;
+
+            for (ListInstance& instance : list)
+            {
+                if (listInstances.size() % MovedInstanceStride == 0)
+                    listMovedInstances.push_back(&instance);
+
+                listInstances.push_back(&instance);
+            }
+
+            // Every measurement starts from the initial placement
+            auto measure = [&](auto&& runFrame)
+            {
+                for (uint32_t instanceIdx = 0; instanceIdx < instanceCount; ++instanceIdx)
+                {
+                    listInstances[instanceIdx]->Transform = initialTransforms[instanceIdx];
+                    listInstances[instanceIdx]->PreviousTransform = initialTransforms[instanceIdx];
+                    storage.SetTransformation(handles[instanceIdx], initialTransforms[instanceIdx]);
+                }
+
+                storage.UpdateTransforms();
+                storage.UpdatePreviousFrameValues();
+
+                double checksum = 0.0;
+                auto start = Clock::now();
+
+                for (uint32_t frame = 0; frame < FrameCount; ++frame)
+                {
+                    checksum += runFrame(frame);
+                }
+
+                double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / FrameCount;
+                return std::make_pair(milliseconds, checksum);
+            };
+
+            auto [listTime, listChecksum] = measure([&](uint32_t frame) { return runListFrame(list, listMovedInstances, frame); });
+            auto [storageTime, storageChecksum] = measure(runStorageFrame);
+
+            // Edited scenes do not keep list nodes in allocation order: relink them in random order
+            std::vector<std::list<ListInstance>::iterator> nodes;
+
+            for (auto it = list.begin(); it != list.end(); ++it)
+            {
+                nodes.push_back(it);
+            }
+
+            std::shuffle(nodes.begin(), nodes.end(), generator);
+
+            for (auto node : nodes)
+            {
+                list.splice(list.end(), list, node);
+            }
+
+            auto [shuffledListTime, shuffledListChecksum] = measure([&](uint32_t frame) { return runListFrame(list, listMovedInstances, frame); });
+
+            // Same frames over the same data must produce the same results
+            double tolerance = 1e-6 * std::max(1.0, std::abs(listChecksum));
+            bool doChecksumsMatch =
+                std::abs(listChecksum - storageChecksum) <= tolerance &&
+                std::abs(listChecksum - shuffledListChecksum) <= tolerance;
+
+            isValid &= doChecksumsMatch;
+
+            // Removal by swap and pop followed by additions reusing slots: live handles keep resolving
+            // to their own instances, handles to removed ones are rejected
+            std::vector<uint32_t> handleMeshIndices(instanceCount);
+            std::vector<bool> isRemoved(instanceCount, false);
+
+            for (uint32_t instanceIdx = 0; instanceIdx < instanceCount; ++instanceIdx)
+            {
+                handleMeshIndices[instanceIdx] = meshIndices[instanceIdx];
+            }
+
+            auto churnStart = Clock::now();
+
+            for (uint32_t instanceIdx = 0; instanceIdx < instanceCount; instanceIdx += 3)
+            {
+                storage.Remove(handles[instanceIdx]);
+                isRemoved[instanceIdx] = true;
+            }
+
+            uint32_t removedCount = (instanceCount + 2) / 3;
+
+            for (uint32_t addedIdx = 0; addedIdx < removedCount; ++addedIdx)
+            {
+                uint32_t meshIdx = addedIdx % MeshCount;
+                handles.push_back(storage.Add(&meshes[meshIdx], nullptr));
+                handleMeshIndices.push_back(meshIdx);
+                isRemoved.push_back(false);
+            }
+
+            double churnMicroseconds = std::chrono::duration<double, std::micro>(Clock::now() - churnStart).count() / (removedCount * 2);
+
+            bool areHandlesConsistent = storage.Size() == instanceCount;
+
+            for (uint64_t handleIdx = 0; handleIdx < handles.size(); ++handleIdx)
+            {
+                if (isRemoved[handleIdx])
+                {
+                    areHandlesConsistent &= !storage.Contains(handles[handleIdx]);
+                }
+                else
+                {
+                    areHandlesConsistent &= storage.Contains(handles[handleIdx]) &&
+                        storage.GetMesh(handles[handleIdx]) == &meshes[handleMeshIndices[handleIdx]] &&
+                        storage.HandleAt(storage.Index(handles[handleIdx])) == handles[handleIdx];
+                }
+            }
+
+            isValid &= areHandlesConsistent;
+
+            stream << (countIdx == 0 ? "" : ",\n") << "{\"instances\":" << instanceCount
+                << ",\"list\":" << listTime << ",\"shuffledList\":" << shuffledListTime
+                << ",\"storage\":" << storageTime
+                << ",\"speedup\":" << listTime / storageTime << ",\"shuffledSpeedup\":" << shuffledListTime / storageTime
+                << ",\"addRemoveMicroseconds\":" << churnMicroseconds
+                << ",\"checksumsMatch\":" << (doChecksumsMatch ? "true" : "false")
+                << ",\"handlesConsistent\":" << (areHandlesConsistent ? "true" : "false") << "}";
+        }
+
+        stream << "\n],\"valid\":" << (isValid ? "true" : "false") << "}\n";
+
+        return isValid && stream.good();
+    }
+
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "Mesh.hpp"
+#include "TransformHierarchy.hpp"
+
+#include <Foundation/HandleTable.hpp>
+#include <Foundation/BitwiseEnum.hpp>
+#include <Geometry/Transformation.hpp>
+#include <Geometry/AABB.hpp>
+#include <bitsery/bitsery.h>
+#include <bitsery/ext/pointer.h>
+#include <Utility/SerializationAdapters.hpp>
+
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+
+namespace PathFinder
+{
+
+    class Material;
+
+    using MeshInstanceHandle = Foundation::Handle;
+
+    enum class MeshInstanceFlags : uint8_t
+    {
+        None = 0, DoubleSided = 1 << 0, Selected = 1 << 1, Highlighted = 1 << 2
+    };
+
+    /// Mesh instances kept as one dense array per component.
+    /// Handles survive removal of other instances, dense indices do not:
+    /// removal moves the last instance into the removed one's place.
+    /// Per-frame passes walk the arrays by dense index and touch only the components they need.
+    /// Every instance owns a node of the transform hierarchy, so instances can be attached to each other
+    /// or to nodes of an imported scene graph.
+    class MeshInstanceStorage
+    {
+    public:
+        /// Instance as it is written to scene files.
+        /// Field order matches the list of instances scenes used to store, so older scene files still load.
+        /// Transforms are world space: hierarchy is flattened on export.
+        struct Record
+        {
+            Mesh* AssociatedMesh = nullptr;
+            Material* AssociatedMaterial = nullptr;
+            bool IsSelected = false;
+            bool IsHighlighted = false;
+            Geometry::Transformation PreviousTransform;
+            Geometry::Transformation Transform;
+
+            template <typename S>
+            void serialize(S& s)
+            {
+                s.ext(AssociatedMesh, bitsery::ext::PointerObserver{});
+                s.ext(AssociatedMaterial, bitsery::ext::PointerObserver{});
+                s.boolValue(IsSelected);
+                s.boolValue(IsHighlighted);
+                s.object(PreviousTransform);
+                s.object(Transform);
+            }
+        };
+
+        MeshInstanceHandle Add(Mesh* mesh, Material* material, TransformHierarchy::NodeId parent = TransformHierarchy::NoParent);
+        void Remove(MeshInstanceHandle handle);
+        void Clear();
+
+        std::vector<Record> ExportRecords() const;
+        void ImportRecords(const std::vector<Record>& records);
+
+        // Transform relative to the parent node, applied on the next UpdateTransforms
+        void SetTransformation(MeshInstanceHandle handle, const Geometry::Transformation& transform);
+        // Picks the local transform that puts the instance at the world matrix under its current parent
+        void SetWorldMatrix(MeshInstanceHandle handle, const glm::mat4& worldMatrix);
+        void SetMaterial(MeshInstanceHandle handle, Material* material);
+        void SetFlag(MeshInstanceHandle handle, MeshInstanceFlags flag, bool enabled);
+        bool HasFlag(uint32_t index, MeshInstanceFlags flag) const;
+
+        // Composes world matrices of changed subtrees and refits world bounds of instances they moved
+        void UpdateTransforms();
+
+        // Previous matrices and bounds take current values, split between task scheduler workers
+        void UpdatePreviousFrameValues();
+
+        // World matrix was recomputed since previous frame values were last updated
+        bool HasChanged(uint32_t index) const;
+
+        // Measures per-frame passes over dense storage against the same passes over a list of instances
+        static bool RunBenchmark(const std::filesystem::path& reportPath);
+
+    private:
+        Foundation::HandleTable mHandles;
+        TransformHierarchy mHierarchy;
+        std::vector<Mesh*> mMeshes;
+        std::vector<Material*> mMaterials;
+        std::vector<TransformHierarchy::NodeId> mNodes;
+        std::vector<Geometry::AABB> mWorldBounds;
+        std::vector<Geometry::AABB> mPreviousWorldBounds;
+        std::vector<uint32_t> mGPUTableIndices;
+        std::vector<MeshInstanceFlags> mFlags;
+
+    public:
+        inline bool Contains(MeshInstanceHandle handle) const { return mHandles.Contains(handle); }
+        inline uint32_t Index(MeshInstanceHandle handle) const { return mHandles.Index(handle); }
+        inline MeshInstanceHandle HandleAt(uint32_t index) const { return mHandles.HandleAt(index); }
+        inline uint32_t Size() const { return mHandles.Size(); }
+        inline bool Empty() const { return mHandles.Empty(); }
+
+        inline const std::vector<Mesh*>& Meshes() const { return mMeshes; }
+        inline const std::vector<Material*>& Materials() const { return mMaterials; }
+        inline const std::vector<TransformHierarchy::NodeId>& Nodes() const { return mNodes; }
+        inline const std::vector<Geometry::AABB>& WorldBounds() const { return mWorldBounds; }
+        inline const std::vector<Geometry::AABB>& PreviousWorldBounds() const { return mPreviousWorldBounds; }
+        inline const std::vector<uint32_t>& GPUTableIndices() const { return mGPUTableIndices; }
+        inline const std::vector<MeshInstanceFlags>& Flags() const { return mFlags; }
+        inline std::vector<uint32_t>& GPUTableIndices() { return mGPUTableIndices; }
+        inline const TransformHierarchy& Hierarchy() const { return mHierarchy; }
+        inline TransformHierarchy& Hierarchy() { return mHierarchy; }
+
+        inline const glm::mat4& WorldMatrix(uint32_t index) const { return mHierarchy.WorldMatrix(mNodes[index]); }
+        inline const glm::mat4& PreviousWorldMatrix(uint32_t index) const { return mHierarchy.PreviousWorldMatrix(mNodes[index]); }
+        inline const glm::mat4& NormalMatrix(uint32_t index) const { return mHierarchy.NormalMatrix(mNodes[index]); }
+
+        inline Geometry::Transformation GetTransformation(MeshInstanceHandle handle) const { return mHierarchy.LocalTransform(mNodes[Index(handle)]); }
+        inline Mesh* GetMesh(MeshInstanceHandle handle) const { return mMeshes[Index(handle)]; }
+        inline Material* GetMaterial(MeshInstanceHandle handle) const { return mMaterials[Index(handle)]; }
+    };
+
+}
+
+ENABLE_BITMASK_OPERATORS(PathFinder::MeshInstanceFlags);
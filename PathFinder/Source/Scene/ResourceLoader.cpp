@@ -2,137 +2,338 @@
 
 #include "ResourceLoader.hpp"
 
+#include <Foundation/Assert.hpp>
+
 #include <fstream>
 #include <iterator>
 #include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 
 namespace PathFinder
 {
 
+    namespace
+    {
+        // Parser reports signed and unsigned BC6H as a single format,
+        // so the variant is read from DX10 extension header of DDS files
+        bool IsUnsignedBC6H(const ddsktx_texture_info& textureInfo, const std::vector<uint8_t>& fileBytes)
+        {
+            const uint64_t FourCCOffset = 84;
+            const uint64_t DX10HeaderOffset = 128;
+
+            if (!(textureInfo.flags & DDSKTX_TEXTURE_FLAG_DDS) || fileBytes.size() < DX10HeaderOffset + sizeof(uint32_t))
+            {
+                return false;
+            }
+
+            if (memcmp(fileBytes.data() + FourCCOffset, "DX10", 4) != 0)
+            {
+                return false;
+            }
+
+            uint32_t dxgiFormat = 0;
+            memcpy(&dxgiFormat, fileBytes.data() + DX10HeaderOffset, sizeof(uint32_t));
+
+            return dxgiFormat == DXGI_FORMAT_BC6H_UF16;
+        }
+    }
+
     ResourceLoader::ResourceLoader(Memory::GPUResourceProducer* resourceProducer)
         : mResourceProducer{ resourceProducer } {}
 
     Memory::GPUResourceProducer::TexturePtr ResourceLoader::LoadTexture(const std::filesystem::path& path, bool saveRowMajorBlob) 
     {
-        std::ifstream input{ path, std::ios::binary };
-        
-        if (!input.is_open())
+        std::vector<uint8_t> bytes;
+        ddsktx_texture_info textureInfo;
+
+        if (!ReadAndParse(path, bytes, textureInfo))
         {
             return nullptr;
         }
-        
-        std::uintmax_t fileSize = std::filesystem::file_size(path);
 
-        std::vector<uint8_t> bytes;
-        bytes.resize(fileSize);
+        auto texture = AllocateTexture(textureInfo, bytes);
+
+        texture->RequestWrite();
 
-        input.read((char *)bytes.data(), bytes.size());
+        // Footprint is computed once per texture and shared with upload commands
+        const HAL::ResourceFootprint& footprint = texture->Footprint();
 
-        ddsktx_texture_info textureInfo;
-        ddsktx_error error;
+        if (saveRowMajorBlob)
+        {
+            // Blob mirrors upload buffer layout, so it is written to the texture with a single copy
+            mRowMajorBlob.clear();
+            mRowMajorBlob.resize(footprint.TotalSizeInBytes());
 
-        if (!ddsktx_parse(&textureInfo, bytes.data(), (int)bytes.size(), &error))
+            CopySubresources(textureInfo, bytes, footprint, mRowMajorBlob.data());
+            texture->Write(mRowMajorBlob.data(), 0, mRowMajorBlob.size());
+        }
+        else 
         {
-            return nullptr;
+            CopySubresources(textureInfo, bytes, footprint, texture->WriteOnlyPtr());
         }
 
-        assert_format(textureInfo.num_layers == 1, "Texture arrays are not supported yet");
+        texture->SetDebugName(path.filename().string());
+        
+        return std::move(texture);
+    }
 
-        bool isCompressedFormat = ddsktx_format_compressed(textureInfo.format);
-        auto texture = AllocateTexture(textureInfo);
+    void ResourceLoader::StoreResource(const Memory::GPUResource& resource, const std::filesystem::path& path) const
+    {
 
-        texture->RequestWrite();
+    }
 
-        if (saveRowMajorBlob)
+    bool ResourceLoader::RunBenchmark(const std::filesystem::path& textureFolder, const std::filesystem::path& reportPath)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        if (!std::filesystem::is_directory(textureFolder))
         {
-            mRowMajorBlob.clear();
-            mRowMajorBlob.resize(texture->Footprint().TotalSizeInBytes());
+            return false;
         }
 
-        uint64_t uploadMemoryOffset = 0;
+        std::ofstream stream{ reportPath, std::ios::out | std::ios::trunc };
 
-        for (int mip = 0; mip < textureInfo.num_mips; ++mip)
+        if (!stream.is_open())
         {
-            const HAL::SubresourceFootprint& mipFootprint = texture->Footprint().GetSubresourceFootprint(mip);
-            uploadMemoryOffset = mipFootprint.Offset();
+            return false;
+        }
+
+        uint64_t totalFileBytes = 0;
+        uint64_t totalCopiedBytes = 0;
+        uint64_t totalSubresourceCount = 0;
+        uint64_t totalRowByRowSubresourceCount = 0;
+        double totalReadDuration = 0.0;
+        double totalCopyDuration = 0.0;
+        double totalRowByRowCopyDuration = 0.0;
+        bool isFirstResult = true;
+
+        stream.precision(6);
+        stream << "{\"units\":\"megabytes per second\",\"textures\":[\n";
+
+        for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator{ textureFolder })
+        {
+            if (!entry.is_regular_file() || entry.path().extension() != ".dds")
+            {
+                continue;
+            }
+
+            std::vector<uint8_t> bytes;
+            ddsktx_texture_info textureInfo;
+
+            auto readStart = Clock::now();
 
-            for (int depthLayer = 0; depthLayer < textureInfo.depth; ++depthLayer)
+            if (!ReadAndParse(entry.path(), bytes, textureInfo))
             {
-                ddsktx_sub_data subData;
-                ddsktx_get_sub(&textureInfo, &subData, bytes.data(), (int)bytes.size(), 0, depthLayer, mip);
+                continue;
+            }
+
+            double readDuration = std::chrono::duration<double>(Clock::now() - readStart).count();
+
+            auto texture = AllocateTexture(textureInfo, bytes);
+            texture->RequestWrite();
+
+            const HAL::ResourceFootprint& footprint = texture->Footprint();
+            uint8_t* uploadMemory = texture->WriteOnlyPtr();
+
+            // Touch upload memory once so that first-use page faults don't skew the first measurement
+            memset(uploadMemory, 0, footprint.TotalSizeInBytes());
+
+            auto copyStart = Clock::now();
+            CopyStatistics statistics = CopySubresources(textureInfo, bytes, footprint, uploadMemory);
+            double copyDuration = std::chrono::duration<double>(Clock::now() - copyStart).count();
+
+            auto rowByRowCopyStart = Clock::now();
+            CopySubresources(textureInfo, bytes, footprint, uploadMemory, true);
+            double rowByRowCopyDuration = std::chrono::duration<double>(Clock::now() - rowByRowCopyStart).count();
+
+            double megabytes = statistics.CopiedBytes / (1024.0 * 1024.0);
+
+            stream << (isFirstResult ? "" : ",\n") << "{\"file\":\"" << entry.path().filename().string() << "\""
+                << ",\"format\":\"" << ddsktx_format_str(textureInfo.format) << "\""
+                << ",\"width\":" << textureInfo.width
+                << ",\"height\":" << textureInfo.height
+                << ",\"depth\":" << textureInfo.depth
+                << ",\"layers\":" << textureInfo.num_layers
+                << ",\"cubeMap\":" << ((textureInfo.flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) ? "true" : "false")
+                << ",\"mips\":" << textureInfo.num_mips
+                << ",\"subresources\":" << statistics.SubresourceCount
+                << ",\"rowByRowSubresources\":" << statistics.RowByRowSubresourceCount
+                << ",\"copiedMegabytes\":" << megabytes
+                << ",\"copyThroughput\":" << (copyDuration > 0.0 ? megabytes / copyDuration : 0.0)
+                << ",\"rowByRowCopyThroughput\":" << (rowByRowCopyDuration > 0.0 ? megabytes / rowByRowCopyDuration : 0.0) << "}";
+
+            isFirstResult = false;
+            totalFileBytes += bytes.size();
+            totalCopiedBytes += statistics.CopiedBytes;
+            totalSubresourceCount += statistics.SubresourceCount;
+            totalRowByRowSubresourceCount += statistics.RowByRowSubresourceCount;
+            totalReadDuration += readDuration;
+            totalCopyDuration += copyDuration;
+            totalRowByRowCopyDuration += rowByRowCopyDuration;
+        }
+
+        double fileMegabytes = totalFileBytes / (1024.0 * 1024.0);
+        double copiedMegabytes = totalCopiedBytes / (1024.0 * 1024.0);
+
+        stream << "],\"fileMegabytes\":" << fileMegabytes
+            << ",\"copiedMegabytes\":" << copiedMegabytes
+            << ",\"subresources\":" << totalSubresourceCount
+            << ",\"rowByRowSubresources\":" << totalRowByRowSubresourceCount
+            << ",\"readThroughput\":" << (totalReadDuration > 0.0 ? fileMegabytes / totalReadDuration : 0.0)
+            << ",\"copyThroughput\":" << (totalCopyDuration > 0.0 ? copiedMegabytes / totalCopyDuration : 0.0)
+            << ",\"rowByRowCopyThroughput\":" << (totalRowByRowCopyDuration > 0.0 ? copiedMegabytes / totalRowByRowCopyDuration : 0.0)
+            << ",\"loadThroughput\":" << (totalReadDuration + totalCopyDuration > 0.0 ? fileMegabytes / (totalReadDuration + totalCopyDuration) : 0.0)
+            << "}\n";
+
+        return stream.good();
+    }
+
+    bool ResourceLoader::ReadAndParse(const std::filesystem::path& path, std::vector<uint8_t>& fileBytes, ddsktx_texture_info& textureInfo) const
+    {
+        std::ifstream input{ path, std::ios::binary };
+
+        if (!input.is_open())
+        {
+            return false;
+        }
+
+        std::uintmax_t fileSize = std::filesystem::file_size(path);
+
+        fileBytes.resize(fileSize);
+        input.read((char*)fileBytes.data(), fileBytes.size());
+
+        ddsktx_error error;
+
+        return ddsktx_parse(&textureInfo, fileBytes.data(), (int)fileBytes.size(), &error);
+    }
+
+    ResourceLoader::CopyStatistics ResourceLoader::CopySubresources(
+        const ddsktx_texture_info& textureInfo,
+        const std::vector<uint8_t>& fileBytes,
+        const HAL::ResourceFootprint& footprint,
+        uint8_t* destination,
+        bool forceRowByRowCopy) const
+    {
+        assert_format(destination, "Need to request a write operation before copying subresources");
+
+        CopyStatistics statistics{};
+
+        bool isCubeMap = (textureInfo.flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) != 0;
+        bool isVolume = !isCubeMap && textureInfo.depth > 1;
+        uint64_t faceCount = isCubeMap ? DDSKTX_CUBE_FACE_COUNT : 1;
+        uint64_t mipCount = textureInfo.num_mips;
+
+        bool isCompressedFormat = ddsktx_format_compressed(textureInfo.format);
 
-                // row_pitch_bytes is number of bytes per row in the image file
-                // mipFootprint.RowPitch() is row size with possible wasted space in it due to HW alignment requirements
-                bool imageDataSatisfiesTextureRowAlignment =
-                    mipFootprint.RowPitch() == subData.row_pitch_bytes &&
-                    mipFootprint.RowSizeInBytes() == subData.row_pitch_bytes;
+        // DDS volumes store depth halved with every mip while the parser assumes full depth for all of them,
+        // so mips of volumes are located by walking tightly packed data manually
+        bool isDDSVolume = isVolume && (textureInfo.flags & DDSKTX_TEXTURE_FLAG_DDS);
+        const uint8_t* volumeMipData = nullptr;
 
-                if (imageDataSatisfiesTextureRowAlignment)
+        // File order is layer, face, mip, which for arrays and cube maps is also D3D subresource order
+        for (int layer = 0; layer < textureInfo.num_layers; ++layer)
+        {
+            for (uint64_t face = 0; face < faceCount; ++face)
+            {
+                for (uint64_t mip = 0; mip < mipCount; ++mip)
                 {
-                    // Copy whole subresource
-                    texture->Write((uint8_t*)subData.buff, uploadMemoryOffset, subData.size_bytes);
+                    uint64_t arraySlice = layer * faceCount + face;
+                    const HAL::SubresourceFootprint& subresourceFootprint = footprint.GetSubresourceFootprint(uint32_t(mip + arraySlice * mipCount));
+                    uint64_t sliceCount = subresourceFootprint.Depth();
+
+                    const uint8_t* source = nullptr;
+
+                    // row_pitch_bytes is number of bytes per row in the image file
+                    // RowPitch() is row size with possible wasted space in it due to HW alignment requirements
+                    uint64_t sourceRowPitch = 0;
+                    uint64_t sourceSlicePitch = 0;
+
+                    if (isDDSVolume)
+                    {
+                        if (!volumeMipData)
+                        {
+                            ddsktx_sub_data subData;
+                            ddsktx_get_sub(&textureInfo, &subData, fileBytes.data(), (int)fileBytes.size(), 0, 0, 0);
+                            volumeMipData = (const uint8_t*)subData.buff;
+                        }
+
+                        // Compressed formats store 4x4 blocks of bpp * 16 bits
+                        uint64_t mipWidth = std::max(textureInfo.width >> mip, 1);
+                        sourceRowPitch = isCompressedFormat ? 
+                            std::max<uint64_t>((mipWidth + 3) / 4, 1) * textureInfo.bpp * 2 :
+                            (mipWidth * textureInfo.bpp + 7) / 8;
 
-                    if (saveRowMajorBlob)
+                        sourceSlicePitch = sourceRowPitch * subresourceFootprint.RowCount();
+                        source = volumeMipData;
+                        volumeMipData += sourceSlicePitch * sliceCount;
+                    }
+                    else 
                     {
-                        auto start = (uint8_t*)subData.buff;
-                        auto end = start + subData.size_bytes;
-                        std::copy(start, end, mRowMajorBlob.begin() + uploadMemoryOffset);
+                        ddsktx_sub_data subData;
+                        ddsktx_get_sub(&textureInfo, &subData, fileBytes.data(), (int)fileBytes.size(), layer, (int)face, (int)mip);
+
+                        source = (const uint8_t*)subData.buff;
+                        sourceRowPitch = subData.row_pitch_bytes;
+                        sourceSlicePitch = subData.size_bytes;
                     }
 
-                    uploadMemoryOffset += subData.size_bytes;
-                }
-                else {
-                    // Have to copy row-by-row
-                    uint8_t* rowData = (uint8_t*)subData.buff;
-                    uint64_t rowReadCountAtOnce = mipFootprint.RowSizeInBytes() / subData.row_pitch_bytes;
-                    uint64_t readMemoryOffset = 0;
+                    uint8_t* subresourceDestination = destination + subresourceFootprint.Offset();
 
-                    // Loader library does not divide row cout by 4 for compressed formats (a bug?) so we do it manually
-                    uint64_t actualRowCount = isCompressedFormat ? subData.height / 4 : subData.height;
+                    bool layoutsMatch =
+                        subresourceFootprint.RowPitch() == sourceRowPitch &&
+                        subresourceFootprint.SlicePitch() == sourceSlicePitch;
 
-                    for (auto row = 0; row < actualRowCount; row += rowReadCountAtOnce)
+                    if (layoutsMatch && !forceRowByRowCopy)
+                    {
+                        // Copy whole subresource, all of its slices at once
+                        memcpy(subresourceDestination, source, sourceSlicePitch * sliceCount);
+                    }
+                    else 
                     {
-                        uint64_t bytesToRead = subData.row_pitch_bytes * rowReadCountAtOnce;
-                        texture->Write((uint8_t*)subData.buff + readMemoryOffset, uploadMemoryOffset, bytesToRead);
+                        // Have to copy row by row. Row count comes from the footprint
+                        // because it is already expressed in blocks for compressed formats.
+                        uint64_t rowSize = std::min<uint64_t>(subresourceFootprint.RowSizeInBytes(), sourceRowPitch);
 
-                        if (saveRowMajorBlob)
+                        for (uint64_t slice = 0; slice < sliceCount; ++slice)
                         {
-                            auto start = (uint8_t*)subData.buff + readMemoryOffset;
-                            auto end = start + bytesToRead;
-                            std::copy(start, end, mRowMajorBlob.begin() + uploadMemoryOffset);
+                            const uint8_t* sourceSlice = source + slice * sourceSlicePitch;
+                            uint8_t* destinationSlice = subresourceDestination + slice * subresourceFootprint.SlicePitch();
+
+                            for (uint64_t row = 0; row < subresourceFootprint.RowCount(); ++row)
+                            {
+                                memcpy(destinationSlice + row * subresourceFootprint.RowPitch(), sourceSlice + row * sourceRowPitch, rowSize);
+                            }
                         }
 
-                        uploadMemoryOffset += mipFootprint.RowPitch();
-                        readMemoryOffset += bytesToRead;
+                        ++statistics.RowByRowSubresourceCount;
                     }
+
+                    ++statistics.SubresourceCount;
+                    statistics.CopiedBytes += sourceSlicePitch * sliceCount;
                 }
             }
         }
 
-        texture->SetDebugName(path.filename().string());
-        input.close();
-        
-        return std::move(texture);
-    }
-
-    void ResourceLoader::StoreResource(const Memory::GPUResource& resource, const std::filesystem::path& path) const
-    {
-
+        return statistics;
     }
 
     HAL::TextureKind ResourceLoader::ToKind(const ddsktx_texture_info& textureInfo) const
     {
         bool isArray = textureInfo.num_layers > 1;
 
-        if (textureInfo.depth > 1 && !isArray) return HAL::TextureKind::Texture3D;
-        if (textureInfo.depth > 1 || textureInfo.width > 1) return HAL::TextureKind::Texture2D;
+        // Parser guarantees that a texture is either a cube map or a volume
+        if (textureInfo.flags & DDSKTX_TEXTURE_FLAG_CUBEMAP) return HAL::TextureKind::TextureCube;
+        if (textureInfo.depth > 1) return HAL::TextureKind::Texture3D;
+        if (textureInfo.height > 1 || textureInfo.width > 1 || isArray) return HAL::TextureKind::Texture2D;
 
         return HAL::TextureKind::Texture1D;
     }
 
-    HAL::FormatVariant ResourceLoader::ToResourceFormat(const ddsktx_format& parserFormat) const
+    HAL::FormatVariant ResourceLoader::ToResourceFormat(const ddsktx_texture_info& textureInfo, const std::vector<uint8_t>& fileBytes) const
     {
-        switch (parserFormat)
+        switch (textureInfo.format)
         {
             // Supported color formats
         case DDSKTX_FORMAT_R8:          return HAL::ColorFormat::R8_Unsigned_Norm;
@@ -158,12 +359,12 @@ namespace PathFinder
         case DDSKTX_FORMAT_BC4:         return HAL::ColorFormat::BC4_Unsigned_Norm;
         case DDSKTX_FORMAT_BC5:         return HAL::ColorFormat::BC5_Unsigned_Norm;
         case DDSKTX_FORMAT_BC7:         return HAL::ColorFormat::BC7_Unsigned_Norm;
+        case DDSKTX_FORMAT_BC6H:        return IsUnsignedBC6H(textureInfo, fileBytes) ? HAL::ColorFormat::BC6H_Unsigned_Float : HAL::ColorFormat::BC6H_Signed_Float;
 
             // Not yet supported formats
         case DDSKTX_FORMAT_RGB10A2:
         case DDSKTX_FORMAT_RG11B10F:
         case DDSKTX_FORMAT_A8:
-        case DDSKTX_FORMAT_BC6H:        // BC6H
         case DDSKTX_FORMAT_ETC1:        // ETC1 RGB8
         case DDSKTX_FORMAT_ETC2:        // ETC2 RGB8
         case DDSKTX_FORMAT_ETC2A:       // ETC2 RGBA8
@@ -189,12 +390,19 @@ namespace PathFinder
         }
     }
 
-    Memory::GPUResourceProducer::TexturePtr ResourceLoader::AllocateTexture(const ddsktx_texture_info& textureInfo) const
+    Memory::GPUResourceProducer::TexturePtr ResourceLoader::AllocateTexture(const ddsktx_texture_info& textureInfo, const std::vector<uint8_t>& fileBytes) const
     {
-        HAL::FormatVariant format = ToResourceFormat(textureInfo.format);
-        Geometry::Dimensions dimensions(textureInfo.width, textureInfo.height, textureInfo.depth);
+        HAL::FormatVariant format = ToResourceFormat(textureInfo, fileBytes);
         HAL::TextureKind kind = ToKind(textureInfo);
 
+        // Depth of dimensions is array size for arrays and face count for cube maps
+        uint64_t depth = textureInfo.depth;
+
+        if (kind == HAL::TextureKind::TextureCube) depth = textureInfo.num_layers * DDSKTX_CUBE_FACE_COUNT;
+        else if (kind != HAL::TextureKind::Texture3D) depth = textureInfo.num_layers;
+
+        Geometry::Dimensions dimensions(textureInfo.width, textureInfo.height, depth);
+
         HAL::TextureProperties properties{ format, kind, dimensions, HAL::ResourceState::AnyShaderAccess, HAL::ResourceState::CopyDestination, (uint16_t)textureInfo.num_mips };
 
         return mResourceProducer->NewTexture(properties);
@@ -7,9 +7,12 @@
 #include <filesystem>
 #include <vector>
 
-namespace PathFinder 
+namespace PathFinder
 {
 
+    /// Loads DDS and KTX textures of any kind: 1D, 2D, arrays, cube maps, cube map arrays and volumes with all of their mips.
+    /// Subresources are copied straight into the upload buffer laid out by the texture's cached footprint,
+    /// a whole subresource at a time when pitches of the file and the footprint match and row by row otherwise.
     class ResourceLoader
     {
     public:
@@ -18,10 +21,31 @@ namespace PathFinder
         Memory::GPUResourceProducer::TexturePtr LoadTexture(const std::filesystem::path& path, bool saveRowMajorBlob = false);
         void StoreResource(const Memory::GPUResource& resource, const std::filesystem::path& path) const;
 
+        // Loads every DDS file found in the folder and its subfolders, measures throughput
+        // of whole subresource and forced row by row copies and writes both to a JSON report.
+        // Meant for headless runs: textures are released right after measurement and never reach the GPU.
+        bool RunBenchmark(const std::filesystem::path& textureFolder, const std::filesystem::path& reportPath);
+
     private:
+        struct CopyStatistics
+        {
+            uint64_t SubresourceCount = 0;
+            uint64_t RowByRowSubresourceCount = 0;
+            uint64_t CopiedBytes = 0;
+        };
+
+        bool ReadAndParse(const std::filesystem::path& path, std::vector<uint8_t>& fileBytes, ddsktx_texture_info& textureInfo) const;
+
+        CopyStatistics CopySubresources(
+            const ddsktx_texture_info& textureInfo,
+            const std::vector<uint8_t>& fileBytes,
+            const HAL::ResourceFootprint& footprint,
+            uint8_t* destination,
+            bool forceRowByRowCopy = false) const;
+
         HAL::TextureKind ToKind(const ddsktx_texture_info& textureInfo) const;
-        HAL::FormatVariant ToResourceFormat(const ddsktx_format& parserFormat) const;
-        Memory::GPUResourceProducer::TexturePtr AllocateTexture(const ddsktx_texture_info& textureInfo) const;
+        HAL::FormatVariant ToResourceFormat(const ddsktx_texture_info& textureInfo, const std::vector<uint8_t>& fileBytes) const;
+        Memory::GPUResourceProducer::TexturePtr AllocateTexture(const ddsktx_texture_info& textureInfo, const std::vector<uint8_t>& fileBytes) const;
 
         std::vector<uint8_t> mRowMajorBlob;
         Memory::GPUResourceProducer* mResourceProducer;
@@ -9,6 +9,7 @@
 #include <bitsery/ext/pointer.h>
 
 #include <fstream>
+#include <algorithm>
 
 #include <Foundation/Filesystem.hpp>
 #include <Foundation/StringUtils.hpp>
@@ -27,6 +28,7 @@ namespace PathFinder
         mResourceProducer{ resourceProducer },
         mLuminanceMeter{ &mCamera },
         mGPUStorage{ this, device, resourceProducer, pipelineResourceStorage, renderSurfaceDescription, renderSettings },
+        mBVH{ this },
         mMaterialLoader{ executableFolder, resourceProducer },
         mGIManager{ this }
     {
@@ -39,10 +41,14 @@ namespace PathFinder
         return mMeshes.back();
     }
 
-    MeshInstance& Scene::AddMeshInstance(MeshInstance&& instance)
+    MeshInstanceHandle Scene::AddMeshInstance(Mesh* mesh, Material* material)
     {
-        mMeshInstances.emplace_back(std::move(instance));
-        return mMeshInstances.back();
+        return mMeshInstances.Add(mesh, material);
+    }
+
+    void Scene::RemoveMeshInstance(MeshInstanceHandle handle)
+    {
+        mMeshInstances.Remove(handle);
     }
 
     Material& Scene::AddMaterial(Material&& material)
@@ -51,6 +57,29 @@ namespace PathFinder
         return mMaterials.back();
     }
 
+    void Scene::RemoveMesh(const Mesh* mesh)
+    {
+        const std::vector<Mesh*>& instanceMeshes = mMeshInstances.Meshes();
+
+        assert_format(std::find(instanceMeshes.begin(), instanceMeshes.end(), mesh) == instanceMeshes.end(), "Mesh is still referenced by instances");
+
+        mGPUStorage.ReleaseMesh(*mesh);
+        mBVH.ReleaseMesh(*mesh);
+        mMeshNames.erase(mesh->GetName());
+        mMeshes.remove_if([mesh](const Mesh& sceneMesh) { return &sceneMesh == mesh; });
+    }
+
+    void Scene::RemoveMaterial(const Material* material)
+    {
+        const std::vector<Material*>& instanceMaterials = mMeshInstances.Materials();
+
+        assert_format(std::find(instanceMaterials.begin(), instanceMaterials.end(), material) == instanceMaterials.end(), "Material is still referenced by instances");
+
+        mGPUStorage.ReleaseMaterial(*material);
+        mMaterialNames.erase(material->Name);
+        mMaterials.remove_if([material](const Material& sceneMaterial) { return &sceneMaterial == material; });
+    }
+
     Scene::FlatLightIt Scene::EmplaceDiskLight()
     {
         mDiskLights.emplace_back(FlatLight::Type::Disk);
@@ -71,11 +100,13 @@ namespace PathFinder
 
     void Scene::MapEntitiesToGPUIndices()
     {
-        mMeshInstanceGPUIndexMappings.resize(mMeshInstances.size());
+        mMeshInstanceGPUIndexMappings.resize(mMeshInstances.Size());
         mLightGPUIndexMappings.resize(mRectangularLights.size() + mDiskLights.size() + mSphericalLights.size());
 
-        for (MeshInstance& instance : mMeshInstances)
-            mMeshInstanceGPUIndexMappings[instance.GetIndexInGPUTable()] = &instance;
+        const std::vector<uint32_t>& instanceGPUIndices = mMeshInstances.GPUTableIndices();
+
+        for (uint32_t index = 0; index < mMeshInstances.Size(); ++index)
+            mMeshInstanceGPUIndexMappings[instanceGPUIndices[index]] = mMeshInstances.HandleAt(index);
 
         for (FlatLight& light : mRectangularLights)
             mLightGPUIndexMappings[light.GetIndexInGPUTable()] = &light;
@@ -89,8 +120,7 @@ namespace PathFinder
 
     void Scene::UpdatePreviousFrameValues()
     {
-        for (MeshInstance& instance : mMeshInstances)
-            instance.UpdatePreviousFrameValues();
+        mMeshInstances.UpdatePreviousFrameValues();
 
         for (FlatLight& light : mRectangularLights)
             light.UpdatePreviousFrameValues();
@@ -117,13 +147,23 @@ namespace PathFinder
 
             mMaterialLoader.LoadMaterial(*insertedMaterial);
         }
+
+        // Scene graph nodes become transform hierarchy nodes, instances are attached to the node that referenced their mesh
+        TransformHierarchy& hierarchy = mMeshInstances.Hierarchy();
+        std::vector<TransformHierarchy::NodeId> insertedNodes;
+
+        for (const ThirdPartySceneLoader::LoadedNode& loadedNode : mThirdPartySceneLoader.LoadedNodes())
+        {
+            TransformHierarchy::NodeId parent = loadedNode.ParentIndex ? insertedNodes[*loadedNode.ParentIndex] : TransformHierarchy::NoParent;
+            insertedNodes.push_back(hierarchy.AddNode(loadedNode.LocalTransform, parent));
+        }
             
         for (ThirdPartySceneLoader::LoadedMesh& loadedMesh : loadedMeshes)
         {
             Mesh* insertedMesh = &mMeshes.emplace_back(std::move(loadedMesh.MeshObject));
             Material* material = insertedMaterials[loadedMesh.MaterialIndex];
             insertedMesh->SetName(EnsureMeshNameUniqueness(insertedMesh->GetName()));
-            mMeshInstances.emplace_back(insertedMesh, material);
+            mMeshInstances.Add(insertedMesh, material, insertedNodes[loadedMesh.NodeIndex]);
 
             mTotalVertexCount += insertedMesh->GetVertices().size();
             mTotalIndexCount += insertedMesh->GetIndices().size();
@@ -152,7 +192,8 @@ namespace PathFinder
         serializer.object(mCamera);
         serializer.container(mMeshes, std::numeric_limits<uint64_t>::max(), [](Serializer& s, Mesh& m) { s.ext(m, bitsery::ext::ReferencedByPointer{}); });
         serializer.container(mMaterials, std::numeric_limits<uint64_t>::max(), [](Serializer& s, Material& m) { s.ext(m, bitsery::ext::ReferencedByPointer{}); });
-        serializer.container(mMeshInstances, std::numeric_limits<uint64_t>::max());
+        std::vector<MeshInstanceStorage::Record> meshInstanceRecords = mMeshInstances.ExportRecords();
+        serializer.container(meshInstanceRecords, std::numeric_limits<uint64_t>::max());
 
         serializer.adapter().flush();
         stream.close();
@@ -175,12 +216,15 @@ namespace PathFinder
         deserializer.object(mCamera);
         deserializer.container(mMeshes, std::numeric_limits<uint64_t>::max(), [](Deserializer& s, Mesh& m) { s.ext(m, bitsery::ext::ReferencedByPointer{}); });
         deserializer.container(mMaterials, std::numeric_limits<uint64_t>::max(), [](Deserializer& s, Material& m) { s.ext(m, bitsery::ext::ReferencedByPointer{}); });
-        deserializer.container(mMeshInstances, std::numeric_limits<uint64_t>::max());
+        std::vector<MeshInstanceStorage::Record> meshInstanceRecords;
+        deserializer.container(meshInstanceRecords, std::numeric_limits<uint64_t>::max());
 
         stream.close();
 
         assert_format(context.isValid(), "Scene deserialization failed");
 
+        mMeshInstances.ImportRecords(meshInstanceRecords);
+
         for (Mesh& mesh : mMeshes)
         {
             mesh.DeserializeVertexData(sceneFiles.MeshFolderPath / (mesh.GetName() + ".pfmeshdat"));
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "Mesh.hpp"
-#include "MeshInstance.hpp"
+#include "MeshInstanceStorage.hpp"
 #include "Camera.hpp"
 #include "Material.hpp"
 #include "GTTonemappingParameters.hpp"
@@ -12,6 +12,7 @@
 #include "LuminanceMeter.hpp"
 #include "GIManager.hpp"
 #include "SceneGPUStorage.hpp"
+#include "SceneBVH.hpp"
 #include "ThirdPartySceneLoader.hpp"
 #include "MaterialLoader.hpp"
 #include "Sky.hpp"
@@ -46,8 +47,13 @@ namespace PathFinder
         );
 
         Mesh& AddMesh(Mesh&& mesh);
-        MeshInstance& AddMeshInstance(MeshInstance&& instance);
+        MeshInstanceHandle AddMeshInstance(Mesh* mesh, Material* material);
+        void RemoveMeshInstance(MeshInstanceHandle handle);
         Material& AddMaterial(Material&& material);
+
+        // Meshes and materials can only be removed once no instances reference them
+        void RemoveMesh(const Mesh* mesh);
+        void RemoveMaterial(const Material* material);
         FlatLightIt EmplaceDiskLight();
         FlatLightIt EmplaceRectangularLight();
         SphericalLightIt EmplaceSphericalLight();
@@ -80,7 +86,7 @@ namespace PathFinder
         std::string EnsureNameUniqueness(const std::string& name, robin_hood::unordered_flat_set<std::string>& set);
 
         std::list<Mesh> mMeshes;
-        std::list<MeshInstance> mMeshInstances;
+        MeshInstanceStorage mMeshInstances;
         std::list<Material> mMaterials;
         std::list<FlatLight> mRectangularLights;
         std::list<FlatLight> mDiskLights;
@@ -106,8 +112,9 @@ namespace PathFinder
 
         Memory::GPUResourceProducer* mResourceProducer;
         SceneGPUStorage mGPUStorage;
+        SceneBVH mBVH;
 
-        std::vector<MeshInstance*> mMeshInstanceGPUIndexMappings;
+        std::vector<MeshInstanceHandle> mMeshInstanceGPUIndexMappings;
         std::vector<LightVariant> mLightGPUIndexMappings;
 
         uint64_t mTotalVertexCount = 0;
@@ -121,6 +128,7 @@ namespace PathFinder
         inline GIManager& GetGIManager() { return mGIManager; }
         inline const GIManager& GetGIManager() const { return mGIManager; }
         inline Sky& GetSky() { return mSky; }
+        inline MaterialLoader& GetMaterialLoader() { return mMaterialLoader; }
         inline const Sky& GetSky() const { return mSky; }
         inline const auto& GetMeshes() const { return mMeshes; }
         inline const auto& GetMeshInstances() const { return mMeshInstances; }
@@ -139,6 +147,8 @@ namespace PathFinder
         inline auto& GetSphericalLights() { return mSphericalLights; }
         inline auto& GetTonemappingParams() { return mTonemappingParams; }
         inline auto& GetBloomParams() { return mBloomParameters; }
+        inline Mesh& GetUnitCube() { return mUnitCube; }
+        inline Mesh& GetUnitSphere() { return mUnitSphere; }
 
         inline auto GetTotalLightCount() const { return mRectangularLights.size() + mDiskLights.size() + mSphericalLights.size() + 1 /*Sun*/; }
 
@@ -148,10 +158,12 @@ namespace PathFinder
         inline const Mesh& GetUnitCube() const { return mUnitCube; }
         inline const Mesh& GetUnitSphere() const { return mUnitSphere; }
 
-        inline MeshInstance* GetMeshInstanceForGPUIndex(uint64_t index) const { return mMeshInstanceGPUIndexMappings[index]; }
+        inline MeshInstanceHandle GetMeshInstanceForGPUIndex(uint64_t index) const { return mMeshInstanceGPUIndexMappings[index]; }
         inline LightVariant GetLightForGPUIndex(uint64_t index) const { return mLightGPUIndexMappings[index]; }
 
         inline SceneGPUStorage& GetGPUStorage() { return mGPUStorage; }
+        inline SceneBVH& GetBVH() { return mBVH; }
+        inline const SceneBVH& GetBVH() const { return mBVH; }
 
         inline const auto GetTotalVertexCount() const { return mTotalVertexCount; }
         inline const auto GetTotalIndexCount() const { return mTotalIndexCount; }
@@ -0,0 +1,108 @@
+#include "SceneBVH.hpp"
+#include "Scene.hpp"
+
+#include <RenderPipeline/DrawablePrimitive.hpp>
+#include <Foundation/CPUProfiler.hpp>
+
+namespace PathFinder
+{
+
+    SceneBVH::SceneBVH(Scene* scene)
+        : mScene{ scene },
+        mUnitQuadHierarchy{
+            std::vector<glm::vec3>{ DrawablePrimitive::UnitQuadVertices.begin(), DrawablePrimitive::UnitQuadVertices.end() },
+            std::vector<uint32_t>{ DrawablePrimitive::UnitQuadIndices.begin(), DrawablePrimitive::UnitQuadIndices.end() } } {}
+
+    void SceneBVH::Update()
+    {
+        PF_CPU_ZONE("SceneBVH::Update");
+
+        mInstanceBVH.Clear();
+        mEntities.clear();
+
+        const MeshInstanceStorage& instances = mScene->GetMeshInstances();
+
+        for (uint32_t index = 0; index < instances.Size(); ++index)
+        {
+            AddEntity(MeshHierarchy(*instances.Meshes()[index]), instances.WorldMatrix(index), instances.HandleAt(index));
+        }
+
+        // Same lights as in the GPU light table: unlit ones are skipped
+        const Geometry::TriangleBVH* sphereHierarchy = MeshHierarchy(mScene->GetUnitSphere());
+
+        for (SphericalLight& light : mScene->GetSphericalLights())
+        {
+            if (light.GetLuminousPower() > 0.0)
+                AddEntity(sphereHierarchy, light.GetModelMatrix(), &light);
+        }
+
+        for (auto lights : { &mScene->GetRectangularLights(), &mScene->GetDiskLights() })
+        {
+            for (FlatLight& light : *lights)
+            {
+                if (light.GetLuminousPower() > 0.0)
+                    AddEntity(&mUnitQuadHierarchy, light.GetModelMatrix(), &light);
+            }
+        }
+
+        const GIManager& giManager = mScene->GetGIManager();
+
+        if (giManager.GIDebugEnabled)
+        {
+            const IlluminanceField& field = giManager.ProbeField;
+
+            for (uint32_t probeIdx = 0; probeIdx < field.GetTotalProbeCount(); ++probeIdx)
+            {
+                Geometry::Transformation probeTransform{ glm::vec3{ field.GetDebugProbeRadius() * 2 }, field.GetProbePosition(probeIdx), glm::quat{} };
+                AddEntity(sphereHierarchy, probeTransform.GetMatrix(), DebugGIProbe{ probeIdx });
+            }
+        }
+
+        mInstanceBVH.Build();
+    }
+
+    std::optional<SceneBVH::Hit> SceneBVH::ClosestHit(const Geometry::Ray3D& ray, float minDistance, float maxDistance, bool cullBackFaces) const
+    {
+        std::optional<Geometry::InstanceBVH::Hit> hit = mInstanceBVH.ClosestHit(ray, minDistance, maxDistance, cullBackFaces);
+
+        if (!hit)
+            return std::nullopt;
+
+        return Hit{ mEntities[hit->InstanceIndex], hit->Distance };
+    }
+
+    bool SceneBVH::AnyHit(const Geometry::Ray3D& ray, float minDistance, float maxDistance, bool cullBackFaces) const
+    {
+        return mInstanceBVH.AnyHit(ray, minDistance, maxDistance, cullBackFaces);
+    }
+
+    void SceneBVH::ReleaseMesh(const Mesh& mesh)
+    {
+        mMeshHierarchies.erase(&mesh);
+    }
+
+    const Geometry::TriangleBVH* SceneBVH::MeshHierarchy(const Mesh& mesh)
+    {
+        auto hierarchyIt = mMeshHierarchies.find(&mesh);
+
+        if (hierarchyIt != mMeshHierarchies.end())
+            return &hierarchyIt->second;
+
+        std::vector<glm::vec3> positions;
+        positions.reserve(mesh.GetVertices().size());
+
+        for (const Vertex1P1N1UV1T1BT& vertex : mesh.GetVertices())
+        {
+            positions.emplace_back(vertex.Position);
+        }
+
+        return &mMeshHierarchies.emplace(&mesh, Geometry::TriangleBVH{ positions, mesh.GetIndices() }).first->second;
+    }
+
+    void SceneBVH::AddEntity(const Geometry::TriangleBVH* hierarchy, const glm::mat4& transform, Entity entity)
+    {
+        mInstanceBVH.AddInstance(hierarchy, transform);
+        mEntities.push_back(entity);
+    }
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Mesh.hpp"
+#include "MeshInstanceStorage.hpp"
+#include "FlatLight.hpp"
+#include "SphericalLight.hpp"
+
+#include <Geometry/InstanceBVH.hpp>
+#include <robinhood/robin_hood.h>
+
+#include <variant>
+#include <optional>
+
+namespace PathFinder
+{
+
+    class Scene;
+
+    /// CPU side two-level hierarchy over the same entities the GPU top level acceleration structure holds:
+    /// mesh instances, lights and debug GI probes. Answers ray queries within the frame they are issued in,
+    /// which is what picking, line of sight and camera collision need.
+    /// Mesh hierarchies are built once per mesh, the top level is refit as entities move.
+    class SceneBVH
+    {
+    public:
+        struct DebugGIProbe
+        {
+            uint32_t Index;
+        };
+
+        using Entity = std::variant<MeshInstanceHandle, SphericalLight*, FlatLight*, DebugGIProbe>;
+
+        struct Hit
+        {
+            Entity HitEntity;
+            float Distance;
+        };
+
+        SceneBVH(Scene* scene);
+
+        // Must run after lights constructed their model matrices for the frame
+        void Update();
+
+        std::optional<Hit> ClosestHit(const Geometry::Ray3D& ray, float minDistance, float maxDistance, bool cullBackFaces) const;
+        bool AnyHit(const Geometry::Ray3D& ray, float minDistance, float maxDistance, bool cullBackFaces) const;
+
+        // Drops the cached hierarchy of a mesh that is about to be removed from the scene
+        void ReleaseMesh(const Mesh& mesh);
+
+    private:
+        const Geometry::TriangleBVH* MeshHierarchy(const Mesh& mesh);
+        void AddEntity(const Geometry::TriangleBVH* hierarchy, const glm::mat4& transform, Entity entity);
+
+        Scene* mScene;
+        Geometry::TriangleBVH mUnitQuadHierarchy;
+        robin_hood::unordered_node_map<const Mesh*, Geometry::TriangleBVH> mMeshHierarchies;
+        Geometry::InstanceBVH mInstanceBVH;
+        std::vector<Entity> mEntities;
+
+    public:
+        inline const Geometry::InstanceBVH& InstanceHierarchy() const { return mInstanceBVH; }
+    };
+
+}
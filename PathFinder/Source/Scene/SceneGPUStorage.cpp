@@ -3,12 +3,15 @@
 
 #include <algorithm>
 #include <iterator>
+#include <limits>
 #include <Foundation/Pi.hpp>
+#include <Foundation/CPUProfiler.hpp>
+#include <Foundation/TaskScheduler.hpp>
 #include <Geometry/Utils.hpp>
+#include <Foundation/Assert.hpp>
 #include <RenderPipeline/RenderSettings.hpp>
 #include <RenderPipeline/DrawablePrimitive.hpp>
 #include <RenderPipeline/RenderPasses/PipelineNames.hpp>
-#include <fplus/fplus.hpp>
 
 namespace PathFinder
 {
@@ -30,62 +33,305 @@ namespace PathFinder
         mRenderSettings{ renderSettings }
     {
         mTopAccelerationStructure.SetDebugName("All Meshes Top RT AS");
+
+        for (const glm::vec3& position : DrawablePrimitive::UnitQuadVertices)
+        {
+            mUnitQuad.AddVertex(Vertex{ glm::vec4{ position, 1.0f } });
+        }
+
+        for (uint32_t index : DrawablePrimitive::UnitQuadIndices)
+        {
+            mUnitQuad.AddIndex(index);
+        }
+
+        mUnitQuad.SetName("Unit Quad");
     }        
 
+    template <class Function>
+    void SceneGPUStorage::ForEachMesh(const Function& function)
+    {
+        for (Mesh& mesh : mScene->GetMeshes())
+        {
+            function(mesh);
+        }
+
+        // Light and debug geometry
+        function(mUnitQuad);
+        function(mScene->GetUnitCube());
+        function(mScene->GetUnitSphere());
+    }
+
     void SceneGPUStorage::UploadMeshes()
     {
-        auto& meshes = mScene->GetMeshes();
+        PF_CPU_ZONE("SceneGPUStorage::UploadMeshes");
 
-        mBottomAccelerationStructures.clear();
+        mBottomAccelerationStructuresToBuild.clear();
 
-        auto& package1P1N1UV1T1BT = std::get<UploadBufferPackage<Vertex1P1N1UV1T1BT>>(mUploadBuffers);
-        package1P1N1UV1T1BT.Vertices.reserve(mScene->GetTotalVertexCount());
-        package1P1N1UV1T1BT.Indices.reserve(mScene->GetTotalIndexCount());
+        std::vector<Mesh*> newMeshes;
 
-        for (Mesh& mesh : meshes)
+        ForEachMesh([&](Mesh& mesh)
         {
-            assert_format(!mesh.GetVertices().empty(), "Empty meshes are not allowed");
+            if (!mVertexRanges.Contains(reinterpret_cast<uint64_t>(&mesh)))
+            {
+                AllocateMeshRanges(mesh);
+                newMeshes.push_back(&mesh);
+            }
+        });
 
-            VertexStorageLocation locationInStorage = WriteToTemporaryBuffers<Vertex1P1N1UV1T1BT>(
-                mesh.GetVertices().data(), mesh.GetVertices().size(), mesh.GetIndices().data(), mesh.GetIndices().size());
+        bool isVertexBufferTooSmall = !mVertexBuffer || mVertexBuffer->Capacity<Vertex>() < mVertexRanges.Capacity();
+        bool isIndexBufferTooSmall = !mIndexBuffer || mIndexBuffer->Capacity<uint32_t>() < mIndexRanges.Capacity();
 
-            mesh.SetVertexStorageLocation(locationInStorage);
+        // Bottom structures reference HAL buffers, so all of them are rebuilt along with new buffers
+        if (isVertexBufferTooSmall || isIndexBufferTooSmall)
+        {
+            RecreateGeometryBuffers();
+            ForEachMesh([this](const Mesh& mesh) { BuildBottomAccelerationStructure(mesh); });
+            UpdateUtilityVertexLocations();
+            return;
         }
 
-        auto quadVertices = fplus::transform([](const glm::vec3& p) { return Vertex1P1N1UV1T1BT{ glm::vec4{p, 1.0f} }; }, DrawablePrimitive::UnitQuadVertices);
+        std::vector<Mesh*> meshesWithNewVertices = newMeshes;
+        std::vector<Mesh*> meshesWithNewIndices = newMeshes;
 
-        mUnitQuadVertexLocation = WriteToTemporaryBuffers<Vertex1P1N1UV1T1BT>(
-            quadVertices.data(), quadVertices.size(),
-            DrawablePrimitive::UnitQuadIndices.data(), DrawablePrimitive::UnitQuadIndices.size());
+        if (ShouldCompact(mVertexRanges))
+        {
+            for (const Memory::CompactingRangeAllocator::Move& move : mVertexRanges.Compact(VertexCompactionBudget))
+            {
+                Mesh* mesh = reinterpret_cast<Mesh*>(move.Owner);
+                VertexStorageLocation location = mesh->GetLocationInVertexStorage();
+                location.VertexBufferOffset = move.Offset;
+                mesh->SetVertexStorageLocation(location);
+                meshesWithNewVertices.push_back(mesh);
+            }
+        }
 
-        mUnitCubeVertexLocation = WriteToTemporaryBuffers<Vertex1P1N1UV1T1BT>(
-            mScene->GetUnitCube().GetVertices().data(), mScene->GetUnitCube().GetVertices().size(), 
-            mScene->GetUnitCube().GetIndices().data(), mScene->GetUnitCube().GetIndices().size());
+        if (ShouldCompact(mIndexRanges))
+        {
+            for (const Memory::CompactingRangeAllocator::Move& move : mIndexRanges.Compact(IndexCompactionBudget))
+            {
+                Mesh* mesh = reinterpret_cast<Mesh*>(move.Owner);
+                VertexStorageLocation location = mesh->GetLocationInVertexStorage();
+                location.IndexBufferOffset = move.Offset;
+                mesh->SetVertexStorageLocation(location);
+                meshesWithNewIndices.push_back(mesh);
+            }
+        }
 
-        mUnitSphereVertexLocation = WriteToTemporaryBuffers<Vertex1P1N1UV1T1BT>(
-            mScene->GetUnitSphere().GetVertices().data(), mScene->GetUnitSphere().GetVertices().size(),
-            mScene->GetUnitSphere().GetIndices().data(), mScene->GetUnitSphere().GetIndices().size());
+        // Moved ranges land in free space, so they are uploaded from CPU copies just like new meshes
+        for (const Mesh* mesh : meshesWithNewVertices)
+        {
+            const VertexStorageLocation& location = mesh->GetLocationInVertexStorage();
+            mVertexBuffer->WriteRegion(mesh->GetVertices().data(), location.VertexBufferOffset, location.VertexCount);
+        }
 
-        SubmitTemporaryBuffersToGPU<Vertex1P1N1UV1T1BT>();
+        for (const Mesh* mesh : meshesWithNewIndices)
+        {
+            const VertexStorageLocation& location = mesh->GetLocationInVertexStorage();
+            mIndexBuffer->WriteRegion(mesh->GetIndices().data(), location.IndexBufferOffset, location.IndexCount);
+        }
+
+        std::vector<Mesh*> changedMeshes = std::move(meshesWithNewVertices);
+        changedMeshes.insert(changedMeshes.end(), meshesWithNewIndices.begin(), meshesWithNewIndices.end());
+        std::sort(changedMeshes.begin(), changedMeshes.end());
+        changedMeshes.erase(std::unique(changedMeshes.begin(), changedMeshes.end()), changedMeshes.end());
+
+        for (const Mesh* mesh : changedMeshes)
+        {
+            BuildBottomAccelerationStructure(*mesh);
+        }
+
+        UpdateUtilityVertexLocations();
     }
 
     void SceneGPUStorage::UploadMaterials()
     {
+        PF_CPU_ZONE("SceneGPUStorage::UploadMaterials");
+
         auto& materials = mScene->GetMaterials();
 
-        if (materials.empty()) return;
+        std::vector<Material*> changedMaterials;
 
-        if (!mMaterialTable || mMaterialTable->Capacity<GPUMaterialTableEntry>() < materials.size())
+        for (Material& material : materials)
+        {
+            uint64_t owner = reinterpret_cast<uint64_t>(&material);
+
+            if (!mMaterialSlots.Contains(owner))
+            {
+                material.GPUMaterialTableIndex = mMaterialSlots.Allocate(owner, 1);
+                changedMaterials.push_back(&material);
+            }
+            // Relocated textures got new descriptor indices
+            else if (material.GPUTextureRelocationCount != MaterialTextureRelocationCount(material))
+            {
+                changedMaterials.push_back(&material);
+            }
+        }
+
+        if (!mMaterialTable || mMaterialTable->Capacity<GPUMaterialTableEntry>() < mMaterialSlots.Capacity())
         {
-            auto properties = HAL::BufferProperties::Create<GPUMaterialTableEntry>(materials.size());
+            auto properties = HAL::BufferProperties::Create<GPUMaterialTableEntry>(mMaterialSlots.Capacity());
             mMaterialTable = mResourceProducer->NewBuffer(properties);
             mMaterialTable->SetDebugName("Material Table");
+            mMaterialTable->RequestWrite();
+
+            for (Material& material : materials)
+            {
+                GPUMaterialTableEntry materialEntry = CreateMaterialGPUTableEntry(material);
+                mMaterialTable->Write(&materialEntry, material.GPUMaterialTableIndex, 1);
+                material.GPUTextureRelocationCount = MaterialTextureRelocationCount(material);
+            }
+
+            return;
         }
 
-        mMaterialTable->RequestWrite();
+        // Instance table picks up new indices when it's uploaded later in the frame
+        if (ShouldCompact(mMaterialSlots))
+        {
+            for (const Memory::CompactingRangeAllocator::Move& move : mMaterialSlots.Compact(MaterialCompactionBudget))
+            {
+                Material* material = reinterpret_cast<Material*>(move.Owner);
+                material->GPUMaterialTableIndex = move.Offset;
+                changedMaterials.push_back(material);
+            }
+        }
 
-        uint64_t materialIndex = 0;
+        std::sort(changedMaterials.begin(), changedMaterials.end());
+        changedMaterials.erase(std::unique(changedMaterials.begin(), changedMaterials.end()), changedMaterials.end());
 
+        for (Material* material : changedMaterials)
+        {
+            GPUMaterialTableEntry materialEntry = CreateMaterialGPUTableEntry(*material);
+            mMaterialTable->WriteRegion(&materialEntry, material->GPUMaterialTableIndex, 1);
+            material->GPUTextureRelocationCount = MaterialTextureRelocationCount(*material);
+        }
+    }
+
+    void SceneGPUStorage::ReleaseMesh(const Mesh& mesh)
+    {
+        uint64_t owner = reinterpret_cast<uint64_t>(&mesh);
+
+        // Mesh was never uploaded
+        if (!mVertexRanges.Contains(owner))
+            return;
+
+        mVertexRanges.Deallocate(owner);
+
+        if (mIndexRanges.Contains(owner))
+            mIndexRanges.Deallocate(owner);
+
+        uint16_t blasIndex = mesh.GetLocationInVertexStorage().BottomAccelerationStructureIndex;
+        BottomRTAS& blas = mBottomAccelerationStructures[blasIndex];
+
+        mBottomAccelerationStructuresToBuild.erase(
+            std::remove(mBottomAccelerationStructuresToBuild.begin(), mBottomAccelerationStructuresToBuild.end(), &blas),
+            mBottomAccelerationStructuresToBuild.end());
+
+        blas.Clear();
+        mFreeBottomAccelerationStructureIndices.push_back(blasIndex);
+    }
+
+    void SceneGPUStorage::ReleaseMaterial(const Material& material)
+    {
+        uint64_t owner = reinterpret_cast<uint64_t>(&material);
+
+        if (mMaterialSlots.Contains(owner))
+            mMaterialSlots.Deallocate(owner);
+    }
+
+    bool SceneGPUStorage::ShouldCompact(const Memory::CompactingRangeAllocator& allocator) const
+    {
+        uint64_t extent = allocator.AllocatedExtent();
+        uint64_t holesSize = extent - allocator.AllocatedSize();
+
+        return holesSize > 0 && holesSize >= extent * CompactionFragmentationThreshold;
+    }
+
+    void SceneGPUStorage::AllocateMeshRanges(Mesh& mesh)
+    {
+        assert_format(!mesh.GetVertices().empty(), "Empty meshes are not allowed");
+
+        uint64_t owner = reinterpret_cast<uint64_t>(&mesh);
+
+        VertexStorageLocation location{};
+        location.VertexCount = mesh.GetVertices().size();
+        location.VertexBufferOffset = mVertexRanges.Allocate(owner, location.VertexCount);
+        location.IndexCount = mesh.GetIndices().size();
+
+        if (location.IndexCount > 0)
+            location.IndexBufferOffset = mIndexRanges.Allocate(owner, location.IndexCount);
+
+        if (!mFreeBottomAccelerationStructureIndices.empty())
+        {
+            location.BottomAccelerationStructureIndex = mFreeBottomAccelerationStructureIndices.back();
+            mFreeBottomAccelerationStructureIndices.pop_back();
+        }
+        else
+        {
+            assert_format(mBottomAccelerationStructures.size() < std::numeric_limits<uint16_t>::max(), "Bottom acceleration structure limit is reached");
+
+            location.BottomAccelerationStructureIndex = mBottomAccelerationStructures.size();
+            // Meshes don't deform, so their structures are compacted once built
+            mBottomAccelerationStructures.emplace_back(mDevice, mResourceProducer, BottomRTAS::Usage::Static);
+            mBottomAccelerationStructures.back().SetDebugName("Mesh Bottom RT AS");
+        }
+
+        mesh.SetVertexStorageLocation(location);
+    }
+
+    void SceneGPUStorage::RecreateGeometryBuffers()
+    {
+        // Both buffers are replaced together since every bottom structure is rebuilt anyway
+        auto vertexProperties = HAL::BufferProperties::Create<Vertex>(mVertexRanges.Capacity());
+        mVertexBuffer = mResourceProducer->NewBuffer(vertexProperties);
+        mVertexBuffer->SetDebugName("Unified Vertex Buffer");
+        // Bottom acceleration structure geometries reference HAL buffers directly
+        mVertexBuffer->DisableRelocation();
+        mVertexBuffer->RequestWrite();
+
+        auto indexProperties = HAL::BufferProperties::Create<uint32_t>(mIndexRanges.Capacity());
+        mIndexBuffer = mResourceProducer->NewBuffer(indexProperties);
+        mIndexBuffer->SetDebugName("Unified Index Buffer");
+        mIndexBuffer->DisableRelocation();
+        mIndexBuffer->RequestWrite();
+
+        ForEachMesh([this](const Mesh& mesh)
+        {
+            const VertexStorageLocation& location = mesh.GetLocationInVertexStorage();
+
+            mVertexBuffer->Write(mesh.GetVertices().data(), location.VertexBufferOffset, location.VertexCount);
+
+            if (location.IndexCount > 0)
+                mIndexBuffer->Write(mesh.GetIndices().data(), location.IndexBufferOffset, location.IndexCount);
+        });
+    }
+
+    void SceneGPUStorage::BuildBottomAccelerationStructure(const Mesh& mesh)
+    {
+        const VertexStorageLocation& location = mesh.GetLocationInVertexStorage();
+        BottomRTAS& blas = mBottomAccelerationStructures[location.BottomAccelerationStructureIndex];
+
+        HAL::RayTracingGeometry blasGeometry{
+            mVertexBuffer->HALBuffer(), location.VertexBufferOffset, location.VertexCount, sizeof(Vertex), HAL::ColorFormat::RGB32_Float,
+            mIndexBuffer->HALBuffer(), location.IndexBufferOffset, location.IndexCount, sizeof(uint32_t), HAL::ColorFormat::R32_Unsigned,
+            glm::mat4x4{}, true
+        };
+
+        blas.Clear();
+        blas.AddGeometry(blasGeometry);
+        blas.Build();
+
+        mBottomAccelerationStructuresToBuild.push_back(&blas);
+    }
+
+    void SceneGPUStorage::UpdateUtilityVertexLocations()
+    {
+        mUnitQuadVertexLocation = mUnitQuad.GetLocationInVertexStorage();
+        mUnitCubeVertexLocation = mScene->GetUnitCube().GetLocationInVertexStorage();
+        mUnitSphereVertexLocation = mScene->GetUnitSphere().GetLocationInVertexStorage();
+    }
+
+    GPUMaterialTableEntry SceneGPUStorage::CreateMaterialGPUTableEntry(const Material& material) const
+    {
         auto getSamplerIndex = [this](Material::WrapMode wrapMode) -> uint32_t
         {
             switch (wrapMode)
@@ -97,51 +343,69 @@ namespace PathFinder
             }
         };
 
-        for (Material& material : materials)
-        {
-            // All ltc look-up tables are expected to be of the same size
-            auto lut0SpecularSize = material.LTC_LUT_MatrixInverse_Specular->HALTexture()->Dimensions();
-
-            GPUMaterialTableEntry materialEntry{
-                material.DiffuseAlbedoMap.Texture->GetSRDescriptor()->IndexInHeapRange(),
-                material.NormalMap.Texture->GetSRDescriptor()->IndexInHeapRange(),
-                material.RoughnessMap.Texture->GetSRDescriptor()->IndexInHeapRange(),
-                material.MetalnessMap.Texture->GetSRDescriptor()->IndexInHeapRange(),
-
-                material.DisplacementMap.Texture->GetSRDescriptor()->IndexInHeapRange(),
-                material.DistanceField.Texture->GetSRDescriptor()->IndexInHeapRange(),
-                material.LTC_LUT_MatrixInverse_Specular->GetSRDescriptor()->IndexInHeapRange(),
-                material.LTC_LUT_Matrix_Specular->GetSRDescriptor()->IndexInHeapRange(),
-                material.LTC_LUT_Terms_Specular->GetSRDescriptor()->IndexInHeapRange(),
-                material.LTC_LUT_MatrixInverse_Diffuse->GetSRDescriptor()->IndexInHeapRange(),
-                material.LTC_LUT_Matrix_Diffuse->GetSRDescriptor()->IndexInHeapRange(),
-                material.LTC_LUT_Terms_Diffuse->GetSRDescriptor()->IndexInHeapRange(),
-                lut0SpecularSize.Width,
-                // Right now we use wrap mode from diffuse albedo and apply it for all textures in material, which should be sufficient.
-                getSamplerIndex(material.DiffuseAlbedoMap.Wrapping),
-                material.NormalMap.Texture->Properties().Dimensions.Width > 1,
-                material.IOROverride.value_or(-1.f),
-                material.DiffuseAlbedoOverride.value_or(glm::vec3{-1.f}),
-                material.RoughnessOverride.value_or(-1.f),
-                material.SpecularAlbedoOverride.value_or(glm::vec3{-1.f}),
-                material.MetalnessOverride.value_or(-1.f),
-                material.TransmissionFilter.value_or(glm::vec3{-1.f}),
-                material.TranslucencyOverride.value_or(-1.f),
-            };
+        // All ltc look-up tables are expected to be of the same size
+        auto lut0SpecularSize = material.LTC_LUT_MatrixInverse_Specular->HALTexture()->Dimensions();
 
-            material.GPUMaterialTableIndex = materialIndex;
+        const HAL::ColorFormat* normalMapFormat = std::get_if<HAL::ColorFormat>(&material.NormalMap.Texture->Properties().Format);
 
-            mMaterialTable->Write(&materialEntry, materialIndex, 1);
-            ++materialIndex;
-        }
+        bool isTwoChannelNormalMap = normalMapFormat && (
+            *normalMapFormat == HAL::ColorFormat::BC5_Unsigned_Norm ||
+            *normalMapFormat == HAL::ColorFormat::BC5_Signed_Norm);
+
+        return{
+            material.DiffuseAlbedoMap.Texture->GetSRDescriptor()->IndexInHeapRange(),
+            material.NormalMap.Texture->GetSRDescriptor()->IndexInHeapRange(),
+            material.RoughnessMap.Texture->GetSRDescriptor()->IndexInHeapRange(),
+            material.MetalnessMap.Texture->GetSRDescriptor()->IndexInHeapRange(),
+
+            material.DisplacementMap.Texture->GetSRDescriptor()->IndexInHeapRange(),
+            material.DistanceField.Texture->GetSRDescriptor()->IndexInHeapRange(),
+            material.LTC_LUT_MatrixInverse_Specular->GetSRDescriptor()->IndexInHeapRange(),
+            material.LTC_LUT_Matrix_Specular->GetSRDescriptor()->IndexInHeapRange(),
+            material.LTC_LUT_Terms_Specular->GetSRDescriptor()->IndexInHeapRange(),
+            material.LTC_LUT_MatrixInverse_Diffuse->GetSRDescriptor()->IndexInHeapRange(),
+            material.LTC_LUT_Matrix_Diffuse->GetSRDescriptor()->IndexInHeapRange(),
+            material.LTC_LUT_Terms_Diffuse->GetSRDescriptor()->IndexInHeapRange(),
+            lut0SpecularSize.Width,
+            // Right now we use wrap mode from diffuse albedo and apply it for all textures in material, which should be sufficient.
+            getSamplerIndex(material.DiffuseAlbedoMap.Wrapping),
+            material.NormalMap.Texture->Properties().Dimensions.Width > 1,
+            material.IOROverride.value_or(-1.f),
+            material.DiffuseAlbedoOverride.value_or(glm::vec3{-1.f}),
+            material.RoughnessOverride.value_or(-1.f),
+            material.SpecularAlbedoOverride.value_or(glm::vec3{-1.f}),
+            material.MetalnessOverride.value_or(-1.f),
+            material.TransmissionFilter.value_or(glm::vec3{-1.f}),
+            material.TranslucencyOverride.value_or(-1.f),
+            isTwoChannelNormalMap
+        };
+    }
+
+    uint64_t SceneGPUStorage::MaterialTextureRelocationCount(const Material& material) const
+    {
+        // Counts only grow, so the sum changes whenever any texture is relocated
+        return material.DiffuseAlbedoMap.Texture->RelocationCount() +
+            material.NormalMap.Texture->RelocationCount() +
+            material.RoughnessMap.Texture->RelocationCount() +
+            material.MetalnessMap.Texture->RelocationCount() +
+            material.DisplacementMap.Texture->RelocationCount() +
+            material.DistanceField.Texture->RelocationCount() +
+            material.LTC_LUT_MatrixInverse_Specular->RelocationCount() +
+            material.LTC_LUT_Matrix_Specular->RelocationCount() +
+            material.LTC_LUT_Terms_Specular->RelocationCount() +
+            material.LTC_LUT_MatrixInverse_Diffuse->RelocationCount() +
+            material.LTC_LUT_Matrix_Diffuse->RelocationCount() +
+            material.LTC_LUT_Terms_Diffuse->RelocationCount();
     }
 
     void SceneGPUStorage::UploadInstances()
     {
+        PF_CPU_ZONE("SceneGPUStorage::UploadInstances");
+
         mTopAccelerationStructure.Clear();
         UploadMeshInstances();
         UploadLights();
-        UploadDebugGIProbes();
+        UploadGIProbeStates();
         mTopAccelerationStructure.Build();
         mScene->MapEntitiesToGPUIndices();
     }
@@ -153,7 +417,7 @@ namespace PathFinder
         auto& rectangularLights = mScene->GetRectangularLights();
         auto& diskLights = mScene->GetDiskLights();
 
-        auto requiredBufferSize = meshInstances.size() + mScene->GetTotalLightCount();
+        auto requiredBufferSize = meshInstances.Size() + mScene->GetTotalLightCount();
 
         if (requiredBufferSize == 0)
             return;
@@ -167,39 +431,45 @@ namespace PathFinder
 
         mMeshInstanceTable->RequestWrite();
 
-        uint32_t instanceIdx = 0;
+        GPUMeshInstanceTableEntry* instanceEntries = mMeshInstanceTable->WriteOnlyPtr<GPUMeshInstanceTableEntry>();
+        const std::vector<Mesh*>& meshes = meshInstances.Meshes();
+        const std::vector<Material*>& materials = meshInstances.Materials();
+        std::vector<uint32_t>& gpuIndices = meshInstances.GPUTableIndices();
 
-        auto uploadInstance = [&](const GPUMeshInstanceTableEntry& gpuInstance, const VertexStorageLocation& vertexLocations, auto&& sceneObject)
+        // Instances take the first table entries in their dense order.
+        // Matrices composed by the transform hierarchy go straight into the upload buffer.
+        Foundation::TaskScheduler::SharedInstance().ParallelFor(meshInstances.Size(), 1024, [&](uint64_t first, uint64_t last)
         {
-            sceneObject.SetIndexInGPUTable(instanceIdx);
+            for (uint32_t index = (uint32_t)first; index < last; ++index)
+            {
+                const VertexStorageLocation& vertexLocations = meshes[index]->GetLocationInVertexStorage();
+                GPUMeshInstanceTableEntry& instanceEntry = instanceEntries[index];
+
+                instanceEntry.InstanceWorldMatrix = meshInstances.WorldMatrix(index);
+                instanceEntry.InstancePrevWorldMatrix = meshInstances.PreviousWorldMatrix(index);
+                instanceEntry.InstanceNormalMatrix = meshInstances.NormalMatrix(index);
+                instanceEntry.MaterialIndex = materials[index]->GPUMaterialTableIndex;
+                instanceEntry.UnifiedVertexBufferOffset = vertexLocations.VertexBufferOffset;
+                instanceEntry.UnifiedIndexBufferOffset = vertexLocations.IndexBufferOffset;
+                instanceEntry.IndexCount = vertexLocations.IndexCount;
+                instanceEntry.HasTangentSpace = meshes[index]->HasTangentSpace();
+                instanceEntry.IsDoubleSided = meshInstances.HasFlag(index, MeshInstanceFlags::DoubleSided);
+
+                gpuIndices[index] = index;
+            }
+        },
+        "SceneGPUStorage::UploadMeshInstances");
 
+        for (uint32_t index = 0; index < meshInstances.Size(); ++index)
+        {
+            const VertexStorageLocation& vertexLocations = meshes[index]->GetLocationInVertexStorage();
             BottomRTAS& blas = mBottomAccelerationStructures[vertexLocations.BottomAccelerationStructureIndex];
 
             HAL::RayTracingTopAccelerationStructure::InstanceInfo instanceInfo{
-                instanceIdx, std::underlying_type_t<GPUInstanceMask>(GPUInstanceMask::Mesh), std::underlying_type_t<GPUInstanceHitGroupContribution>(GPUInstanceHitGroupContribution::Mesh)
-            };
-
-            mTopAccelerationStructure.AddInstance(blas, instanceInfo, gpuInstance.InstanceWorldMatrix);
-            mMeshInstanceTable->Write(&gpuInstance, instanceIdx, 1);
-
-            ++instanceIdx;
-        };
-
-        for (MeshInstance& instance : meshInstances)
-        {
-            GPUMeshInstanceTableEntry instanceEntry{
-                instance.GetTransformation().GetMatrix(),
-                instance.GetPreviousTransformation().GetMatrix(),
-                instance.GetTransformation().GetNormalMatrix(),
-                instance.GetAssociatedMaterial()->GPUMaterialTableIndex,
-                instance.GetAssociatedMesh()->GetLocationInVertexStorage().VertexBufferOffset,
-                instance.GetAssociatedMesh()->GetLocationInVertexStorage().IndexBufferOffset,
-                instance.GetAssociatedMesh()->GetLocationInVertexStorage().IndexCount,
-                instance.GetAssociatedMesh()->HasTangentSpace(),
-                instance.IsDoubleSided()
+                index, std::underlying_type_t<GPUInstanceMask>(GPUInstanceMask::Mesh), std::underlying_type_t<GPUInstanceHitGroupContribution>(GPUInstanceHitGroupContribution::Mesh)
             };
 
-            uploadInstance(instanceEntry, instance.GetAssociatedMesh()->GetLocationInVertexStorage(), instance);
+            mTopAccelerationStructure.AddInstance(blas, instanceInfo, meshInstances.WorldMatrix(index));
         }
     }
 
@@ -264,29 +534,46 @@ namespace PathFinder
         uploadLights(mScene->GetDiskLights(), mLightTablePartitionInfo.EllipticalLightsOffset, mLightTablePartitionInfo.EllipticalLightsCount, mUnitQuadVertexLocation);
     }
 
-    void SceneGPUStorage::UploadDebugGIProbes()
+    void SceneGPUStorage::UploadGIProbeStates()
     {
-        if (!mScene->GetGIManager().GIDebugEnabled)
-            return;
-
-        // We upload probe spheres for debug probe mouse picking 
         const IlluminanceField& L = mScene->GetGIManager().ProbeField;
+        const GIProbeInvalidationGrid& invalidationGrid = mScene->GetGIManager().GetProbeInvalidationGrid();
+        const auto& probeStates = invalidationGrid.ProbeStates();
+        const auto& scheduledProbes = invalidationGrid.ScheduledProbes();
 
-        for (uint32_t probeIdx = 0; probeIdx < L.GetTotalProbeCount(); ++probeIdx)
+        if (!mGIProbeStateTable || mGIProbeStateTable->Capacity<GPUIlluminanceProbeState>() < L.GetTotalProbeCount())
         {
-            glm::vec3 probePosition = L.GetProbePosition(probeIdx);
+            auto stateProperties = HAL::BufferProperties::Create<GPUIlluminanceProbeState>(L.GetTotalProbeCount());
+            mGIProbeStateTable = mResourceProducer->NewBuffer(stateProperties, Memory::GPUResource::AccessStrategy::DirectUpload);
+            mGIProbeStateTable->SetDebugName("GI Probe State Table");
 
-            HAL::RayTracingTopAccelerationStructure::InstanceInfo instanceInfo{
-                probeIdx,
-                std::underlying_type_t<GPUInstanceMask>(GPUInstanceMask::DebugGIProbe),
-                std::underlying_type_t<GPUInstanceHitGroupContribution>(GPUInstanceHitGroupContribution::DebugGIProbe)
-            };
+            auto scheduleProperties = HAL::BufferProperties::Create<uint32_t>(L.GetTotalProbeCount());
+            mGIScheduledProbeTable = mResourceProducer->NewBuffer(scheduleProperties, Memory::GPUResource::AccessStrategy::DirectUpload);
+            mGIScheduledProbeTable->SetDebugName("GI Scheduled Probe Table");
+        }
+
+        mGIProbeStateTable->RequestWrite();
+        mGIScheduledProbeTable->RequestWrite();
 
-            Geometry::Transformation probeTransform{ glm::vec3{L.GetDebugProbeRadius() * 2}, probePosition, glm::quat{} };
+        mGIProbeStateUploadEntries.clear();
 
-            BottomRTAS& blas = mBottomAccelerationStructures[mUnitSphereVertexLocation.BottomAccelerationStructureIndex];
-            mTopAccelerationStructure.AddInstance(blas, instanceInfo, probeTransform.GetMatrix());
+        for (const GIProbeInvalidationGrid::ProbeState& state : probeStates)
+        {
+            mGIProbeStateUploadEntries.push_back({
+                state.IlluminanceHysteresisDecrease,
+                state.DepthHysteresisDecrease,
+                state.UpdatePriority,
+                state.FramesSinceUpdate == 0 // Age is reset for probes scheduled this frame
+            });
         }
+
+        if (!mGIProbeStateUploadEntries.empty())
+            mGIProbeStateTable->Write(mGIProbeStateUploadEntries.data(), 0, mGIProbeStateUploadEntries.size());
+
+        if (!scheduledProbes.empty())
+            mGIScheduledProbeTable->Write(scheduledProbes.data(), 0, scheduledProbes.size());
+
+        mGIScheduledProbeCount = scheduledProbes.size();
     }
 
     GPUCamera SceneGPUStorage::GetCameraGPURepresentation()
@@ -358,9 +645,7 @@ namespace PathFinder
         const IlluminanceField& L = mScene->GetGIManager().ProbeField;
 
         GPUIlluminanceField field{};
-        field.GridSize = L.GetGridSize();
-        field.CellSize = L.GetCellSize();
-        field.GridCornerPosition = L.GetCornerPosition();
+        field.CascadeCount = L.GetCascades().size();
         field.RaysPerProbe = L.GetRaysPerProbe();
         field.TotalProbeCount = L.GetTotalProbeCount();
         field.RayHitInfoTextureSize = { L.GetRayHitInfoTextureSize().Width, L.GetRayHitInfoTextureSize().Height };
@@ -375,9 +660,22 @@ namespace PathFinder
         field.CurrentIlluminanceProbeAtlasTexIdx = 0; // Determined in render pass
         field.CurrentDepthProbeAtlasTexIdx = 0; // Determined in render pass
         field.DebugProbeRadius = L.GetDebugProbeRadius();
-        field.SpawnedProbePlanesCount = L.GetSpawnedProbePlanesCount();
         field.IlluminanceHysteresisDecrease = L.GetIlluminanceHysteresisDecrease();
         field.DepthHysteresisDecrease = L.GetDepthHysteresisDecrease();
+
+        for (uint64_t cascadeIndex = 0; cascadeIndex < L.GetCascades().size(); ++cascadeIndex)
+        {
+            const IlluminanceFieldCascade& cascade = L.GetCascades()[cascadeIndex];
+            GPUIlluminanceFieldCascade& gpuCascade = field.Cascades[cascadeIndex];
+
+            gpuCascade.CornerCell = cascade.GetCornerCell();
+            gpuCascade.CellSize = cascade.GetCellSize();
+            gpuCascade.PreviousCornerCell = cascade.GetPreviousCornerCell();
+            gpuCascade.ProbeOffset = cascade.GetProbeOffset();
+            gpuCascade.GridSize = cascade.GetGridSize();
+            gpuCascade.ProbeCount = cascade.ProbeCount();
+        }
+
         return field;
     }
 
@@ -6,9 +6,11 @@
 #include <HardwareAbstractionLayer/ResourceBarrier.hpp>
 
 #include <Memory/GPUResourceProducer.hpp>
+#include <Memory/CompactingRangeAllocator.hpp>
 
 #include "Mesh.hpp"
-#include "MeshInstance.hpp"
+#include "Material.hpp"
+#include "MeshInstanceStorage.hpp"
 #include "Vertices/Vertex1P1N1UV1T1BT.hpp"
 #include "Vertices/Vertex1P1N1UV.hpp"
 #include "Vertices/Vertex1P3.hpp"
@@ -23,14 +25,18 @@
 #include <RenderPipeline/PipelineResourceStorage.hpp>
 
 #include <vector>
+#include <deque>
 #include <memory>
-#include <tuple>
 
 namespace PathFinder
 {
     class Scene;
     struct RenderSettings;
 
+    /// Keeps scene geometry and materials resident in growable GPU buffers.
+    /// Meshes and materials added to the scene are given ranges of the unified vertex, index and material buffers
+    /// and only those ranges are uploaded. Ranges of released meshes and materials are reused,
+    /// and a few ranges per frame are moved down to close holes, with moved contents re-uploaded from CPU copies.
     class SceneGPUStorage
     {
     public:
@@ -42,60 +48,86 @@ namespace PathFinder
             const RenderSurfaceDescription* renderSurfaceDescription,
             const RenderSettings* renderSettings);
 
+        // Uploads meshes and materials that aren't resident yet and runs a compaction step
         void UploadMeshes();
         void UploadMaterials();
         void UploadInstances();
 
+        // Frees GPU ranges of a mesh or material that is about to be removed from the scene
+        void ReleaseMesh(const Mesh& mesh);
+        void ReleaseMaterial(const Material& material);
+
         GPUCamera GetCameraGPURepresentation();
         std::array<ArHosekSkyModelStateGPU, 3> GetSkyGPURepresentation() const;
         GPUIlluminanceField GetIlluminanceFieldGPURepresentation() const;
         uint32_t GetCompressedLightPartitionInfo() const;
 
     private:
-        template <class Vertex>
-        struct UploadBufferPackage
-        {
-            std::vector<Vertex> Vertices;
-            std::vector<uint32_t> Indices;
-            std::vector<VertexStorageLocation> Locations;
-        };
-
-        template <class Vertex>
-        struct FinalBufferPackage
-        {
-            Memory::GPUResourceProducer::BufferPtr VertexBuffer;
-            Memory::GPUResourceProducer::BufferPtr IndexBuffer;
-        };
-
-        template <class Vertex>
-        void SubmitTemporaryBuffersToGPU();
+        using Vertex = Vertex1P1N1UV1T1BT;
+
+        inline static const uint64_t InitialVertexCapacity = 1 << 16;
+        inline static const uint64_t InitialIndexCapacity = 1 << 18;
+        inline static const uint64_t InitialMaterialCapacity = 64;
+
+        // Elements moved by compaction in one frame
+        inline static const uint64_t VertexCompactionBudget = 1 << 16;
+        inline static const uint64_t IndexCompactionBudget = 1 << 18;
+        inline static const uint64_t MaterialCompactionBudget = 64;
+
+        // Compaction starts once holes take this fraction of the used part of a buffer
+        inline static const float CompactionFragmentationThreshold = 0.125f;
+
+        template <class Function>
+        void ForEachMesh(const Function& function);
+
+        bool ShouldCompact(const Memory::CompactingRangeAllocator& allocator) const;
+        void AllocateMeshRanges(Mesh& mesh);
+        void RecreateGeometryBuffers();
+        void BuildBottomAccelerationStructure(const Mesh& mesh);
+        void UpdateUtilityVertexLocations();
+        GPUMaterialTableEntry CreateMaterialGPUTableEntry(const Material& material) const;
+        uint64_t MaterialTextureRelocationCount(const Material& material) const;
 
         void UploadMeshInstances();
         void UploadLights();
-        void UploadDebugGIProbes();
+        void UploadGIProbeStates();
 
         GPULightTableEntry CreateLightGPUTableEntry(const FlatLight& light) const;
         GPULightTableEntry CreateLightGPUTableEntry(const SphericalLight& light) const;
         GPULightTableEntry CreateSunGPUTableEntry(const Sky& sky) const;
 
-        template <class Vertex>
-        VertexStorageLocation WriteToTemporaryBuffers(const Vertex* vertices, uint32_t vertexCount, const uint32_t* indices = nullptr, uint32_t indexCount = 0);
+        // Owners are addresses of meshes and materials
+        Memory::CompactingRangeAllocator mVertexRanges{ InitialVertexCapacity };
+        Memory::CompactingRangeAllocator mIndexRanges{ InitialIndexCapacity };
+        Memory::CompactingRangeAllocator mMaterialSlots{ InitialMaterialCapacity };
 
-        std::tuple<UploadBufferPackage<Vertex1P1N1UV1T1BT>, UploadBufferPackage<Vertex1P1N1UV>, UploadBufferPackage<Vertex1P3>> mUploadBuffers;
-        std::tuple<FinalBufferPackage<Vertex1P1N1UV1T1BT>, FinalBufferPackage<Vertex1P1N1UV>, FinalBufferPackage<Vertex1P3>> mFinalBuffers;
+        Memory::GPUResourceProducer::BufferPtr mVertexBuffer;
+        Memory::GPUResourceProducer::BufferPtr mIndexBuffer;
 
-        std::vector<BottomRTAS> mBottomAccelerationStructures;
+        // Deque keeps addresses stable for the render engine and the top structure, released slots are reused
+        std::deque<BottomRTAS> mBottomAccelerationStructures;
+        std::vector<uint16_t> mFreeBottomAccelerationStructureIndices;
+        std::vector<BottomRTAS*> mBottomAccelerationStructuresToBuild;
         TopRTAS mTopAccelerationStructure;
 
+        // Shares geometry storage with scene meshes
+        Mesh mUnitQuad;
+
         Memory::GPUResourceProducer::BufferPtr mMeshInstanceTable;
         Memory::GPUResourceProducer::BufferPtr mLightTable;
         Memory::GPUResourceProducer::BufferPtr mMaterialTable;
+        Memory::GPUResourceProducer::BufferPtr mGIProbeStateTable;
+        Memory::GPUResourceProducer::BufferPtr mGIScheduledProbeTable;
+
+        // Reused between frames, probe states go to the table in one write
+        std::vector<GPUIlluminanceProbeState> mGIProbeStateUploadEntries;
 
         VertexStorageLocation mUnitQuadVertexLocation;
         VertexStorageLocation mUnitCubeVertexLocation;
         VertexStorageLocation mUnitSphereVertexLocation;
         GPULightTablePartitionInfo mLightTablePartitionInfo;
         uint64_t mCameraJitterFrameIndex = 0;
+        uint64_t mGIScheduledProbeCount = 0;
 
         Scene* mScene;
         const HAL::Device* mDevice;
@@ -105,16 +137,19 @@ namespace PathFinder
         const RenderSettings* mRenderSettings;
 
     public:
-        inline const auto UnifiedVertexBuffer() const { return std::get<FinalBufferPackage<Vertex1P1N1UV1T1BT>>(mFinalBuffers).VertexBuffer.get(); }
-        inline const auto UnifiedIndexBuffer() const { return std::get<FinalBufferPackage<Vertex1P1N1UV1T1BT>>(mFinalBuffers).IndexBuffer.get(); }
+        inline const auto UnifiedVertexBuffer() const { return mVertexBuffer.get(); }
+        inline const auto UnifiedIndexBuffer() const { return mIndexBuffer.get(); }
         inline const auto MeshInstanceTable() const { return mMeshInstanceTable.get(); }
         inline const auto LightTable() const { return mLightTable.get(); }
         inline const auto MaterialTable() const { return mMaterialTable.get(); }
+        inline const auto GIProbeStateTable() const { return mGIProbeStateTable.get(); }
+        inline const auto GIScheduledProbeTable() const { return mGIScheduledProbeTable.get(); }
+        inline auto GIScheduledProbeCount() const { return mGIScheduledProbeCount; }
         inline const auto& LightTablePartitionInfo() const { return mLightTablePartitionInfo; }
         inline const auto& TopAccelerationStructure() const { return mTopAccelerationStructure; }
-        inline const auto& BottomAccelerationStructures() const { return mBottomAccelerationStructures; }
+        inline const auto& BottomAccelerationStructuresToBuild() const { return mBottomAccelerationStructuresToBuild; }
+        inline const auto& VertexRanges() const { return mVertexRanges; }
+        inline const auto& IndexRanges() const { return mIndexRanges; }
     };
 
 }
-
-#include "SceneGPUStorage.inl"
@@ -54,6 +54,8 @@ namespace PathFinder
         // 16 byte boundary
         glm::vec3 TransmissionFilter;
         float TranslucencyOverride;
+        // 16 byte boundary
+        uint32_t HasTwoChannelNormalMap;
     };
 
     struct GPULightTableEntry
@@ -124,18 +126,29 @@ namespace PathFinder
         uint32_t Pad1__;
     };
 
-    struct GPUIlluminanceField
+    struct GPUIlluminanceFieldCascade
     {
-        glm::uvec3 GridSize;
+        glm::ivec3 CornerCell;
         float CellSize;
         // 16 byte boundary
-        glm::vec3 GridCornerPosition;
-        uint32_t RaysPerProbe;
+        glm::ivec3 PreviousCornerCell;
+        uint32_t ProbeOffset;
         // 16 byte boundary
+        glm::uvec3 GridSize;
+        uint32_t ProbeCount;
+    };
+
+    struct GPUIlluminanceField
+    {
+        uint32_t CascadeCount;
+        uint32_t RaysPerProbe;
         uint32_t TotalProbeCount;
-        glm::uvec2 RayHitInfoTextureSize;
         uint32_t RayHitInfoTextureIdx;
         // 16 byte boundary
+        glm::uvec2 RayHitInfoTextureSize;
+        float DebugProbeRadius;
+        uint32_t Pad0__;
+        // 16 byte boundary
         glm::mat4 ProbeRotation;
         // 16 byte boundary
         glm::uvec2 IlluminanceProbeAtlasSize;
@@ -149,13 +162,20 @@ namespace PathFinder
         uint32_t CurrentIlluminanceProbeAtlasTexIdx;
         uint32_t CurrentDepthProbeAtlasTexIdx;
         // 16 byte boundary
-        glm::ivec3 SpawnedProbePlanesCount; // How many probe planes were spawned this frame on each axis
-        float DebugProbeRadius;
-        // 16 byte boundary
         uint32_t PreviousIlluminanceProbeAtlasTexIdx;
         uint32_t PreviousDepthProbeAtlasTexIdx;
         float IlluminanceHysteresisDecrease;
         float DepthHysteresisDecrease;
+        // 16 byte boundary
+        std::array<GPUIlluminanceFieldCascade, 4> Cascades; // Must match IlluminanceField::MaxCascadeCount
+    };
+
+    struct GPUIlluminanceProbeState
+    {
+        float IlluminanceHysteresisDecrease;
+        float DepthHysteresisDecrease;
+        float UpdatePriority;
+        uint32_t IsScheduled;
     };
 
     using GPUInstanceIndex = uint64_t;
@@ -7,13 +7,9 @@
 namespace PathFinder
 {
 
-    Sky::Sky() 
-        : mSkySpectrum{ 25, 400, 700 },
-        mGroundAlbedoSpectrum{ 25, 400, 700 } 
+    bool Sky::ModelParameters::operator==(const ModelParameters& other) const
     {
-        mSkySpectrum.Init();
-        mGroundAlbedoSpectrum.Init();
-        mGroundAlbedoSpectrum.FromRGB(mGroundAlbedo);
+        return Turbidity == other.Turbidity && SunElevation == other.SunElevation && GroundAlbedo == other.GroundAlbedo;
     }
 
     void Sky::UpdateSkyState()
@@ -22,9 +18,18 @@ namespace PathFinder
         // in different frames of reference, which is really confusing.
         float elevationPiOver2AtHorizon = std::acos(mSunDirection.y);
         float elevationPiOver2AtZenith = M_PI_2 - elevationPiOver2AtHorizon;
-        float turbidity = 1.7f;
 
-        uint32_t totalSampleCount = mSkySpectrum.GetSamples().size();
+        ModelParameters parameters{ mTurbidity, elevationPiOver2AtHorizon, mGroundAlbedo };
+
+        // Model state initialization fits the model for every spectral sample and color channel,
+        // which is too costly to repeat while sun and atmosphere stay the same
+        if (mModelParameters == parameters)
+            return;
+
+        mModelParameters = parameters;
+        mGroundAlbedoSpectrum = Foundation::VisibleSpectrum::FromRGB(mGroundAlbedo);
+
+        uint32_t totalSampleCount = Foundation::VisibleSpectrum::SpectralSampleCount;
 
         // Vertical sample angle. For one ray it's just equal to elevation.
         float theta = elevationPiOver2AtHorizon;
@@ -35,23 +40,13 @@ namespace PathFinder
 
         // We compute spectrum for the middle ray at the center of the Sun's disk.
         // For simplicity, we ignore limb darkening.
-        for (uint64_t i = 0; i < totalSampleCount; ++i)
+        for (uint32_t i = 0; i < totalSampleCount; ++i)
         {
-            ArHosekSkyModelState* skyState = arhosekskymodelstate_alloc_init(elevationPiOver2AtHorizon, turbidity, mGroundAlbedoSpectrum[i]);
-            float wavelength = glm::mix(mSkySpectrum.LowestWavelength(), mSkySpectrum.HighestWavelength(), i / float(totalSampleCount));
-            mSkySpectrum[i] = float(arhosekskymodel_solar_radiance(skyState, theta, gamma, wavelength));
-            arhosekskymodelstate_free(skyState);
+            SkyModelStatePtr skyState{ arhosekskymodelstate_alloc_init(elevationPiOver2AtHorizon, mTurbidity, mGroundAlbedoSpectrum[i]), arhosekskymodelstate_free };
+            float wavelength = Foundation::VisibleSpectrum::Wavelength(i);
+            mSkySpectrum[i] = float(arhosekskymodel_solar_radiance(skyState.get(), theta, gamma, wavelength));
         }
 
-        if (mSkyModelStateR)
-            arhosekskymodelstate_free(mSkyModelStateR);
-
-        if (mSkyModelStateG)
-            arhosekskymodelstate_free(mSkyModelStateG);
-
-        if (mSkyModelStateB)
-            arhosekskymodelstate_free(mSkyModelStateB);
-
         glm::vec3 sunLuminance = mSkySpectrum.ToRGB();
         glm::vec3 sunIlluminance = sunLuminance * SunSolidAngle; // Dividing by 1 / PDF
 
@@ -61,9 +56,9 @@ namespace PathFinder
         mSolarIlluminance = sunIlluminance * multiplier;
         mSolarLuminance = sunLuminance * multiplier;
 
-        mSkyModelStateR = arhosek_rgb_skymodelstate_alloc_init(turbidity, mGroundAlbedo.r, elevationPiOver2AtZenith);
-        mSkyModelStateG = arhosek_rgb_skymodelstate_alloc_init(turbidity, mGroundAlbedo.g, elevationPiOver2AtZenith);
-        mSkyModelStateB = arhosek_rgb_skymodelstate_alloc_init(turbidity, mGroundAlbedo.b, elevationPiOver2AtZenith);
+        mSkyModelStateR.reset(arhosek_rgb_skymodelstate_alloc_init(mTurbidity, mGroundAlbedo.r, elevationPiOver2AtZenith));
+        mSkyModelStateG.reset(arhosek_rgb_skymodelstate_alloc_init(mTurbidity, mGroundAlbedo.g, elevationPiOver2AtZenith));
+        mSkyModelStateB.reset(arhosek_rgb_skymodelstate_alloc_init(mTurbidity, mGroundAlbedo.b, elevationPiOver2AtZenith));
     }
 
     void Sky::UpdatePreviousFrameValues()
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <glm/vec3.hpp>
-#include <Foundation/Spectrum.hpp>
+#include <Foundation/FixedSpectrum.hpp>
 #include <hoseksky/ArHosekSkyModel.h>
 
+#include <memory>
+#include <optional>
+
 namespace PathFinder 
 {
 
@@ -14,31 +17,44 @@ namespace PathFinder
         inline static const float SunSolidAngle = 0.00006807; // Average solid angle as seen from Earth
         inline static const float SunDiskRadius = 0.00471242378; // tan(SunAngularRadius). Disk is at a distance 1 from a surface.
 
-        Sky();
-
+        // Rebuilds model states and solar values when turbidity, ground albedo or sun elevation changed
         void UpdateSkyState();
         void UpdatePreviousFrameValues();
 
     private:
+        using SkyModelStatePtr = std::unique_ptr<ArHosekSkyModelState, decltype(&arhosekskymodelstate_free)>;
+
+        // Everything sky model states are computed from
+        struct ModelParameters
+        {
+            float Turbidity = 0.0f;
+            float SunElevation = 0.0f;
+            glm::vec3 GroundAlbedo{ 0.0f };
+
+            bool operator==(const ModelParameters& other) const;
+        };
+
+        float mTurbidity = 1.7f;
         glm::vec3 mGroundAlbedo = glm::vec3{ 0.5f };
         glm::vec3 mSolarIlluminance = glm::vec3{ 1.0f };
         glm::vec3 mSolarLuminance = glm::vec3{ 1.0f };
         glm::vec3 mSunDirection = glm::vec3{ 0.0, 1.0, 0.0 };
         glm::vec3 mPreviousSunDirection = glm::vec3{ 0.0, 1.0, 0.0 };
-        Foundation::SampledSpectrum mSkySpectrum;
-        Foundation::SampledSpectrum mGroundAlbedoSpectrum;
-        ArHosekSkyModelState* mSkyModelStateR = nullptr;
-        ArHosekSkyModelState* mSkyModelStateG = nullptr;
-        ArHosekSkyModelState* mSkyModelStateB = nullptr;
+        Foundation::VisibleSpectrum mSkySpectrum;
+        Foundation::VisibleSpectrum mGroundAlbedoSpectrum;
+        std::optional<ModelParameters> mModelParameters;
+        SkyModelStatePtr mSkyModelStateR{ nullptr, arhosekskymodelstate_free };
+        SkyModelStatePtr mSkyModelStateG{ nullptr, arhosekskymodelstate_free };
+        SkyModelStatePtr mSkyModelStateB{ nullptr, arhosekskymodelstate_free };
 
     public:
         inline const glm::vec3& GetSolarIlluminance() const { return mSolarIlluminance; }
         inline const glm::vec3& GetSunDirection() const { return mSunDirection; }
         inline const glm::vec3& GetPreviousSunDirection() const { return mPreviousSunDirection; }
         inline const glm::vec3& GetSolarLuminance() const { return mSolarLuminance; }
-        inline const ArHosekSkyModelState* GetSkyModelStateR() const { return mSkyModelStateR; }
-        inline const ArHosekSkyModelState* GetSkyModelStateG() const { return mSkyModelStateG; }
-        inline const ArHosekSkyModelState* GetSkyModelStateB() const { return mSkyModelStateB; }
+        inline const ArHosekSkyModelState* GetSkyModelStateR() const { return mSkyModelStateR.get(); }
+        inline const ArHosekSkyModelState* GetSkyModelStateG() const { return mSkyModelStateG.get(); }
+        inline const ArHosekSkyModelState* GetSkyModelStateB() const { return mSkyModelStateB.get(); }
         void SetSunDirection(const glm::vec3& direction);
     };
 
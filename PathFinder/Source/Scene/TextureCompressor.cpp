@@ -0,0 +1,1969 @@
+#include "TextureCompressor.hpp"
+
+#include <Foundation/Assert.hpp>
+
+#include <bitsery/adapter/stream.h>
+#include <bitsery/traits/vector.h>
+
+#include <robinhood/robin_hood.h>
+
+#include <glm/geometric.hpp>
+#include <glm/gtc/packing.hpp>
+#include <glm/gtc/color_space.hpp>
+
+#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cfloat>
+#include <iterator>
+#include <type_traits>
+#include <immintrin.h>
+
+namespace PathFinder
+{
+
+    namespace
+    {
+        const uint64_t BlockDimension = 4;
+        const uint64_t BlockTexelCount = 16;
+        const uint64_t MaxPaletteSize = 16;
+
+        const uint32_t WholeBlockMask = 0xFFFF;
+        const uint32_t PartitionCount = 64;
+
+        // Interpolation weights of 2, 3 and 4-bit indices, shared by BC6H and BC7
+        const int32_t IndexWeights2Bit[4] = { 0, 21, 43, 64 };
+        const int32_t IndexWeights3Bit[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+        const int32_t IndexWeights4Bit[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+        // Shapes of two subset partitions, bit i is the subset of texel i.
+        // BC6H two region modes address the first 32.
+        const uint16_t TwoSubsetPartitions[PartitionCount] = {
+            0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80, 0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+            0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE, 0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+            0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A, 0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+            0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C, 0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22
+        };
+
+        // Texel of the second subset whose index has its most significant bit implicitly zero, the first subset's one is texel 0
+        const uint8_t TwoSubsetAnchors[PartitionCount] = {
+            15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+            15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+            15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+            6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15
+        };
+
+        // Largest finite value of an unsigned BC6H half
+        const uint16_t MaxUnsignedHalf = 0x7BFF;
+
+        struct CompressionCacheRecord
+        {
+            uint32_t Version = 0;
+            uint64_t InputHash = 0;
+            TextureCompressor::CompressedTexture Texture;
+
+            template <typename S>
+            void serialize(S& s)
+            {
+                s.value4b(Version);
+                s.value8b(InputHash);
+                s.object(Texture);
+            }
+        };
+
+        class BlockBitWriter
+        {
+        public:
+            BlockBitWriter(uint8_t* block) : mBlock{ block } { std::fill(block, block + 16, uint8_t(0)); }
+
+            void Write(uint32_t value, uint32_t bitCount)
+            {
+                for (uint32_t bit = 0; bit < bitCount; ++bit, ++mPosition)
+                {
+                    if ((value >> bit) & 1)
+                        mBlock[mPosition / 8] |= uint8_t(1 << (mPosition % 8));
+                }
+            }
+
+        private:
+            uint8_t* mBlock;
+            uint32_t mPosition = 0;
+        };
+
+        class BlockBitReader
+        {
+        public:
+            BlockBitReader(const uint8_t* block) : mBlock{ block } {}
+
+            uint32_t Read(uint32_t bitCount)
+            {
+                uint32_t value = 0;
+
+                for (uint32_t bit = 0; bit < bitCount; ++bit, ++mPosition)
+                {
+                    value |= uint32_t((mBlock[mPosition / 8] >> (mPosition % 8)) & 1) << bit;
+                }
+
+                return value;
+            }
+
+        private:
+            const uint8_t* mBlock;
+            uint32_t mPosition = 0;
+        };
+
+        // Block texels in the domain a particular format is fitted in, stored by channel for the SIMD index search
+        struct BlockPoints
+        {
+            alignas(16) float Values[4][BlockTexelCount] = {};
+            uint64_t ChannelCount = 0;
+        };
+
+        using Palette = float[MaxPaletteSize][4];
+        using BlockIndices = uint32_t[BlockTexelCount];
+
+        const int32_t* IndexWeights(uint32_t indexBitCount)
+        {
+            return indexBitCount == 2 ? IndexWeights2Bit : (indexBitCount == 3 ? IndexWeights3Bit : IndexWeights4Bit);
+        }
+
+        uint32_t PartitionSubsetMask(uint32_t partition, uint32_t subset)
+        {
+            return subset == 0 ? ~uint32_t(TwoSubsetPartitions[partition]) & WholeBlockMask : TwoSubsetPartitions[partition];
+        }
+
+        // Endpoints at the extremes of the principal axis of subset texels
+        void FitPrincipalEndpoints(const BlockPoints& points, uint32_t subsetMask, uint32_t iterationCount, float* endpoint0, float* endpoint1)
+        {
+            const uint64_t channelCount = points.ChannelCount;
+
+            float mean[4] = {};
+            float minimum[4] = { FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX };
+            float maximum[4] = { -FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX };
+            float texelCount = 0.0f;
+
+            for (uint64_t texel = 0; texel < BlockTexelCount; ++texel)
+            {
+                if (!((subsetMask >> texel) & 1))
+                    continue;
+
+                texelCount += 1.0f;
+
+                for (uint64_t c = 0; c < channelCount; ++c)
+                {
+                    mean[c] += points.Values[c][texel];
+                    minimum[c] = std::min(minimum[c], points.Values[c][texel]);
+                    maximum[c] = std::max(maximum[c], points.Values[c][texel]);
+                }
+            }
+
+            for (uint64_t c = 0; c < channelCount; ++c)
+            {
+                mean[c] /= texelCount;
+            }
+
+            float covariance[4][4] = {};
+
+            for (uint64_t texel = 0; texel < BlockTexelCount; ++texel)
+            {
+                if (!((subsetMask >> texel) & 1))
+                    continue;
+
+                for (uint64_t i = 0; i < channelCount; ++i)
+                {
+                    for (uint64_t j = 0; j < channelCount; ++j)
+                    {
+                        covariance[i][j] += (points.Values[i][texel] - mean[i]) * (points.Values[j][texel] - mean[j]);
+                    }
+                }
+            }
+
+            // Power iteration starting from the bounding box diagonal
+            float axis[4] = {};
+
+            for (uint64_t c = 0; c < channelCount; ++c)
+            {
+                axis[c] = maximum[c] - minimum[c];
+            }
+
+            for (uint32_t iteration = 0; iteration < iterationCount; ++iteration)
+            {
+                float nextAxis[4] = {};
+                float lengthSquared = 0.0f;
+
+                for (uint64_t i = 0; i < channelCount; ++i)
+                {
+                    for (uint64_t j = 0; j < channelCount; ++j)
+                    {
+                        nextAxis[i] += covariance[i][j] * axis[j];
+                    }
+
+                    lengthSquared += nextAxis[i] * nextAxis[i];
+                }
+
+                if (lengthSquared < 1e-12f)
+                    break;
+
+                float inverseLength = 1.0f / std::sqrt(lengthSquared);
+
+                for (uint64_t c = 0; c < channelCount; ++c)
+                {
+                    axis[c] = nextAxis[c] * inverseLength;
+                }
+            }
+
+            float axisLengthSquared = 0.0f;
+
+            for (uint64_t c = 0; c < channelCount; ++c)
+            {
+                axisLengthSquared += axis[c] * axis[c];
+            }
+
+            float minProjection = 0.0f;
+            float maxProjection = 0.0f;
+
+            if (axisLengthSquared > 1e-12f)
+            {
+                minProjection = FLT_MAX;
+                maxProjection = -FLT_MAX;
+
+                for (uint64_t texel = 0; texel < BlockTexelCount; ++texel)
+                {
+                    if (!((subsetMask >> texel) & 1))
+                        continue;
+
+                    float projection = 0.0f;
+
+                    for (uint64_t c = 0; c < channelCount; ++c)
+                    {
+                        projection += (points.Values[c][texel] - mean[c]) * axis[c];
+                    }
+
+                    minProjection = std::min(minProjection, projection);
+                    maxProjection = std::max(maxProjection, projection);
+                }
+
+                minProjection /= axisLengthSquared;
+                maxProjection /= axisLengthSquared;
+            }
+
+            for (uint64_t c = 0; c < channelCount; ++c)
+            {
+                endpoint0[c] = mean[c] + axis[c] * minProjection;
+                endpoint1[c] = mean[c] + axis[c] * maxProjection;
+            }
+        }
+
+        // Picks the closest palette entry for four texels at a time.
+        // Indices of texels outside of the subset are left untouched.
+        float AssignIndices(const BlockPoints& points, const Palette& palette, uint64_t paletteSize, uint32_t subsetMask, BlockIndices& indices)
+        {
+            float totalError = 0.0f;
+
+            for (uint64_t group = 0; group < BlockTexelCount; group += 4)
+            {
+                uint32_t groupMask = (subsetMask >> group) & 0xF;
+
+                if (!groupMask)
+                    continue;
+
+                __m128 bestError = _mm_set1_ps(FLT_MAX);
+                __m128i bestIndex = _mm_setzero_si128();
+
+                for (uint64_t entry = 0; entry < paletteSize; ++entry)
+                {
+                    __m128 error = _mm_setzero_ps();
+
+                    for (uint64_t c = 0; c < points.ChannelCount; ++c)
+                    {
+                        __m128 delta = _mm_sub_ps(_mm_load_ps(points.Values[c] + group), _mm_set1_ps(palette[entry][c]));
+                        error = _mm_add_ps(error, _mm_mul_ps(delta, delta));
+                    }
+
+                    // Strict comparison keeps the first of equally good entries
+                    __m128i isBetter = _mm_castps_si128(_mm_cmplt_ps(error, bestError));
+                    bestError = _mm_min_ps(error, bestError);
+                    bestIndex = _mm_or_si128(_mm_and_si128(isBetter, _mm_set1_epi32(int32_t(entry))), _mm_andnot_si128(isBetter, bestIndex));
+                }
+
+                alignas(16) float groupErrors[4];
+                alignas(16) uint32_t groupIndices[4];
+                _mm_store_ps(groupErrors, bestError);
+                _mm_store_si128(reinterpret_cast<__m128i*>(groupIndices), bestIndex);
+
+                for (uint64_t lane = 0; lane < 4; ++lane)
+                {
+                    if ((groupMask >> lane) & 1)
+                    {
+                        indices[group + lane] = groupIndices[lane];
+                        totalError += groupErrors[lane];
+                    }
+                }
+            }
+
+            return totalError;
+        }
+
+        // Least squares endpoints reproducing subset texels best with the chosen indices
+        template <class Codec>
+        bool RefineEndpoints(const BlockPoints& points, const Codec& codec, const BlockIndices& indices, uint32_t subsetMask, float* endpoint0, float* endpoint1)
+        {
+            float a = 0.0f, b = 0.0f, c = 0.0f;
+            float x0[4] = {};
+            float x1[4] = {};
+
+            for (uint64_t texel = 0; texel < BlockTexelCount; ++texel)
+            {
+                if (!((subsetMask >> texel) & 1))
+                    continue;
+
+                float weight = codec.Weight(indices[texel]);
+                float inverseWeight = 1.0f - weight;
+
+                a += inverseWeight * inverseWeight;
+                b += inverseWeight * weight;
+                c += weight * weight;
+
+                for (uint64_t channel = 0; channel < points.ChannelCount; ++channel)
+                {
+                    x0[channel] += inverseWeight * points.Values[channel][texel];
+                    x1[channel] += weight * points.Values[channel][texel];
+                }
+            }
+
+            float determinant = a * c - b * b;
+
+            if (std::abs(determinant) < 1e-6f)
+                return false;
+
+            for (uint64_t channel = 0; channel < points.ChannelCount; ++channel)
+            {
+                endpoint0[channel] = (c * x0[channel] - b * x1[channel]) / determinant;
+                endpoint1[channel] = (a * x1[channel] - b * x0[channel]) / determinant;
+            }
+
+            return true;
+        }
+
+        // Only codecs that pick P-bits by how well the palette fits need texels of the block
+        template <class Codec>
+        typename Codec::Quantized QuantizeEndpoints(const Codec& codec, const BlockPoints& points, uint32_t subsetMask, const float* endpoint0, const float* endpoint1)
+        {
+            if constexpr (std::is_invocable_v<decltype(&Codec::Quantize), const Codec&, const BlockPoints&, uint32_t, const float*, const float*>)
+                return codec.Quantize(points, subsetMask, endpoint0, endpoint1);
+            else
+                return codec.Quantize(endpoint0, endpoint1);
+        }
+
+        // Fits an endpoint pair to subset texels: principal axis estimate followed by
+        // alternating index assignment and least squares endpoint refinement
+        template <class Codec>
+        float FitSubset(const BlockPoints& points, const Codec& codec, uint32_t subsetMask, TextureCompressor::Quality quality,
+            typename Codec::Quantized& bestEndpoints, BlockIndices& bestIndices)
+        {
+            uint32_t powerIterations = quality == TextureCompressor::Quality::Fast ? 2 : 8;
+            uint32_t refinementCount = quality == TextureCompressor::Quality::Fast ? 0 : (quality == TextureCompressor::Quality::Normal ? 1 : 4);
+
+            float endpoint0[4] = {};
+            float endpoint1[4] = {};
+            FitPrincipalEndpoints(points, subsetMask, powerIterations, endpoint0, endpoint1);
+
+            float bestError = FLT_MAX;
+
+            for (uint32_t iteration = 0; iteration <= refinementCount; ++iteration)
+            {
+                Palette palette;
+                BlockIndices indices{};
+                typename Codec::Quantized quantized = QuantizeEndpoints(codec, points, subsetMask, endpoint0, endpoint1);
+                float error = AssignIndices(points, palette, codec.BuildPalette(quantized, palette), subsetMask, indices);
+
+                if (error < bestError)
+                {
+                    bestError = error;
+                    bestEndpoints = quantized;
+
+                    for (uint64_t texel = 0; texel < BlockTexelCount; ++texel)
+                    {
+                        if ((subsetMask >> texel) & 1)
+                            bestIndices[texel] = indices[texel];
+                    }
+                }
+
+                if (bestError <= 0.0f || !RefineEndpoints(points, codec, indices, subsetMask, endpoint0, endpoint1))
+                    break;
+            }
+
+            return bestError;
+        }
+
+        template <class Codec>
+        float EncodeSingleSubset(const BlockPoints& points, const Codec& codec, TextureCompressor::Quality quality, uint8_t* output)
+        {
+            typename Codec::Quantized quantized;
+            BlockIndices indices{};
+            float error = FitSubset(points, codec, WholeBlockMask, quality, quantized, indices);
+            codec.Write(quantized, indices, output);
+            return error;
+        }
+
+        template <class Codec>
+        float PaletteError(const BlockPoints& points, const Codec& codec, const typename Codec::Quantized& quantized, uint32_t subsetMask)
+        {
+            Palette palette;
+            BlockIndices indices;
+            return AssignIndices(points, palette, codec.BuildPalette(quantized, palette), subsetMask, indices);
+        }
+
+        // Most significant bit of an anchor index is implicitly zero, which swapping endpoints
+        // and mirroring indices of the subset achieves without changing decoded texels
+        template <class Quantized>
+        void ClearAnchorIndexMSB(Quantized& quantized, BlockIndices& indices, uint32_t subsetMask, uint64_t anchorTexel, uint32_t indexBitCount)
+        {
+            uint32_t maxIndex = (1u << indexBitCount) - 1;
+
+            if (indices[anchorTexel] <= (maxIndex >> 1))
+                return;
+
+            quantized.SwapEndpoints();
+
+            for (uint64_t texel = 0; texel < BlockTexelCount; ++texel)
+            {
+                if ((subsetMask >> texel) & 1)
+                    indices[texel] = maxIndex - indices[texel];
+            }
+        }
+
+        // Error of snapping subset texels to evenly spaced levels along an unquantized line, four texels at a time
+        float LineError(const BlockPoints& points, uint32_t subsetMask, const float* endpoint0, const float* endpoint1, uint32_t levelCount)
+        {
+            float lengthSquared = 0.0f;
+
+            for (uint64_t c = 0; c < points.ChannelCount; ++c)
+            {
+                lengthSquared += (endpoint1[c] - endpoint0[c]) * (endpoint1[c] - endpoint0[c]);
+            }
+
+            float steps = float(levelCount - 1);
+            __m128 projectionScale = _mm_set1_ps(lengthSquared > 1e-12f ? steps / lengthSquared : 0.0f);
+            __m128 levelScale = _mm_set1_ps(1.0f / steps);
+            __m128 totalError = _mm_setzero_ps();
+
+            for (uint64_t group = 0; group < BlockTexelCount; group += 4)
+            {
+                uint32_t groupMask = (subsetMask >> group) & 0xF;
+
+                if (!groupMask)
+                    continue;
+
+                __m128 projection = _mm_setzero_ps();
+
+                for (uint64_t c = 0; c < points.ChannelCount; ++c)
+                {
+                    __m128 offset = _mm_sub_ps(_mm_load_ps(points.Values[c] + group), _mm_set1_ps(endpoint0[c]));
+                    projection = _mm_add_ps(projection, _mm_mul_ps(offset, _mm_set1_ps(endpoint1[c] - endpoint0[c])));
+                }
+
+                // Nearest level, clamped to the segment
+                __m128 level = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(projection, projectionScale)));
+                __m128 weight = _mm_mul_ps(_mm_min_ps(_mm_max_ps(level, _mm_setzero_ps()), _mm_set1_ps(steps)), levelScale);
+                __m128 error = _mm_setzero_ps();
+
+                for (uint64_t c = 0; c < points.ChannelCount; ++c)
+                {
+                    __m128 reconstructed = _mm_add_ps(_mm_set1_ps(endpoint0[c]), _mm_mul_ps(weight, _mm_set1_ps(endpoint1[c] - endpoint0[c])));
+                    __m128 delta = _mm_sub_ps(_mm_load_ps(points.Values[c] + group), reconstructed);
+                    error = _mm_add_ps(error, _mm_mul_ps(delta, delta));
+                }
+
+                __m128 laneMask = _mm_castsi128_ps(_mm_cmpgt_epi32(
+                    _mm_and_si128(_mm_set1_epi32(int32_t(groupMask)), _mm_setr_epi32(1, 2, 4, 8)), _mm_setzero_si128()));
+
+                totalError = _mm_add_ps(totalError, _mm_and_ps(error, laneMask));
+            }
+
+            alignas(16) float laneErrors[4];
+            _mm_store_ps(laneErrors, totalError);
+
+            return laneErrors[0] + laneErrors[1] + laneErrors[2] + laneErrors[3];
+        }
+
+        // Two subset partitions ordered by the error of a line along the bounding box diagonal of each subset,
+        // so that only the most promising ones get the full fit
+        uint32_t RankPartitions(const BlockPoints& points, uint32_t partitionCount, uint32_t indexBitCount, uint32_t candidateCount, uint32_t* candidates)
+        {
+            float estimates[PartitionCount];
+            uint32_t order[PartitionCount];
+
+            for (uint32_t partition = 0; partition < partitionCount; ++partition)
+            {
+                estimates[partition] = 0.0f;
+                order[partition] = partition;
+
+                for (uint32_t subset = 0; subset < 2; ++subset)
+                {
+                    uint32_t subsetMask = PartitionSubsetMask(partition, subset);
+                    float endpoint0[4] = { FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX };
+                    float endpoint1[4] = { -FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+                    for (uint64_t texel = 0; texel < BlockTexelCount; ++texel)
+                    {
+                        if (!((subsetMask >> texel) & 1))
+                            continue;
+
+                        for (uint64_t c = 0; c < points.ChannelCount; ++c)
+                        {
+                            endpoint0[c] = std::min(endpoint0[c], points.Values[c][texel]);
+                            endpoint1[c] = std::max(endpoint1[c], points.Values[c][texel]);
+                        }
+                    }
+
+                    estimates[partition] += LineError(points, subsetMask, endpoint0, endpoint1, 1 << indexBitCount);
+                }
+            }
+
+            candidateCount = std::min(candidateCount, partitionCount);
+
+            std::partial_sort(order, order + candidateCount, order + partitionCount,
+                [&estimates](uint32_t first, uint32_t second) { return estimates[first] < estimates[second]; });
+
+            std::copy(order, order + candidateCount, candidates);
+
+            return candidateCount;
+        }
+
+        uint32_t PartitionCandidateCount(TextureCompressor::Quality quality)
+        {
+            switch (quality)
+            {
+            case TextureCompressor::Quality::High: return 16;
+            case TextureCompressor::Quality::Normal: return 4;
+            default: return 0;
+            }
+        }
+
+        struct BC1Codec
+        {
+            struct Quantized
+            {
+                uint16_t Color0 = 0;
+                uint16_t Color1 = 0;
+            };
+
+            static uint16_t To565(const float* color)
+            {
+                auto quantize = [](float value, float maximum) { return uint16_t(std::clamp(std::round(value * maximum / 255.0f), 0.0f, maximum)); };
+                return (quantize(color[0], 31.0f) << 11) | (quantize(color[1], 63.0f) << 5) | quantize(color[2], 31.0f);
+            }
+
+            static void Expand565(uint16_t color, float* output)
+            {
+                uint32_t r = (color >> 11) & 31;
+                uint32_t g = (color >> 5) & 63;
+                uint32_t b = color & 31;
+
+                output[0] = float((r << 3) | (r >> 2));
+                output[1] = float((g << 2) | (g >> 4));
+                output[2] = float((b << 3) | (b >> 2));
+                output[3] = 255.0f;
+            }
+
+            Quantized Quantize(const float* endpoint0, const float* endpoint1) const
+            {
+                // Four color mode requires the first endpoint to be larger
+                Quantized quantized{ To565(endpoint0), To565(endpoint1) };
+
+                if (quantized.Color0 < quantized.Color1)
+                    std::swap(quantized.Color0, quantized.Color1);
+
+                return quantized;
+            }
+
+            uint64_t BuildPalette(const Quantized& quantized, Palette& palette) const
+            {
+                Expand565(quantized.Color0, palette[0]);
+                Expand565(quantized.Color1, palette[1]);
+
+                // Equal endpoints switch decoder to three color mode with transparent black,
+                // in which case only the endpoint itself is usable
+                if (quantized.Color0 == quantized.Color1)
+                    return 1;
+
+                for (uint64_t c = 0; c < 4; ++c)
+                {
+                    palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+                    palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+                }
+
+                return 4;
+            }
+
+            float Weight(uint32_t index) const
+            {
+                static const float weights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+                return weights[index];
+            }
+
+            void Write(const Quantized& quantized, const BlockIndices& indices, uint8_t* output) const
+            {
+                uint32_t packedIndices = 0;
+
+                for (uint64_t texel = 0; texel < BlockTexelCount; ++texel)
+                {
+                    packedIndices |= indices[texel] << (texel * 2);
+                }
+
+                std::memcpy(output, &quantized.Color0, 2);
+                std::memcpy(output + 2, &quantized.Color1, 2);
+                std::memcpy(output + 4, &packedIndices, 4);
+            }
+        };
+
+        struct BC4Codec
+        {
+            struct Quantized
+            {
+                uint8_t Value0 = 0;
+                uint8_t Value1 = 0;
+            };
+
+            Quantized Quantize(const float* endpoint0, const float* endpoint1) const
+            {
+                // Eight value mode requires the first endpoint to be larger
+                uint8_t value0 = uint8_t(std::clamp(std::round(endpoint0[0]), 0.0f, 255.0f));
+                uint8_t value1 = uint8_t(std::clamp(std::round(endpoint1[0]), 0.0f, 255.0f));
+                return { std::max(value0, value1), std::min(value0, value1) };
+            }
+
+            uint64_t BuildPalette(const Quantized& quantized, Palette& palette) const
+            {
+                palette[0][0] = quantized.Value0;
+                palette[1][0] = quantized.Value1;
+
+                if (quantized.Value0 == quantized.Value1)
+                    return 1;
+
+                for (uint64_t index = 2; index < 8; ++index)
+                {
+                    palette[index][0] = ((8 - index) * float(quantized.Value0) + (index - 1) * float(quantized.Value1)) / 7.0f;
+                }
+
+                return 8;
+            }
+
+            float Weight(uint32_t index) const
+            {
+                return index < 2 ? float(index) : (index - 1) / 7.0f;
+            }
+
+            void Write(const Quantized& quantized, const BlockIndices& indices, uint8_t* output) const
+            {
+                uint64_t packedIndices = 0;
+
+                for (uint64_t texel = 0; texel < BlockTexelCount; ++texel)
+                {
+                    packedIndices |= uint64_t(indices[texel]) << (texel * 3);
+                }
+
+                output[0] = quantized.Value0;
+                output[1] = quantized.Value1;
+
+                for (uint64_t byte = 0; byte < 6; ++byte)
+                {
+                    output[2 + byte] = uint8_t(packedIndices >> (byte * 8));
+                }
+            }
+        };
+
+        enum class PBitSharing : uint8_t
+        {
+            None, PerSubset, PerEndpoint
+        };
+
+        // Layout of a BC7 mode written by the encoder
+        struct BC7Mode
+        {
+            uint32_t Mode = 0;
+            uint32_t SubsetCount = 1;
+            uint32_t PartitionBitCount = 0;
+            uint32_t RotationBitCount = 0;
+            uint32_t ColorBitCount = 0;
+            // Modes without alpha bits decode as opaque
+            uint32_t AlphaBitCount = 0;
+            PBitSharing PBits = PBitSharing::None;
+            uint32_t IndexBitCount = 0;
+            // Non-zero for modes with separate alpha indices
+            uint32_t AlphaIndexBitCount = 0;
+        };
+
+        // Two opaque subsets with 6-bit endpoints and a P-bit per subset
+        const BC7Mode BC7Mode1{ 1, 2, 6, 0, 6, 0, PBitSharing::PerSubset, 3, 0 };
+        // 7-bit color and 8-bit alpha endpoints indexed separately
+        const BC7Mode BC7Mode5{ 5, 1, 0, 2, 7, 8, PBitSharing::None, 2, 2 };
+        // 7-bit RGBA endpoints with a P-bit per endpoint
+        const BC7Mode BC7Mode6{ 6, 1, 0, 0, 7, 7, PBitSharing::PerEndpoint, 4, 0 };
+
+        const BC7Mode* const BC7Modes[] = { &BC7Mode1, &BC7Mode5, &BC7Mode6 };
+
+        struct BC7Block
+        {
+            const BC7Mode* Mode = &BC7Mode6;
+            uint32_t Partition = 0;
+            // Subset, endpoint, channel
+            uint8_t Endpoints[2][2][4] = {};
+            uint8_t PBits[2][2] = {};
+            BlockIndices Indices = {};
+            BlockIndices AlphaIndices = {};
+        };
+
+        // Endpoint channel expanded to 8 bits the way the decoder does it
+        int32_t ExpandBC7Endpoint(uint32_t value, uint32_t bitCount, PBitSharing pBits, uint32_t pBit)
+        {
+            if (pBits != PBitSharing::None)
+            {
+                value = (value << 1) | pBit;
+                ++bitCount;
+            }
+
+            return int32_t((value << (8 - bitCount)) | (value >> (2 * bitCount - 8)));
+        }
+
+        void WriteBC7Block(const BC7Block& block, uint8_t* output)
+        {
+            const BC7Mode& mode = *block.Mode;
+
+            BlockBitWriter writer{ output };
+            writer.Write(1 << mode.Mode, mode.Mode + 1);
+            writer.Write(block.Partition, mode.PartitionBitCount);
+            // Channels are never rotated
+            writer.Write(0, mode.RotationBitCount);
+
+            for (uint64_t c = 0; c < 4; ++c)
+            {
+                for (uint64_t subset = 0; subset < mode.SubsetCount; ++subset)
+                {
+                    writer.Write(block.Endpoints[subset][0][c], c < 3 ? mode.ColorBitCount : mode.AlphaBitCount);
+                    writer.Write(block.Endpoints[subset][1][c], c < 3 ? mode.ColorBitCount : mode.AlphaBitCount);
+                }
+            }
+
+            for (uint64_t subset = 0; subset < mode.SubsetCount; ++subset)
+            {
+                if (mode.PBits == PBitSharing::PerSubset)
+                    writer.Write(block.PBits[subset][0], 1);
+
+                if (mode.PBits == PBitSharing::PerEndpoint)
+                {
+                    writer.Write(block.PBits[subset][0], 1);
+                    writer.Write(block.PBits[subset][1], 1);
+                }
+            }
+
+            uint64_t anchorTexel = mode.SubsetCount > 1 ? TwoSubsetAnchors[block.Partition] : 0;
+
+            for (uint64_t texel = 0; texel < BlockTexelCount; ++texel)
+            {
+                writer.Write(block.Indices[texel], mode.IndexBitCount - (texel == 0 || texel == anchorTexel));
+            }
+
+            for (uint64_t texel = 0; mode.AlphaIndexBitCount && texel < BlockTexelCount; ++texel)
+            {
+                writer.Write(block.AlphaIndices[texel], mode.AlphaIndexBitCount - (texel == 0));
+            }
+        }
+
+        BC7Block ReadBC7Block(const uint8_t* data)
+        {
+            BlockBitReader reader{ data };
+            uint32_t modeIndex = 0;
+
+            while (modeIndex < 8 && reader.Read(1) == 0)
+            {
+                ++modeIndex;
+            }
+
+            auto modeIt = std::find_if(std::begin(BC7Modes), std::end(BC7Modes), [modeIndex](const BC7Mode* mode) { return mode->Mode == modeIndex; });
+            assert_format(modeIt != std::end(BC7Modes), "Only BC7 modes 1, 5 and 6 written by the encoder can be decoded");
+
+            const BC7Mode& mode = **modeIt;
+            BC7Block block{ &mode, reader.Read(mode.PartitionBitCount) };
+            assert_format(reader.Read(mode.RotationBitCount) == 0, "Only BC7 blocks without channel rotation can be decoded");
+
+            for (uint64_t c = 0; c < 4; ++c)
+            {
+                for (uint64_t subset = 0; subset < mode.SubsetCount; ++subset)
+                {
+                    block.Endpoints[subset][0][c] = uint8_t(reader.Read(c < 3 ? mode.ColorBitCount : mode.AlphaBitCount));
+                    block.Endpoints[subset][1][c] = uint8_t(reader.Read(c < 3 ? mode.ColorBitCount : mode.AlphaBitCount));
+                }
+            }
+
+            for (uint64_t subset = 0; subset < mode.SubsetCount; ++subset)
+            {
+                if (mode.PBits == PBitSharing::PerSubset)
+                    block.PBits[subset][0] = block.PBits[subset][1] = uint8_t(reader.Read(1));
+
+                if (mode.PBits == PBitSharing::PerEndpoint)
+                {
+                    block.PBits[subset][0] = uint8_t(reader.Read(1));
+                    block.PBits[subset][1] = uint8_t(reader.Read(1));
+                }
+            }
+
+            uint64_t anchorTexel = mode.SubsetCount > 1 ? TwoSubsetAnchors[block.Partition] : 0;
+
+            for (uint64_t texel = 0; texel < BlockTexelCount; ++texel)
+            {
+                block.Indices[texel] = reader.Read(mode.IndexBitCount - (texel == 0 || texel == anchorTexel));
+            }
+
+            for (uint64_t texel = 0; mode.AlphaIndexBitCount && texel < BlockTexelCount; ++texel)
+            {
+                block.AlphaIndices[texel] = reader.Read(mode.AlphaIndexBitCount - (texel == 0));
+            }
+
+            return block;
+        }
+
+        // Endpoint pair of a single BC7 subset over the channels of its points
+        struct BC7SubsetCodec
+        {
+            struct Quantized
+            {
+                uint8_t Endpoints[2][4] = {};
+                uint8_t PBits[2] = {};
+
+                void SwapEndpoints()
+                {
+                    std::swap(Endpoints[0], Endpoints[1]);
+                    std::swap(PBits[0], PBits[1]);
+                }
+            };
+
+            uint32_t EndpointBitCount = 7;
+            PBitSharing PBits = PBitSharing::PerEndpoint;
+            uint32_t IndexBitCount = 4;
+            bool SearchPBitsExhaustively = false;
+
+            int32_t Expand(const Quantized& quantized, uint64_t endpoint, uint64_t channel) const
+            {
+                return ExpandBC7Endpoint(quantized.Endpoints[endpoint][channel], EndpointBitCount, PBits, quantized.PBits[endpoint]);
+            }
+
+            void QuantizeEndpoint(const float* endpoint, uint64_t channelCount, uint8_t pBit, uint8_t* output) const
+            {
+                // Scale to the precision of endpoint and P-bit together, P-bit being the least significant one
+                bool hasPBit = PBits != PBitSharing::None;
+                float scale = float((1 << (EndpointBitCount + hasPBit)) - 1) / 255.0f;
+                float maximum = float((1 << EndpointBitCount) - 1);
+
+                for (uint64_t c = 0; c < channelCount; ++c)
+                {
+                    output[c] = uint8_t(std::clamp(std::round((endpoint[c] * scale - pBit) / (hasPBit ? 2.0f : 1.0f)), 0.0f, maximum));
+                }
+            }
+
+            Quantized Quantize(const BlockPoints& points, uint32_t subsetMask, const float* endpoint0, const float* endpoint1) const
+            {
+                const float* endpoints[2] = { endpoint0, endpoint1 };
+                Quantized quantized;
+
+                if (PBits == PBitSharing::None)
+                {
+                    QuantizeEndpoint(endpoint0, points.ChannelCount, 0, quantized.Endpoints[0]);
+                    QuantizeEndpoint(endpoint1, points.ChannelCount, 0, quantized.Endpoints[1]);
+                    return quantized;
+                }
+
+                // A shared P-bit moves both endpoints, so candidates are compared by how well their palettes fit
+                if (PBits == PBitSharing::PerSubset || SearchPBitsExhaustively)
+                {
+                    uint8_t candidateCount = PBits == PBitSharing::PerSubset ? 2 : 4;
+                    float bestError = FLT_MAX;
+
+                    for (uint8_t pBits = 0; pBits < candidateCount; ++pBits)
+                    {
+                        Quantized candidate;
+
+                        for (uint64_t e = 0; e < 2; ++e)
+                        {
+                            candidate.PBits[e] = PBits == PBitSharing::PerSubset ? pBits : (pBits >> e) & 1;
+                            QuantizeEndpoint(endpoints[e], points.ChannelCount, candidate.PBits[e], candidate.Endpoints[e]);
+                        }
+
+                        float error = PaletteError(points, *this, candidate, subsetMask);
+
+                        if (error < bestError)
+                        {
+                            bestError = error;
+                            quantized = candidate;
+                        }
+                    }
+
+                    return quantized;
+                }
+
+                // Pick P-bit closest to each endpoint independently
+                for (uint64_t e = 0; e < 2; ++e)
+                {
+                    float bestError = FLT_MAX;
+
+                    for (uint8_t pBit = 0; pBit < 2; ++pBit)
+                    {
+                        uint8_t candidate[4] = {};
+                        QuantizeEndpoint(endpoints[e], points.ChannelCount, pBit, candidate);
+
+                        float error = 0.0f;
+
+                        for (uint64_t c = 0; c < points.ChannelCount; ++c)
+                        {
+                            float delta = float(ExpandBC7Endpoint(candidate[c], EndpointBitCount, PBits, pBit)) - endpoints[e][c];
+                            error += delta * delta;
+                        }
+
+                        if (error < bestError)
+                        {
+                            bestError = error;
+                            quantized.PBits[e] = pBit;
+                            std::copy(candidate, candidate + 4, quantized.Endpoints[e]);
+                        }
+                    }
+                }
+
+                return quantized;
+            }
+
+            uint64_t BuildPalette(const Quantized& quantized, Palette& palette) const
+            {
+                const int32_t* weights = IndexWeights(IndexBitCount);
+                uint64_t paletteSize = uint64_t(1) << IndexBitCount;
+
+                for (uint64_t index = 0; index < paletteSize; ++index)
+                {
+                    for (uint64_t c = 0; c < 4; ++c)
+                    {
+                        palette[index][c] = float(((64 - weights[index]) * Expand(quantized, 0, c) + weights[index] * Expand(quantized, 1, c) + 32) >> 6);
+                    }
+                }
+
+                return paletteSize;
+            }
+
+            float Weight(uint32_t index) const
+            {
+                return IndexWeights(IndexBitCount)[index] / 64.0f;
+            }
+        };
+
+        void SetBC7Endpoints(const BC7SubsetCodec::Quantized& quantized, uint64_t subset, uint64_t firstChannel, uint64_t channelCount, BC7Block& block)
+        {
+            for (uint64_t e = 0; e < 2; ++e)
+            {
+                std::copy(quantized.Endpoints[e], quantized.Endpoints[e] + channelCount, block.Endpoints[subset][e] + firstChannel);
+                block.PBits[subset][e] = quantized.PBits[e];
+            }
+        }
+
+        float EncodeBC7Mode6(const BlockPoints& points, TextureCompressor::Quality quality, BC7Block& block)
+        {
+            BC7SubsetCodec codec{ 7, PBitSharing::PerEndpoint, 4, quality == TextureCompressor::Quality::High };
+            BC7SubsetCodec::Quantized quantized;
+
+            block = BC7Block{ &BC7Mode6 };
+
+            float error = FitSubset(points, codec, WholeBlockMask, quality, quantized, block.Indices);
+            ClearAnchorIndexMSB(quantized, block.Indices, WholeBlockMask, 0, codec.IndexBitCount);
+            SetBC7Endpoints(quantized, 0, 0, 4, block);
+
+            return error;
+        }
+
+        // Alpha is fitted on its own, which suits blocks where it doesn't follow color
+        float EncodeBC7Mode5(const BlockPoints& points, TextureCompressor::Quality quality, BC7Block& block)
+        {
+            BlockPoints colorPoints = points;
+            colorPoints.ChannelCount = 3;
+
+            BlockPoints alphaPoints;
+            alphaPoints.ChannelCount = 1;
+            std::copy(std::begin(points.Values[3]), std::end(points.Values[3]), alphaPoints.Values[0]);
+
+            BC7SubsetCodec colorCodec{ 7, PBitSharing::None, 2 };
+            BC7SubsetCodec alphaCodec{ 8, PBitSharing::None, 2 };
+            BC7SubsetCodec::Quantized color;
+            BC7SubsetCodec::Quantized alpha;
+
+            block = BC7Block{ &BC7Mode5 };
+
+            float error = FitSubset(colorPoints, colorCodec, WholeBlockMask, quality, color, block.Indices);
+            error += FitSubset(alphaPoints, alphaCodec, WholeBlockMask, quality, alpha, block.AlphaIndices);
+
+            ClearAnchorIndexMSB(color, block.Indices, WholeBlockMask, 0, colorCodec.IndexBitCount);
+            ClearAnchorIndexMSB(alpha, block.AlphaIndices, WholeBlockMask, 0, alphaCodec.IndexBitCount);
+            SetBC7Endpoints(color, 0, 0, 3, block);
+            SetBC7Endpoints(alpha, 0, 3, 1, block);
+
+            return error;
+        }
+
+        // Color points only, opacity error is accounted for by the caller
+        float EncodeBC7Mode1(const BlockPoints& colorPoints, TextureCompressor::Quality quality, uint32_t partition, BC7Block& block)
+        {
+            BC7SubsetCodec codec{ 6, PBitSharing::PerSubset, 3 };
+
+            block = BC7Block{ &BC7Mode1, partition };
+
+            float error = 0.0f;
+
+            for (uint32_t subset = 0; subset < 2; ++subset)
+            {
+                uint32_t subsetMask = PartitionSubsetMask(partition, subset);
+                BC7SubsetCodec::Quantized quantized;
+
+                error += FitSubset(colorPoints, codec, subsetMask, quality, quantized, block.Indices);
+                ClearAnchorIndexMSB(quantized, block.Indices, subsetMask, subset == 0 ? 0 : TwoSubsetAnchors[partition], codec.IndexBitCount);
+                SetBC7Endpoints(quantized, subset, 0, 3, block);
+            }
+
+            return error;
+        }
+
+        // Fast preset keeps to mode 6. Other presets also try separately indexed alpha
+        // and two subset modes over the best ranked partitions, keeping the block with least error.
+        void EncodeBC7(const BlockPoints& points, TextureCompressor::Quality quality, uint8_t* output)
+        {
+            BC7Block bestBlock;
+            BC7Block candidateBlock;
+            float bestError = EncodeBC7Mode6(points, quality, bestBlock);
+
+            auto keepBetter = [&](float error)
+            {
+                if (error < bestError)
+                {
+                    bestError = error;
+                    bestBlock = candidateBlock;
+                }
+            };
+
+            if (quality != TextureCompressor::Quality::Fast && bestError > 0.0f)
+            {
+                keepBetter(EncodeBC7Mode5(points, quality, candidateBlock));
+
+                float opacityError = 0.0f;
+
+                for (uint64_t texel = 0; texel < BlockTexelCount; ++texel)
+                {
+                    opacityError += (255.0f - points.Values[3][texel]) * (255.0f - points.Values[3][texel]);
+                }
+
+                if (opacityError < bestError)
+                {
+                    BlockPoints colorPoints = points;
+                    colorPoints.ChannelCount = 3;
+
+                    uint32_t partitions[PartitionCount];
+                    uint32_t partitionCount = RankPartitions(colorPoints, PartitionCount, BC7Mode1.IndexBitCount, PartitionCandidateCount(quality), partitions);
+
+                    for (uint32_t candidate = 0; candidate < partitionCount; ++candidate)
+                    {
+                        keepBetter(opacityError + EncodeBC7Mode1(colorPoints, quality, partitions[candidate], candidateBlock));
+                    }
+                }
+            }
+
+            WriteBC7Block(bestBlock, output);
+        }
+
+        // Run of endpoint bits in the order a BC6H mode stores them.
+        // Endpoints are numbered w, x, y, z: first and second of each region.
+        struct BC6HBitRun
+        {
+            uint8_t Endpoint;
+            uint8_t Channel;
+            uint8_t FirstBit;
+            uint8_t BitCount;
+        };
+
+        // Layout of a BC6H mode written by the encoder
+        struct BC6HMode
+        {
+            uint32_t ModeBits = 0;
+            uint32_t RegionCount = 1;
+            uint32_t EndpointBitCount = 0;
+            // Non-zero for modes storing endpoints as signed deltas from the first one
+            uint32_t DeltaBitCount = 0;
+            uint32_t IndexBitCount = 0;
+            const BC6HBitRun* Runs = nullptr;
+            uint64_t RunCount = 0;
+        };
+
+        const BC6HBitRun BC6HMode10Runs[] = {
+            { 0, 0, 0, 6 }, { 3, 1, 4, 1 }, { 3, 2, 0, 1 }, { 3, 2, 1, 1 }, { 2, 2, 4, 1 },
+            { 0, 1, 0, 6 }, { 2, 1, 5, 1 }, { 2, 2, 5, 1 }, { 3, 2, 2, 1 }, { 2, 1, 4, 1 },
+            { 0, 2, 0, 6 }, { 3, 1, 5, 1 }, { 3, 2, 3, 1 }, { 3, 2, 5, 1 }, { 3, 2, 4, 1 },
+            { 1, 0, 0, 6 }, { 2, 1, 0, 4 }, { 1, 1, 0, 6 }, { 3, 1, 0, 4 }, { 1, 2, 0, 6 }, { 2, 2, 0, 4 },
+            { 2, 0, 0, 6 }, { 3, 0, 0, 6 }
+        };
+
+        const BC6HBitRun BC6HMode11Runs[] = {
+            { 0, 0, 0, 10 }, { 0, 1, 0, 10 }, { 0, 2, 0, 10 }, { 1, 0, 0, 10 }, { 1, 1, 0, 10 }, { 1, 2, 0, 10 }
+        };
+
+        const BC6HBitRun BC6HMode12Runs[] = {
+            { 0, 0, 0, 10 }, { 0, 1, 0, 10 }, { 0, 2, 0, 10 },
+            { 1, 0, 0, 9 }, { 0, 0, 10, 1 }, { 1, 1, 0, 9 }, { 0, 1, 10, 1 }, { 1, 2, 0, 9 }, { 0, 2, 10, 1 }
+        };
+
+        // Two regions with 6-bit endpoints
+        const BC6HMode BC6HMode10{ 0x1E, 2, 6, 0, 3, BC6HMode10Runs, std::size(BC6HMode10Runs) };
+        // Single region with 10-bit endpoints
+        const BC6HMode BC6HMode11{ 0x03, 1, 10, 0, 4, BC6HMode11Runs, std::size(BC6HMode11Runs) };
+        // Single region with an 11-bit endpoint and a 9-bit delta to the other one
+        const BC6HMode BC6HMode12{ 0x07, 1, 11, 9, 4, BC6HMode12Runs, std::size(BC6HMode12Runs) };
+
+        const BC6HMode* const BC6HModes[] = { &BC6HMode10, &BC6HMode11, &BC6HMode12 };
+
+        struct BC6HBlock
+        {
+            const BC6HMode* Mode = &BC6HMode11;
+            uint32_t Partition = 0;
+            // Region, endpoint, channel
+            uint16_t Endpoints[2][2][3] = {};
+            BlockIndices Indices = {};
+        };
+
+        int32_t UnquantizeBC6HEndpoint(uint32_t value, uint32_t bitCount)
+        {
+            if (value == 0)
+                return 0;
+
+            if (value == (1u << bitCount) - 1)
+                return 0xFFFF;
+
+            return ((int32_t(value) << 16) + 0x8000) >> bitCount;
+        }
+
+        // Interpolated endpoints with the decoder's final scale to unsigned half bits
+        uint32_t InterpolateBC6H(int32_t endpoint0, int32_t endpoint1, int32_t weight)
+        {
+            int32_t interpolated = ((64 - weight) * endpoint0 + weight * endpoint1 + 32) >> 6;
+            return uint32_t((interpolated * 31) >> 6);
+        }
+
+        void WriteBC6HBlock(const BC6HBlock& block, uint8_t* output)
+        {
+            const BC6HMode& mode = *block.Mode;
+            uint32_t fields[4][3] = {};
+
+            for (uint64_t endpoint = 0; endpoint < mode.RegionCount * 2; ++endpoint)
+            {
+                for (uint64_t c = 0; c < 3; ++c)
+                {
+                    uint32_t value = block.Endpoints[endpoint / 2][endpoint % 2][c];
+
+                    // Two's complement delta, truncated to its bit count
+                    if (mode.DeltaBitCount && endpoint > 0)
+                        value = (value - block.Endpoints[0][0][c]) & ((1u << mode.DeltaBitCount) - 1);
+
+                    fields[endpoint][c] = value;
+                }
+            }
+
+            BlockBitWriter writer{ output };
+            writer.Write(mode.ModeBits, 5);
+
+            for (uint64_t run = 0; run < mode.RunCount; ++run)
+            {
+                const BC6HBitRun& bitRun = mode.Runs[run];
+                writer.Write(fields[bitRun.Endpoint][bitRun.Channel] >> bitRun.FirstBit, bitRun.BitCount);
+            }
+
+            if (mode.RegionCount > 1)
+                writer.Write(block.Partition, 5);
+
+            uint64_t anchorTexel = mode.RegionCount > 1 ? TwoSubsetAnchors[block.Partition] : 0;
+
+            for (uint64_t texel = 0; texel < BlockTexelCount; ++texel)
+            {
+                writer.Write(block.Indices[texel], mode.IndexBitCount - (texel == 0 || texel == anchorTexel));
+            }
+        }
+
+        BC6HBlock ReadBC6HBlock(const uint8_t* data)
+        {
+            BlockBitReader reader{ data };
+            uint32_t modeBits = reader.Read(2);
+
+            // Modes with 2 low bits below 2 have no more mode bits
+            if (modeBits >= 2)
+                modeBits |= reader.Read(3) << 2;
+
+            auto modeIt = std::find_if(std::begin(BC6HModes), std::end(BC6HModes), [modeBits](const BC6HMode* mode) { return mode->ModeBits == modeBits; });
+            assert_format(modeIt != std::end(BC6HModes), "Only BC6H modes 10, 11 and 12 written by the encoder can be decoded");
+
+            const BC6HMode& mode = **modeIt;
+            uint32_t fields[4][3] = {};
+
+            for (uint64_t run = 0; run < mode.RunCount; ++run)
+            {
+                const BC6HBitRun& bitRun = mode.Runs[run];
+                fields[bitRun.Endpoint][bitRun.Channel] |= reader.Read(bitRun.BitCount) << bitRun.FirstBit;
+            }
+
+            BC6HBlock block{ &mode, mode.RegionCount > 1 ? reader.Read(5) : 0 };
+
+            for (uint64_t endpoint = 0; endpoint < mode.RegionCount * 2; ++endpoint)
+            {
+                for (uint64_t c = 0; c < 3; ++c)
+                {
+                    uint32_t value = fields[endpoint][c];
+
+                    if (mode.DeltaBitCount && endpoint > 0)
+                    {
+                        int32_t signBit = 1 << (mode.DeltaBitCount - 1);
+                        int32_t delta = (int32_t(value) ^ signBit) - signBit;
+                        value = uint32_t(int32_t(fields[0][c]) + delta) & ((1u << mode.EndpointBitCount) - 1);
+                    }
+
+                    block.Endpoints[endpoint / 2][endpoint % 2][c] = uint16_t(value);
+                }
+            }
+
+            uint64_t anchorTexel = mode.RegionCount > 1 ? TwoSubsetAnchors[block.Partition] : 0;
+
+            for (uint64_t texel = 0; texel < BlockTexelCount; ++texel)
+            {
+                block.Indices[texel] = reader.Read(mode.IndexBitCount - (texel == 0 || texel == anchorTexel));
+            }
+
+            return block;
+        }
+
+        // Unsigned endpoint pair of a single BC6H region, fitted in half float bit space
+        struct BC6HRegionCodec
+        {
+            struct Quantized
+            {
+                uint16_t Endpoints[2][3] = {};
+
+                void SwapEndpoints()
+                {
+                    std::swap(Endpoints[0], Endpoints[1]);
+                }
+            };
+
+            uint32_t EndpointBitCount = 10;
+            uint32_t DeltaBitCount = 0;
+            uint32_t IndexBitCount = 4;
+
+            // Inverse of the decoder's unquantization and final scale to half bits
+            uint16_t QuantizeHalfBits(float halfBits) const
+            {
+                float unquantized = halfBits * 64.0f / 31.0f;
+                float step = float(1 << (16 - EndpointBitCount));
+                return uint16_t(std::clamp(std::round((unquantized - step * 0.5f) / step), 0.0f, float((1 << EndpointBitCount) - 1)));
+            }
+
+            Quantized Quantize(const float* endpoint0, const float* endpoint1) const
+            {
+                Quantized quantized;
+
+                for (uint64_t c = 0; c < 3; ++c)
+                {
+                    quantized.Endpoints[0][c] = QuantizeHalfBits(endpoint0[c]);
+                    quantized.Endpoints[1][c] = QuantizeHalfBits(endpoint1[c]);
+
+                    // Delta range is kept symmetric so that it still fits once endpoints are swapped for the anchor index
+                    if (DeltaBitCount)
+                    {
+                        int32_t maxDelta = (1 << (DeltaBitCount - 1)) - 1;
+                        int32_t delta = std::clamp(int32_t(quantized.Endpoints[1][c]) - int32_t(quantized.Endpoints[0][c]), -maxDelta, maxDelta);
+                        quantized.Endpoints[1][c] = uint16_t(quantized.Endpoints[0][c] + delta);
+                    }
+                }
+
+                return quantized;
+            }
+
+            uint64_t BuildPalette(const Quantized& quantized, Palette& palette) const
+            {
+                const int32_t* weights = IndexWeights(IndexBitCount);
+                uint64_t paletteSize = uint64_t(1) << IndexBitCount;
+
+                for (uint64_t index = 0; index < paletteSize; ++index)
+                {
+                    for (uint64_t c = 0; c < 3; ++c)
+                    {
+                        palette[index][c] = float(InterpolateBC6H(
+                            UnquantizeBC6HEndpoint(quantized.Endpoints[0][c], EndpointBitCount),
+                            UnquantizeBC6HEndpoint(quantized.Endpoints[1][c], EndpointBitCount),
+                            weights[index]));
+                    }
+                }
+
+                return paletteSize;
+            }
+
+            float Weight(uint32_t index) const
+            {
+                return IndexWeights(IndexBitCount)[index] / 64.0f;
+            }
+        };
+
+        float EncodeBC6HMode(const BlockPoints& points, TextureCompressor::Quality quality, const BC6HMode& mode, uint32_t partition, BC6HBlock& block)
+        {
+            BC6HRegionCodec codec{ mode.EndpointBitCount, mode.DeltaBitCount, mode.IndexBitCount };
+
+            block = BC6HBlock{ &mode, partition };
+
+            float error = 0.0f;
+
+            for (uint32_t region = 0; region < mode.RegionCount; ++region)
+            {
+                uint32_t regionMask = mode.RegionCount > 1 ? PartitionSubsetMask(partition, region) : WholeBlockMask;
+                BC6HRegionCodec::Quantized quantized;
+
+                error += FitSubset(points, codec, regionMask, quality, quantized, block.Indices);
+                ClearAnchorIndexMSB(quantized, block.Indices, regionMask, region == 0 ? 0 : TwoSubsetAnchors[partition], codec.IndexBitCount);
+
+                for (uint64_t e = 0; e < 2; ++e)
+                {
+                    std::copy(quantized.Endpoints[e], quantized.Endpoints[e] + 3, block.Endpoints[region][e]);
+                }
+            }
+
+            return error;
+        }
+
+        // Fast preset keeps to mode 11. Other presets also try the delta encoded mode 12
+        // and two region mode 10 over the best ranked partitions, keeping the block with least error.
+        void EncodeBC6H(const BlockPoints& points, TextureCompressor::Quality quality, uint8_t* output)
+        {
+            BC6HBlock bestBlock;
+            BC6HBlock candidateBlock;
+            float bestError = EncodeBC6HMode(points, quality, BC6HMode11, 0, bestBlock);
+
+            auto keepBetter = [&](float error)
+            {
+                if (error < bestError)
+                {
+                    bestError = error;
+                    bestBlock = candidateBlock;
+                }
+            };
+
+            if (quality != TextureCompressor::Quality::Fast && bestError > 0.0f)
+            {
+                keepBetter(EncodeBC6HMode(points, quality, BC6HMode12, 0, candidateBlock));
+
+                // BC6H addresses the first half of the partition table
+                uint32_t partitions[PartitionCount];
+                uint32_t partitionCount = RankPartitions(points, PartitionCount / 2, BC6HMode10.IndexBitCount, PartitionCandidateCount(quality), partitions);
+
+                for (uint32_t candidate = 0; candidate < partitionCount; ++candidate)
+                {
+                    keepBetter(EncodeBC6HMode(points, quality, BC6HMode10, partitions[candidate], candidateBlock));
+                }
+            }
+
+            WriteBC6HBlock(bestBlock, output);
+        }
+
+        void DecodeBC1(const uint8_t* block, glm::vec4* texels)
+        {
+            uint16_t color0, color1;
+            uint32_t packedIndices;
+            std::memcpy(&color0, block, 2);
+            std::memcpy(&color1, block + 2, 2);
+            std::memcpy(&packedIndices, block + 4, 4);
+
+            Palette palette;
+            BC1Codec::Expand565(color0, palette[0]);
+            BC1Codec::Expand565(color1, palette[1]);
+
+            for (uint64_t c = 0; c < 4; ++c)
+            {
+                if (color0 > color1)
+                {
+                    palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+                    palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+                }
+                else
+                {
+                    palette[2][c] = (palette[0][c] + palette[1][c]) / 2.0f;
+                    palette[3][c] = 0.0f;
+                }
+            }
+
+            for (uint64_t texel = 0; texel < BlockTexelCount; ++texel)
+            {
+                const float* entry = palette[(packedIndices >> (texel * 2)) & 3];
+                texels[texel] = glm::vec4{ entry[0], entry[1], entry[2], entry[3] } / 255.0f;
+            }
+        }
+
+        void DecodeBC4(const uint8_t* block, float* values)
+        {
+            float value0 = block[0];
+            float value1 = block[1];
+            float palette[8] = { value0, value1 };
+
+            for (uint64_t index = 2; index < 8; ++index)
+            {
+                if (value0 > value1)
+                {
+                    palette[index] = ((8 - index) * value0 + (index - 1) * value1) / 7.0f;
+                }
+                else
+                {
+                    palette[index] = index < 6 ? ((6 - index) * value0 + (index - 1) * value1) / 5.0f : (index == 6 ? 0.0f : 255.0f);
+                }
+            }
+
+            uint64_t packedIndices = 0;
+
+            for (uint64_t byte = 0; byte < 6; ++byte)
+            {
+                packedIndices |= uint64_t(block[2 + byte]) << (byte * 8);
+            }
+
+            for (uint64_t texel = 0; texel < BlockTexelCount; ++texel)
+            {
+                values[texel] = palette[(packedIndices >> (texel * 3)) & 7] / 255.0f;
+            }
+        }
+
+        void DecodeBC7(const uint8_t* data, glm::vec4* texels)
+        {
+            BC7Block block = ReadBC7Block(data);
+            const BC7Mode& mode = *block.Mode;
+            const int32_t* weights = IndexWeights(mode.IndexBitCount);
+            const int32_t* alphaWeights = IndexWeights(mode.AlphaIndexBitCount);
+
+            for (uint64_t texel = 0; texel < BlockTexelCount; ++texel)
+            {
+                uint64_t subset = mode.SubsetCount > 1 ? (TwoSubsetPartitions[block.Partition] >> texel) & 1 : 0;
+                glm::vec4 value{ 255.0f };
+
+                for (uint64_t c = 0; c < 4; ++c)
+                {
+                    uint32_t bitCount = c < 3 ? mode.ColorBitCount : mode.AlphaBitCount;
+
+                    if (!bitCount)
+                        continue;
+
+                    int32_t endpoint0 = ExpandBC7Endpoint(block.Endpoints[subset][0][c], bitCount, mode.PBits, block.PBits[subset][0]);
+                    int32_t endpoint1 = ExpandBC7Endpoint(block.Endpoints[subset][1][c], bitCount, mode.PBits, block.PBits[subset][1]);
+                    int32_t weight = c == 3 && mode.AlphaIndexBitCount ? alphaWeights[block.AlphaIndices[texel]] : weights[block.Indices[texel]];
+
+                    value[c] = float(((64 - weight) * endpoint0 + weight * endpoint1 + 32) >> 6);
+                }
+
+                texels[texel] = value / 255.0f;
+            }
+        }
+
+        void DecodeBC6H(const uint8_t* data, glm::vec4* texels)
+        {
+            BC6HBlock block = ReadBC6HBlock(data);
+            const BC6HMode& mode = *block.Mode;
+            const int32_t* weights = IndexWeights(mode.IndexBitCount);
+
+            for (uint64_t texel = 0; texel < BlockTexelCount; ++texel)
+            {
+                uint64_t region = mode.RegionCount > 1 ? (TwoSubsetPartitions[block.Partition] >> texel) & 1 : 0;
+                glm::vec4 value{ 1.0f };
+
+                for (uint64_t c = 0; c < 3; ++c)
+                {
+                    uint32_t halfBits = InterpolateBC6H(
+                        UnquantizeBC6HEndpoint(block.Endpoints[region][0][c], mode.EndpointBitCount),
+                        UnquantizeBC6HEndpoint(block.Endpoints[region][1][c], mode.EndpointBitCount),
+                        weights[block.Indices[texel]]);
+
+                    value[c] = glm::unpackHalf1x16(uint16_t(halfBits));
+                }
+
+                texels[texel] = value;
+            }
+        }
+
+        float ToUnsignedHalfBits(float value)
+        {
+            // Negative values and NaNs are not representable in unsigned BC6H
+            if (!(value > 0.0f))
+                return 0.0f;
+
+            return float(std::min(glm::packHalf1x16(std::min(value, 65504.0f)), MaxUnsignedHalf));
+        }
+
+        uint32_t Hash(uint32_t value)
+        {
+            value ^= value >> 16;
+            value *= 0x7feb352d;
+            value ^= value >> 15;
+            value *= 0x846ca68b;
+            value ^= value >> 16;
+            return value;
+        }
+
+        float Noise(uint64_t x, uint64_t y, uint32_t seed)
+        {
+            return Hash(uint32_t(x) * 1973 + Hash(uint32_t(y) * 9277 + seed)) / float(0xFFFFFFFFu);
+        }
+
+        TextureCompressor::Image GenerateSyntheticImage(TextureCompressor::ContentType contentType, uint64_t size)
+        {
+            TextureCompressor::Image image{ size, size };
+            image.Texels.resize(size * size);
+
+            for (uint64_t y = 0; y < size; ++y)
+            {
+                for (uint64_t x = 0; x < size; ++x)
+                {
+                    float u = float(x) / size;
+                    float v = float(y) / size;
+                    float smooth = 0.5f + 0.5f * std::sin(u * 17.0f) * std::cos(v * 11.0f);
+                    float edge = ((x / 64 + y / 64) % 2) ? 0.15f : 0.0f;
+                    float grain = Noise(x, y, 1) * 0.1f;
+                    glm::vec4& texel = image.Texels[y * size + x];
+
+                    switch (contentType)
+                    {
+                    case TextureCompressor::ContentType::Color:
+                        texel = glm::vec4{ smooth * 0.8f + edge + grain, u * 0.7f + grain, 0.3f + 0.5f * v * smooth + edge, 0.5f + 0.5f * std::sin(u * 5.0f) };
+                        break;
+
+                    case TextureCompressor::ContentType::Data:
+                        texel = glm::vec4{ 0.2f + 0.6f * smooth + edge + grain, 0.0f, 0.0f, 1.0f };
+                        break;
+
+                    case TextureCompressor::ContentType::Normal:
+                    {
+                        glm::vec3 normal = glm::normalize(glm::vec3{ -0.6f * std::cos(u * 17.0f) * std::cos(v * 11.0f), 0.4f * std::sin(u * 17.0f) * std::sin(v * 11.0f), 1.0f });
+                        texel = glm::vec4{ normal * 0.5f + 0.5f, 1.0f };
+                        break;
+                    }
+
+                    case TextureCompressor::ContentType::HDRColor:
+                    {
+                        float intensity = std::exp2(10.0f * u - 4.0f) * (0.5f + smooth);
+                        texel = glm::vec4{ intensity, intensity * (0.6f + 0.4f * v), intensity * (0.3f + grain), 1.0f };
+                        break;
+                    }
+                    }
+
+                    texel = contentType == TextureCompressor::ContentType::HDRColor ? texel : glm::clamp(texel, 0.0f, 1.0f);
+                }
+            }
+
+            return image;
+        }
+    }
+
+    TextureCompressor::TextureCompressor(Quality quality, uint64_t threadCount)
+        : mQuality{ quality }, mThreadCount{ threadCount == 1 ? 1 : Foundation::TaskScheduler::SharedInstance().ThreadCount() } {}
+
+    TextureCompressor::CompressedTexture TextureCompressor::Compress(const Image& image, BlockFormat format, ContentType contentType, bool generateMips) const
+    {
+        CompressedTexture texture{ format };
+
+        if (!generateMips)
+        {
+            texture.Mips.push_back(CompressMip(image, format));
+            return texture;
+        }
+
+        for (const Image& mip : GenerateMips(image, contentType))
+        {
+            texture.Mips.push_back(CompressMip(mip, format));
+        }
+
+        return texture;
+    }
+
+    TextureCompressor::CompressedMip TextureCompressor::CompressMip(const Image& image, BlockFormat format) const
+    {
+        uint64_t blockCountX = (image.Width + BlockDimension - 1) / BlockDimension;
+        uint64_t blockCountY = (image.Height + BlockDimension - 1) / BlockDimension;
+        uint64_t blockSize = BlockSizeInBytes(format);
+
+        CompressedMip mip{ image.Width, image.Height };
+        mip.Blocks.resize(blockCountX * blockCountY * blockSize);
+
+        ParallelFor(blockCountY, [&](uint64_t begin, uint64_t end)
+        {
+            glm::vec4 blockTexels[BlockTexelCount];
+
+            for (uint64_t blockY = begin; blockY < end; ++blockY)
+            {
+                for (uint64_t blockX = 0; blockX < blockCountX; ++blockX)
+                {
+                    // Blocks of mips smaller than block size repeat edge texels
+                    for (uint64_t texel = 0; texel < BlockTexelCount; ++texel)
+                    {
+                        uint64_t x = std::min(blockX * BlockDimension + texel % BlockDimension, image.Width - 1);
+                        uint64_t y = std::min(blockY * BlockDimension + texel / BlockDimension, image.Height - 1);
+                        blockTexels[texel] = image.Texels[y * image.Width + x];
+                    }
+
+                    EncodeBlock(blockTexels, format, mip.Blocks.data() + (blockY * blockCountX + blockX) * blockSize);
+                }
+            }
+        });
+
+        return mip;
+    }
+
+    TextureCompressor::Image TextureCompressor::Decompress(const CompressedMip& mip, BlockFormat format)
+    {
+        uint64_t blockCountX = (mip.Width + BlockDimension - 1) / BlockDimension;
+        uint64_t blockCountY = (mip.Height + BlockDimension - 1) / BlockDimension;
+        uint64_t blockSize = BlockSizeInBytes(format);
+
+        Image image{ mip.Width, mip.Height };
+        image.Texels.resize(mip.Width * mip.Height);
+
+        for (uint64_t blockY = 0; blockY < blockCountY; ++blockY)
+        {
+            for (uint64_t blockX = 0; blockX < blockCountX; ++blockX)
+            {
+                const uint8_t* block = mip.Blocks.data() + (blockY * blockCountX + blockX) * blockSize;
+                glm::vec4 texels[BlockTexelCount];
+                float red[BlockTexelCount];
+                float green[BlockTexelCount];
+
+                switch (format)
+                {
+                case BlockFormat::BC1: DecodeBC1(block, texels); break;
+                case BlockFormat::BC7: DecodeBC7(block, texels); break;
+                case BlockFormat::BC6H: DecodeBC6H(block, texels); break;
+
+                case BlockFormat::BC4:
+                    DecodeBC4(block, red);
+                    for (uint64_t texel = 0; texel < BlockTexelCount; ++texel) texels[texel] = glm::vec4{ red[texel], 0.0f, 0.0f, 1.0f };
+                    break;
+
+                case BlockFormat::BC5:
+                    DecodeBC4(block, red);
+                    DecodeBC4(block + 8, green);
+                    for (uint64_t texel = 0; texel < BlockTexelCount; ++texel) texels[texel] = glm::vec4{ red[texel], green[texel], 0.0f, 1.0f };
+                    break;
+                }
+
+                for (uint64_t texel = 0; texel < BlockTexelCount; ++texel)
+                {
+                    uint64_t x = blockX * BlockDimension + texel % BlockDimension;
+                    uint64_t y = blockY * BlockDimension + texel / BlockDimension;
+
+                    if (x < mip.Width && y < mip.Height)
+                        image.Texels[y * mip.Width + x] = texels[texel];
+                }
+            }
+        }
+
+        return image;
+    }
+
+    std::vector<TextureCompressor::Image> TextureCompressor::GenerateMips(const Image& image, ContentType contentType)
+    {
+        auto toLinear = [contentType](glm::vec4 texel)
+        {
+            switch (contentType)
+            {
+            case ContentType::Color: return glm::vec4{ glm::convertSRGBToLinear(glm::vec3{ texel }), texel.a };
+            case ContentType::Normal: return glm::vec4{ glm::vec3{ texel } * 2.0f - 1.0f, texel.a };
+            default: return texel;
+            }
+        };
+
+        auto fromLinear = [contentType](glm::vec4 texel)
+        {
+            switch (contentType)
+            {
+            case ContentType::Color: return glm::vec4{ glm::convertLinearToSRGB(glm::max(glm::vec3{ texel }, 0.0f)), texel.a };
+            case ContentType::Normal: return glm::vec4{ glm::vec3{ texel } * 0.5f + 0.5f, texel.a };
+            default: return texel;
+            }
+        };
+
+        std::vector<Image> mips{ image };
+
+        // Filter from the linear previous level to avoid accumulating encoding round trips
+        Image linear = image;
+        std::transform(linear.Texels.begin(), linear.Texels.end(), linear.Texels.begin(), toLinear);
+
+        while (linear.Width > 1 || linear.Height > 1)
+        {
+            Image next{ std::max<uint64_t>(linear.Width / 2, 1), std::max<uint64_t>(linear.Height / 2, 1) };
+            next.Texels.resize(next.Width * next.Height);
+
+            for (uint64_t y = 0; y < next.Height; ++y)
+            {
+                uint64_t y0 = std::min(y * 2, linear.Height - 1);
+                uint64_t y1 = std::min(y * 2 + 1, linear.Height - 1);
+
+                for (uint64_t x = 0; x < next.Width; ++x)
+                {
+                    uint64_t x0 = std::min(x * 2, linear.Width - 1);
+                    uint64_t x1 = std::min(x * 2 + 1, linear.Width - 1);
+
+                    glm::vec4 average = 0.25f * (
+                        linear.Texels[y0 * linear.Width + x0] + linear.Texels[y0 * linear.Width + x1] +
+                        linear.Texels[y1 * linear.Width + x0] + linear.Texels[y1 * linear.Width + x1]);
+
+                    if (contentType == ContentType::Normal && glm::length(glm::vec3{ average }) > 1e-6f)
+                        average = glm::vec4{ glm::normalize(glm::vec3{ average }), average.a };
+
+                    next.Texels[y * next.Width + x] = average;
+                }
+            }
+
+            Image& mip = mips.emplace_back(next);
+            std::transform(mip.Texels.begin(), mip.Texels.end(), mip.Texels.begin(), fromLinear);
+            linear = std::move(next);
+        }
+
+        return mips;
+    }
+
+    bool TextureCompressor::IsCompressible(uint64_t width, uint64_t height)
+    {
+        return width > 0 && height > 0 && width % BlockDimension == 0 && height % BlockDimension == 0;
+    }
+
+    uint64_t TextureCompressor::BlockSizeInBytes(BlockFormat format)
+    {
+        return format == BlockFormat::BC1 || format == BlockFormat::BC4 ? 8 : 16;
+    }
+
+    const char* TextureCompressor::FormatName(BlockFormat format)
+    {
+        switch (format)
+        {
+        case BlockFormat::BC1: return "bc1";
+        case BlockFormat::BC4: return "bc4";
+        case BlockFormat::BC5: return "bc5";
+        case BlockFormat::BC6H: return "bc6h";
+        default: return "bc7";
+        }
+    }
+
+    float TextureCompressor::PSNR(const Image& reference, const Image& test, uint64_t channelCount, bool isHDR)
+    {
+        assert_format(reference.Texels.size() == test.Texels.size(), "Images of different size can't be compared");
+
+        auto map = [isHDR](float value)
+        {
+            return isHDR ? std::max(value, 0.0f) / (1.0f + std::max(value, 0.0f)) : std::clamp(value, 0.0f, 1.0f);
+        };
+
+        double squaredErrorSum = 0.0;
+
+        for (uint64_t texel = 0; texel < reference.Texels.size(); ++texel)
+        {
+            for (uint64_t c = 0; c < channelCount; ++c)
+            {
+                double delta = map(reference.Texels[texel][c]) - map(test.Texels[texel][c]);
+                squaredErrorSum += delta * delta;
+            }
+        }
+
+        double meanSquaredError = squaredErrorSum / double(reference.Texels.size() * channelCount);
+
+        // Cap identical images to keep reports finite
+        return meanSquaredError > 1e-10 ? float(10.0 * std::log10(1.0 / meanSquaredError)) : 100.0f;
+    }
+
+    uint64_t TextureCompressor::InputHash(const Image& image, BlockFormat format, ContentType contentType, Quality quality)
+    {
+        uint64_t texelsHash = robin_hood::hash_bytes(image.Texels.data(), image.Texels.size() * sizeof(glm::vec4));
+
+        uint64_t inputData[] = {
+            texelsHash, image.Width, image.Height,
+            uint64_t(format), uint64_t(contentType), uint64_t(quality), CacheVersion
+        };
+
+        return robin_hood::hash_bytes(inputData, sizeof(inputData));
+    }
+
+    bool TextureCompressor::SaveCache(const std::filesystem::path& path, uint64_t inputHash, const CompressedTexture& texture)
+    {
+        std::fstream stream{ path, std::ios::binary | std::ios::trunc | std::ios::out };
+
+        if (!stream.is_open())
+            return false;
+
+        CompressionCacheRecord record{ CacheVersion, inputHash, texture };
+
+        bitsery::Serializer<bitsery::OutputBufferedStreamAdapter> ser{ stream };
+        ser.object(record);
+        ser.adapter().flush();
+
+        return stream.good();
+    }
+
+    std::optional<TextureCompressor::CompressedTexture> TextureCompressor::LoadCache(const std::filesystem::path& path, uint64_t inputHash)
+    {
+        std::fstream stream{ path, std::ios::binary | std::ios::in };
+
+        if (!stream.is_open())
+            return std::nullopt;
+
+        CompressionCacheRecord record;
+        bitsery::Deserializer<bitsery::InputStreamAdapter> des{ stream };
+        des.object(record);
+
+        if (des.adapter().error() != bitsery::ReaderError::NoError || record.Version != CacheVersion || record.InputHash != inputHash || record.Texture.Mips.empty())
+            return std::nullopt;
+
+        for (const CompressedMip& mip : record.Texture.Mips)
+        {
+            uint64_t blockCount = ((mip.Width + BlockDimension - 1) / BlockDimension) * ((mip.Height + BlockDimension - 1) / BlockDimension);
+
+            if (mip.Blocks.size() != blockCount * BlockSizeInBytes(record.Texture.Format))
+                return std::nullopt;
+        }
+
+        return std::move(record.Texture);
+    }
+
+    bool TextureCompressor::RunBenchmark(const std::filesystem::path& reportPath)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        struct Case
+        {
+            BlockFormat Format;
+            ContentType Content;
+            uint64_t ChannelCount;
+        };
+
+        const uint64_t imageSize = 1024;
+        const Case cases[] = {
+            { BlockFormat::BC1, ContentType::Color, 3 },
+            { BlockFormat::BC7, ContentType::Color, 4 },
+            { BlockFormat::BC4, ContentType::Data, 1 },
+            { BlockFormat::BC5, ContentType::Normal, 2 },
+            { BlockFormat::BC6H, ContentType::HDRColor, 3 }
+        };
+
+        std::ofstream stream{ reportPath, std::ios::out | std::ios::trunc };
+
+        if (!stream.is_open())
+            return false;
+
+        stream.precision(6);
+        stream << "{\"units\":\"megapixels per second, dB\",\"imageSize\":" << imageSize << ",\"threads\":" << TextureCompressor{}.ThreadCount() << ",\"results\":[\n";
+
+        bool isFirstResult = true;
+        bool passed = true;
+
+        for (const Case& benchmarkCase : cases)
+        {
+            Image image = GenerateSyntheticImage(benchmarkCase.Content, imageSize);
+
+            Clock::time_point mipStart = Clock::now();
+            std::vector<Image> mips = GenerateMips(image, benchmarkCase.Content);
+            double mipDuration = std::chrono::duration<double>(Clock::now() - mipStart).count();
+
+            for (Quality quality : { Quality::Fast, Quality::Normal, Quality::High })
+            {
+                TextureCompressor compressor{ quality };
+
+                Clock::time_point start = Clock::now();
+                CompressedMip mip = compressor.CompressMip(image, benchmarkCase.Format);
+                double duration = std::chrono::duration<double>(Clock::now() - start).count();
+
+                float psnr = PSNR(image, Decompress(mip, benchmarkCase.Format), benchmarkCase.ChannelCount, benchmarkCase.Content == ContentType::HDRColor);
+                double megapixels = double(imageSize * imageSize) / 1e6;
+
+                // Anything below this indicates a broken encoder rather than a quality trade-off
+                passed = passed && psnr > 30.0f;
+
+                stream << (isFirstResult ? "" : ",\n") << "{\"format\":\"" << FormatName(benchmarkCase.Format) << "\""
+                    << ",\"quality\":" << uint32_t(quality)
+                    << ",\"throughput\":" << (duration > 0.0 ? megapixels / duration : 0.0)
+                    << ",\"psnr\":" << psnr
+                    << ",\"mipGenerationThroughput\":" << (mipDuration > 0.0 ? megapixels / mipDuration : 0.0)
+                    << ",\"mipCount\":" << mips.size() << "}";
+
+                isFirstResult = false;
+            }
+        }
+
+        stream << "],\"passed\":" << (passed ? "true" : "false") << "}\n";
+
+        return stream.good() && passed;
+    }
+
+    void TextureCompressor::EncodeBlock(const glm::vec4* texels, BlockFormat format, uint8_t* output) const
+    {
+        BlockPoints points;
+
+        auto gatherUnorm = [&points, texels](uint64_t firstChannel, uint64_t channelCount)
+        {
+            points.ChannelCount = channelCount;
+
+            for (uint64_t texel = 0; texel < BlockTexelCount; ++texel)
+            {
+                for (uint64_t c = 0; c < channelCount; ++c)
+                {
+                    points.Values[c][texel] = std::clamp(texels[texel][firstChannel + c], 0.0f, 1.0f) * 255.0f;
+                }
+            }
+        };
+
+        switch (format)
+        {
+        case BlockFormat::BC1:
+            gatherUnorm(0, 3);
+            EncodeSingleSubset(points, BC1Codec{}, mQuality, output);
+            break;
+
+        case BlockFormat::BC4:
+            gatherUnorm(0, 1);
+            EncodeSingleSubset(points, BC4Codec{}, mQuality, output);
+            break;
+
+        case BlockFormat::BC5:
+            gatherUnorm(0, 1);
+            EncodeSingleSubset(points, BC4Codec{}, mQuality, output);
+            gatherUnorm(1, 1);
+            EncodeSingleSubset(points, BC4Codec{}, mQuality, output + 8);
+            break;
+
+        case BlockFormat::BC7:
+            gatherUnorm(0, 4);
+            EncodeBC7(points, mQuality, output);
+            break;
+
+        case BlockFormat::BC6H:
+            points.ChannelCount = 3;
+
+            for (uint64_t texel = 0; texel < BlockTexelCount; ++texel)
+            {
+                for (uint64_t c = 0; c < 3; ++c)
+                {
+                    points.Values[c][texel] = ToUnsignedHalfBits(texels[texel][c]);
+                }
+            }
+
+            EncodeBC6H(points, mQuality, output);
+            break;
+        }
+    }
+
+    template <class Function>
+    void TextureCompressor::ParallelFor(uint64_t count, const Function& function) const
+    {
+        if (mThreadCount <= 1)
+        {
+            function(0, count);
+            return;
+        }
+
+        Foundation::TaskScheduler::SharedInstance().ParallelFor(count, 1, function);
+    }
+
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <glm/vec4.hpp>
+#include <bitsery/bitsery.h>
+#include <Foundation/TaskScheduler.hpp>
+
+#include <vector>
+#include <optional>
+#include <filesystem>
+
+namespace PathFinder
+{
+
+    /// Encodes uncompressed texture data into BC1, BC4, BC5, BC6H and BC7 blocks on the CPU.
+    /// Mip chains are generated in linear space before encoding: sRGB color is decoded before
+    /// filtering and normals are renormalized. Rows of blocks are encoded in parallel.
+    /// Fast preset writes BC7 mode 6 and BC6H mode 11 only. Normal and High presets also try
+    /// BC7 modes 5 and 1 and BC6H modes 12 and 10, the two subset ones over the best ranked partitions,
+    /// and keep the mode with least error per block. Palette index search runs on four texels at a time with SSE.
+    class TextureCompressor
+    {
+    public:
+        inline static const uint32_t CacheVersion = 2;
+
+        enum class BlockFormat : uint8_t
+        {
+            BC1, BC4, BC5, BC6H, BC7
+        };
+
+        enum class Quality : uint8_t
+        {
+            Fast, Normal, High
+        };
+
+        enum class ContentType : uint8_t
+        {
+            // sRGB encoded color
+            Color,
+            // Linear data such as masks, roughness or metalness
+            Data,
+            // Tangent space normals remapped to [0; 1]
+            Normal,
+            // Linear high dynamic range color
+            HDRColor
+        };
+
+        struct Image
+        {
+            uint64_t Width = 0;
+            uint64_t Height = 0;
+            // Row-major texels in the encoding of their content type
+            std::vector<glm::vec4> Texels;
+        };
+
+        struct CompressedMip
+        {
+            uint64_t Width = 0;
+            uint64_t Height = 0;
+            // Rows of 4x4 blocks, tightly packed
+            std::vector<uint8_t> Blocks;
+
+            template <typename S>
+            void serialize(S& s)
+            {
+                s.value8b(Width);
+                s.value8b(Height);
+                s.container1b(Blocks, std::numeric_limits<uint64_t>::max());
+            }
+        };
+
+        struct CompressedTexture
+        {
+            BlockFormat Format = BlockFormat::BC7;
+            std::vector<CompressedMip> Mips;
+
+            template <typename S>
+            void serialize(S& s)
+            {
+                s.value1b(Format);
+                s.container(Mips, std::numeric_limits<uint64_t>::max());
+            }
+        };
+
+        // Thread count of 1 encodes on the calling thread, any other value uses all threads of the shared task scheduler
+        TextureCompressor(Quality quality = Quality::Normal, uint64_t threadCount = 0);
+
+        CompressedTexture Compress(const Image& image, BlockFormat format, ContentType contentType, bool generateMips) const;
+        CompressedMip CompressMip(const Image& image, BlockFormat format) const;
+
+        static Image Decompress(const CompressedMip& mip, BlockFormat format);
+
+        // Full chain down to 1x1, first element is a copy of the source image
+        static std::vector<Image> GenerateMips(const Image& image, ContentType contentType);
+
+        // Block compressed textures require top mip dimensions to be a multiple of block size
+        static bool IsCompressible(uint64_t width, uint64_t height);
+        static uint64_t BlockSizeInBytes(BlockFormat format);
+        static const char* FormatName(BlockFormat format);
+
+        // Peak signal-to-noise ratio over the first channelCount channels.
+        // HDR images are compared after x / (1 + x) mapping.
+        static float PSNR(const Image& reference, const Image& test, uint64_t channelCount, bool isHDR);
+
+        // Hash identifying compression input, used to validate cached results
+        static uint64_t InputHash(const Image& image, BlockFormat format, ContentType contentType, Quality quality);
+
+        static bool SaveCache(const std::filesystem::path& path, uint64_t inputHash, const CompressedTexture& texture);
+        static std::optional<CompressedTexture> LoadCache(const std::filesystem::path& path, uint64_t inputHash);
+
+        // Measures throughput and PSNR of every format and quality preset on synthetic images
+        static bool RunBenchmark(const std::filesystem::path& reportPath);
+
+    private:
+        void EncodeBlock(const glm::vec4* texels, BlockFormat format, uint8_t* output) const;
+
+        template <class Function>
+        void ParallelFor(uint64_t count, const Function& function) const;
+
+        Quality mQuality;
+        uint64_t mThreadCount;
+
+    public:
+        inline auto CompressionQuality() const { return mQuality; }
+        inline auto ThreadCount() const { return mThreadCount; }
+    };
+
+}
@@ -1,5 +1,7 @@
 #include "ThirdPartySceneLoader.hpp"
 
+#include <glm/gtc/type_ptr.hpp>
+
 namespace PathFinder
 {
 
@@ -27,9 +29,10 @@ namespace PathFinder
 
         mLoadedMeshes.clear();
         mLoadedMaterials.clear();
+        mLoadedNodes.clear();
 
         ProcessMaterials(pScene);
-        ProcessNode(pScene->mRootNode, pScene);
+        ProcessNode(pScene->mRootNode, pScene, std::nullopt);
 
         return mLoadedMeshes;
     }
@@ -178,19 +181,28 @@ namespace PathFinder
         mesh.SetName(assimpMesh->mName.data);
     }
 
-    void ThirdPartySceneLoader::ProcessNode(aiNode* node, const aiScene* scene)
+    void ThirdPartySceneLoader::ProcessNode(aiNode* node, const aiScene* scene, std::optional<uint64_t> parentIndex)
     {
+        // Assimp matrices are row major
+        Geometry::Transformation localTransform{ glm::transpose(glm::make_mat4(&node->mTransformation.a1)) };
+        // Vertices are already scaled, so only offsets between nodes need to be
+        localTransform.SetTranslation(localTransform.GetTranslation() * mLoadSettings.InitialScale);
+
+        uint64_t nodeIndex = mLoadedNodes.size();
+        mLoadedNodes.push_back({ localTransform, parentIndex });
+
         for (auto i = 0u; i < node->mNumMeshes; i++)
         {
             aiMesh* assimpMesh = scene->mMeshes[node->mMeshes[i]];
             LoadedMesh& loadedMesh = mLoadedMeshes.emplace_back();
             ProcessMesh(loadedMesh.MeshObject, assimpMesh, scene);
             loadedMesh.MaterialIndex = assimpMesh->mMaterialIndex;
+            loadedMesh.NodeIndex = nodeIndex;
         }
 
         for (auto i = 0u; i < node->mNumChildren; i++)
         {
-            ProcessNode(node->mChildren[i], scene);
+            ProcessNode(node->mChildren[i], scene, nodeIndex);
         }
     }
 
@@ -4,6 +4,8 @@
 #include "Mesh.hpp"
 #include "Material.hpp"
 
+#include <Geometry/Transformation.hpp>
+
 // Assimp is in conflict with windows.h definitions of min and max
 #ifndef NOMINMAX 
 #define NOMINMAX
@@ -18,6 +20,7 @@
 #endif
 
 #include <vector>
+#include <optional>
 #include <filesystem>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -34,10 +37,18 @@ namespace PathFinder
             float InitialScale = 1.0;
         };
 
+        /// Scene graph node, parents precede their children
+        struct LoadedNode
+        {
+            Geometry::Transformation LocalTransform;
+            std::optional<uint64_t> ParentIndex;
+        };
+
         struct LoadedMesh
         {
             Mesh MeshObject;
             uint64_t MaterialIndex = 0;
+            uint64_t NodeIndex = 0;
         };
 
         std::vector<LoadedMesh>& Load(const std::filesystem::path& path, const Settings& settings = {});
@@ -45,16 +56,18 @@ namespace PathFinder
     private:
         void ProcessMaterials(const aiScene* scene);
         void ProcessMesh(Mesh& mesh, aiMesh* assimpMesh, const aiScene* scene);
-        void ProcessNode(aiNode* node, const aiScene* scene);
+        void ProcessNode(aiNode* node, const aiScene* scene, std::optional<uint64_t> parentIndex);
 
         std::vector<Material> mLoadedMaterials;
         std::vector<LoadedMesh> mLoadedMeshes;
+        std::vector<LoadedNode> mLoadedNodes;
         std::filesystem::path mPath;
         std::filesystem::path mDirectory;
         Settings mLoadSettings;
 
     public:
         inline auto& LoadedMaterials() { return mLoadedMaterials; }
+        inline const auto& LoadedNodes() const { return mLoadedNodes; }
     };
 
 }
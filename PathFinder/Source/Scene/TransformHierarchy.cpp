@@ -0,0 +1,674 @@
+#include "TransformHierarchy.hpp"
+
+#include <Foundation/TaskScheduler.hpp>
+#include <Foundation/CPUProfiler.hpp>
+#include <Foundation/Assert.hpp>
+
+#include <glm/gtc/matrix_inverse.hpp>
+#include <xmmintrin.h>
+
+#include <atomic>
+#include <random>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+#include <string>
+
+namespace PathFinder
+{
+
+    namespace
+    {
+        const uint32_t InvalidPosition = std::numeric_limits<uint32_t>::max();
+
+        template <class T>
+        void Permute(std::vector<T>& array, const std::vector<uint32_t>& sourcePositions)
+        {
+            std::vector<T> permuted(sourcePositions.size());
+
+            for (uint64_t position = 0; position < sourcePositions.size(); ++position)
+            {
+                permuted[position] = array[sourcePositions[position]];
+            }
+
+            array = std::move(permuted);
+        }
+
+        // Column major 4x4 product of a matrix in memory and 4 columns in registers
+        void MultiplyMatrix(const glm::mat4& left, const __m128* rightColumns, glm::mat4& result)
+        {
+            __m128 left0 = _mm_loadu_ps(&left[0][0]);
+            __m128 left1 = _mm_loadu_ps(&left[1][0]);
+            __m128 left2 = _mm_loadu_ps(&left[2][0]);
+            __m128 left3 = _mm_loadu_ps(&left[3][0]);
+
+            for (uint32_t column = 0; column < 4; ++column)
+            {
+                __m128 right = rightColumns[column];
+                __m128 x = _mm_mul_ps(left0, _mm_shuffle_ps(right, right, _MM_SHUFFLE(0, 0, 0, 0)));
+                __m128 y = _mm_mul_ps(left1, _mm_shuffle_ps(right, right, _MM_SHUFFLE(1, 1, 1, 1)));
+                __m128 z = _mm_mul_ps(left2, _mm_shuffle_ps(right, right, _MM_SHUFFLE(2, 2, 2, 2)));
+                __m128 w = _mm_mul_ps(left3, _mm_shuffle_ps(right, right, _MM_SHUFFLE(3, 3, 3, 3)));
+                _mm_storeu_ps(&result[column][0], _mm_add_ps(_mm_add_ps(x, y), _mm_add_ps(z, w)));
+            }
+        }
+    }
+
+    TransformHierarchy::NodeId TransformHierarchy::AddNode(const Geometry::Transformation& localTransform, NodeId parent)
+    {
+        assert_format(parent == NoParent || (parent < mParents.size() && mPositions[parent] != InvalidPosition), "Parent node does not exist");
+
+        NodeId node = 0;
+
+        if (mFreeIds.empty())
+        {
+            node = (NodeId)mParents.size();
+            mParents.push_back(parent);
+            mPositions.push_back(0);
+            mChildCounts.push_back(0);
+        }
+        else
+        {
+            node = mFreeIds.back();
+            mFreeIds.pop_back();
+            mParents[node] = parent;
+            mChildCounts[node] = 0;
+        }
+
+        if (parent != NoParent)
+            ++mChildCounts[parent];
+
+        // Appended out of level order until the next update sorts it in
+        mPositions[node] = (uint32_t)mIds.size();
+        mIds.push_back(node);
+        mParentPositions.push_back(InvalidPosition);
+        mTranslations.push_back(localTransform.GetTranslation());
+        mRotations.push_back(localTransform.GetRotation());
+        mScales.push_back(localTransform.GetScale());
+        mStates.push_back(LocalTransformChanged | NoPreviousWorldMatrix);
+        mUpdateEpochs.push_back(0);
+        mWorldMatrices.emplace_back(1.0f);
+        mPreviousWorldMatrices.emplace_back(1.0f);
+        mNormalMatrices.emplace_back(1.0f);
+
+        mIsLevelOrderValid = false;
+
+        return node;
+    }
+
+    void TransformHierarchy::RemoveNode(NodeId node)
+    {
+        uint32_t position = mPositions[node];
+        NodeId parent = mParents[node];
+
+        assert_format(position != InvalidPosition, "Removing a node that does not exist");
+
+        if (mChildCounts[node] > 0)
+        {
+            for (NodeId child = 0; child < mParents.size(); ++child)
+            {
+                if (mParents[child] != node || mPositions[child] == InvalidPosition)
+                    continue;
+
+                mParents[child] = parent;
+                mStates[mPositions[child]] |= LocalTransformChanged;
+
+                if (parent != NoParent)
+                    ++mChildCounts[parent];
+            }
+        }
+
+        if (parent != NoParent)
+            --mChildCounts[parent];
+
+        // Position stays occupied by a dead entry until the next update compacts arrays
+        mIds[position] = NoParent;
+        mPositions[node] = InvalidPosition;
+        mParents[node] = NoParent;
+        mFreeIds.push_back(node);
+        mIsLevelOrderValid = false;
+    }
+
+    void TransformHierarchy::Clear()
+    {
+        mParents.clear();
+        mPositions.clear();
+        mChildCounts.clear();
+        mFreeIds.clear();
+        mIds.clear();
+        mParentPositions.clear();
+        mTranslations.clear();
+        mRotations.clear();
+        mScales.clear();
+        mStates.clear();
+        mUpdateEpochs.clear();
+        mWorldMatrices.clear();
+        mPreviousWorldMatrices.clear();
+        mNormalMatrices.clear();
+        mLevelOffsets.clear();
+        mIsLevelOrderValid = true;
+    }
+
+    void TransformHierarchy::SetLocalTransform(NodeId node, const Geometry::Transformation& localTransform)
+    {
+        uint32_t position = mPositions[node];
+        mTranslations[position] = localTransform.GetTranslation();
+        mRotations[position] = localTransform.GetRotation();
+        mScales[position] = localTransform.GetScale();
+        mStates[position] |= LocalTransformChanged;
+    }
+
+    Geometry::Transformation TransformHierarchy::LocalTransform(NodeId node) const
+    {
+        uint32_t position = mPositions[node];
+        return { mScales[position], mTranslations[position], mRotations[position] };
+    }
+
+    void TransformHierarchy::Update()
+    {
+        PF_CPU_ZONE("TransformHierarchy::Update");
+
+        if (!mIsLevelOrderValid)
+            RebuildLevelOrder();
+
+        ++mEpoch;
+
+        std::atomic<uint64_t> updatedNodeCount = 0;
+
+        // Levels depend on their parent levels, nodes within a level are independent
+        for (uint64_t level = 0; level < LevelCount(); ++level)
+        {
+            uint32_t levelStart = mLevelOffsets[level];
+            uint32_t levelSize = mLevelOffsets[level + 1] - levelStart;
+
+            Foundation::TaskScheduler::SharedInstance().ParallelFor(levelSize, 512, [this, levelStart, &updatedNodeCount](uint64_t first, uint64_t last)
+            {
+                updatedNodeCount += UpdateNodes(levelStart + (uint32_t)first, levelStart + (uint32_t)last);
+            },
+            "TransformHierarchy::Update");
+        }
+
+        mLastUpdatedNodeCount = updatedNodeCount;
+    }
+
+    void TransformHierarchy::UpdatePreviousFrameValues()
+    {
+        Foundation::TaskScheduler::SharedInstance().ParallelFor(mIds.size(), 4096, [this](uint64_t first, uint64_t last)
+        {
+            for (uint64_t position = first; position < last; ++position)
+            {
+                if ((mStates[position] & WorldMatrixChanged) == 0)
+                    continue;
+
+                mPreviousWorldMatrices[position] = mWorldMatrices[position];
+                mStates[position] &= ~WorldMatrixChanged;
+            }
+        },
+        "TransformHierarchy::UpdatePreviousFrameValues");
+    }
+
+    bool TransformHierarchy::HasChanged(NodeId node) const
+    {
+        return (mStates[mPositions[node]] & WorldMatrixChanged) != 0;
+    }
+
+    void TransformHierarchy::RebuildLevelOrder()
+    {
+        const uint32_t Unresolved = std::numeric_limits<uint32_t>::max();
+
+        std::vector<uint32_t> depths(mParents.size(), Unresolved);
+        std::vector<NodeId> unresolvedChain;
+        uint32_t maxDepth = 0;
+        uint32_t liveNodeCount = 0;
+
+        // Walk up to the closest node with known depth, then assign depths on the way back down
+        for (NodeId node = 0; node < mParents.size(); ++node)
+        {
+            if (mPositions[node] == InvalidPosition)
+                continue;
+
+            ++liveNodeCount;
+
+            for (NodeId current = node; current != NoParent && depths[current] == Unresolved; current = mParents[current])
+            {
+                unresolvedChain.push_back(current);
+            }
+
+            NodeId resolvedAncestor = mParents[unresolvedChain.empty() ? node : unresolvedChain.back()];
+            uint32_t depth = resolvedAncestor == NoParent ? 0 : depths[resolvedAncestor] + 1;
+
+            for (auto it = unresolvedChain.rbegin(); it != unresolvedChain.rend(); ++it, ++depth)
+            {
+                depths[*it] = depth;
+                maxDepth = std::max(maxDepth, depth);
+            }
+
+            unresolvedChain.clear();
+        }
+
+        // Counting sort by depth keeps relative order of nodes within a level
+        mLevelOffsets.assign(liveNodeCount > 0 ? maxDepth + 2 : 0, 0);
+
+        for (NodeId node = 0; node < mParents.size(); ++node)
+        {
+            if (mPositions[node] != InvalidPosition)
+                ++mLevelOffsets[depths[node] + 1];
+        }
+
+        for (uint64_t level = 1; level < mLevelOffsets.size(); ++level)
+        {
+            mLevelOffsets[level] += mLevelOffsets[level - 1];
+        }
+
+        std::vector<uint32_t> sourcePositions(liveNodeCount);
+        std::vector<uint32_t> levelFill{ mLevelOffsets };
+
+        for (NodeId node = 0; node < mParents.size(); ++node)
+        {
+            if (mPositions[node] == InvalidPosition)
+                continue;
+
+            uint32_t newPosition = levelFill[depths[node]]++;
+            sourcePositions[newPosition] = mPositions[node];
+            mPositions[node] = newPosition;
+        }
+
+        Permute(mIds, sourcePositions);
+        Permute(mTranslations, sourcePositions);
+        Permute(mRotations, sourcePositions);
+        Permute(mScales, sourcePositions);
+        Permute(mStates, sourcePositions);
+        Permute(mUpdateEpochs, sourcePositions);
+        Permute(mWorldMatrices, sourcePositions);
+        Permute(mPreviousWorldMatrices, sourcePositions);
+        Permute(mNormalMatrices, sourcePositions);
+
+        mParentPositions.resize(liveNodeCount);
+
+        for (uint32_t position = 0; position < liveNodeCount; ++position)
+        {
+            NodeId parent = mParents[mIds[position]];
+            mParentPositions[position] = parent == NoParent ? InvalidPosition : mPositions[parent];
+        }
+
+        mIsLevelOrderValid = true;
+    }
+
+    uint64_t TransformHierarchy::UpdateNodes(uint32_t firstPosition, uint32_t lastPosition)
+    {
+        uint32_t batch[BatchSize];
+        uint32_t batchCount = 0;
+        uint64_t updatedNodeCount = 0;
+
+        for (uint32_t position = firstPosition; position < lastPosition; ++position)
+        {
+            uint32_t parentPosition = mParentPositions[position];
+
+            // Parent levels are complete at this point
+            bool isParentUpdated = parentPosition != InvalidPosition && mUpdateEpochs[parentPosition] == mEpoch;
+
+            if ((mStates[position] & LocalTransformChanged) == 0 && !isParentUpdated)
+                continue;
+
+            batch[batchCount++] = position;
+
+            if (batchCount == BatchSize)
+            {
+                ComposeBatch(batch, batchCount);
+                updatedNodeCount += batchCount;
+                batchCount = 0;
+            }
+        }
+
+        if (batchCount > 0)
+        {
+            ComposeBatch(batch, batchCount);
+            updatedNodeCount += batchCount;
+        }
+
+        return updatedNodeCount;
+    }
+
+    void TransformHierarchy::ComposeBatch(const uint32_t* positions, uint32_t count)
+    {
+        alignas(16) float lanes[10][BatchSize];
+
+        // Partial batches repeat the first node in unused lanes
+        for (uint32_t lane = 0; lane < BatchSize; ++lane)
+        {
+            uint32_t position = positions[lane < count ? lane : 0];
+            const glm::quat& rotation = mRotations[position];
+            const glm::vec3& scale = mScales[position];
+
+            lanes[0][lane] = rotation.x;
+            lanes[1][lane] = rotation.y;
+            lanes[2][lane] = rotation.z;
+            lanes[3][lane] = rotation.w;
+            lanes[4][lane] = scale.x;
+            lanes[5][lane] = scale.y;
+            lanes[6][lane] = scale.z;
+        }
+
+        __m128 qx = _mm_load_ps(lanes[0]);
+        __m128 qy = _mm_load_ps(lanes[1]);
+        __m128 qz = _mm_load_ps(lanes[2]);
+        __m128 qw = _mm_load_ps(lanes[3]);
+        __m128 one = _mm_set1_ps(1.0f);
+        __m128 two = _mm_set1_ps(2.0f);
+
+        __m128 xx = _mm_mul_ps(qx, qx), yy = _mm_mul_ps(qy, qy), zz = _mm_mul_ps(qz, qz);
+        __m128 xy = _mm_mul_ps(qx, qy), xz = _mm_mul_ps(qx, qz), yz = _mm_mul_ps(qy, qz);
+        __m128 wx = _mm_mul_ps(qw, qx), wy = _mm_mul_ps(qw, qy), wz = _mm_mul_ps(qw, qz);
+
+        // Rotation matrix columns, same terms glm::mat3_cast produces
+        __m128 rotation[3][3] = {
+            { _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), _mm_mul_ps(two, _mm_add_ps(xy, wz)), _mm_mul_ps(two, _mm_sub_ps(xz, wy)) },
+            { _mm_mul_ps(two, _mm_sub_ps(xy, wz)), _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), _mm_mul_ps(two, _mm_add_ps(yz, wx)) },
+            { _mm_mul_ps(two, _mm_add_ps(xz, wy)), _mm_mul_ps(two, _mm_sub_ps(yz, wx)), _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))) }
+        };
+
+        // T * R * S scales rotation columns, the normal matrix (R * S)^-T = R * S^-1 divides them
+        alignas(16) float localLanes[3][3][BatchSize];
+        alignas(16) float normalLanes[3][3][BatchSize];
+
+        for (uint32_t column = 0; column < 3; ++column)
+        {
+            __m128 scale = _mm_load_ps(lanes[4 + column]);
+            __m128 inverseScale = _mm_div_ps(one, scale);
+
+            for (uint32_t row = 0; row < 3; ++row)
+            {
+                _mm_store_ps(localLanes[column][row], _mm_mul_ps(rotation[column][row], scale));
+                _mm_store_ps(normalLanes[column][row], _mm_mul_ps(rotation[column][row], inverseScale));
+            }
+        }
+
+        for (uint32_t lane = 0; lane < count; ++lane)
+        {
+            uint32_t position = positions[lane];
+            uint32_t parentPosition = mParentPositions[position];
+            const glm::vec3& translation = mTranslations[position];
+
+            __m128 localColumns[4];
+            __m128 normalColumns[4];
+
+            for (uint32_t column = 0; column < 3; ++column)
+            {
+                localColumns[column] = _mm_setr_ps(localLanes[column][0][lane], localLanes[column][1][lane], localLanes[column][2][lane], 0.0f);
+                normalColumns[column] = _mm_setr_ps(normalLanes[column][0][lane], normalLanes[column][1][lane], normalLanes[column][2][lane], 0.0f);
+            }
+
+            localColumns[3] = _mm_setr_ps(translation.x, translation.y, translation.z, 1.0f);
+            normalColumns[3] = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+
+            glm::mat4& world = mWorldMatrices[position];
+            glm::mat4& normal = mNormalMatrices[position];
+
+            if (parentPosition == InvalidPosition)
+            {
+                for (uint32_t column = 0; column < 4; ++column)
+                {
+                    _mm_storeu_ps(&world[column][0], localColumns[column]);
+                    _mm_storeu_ps(&normal[column][0], normalColumns[column]);
+                }
+            }
+            else
+            {
+                MultiplyMatrix(mWorldMatrices[parentPosition], localColumns, world);
+                MultiplyMatrix(mNormalMatrices[parentPosition], normalColumns, normal);
+            }
+
+            uint8_t& state = mStates[position];
+
+            if (state & NoPreviousWorldMatrix)
+                mPreviousWorldMatrices[position] = world;
+
+            state = WorldMatrixChanged;
+            mUpdateEpochs[position] = mEpoch;
+        }
+    }
+
+    bool TransformHierarchy::RunBenchmark(const std::filesystem::path& reportPath)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        const uint32_t RepeatCount = 5;
+        // Share of nodes whose local transform changes in partial updates
+        const float PartialUpdateFraction = 0.01f;
+
+        std::ofstream stream{ reportPath, std::ios::out | std::ios::trunc };
+
+        if (!stream.is_open())
+            return false;
+
+        struct Shape
+        {
+            std::string Name;
+            // Parent of every node, parents precede children
+            std::vector<NodeId> Parents;
+        };
+
+        std::vector<Shape> shapes;
+
+        // 64 chains 1024 nodes deep
+        Shape& deep = shapes.emplace_back(Shape{ "deep" });
+
+        for (uint32_t chain = 0; chain < 64; ++chain)
+        {
+            for (uint32_t depth = 0; depth < 1024; ++depth)
+            {
+                deep.Parents.push_back(depth == 0 ? NoParent : NodeId(deep.Parents.size() - 1));
+            }
+        }
+
+        // One root with 65535 children
+        Shape& wide = shapes.emplace_back(Shape{ "wide" });
+        wide.Parents.push_back(NoParent);
+        wide.Parents.resize(65536, 0);
+
+        // 8 children per node, 6 levels
+        Shape& balanced = shapes.emplace_back(Shape{ "balanced" });
+        balanced.Parents.push_back(NoParent);
+
+        for (NodeId parent = 0; balanced.Parents.size() < (1 + 8 + 64 + 512 + 4096 + 32768); ++parent)
+        {
+            balanced.Parents.resize(balanced.Parents.size() + 8, parent);
+        }
+
+        std::mt19937 generator{ 12345 };
+        std::uniform_real_distribution<float> distribution{ -1.0f, 1.0f };
+
+        // Scales close to 1 keep products along 1024 deep chains well conditioned
+        auto randomTransform = [&]
+        {
+            glm::vec3 axis = glm::normalize(glm::vec3{ distribution(generator), distribution(generator), distribution(generator) } + 0.001f);
+            glm::vec3 scale = glm::vec3{ 1.0f } + glm::vec3{ distribution(generator), distribution(generator), distribution(generator) } * 0.001f;
+            glm::vec3 translation = glm::vec3{ distribution(generator), distribution(generator), distribution(generator) } * 0.05f;
+            return Geometry::Transformation{ scale, translation, glm::angleAxis(distribution(generator) * 0.1f, axis) };
+        };
+
+        auto bestOf = [&](auto&& prepare, auto&& function)
+        {
+            double bestMilliseconds = std::numeric_limits<double>::max();
+
+            for (uint32_t repeat = 0; repeat < RepeatCount; ++repeat)
+            {
+                prepare();
+                auto start = Clock::now();
+                function();
+                bestMilliseconds = std::min(bestMilliseconds, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+            }
+
+            return bestMilliseconds;
+        };
+
+        bool isValid = true;
+
+        stream.precision(6);
+        stream << "{\"threads\":" << Foundation::TaskScheduler::SharedInstance().ThreadCount()
+            << ",\"partialUpdateFraction\":" << PartialUpdateFraction << ",\"unit\":\"ms\",\"hierarchies\":[\n";
+
+        for (uint64_t shapeIdx = 0; shapeIdx < shapes.size(); ++shapeIdx)
+        {
+            const Shape& shape = shapes[shapeIdx];
+            uint64_t nodeCount = shape.Parents.size();
+
+            std::vector<Geometry::Transformation> localTransforms(nodeCount);
+            std::generate(localTransforms.begin(), localTransforms.end(), randomTransform);
+
+            TransformHierarchy hierarchy;
+
+            for (uint64_t node = 0; node < nodeCount; ++node)
+            {
+                hierarchy.AddNode(localTransforms[node], shape.Parents[node]);
+            }
+
+            auto rebuildStart = Clock::now();
+            hierarchy.Update();
+            double rebuildMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - rebuildStart).count();
+
+            // Per-node composition through Geometry::Transformation the way flattened instances compute matrices
+            std::vector<glm::mat4> referenceWorld(nodeCount);
+            std::vector<glm::mat4> referenceNormal(nodeCount);
+
+            auto computeReference = [&]
+            {
+                for (uint64_t node = 0; node < nodeCount; ++node)
+                {
+                    Geometry::Transformation local{ localTransforms[node].GetScale(), localTransforms[node].GetTranslation(), localTransforms[node].GetRotation() };
+                    NodeId parent = shape.Parents[node];
+                    referenceWorld[node] = parent == NoParent ? local.GetMatrix() : referenceWorld[parent] * local.GetMatrix();
+                    referenceNormal[node] = glm::transpose(glm::inverse(referenceWorld[node]));
+                }
+            };
+
+            double referenceMilliseconds = bestOf([] {}, computeReference);
+
+            auto maxError = [&]
+            {
+                float error = 0.0f;
+
+                for (uint64_t node = 0; node < nodeCount; ++node)
+                {
+                    NodeId id = NodeId(node);
+
+                    for (uint32_t column = 0; column < 4; ++column)
+                    {
+                        for (uint32_t row = 0; row < 4; ++row)
+                        {
+                            float worldError = std::abs(hierarchy.WorldMatrix(id)[column][row] - referenceWorld[node][column][row]);
+                            error = std::max(error, worldError / std::max(1.0f, std::abs(referenceWorld[node][column][row])));
+
+                            // Only the rotation part of normal matrices is used
+                            if (column < 3 && row < 3)
+                            {
+                                float normalError = std::abs(hierarchy.NormalMatrix(id)[column][row] - referenceNormal[node][column][row]);
+                                error = std::max(error, normalError / std::max(1.0f, std::abs(referenceNormal[node][column][row])));
+                            }
+                        }
+                    }
+                }
+
+                return error;
+            };
+
+            float fullUpdateError = maxError();
+
+            double fullUpdateMilliseconds = bestOf(
+                [&] { for (uint64_t node = 0; node < nodeCount; ++node) hierarchy.SetLocalTransform(NodeId(node), localTransforms[node]); },
+                [&] { hierarchy.Update(); });
+
+            // Changing a few nodes recomputes exactly their subtrees
+            std::vector<NodeId> changedNodes;
+            std::vector<uint8_t> isInChangedSubtree(nodeCount);
+            uint64_t expectedUpdatedNodeCount = 0;
+
+            auto pickChangedNodes = [&]
+            {
+                changedNodes.clear();
+                std::fill(isInChangedSubtree.begin(), isInChangedSubtree.end(), 0);
+
+                for (uint64_t node = 0; node < nodeCount; ++node)
+                {
+                    if (std::abs(distribution(generator)) < PartialUpdateFraction)
+                        changedNodes.push_back(NodeId(node));
+                }
+
+                for (NodeId node : changedNodes)
+                {
+                    localTransforms[node] = randomTransform();
+                    hierarchy.SetLocalTransform(node, localTransforms[node]);
+                    isInChangedSubtree[node] = 1;
+                }
+
+                expectedUpdatedNodeCount = 0;
+
+                for (uint64_t node = 0; node < nodeCount; ++node)
+                {
+                    NodeId parent = shape.Parents[node];
+                    isInChangedSubtree[node] |= parent != NoParent && isInChangedSubtree[parent];
+                    expectedUpdatedNodeCount += isInChangedSubtree[node];
+                }
+            };
+
+            bool isPartialUpdateExact = true;
+
+            double partialUpdateMilliseconds = bestOf(pickChangedNodes, [&] { hierarchy.Update(); });
+            uint64_t partialUpdatedNodeCount = hierarchy.LastUpdatedNodeCount();
+            isPartialUpdateExact &= partialUpdatedNodeCount == expectedUpdatedNodeCount;
+
+            computeReference();
+            float partialUpdateError = maxError();
+
+            // Previous matrices catch up with current ones
+            hierarchy.UpdatePreviousFrameValues();
+            bool arePreviousMatricesCurrent = true;
+
+            for (uint64_t node = 0; node < nodeCount; ++node)
+            {
+                arePreviousMatricesCurrent &= hierarchy.PreviousWorldMatrix(NodeId(node)) == hierarchy.WorldMatrix(NodeId(node)) && !hierarchy.HasChanged(NodeId(node));
+            }
+
+            hierarchy.Update();
+            isPartialUpdateExact &= hierarchy.LastUpdatedNodeCount() == 0;
+
+            isValid &= fullUpdateError < 1e-3f && partialUpdateError < 1e-3f && isPartialUpdateExact && arePreviousMatricesCurrent;
+
+            stream << (shapeIdx == 0 ? "" : ",\n") << "{\"name\":\"" << shape.Name << "\",\"nodes\":" << nodeCount << ",\"levels\":" << hierarchy.LevelCount()
+                << ",\"levelOrderBuild\":" << rebuildMilliseconds << ",\"perNodeReference\":" << referenceMilliseconds
+                << ",\"fullUpdate\":" << fullUpdateMilliseconds << ",\"partialUpdate\":" << partialUpdateMilliseconds
+                << ",\"partialUpdatedNodes\":" << partialUpdatedNodeCount << ",\"expectedPartialUpdatedNodes\":" << expectedUpdatedNodeCount
+                << ",\"maxRelativeError\":" << std::max(fullUpdateError, partialUpdateError)
+                << ",\"partialUpdateExact\":" << (isPartialUpdateExact ? "true" : "false")
+                << ",\"previousMatricesCurrent\":" << (arePreviousMatricesCurrent ? "true" : "false") << "}";
+        }
+
+        // Removal attaches children to the grandparent without moving them in world space unless their parent moved
+        TransformHierarchy hierarchy;
+        NodeId root = hierarchy.AddNode(randomTransform());
+        NodeId middle = hierarchy.AddNode(Geometry::Transformation{}, root);
+        NodeId leaf = hierarchy.AddNode(randomTransform(), middle);
+        hierarchy.Update();
+        glm::mat4 leafWorld = hierarchy.WorldMatrix(leaf);
+        hierarchy.RemoveNode(middle);
+        hierarchy.Update();
+
+        float removalError = 0.0f;
+
+        for (uint32_t column = 0; column < 4; ++column)
+        {
+            for (uint32_t row = 0; row < 4; ++row)
+            {
+                removalError = std::max(removalError, std::abs(hierarchy.WorldMatrix(leaf)[column][row] - leafWorld[column][row]));
+            }
+        }
+
+        bool isRemovalValid = removalError < 1e-5f && hierarchy.Parent(leaf) == root && hierarchy.NodeCount() == 2 && hierarchy.LevelCount() == 2;
+        isValid &= isRemovalValid;
+
+        stream << "\n],\"removalValid\":" << (isRemovalValid ? "true" : "false") << ",\"valid\":" << (isValid ? "true" : "false") << "}\n";
+
+        return isValid && stream.good();
+    }
+
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <Geometry/Transformation.hpp>
+
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <filesystem>
+
+namespace PathFinder
+{
+
+    /// Parent-child tree of transforms stored in flat arrays ordered by depth, so every parent precedes its children.
+    /// World matrices are composed level by level, each level split between task scheduler workers,
+    /// and only nodes with changed local transforms and their subtrees are recomputed.
+    /// Local translation, rotation and scale are turned into matrices 4 nodes at a time with SSE.
+    /// Node ids are stable; positions in the arrays change whenever nodes are added or removed.
+    class TransformHierarchy
+    {
+    public:
+        using NodeId = uint32_t;
+
+        inline static const NodeId NoParent = std::numeric_limits<NodeId>::max();
+
+        NodeId AddNode(const Geometry::Transformation& localTransform, NodeId parent = NoParent);
+
+        // Children of a removed node are attached to its parent keeping their local transforms
+        void RemoveNode(NodeId node);
+        void Clear();
+
+        void SetLocalTransform(NodeId node, const Geometry::Transformation& localTransform);
+        Geometry::Transformation LocalTransform(NodeId node) const;
+
+        // Recomputes world and normal matrices of changed subtrees
+        void Update();
+
+        // Previous world matrices take current values for nodes changed since the last call
+        void UpdatePreviousFrameValues();
+
+        // World matrix was recomputed since previous frame values were last updated
+        bool HasChanged(NodeId node) const;
+
+        // Compares level ordered updates against per-node glm composition on deep and wide hierarchies
+        static bool RunBenchmark(const std::filesystem::path& reportPath);
+
+    private:
+        enum NodeState : uint8_t
+        {
+            LocalTransformChanged = 1 << 0,
+            WorldMatrixChanged = 1 << 1,
+            // Previous world matrix takes the first computed world matrix
+            NoPreviousWorldMatrix = 1 << 2
+        };
+
+        inline static const uint32_t BatchSize = 4;
+
+        void RebuildLevelOrder();
+        uint64_t UpdateNodes(uint32_t firstPosition, uint32_t lastPosition);
+        void ComposeBatch(const uint32_t* positions, uint32_t count);
+
+        // Per node id
+        std::vector<NodeId> mParents;
+        std::vector<uint32_t> mPositions;
+        std::vector<uint32_t> mChildCounts;
+        std::vector<NodeId> mFreeIds;
+
+        // Per position
+        std::vector<NodeId> mIds;
+        std::vector<uint32_t> mParentPositions;
+        std::vector<glm::vec3> mTranslations;
+        std::vector<glm::quat> mRotations;
+        std::vector<glm::vec3> mScales;
+        std::vector<uint8_t> mStates;
+        std::vector<uint32_t> mUpdateEpochs;
+        std::vector<glm::mat4> mWorldMatrices;
+        std::vector<glm::mat4> mPreviousWorldMatrices;
+        std::vector<glm::mat4> mNormalMatrices;
+
+        // Index of the first position of every level and one past the last
+        std::vector<uint32_t> mLevelOffsets;
+        bool mIsLevelOrderValid = true;
+        uint32_t mEpoch = 0;
+        uint64_t mLastUpdatedNodeCount = 0;
+
+    public:
+        inline const glm::mat4& WorldMatrix(NodeId node) const { return mWorldMatrices[mPositions[node]]; }
+        inline const glm::mat4& PreviousWorldMatrix(NodeId node) const { return mPreviousWorldMatrices[mPositions[node]]; }
+        inline const glm::mat4& NormalMatrix(NodeId node) const { return mNormalMatrices[mPositions[node]]; }
+        inline NodeId Parent(NodeId node) const { return mParents[node]; }
+        inline uint64_t NodeCount() const { return mParents.size() - mFreeIds.size(); }
+        inline uint64_t LevelCount() const { return mLevelOffsets.empty() ? 0 : mLevelOffsets.size() - 1; }
+        inline uint64_t LastUpdatedNodeCount() const { return mLastUpdatedNodeCount; }
+    };
+
+}
@@ -289,6 +289,7 @@ DDSKTX_API bool        ddsktx_format_compressed(ddsktx_format format);
 #define DDSKTX__DDS_FORMAT_B5G5R5A1_UNORM      86
 #define DDSKTX__DDS_FORMAT_B8G8R8A8_UNORM      87
 #define DDSKTX__DDS_FORMAT_B8G8R8A8_UNORM_SRGB 91
+#define DDSKTX__DDS_FORMAT_BC6H_UF16           95
 #define DDSKTX__DDS_FORMAT_BC6H_SF16           96
 #define DDSKTX__DDS_FORMAT_BC7_UNORM           98
 #define DDSKTX__DDS_FORMAT_BC7_UNORM_SRGB      99
@@ -519,6 +520,7 @@ static const ddsktx__dds_translate_fourcc_format k__translate_dxgi[] = {
     { DDSKTX__DDS_FORMAT_BC3_UNORM_SRGB,      DDSKTX_FORMAT_BC3,        true  },
     { DDSKTX__DDS_FORMAT_BC4_UNORM,           DDSKTX_FORMAT_BC4,        false },
     { DDSKTX__DDS_FORMAT_BC5_UNORM,           DDSKTX_FORMAT_BC5,        false },
+    { DDSKTX__DDS_FORMAT_BC6H_UF16,           DDSKTX_FORMAT_BC6H,       false },
     { DDSKTX__DDS_FORMAT_BC6H_SF16,           DDSKTX_FORMAT_BC6H,       false },
     { DDSKTX__DDS_FORMAT_BC7_UNORM,           DDSKTX_FORMAT_BC7,        false },
     { DDSKTX__DDS_FORMAT_BC7_UNORM_SRGB,      DDSKTX_FORMAT_BC7,        true  },
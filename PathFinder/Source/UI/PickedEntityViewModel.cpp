@@ -3,39 +3,37 @@
 #include <Foundation/STDHelpers.hpp>
 #include <Geometry/Utils.hpp>
 #include <fplus/fplus.hpp>
-#include <RenderPipeline/RenderPasses/PipelineNames.hpp>
 #include <glm/gtx/matrix_decompose.hpp>
 #include <glm/gtx/transform.hpp>
+#include <glm/common.hpp>
 
 namespace PathFinder
 {
 
-    void PickedEntityViewModel::HandleClick()
+    void PickedEntityViewModel::HandleClick(const glm::vec2& mousePosition)
     {
-        mMeshInstance = nullptr;
+        mMeshInstance = {};
         mSphericalLight = nullptr;
         mFlatLight = nullptr;
         mSky = nullptr;
 
-        if (mPickedEntityInfo.GPUIndex != PickedGPUEntityInfo::NoEntity)
+        const Camera& camera = Dependencies->ScenePtr->GetMainCamera();
+        const Geometry::Dimensions& viewportSize = Dependencies->RenderEngine->RenderSurface().Dimensions();
+
+        // Ray through the clicked pixel's center within the camera depth range, back faces are not pickable
+        glm::vec2 uv = (glm::floor(mousePosition) + 0.5f) / glm::vec2{ viewportSize.Width, viewportSize.Height };
+
+        std::optional<SceneBVH::Hit> hit = Dependencies->ScenePtr->GetBVH().ClosestHit(
+            camera.WorldRay(uv), camera.GetNearClipPlane(), camera.GetFarClipPlane(), true);
+
+        if (hit)
         {
-            switch (PickedGPUEntityInfo::GPUEntityType{ mPickedEntityInfo.EntityType })
-            {
-            case PickedGPUEntityInfo::GPUEntityType::MeshInstance:
-                mMeshInstance = mScene->GetMeshInstanceForGPUIndex(mPickedEntityInfo.GPUIndex);
-                break;
-
-            case PickedGPUEntityInfo::GPUEntityType::Light:
-                std::visit(Foundation::MakeVisitor(
-                    [this](SphericalLight* light) { mSphericalLight = light; },
-                    [this](FlatLight* light) { mFlatLight = light; }),
-                    mScene->GetLightForGPUIndex(mPickedEntityInfo.GPUIndex));
-                break;
-
-            case PickedGPUEntityInfo::GPUEntityType::DebugGIProbe:
-                Dependencies->ScenePtr->GetGIManager().PickedDebugProbeIndex = mPickedEntityInfo.GPUIndex;
-                break;
-            }
+            std::visit(Foundation::MakeVisitor(
+                [this](MeshInstanceHandle instance) { mMeshInstance = instance; },
+                [this](SphericalLight* light) { mSphericalLight = light; },
+                [this](FlatLight* light) { mFlatLight = light; },
+                [this](SceneBVH::DebugGIProbe probe) { Dependencies->ScenePtr->GetGIManager().PickedDebugProbeIndex = probe.Index; }),
+                hit->HitEntity);
         }
         else
         {
@@ -46,7 +44,7 @@ namespace PathFinder
 
     void PickedEntityViewModel::HandleEsc()
     {
-        mMeshInstance = nullptr;
+        mMeshInstance = {};
         mSphericalLight = nullptr;
         mFlatLight = nullptr;
         mSky = nullptr;
@@ -55,7 +53,7 @@ namespace PathFinder
 
     void PickedEntityViewModel::SelectSky()
     {
-        mMeshInstance = nullptr;
+        mMeshInstance = {};
         mSphericalLight = nullptr;
         mFlatLight = nullptr;
         mSky = &Dependencies->ScenePtr->GetSky();
@@ -73,7 +71,11 @@ namespace PathFinder
     {
         mScene = Dependencies->ScenePtr;
 
-        mShouldDisplay = mMeshInstance != nullptr || mSphericalLight != nullptr || mFlatLight != nullptr || mSky != nullptr;
+        // Instance might have been removed from the scene since it was picked
+        if (mMeshInstance.IsValid() && !mScene->GetMeshInstances().Contains(mMeshInstance))
+            mMeshInstance = {};
+
+        mShouldDisplay = mMeshInstance.IsValid() || mSphericalLight != nullptr || mFlatLight != nullptr || mSky != nullptr;
         mAllowedGizmoTypes = GizmoType::All;
         mAllowedGizmoSpaces = GizmoSpace::All;
 
@@ -89,8 +91,8 @@ namespace PathFinder
             mAllowedGizmoSpaces = GizmoSpace::World;
         }
            
-        if (mMeshInstance)
-            mModelMatrix = mMeshInstance->GetTransformation().GetMatrix();
+        if (mMeshInstance.IsValid())
+            mModelMatrix = mScene->GetMeshInstances().WorldMatrix(mScene->GetMeshInstances().Index(mMeshInstance));
         else if (mSphericalLight)
             mModelMatrix = mSphericalLight->GetModelMatrix();
         else if (mFlatLight)
@@ -106,9 +108,11 @@ namespace PathFinder
 
     void PickedEntityViewModel::Export()
     {
-        if (mMeshInstance)
+        if (mMeshInstance.IsValid())
         {
-            mMeshInstance->SetTransformation(Geometry::Transformation{ mModifiedModelMatrix });
+            // Untouched gizmo leaves the instance out of this frame's transform update
+            if (mModifiedModelMatrix != mModelMatrix)
+                mScene->GetMeshInstances().SetWorldMatrix(mMeshInstance, mModifiedModelMatrix);
         }
         else if (mSphericalLight)
         {
@@ -158,22 +162,6 @@ namespace PathFinder
         }
     }
 
-    void PickedEntityViewModel::OnCreated()
-    {
-        Dependencies->RenderEngine->PostRenderEvent() += { "PickedEntityViewModel.Post.Render", [this]()
-        {
-            const Memory::Buffer* pickedGeometryInfo = Dependencies->ResourceStorage->GetPerResourceData(PathFinder::ResourceNames::PickedGeometryInfo)->Buffer.get();
-
-            pickedGeometryInfo->Read<PickedGPUEntityInfo>([this](const PickedGPUEntityInfo* info)
-            {
-                if (info)
-                {
-                    mPickedEntityInfo = *info;
-                }
-            });
-        }};
-    }
-
     glm::mat4 PickedEntityViewModel::ConstructSunMatrix(const Sky& sky) const
     {
         const Camera& camera = mScene->GetMainCamera();
@@ -2,26 +2,13 @@
 
 #include "ViewModel.hpp"
 
-#include <Scene/MeshInstance.hpp>
+#include <Scene/MeshInstanceStorage.hpp>
 #include <Scene/Scene.hpp>
 #include <Foundation/BitwiseEnum.hpp>
 
 namespace PathFinder
 {
    
-    struct PickedGPUEntityInfo
-    {
-        enum class GPUEntityType : uint32_t
-        {
-            MeshInstance = 0, Light = 1, DebugGIProbe = 2
-        };
-
-        static const uint32_t NoEntity = std::numeric_limits<uint32_t>::max();
-
-        uint32_t GPUIndex = NoEntity;
-        uint32_t EntityType = 0;
-    };
-
     class PickedEntityViewModel : public ViewModel
     {
     public:
@@ -40,14 +27,13 @@ namespace PathFinder
             All = Local | World
         };
 
-        void HandleClick();
+        void HandleClick(const glm::vec2& mousePosition);
         void HandleEsc();
         void SelectSky();
         void SetModifiedModelMatrix(const glm::mat4& mat, const glm::mat4& delta);
 
         void Import() override;
         void Export() override;
-        void OnCreated() override;
 
     private:
         glm::mat4 ConstructSunMatrix(const Sky& sky) const;
@@ -59,13 +45,11 @@ namespace PathFinder
         glm::mat4 mModelMatrix;
         glm::mat4 mModifiedModelMatrix;
         glm::mat4 mDeltaMatrix;
-        MeshInstance* mMeshInstance = nullptr;
+        MeshInstanceHandle mMeshInstance;
         SphericalLight* mSphericalLight = nullptr;
         FlatLight* mFlatLight = nullptr;
         Sky* mSky = nullptr;
         Scene* mScene = nullptr;
-        
-        PickedGPUEntityInfo mPickedEntityInfo;
 
     public:
         inline const glm::mat4& ModelMatrix() const { return mModelMatrix; }
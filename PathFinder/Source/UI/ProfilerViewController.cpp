@@ -17,6 +17,14 @@ namespace PathFinder
         ImGui::Begin("GPU Profiler", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
         ImGui::Text(ProfilerVM->FrameMeasurement().c_str());
         ImGui::Text(ProfilerVM->BarrierMeasurements().c_str());
+        ImGui::Text(ProfilerVM->FramePlan().c_str());
+
+        if (!ProfilerVM->BarrierPlan().empty())
+            ImGui::Text(ProfilerVM->BarrierPlan().c_str());
+
+        ImGui::Text(ProfilerVM->MemoryAllocation().c_str());
+        ImGui::Text(ProfilerVM->Fragmentation().c_str());
+        ImGui::Text(ProfilerVM->AccelerationStructures().c_str());
         ImGui::Separator();
 
         for (const std::string& workMeasurement : ProfilerVM->WorkMeasurements())
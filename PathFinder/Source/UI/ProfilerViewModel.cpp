@@ -10,18 +10,37 @@ namespace PathFinder
 
         mWorkMeasurementStrings.clear();
 
-        auto constructMeasurementString = [](const RenderDevice::PipelineMeasurement& measurement) -> std::string
+        using MeasurementType = PipelineMeasurementStorage::MeasurementType;
+
+        const PipelineMeasurementStorage& storage = Dependencies->Device->MeasurementStorage();
+
+        auto constructMeasurementString = [&storage](const RenderDevice::PipelineMeasurement& measurement, MeasurementType type) -> std::string
         {
             std::stringstream ss;
             ss << std::setprecision(3) << std::fixed << measurement.DurationSeconds * 1000;
-            return ss.str() + " ms " + measurement.Name;
+
+            // Find series on any queue
+            const PipelineMeasurementStorage::Series* series = nullptr;
+            for (auto queueIdx = 0; queueIdx < 2 && !series; ++queueIdx)
+                series = storage.GetSeries(measurement.Name, type, queueIdx);
+
+            if (series)
+            {
+                ss << " ms (p95 " << series->Stats.P95 * 1000 << ")" << (series->Stats.IsSpike ? " [Spike]" : "");
+            }
+            else
+            {
+                ss << " ms";
+            }
+
+            return ss.str() + " " + measurement.Name.ToString();
         };
 
-        mFrameMeasurementString = constructMeasurementString(Dependencies->Device->FrameMeasurement());
+        mFrameMeasurementString = constructMeasurementString(Dependencies->Device->FrameMeasurement(), MeasurementType::Frame);
 
         for (const RenderDevice::PipelineMeasurement& measurement : Dependencies->Device->RenderPassWorkMeasurements())
         {
-            mWorkMeasurementStrings.push_back(constructMeasurementString(measurement));
+            mWorkMeasurementStrings.push_back(constructMeasurementString(measurement, MeasurementType::PassWork));
         }
 
         float marriersTime = 0.0;
@@ -34,6 +53,57 @@ namespace PathFinder
         std::stringstream ss;
         ss << std::setprecision(3) << std::fixed << marriersTime;
         mBarrierMeasurementsString = ss.str() + " us " + "Total Barriers Time";
+
+        const RenderDevice::FramePlanStatistics& planStats = Dependencies->Device->FramePlanStats();
+        uint64_t planFrameCount = std::max(planStats.HitCount + planStats.MissCount, uint64_t(1));
+
+        std::stringstream planSS;
+        planSS << std::setprecision(1) << std::fixed << 100.0 * planStats.HitCount / planFrameCount << "% Frame Plan Hits"
+            << std::setprecision(3) << " (replay " << planStats.ReplaySeconds * 1000 << " ms, compile " << planStats.CompileSeconds * 1000 << " ms)";
+        mFramePlanString = planSS.str();
+
+        const std::optional<BarrierPlanner::Score>& barrierScore = Dependencies->Device->BarrierPlanScore();
+        const std::optional<BarrierPlanner::Score>& legacyBarrierScore = Dependencies->Device->LegacyBarrierPlanScore();
+        mBarrierPlanString.clear();
+
+        if (barrierScore && legacyBarrierScore)
+        {
+            std::stringstream barrierPlanSS;
+            barrierPlanSS << barrierScore->BarrierCount << " Barriers (" << barrierScore->SplitBarrierCount << " split, "
+                << barrierScore->ReroutedTransitionCount << " rerouted), stall cost " << std::setprecision(1) << std::fixed << barrierScore->EstimatedStallCost
+                << " vs " << legacyBarrierScore->BarrierCount << " Barriers, stall cost " << legacyBarrierScore->EstimatedStallCost << " legacy";
+            mBarrierPlanString = barrierPlanSS.str();
+        }
+
+        Memory::SegregatedPoolsResourceAllocator::Statistics allocatorStats = Dependencies->RenderEngine->ResourceAllocator()->GetStatistics();
+        uint64_t pageCapacity = std::max(allocatorStats.PageCapacityBytes, uint64_t(1));
+
+        std::stringstream memorySS;
+        memorySS << allocatorStats.HeapCount << " Heaps " << std::setprecision(1) << std::fixed
+            << allocatorStats.CommittedHeapBytes / (1024.0 * 1024.0) << " MB (" << 100.0 * allocatorStats.PageAllocatedBytes / pageCapacity << "% used, "
+            << allocatorStats.RecycledTextureCount << " recycled textures, "
+            << std::setprecision(3) << allocatorStats.AllocationSeconds * 1000 * 1000 / std::max(allocatorStats.AllocationCount, uint64_t(1)) << " us per allocation)";
+        mMemoryAllocationString = memorySS.str();
+
+        const Memory::ResourceDefragmenter* defragmenter = Dependencies->RenderEngine->ResourceDefragmenter();
+        Memory::SegregatedPoolsResourceAllocator::FragmentationMetrics fragmentation =
+            Dependencies->RenderEngine->ResourceAllocator()->GetFragmentationMetrics(Memory::ResourceDefragmenter::SparsePageUtilization);
+
+        std::stringstream fragmentationSS;
+        fragmentationSS << fragmentation.SparsePageCount << "/" << fragmentation.PageCount << " Sparse Pages " << std::setprecision(1) << std::fixed
+            << 100.0 * fragmentation.ExternalFragmentation << "% fragmented (" << defragmenter->GetStatistics().RelocationsStarted << " relocations, "
+            << allocatorStats.EvacuatedHeapReleaseCount << " pages released)";
+        mFragmentationString = fragmentationSS.str();
+
+        const RTASManager::Statistics& rtasStats = Dependencies->RenderEngine->AccelerationStructureManager()->GetStatistics();
+        float rtasGPUMilliseconds = Dependencies->RenderEngine->AccelerationStructureRecorder()->GPUMilliseconds();
+
+        std::stringstream rtasSS;
+        rtasSS << rtasStats.Plan.BuildCount << " BLAS Builds (" << rtasStats.Plan.DeferredBuildCount << " deferred) in " << rtasStats.Plan.BatchCount
+            << " Batches " << std::setprecision(3) << std::fixed << rtasGPUMilliseconds << " ms (record " << rtasStats.RecordingMilliseconds << " ms), " << std::setprecision(1)
+            << rtasStats.Plan.TotalCompactionBytesSaved / (1024.0 * 1024.0) << " MB saved by compaction, "
+            << rtasStats.Plan.ScratchBytesSaved / (1024.0 * 1024.0) << " MB by shared scratch";
+        mAccelerationStructuresString = rtasSS.str();
     }
 
 }
@@ -16,12 +16,22 @@ namespace PathFinder
         std::vector<std::string> mWorkMeasurementStrings;
         std::string mBarrierMeasurementsString;
         std::string mFrameMeasurementString;
+        std::string mFramePlanString;
+        std::string mBarrierPlanString;
+        std::string mMemoryAllocationString;
+        std::string mFragmentationString;
+        std::string mAccelerationStructuresString;
         Foundation::Cooldown mUpdateCooldown{ 0.075 };
 
     public:
         inline const auto& WorkMeasurements() const { return mWorkMeasurementStrings; }
         inline const std::string& BarrierMeasurements() const { return mBarrierMeasurementsString; }
         inline const std::string& FrameMeasurement() const { return mFrameMeasurementString; }
+        inline const std::string& FramePlan() const { return mFramePlanString; }
+        inline const std::string& BarrierPlan() const { return mBarrierPlanString; }
+        inline const std::string& MemoryAllocation() const { return mMemoryAllocationString; }
+        inline const std::string& Fragmentation() const { return mFragmentationString; }
+        inline const std::string& AccelerationStructures() const { return mAccelerationStructuresString; }
     };
 
 }
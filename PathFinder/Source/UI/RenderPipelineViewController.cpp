@@ -18,6 +18,9 @@ namespace PathFinder
         ImGui::Checkbox("Enable Memory Aliasing", &VM->RenderPipelineSettings()->IsMemoryAliasingEnabled);
         ImGui::Checkbox("Enable Async Compute", &VM->RenderPipelineSettings()->IsAsyncComputeEnabled);
         ImGui::Checkbox("Enable Split Barriers", &VM->RenderPipelineSettings()->IsSplitBarriersEnabled);
+        ImGui::Checkbox("Automatic Async Compute Assignment", &VM->RenderPipelineSettings()->IsAutomaticQueueAssignmentEnabled);
+        ImGui::Checkbox("Cache Frame Plan", &VM->RenderPipelineSettings()->IsFramePlanCachingEnabled);
+        ImGui::Checkbox("Score Barrier Placement", &VM->RenderPipelineSettings()->IsBarrierPlanScoringEnabled);
 
         bool isStatePowerStateEnabled = VM->IsStablePowerStateEnabled();
         if (ImGui::Checkbox("Enable Stable Power State (Windows Dev. mode required)", &isStatePowerStateEnabled))
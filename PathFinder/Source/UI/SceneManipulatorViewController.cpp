@@ -195,7 +195,7 @@ namespace PathFinder
     {
         if (GetInput()->CurrentClickCount() == 1 && !GetUIManager()->IsInteracting() && !GetUIManager()->IsMouseOverUI())
         {
-            EntityVM->HandleClick();
+            EntityVM->HandleClick(GetInput()->MousePosition());
         }
 
         if (GetInput()->WasKeyboardKeyUnpressed(KeyboardKey::T) &&
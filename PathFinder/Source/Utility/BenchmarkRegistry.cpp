@@ -0,0 +1,32 @@
+#include "BenchmarkRegistry.hpp"
+
+#include <Foundation/Assert.hpp>
+
+#include <algorithm>
+
+namespace PathFinder
+{
+
+    void BenchmarkRegistry::Register(const std::string& name, const std::string& reportFileName, const Benchmark& benchmark)
+    {
+        AddEntry({ name, reportFileName, false, benchmark });
+    }
+
+    void BenchmarkRegistry::RegisterDeviceBenchmark(const std::string& name, const std::string& reportFileName, const Benchmark& benchmark)
+    {
+        AddEntry({ name, reportFileName, true, benchmark });
+    }
+
+    const BenchmarkRegistry::Entry* BenchmarkRegistry::Find(const std::string& name) const
+    {
+        auto it = std::find_if(mEntries.begin(), mEntries.end(), [&name](const Entry& entry) { return entry.Name == name; });
+        return it != mEntries.end() ? &(*it) : nullptr;
+    }
+
+    void BenchmarkRegistry::AddEntry(Entry&& entry)
+    {
+        assert_format(!Find(entry.Name), "Benchmark ", entry.Name, " is already registered");
+        mEntries.emplace_back(std::move(entry));
+    }
+
+}
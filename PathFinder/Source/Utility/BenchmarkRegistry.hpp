@@ -0,0 +1,55 @@
+#pragma once
+
+#include <HardwareAbstractionLayer/Device.hpp>
+#include <Memory/GPUResourceProducer.hpp>
+
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace PathFinder
+{
+
+    /// Headless runs selected with -benchmark <name> instead of starting the application.
+    /// Every benchmark writes a JSON report next to the executable and fails if validation of its results fails.
+    /// Benchmarks that don't need a device run before any window or device is created.
+    class BenchmarkRegistry
+    {
+    public:
+        struct Context
+        {
+            std::filesystem::path ReportPath;
+            // Passed with -benchmark_input
+            std::optional<std::filesystem::path> Input;
+            // Only set for benchmarks that require a device
+            const HAL::Device* Device = nullptr;
+            Memory::GPUResourceProducer* ResourceProducer = nullptr;
+        };
+
+        using Benchmark = std::function<bool(const Context& context)>;
+
+        struct Entry
+        {
+            std::string Name;
+            std::string ReportFileName;
+            bool RequiresDevice = false;
+            Benchmark Run;
+        };
+
+        void Register(const std::string& name, const std::string& reportFileName, const Benchmark& benchmark);
+        void RegisterDeviceBenchmark(const std::string& name, const std::string& reportFileName, const Benchmark& benchmark);
+
+        const Entry* Find(const std::string& name) const;
+
+    private:
+        void AddEntry(Entry&& entry);
+
+        std::vector<Entry> mEntries;
+
+    public:
+        inline const auto& Entries() const { return mEntries; }
+    };
+
+}
@@ -2,10 +2,157 @@
 #pragma comment(linker, "/SUBSYSTEM:windows /ENTRY:mainCRTStartup")
 
 #include "Application.hpp"
+#include <Utility/BenchmarkRegistry.hpp>
+#include <RenderPipeline/RenderPassGraphAnalyzer.hpp>
+#include <RenderPipeline/QueueAssignmentOptimizer.hpp>
+#include <RenderPipeline/BarrierPlanner.hpp>
+#include <Scene/DisplacementDistanceFieldBaker.hpp>
+#include <Scene/TextureCompressor.hpp>
+#include <Scene/GIProbeInvalidationGrid.hpp>
+#include <Scene/IlluminanceFieldCascade.hpp>
+#include <Scene/MeshInstanceStorage.hpp>
+#include <Scene/TransformHierarchy.hpp>
+#include <Memory/CompactingRangeAllocator.hpp>
+#include <RenderPipeline/RTASBuildPlanner.hpp>
+#include <Foundation/CPUProfiler.hpp>
+#include <Foundation/TaskScheduler.hpp>
+#include <Foundation/SamplingService.hpp>
+#include <Foundation/FixedSpectrum.hpp>
+#include <Geometry/CollisionKernels.hpp>
+#include <Geometry/InstanceBVH.hpp>
+
+namespace
+{
+
+    PathFinder::BenchmarkRegistry CreateBenchmarkRegistry()
+    {
+        using namespace PathFinder;
+        using Context = BenchmarkRegistry::Context;
+
+        BenchmarkRegistry registry;
+
+        // Timing and validation of CPU displacement distance field baking
+        registry.Register("distance_field", "DistanceFieldBenchmark.json",
+            [](const Context& context) { return DisplacementDistanceFieldBaker::RunBenchmark(context.ReportPath); });
+
+        // Throughput and quality measurement of CPU texture block compression
+        registry.Register("texture_compression", "TextureCompressionBenchmark.json",
+            [](const Context& context) { return TextureCompressor::RunBenchmark(context.ReportPath); });
+
+        // Per zone overhead of the CPU profiler with capture disabled and enabled
+        registry.Register("cpu_profiler", "CPUProfilerBenchmark.json",
+            [](const Context& context) { return Foundation::CPUProfiler::RunBenchmark(context.ReportPath); });
+
+        // Scalability measurement of the task scheduler
+        registry.Register("tasks", "TaskSchedulerBenchmark.json",
+            [](const Context& context) { return Foundation::TaskScheduler::RunBenchmark(context.ReportPath); });
+
+        // Legacy and planned barrier placement scored on frame transitions recorded with -record_barriers. Takes the record as input.
+        registry.Register("barriers", "BarrierBenchmark.json",
+            [](const Context& context) { return context.Input && BarrierPlanner::RunBenchmark(*context.Input, context.ReportPath); });
+
+        // Texture loading throughput is measured on footprints of a real device. Takes a texture folder as input.
+        registry.RegisterDeviceBenchmark("texture_loading", "TextureLoadingBenchmark.json", [](const Context& context)
+        {
+            ResourceLoader resourceLoader{ context.ResourceProducer };
+            return context.Input && resourceLoader.RunBenchmark(*context.Input, context.ReportPath);
+        });
+
+        // Transient heap relayouts are measured on a real device
+        registry.RegisterDeviceBenchmark("transient_heaps", "TransientHeapBenchmark.json",
+            [](const Context& context) { return Memory::TransientHeapPool::RunBenchmark(context.Device, context.ResourceProducer, context.ReportPath); });
+
+        // Heap creations, allocation latency and utilization of segregated pools on a real device
+        registry.RegisterDeviceBenchmark("resource_allocator", "ResourceAllocatorBenchmark.json",
+            [](const Context& context) { return Memory::SegregatedPoolsResourceAllocator::RunBenchmark(context.Device, context.ReportPath); });
+
+        // Memory and fragmentation over a simulated editing session with and without defragmentation
+        registry.RegisterDeviceBenchmark("defragmentation", "DefragmentationBenchmark.json",
+            [](const Context& context) { return Memory::ResourceDefragmenter::RunBenchmark(context.Device, context.ReportPath); });
+
+        // Per probe GI invalidation with thousands of dynamic objects
+        registry.Register("gi_invalidation", "GIInvalidationBenchmark.json",
+            [](const Context& context) { return GIProbeInvalidationGrid::RunBenchmark(context.ReportPath); });
+
+        // Dirty probe statistics of toroidally scrolled GI cascades over camera sweeps
+        registry.Register("gi_scrolling", "GIScrollingBenchmark.json",
+            [](const Context& context) { return IlluminanceFieldCascade::RunBenchmark(context.ReportPath); });
+
+        // Sampling table generation throughput and discrepancy checks, fails if any sequence loses its guarantees
+        registry.Register("sampling", "SamplingBenchmark.json",
+            [](const Context& context) { return Foundation::SamplingService::RunBenchmark(context.ReportPath); });
+
+        // Per spectrum and batched spectral conversion timings
+        registry.Register("spectrum", "SpectrumBenchmark.json",
+            [](const Context& context) { return Foundation::VisibleSpectrum::RunBenchmark(context.ReportPath); });
+
+        // Throughput of batched collision kernels for each instruction set against scalar Collision tests
+        registry.Register("geometry_kernels", "GeometryKernelsBenchmark.json",
+            [](const Context& context) { return Geometry::CollisionKernels::RunBenchmark(context.ReportPath); });
+
+        // Build, refit and ray query timings of the CPU two-level hierarchy on procedural scenes
+        registry.Register("bvh", "BVHBenchmark.json",
+            [](const Context& context) { return Geometry::InstanceBVH::RunBenchmark(context.ReportPath); });
+
+        // Per-frame scene update timings of dense mesh instance storage against list based storage
+        registry.Register("scene_storage", "SceneStorageBenchmark.json",
+            [](const Context& context) { return MeshInstanceStorage::RunBenchmark(context.ReportPath); });
+
+        // Level ordered transform hierarchy updates on deep, wide and balanced hierarchies
+        registry.Register("transform_hierarchy", "TransformHierarchyBenchmark.json",
+            [](const Context& context) { return TransformHierarchy::RunBenchmark(context.ReportPath); });
+
+        // Runtime add, remove and compaction of geometry buffer ranges with remapped contents validation
+        registry.Register("range_compaction", "RangeCompactionBenchmark.json",
+            [](const Context& context) { return Memory::CompactingRangeAllocator::RunBenchmark(context.ReportPath); });
+
+        // Planning of batched bottom acceleration structure builds and compactions from synthetic prebuild sizes
+        registry.Register("rtas_builds", "RTASBuildBenchmark.json",
+            [](const Context& context) { return RTASBuildPlanner::RunBenchmark(context.ReportPath); });
+
+        return registry;
+    }
+
+}
 
 int main(int argc, char** argv)
 {
+    PathFinder::CommandLineParser cmdLineParser{ argc, argv };
+    PathFinder::BenchmarkRegistry benchmarks = CreateBenchmarkRegistry();
+    const PathFinder::BenchmarkRegistry::Entry* benchmark = nullptr;
+
+    if (cmdLineParser.BenchmarkToRun())
+    {
+        benchmark = benchmarks.Find(*cmdLineParser.BenchmarkToRun());
+        assert_format(benchmark, "Unknown benchmark ", *cmdLineParser.BenchmarkToRun());
+
+        // Headless benchmarks run without creating a window and a device
+        if (!benchmark->RequiresDevice)
+        {
+            PathFinder::BenchmarkRegistry::Context context{ cmdLineParser.ExecutableFolderPath() / benchmark->ReportFileName, cmdLineParser.BenchmarkInput() };
+            return benchmark->Run(context) ? 0 : 1;
+        }
+    }
+
+    // Headless analysis of a previously recorded render graph
+    if (cmdLineParser.GraphRecordToAnalyze())
+    {
+        return PathFinder::RenderPassGraphAnalyzer::AnalyzeRecordedGraph(*cmdLineParser.GraphRecordToAnalyze()) ? 0 : 1;
+    }
+
+    // Headless queue assignment search on a previously recorded render graph
+    if (cmdLineParser.GraphRecordToOptimize())
+    {
+        return PathFinder::QueueAssignmentOptimizer::OptimizeRecordedGraph(*cmdLineParser.GraphRecordToOptimize()) ? 0 : 1;
+    }
+
     PathFinder::Application app{ argc, argv };
+
+    if (benchmark)
+    {
+        return app.RunBenchmark(*benchmark) ? 0 : 1;
+    }
+
     app.RunMessageLoop();
     return 0;
 }
\ No newline at end of file
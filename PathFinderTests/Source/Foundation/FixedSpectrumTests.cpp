@@ -0,0 +1,210 @@
+#include "../TestRunner.hpp"
+
+#include <Foundation/FixedSpectrum.hpp>
+
+#include <glm/common.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+    using Spectrum = Foundation::VisibleSpectrum;
+    using Foundation::SpectrumType;
+
+    const float RelativeTolerance = 1e-4f;
+
+    // Vector backed spectrum that builds matching functions and RGB basis for every instance,
+    // the way spectra were computed before FixedSpectrum
+    class ReferenceSpectrum
+    {
+    public:
+        ReferenceSpectrum(uint32_t sampleCount, float lowestWavelength, float highestWavelength)
+            : mLowestWavelength{ lowestWavelength }, mHighestWavelength{ highestWavelength }, mSamples(sampleCount, 0.0f)
+        {
+            using namespace Foundation;
+
+            const float* tables[] = {
+                CIE_X, CIE_Y, CIE_Z,
+                RGBRefl2SpectWhite, RGBRefl2SpectCyan, RGBRefl2SpectMagenta, RGBRefl2SpectYellow, RGBRefl2SpectRed, RGBRefl2SpectGreen, RGBRefl2SpectBlue,
+                RGBIllum2SpectWhite, RGBIllum2SpectCyan, RGBIllum2SpectMagenta, RGBIllum2SpectYellow, RGBIllum2SpectRed, RGBIllum2SpectGreen, RGBIllum2SpectBlue
+            };
+
+            for (uint32_t table = 0; table < std::size(tables); ++table)
+            {
+                std::vector<float>& function = mFunctions.emplace_back(sampleCount);
+                bool isCIE = table < 3;
+
+                for (uint32_t i = 0; i < sampleCount; ++i)
+                {
+                    float wl0 = glm::mix(mLowestWavelength, mHighestWavelength, float(i) / float(sampleCount));
+                    float wl1 = glm::mix(mLowestWavelength, mHighestWavelength, float(i + 1) / float(sampleCount));
+
+                    function[i] = isCIE ?
+                        AverageSpectrumSamples(CIE_lambda, tables[table], nCIESamples, wl0, wl1) :
+                        AverageSpectrumSamples(RGB2SpectLambda, tables[table], nRGB2SpectSamples, wl0, wl1);
+                }
+            }
+        }
+
+        void FromRGB(const glm::vec3& rgb, SpectrumType type)
+        {
+            // Functions of the spectrum type, ordered white, cyan, magenta, yellow, red, green, blue
+            uint32_t first = type == SpectrumType::Reflectance ? 3 : 10;
+            std::vector<float> sum(mSamples.size(), 0.0f);
+
+            auto add = [&](float weight, uint32_t color)
+            {
+                for (uint32_t i = 0; i < sum.size(); ++i)
+                    sum[i] += weight * mFunctions[first + color][i];
+            };
+
+            if (rgb[0] <= rgb[1] && rgb[0] <= rgb[2])
+            {
+                add(rgb[0], 0);
+                if (rgb[1] <= rgb[2]) { add(rgb[1] - rgb[0], 1); add(rgb[2] - rgb[1], 6); }
+                else { add(rgb[2] - rgb[0], 1); add(rgb[1] - rgb[2], 5); }
+            }
+            else if (rgb[1] <= rgb[0] && rgb[1] <= rgb[2])
+            {
+                add(rgb[1], 0);
+                if (rgb[0] <= rgb[2]) { add(rgb[0] - rgb[1], 2); add(rgb[2] - rgb[0], 6); }
+                else { add(rgb[2] - rgb[1], 2); add(rgb[0] - rgb[2], 4); }
+            }
+            else
+            {
+                add(rgb[2], 0);
+                if (rgb[0] <= rgb[1]) { add(rgb[0] - rgb[2], 3); add(rgb[1] - rgb[0], 5); }
+                else { add(rgb[1] - rgb[2], 3); add(rgb[0] - rgb[1], 4); }
+            }
+
+            float scale = type == SpectrumType::Reflectance ? 0.94f : 0.86445f;
+
+            for (uint32_t i = 0; i < mSamples.size(); ++i)
+                mSamples[i] = std::max(sum[i] * scale, 0.0f);
+        }
+
+        glm::vec3 ToXYZ() const
+        {
+            glm::vec3 xyz{ 0.0f };
+
+            for (uint32_t i = 0; i < mSamples.size(); ++i)
+            {
+                xyz[0] += mFunctions[0][i] * mSamples[i];
+                xyz[1] += mFunctions[1][i] * mSamples[i];
+                xyz[2] += mFunctions[2][i] * mSamples[i];
+            }
+
+            return xyz * (mHighestWavelength - mLowestWavelength) / float(Foundation::CIE_Y_integral * mSamples.size());
+        }
+
+        glm::vec3 ToRGB() const
+        {
+            glm::vec3 rgb;
+            Foundation::XYZToRGB(ToXYZ(), rgb);
+            return rgb;
+        }
+
+    private:
+        float mLowestWavelength;
+        float mHighestWavelength;
+        std::vector<float> mSamples;
+        std::vector<std::vector<float>> mFunctions;
+
+    public:
+        inline float operator[](uint32_t sampleIndex) const { return mSamples[sampleIndex]; }
+    };
+
+    // Relative to the largest component, since conversion to RGB cancels out small ones
+    float RelativeError(const glm::vec3& value, const glm::vec3& reference)
+    {
+        glm::vec3 error = glm::abs(value - reference);
+        float magnitude = std::max(std::max(std::abs(reference.x), std::abs(reference.y)), std::max(std::abs(reference.z), 1e-3f));
+        return std::max(error.x, std::max(error.y, error.z)) / magnitude;
+    }
+
+    std::vector<glm::vec3> RandomColors(uint32_t count)
+    {
+        std::mt19937 generator{ 12345 };
+        std::uniform_real_distribution<float> distribution{ 0.0f, 4.0f };
+        std::vector<glm::vec3> colors(count);
+
+        for (glm::vec3& color : colors)
+            color = { distribution(generator), distribution(generator), distribution(generator) };
+
+        return colors;
+    }
+
+    SpectrumType AlternatingType(uint64_t index)
+    {
+        return index % 2 ? SpectrumType::Reflectance : SpectrumType::Illuminant;
+    }
+
+}
+
+PF_TEST(FixedSpectrum_FromRGBMatchesReference)
+{
+    std::vector<glm::vec3> colors = RandomColors(512);
+
+    for (uint64_t i = 0; i < colors.size(); ++i)
+    {
+        Spectrum spectrum = Spectrum::FromRGB(colors[i], AlternatingType(i));
+        ReferenceSpectrum reference{ Spectrum::SpectralSampleCount, 400.0f, 700.0f };
+        reference.FromRGB(colors[i], AlternatingType(i));
+
+        for (uint32_t sampleIndex = 0; sampleIndex < Spectrum::SpectralSampleCount; ++sampleIndex)
+        {
+            float error = std::abs(spectrum[sampleIndex] - reference[sampleIndex]) / std::max(std::abs(reference[sampleIndex]), 1e-3f);
+            PF_CHECK(error < RelativeTolerance);
+        }
+
+        // Padding must stay zero for the SIMD loops to ignore it
+        for (uint32_t sampleIndex = Spectrum::SpectralSampleCount; sampleIndex < Spectrum::PaddedSampleCount; ++sampleIndex)
+            PF_CHECK(spectrum[sampleIndex] == 0.0f);
+
+        PF_CHECK(RelativeError(spectrum.ToXYZ(), reference.ToXYZ()) < RelativeTolerance);
+        PF_CHECK(RelativeError(spectrum.ToRGB(), reference.ToRGB()) < RelativeTolerance);
+        PF_CHECK(std::abs(spectrum.Y() - reference.ToXYZ().y) / std::max(reference.ToXYZ().y, 1e-3f) < RelativeTolerance);
+    }
+}
+
+PF_TEST(FixedSpectrum_BatchConversionsMatchSingleSpectrum)
+{
+    // Count isn't a multiple of the 4 spectra a batch iteration converts
+    std::vector<glm::vec3> colors = RandomColors(1027);
+    std::vector<Spectrum> spectra(colors.size());
+    std::vector<glm::vec3> xyz(colors.size());
+    std::vector<glm::vec3> rgb(colors.size());
+
+    for (uint64_t i = 0; i < colors.size(); ++i)
+        spectra[i] = Spectrum::FromRGB(colors[i], AlternatingType(i));
+
+    Spectrum::ToXYZ(spectra.data(), spectra.size(), xyz.data());
+    Spectrum::ToRGB(spectra.data(), spectra.size(), rgb.data());
+
+    for (uint64_t i = 0; i < spectra.size(); ++i)
+    {
+        PF_CHECK(RelativeError(xyz[i], spectra[i].ToXYZ()) < RelativeTolerance);
+        PF_CHECK(RelativeError(rgb[i], spectra[i].ToRGB()) < RelativeTolerance);
+    }
+}
+
+PF_TEST(FixedSpectrum_WavelengthsAreIntervalCenters)
+{
+    // 25 intervals of 12 nm over 400-700 nm
+    PF_CHECK(std::abs(Spectrum::Wavelength(0) - 406.0f) < 1e-3f);
+    PF_CHECK(std::abs(Spectrum::Wavelength(Spectrum::SpectralSampleCount - 1) - 694.0f) < 1e-3f);
+
+    for (uint32_t i = 0; i < Spectrum::SpectralSampleCount; ++i)
+    {
+        float mirrored = Spectrum::Wavelength(Spectrum::SpectralSampleCount - 1 - i);
+        PF_CHECK(std::abs(Spectrum::Wavelength(i) + mirrored - 1100.0f) < 1e-3f);
+    }
+
+    // Constant spectrum of 1 integrates the normalized Y matching function to 1
+    PF_CHECK(std::abs(Spectrum{ 1.0f }.Y() - 1.0f) < 1e-2f);
+}
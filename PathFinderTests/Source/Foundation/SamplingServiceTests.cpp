@@ -0,0 +1,129 @@
+#include "../TestRunner.hpp"
+
+#include <Foundation/SamplingService.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+namespace
+{
+
+    using Service = Foundation::SamplingService;
+
+    const uint32_t SampleCount = 1024;
+
+    // L2 star discrepancy of the first dimensions of a sequence by Warnock's formula
+    double L2StarDiscrepancy(const std::function<float(uint32_t, uint32_t)>& sample, uint32_t dimensionCount)
+    {
+        std::vector<double> points(uint64_t(SampleCount) * dimensionCount);
+
+        for (uint32_t i = 0; i < SampleCount; ++i)
+            for (uint32_t k = 0; k < dimensionCount; ++k)
+                points[uint64_t(i) * dimensionCount + k] = sample(i, k);
+
+        double secondTerm = 0.0;
+        double thirdTerm = 0.0;
+
+        for (uint32_t i = 0; i < SampleCount; ++i)
+        {
+            const double* a = &points[uint64_t(i) * dimensionCount];
+            double product = 1.0;
+
+            for (uint32_t k = 0; k < dimensionCount; ++k)
+                product *= (1.0 - a[k] * a[k]) * 0.5;
+
+            secondTerm += product;
+
+            for (uint32_t j = 0; j < SampleCount; ++j)
+            {
+                const double* b = &points[uint64_t(j) * dimensionCount];
+                double pairProduct = 1.0;
+
+                for (uint32_t k = 0; k < dimensionCount; ++k)
+                    pairProduct *= 1.0 - std::max(a[k], b[k]);
+
+                thirdTerm += pairProduct;
+            }
+        }
+
+        double n = SampleCount;
+        return std::sqrt(std::max(std::pow(1.0 / 3.0, dimensionCount) - 2.0 * secondTerm / n + thirdTerm / (n * n), 0.0));
+    }
+
+    // Expected L2 star discrepancy of uniformly random points, which is what a single random set scatters around
+    double RandomPointsDiscrepancy(uint32_t dimensionCount)
+    {
+        return std::sqrt((std::pow(0.5, dimensionCount) - std::pow(1.0 / 3.0, dimensionCount)) / SampleCount);
+    }
+
+    double RadicalInverse(uint32_t index, uint32_t base)
+    {
+        double result = 0.0;
+        double scale = 1.0 / base;
+
+        for (; index > 0; index /= base, scale /= base)
+            result += (index % base) * scale;
+
+        return result;
+    }
+
+}
+
+PF_TEST(SamplingService_HaltonBeatsRandomPointsInEveryDimensionCount)
+{
+    Service service{ Service::DefaultDimensionCount, SampleCount, 0 };
+
+    for (uint32_t dimensionCount = 1; dimensionCount <= Service::DefaultDimensionCount; ++dimensionCount)
+    {
+        double discrepancy = L2StarDiscrepancy([&](uint32_t i, uint32_t k) { return service.Halton(i, k); }, dimensionCount);
+        PF_CHECK(discrepancy < RandomPointsDiscrepancy(dimensionCount));
+    }
+}
+
+PF_TEST(SamplingService_SobolBeatsRandomPointsInEveryDimensionCount)
+{
+    // Padding groups of 4 dimensions must not make the whole table less uniform than random points
+    for (uint32_t seed : { 0u, 7u })
+    {
+        Service service{ Service::DefaultDimensionCount, SampleCount, seed };
+
+        for (uint32_t dimensionCount = 1; dimensionCount <= Service::DefaultDimensionCount; ++dimensionCount)
+        {
+            double discrepancy = L2StarDiscrepancy([&](uint32_t i, uint32_t k) { return service.Sobol(i, k); }, dimensionCount);
+            PF_CHECK(discrepancy < RandomPointsDiscrepancy(dimensionCount));
+        }
+    }
+}
+
+PF_TEST(SamplingService_Rank1LatticeBeatsRandomPointsInEveryDimensionCount)
+{
+    Service service{ Service::DefaultDimensionCount, SampleCount, 0 };
+
+    for (uint32_t dimensionCount = 1; dimensionCount <= Service::DefaultDimensionCount; ++dimensionCount)
+    {
+        double discrepancy = L2StarDiscrepancy([&](uint32_t i, uint32_t k) { return service.Rank1Lattice(i, k); }, dimensionCount);
+        PF_CHECK(discrepancy < RandomPointsDiscrepancy(dimensionCount));
+    }
+}
+
+PF_TEST(SamplingService_HaltonKeepsPlainJitterDimensions)
+{
+    Service service{ Service::DefaultDimensionCount, SampleCount, 0 };
+
+    // Camera jitter expects the unscrambled (2, 3) Halton pattern
+    for (uint32_t i = 0; i < SampleCount; ++i)
+    {
+        PF_CHECK(std::abs(service.Halton(i, 0) - RadicalInverse(i, 2)) < 1e-6);
+        PF_CHECK(std::abs(service.Halton(i, 1) - RadicalInverse(i, 3)) < 1e-6);
+    }
+
+    // Scrambled dimensions still take every digit once per block of base size
+    std::vector<bool> isDigitTaken(5, false);
+
+    for (uint32_t i = 0; i < 5; ++i)
+        isDigitTaken[uint32_t(std::round(service.Halton(i, 2) * 5.0f))] = true;
+
+    PF_CHECK(std::all_of(isDigitTaken.begin(), isDigitTaken.end(), [](bool isTaken) { return isTaken; }));
+}
@@ -0,0 +1,306 @@
+#include "../TestRunner.hpp"
+
+#include <Geometry/CollisionKernels.hpp>
+#include <Geometry/Collision.hpp>
+
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+    namespace Kernels = Geometry::CollisionKernels;
+
+    using Geometry::AABB;
+    using Geometry::Ray3D;
+    using Geometry::Triangle3D;
+
+    // Odd count so that scalar tails of vectorized loops are exercised
+    const uint64_t PrimitiveCount = 1027;
+    const uint64_t QueryCount = 64;
+
+    // Möller-Trumbore and the plane based scalar test may disagree this close to triangle edges
+    const float TriangleEdgeTolerance = 1e-4f;
+
+    struct Scene
+    {
+        std::vector<AABB> BoxList;
+        std::vector<Triangle3D> TriangleList;
+        std::vector<Ray3D> Rays;
+        std::vector<glm::mat4> ViewProjections;
+        std::vector<glm::mat4> Transforms;
+
+        Kernels::AABBSoA Boxes;
+        Kernels::TriangleSoA Triangles;
+    };
+
+    Scene MakeScene()
+    {
+        std::mt19937 generator{ 12345 };
+        std::uniform_real_distribution<float> positionDistribution{ -10.0f, 10.0f };
+        std::uniform_real_distribution<float> sizeDistribution{ 0.1f, 4.0f };
+        std::uniform_real_distribution<float> unitDistribution{ -1.0f, 1.0f };
+
+        auto randomVector = [&](std::uniform_real_distribution<float>& distribution)
+        {
+            return glm::vec3{ distribution(generator), distribution(generator), distribution(generator) };
+        };
+
+        Scene scene;
+        scene.Boxes.Resize(PrimitiveCount);
+        scene.Triangles.Resize(PrimitiveCount);
+
+        for (uint64_t i = 0; i < PrimitiveCount; ++i)
+        {
+            glm::vec3 min = randomVector(positionDistribution);
+            glm::vec3 a = randomVector(positionDistribution);
+
+            scene.BoxList.emplace_back(min, min + randomVector(sizeDistribution));
+            scene.TriangleList.emplace_back(a, a + randomVector(unitDistribution) * 3.0f, a + randomVector(unitDistribution) * 3.0f);
+            scene.Boxes.Set(i, scene.BoxList.back());
+            scene.Triangles.Set(i, scene.TriangleList.back());
+        }
+
+        for (uint64_t i = 0; i < QueryCount; ++i)
+        {
+            glm::vec3 origin = randomVector(positionDistribution) * 2.0f;
+            glm::vec3 target = randomVector(positionDistribution) * 0.5f;
+            glm::vec3 up = std::abs(glm::normalize(target - origin).y) > 0.99f ? glm::vec3{ 1, 0, 0 } : glm::vec3{ 0, 1, 0 };
+
+            scene.Rays.emplace_back(origin, glm::normalize(target - origin));
+            scene.ViewProjections.push_back(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 30.0f) * glm::lookAt(origin, target, up));
+
+            glm::quat rotation = glm::angleAxis(unitDistribution(generator) * 3.14159f, glm::normalize(randomVector(unitDistribution) + glm::vec3{ 0.0f, 0.0f, 1e-3f }));
+            scene.Transforms.push_back(glm::translate(glm::mat4{ 1.0f }, randomVector(positionDistribution)) * glm::mat4_cast(rotation) * glm::scale(glm::mat4{ 1.0f }, randomVector(sizeDistribution)));
+        }
+
+        return scene;
+    }
+
+    // Runs the function with each instruction set the CPU supports activated, scalar first
+    template <class Function>
+    void ForEachInstructionSet(Function&& function)
+    {
+        std::vector<Kernels::InstructionSet> sets = { Kernels::InstructionSet::Scalar, Kernels::InstructionSet::SSE };
+
+        if (Kernels::SupportedInstructionSet() == Kernels::InstructionSet::AVX2)
+            sets.push_back(Kernels::InstructionSet::AVX2);
+
+        for (Kernels::InstructionSet set : sets)
+        {
+            Kernels::SetActiveInstructionSet(set);
+            function(set);
+        }
+
+        Kernels::SetActiveInstructionSet(Kernels::SupportedInstructionSet());
+    }
+
+    // Culled if all 8 corners are outside one plane
+    bool IsVisibleReference(const Kernels::FrustumPlanes& planes, const AABB& box)
+    {
+        std::array<glm::vec4, 8> corners = box.CornerPoints();
+
+        for (const glm::vec4& plane : planes)
+        {
+            bool isOutside = true;
+
+            for (const glm::vec4& corner : corners)
+                isOutside &= plane.x * corner.x + plane.y * corner.y + plane.z * corner.z + plane.w < 0.0f;
+
+            if (isOutside)
+                return false;
+        }
+
+        return true;
+    }
+
+    // Bounds of 8 transformed corners
+    AABB TransformReference(const glm::mat4& transform, const AABB& box)
+    {
+        std::array<glm::vec4, 8> corners = box.CornerPoints();
+
+        for (glm::vec4& corner : corners)
+            corner = transform * corner;
+
+        return AABB{ corners.begin(), corners.end() };
+    }
+
+    bool IsNearTriangleEdge(const Ray3D& ray, const Triangle3D& triangle)
+    {
+        glm::dvec3 ab = glm::dvec3{ triangle.b } - glm::dvec3{ triangle.a };
+        glm::dvec3 ac = glm::dvec3{ triangle.c } - glm::dvec3{ triangle.a };
+        glm::dvec3 direction{ ray.direction };
+        glm::dvec3 p = glm::cross(direction, ac);
+        double determinant = glm::dot(ab, p);
+
+        if (std::abs(determinant) < 1e-6)
+            return true;
+
+        glm::dvec3 t = glm::dvec3{ ray.origin } - glm::dvec3{ triangle.a };
+        glm::dvec3 q = glm::cross(t, ab);
+        double u = glm::dot(t, p) / determinant;
+        double v = glm::dot(direction, q) / determinant;
+
+        return std::min({ std::abs(u), std::abs(v), std::abs(1.0 - u - v) }) < TriangleEdgeTolerance;
+    }
+
+}
+
+PF_TEST(CollisionKernels_RayAABBsMatchCollision)
+{
+    Scene scene = MakeScene();
+    std::vector<uint8_t> hits(PrimitiveCount);
+    std::vector<float> distances(PrimitiveCount);
+
+    ForEachInstructionSet([&](Kernels::InstructionSet)
+    {
+        for (const Ray3D& ray : scene.Rays)
+        {
+            Kernels::RayAABBs(ray, scene.Boxes, hits.data(), distances.data());
+
+            for (uint64_t i = 0; i < PrimitiveCount; ++i)
+            {
+                float distance = 0.0f;
+                bool isHit = Geometry::Collision::RayAABB(ray, scene.BoxList[i], distance);
+                PF_CHECK(isHit == bool(hits[i]) && distance == distances[i]);
+            }
+        }
+    });
+}
+
+PF_TEST(CollisionKernels_RayTrianglesMatchCollisionAwayFromEdges)
+{
+    Scene scene = MakeScene();
+    std::vector<uint8_t> hits(PrimitiveCount);
+    std::vector<float> distances(PrimitiveCount);
+    uint64_t hitCount = 0;
+
+    ForEachInstructionSet([&](Kernels::InstructionSet)
+    {
+        for (const Ray3D& ray : scene.Rays)
+        {
+            Kernels::RayTriangles(ray, scene.Triangles, hits.data(), distances.data());
+
+            for (uint64_t i = 0; i < PrimitiveCount; ++i)
+            {
+                float distance = 0.0f;
+                bool isHit = Geometry::Collision::RayTriangle(ray, scene.TriangleList[i], distance);
+                bool isMismatch = isHit != bool(hits[i]) || (isHit && std::abs(distance - distances[i]) > 1e-3f * std::max(distance, 1.0f));
+
+                PF_CHECK(!isMismatch || IsNearTriangleEdge(ray, scene.TriangleList[i]));
+                hitCount += isHit;
+            }
+        }
+    });
+
+    // Rays are aimed at the middle of the scene, so some of them have to hit something
+    PF_CHECK(hitCount > 0);
+}
+
+PF_TEST(CollisionKernels_InstructionSetsAgreeExactly)
+{
+    // Kernels issue the same operations for every width, so results match bit for bit, including near triangle edges
+    Scene scene = MakeScene();
+    std::vector<uint8_t> hits(PrimitiveCount);
+    std::vector<float> distances(PrimitiveCount);
+    std::vector<std::vector<uint8_t>> scalarHits(QueryCount * 3);
+    std::vector<std::vector<float>> scalarDistances(QueryCount * 2);
+    std::vector<Kernels::AABBSoA> scalarTransformedBoxes(QueryCount);
+    Kernels::AABBSoA transformedBoxes;
+
+    auto compare = [](auto& scalar, const auto& values, bool isScalar)
+    {
+        if (isScalar)
+            scalar = values;
+        else
+            PF_CHECK(std::equal(values.begin(), values.end(), scalar.begin()));
+    };
+
+    ForEachInstructionSet([&](Kernels::InstructionSet set)
+    {
+        bool isScalar = set == Kernels::InstructionSet::Scalar;
+
+        for (uint64_t query = 0; query < QueryCount; ++query)
+        {
+            Kernels::RayAABBs(scene.Rays[query], scene.Boxes, hits.data(), distances.data());
+            compare(scalarHits[query * 3], hits, isScalar);
+            compare(scalarDistances[query * 2], distances, isScalar);
+
+            Kernels::RayTriangles(scene.Rays[query], scene.Triangles, hits.data(), distances.data());
+            compare(scalarHits[query * 3 + 1], hits, isScalar);
+
+            // Distances of missed triangles are unspecified
+            for (uint64_t i = 0; i < PrimitiveCount; ++i)
+                distances[i] = hits[i] ? distances[i] : 0.0f;
+
+            compare(scalarDistances[query * 2 + 1], distances, isScalar);
+
+            Kernels::FrustumAABBs(Kernels::ExtractFrustumPlanes(scene.ViewProjections[query]), scene.Boxes, hits.data());
+            compare(scalarHits[query * 3 + 2], hits, isScalar);
+
+            Kernels::TransformAABBs(scene.Transforms[query], scene.Boxes, transformedBoxes);
+            Kernels::AABBSoA& scalarBoxes = scalarTransformedBoxes[query];
+            compare(scalarBoxes.MinX, transformedBoxes.MinX, isScalar);
+            compare(scalarBoxes.MinY, transformedBoxes.MinY, isScalar);
+            compare(scalarBoxes.MinZ, transformedBoxes.MinZ, isScalar);
+            compare(scalarBoxes.MaxX, transformedBoxes.MaxX, isScalar);
+            compare(scalarBoxes.MaxY, transformedBoxes.MaxY, isScalar);
+            compare(scalarBoxes.MaxZ, transformedBoxes.MaxZ, isScalar);
+        }
+    });
+}
+
+PF_TEST(CollisionKernels_FrustumAABBsMatchCornerTest)
+{
+    Scene scene = MakeScene();
+    std::vector<uint8_t> visible(PrimitiveCount);
+    uint64_t visibleCount = 0;
+
+    ForEachInstructionSet([&](Kernels::InstructionSet set)
+    {
+        for (const glm::mat4& viewProjection : scene.ViewProjections)
+        {
+            Kernels::FrustumPlanes planes = Kernels::ExtractFrustumPlanes(viewProjection);
+            Kernels::FrustumAABBs(planes, scene.Boxes, visible.data());
+
+            for (uint64_t i = 0; i < PrimitiveCount; ++i)
+            {
+                PF_CHECK(IsVisibleReference(planes, scene.BoxList[i]) == bool(visible[i]));
+                visibleCount += set == Kernels::InstructionSet::Scalar && visible[i];
+            }
+        }
+    });
+
+    // Neither everything nor nothing is culled
+    PF_CHECK(visibleCount > 0 && visibleCount < PrimitiveCount * QueryCount);
+}
+
+PF_TEST(CollisionKernels_TransformAABBsMatchTransformedCorners)
+{
+    Scene scene = MakeScene();
+    Kernels::AABBSoA transformedBoxes;
+
+    ForEachInstructionSet([&](Kernels::InstructionSet)
+    {
+        for (const glm::mat4& transform : scene.Transforms)
+        {
+            Kernels::TransformAABBs(transform, scene.Boxes, transformedBoxes);
+            PF_CHECK(transformedBoxes.Size() == PrimitiveCount);
+
+            for (uint64_t i = 0; i < PrimitiveCount; ++i)
+            {
+                AABB reference = TransformReference(transform, scene.BoxList[i]);
+                AABB box = transformedBoxes.Get(i);
+                float tolerance = 1e-4f * std::max(reference.LargestDimensionLength(), glm::length(reference.Сenter()));
+                float error = std::max(glm::length(box.GetMin() - reference.GetMin()), glm::length(box.GetMax() - reference.GetMax()));
+                PF_CHECK(error <= tolerance);
+            }
+        }
+    });
+}
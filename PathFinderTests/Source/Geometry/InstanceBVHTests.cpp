@@ -0,0 +1,233 @@
+#include "../TestRunner.hpp"
+
+#include <Geometry/InstanceBVH.hpp>
+
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_inverse.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <random>
+#include <optional>
+#include <algorithm>
+
+namespace
+{
+
+    struct Scene
+    {
+        std::vector<std::vector<glm::vec3>> MeshPositions;
+        std::vector<std::vector<uint32_t>> MeshIndices;
+        std::vector<Geometry::TriangleBVH> Hierarchies;
+        std::vector<glm::mat4> Transforms;
+    };
+
+    Scene MakeScene(std::mt19937& generator, uint32_t meshCount, uint32_t trianglesPerMesh, uint32_t instanceCount)
+    {
+        std::uniform_real_distribution<float> unit{ 0.0f, 1.0f };
+        Scene scene;
+
+        for (uint32_t meshIdx = 0; meshIdx < meshCount; ++meshIdx)
+        {
+            std::vector<glm::vec3>& positions = scene.MeshPositions.emplace_back();
+            std::vector<uint32_t>& indices = scene.MeshIndices.emplace_back();
+
+            for (uint32_t triangle = 0; triangle < trianglesPerMesh; ++triangle)
+            {
+                glm::vec3 center = glm::vec3{ unit(generator), unit(generator), unit(generator) } * 2.0f - 1.0f;
+
+                for (uint32_t vertex = 0; vertex < 3; ++vertex)
+                {
+                    indices.push_back(positions.size());
+                    positions.push_back(center + (glm::vec3{ unit(generator), unit(generator), unit(generator) } - 0.5f) * 0.3f);
+                }
+            }
+        }
+
+        for (uint32_t meshIdx = 0; meshIdx < meshCount; ++meshIdx)
+        {
+            scene.Hierarchies.emplace_back(scene.MeshPositions[meshIdx], scene.MeshIndices[meshIdx]);
+        }
+
+        for (uint32_t instanceIdx = 0; instanceIdx < instanceCount; ++instanceIdx)
+        {
+            glm::vec3 position = (glm::vec3{ unit(generator), unit(generator), unit(generator) } - 0.5f) * 10.0f;
+            glm::vec3 axis = glm::normalize(glm::vec3{ unit(generator), unit(generator), unit(generator) } + 0.01f);
+            float scale = 0.5f + unit(generator) * 2.0f;
+
+            scene.Transforms.push_back(
+                glm::translate(glm::mat4{ 1.0f }, position) * 
+                glm::rotate(glm::mat4{ 1.0f }, unit(generator) * 6.2831853f, axis) * 
+                glm::scale(glm::mat4{ 1.0f }, glm::vec3{ scale }));
+        }
+
+        return scene;
+    }
+
+    void BuildInstances(Geometry::InstanceBVH& bvh, const Scene& scene)
+    {
+        bvh.Clear();
+
+        for (uint64_t instanceIdx = 0; instanceIdx < scene.Transforms.size(); ++instanceIdx)
+        {
+            bvh.AddInstance(&scene.Hierarchies[instanceIdx % scene.Hierarchies.size()], scene.Transforms[instanceIdx]);
+        }
+
+        bvh.Build();
+    }
+
+    // Every triangle of every instance, intersected in world space
+    std::optional<float> BruteForceClosestHit(const Scene& scene, const Geometry::Ray3D& ray, bool cullBackFaces)
+    {
+        std::optional<float> closestDistance;
+
+        for (uint64_t instanceIdx = 0; instanceIdx < scene.Transforms.size(); ++instanceIdx)
+        {
+            uint64_t meshIdx = instanceIdx % scene.MeshPositions.size();
+            const std::vector<glm::vec3>& positions = scene.MeshPositions[meshIdx];
+            const std::vector<uint32_t>& indices = scene.MeshIndices[meshIdx];
+            const glm::mat4& transform = scene.Transforms[instanceIdx];
+
+            for (uint64_t index = 0; index < indices.size(); index += 3)
+            {
+                glm::vec3 a = transform * glm::vec4{ positions[indices[index]], 1.0f };
+                glm::vec3 b = transform * glm::vec4{ positions[indices[index + 1]], 1.0f };
+                glm::vec3 c = transform * glm::vec4{ positions[indices[index + 2]], 1.0f };
+
+                glm::vec3 edgeAB = b - a;
+                glm::vec3 edgeAC = c - a;
+                glm::vec3 p = glm::cross(ray.direction, edgeAC);
+                float determinant = glm::dot(edgeAB, p);
+
+                if (cullBackFaces ? determinant >= 0.0f : determinant == 0.0f)
+                    continue;
+
+                glm::vec3 t = ray.origin - a;
+                float u = glm::dot(t, p) / determinant;
+                glm::vec3 q = glm::cross(t, edgeAB);
+                float v = glm::dot(ray.direction, q) / determinant;
+                float distance = glm::dot(edgeAC, q) / determinant;
+
+                if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && distance >= 0.0f && (!closestDistance || distance < *closestDistance))
+                {
+                    closestDistance = distance;
+                }
+            }
+        }
+
+        return closestDistance;
+    }
+
+    // Rays grazing triangle edges can legitimately disagree between world and object space arithmetic
+    bool DistancesMatch(float a, float b)
+    {
+        return std::abs(a - b) <= 1e-3f * std::max(std::abs(b), 1.0f);
+    }
+
+    void CheckAgainstBruteForce(const Geometry::InstanceBVH& bvh, const Scene& scene, std::mt19937& generator, uint64_t& comparedHitCount, uint64_t& mismatchCount)
+    {
+        std::uniform_real_distribution<float> unit{ 0.0f, 1.0f };
+
+        for (uint32_t rayIdx = 0; rayIdx < 512; ++rayIdx)
+        {
+            glm::vec3 origin = (glm::vec3{ unit(generator), unit(generator), unit(generator) } - 0.5f) * 14.0f;
+            glm::vec3 direction = glm::vec3{ unit(generator), unit(generator), unit(generator) } - 0.5f + glm::vec3{ 0.0f, 0.0f, 1e-4f };
+            Geometry::Ray3D ray{ origin, direction };
+            bool cullBackFaces = rayIdx % 2 == 1;
+
+            std::optional<float> reference = BruteForceClosestHit(scene, ray, cullBackFaces);
+            std::optional<Geometry::InstanceBVH::Hit> hit = bvh.ClosestHit(ray, 0.0f, std::numeric_limits<float>::max(), cullBackFaces);
+
+            bool closestHitMatches = reference.has_value() == hit.has_value() && (!hit || DistancesMatch(hit->Distance, *reference));
+            bool anyHitMatches = bvh.AnyHit(ray, 0.0f, std::numeric_limits<float>::max(), cullBackFaces) == reference.has_value();
+
+            mismatchCount += !closestHitMatches || !anyHitMatches;
+            comparedHitCount += hit.has_value();
+        }
+    }
+
+}
+
+PF_TEST(InstanceBVH_MatchesBruteForceAfterBuild)
+{
+    std::mt19937 generator{ 17 };
+    Scene scene = MakeScene(generator, 3, 200, 24);
+    Geometry::InstanceBVH bvh;
+    BuildInstances(bvh, scene);
+
+    uint64_t comparedHitCount = 0;
+    uint64_t mismatchCount = 0;
+    CheckAgainstBruteForce(bvh, scene, generator, comparedHitCount, mismatchCount);
+
+    PF_CHECK(bvh.InstanceCount() == scene.Transforms.size());
+    PF_CHECK(comparedHitCount > 0);
+    PF_CHECK(mismatchCount == 0);
+}
+
+PF_TEST(InstanceBVH_MatchesBruteForceAfterRefit)
+{
+    std::mt19937 generator{ 29 };
+    Scene scene = MakeScene(generator, 3, 200, 24);
+    Geometry::InstanceBVH bvh;
+    BuildInstances(bvh, scene);
+
+    uint64_t comparedHitCount = 0;
+    uint64_t mismatchCount = 0;
+    bool wasRefit = false;
+
+    for (uint32_t frame = 0; frame < 4; ++frame)
+    {
+        // Same hierarchies in the same order, so the tree is refitted to moved instances
+        for (uint64_t instanceIdx = 0; instanceIdx < scene.Transforms.size(); ++instanceIdx)
+        {
+            float phase = float(instanceIdx % 7) + frame * 0.5f;
+            scene.Transforms[instanceIdx] = glm::translate(glm::mat4{ 1.0f }, glm::vec3{ std::sin(phase), 0.0f, std::cos(phase) } * 0.3f) * scene.Transforms[instanceIdx];
+        }
+
+        BuildInstances(bvh, scene);
+        wasRefit |= bvh.WasRefit();
+
+        CheckAgainstBruteForce(bvh, scene, generator, comparedHitCount, mismatchCount);
+    }
+
+    PF_CHECK(wasRefit);
+    PF_CHECK(comparedHitCount > 0);
+    PF_CHECK(mismatchCount == 0);
+}
+
+PF_TEST(InstanceBVH_RangeLimitedQueriesAgree)
+{
+    std::mt19937 generator{ 41 };
+    Scene scene = MakeScene(generator, 2, 150, 16);
+    Geometry::InstanceBVH bvh;
+    BuildInstances(bvh, scene);
+
+    std::uniform_real_distribution<float> unit{ 0.0f, 1.0f };
+    uint64_t checkedHitCount = 0;
+
+    for (uint32_t rayIdx = 0; rayIdx < 512; ++rayIdx)
+    {
+        Geometry::Ray3D ray{ (glm::vec3{ unit(generator), unit(generator), unit(generator) } - 0.5f) * 14.0f, glm::vec3{ unit(generator), unit(generator), unit(generator) } - 0.5f };
+        std::optional<Geometry::InstanceBVH::Hit> hit = bvh.ClosestHit(ray);
+
+        if (!hit)
+            continue;
+
+        ++checkedHitCount;
+
+        PF_CHECK(bvh.AnyHit(ray, 0.0f, hit->Distance * 1.001f));
+        PF_CHECK(bvh.AnyHit(ray, 0.0f, hit->Distance * 0.999f) == bvh.ClosestHit(ray, 0.0f, hit->Distance * 0.999f).has_value());
+    }
+
+    PF_CHECK(checkedHitCount > 0);
+}
+
+PF_TEST(InstanceBVH_EmptySceneHasNoHits)
+{
+    Geometry::InstanceBVH bvh;
+    bvh.Build();
+
+    Geometry::Ray3D ray{ glm::vec3{ 0.0f }, glm::vec3{ 0.0f, 0.0f, 1.0f } };
+
+    PF_CHECK(!bvh.ClosestHit(ray).has_value());
+    PF_CHECK(!bvh.AnyHit(ray));
+}
@@ -0,0 +1,211 @@
+#include "../TestRunner.hpp"
+
+#include <Memory/CompactingRangeAllocator.hpp>
+
+#include <random>
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+
+    // Stand-in for buffer contents: every element holds the owner of the range it belongs to
+    class MirroredBuffer
+    {
+    public:
+        void Fill(const Memory::CompactingRangeAllocator::Range& range, uint64_t owner)
+        {
+            Resize(range.Offset + range.Size);
+            std::fill(mElements.begin() + range.Offset, mElements.begin() + range.Offset + range.Size, owner);
+        }
+
+        void Apply(const std::vector<Memory::CompactingRangeAllocator::Move>& moves)
+        {
+            for (const Memory::CompactingRangeAllocator::Move& move : moves)
+            {
+                Resize(move.Offset + move.Size);
+                std::copy(mElements.begin() + move.PreviousOffset, mElements.begin() + move.PreviousOffset + move.Size, mElements.begin() + move.Offset);
+            }
+        }
+
+        bool Holds(const Memory::CompactingRangeAllocator::Range& range, uint64_t owner) const
+        {
+            return range.Offset + range.Size <= mElements.size() && 
+                std::all_of(mElements.begin() + range.Offset, mElements.begin() + range.Offset + range.Size, [owner](uint64_t element) { return element == owner; });
+        }
+
+    private:
+        void Resize(uint64_t size)
+        {
+            if (mElements.size() < size)
+                mElements.resize(size, std::numeric_limits<uint64_t>::max());
+        }
+
+        std::vector<uint64_t> mElements;
+    };
+
+    bool RangesAreDisjoint(const Memory::CompactingRangeAllocator& allocator, const std::vector<uint64_t>& owners)
+    {
+        std::vector<Memory::CompactingRangeAllocator::Range> ranges;
+
+        for (uint64_t owner : owners)
+            ranges.push_back(*allocator.Find(owner));
+
+        std::sort(ranges.begin(), ranges.end(), [](const auto& a, const auto& b) { return a.Offset < b.Offset; });
+
+        for (uint64_t i = 1; i < ranges.size(); ++i)
+        {
+            if (ranges[i - 1].Offset + ranges[i - 1].Size > ranges[i].Offset)
+                return false;
+        }
+
+        return ranges.empty() || ranges.back().Offset + ranges.back().Size <= allocator.Capacity();
+    }
+
+}
+
+PF_TEST(CompactingRangeAllocator_GrowthKeepsExistingRanges)
+{
+    Memory::CompactingRangeAllocator allocator{ 64 };
+    std::vector<uint64_t> owners;
+
+    for (uint64_t owner = 0; owner < 20; ++owner)
+    {
+        allocator.Allocate(owner, 16 + owner);
+        owners.push_back(owner);
+    }
+
+    std::vector<Memory::CompactingRangeAllocator::Range> rangesBeforeGrowth;
+
+    for (uint64_t owner : owners)
+        rangesBeforeGrowth.push_back(*allocator.Find(owner));
+
+    allocator.Allocate(100, 4096);
+
+    for (uint64_t i = 0; i < owners.size(); ++i)
+    {
+        PF_CHECK(allocator.Find(owners[i])->Offset == rangesBeforeGrowth[i].Offset);
+        PF_CHECK(allocator.Find(owners[i])->Size == rangesBeforeGrowth[i].Size);
+    }
+
+    owners.push_back(100);
+
+    PF_CHECK(allocator.Capacity() >= allocator.AllocatedSize());
+    PF_CHECK(RangesAreDisjoint(allocator, owners));
+}
+
+PF_TEST(CompactingRangeAllocator_MovesKeepContentsIntact)
+{
+    std::mt19937 generator{ 7 };
+    std::uniform_int_distribution<uint64_t> sizeDistribution{ 1, 300 };
+
+    Memory::CompactingRangeAllocator allocator{ 1024 };
+    MirroredBuffer buffer;
+    std::vector<uint64_t> owners;
+    uint64_t nextOwner = 0;
+    bool movesGoDown = true;
+    bool contentsAreIntact = true;
+    bool rangesAreDisjoint = true;
+
+    for (uint32_t step = 0; step < 400; ++step)
+    {
+        // Mostly adds early on, mostly removes later, so holes keep appearing in the middle
+        bool shouldRemove = !owners.empty() && generator() % 100 < (step < 200 ? 35u : 65u);
+
+        if (shouldRemove)
+        {
+            uint64_t index = generator() % owners.size();
+            allocator.Deallocate(owners[index]);
+            owners.erase(owners.begin() + index);
+        }
+        else
+        {
+            uint64_t owner = nextOwner++;
+            allocator.Allocate(owner, sizeDistribution(generator));
+            buffer.Fill(*allocator.Find(owner), owner);
+            owners.push_back(owner);
+        }
+
+        std::vector<Memory::CompactingRangeAllocator::Move> moves = allocator.Compact(512);
+        buffer.Apply(moves);
+
+        for (const Memory::CompactingRangeAllocator::Move& move : moves)
+        {
+            movesGoDown &= move.Offset < move.PreviousOffset;
+            movesGoDown &= allocator.Find(move.Owner)->Offset == move.Offset;
+        }
+
+        for (uint64_t owner : owners)
+            contentsAreIntact &= buffer.Holds(*allocator.Find(owner), owner);
+
+        rangesAreDisjoint &= RangesAreDisjoint(allocator, owners);
+    }
+
+    PF_CHECK(movesGoDown);
+    PF_CHECK(contentsAreIntact);
+    PF_CHECK(rangesAreDisjoint);
+    PF_CHECK(allocator.OwnerCount() == owners.size());
+}
+
+PF_TEST(CompactingRangeAllocator_CompactionClosesAllHoles)
+{
+    Memory::CompactingRangeAllocator allocator{ 256 };
+    MirroredBuffer buffer;
+    std::vector<uint64_t> owners;
+
+    for (uint64_t owner = 0; owner < 64; ++owner)
+    {
+        allocator.Allocate(owner, 8);
+        buffer.Fill(*allocator.Find(owner), owner);
+        owners.push_back(owner);
+    }
+
+    // Free every other range, leaving equally sized holes behind
+    for (uint64_t owner = 0; owner < 64; owner += 2)
+    {
+        allocator.Deallocate(owner);
+        owners.erase(std::find(owners.begin(), owners.end(), owner));
+    }
+
+    PF_CHECK(allocator.AllocatedExtent() > allocator.AllocatedSize());
+
+    // Small budget spreads compaction over several steps
+    uint32_t stepCount = 0;
+
+    for (std::vector<Memory::CompactingRangeAllocator::Move> moves = allocator.Compact(32); !moves.empty(); moves = allocator.Compact(32))
+    {
+        uint64_t movedSize = 0;
+
+        for (const Memory::CompactingRangeAllocator::Move& move : moves)
+            movedSize += move.Size;
+
+        PF_CHECK(movedSize <= 32);
+
+        buffer.Apply(moves);
+        ++stepCount;
+    }
+
+    PF_CHECK(stepCount > 1);
+    PF_CHECK(allocator.AllocatedExtent() == allocator.AllocatedSize());
+
+    for (uint64_t owner : owners)
+        PF_CHECK(buffer.Holds(*allocator.Find(owner), owner));
+}
+
+PF_TEST(CompactingRangeAllocator_DeallocatedOwnersAreForgotten)
+{
+    Memory::CompactingRangeAllocator allocator{ 128 };
+    allocator.Allocate(1, 32);
+    allocator.Allocate(2, 32);
+    allocator.Deallocate(1);
+
+    PF_CHECK(!allocator.Contains(1));
+    PF_CHECK(!allocator.Find(1).has_value());
+    PF_CHECK(allocator.Contains(2));
+    PF_CHECK(allocator.AllocatedSize() == 32);
+
+    allocator.Clear();
+
+    PF_CHECK(allocator.OwnerCount() == 0);
+    PF_CHECK(allocator.AllocatedSize() == 0);
+}
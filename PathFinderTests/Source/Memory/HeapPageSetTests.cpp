@@ -0,0 +1,265 @@
+#include "../TestRunner.hpp"
+
+#include <Memory/HeapPageSet.hpp>
+
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+    using Pages = Memory::HeapPageSet<uint64_t>;
+
+    const uint64_t KB = 1024;
+    const uint64_t MB = 1024 * KB;
+    const uint64_t Alignment = 64 * KB;
+
+    // Thresholds of ResourceDefragmenter scaled down with the page size
+    const float SparsePageUtilization = 0.25f;
+    const uint64_t FrameRelocationByteBudget = 2 * MB;
+    const uint64_t AbandonedEvacuationCooldownFrameCount = 300;
+
+    struct LiveAllocation
+    {
+        Pages::Allocation Allocation;
+        uint64_t ReleaseFrame = 0;
+        bool CanBeRelocated = true;
+    };
+
+    struct SessionResult
+    {
+        uint64_t PeakCapacityBytes = 0;
+        uint64_t PeakLiveBytes = 0;
+        uint64_t ReleasedPageCount = 0;
+        uint64_t RelocationCount = 0;
+        Memory::HeapPageFragmentationMetrics FinalMetrics;
+        bool IsPlacementValid = true;
+    };
+
+    Pages::Allocation Allocate(Pages& pages, uint64_t size, uint64_t& nextPageId)
+    {
+        if (std::optional<Pages::Allocation> allocation = pages.Allocate(size, Alignment))
+            return *allocation;
+
+        Pages::Page& page = pages.AddPage(pages.NewPageSize(size, Alignment), uint64_t{ nextPageId++ });
+        return Pages::Allocation{ &page, *page.Ranges.Allocate(size, Alignment), size };
+    }
+
+    // Allocations of a page must stay inside of it, never overlap and add up to what the page reports
+    bool ArePlacementsValid(const Pages& pages, const std::vector<LiveAllocation>& liveAllocations)
+    {
+        for (const std::unique_ptr<Pages::Page>& page : pages.Pages())
+        {
+            std::vector<Pages::Allocation> pageAllocations;
+            uint64_t allocatedSize = 0;
+
+            for (const LiveAllocation& live : liveAllocations)
+            {
+                if (live.Allocation.Page == page.get())
+                    pageAllocations.push_back(live.Allocation);
+            }
+
+            std::sort(pageAllocations.begin(), pageAllocations.end(), [](const Pages::Allocation& a, const Pages::Allocation& b) { return a.Offset < b.Offset; });
+
+            for (auto allocationIdx = 0u; allocationIdx < pageAllocations.size(); ++allocationIdx)
+            {
+                const Pages::Allocation& allocation = pageAllocations[allocationIdx];
+                uint64_t end = allocation.Offset + allocation.Size;
+
+                if (allocation.Offset % Alignment != 0 || end > page->Ranges.Capacity())
+                    return false;
+
+                if (allocationIdx + 1 < pageAllocations.size() && end > pageAllocations[allocationIdx + 1].Offset)
+                    return false;
+
+                allocatedSize += allocation.Size;
+            }
+
+            if (allocatedSize != page->Ranges.AllocatedSize())
+                return false;
+        }
+
+        return true;
+    }
+
+    // Replays an editing session like ResourceDefragmenter's benchmark does: log-uniform lifetimes,
+    // a few resources pinned in place, one page evacuated at a time within a per frame relocation budget.
+    // Allocations stop after the first two thirds of the session, leaving long lived ones scattered across pages.
+    SessionResult RunSession(bool defragment, uint64_t frameCount)
+    {
+        Pages pages{ 4 * MB, 16 * MB };
+        std::vector<LiveAllocation> liveAllocations;
+        SessionResult result;
+        uint64_t nextPageId = 0;
+        uint64_t nextEvacuationFrame = 0;
+        uint64_t liveBytes = 0;
+
+        std::mt19937 randomEngine{ 1337 };
+        std::uniform_real_distribution<double> logLifetimeDistribution{ std::log(16.0), std::log(6000.0) };
+        std::uniform_int_distribution<uint64_t> sizeDistribution{ 1, 16 };
+        std::uniform_real_distribution<double> unitDistribution{ 0.0, 1.0 };
+
+        for (uint64_t frame = 1; frame <= frameCount; ++frame)
+        {
+            if (defragment)
+            {
+                if (!pages.IsEvacuationInProgress() && frame >= nextEvacuationFrame)
+                {
+                    if (Pages::Page* page = pages.FindEvacuationCandidate(SparsePageUtilization))
+                        page->IsEvacuating = true;
+                }
+
+                uint64_t relocatedBytes = 0;
+
+                for (LiveAllocation& live : liveAllocations)
+                {
+                    if (!live.Allocation.Page->IsEvacuating)
+                        continue;
+
+                    if (!live.CanBeRelocated || (relocatedBytes > 0 && relocatedBytes + live.Allocation.Size > FrameRelocationByteBudget))
+                    {
+                        if (!live.CanBeRelocated)
+                        {
+                            pages.AbandonEvacuations();
+                            nextEvacuationFrame = frame + AbandonedEvacuationCooldownFrameCount;
+                        }
+
+                        break;
+                    }
+
+                    std::optional<Pages::Allocation> target = pages.Allocate(live.Allocation.Size, Alignment);
+
+                    if (!target)
+                    {
+                        pages.AbandonEvacuations();
+                        nextEvacuationFrame = frame + AbandonedEvacuationCooldownFrameCount;
+                        break;
+                    }
+
+                    // Target can't land in the page being emptied
+                    result.IsPlacementValid = result.IsPlacementValid && !target->Page->IsEvacuating;
+
+                    pages.Deallocate(live.Allocation);
+                    live.Allocation = *target;
+                    relocatedBytes += target->Size;
+                    ++result.RelocationCount;
+                }
+            }
+
+            auto releasedIt = std::stable_partition(liveAllocations.begin(), liveAllocations.end(), [frame](const LiveAllocation& live) { return live.ReleaseFrame > frame; });
+
+            for (auto it = releasedIt; it != liveAllocations.end(); ++it)
+            {
+                pages.Deallocate(it->Allocation);
+                liveBytes -= it->Allocation.Size;
+            }
+
+            liveAllocations.erase(releasedIt, liveAllocations.end());
+
+            if (frame <= frameCount * 2 / 3)
+            {
+                LiveAllocation live;
+                live.Allocation = Allocate(pages, sizeDistribution(randomEngine) * Alignment, nextPageId);
+                live.ReleaseFrame = frame + static_cast<uint64_t>(std::exp(logLifetimeDistribution(randomEngine)));
+                live.CanBeRelocated = unitDistribution(randomEngine) > 0.02;
+                liveAllocations.push_back(live);
+                liveBytes += live.Allocation.Size;
+            }
+
+            result.ReleasedPageCount += pages.ReleaseEvacuatedPages();
+
+            // Owner releases idle pages, as the resource allocator does once they exceed its idle memory budget
+            Pages::PageList& pageList = pages.Pages();
+            pageList.erase(std::remove_if(pageList.begin(), pageList.end(), [](const std::unique_ptr<Pages::Page>& page) { return page->Ranges.IsEmpty(); }), pageList.end());
+
+            Memory::HeapPageFragmentationMetrics metrics;
+            pages.AccumulateFragmentationMetrics(SparsePageUtilization, metrics);
+            result.PeakCapacityBytes = std::max(result.PeakCapacityBytes, metrics.CapacityBytes);
+            result.PeakLiveBytes = std::max(result.PeakLiveBytes, liveBytes);
+
+            if (frame % 250 == 0)
+                result.IsPlacementValid = result.IsPlacementValid && ArePlacementsValid(pages, liveAllocations);
+        }
+
+        pages.AccumulateFragmentationMetrics(SparsePageUtilization, result.FinalMetrics);
+
+        return result;
+    }
+
+}
+
+PF_TEST(HeapPageSet_EvacuatingPageTakesNoAllocations)
+{
+    Pages pages{ 4 * MB, 16 * MB };
+    uint64_t nextPageId = 0;
+
+    Pages::Allocation first = Allocate(pages, 1 * MB, nextPageId);
+    first.Page->IsEvacuating = true;
+
+    Pages::Allocation second = Allocate(pages, 1 * MB, nextPageId);
+
+    PF_CHECK(second.Page != first.Page);
+    PF_CHECK(pages.Pages().size() == 2);
+    PF_CHECK(pages.IsEvacuationInProgress());
+
+    // Evacuating page is released only once emptied
+    PF_CHECK(pages.ReleaseEvacuatedPages() == 0);
+    pages.Deallocate(first);
+    PF_CHECK(pages.ReleaseEvacuatedPages() == 1);
+    PF_CHECK(pages.Pages().size() == 1);
+    PF_CHECK(!pages.IsEvacuationInProgress());
+}
+
+PF_TEST(HeapPageSet_EvacuatesSparsestPageThatFitsElsewhere)
+{
+    Pages pages{ 4 * MB, 16 * MB };
+
+    Pages::Page& full = pages.AddPage(4 * MB, uint64_t{ 0 });
+    Pages::Page& sparse = pages.AddPage(4 * MB, uint64_t{ 1 });
+    Pages::Page& sparsest = pages.AddPage(4 * MB, uint64_t{ 2 });
+    pages.AddPage(4 * MB, uint64_t{ 3 });
+
+    full.Ranges.Allocate(4 * MB);
+    uint64_t sparseOffset = *sparse.Ranges.Allocate(768 * KB);
+    sparsest.Ranges.Allocate(256 * KB);
+
+    // Empty pages are left alone
+    PF_CHECK(pages.FindEvacuationCandidate(SparsePageUtilization) == &sparsest);
+    // Limit is exclusive
+    PF_CHECK(pages.FindEvacuationCandidate(0.0625) == nullptr);
+
+    // Pages are evacuated only while the rest of the set can take their allocations
+    pages.Pages().back()->Ranges.Allocate(4 * MB);
+    sparse.Ranges.Deallocate(sparseOffset, 768 * KB);
+    sparse.Ranges.Allocate(4 * MB - 256 * KB);
+
+    PF_CHECK(pages.FindEvacuationCandidate(SparsePageUtilization) == &sparsest);
+
+    sparse.Ranges.Allocate(64 * KB);
+
+    PF_CHECK(pages.FindEvacuationCandidate(SparsePageUtilization) == nullptr);
+}
+
+PF_TEST(HeapPageSet_DefragmentationKeepsPlacementsDisjointAndMemoryBounded)
+{
+    const uint64_t FrameCount = 9000;
+
+    SessionResult fragmented = RunSession(false, FrameCount);
+    SessionResult defragmented = RunSession(true, FrameCount);
+
+    PF_CHECK(fragmented.IsPlacementValid);
+    PF_CHECK(defragmented.IsPlacementValid);
+    PF_CHECK(defragmented.RelocationCount > 0);
+    PF_CHECK(defragmented.ReleasedPageCount > 0);
+
+    // Page growth keeps committed memory close to what is actually used
+    PF_CHECK(defragmented.PeakCapacityBytes <= fragmented.PeakCapacityBytes);
+    PF_CHECK(defragmented.PeakCapacityBytes < 2 * defragmented.PeakLiveBytes);
+
+    // Survivors of the session pin pages unless they're moved out
+    PF_CHECK(defragmented.FinalMetrics.CapacityBytes < fragmented.FinalMetrics.CapacityBytes);
+    PF_CHECK(defragmented.FinalMetrics.SparsePageCount < fragmented.FinalMetrics.SparsePageCount);
+    PF_CHECK(defragmented.FinalMetrics.Utilization > fragmented.FinalMetrics.Utilization);
+}
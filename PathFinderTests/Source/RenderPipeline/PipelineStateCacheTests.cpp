@@ -0,0 +1,74 @@
+#include "../TestRunner.hpp"
+
+#include <RenderPipeline/PipelineStateCache.hpp>
+
+#include <filesystem>
+
+namespace
+{
+
+    using Cache = PathFinder::PipelineStateCache;
+
+    std::vector<uint8_t> Blob(uint8_t value)
+    {
+        return std::vector<uint8_t>(16, value);
+    }
+
+}
+
+PF_TEST(PipelineStateCache_NewKeyEvictsPreviousBlobOfState)
+{
+    Cache cache;
+
+    cache.Store(1, 100, Blob(1));
+    cache.Store(2, 200, Blob(2));
+    // First state recompiled with an edited shader
+    cache.Store(3, 100, Blob(3));
+
+    PF_CHECK(!cache.Find(1));
+    PF_CHECK(cache.Find(2) == Blob(2));
+    PF_CHECK(cache.Find(3) == Blob(3));
+}
+
+PF_TEST(PipelineStateCache_SharedKeyOutlivesOtherStates)
+{
+    Cache cache;
+
+    // Identical states produce the same key
+    cache.Store(1, 100, Blob(1));
+    cache.Store(1, 200, Blob(1));
+    cache.Store(2, 100, Blob(2));
+
+    PF_CHECK(cache.Find(1) == Blob(1));
+
+    cache.Store(3, 200, Blob(3));
+
+    PF_CHECK(!cache.Find(1));
+}
+
+PF_TEST(PipelineStateCache_EvictsBlobsStoredInEarlierRuns)
+{
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "PipelineStateCacheTests.pfpso";
+
+    {
+        Cache cache;
+        cache.Store(1, 100, Blob(1));
+        cache.Store(2, 200, Blob(2));
+        PF_CHECK(cache.Save(path));
+    }
+
+    Cache cache;
+    PF_CHECK(cache.Load(path));
+    PF_CHECK(!cache.IsDirty());
+
+    cache.Store(3, 100, Blob(3));
+    PF_CHECK(cache.Save(path));
+
+    Cache reloaded;
+    PF_CHECK(reloaded.Load(path));
+    PF_CHECK(!reloaded.Find(1));
+    PF_CHECK(reloaded.Find(2) == Blob(2));
+    PF_CHECK(reloaded.Find(3) == Blob(3));
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,193 @@
+#include "../TestRunner.hpp"
+
+#include <RenderPipeline/QueueAssignmentOptimizer.hpp>
+
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+
+    using Optimizer = PathFinder::QueueAssignmentOptimizer;
+    using Analyzer = PathFinder::RenderPassGraphAnalyzer;
+
+    const uint64_t GraphicsQueue = 0;
+    const uint64_t AsyncComputeQueue = 1;
+    const float SyncCost = 50e-6f;
+
+    Analyzer::PassRecord MakePass(float workDuration, bool isEligible, std::vector<uint64_t> dependencies)
+    {
+        Analyzer::PassRecord pass;
+        pass.Name = "Pass";
+        pass.WorkDuration = workDuration;
+        pass.IsAsyncComputeEligible = isEligible;
+        pass.QueueWorkDurations = { workDuration };
+        pass.Dependencies = std::move(dependencies);
+
+        // Async compute runs a little slower than the graphics queue
+        if (isEligible)
+            pass.QueueWorkDurations.push_back(workDuration * 1.2f);
+
+        return pass;
+    }
+
+    // Graph recorded with every pass on the graphics queue, the way it looks before the first optimization
+    Analyzer::GraphRecord MakeRecord(std::vector<Analyzer::PassRecord> passes)
+    {
+        Analyzer::GraphRecord record;
+        record.QueueCount = 2;
+        record.Passes = std::move(passes);
+
+        for (auto passIdx = 0u; passIdx < record.Passes.size(); ++passIdx)
+            record.Passes[passIdx].DependencyLevelIndex = passIdx;
+
+        Analyzer::ReassignQueues(record, std::vector<uint64_t>(record.Passes.size(), GraphicsQueue));
+        return record;
+    }
+
+    Analyzer::GraphRecord RandomRecord(uint64_t passCount, float eligibleProbability, uint32_t seed)
+    {
+        std::mt19937 generator{ seed };
+        std::uniform_real_distribution<float> durationDistribution{ 0.1e-3f, 2e-3f };
+        std::uniform_real_distribution<float> unitDistribution{ 0.0f, 1.0f };
+
+        std::vector<Analyzer::PassRecord> passes;
+
+        for (uint64_t passIdx = 0; passIdx < passCount; ++passIdx)
+        {
+            std::vector<uint64_t> dependencies;
+
+            for (uint64_t dependencyIdx = 0; dependencyIdx < passIdx; ++dependencyIdx)
+            {
+                // Mostly local dependencies leave room for passes to overlap
+                if (dependencyIdx + 3 >= passIdx && unitDistribution(generator) < 0.35f)
+                    dependencies.push_back(dependencyIdx);
+            }
+
+            passes.push_back(MakePass(durationDistribution(generator), unitDistribution(generator) < eligibleProbability, dependencies));
+        }
+
+        return MakeRecord(std::move(passes));
+    }
+
+    bool IsAssignmentValid(const Analyzer::GraphRecord& record, const Optimizer::Result& result)
+    {
+        if (result.PassQueueIndices.size() != record.Passes.size())
+            return false;
+
+        for (auto passIdx = 0u; passIdx < record.Passes.size(); ++passIdx)
+        {
+            uint64_t queueIndex = result.PassQueueIndices[passIdx];
+
+            bool isValid = record.Passes[passIdx].IsAsyncComputeEligible ?
+                queueIndex == GraphicsQueue || queueIndex == AsyncComputeQueue :
+                queueIndex == record.Passes[passIdx].QueueIndex;
+
+            if (!isValid)
+                return false;
+        }
+
+        return true;
+    }
+
+    float AnalyzedFrameDuration(const Analyzer::GraphRecord& record, const std::vector<uint64_t>& passQueueIndices)
+    {
+        Analyzer::GraphRecord reassigned = record;
+        Analyzer::ReassignQueues(reassigned, passQueueIndices);
+        return Analyzer::Analyze(reassigned, SyncCost).FrameDuration;
+    }
+
+}
+
+PF_TEST(QueueAssignmentOptimizer_MovesIndependentComputeToAsyncQueue)
+{
+    // Long graphics chain and a compute pass nothing waits for until the very end
+    Analyzer::GraphRecord record = MakeRecord({
+        MakePass(1e-3f, false, {}),
+        MakePass(2e-3f, true, {}),
+        MakePass(1e-3f, false, { 0 }),
+        MakePass(1e-3f, false, { 2 }),
+        MakePass(0.5e-3f, false, { 1, 3 })
+    });
+
+    Optimizer::Result result = Optimizer::Optimize(record, SyncCost);
+
+    PF_CHECK(IsAssignmentValid(record, result));
+    PF_CHECK(result.PassQueueIndices[1] == AsyncComputeQueue);
+    PF_CHECK(result.EstimatedFrameDuration < result.BaselineFrameDuration * 0.8f);
+    // Exhaustive search over a single eligible pass
+    PF_CHECK(result.EvaluatedAssignments == 3);
+}
+
+PF_TEST(QueueAssignmentOptimizer_KeepsBaselineWhenSyncIsTooCostly)
+{
+    Analyzer::GraphRecord record = MakeRecord({
+        MakePass(1e-3f, false, {}),
+        MakePass(0.2e-3f, true, {}),
+        MakePass(1e-3f, false, { 0 }),
+        MakePass(0.5e-3f, false, { 1, 2 })
+    });
+
+    Optimizer::Result result = Optimizer::Optimize(record, 5e-3f);
+
+    PF_CHECK(result.PassQueueIndices == std::vector<uint64_t>(record.Passes.size(), GraphicsQueue));
+    PF_CHECK(result.EstimatedFrameDuration == result.BaselineFrameDuration);
+}
+
+PF_TEST(QueueAssignmentOptimizer_NeverIncreasesMakespan)
+{
+    // Small graphs are searched exhaustively, large ones greedily
+    const uint64_t passCounts[]{ 6, 12, 24, 48 };
+
+    for (uint64_t passCount : passCounts)
+    {
+        for (uint32_t seed = 0; seed < 8; ++seed)
+        {
+            Analyzer::GraphRecord record = RandomRecord(passCount, 0.5f, seed * 31 + uint32_t(passCount));
+            Optimizer::Result result = Optimizer::Optimize(record, SyncCost);
+
+            float baseline = AnalyzedFrameDuration(record, std::vector<uint64_t>(record.Passes.size(), GraphicsQueue));
+            float optimized = AnalyzedFrameDuration(record, result.PassQueueIndices);
+
+            PF_CHECK(IsAssignmentValid(record, result));
+            PF_CHECK(std::abs(result.BaselineFrameDuration - baseline) <= 1e-4f * baseline);
+            PF_CHECK(result.EstimatedFrameDuration <= result.BaselineFrameDuration);
+            // Estimate of the search has to match a full analysis of the reassigned graph
+            PF_CHECK(std::abs(optimized - result.EstimatedFrameDuration) <= 1e-4f * baseline);
+            PF_CHECK(result.EvaluatedAssignments >= 1);
+        }
+    }
+}
+
+PF_TEST(QueueAssignmentOptimizer_ExhaustiveSearchFindsOptimum)
+{
+    for (uint32_t seed = 0; seed < 4; ++seed)
+    {
+        Analyzer::GraphRecord record = RandomRecord(10, 0.6f, 100 + seed);
+        Optimizer::Result result = Optimizer::Optimize(record, SyncCost);
+
+        std::vector<uint64_t> eligiblePasses;
+
+        for (auto passIdx = 0u; passIdx < record.Passes.size(); ++passIdx)
+        {
+            if (record.Passes[passIdx].IsAsyncComputeEligible)
+                eligiblePasses.push_back(passIdx);
+        }
+
+        float bestDuration = std::numeric_limits<float>::max();
+
+        for (uint64_t combination = 0; combination < (1ull << eligiblePasses.size()); ++combination)
+        {
+            std::vector<uint64_t> queues(record.Passes.size(), GraphicsQueue);
+
+            for (auto eligibleIdx = 0u; eligibleIdx < eligiblePasses.size(); ++eligibleIdx)
+                queues[eligiblePasses[eligibleIdx]] = (combination >> eligibleIdx) & 1 ? AsyncComputeQueue : GraphicsQueue;
+
+            bestDuration = std::min(bestDuration, AnalyzedFrameDuration(record, queues));
+        }
+
+        PF_CHECK(std::abs(result.EstimatedFrameDuration - bestDuration) <= 1e-4f * bestDuration);
+    }
+}
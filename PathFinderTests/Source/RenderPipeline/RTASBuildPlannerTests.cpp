@@ -0,0 +1,241 @@
+#include "../TestRunner.hpp"
+
+#include <RenderPipeline/RTASBuildPlanner.hpp>
+
+#include <random>
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+
+    using Planner = PathFinder::RTASBuildPlanner;
+
+    const uint64_t Unlimited = std::numeric_limits<uint64_t>::max();
+
+    uint64_t AlignedScratchSize(uint64_t size)
+    {
+        return (size + Planner::ScratchAlignment - 1) / Planner::ScratchAlignment * Planner::ScratchAlignment;
+    }
+
+    // Slices of one batch must be aligned, disjoint and inside the arena, batches must follow one another
+    bool AreSlicesValid(const Planner::FramePlan& plan, const std::vector<Planner::Build>& builds)
+    {
+        std::vector<std::pair<uint64_t, uint64_t>> batchSlices;
+        uint32_t batch = 0;
+
+        for (const Planner::ScheduledBuild& scheduled : plan.Builds)
+        {
+            auto buildIt = std::find_if(builds.begin(), builds.end(), [&](const Planner::Build& build) { return build.Key == scheduled.Key; });
+
+            if (buildIt == builds.end() || scheduled.ScratchOffset % Planner::ScratchAlignment != 0)
+                return false;
+
+            if (scheduled.Batch != batch)
+            {
+                if (scheduled.Batch != batch + 1)
+                    return false;
+
+                batch = scheduled.Batch;
+                batchSlices.clear();
+            }
+
+            uint64_t sliceEnd = scheduled.ScratchOffset + AlignedScratchSize(buildIt->ScratchSize);
+
+            if (sliceEnd > plan.Statistics.ScratchArenaSize)
+                return false;
+
+            for (const auto& [start, end] : batchSlices)
+            {
+                if (scheduled.ScratchOffset < end && start < sliceEnd)
+                    return false;
+            }
+
+            batchSlices.emplace_back(scheduled.ScratchOffset, sliceEnd);
+        }
+
+        return true;
+    }
+
+}
+
+PF_TEST(RTASBuildPlanner_SlicesOfBatchesDontOverlap)
+{
+    std::mt19937_64 generator{ 50 };
+    std::uniform_int_distribution<uint64_t> sizeDistribution{ 1, 3 << 20 };
+
+    Planner planner{ 8 << 20, Unlimited, Unlimited, 64 };
+
+    for (uint64_t frame = 0; frame < 20; ++frame)
+    {
+        std::vector<Planner::Build> builds;
+
+        for (uint64_t key = 0; key < 40; ++key)
+            builds.push_back({ key, frame + 1, sizeDistribution(generator), 1024, false });
+
+        Planner::FramePlan plan = planner.PlanFrame(frame, builds);
+
+        PF_CHECK(plan.Builds.size() == builds.size());
+        PF_CHECK(plan.Statistics.BatchCount > 1);
+        PF_CHECK(plan.Statistics.BatchCount == plan.Builds.back().Batch + 1);
+        PF_CHECK(AreSlicesValid(plan, builds));
+
+        // Builds keep their order
+        for (uint64_t buildIdx = 0; buildIdx < builds.size(); ++buildIdx)
+            PF_CHECK(plan.Builds[buildIdx].Key == builds[buildIdx].Key);
+    }
+}
+
+PF_TEST(RTASBuildPlanner_ArenaGrowsToLargestBuild)
+{
+    Planner planner{ 1024, Unlimited, Unlimited, 64 };
+
+    std::vector<Planner::Build> builds{ { 0, 1, 300, 1024, false }, { 1, 1, 5000, 1024, false }, { 2, 1, 100, 1024, false } };
+    Planner::FramePlan plan = planner.PlanFrame(0, builds);
+
+    PF_CHECK(planner.ScratchArenaSize() == AlignedScratchSize(5000));
+    PF_CHECK(plan.Statistics.ScratchArenaSize == planner.ScratchArenaSize());
+    PF_CHECK(AreSlicesValid(plan, builds));
+
+    // Arena never shrinks back
+    plan = planner.PlanFrame(1, { { 0, 2, 300, 1024, false } });
+
+    PF_CHECK(planner.ScratchArenaSize() == AlignedScratchSize(5000));
+    PF_CHECK(plan.Statistics.BatchCount == 1);
+}
+
+PF_TEST(RTASBuildPlanner_CompactsOnlyCurrentGenerations)
+{
+    Planner planner{ 1 << 20, Unlimited, Unlimited, 64 };
+
+    Planner::FramePlan plan = planner.PlanFrame(0, { { 0, 1, 1024, 4096, true }, { 1, 1, 1024, 4096, true }, { 2, 1, 1024, 4096, false } });
+
+    // Only structures that allow compaction get queried
+    PF_CHECK(plan.SizeQueries.size() == 2);
+    PF_CHECK(plan.SizeQueries[0].Key == 0 && plan.SizeQueries[1].Key == 1);
+
+    // Structure 1 is rebuilt before its compacted size arrives
+    planner.PlanFrame(1, { { 1, 2, 1024, 4096, true } });
+
+    uint64_t compactedSizes[]{ 1000, 1000 };
+    planner.ReportCompactedSizes(0, compactedSizes);
+
+    PF_CHECK(planner.PendingCompactionCount() == 1);
+
+    plan = planner.PlanFrame(2, {});
+
+    PF_CHECK(plan.Compactions.size() == 1);
+    PF_CHECK(plan.Compactions[0].Key == 0 && plan.Compactions[0].Generation == 1 && plan.Compactions[0].CompactedSize == 1000);
+    PF_CHECK(planner.TotalCompactionBytesSaved() == 4096 - 1000);
+
+    // Rebuild of a compacted structure gives its savings back
+    planner.PlanFrame(3, { { 0, 3, 1024, 4096, false } });
+
+    PF_CHECK(planner.TotalCompactionBytesSaved() == 0);
+}
+
+PF_TEST(RTASBuildPlanner_LostQueriesAreIssuedAgain)
+{
+    Planner planner{ 1 << 20, Unlimited, Unlimited, 64 };
+
+    planner.PlanFrame(0, { { 0, 1, 1024, 4096, true } });
+    planner.PlanFrame(1, { { 1, 1, 1024, 4096, true } });
+
+    // Readback of frame 0 never arrived, frame 1 completes
+    uint64_t compactedSizes[]{ 2048 };
+    planner.ReportCompactedSizes(1, compactedSizes);
+
+    PF_CHECK(planner.PendingSizeQueryCount() == 1);
+
+    Planner::FramePlan plan = planner.PlanFrame(2, {});
+
+    PF_CHECK(plan.SizeQueries.size() == 1 && plan.SizeQueries[0].Key == 0);
+    PF_CHECK(plan.Compactions.size() == 1 && plan.Compactions[0].Key == 1);
+}
+
+PF_TEST(RTASBuildPlanner_CompactionsStayWithinBudget)
+{
+    const uint64_t Budget = 10000;
+
+    Planner planner{ 1 << 20, Unlimited, Budget, 64 };
+
+    std::vector<Planner::Build> builds;
+
+    for (uint64_t key = 0; key < 10; ++key)
+        builds.push_back({ key, 1, 1024, 4000, true });
+
+    // Oversized structure still gets compacted, alone
+    builds.push_back({ 10, 1, 1024, 3 * Budget, true });
+
+    planner.PlanFrame(0, builds);
+
+    std::vector<uint64_t> compactedSizes(builds.size(), 1000);
+    planner.ReportCompactedSizes(0, compactedSizes.data());
+
+    uint64_t compactionCount = 0;
+
+    for (uint64_t frame = 1; frame < 10 && planner.PendingCompactionCount() > 0; ++frame)
+    {
+        Planner::FramePlan plan = planner.PlanFrame(frame, {});
+        uint64_t compactedBytes = 0;
+
+        for (const Planner::Compaction& compaction : plan.Compactions)
+            compactedBytes += compaction.OriginalSize;
+
+        PF_CHECK(plan.Compactions.size() == 1 || compactedBytes <= Budget);
+        compactionCount += plan.Compactions.size();
+    }
+
+    PF_CHECK(compactionCount == builds.size());
+}
+
+PF_TEST(RTASBuildPlanner_DeferrableBuildsStayWithinBudget)
+{
+    const uint64_t Budget = 10000;
+
+    Planner planner{ 1 << 20, Budget, Unlimited, 64 };
+
+    // Mandatory builds go in regardless of the budget and leave nothing for deferrable ones
+    std::vector<Planner::Build> builds{ { 0, 1, 1024, 3000, true, true }, { 1, 1, 1024, 12000, true, false }, { 2, 1, 1024, 3000, true, true } };
+    Planner::FramePlan plan = planner.PlanFrame(0, builds);
+
+    PF_CHECK(plan.Builds.size() == 1 && plan.Builds[0].Key == 1);
+    PF_CHECK(plan.DeferredBuilds.size() == 2 && plan.DeferredBuilds[0].Key == 0 && plan.DeferredBuilds[1].Key == 2);
+    PF_CHECK(plan.Statistics.DeferredBuildCount == 2);
+    PF_CHECK(plan.SizeQueries.size() == 1 && plan.SizeQueries[0].Key == 1);
+
+    // Deferred builds come back first and get built as the budget allows
+    builds = plan.DeferredBuilds;
+
+    for (uint64_t key = 3; key < 6; ++key)
+        builds.push_back({ key, 1, 1024, 3000, false, true });
+
+    plan = planner.PlanFrame(1, builds);
+
+    PF_CHECK(plan.Builds.size() == 3);
+    PF_CHECK(plan.Builds[0].Key == 0 && plan.Builds[1].Key == 2 && plan.Builds[2].Key == 3);
+    PF_CHECK(plan.DeferredBuilds.size() == 2);
+    PF_CHECK(AreSlicesValid(plan, builds));
+
+    // At least one build per frame even if it alone exceeds the budget
+    plan = planner.PlanFrame(2, { { 6, 1, 1024, 3 * Budget, false, true } });
+
+    PF_CHECK(plan.Builds.size() == 1 && plan.DeferredBuilds.empty());
+}
+
+PF_TEST(RTASBuildPlanner_DeferredBuildCancelsCompaction)
+{
+    Planner planner{ 1 << 20, 1000, Unlimited, 64 };
+
+    planner.PlanFrame(0, { { 0, 1, 1024, 4096, true } });
+
+    // Rebuild of structure 0 is deferred behind a mandatory build, its old size must not be used anymore
+    Planner::FramePlan plan = planner.PlanFrame(1, { { 1, 1, 1024, 4096, false }, { 0, 2, 1024, 4096, true, true } });
+
+    PF_CHECK(plan.DeferredBuilds.size() == 1);
+
+    uint64_t compactedSizes[]{ 1000 };
+    planner.ReportCompactedSizes(0, compactedSizes);
+
+    PF_CHECK(planner.PendingCompactionCount() == 0);
+}
@@ -0,0 +1,301 @@
+#include "../TestRunner.hpp"
+
+#include <RenderPipeline/RTASManager.hpp>
+
+#include <map>
+#include <algorithm>
+
+namespace
+{
+
+    using Manager = PathFinder::RTASManager;
+    using Description = Manager::WorkRecorder::StructureDescription;
+
+    // Stands in for the device: structures are synthetic prebuild sizes and recorded work is logged per frame.
+    // Query results of a frame are handed out once the frame is reported as completed.
+    class FakeRecorder : public Manager::WorkRecorder
+    {
+    public:
+        struct FrameLog
+        {
+            std::vector<uint64_t> Builds;
+            std::vector<uint64_t> Compactions;
+            std::vector<uint64_t> SizeQueries;
+            std::vector<uint64_t> Barriers;
+            uint64_t ScratchArenaBarrierCount = 0;
+            bool AreSlicesInsideArena = true;
+        };
+
+        // Mirrors BottomRTAS: new destination memory holds nothing, same size rebuilds keep the old structure traceable
+        void SetStructure(uint64_t key, uint64_t scratchSize, uint64_t destinationSize, bool allowsCompaction, uint64_t compactedSize = 0)
+        {
+            Description& structure = mStructures[key];
+            structure.HoldsRecordedBuild &= structure.DestinationSize >= destinationSize;
+            structure.Generation = mNextGeneration++;
+            structure.ScratchSize = scratchSize;
+            structure.DestinationSize = std::max(structure.DestinationSize, destinationSize);
+            structure.AllowsCompaction = allowsCompaction;
+            mCompactedSizes[key] = compactedSize;
+        }
+
+        void ClearStructure(uint64_t key)
+        {
+            mStructures[key].Generation = mNextGeneration++;
+        }
+
+        void BeginFrame(uint64_t frameNumber)
+        {
+            mFrameNumber = frameNumber;
+            mLog = {};
+        }
+
+        void CompleteFrame(uint64_t frameNumber)
+        {
+            mCompletedFrameNumber = frameNumber;
+        }
+
+        Description DescribeStructure(uint64_t key) const override
+        {
+            return mStructures.at(key);
+        }
+
+        void AllocateScratchArena(uint64_t size) override
+        {
+            mScratchArenaSize = std::max(mScratchArenaSize, size);
+        }
+
+        void RecordScratchArenaBarrier() override
+        {
+            ++mLog.ScratchArenaBarrierCount;
+        }
+
+        void RecordBuild(uint64_t key, uint64_t scratchOffset) override
+        {
+            Description& structure = mStructures.at(key);
+            mLog.AreSlicesInsideArena &= scratchOffset + structure.ScratchSize <= mScratchArenaSize;
+            mLog.Builds.push_back(key);
+            structure.HoldsRecordedBuild = true;
+        }
+
+        void RecordCompaction(uint64_t key, uint64_t compactedSize) override
+        {
+            mLog.Compactions.push_back(key);
+            mStructures.at(key).DestinationSize = compactedSize;
+        }
+
+        void RecordCompactedSizeQueries(const std::vector<uint64_t>& keys) override
+        {
+            mLog.SizeQueries = keys;
+
+            for (uint64_t key : keys)
+                mQueryResults[mFrameNumber].push_back(mCompactedSizes.at(key));
+        }
+
+        void RecordStructureBarriers(const std::vector<uint64_t>& keys) override
+        {
+            mLog.Barriers = keys;
+        }
+
+        void ReadCompactedSizes(const std::function<void(const uint64_t*)>& callback) override
+        {
+            auto resultsIt = mQueryResults.find(mCompletedFrameNumber);
+            callback(resultsIt != mQueryResults.end() ? resultsIt->second.data() : nullptr);
+        }
+
+    private:
+        std::map<uint64_t, Description> mStructures;
+        std::map<uint64_t, uint64_t> mCompactedSizes;
+        std::map<uint64_t, std::vector<uint64_t>> mQueryResults;
+        uint64_t mNextGeneration = 1;
+        uint64_t mScratchArenaSize = 0;
+        uint64_t mFrameNumber = 0;
+        uint64_t mCompletedFrameNumber = 0;
+        FrameLog mLog;
+
+    public:
+        inline const FrameLog& Log() const { return mLog; }
+        inline const Description& Structure(uint64_t key) const { return mStructures.at(key); }
+    };
+
+    // Runs a frame the way the render engine does, with the previous frame completing at its end
+    void RunFrame(Manager& manager, FakeRecorder& recorder, uint64_t frameNumber)
+    {
+        recorder.BeginFrame(frameNumber);
+        manager.BeginFrame(frameNumber);
+        manager.RecordBottomRTASWork();
+
+        if (frameNumber > 0)
+        {
+            recorder.CompleteFrame(frameNumber - 1);
+            manager.EndFrame(frameNumber - 1);
+        }
+    }
+
+    bool Contains(const std::vector<uint64_t>& keys, uint64_t key)
+    {
+        return std::find(keys.begin(), keys.end(), key) != keys.end();
+    }
+
+}
+
+PF_TEST(RTASManager_BuildsEveryAddedStructureOnce)
+{
+    FakeRecorder recorder;
+    Manager manager{ &recorder };
+
+    // Enough scratch to need several batches of the initial arena
+    const uint64_t StructureCount = 12;
+    const uint64_t ScratchSize = Manager::InitialScratchArenaSize / 5;
+
+    for (uint64_t key = 0; key < StructureCount; ++key)
+    {
+        recorder.SetStructure(key, ScratchSize, 1 << 20, false);
+        manager.AddStructure(key);
+        manager.AddStructure(key);
+    }
+
+    RunFrame(manager, recorder, 0);
+
+    const FakeRecorder::FrameLog& log = recorder.Log();
+
+    PF_CHECK(log.Builds.size() == StructureCount);
+    PF_CHECK(log.AreSlicesInsideArena);
+    PF_CHECK(log.ScratchArenaBarrierCount + 1 == manager.GetStatistics().Plan.BatchCount);
+    PF_CHECK(log.ScratchArenaBarrierCount > 0);
+    PF_CHECK(log.Barriers == log.Builds);
+    PF_CHECK(log.SizeQueries.empty());
+    PF_CHECK(manager.QueuedStructureCount() == 0);
+
+    // Nothing is rebuilt without being added again
+    RunFrame(manager, recorder, 1);
+
+    PF_CHECK(recorder.Log().Builds.empty());
+}
+
+PF_TEST(RTASManager_CompactsStaticStructuresAfterReadback)
+{
+    FakeRecorder recorder;
+    Manager manager{ &recorder };
+
+    for (uint64_t key = 0; key < 4; ++key)
+    {
+        recorder.SetStructure(key, 4096, 1 << 20, key != 3, 300 << 10);
+        manager.AddStructure(key);
+    }
+
+    RunFrame(manager, recorder, 0);
+
+    PF_CHECK(recorder.Log().SizeQueries == std::vector<uint64_t>({ 0, 1, 2 }));
+
+    // Structure 1 is rebuilt and structure 2 cleared before sizes of frame 0 arrive at the end of frame 1
+    recorder.SetStructure(1, 4096, 1 << 20, true, 300 << 10);
+    manager.AddStructure(1);
+    RunFrame(manager, recorder, 1);
+
+    recorder.ClearStructure(2);
+    RunFrame(manager, recorder, 2);
+
+    const FakeRecorder::FrameLog& log = recorder.Log();
+
+    PF_CHECK(log.Compactions == std::vector<uint64_t>({ 0 }));
+    PF_CHECK(Contains(log.Barriers, 0));
+    PF_CHECK(recorder.Structure(0).DestinationSize == 300 << 10);
+    PF_CHECK(recorder.Structure(2).DestinationSize == 1 << 20);
+    PF_CHECK(recorder.Structure(3).DestinationSize == 1 << 20);
+
+    // Rebuilt structure gets compacted once its own size arrives
+    RunFrame(manager, recorder, 3);
+
+    PF_CHECK(recorder.Log().Compactions == std::vector<uint64_t>({ 1 }));
+    PF_CHECK(manager.GetStatistics().Plan.TotalCompactionBytesSaved == 2 * ((1 << 20) - (300 << 10)));
+}
+
+PF_TEST(RTASManager_DefersRebuildsOfTraceableStructures)
+{
+    FakeRecorder recorder;
+    Manager manager{ &recorder };
+
+    const uint64_t DestinationSize = Manager::BuildByteBudgetPerFrame / 4;
+    const uint64_t StructureCount = 10;
+
+    for (uint64_t key = 0; key < StructureCount; ++key)
+    {
+        recorder.SetStructure(key, 4096, DestinationSize, false);
+        manager.AddStructure(key);
+    }
+
+    // First builds have nothing to fall back to and go in all at once
+    RunFrame(manager, recorder, 0);
+
+    PF_CHECK(recorder.Log().Builds.size() == StructureCount);
+
+    // Same size rebuilds keep previous contents traceable and get spread over frames
+    for (uint64_t key = 0; key < StructureCount; ++key)
+    {
+        recorder.SetStructure(key, 4096, DestinationSize, false);
+        manager.AddStructure(key);
+    }
+
+    std::vector<uint64_t> builtKeys;
+    uint64_t frameNumber = 1;
+
+    for (; frameNumber < 10 && (frameNumber == 1 || manager.QueuedStructureCount() > 0); ++frameNumber)
+    {
+        RunFrame(manager, recorder, frameNumber);
+
+        const FakeRecorder::FrameLog& log = recorder.Log();
+
+        PF_CHECK(log.Builds.size() <= 4);
+        PF_CHECK(manager.GetStatistics().Plan.DeferredBuildCount == manager.QueuedStructureCount());
+        builtKeys.insert(builtKeys.end(), log.Builds.begin(), log.Builds.end());
+
+        // Adding a waiting structure again doesn't queue it twice
+        if (manager.QueuedStructureCount() > 0)
+            manager.AddStructure(StructureCount - 1);
+    }
+
+    std::sort(builtKeys.begin(), builtKeys.end());
+
+    PF_CHECK(frameNumber == 4);
+    PF_CHECK(builtKeys.size() == StructureCount);
+    PF_CHECK(std::unique(builtKeys.begin(), builtKeys.end()) == builtKeys.end());
+}
+
+PF_TEST(RTASManager_DropsDeferredBuildsOfClearedStructures)
+{
+    FakeRecorder recorder;
+    Manager manager{ &recorder };
+
+    const uint64_t DestinationSize = Manager::BuildByteBudgetPerFrame / 2;
+
+    for (uint64_t key = 0; key < 3; ++key)
+    {
+        recorder.SetStructure(key, 4096, DestinationSize, false);
+        manager.AddStructure(key);
+    }
+
+    RunFrame(manager, recorder, 0);
+
+    // A grown structure needs new memory, so its build can't wait and takes the budget
+    recorder.SetStructure(0, 4096, 2 * DestinationSize, false);
+    recorder.SetStructure(1, 4096, DestinationSize, false);
+    recorder.SetStructure(2, 4096, DestinationSize, false);
+
+    for (uint64_t key = 0; key < 3; ++key)
+        manager.AddStructure(key);
+
+    RunFrame(manager, recorder, 1);
+
+    PF_CHECK(recorder.Log().Builds == std::vector<uint64_t>({ 0 }));
+    PF_CHECK(manager.QueuedStructureCount() == 2);
+
+    // Structure 1 is removed from the scene while waiting, structure 2 is rebuilt again and stays queued
+    recorder.ClearStructure(1);
+    recorder.SetStructure(2, 4096, DestinationSize, false);
+    manager.AddStructure(2);
+
+    RunFrame(manager, recorder, 2);
+
+    PF_CHECK(recorder.Log().Builds == std::vector<uint64_t>({ 2 }));
+    PF_CHECK(manager.QueuedStructureCount() == 0);
+}
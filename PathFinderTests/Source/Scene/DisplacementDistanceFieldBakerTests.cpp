@@ -0,0 +1,114 @@
+#include "../TestRunner.hpp"
+
+#include <Scene/DisplacementDistanceFieldBaker.hpp>
+
+#include <random>
+#include <cmath>
+
+namespace
+{
+
+    using Baker = PathFinder::DisplacementDistanceFieldBaker;
+
+    Baker::HeightField RandomHeightField(uint64_t width, uint64_t height, uint32_t seed)
+    {
+        std::mt19937 generator{ seed };
+        std::uniform_real_distribution<float> distribution{ 0.0f, 1.0f };
+
+        Baker::HeightField heightField{ width, height };
+        heightField.Heights.resize(width * height);
+
+        for (float& texelHeight : heightField.Heights)
+            texelHeight = distribution(generator);
+
+        return heightField;
+    }
+
+    float VoxelDistance(const std::vector<float>& distances, const Geometry::Dimensions& gridSize, uint64_t x, uint64_t y, uint64_t z, uint64_t octant)
+    {
+        return distances[((z * gridSize.Height + y) * gridSize.Width + x) * Baker::OctantCount + octant];
+    }
+
+}
+
+PF_TEST(DisplacementDistanceFieldBaker_OctantsFollowShaderOrder)
+{
+    // Flat surface intersects the bottom layer only
+    Geometry::Dimensions gridSize{ 16, 8, 8 };
+    Baker::HeightField heightField{ 16, 8, std::vector<float>(16 * 8, 0.01f) };
+
+    std::vector<float> distances = Baker{ 1 }.BakeDistances(heightField, gridSize);
+
+    const uint64_t x = 8, y = 4, z = 5;
+    float dz = float(z) / gridSize.Depth;
+    // Wedges around X need |dx| > |dz|
+    float dx = float(z + 1) / gridSize.Width;
+
+    for (uint64_t lower = 0; lower < 2; ++lower)
+    {
+        uint64_t offset = lower * 4;
+        // Lower octants need a negative Y offset
+        float dy = lower ? 1.0f / gridSize.Height : 0.0f;
+        float down = std::sqrt(dy * dy + dz * dz);
+        float sideways = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+        PF_CHECK(std::abs(VoxelDistance(distances, gridSize, x, y, z, offset + 3) - down) < 1e-5f);
+        PF_CHECK(std::isinf(VoxelDistance(distances, gridSize, x, y, z, offset + 1)));
+        PF_CHECK(std::abs(VoxelDistance(distances, gridSize, x, y, z, offset + 0) - sideways) < 1e-5f);
+        PF_CHECK(std::abs(VoxelDistance(distances, gridSize, x, y, z, offset + 2) - sideways) < 1e-5f);
+    }
+
+    // Seeds are at zero distance in every octant
+    for (uint64_t octant = 0; octant < Baker::OctantCount; ++octant)
+        PF_CHECK(VoxelDistance(distances, gridSize, x, y, 0, octant) == 0.0f);
+}
+
+PF_TEST(DisplacementDistanceFieldBaker_MatchesBruteForce)
+{
+    Geometry::Dimensions gridSizes[]{ { 12, 10, 14 }, { 20, 7, 5 } };
+
+    for (const Geometry::Dimensions& gridSize : gridSizes)
+    {
+        Baker::HeightField heightField = RandomHeightField(24, 20, 31);
+
+        std::vector<float> distances = Baker{ 1 }.BakeDistances(heightField, gridSize);
+        std::vector<float> referenceDistances = Baker::BakeDistancesBruteForce(heightField, gridSize);
+
+        PF_CHECK(distances.size() == referenceDistances.size());
+
+        uint64_t mismatchCount = 0;
+
+        for (uint64_t i = 0; i < distances.size(); ++i)
+        {
+            bool bothInfinite = std::isinf(distances[i]) && std::isinf(referenceDistances[i]);
+            mismatchCount += !bothInfinite && !(std::abs(distances[i] - referenceDistances[i]) <= 1e-5f);
+        }
+
+        PF_CHECK(mismatchCount == 0);
+    }
+}
+
+PF_TEST(DisplacementDistanceFieldBaker_BoundsGPUJumpFlooding)
+{
+    Geometry::Dimensions gridSize{ 16, 16, 8 };
+    Baker::HeightField heightField = RandomHeightField(32, 32, 7);
+
+    std::vector<float> distances = Baker{ 1 }.BakeDistances(heightField, gridSize);
+    std::vector<float> floodingDistances = Baker::BakeDistancesJumpFlooding(heightField, gridSize);
+
+    uint64_t violationCount = 0;
+    uint64_t matchCount = 0;
+
+    // Flooding finds seeds within the octant it fills, never closer than the exact one
+    for (uint64_t i = 0; i < distances.size(); ++i)
+    {
+        if (std::isinf(floodingDistances[i]))
+            continue;
+
+        violationCount += !(floodingDistances[i] >= distances[i] - 1e-5f);
+        matchCount += std::abs(floodingDistances[i] - distances[i]) <= 1e-5f;
+    }
+
+    PF_CHECK(violationCount == 0);
+    PF_CHECK(matchCount > distances.size() / 2);
+}
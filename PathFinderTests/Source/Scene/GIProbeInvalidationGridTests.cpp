@@ -0,0 +1,102 @@
+#include "../TestRunner.hpp"
+
+#include <Scene/GIProbeInvalidationGrid.hpp>
+
+namespace
+{
+
+    using Grid = PathFinder::GIProbeInvalidationGrid;
+
+    const Geometry::AABB LeftBounds{ glm::vec3{ 1.2f }, glm::vec3{ 1.8f } };
+    const Geometry::AABB RightBounds{ glm::vec3{ 5.2f }, glm::vec3{ 5.8f } };
+
+    std::vector<PathFinder::IlluminanceFieldCascade> SingleCascade()
+    {
+        std::vector<PathFinder::IlluminanceFieldCascade> cascades = { { glm::uvec3{ 8 }, 1.0f } };
+        cascades.front().Reset();
+        cascades.front().Scroll(glm::vec3{ 0.0f });
+        return cascades;
+    }
+
+    // Caches footprints of two entities and lets invalidation of the initial frame expire
+    void PlaceTwoEntities(Grid& grid, const std::vector<PathFinder::IlluminanceFieldCascade>& cascades)
+    {
+        grid.BeginFrame(cascades);
+        grid.ResizeEntitySlots(2);
+
+        PF_CHECK(grid.AssignEntity(0, 100));
+        PF_CHECK(grid.AssignEntity(1, 200));
+
+        grid.RefitEntity(0, LeftBounds, 0.0f, 0.0f, 0.0f);
+        grid.RefitEntity(1, RightBounds, 0.0f, 0.0f, 0.0f);
+
+        for (uint64_t frame = 0; frame < 16; ++frame)
+            grid.ScheduleProbeUpdates(0, false);
+    }
+
+    bool IsInvalidated(const Grid& grid, const PathFinder::IlluminanceFieldCascade& cascade, const glm::ivec3& cell)
+    {
+        return grid.ProbeStates()[cascade.ProbeIndex(cell)].IlluminanceHysteresisDecrease > 0.0f;
+    }
+
+}
+
+PF_TEST(GIProbeInvalidationGrid_KeepsSlotsOfUnchangedEntities)
+{
+    std::vector<PathFinder::IlluminanceFieldCascade> cascades = SingleCascade();
+    Grid grid;
+    PlaceTwoEntities(grid, cascades);
+
+    cascades.front().Scroll(glm::vec3{ 0.0f });
+    grid.BeginFrame(cascades);
+    grid.ResizeEntitySlots(2);
+
+    PF_CHECK(!grid.AssignEntity(0, 100));
+    PF_CHECK(!grid.AssignEntity(1, 200));
+
+    grid.ScheduleProbeUpdates(0, false);
+
+    PF_CHECK(grid.InvalidatedProbeCount() == 0);
+}
+
+PF_TEST(GIProbeInvalidationGrid_InvalidatesAroundRemovedEntity)
+{
+    std::vector<PathFinder::IlluminanceFieldCascade> cascades = SingleCascade();
+    Grid grid;
+    PlaceTwoEntities(grid, cascades);
+
+    // First entity is removed and the last one takes its slot, the way dense storage erases
+    cascades.front().Scroll(glm::vec3{ 0.0f });
+    grid.BeginFrame(cascades);
+    grid.ResizeEntitySlots(1);
+
+    PF_CHECK(grid.AssignEntity(0, 200));
+
+    grid.RefitEntity(0, RightBounds, 0.0f, Grid::MaxHysteresisDecrease, Grid::MaxHysteresisDecrease);
+
+    PF_CHECK(IsInvalidated(grid, cascades.front(), { 1, 1, 1 }));
+    PF_CHECK(IsInvalidated(grid, cascades.front(), { 6, 6, 6 }));
+    PF_CHECK(!IsInvalidated(grid, cascades.front(), { 1, 6, 1 }));
+}
+
+PF_TEST(GIProbeInvalidationGrid_DetectsReplacementWithoutCountChange)
+{
+    std::vector<PathFinder::IlluminanceFieldCascade> cascades = SingleCascade();
+    Grid grid;
+    PlaceTwoEntities(grid, cascades);
+
+    // One entity is added and another removed within a frame
+    cascades.front().Scroll(glm::vec3{ 0.0f });
+    grid.BeginFrame(cascades);
+    grid.ResizeEntitySlots(2);
+
+    PF_CHECK(!grid.AssignEntity(0, 100));
+    PF_CHECK(grid.AssignEntity(1, 300));
+
+    grid.RefitEntity(1, LeftBounds, 0.0f, Grid::MaxHysteresisDecrease, Grid::MaxHysteresisDecrease);
+
+    // Probes are invalidated where the removed entity was as well as where the new one is
+    PF_CHECK(IsInvalidated(grid, cascades.front(), { 6, 6, 6 }));
+    PF_CHECK(IsInvalidated(grid, cascades.front(), { 2, 2, 2 }));
+    PF_CHECK(!IsInvalidated(grid, cascades.front(), { 1, 6, 1 }));
+}
@@ -0,0 +1,192 @@
+#include "../TestRunner.hpp"
+
+#include <Scene/IlluminanceFieldCascade.hpp>
+
+#include <glm/common.hpp>
+#include <glm/vector_relational.hpp>
+
+#include <string>
+#include <vector>
+#include <cmath>
+
+namespace
+{
+
+    using Cascade = PathFinder::IlluminanceFieldCascade;
+    using CellBox = Cascade::CellBox;
+
+    // Same layout as the default illuminance field
+    std::vector<Cascade> DefaultCascades()
+    {
+        std::vector<Cascade> cascades = { { { 20, 14, 20 }, 3.0f }, { { 16, 8, 16 }, 12.0f } };
+        uint64_t probeOffset = 0;
+
+        for (Cascade& cascade : cascades)
+        {
+            cascade.SetProbeOffset(probeOffset);
+            probeOffset += cascade.ProbeCount();
+        }
+
+        return cascades;
+    }
+
+    bool IsInBox(const glm::ivec3& cell, const CellBox& box)
+    {
+        return glm::all(glm::greaterThanEqual(cell, box.Min)) && glm::all(glm::lessThanEqual(cell, box.Max));
+    }
+
+    template <class Function>
+    void ForEachCell(const CellBox& box, Function&& function)
+    {
+        for (int32_t z = box.Min.z; z <= box.Max.z; ++z)
+            for (int32_t y = box.Min.y; y <= box.Max.y; ++y)
+                for (int32_t x = box.Min.x; x <= box.Max.x; ++x)
+                    function(glm::ivec3{ x, y, z });
+    }
+
+    void ScrollToCamera(Cascade& cascade, const glm::vec3& cameraPosition)
+    {
+        cascade.Scroll(cameraPosition - glm::vec3{ cascade.GetGridSize() } * cascade.GetCellSize() * 0.5f);
+    }
+
+    // Dirty slabs must cover exactly the cells that weren't in the volume before the scroll, once each
+    bool AreDirtySlabsExact(const Cascade& cascade, const CellBox& previousBox, bool isFirstScroll)
+    {
+        CellBox box = cascade.GetCellBox();
+        std::vector<uint8_t> visitedSlots(cascade.ProbeCount(), 0);
+        uint64_t slabCellCount = 0;
+        uint64_t exposedCellCount = 0;
+        bool isValid = true;
+
+        for (const CellBox& slab : cascade.GetDirtySlabs())
+        {
+            ForEachCell(slab, [&](const glm::ivec3& cell)
+            {
+                uint64_t slot = cascade.ProbeIndex(cell) - cascade.GetProbeOffset();
+
+                isValid = isValid && IsInBox(cell, box) && (isFirstScroll || !IsInBox(cell, previousBox));
+                isValid = isValid && visitedSlots[slot] == 0;
+                visitedSlots[slot] = 1;
+                ++slabCellCount;
+            });
+        }
+
+        ForEachCell(box, [&](const glm::ivec3& cell)
+        {
+            if (isFirstScroll || !IsInBox(cell, previousBox))
+                ++exposedCellCount;
+        });
+
+        return isValid && slabCellCount == exposedCellCount && slabCellCount == cascade.DirtyProbeCount();
+    }
+
+    // Every cell of the volume must own a distinct slot of its cascade and map back to itself
+    bool AreProbeSlotsExact(const Cascade& cascade)
+    {
+        std::vector<uint8_t> visitedSlots(cascade.ProbeCount(), 0);
+        bool isValid = true;
+
+        ForEachCell(cascade.GetCellBox(), [&](const glm::ivec3& cell)
+        {
+            uint64_t probeIndex = cascade.ProbeIndex(cell);
+            bool isInRange = probeIndex >= cascade.GetProbeOffset() && probeIndex < cascade.GetProbeOffset() + cascade.ProbeCount();
+
+            isValid = isValid && isInRange && visitedSlots[probeIndex - cascade.GetProbeOffset()] == 0 && cascade.ProbeCell(probeIndex) == cell;
+
+            if (isInRange)
+                visitedSlots[probeIndex - cascade.GetProbeOffset()] = 1;
+        });
+
+        return isValid;
+    }
+
+    glm::vec3 SweepCameraPosition(const std::string& sweep, uint64_t frame)
+    {
+        float time = frame / 60.0f;
+        glm::vec3 position{ 0.0f, 2.0f, 0.0f };
+
+        if (sweep == "walk") position.x += 1.5f * time;
+        else if (sweep == "walk_back") position.x -= 1.5f * time;
+        else if (sweep == "run_diagonal") position += glm::vec3{ 1.0f, 0.1f, 1.0f } * 6.0f * time / std::sqrt(2.01f);
+        else if (sweep == "vehicle") position.z -= 40.0f * time;
+        else if (sweep == "orbit") position += glm::vec3{ std::cos(time * 0.5f), 0.0f, std::sin(time * 0.5f) } * 30.0f;
+        else if (sweep == "teleport") position.x += 1.5f * time + 500.0f * float(frame / 120);
+
+        return position;
+    }
+
+}
+
+PF_TEST(IlluminanceFieldCascade_DirtySlabsCoverExactlyExposedCells)
+{
+    const char* sweeps[]{ "walk", "walk_back", "run_diagonal", "vehicle", "orbit", "teleport" };
+
+    for (const char* sweep : sweeps)
+    {
+        std::vector<Cascade> cascades = DefaultCascades();
+
+        for (uint64_t frame = 0; frame < 360; ++frame)
+        {
+            for (Cascade& cascade : cascades)
+            {
+                CellBox previousBox = cascade.GetCellBox();
+                ScrollToCamera(cascade, SweepCameraPosition(sweep, frame));
+
+                PF_CHECK(AreDirtySlabsExact(cascade, previousBox, frame == 0));
+                PF_CHECK(AreProbeSlotsExact(cascade));
+            }
+        }
+    }
+}
+
+PF_TEST(IlluminanceFieldCascade_ProbesKeepSlotsWhileInVolume)
+{
+    Cascade cascade{ { 8, 4, 8 }, 1.0f };
+    cascade.Scroll(glm::vec3{ 0.0f });
+
+    std::vector<uint64_t> slots;
+    ForEachCell(cascade.GetCellBox(), [&](const glm::ivec3& cell) { slots.push_back(cascade.ProbeIndex(cell)); });
+
+    CellBox previousBox = cascade.GetCellBox();
+    cascade.Scroll(glm::vec3{ 3.0f, -1.0f, 2.0f });
+
+    // Only the slabs exposed by the scroll are dirty
+    PF_CHECK(cascade.DirtyProbeCount() == cascade.ProbeCount() - 5 * 3 * 6);
+    PF_CHECK(cascade.GetDirtySlabs().size() == 3);
+
+    uint64_t cellIndex = 0;
+
+    ForEachCell(previousBox, [&](const glm::ivec3& cell)
+    {
+        uint64_t previousSlot = slots[cellIndex++];
+
+        if (cascade.ContainsCell(cell))
+        {
+            PF_CHECK(cascade.ProbeIndex(cell) == previousSlot);
+            PF_CHECK(cascade.ProbeCell(previousSlot) == cell);
+        }
+    });
+}
+
+PF_TEST(IlluminanceFieldCascade_ResetAndLongJumpsDirtyWholeVolume)
+{
+    Cascade cascade{ { 8, 4, 8 }, 2.0f };
+
+    // Volume starts reset
+    cascade.Scroll(glm::vec3{ 0.0f });
+    PF_CHECK(cascade.DirtyProbeCount() == cascade.ProbeCount());
+
+    // Movement within a cell snaps to the same corner
+    cascade.Scroll(glm::vec3{ 0.4f, 0.0f, -0.4f });
+    PF_CHECK(cascade.DirtyProbeCount() == 0);
+    PF_CHECK(cascade.GetDirtySlabs().empty());
+
+    cascade.Reset();
+    cascade.Scroll(glm::vec3{ 0.0f });
+    PF_CHECK(cascade.DirtyProbeCount() == cascade.ProbeCount());
+
+    // Jump by exactly the volume size along a single axis leaves nothing to keep
+    cascade.Scroll(glm::vec3{ 0.0f, 8.0f, 0.0f });
+    PF_CHECK(cascade.DirtyProbeCount() == cascade.ProbeCount());
+    PF_CHECK(cascade.GetDirtySlabs().size() == 1);
+}
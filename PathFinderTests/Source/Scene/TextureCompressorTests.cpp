@@ -0,0 +1,123 @@
+#include "../TestRunner.hpp"
+
+#include <Scene/TextureCompressor.hpp>
+
+#include <glm/vec3.hpp>
+
+#include <random>
+#include <cmath>
+
+namespace
+{
+
+    using Compressor = PathFinder::TextureCompressor;
+
+    const Compressor::Quality Qualities[]{ Compressor::Quality::Fast, Compressor::Quality::Normal, Compressor::Quality::High };
+
+    Compressor::Image SmoothImage(uint64_t size, float intensityScale)
+    {
+        Compressor::Image image{ size, size };
+
+        for (uint64_t y = 0; y < size; ++y)
+        {
+            for (uint64_t x = 0; x < size; ++x)
+            {
+                float u = float(x) / size;
+                float v = float(y) / size;
+                float smooth = 0.5f + 0.5f * std::sin(u * 9.0f) * std::cos(v * 7.0f);
+
+                image.Texels.emplace_back(smooth * intensityScale, (0.2f + 0.6f * u) * intensityScale, (0.3f + 0.5f * v * smooth) * intensityScale, 0.5f + 0.5f * v);
+            }
+        }
+
+        return image;
+    }
+
+    // Every block holds three colors that don't lie on a line, split by one of the two subset partitions:
+    // left half, and top and bottom of the right half
+    Compressor::Image ThreeColorBlocksImage(uint64_t size, float intensityScale, uint32_t seed)
+    {
+        std::mt19937 generator{ seed };
+        std::uniform_real_distribution<float> distribution{ 0.0f, 1.0f };
+
+        Compressor::Image image{ size, size, std::vector<glm::vec4>(size * size) };
+
+        for (uint64_t blockY = 0; blockY < size / 4; ++blockY)
+        {
+            for (uint64_t blockX = 0; blockX < size / 4; ++blockX)
+            {
+                glm::vec4 left{ distribution(generator), 0.1f, 0.1f, 1.0f };
+                glm::vec4 top{ 0.1f, distribution(generator), 0.9f, 1.0f };
+                glm::vec4 bottom{ 0.9f, 0.1f, distribution(generator), 1.0f };
+
+                for (uint64_t texel = 0; texel < 16; ++texel)
+                {
+                    uint64_t x = texel % 4;
+                    uint64_t y = texel / 4;
+                    glm::vec4 color = x < 2 ? left : (y < 2 ? top : bottom);
+
+                    image.Texels[(blockY * 4 + y) * size + blockX * 4 + x] = glm::vec4{ glm::vec3{ color } * intensityScale, color.a };
+                }
+            }
+        }
+
+        return image;
+    }
+
+    float RoundTripPSNR(const Compressor::Image& image, Compressor::BlockFormat format, Compressor::Quality quality, uint64_t channelCount)
+    {
+        Compressor compressor{ quality, 1 };
+        Compressor::CompressedMip mip = compressor.CompressMip(image, format);
+        return Compressor::PSNR(image, Compressor::Decompress(mip, format), channelCount, format == Compressor::BlockFormat::BC6H);
+    }
+
+}
+
+PF_TEST(TextureCompressor_RoundTripsEveryFormat)
+{
+    Compressor::Image image = SmoothImage(64, 1.0f);
+    Compressor::Image hdrImage = SmoothImage(64, 40.0f);
+
+    for (Compressor::Quality quality : Qualities)
+    {
+        PF_CHECK(RoundTripPSNR(image, Compressor::BlockFormat::BC1, quality, 3) > 35.0f);
+        PF_CHECK(RoundTripPSNR(image, Compressor::BlockFormat::BC4, quality, 1) > 40.0f);
+        PF_CHECK(RoundTripPSNR(image, Compressor::BlockFormat::BC5, quality, 2) > 40.0f);
+        PF_CHECK(RoundTripPSNR(image, Compressor::BlockFormat::BC7, quality, 4) > 40.0f);
+        PF_CHECK(RoundTripPSNR(hdrImage, Compressor::BlockFormat::BC6H, quality, 3) > 40.0f);
+    }
+}
+
+PF_TEST(TextureCompressor_PartitionedModesFitThreeColorBlocks)
+{
+    Compressor::Image image = ThreeColorBlocksImage(32, 1.0f, 3);
+    Compressor::Image hdrImage = ThreeColorBlocksImage(32, 8.0f, 5);
+
+    // Single subset modes can't reproduce three colors off a line, partitioned ones can
+    float bc7Fast = RoundTripPSNR(image, Compressor::BlockFormat::BC7, Compressor::Quality::Fast, 3);
+    float bc6hFast = RoundTripPSNR(hdrImage, Compressor::BlockFormat::BC6H, Compressor::Quality::Fast, 3);
+
+    PF_CHECK(RoundTripPSNR(image, Compressor::BlockFormat::BC7, Compressor::Quality::Normal, 3) > bc7Fast + 10.0f);
+    PF_CHECK(RoundTripPSNR(hdrImage, Compressor::BlockFormat::BC6H, Compressor::Quality::Normal, 3) > bc6hFast + 10.0f);
+}
+
+PF_TEST(TextureCompressor_SlowerPresetsNeverLoseQuality)
+{
+    Compressor::Image image = ThreeColorBlocksImage(32, 1.0f, 7);
+    Compressor::Image smoothImage = SmoothImage(32, 1.0f);
+    Compressor::Image hdrImage = SmoothImage(32, 200.0f);
+
+    for (const Compressor::Image* testImage : { &image, &smoothImage })
+    {
+        float fast = RoundTripPSNR(*testImage, Compressor::BlockFormat::BC7, Compressor::Quality::Fast, 4);
+        float normal = RoundTripPSNR(*testImage, Compressor::BlockFormat::BC7, Compressor::Quality::Normal, 4);
+        float high = RoundTripPSNR(*testImage, Compressor::BlockFormat::BC7, Compressor::Quality::High, 4);
+
+        PF_CHECK(normal >= fast && high >= normal - 0.01f);
+    }
+
+    float fast = RoundTripPSNR(hdrImage, Compressor::BlockFormat::BC6H, Compressor::Quality::Fast, 3);
+    float normal = RoundTripPSNR(hdrImage, Compressor::BlockFormat::BC6H, Compressor::Quality::Normal, 3);
+
+    PF_CHECK(normal >= fast);
+}
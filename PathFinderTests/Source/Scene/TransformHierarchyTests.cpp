@@ -0,0 +1,214 @@
+#include "../TestRunner.hpp"
+
+#include <Scene/TransformHierarchy.hpp>
+
+#include <glm/gtc/matrix_inverse.hpp>
+
+#include <random>
+#include <algorithm>
+
+namespace
+{
+
+    using PathFinder::TransformHierarchy;
+
+    Geometry::Transformation RandomTransformation(std::mt19937& generator)
+    {
+        std::uniform_real_distribution<float> distribution{ -1.0f, 1.0f };
+        glm::vec3 axis = glm::normalize(glm::vec3{ distribution(generator), distribution(generator), distribution(generator) } + 0.001f);
+        glm::vec3 scale = glm::vec3{ 1.0f } + glm::vec3{ distribution(generator), distribution(generator), distribution(generator) } * 0.01f;
+        glm::vec3 translation = glm::vec3{ distribution(generator), distribution(generator), distribution(generator) } * 0.5f;
+        return Geometry::Transformation{ scale, translation, glm::angleAxis(distribution(generator) * 0.5f, axis) };
+    }
+
+    // Per node glm composition the hierarchy is expected to reproduce
+    class ReferenceHierarchy
+    {
+    public:
+        TransformHierarchy::NodeId Add(TransformHierarchy& hierarchy, const Geometry::Transformation& local, TransformHierarchy::NodeId parent)
+        {
+            TransformHierarchy::NodeId id = hierarchy.AddNode(local, parent);
+            mNodes.push_back({ id, parent, local });
+            return id;
+        }
+
+        void SetLocal(TransformHierarchy& hierarchy, uint64_t index, const Geometry::Transformation& local)
+        {
+            mNodes[index].Local = local;
+            hierarchy.SetLocalTransform(mNodes[index].Id, local);
+        }
+
+        // Largest element error relative to element magnitude, over world and normal matrices of every node
+        float MaxError(const TransformHierarchy& hierarchy) const
+        {
+            std::vector<glm::mat4> worldMatrices(mNodes.size());
+            float maxError = 0.0f;
+
+            // Nodes are recorded after their parents
+            for (uint64_t index = 0; index < mNodes.size(); ++index)
+            {
+                const Node& node = mNodes[index];
+                glm::mat4 local = node.Local.GetMatrix();
+
+                if (node.Parent != TransformHierarchy::NoParent)
+                {
+                    auto parentIt = std::find_if(mNodes.begin(), mNodes.end(), [&node](const Node& other) { return other.Id == node.Parent; });
+                    local = worldMatrices[std::distance(mNodes.begin(), parentIt)] * local;
+                }
+
+                worldMatrices[index] = local;
+                glm::mat4 normal = glm::transpose(glm::inverse(local));
+
+                for (auto column = 0; column < 4; ++column)
+                {
+                    for (auto row = 0; row < 4; ++row)
+                    {
+                        float worldReference = worldMatrices[index][column][row];
+                        maxError = std::max(maxError, std::abs(hierarchy.WorldMatrix(node.Id)[column][row] - worldReference) / std::max(1.0f, std::abs(worldReference)));
+
+                        // Only the upper 3x3 of normal matrices is meaningful
+                        if (column < 3 && row < 3)
+                        {
+                            float normalReference = normal[column][row];
+                            maxError = std::max(maxError, std::abs(hierarchy.NormalMatrix(node.Id)[column][row] - normalReference) / std::max(1.0f, std::abs(normalReference)));
+                        }
+                    }
+                }
+            }
+
+            return maxError;
+        }
+
+        TransformHierarchy::NodeId Id(uint64_t index) const { return mNodes[index].Id; }
+        uint64_t Size() const { return mNodes.size(); }
+
+    private:
+        struct Node
+        {
+            TransformHierarchy::NodeId Id;
+            TransformHierarchy::NodeId Parent;
+            Geometry::Transformation Local;
+        };
+
+        std::vector<Node> mNodes;
+    };
+
+    const float MaxRelativeError = 1e-4f;
+
+}
+
+PF_TEST(TransformHierarchy_DeepChainMatchesGLM)
+{
+    std::mt19937 generator{ 3 };
+    TransformHierarchy hierarchy;
+    ReferenceHierarchy reference;
+    TransformHierarchy::NodeId parent = TransformHierarchy::NoParent;
+
+    for (uint32_t depth = 0; depth < 64; ++depth)
+    {
+        parent = reference.Add(hierarchy, RandomTransformation(generator), parent);
+    }
+
+    hierarchy.Update();
+
+    PF_CHECK(hierarchy.LevelCount() == 64);
+    PF_CHECK(reference.MaxError(hierarchy) < MaxRelativeError);
+}
+
+PF_TEST(TransformHierarchy_WideAndRandomTreesMatchGLM)
+{
+    std::mt19937 generator{ 5 };
+    TransformHierarchy hierarchy;
+    ReferenceHierarchy reference;
+
+    TransformHierarchy::NodeId wideRoot = reference.Add(hierarchy, RandomTransformation(generator), TransformHierarchy::NoParent);
+
+    // Odd child count leaves a partial batch of 4
+    for (uint32_t child = 0; child < 1023; ++child)
+    {
+        reference.Add(hierarchy, RandomTransformation(generator), wideRoot);
+    }
+
+    for (uint32_t node = 0; node < 2000; ++node)
+    {
+        bool isRoot = generator() % 16 == 0;
+        TransformHierarchy::NodeId parent = isRoot ? TransformHierarchy::NoParent : reference.Id(generator() % reference.Size());
+        reference.Add(hierarchy, RandomTransformation(generator), parent);
+    }
+
+    hierarchy.Update();
+
+    PF_CHECK(hierarchy.NodeCount() == reference.Size());
+    PF_CHECK(reference.MaxError(hierarchy) < MaxRelativeError);
+}
+
+PF_TEST(TransformHierarchy_UpdatesOnlyChangedSubtrees)
+{
+    std::mt19937 generator{ 11 };
+    TransformHierarchy hierarchy;
+    ReferenceHierarchy reference;
+
+    // Root with two chains of 10 nodes each
+    TransformHierarchy::NodeId root = reference.Add(hierarchy, RandomTransformation(generator), TransformHierarchy::NoParent);
+    TransformHierarchy::NodeId leftParent = root;
+    TransformHierarchy::NodeId rightParent = root;
+
+    for (uint32_t depth = 0; depth < 10; ++depth)
+    {
+        leftParent = reference.Add(hierarchy, RandomTransformation(generator), leftParent);
+        rightParent = reference.Add(hierarchy, RandomTransformation(generator), rightParent);
+    }
+
+    hierarchy.Update();
+    hierarchy.UpdatePreviousFrameValues();
+
+    hierarchy.Update();
+    PF_CHECK(hierarchy.LastUpdatedNodeCount() == 0);
+
+    // Head of the left chain is the second recorded node
+    reference.SetLocal(hierarchy, 1, RandomTransformation(generator));
+    hierarchy.Update();
+
+    PF_CHECK(hierarchy.LastUpdatedNodeCount() == 10);
+    PF_CHECK(hierarchy.HasChanged(reference.Id(1)));
+    PF_CHECK(hierarchy.HasChanged(leftParent));
+    PF_CHECK(!hierarchy.HasChanged(root));
+    PF_CHECK(!hierarchy.HasChanged(rightParent));
+    PF_CHECK(reference.MaxError(hierarchy) < MaxRelativeError);
+
+    glm::mat4 changedWorld = hierarchy.WorldMatrix(leftParent);
+    hierarchy.UpdatePreviousFrameValues();
+
+    PF_CHECK(hierarchy.PreviousWorldMatrix(leftParent) == changedWorld);
+    PF_CHECK(!hierarchy.HasChanged(leftParent));
+}
+
+PF_TEST(TransformHierarchy_RemovedNodeChildrenKeepLocalTransforms)
+{
+    std::mt19937 generator{ 13 };
+    TransformHierarchy hierarchy;
+
+    Geometry::Transformation rootLocal = RandomTransformation(generator);
+    Geometry::Transformation middleLocal = RandomTransformation(generator);
+    Geometry::Transformation leafLocal = RandomTransformation(generator);
+
+    TransformHierarchy::NodeId root = hierarchy.AddNode(rootLocal);
+    TransformHierarchy::NodeId middle = hierarchy.AddNode(middleLocal, root);
+    TransformHierarchy::NodeId leaf = hierarchy.AddNode(leafLocal, middle);
+
+    hierarchy.Update();
+    hierarchy.RemoveNode(middle);
+    hierarchy.Update();
+
+    glm::mat4 expectedLeafWorld = rootLocal.GetMatrix() * leafLocal.GetMatrix();
+    float maxError = 0.0f;
+
+    for (auto column = 0; column < 4; ++column)
+        for (auto row = 0; row < 4; ++row)
+            maxError = std::max(maxError, std::abs(hierarchy.WorldMatrix(leaf)[column][row] - expectedLeafWorld[column][row]));
+
+    PF_CHECK(hierarchy.Parent(leaf) == root);
+    PF_CHECK(hierarchy.NodeCount() == 2);
+    PF_CHECK(hierarchy.LevelCount() == 2);
+    PF_CHECK(maxError < MaxRelativeError);
+}
@@ -0,0 +1,48 @@
+#include "TestRunner.hpp"
+
+#include <cstdio>
+#include <chrono>
+
+namespace PathFinderTests
+{
+
+    TestRunner& TestRunner::SharedInstance()
+    {
+        static TestRunner runner;
+        return runner;
+    }
+
+    bool TestRunner::Register(const char* name, Test test)
+    {
+        mTests.push_back({ name, test });
+        return true;
+    }
+
+    void TestRunner::ReportFailure(const char* expression, const char* file, int line)
+    {
+        printf("    %s(%d): check failed: %s\n", file, line, expression);
+        ++mCurrentTestFailureCount;
+    }
+
+    uint64_t TestRunner::RunAll()
+    {
+        uint64_t failedTestCount = 0;
+
+        for (const Entry& test : mTests)
+        {
+            mCurrentTestFailureCount = 0;
+
+            auto start = std::chrono::steady_clock::now();
+            test.Function();
+            double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            printf("%s %s (%.1f ms)\n", mCurrentTestFailureCount == 0 ? "[PASSED]" : "[FAILED]", test.Name, milliseconds);
+            failedTestCount += mCurrentTestFailureCount > 0;
+        }
+
+        printf("%llu of %llu tests passed\n", (unsigned long long)(mTests.size() - failedTestCount), (unsigned long long)mTests.size());
+
+        return failedTestCount;
+    }
+
+}
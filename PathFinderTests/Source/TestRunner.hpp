@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace PathFinderTests
+{
+
+    /// Runs tests registered with PF_TEST. A failed check is reported and marks its test as failed
+    /// without stopping it, so one run lists every broken expectation.
+    class TestRunner
+    {
+    public:
+        using Test = void(*)();
+
+        static TestRunner& SharedInstance();
+
+        bool Register(const char* name, Test test);
+        void ReportFailure(const char* expression, const char* file, int line);
+
+        // Returns the number of failed tests
+        uint64_t RunAll();
+
+    private:
+        struct Entry
+        {
+            const char* Name;
+            Test Function;
+        };
+
+        std::vector<Entry> mTests;
+        uint64_t mCurrentTestFailureCount = 0;
+    };
+
+}
+
+#define PF_TEST_CONCAT_IMPL(a, b) a##b
+#define PF_TEST_CONCAT(a, b) PF_TEST_CONCAT_IMPL(a, b)
+
+// Defines and registers a test function. Name must be unique within the test target.
+#define PF_TEST(name) \
+    static void name(); \
+    static const bool PF_TEST_CONCAT(name, _IsRegistered) = PathFinderTests::TestRunner::SharedInstance().Register(#name, &name); \
+    static void name()
+
+#define PF_CHECK(expression) ((expression) ? (void)0 : PathFinderTests::TestRunner::SharedInstance().ReportFailure(#expression, __FILE__, __LINE__))
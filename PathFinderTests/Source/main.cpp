@@ -0,0 +1,6 @@
+#include "TestRunner.hpp"
+
+int main(int argc, char** argv)
+{
+    return PathFinderTests::TestRunner::SharedInstance().RunAll() == 0 ? 0 : 1;
+}